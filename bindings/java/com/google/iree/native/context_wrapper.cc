@@ -79,10 +79,14 @@ Status ContextWrapper::ResolveFunction(iree_string_view_t name,
 Status ContextWrapper::InvokeFunction(const FunctionWrapper& function_wrapper,
                                       const std::vector<float*>& inputs,
                                       int input_element_count, float* output) {
+  if (!list_pool_) {
+    IREE_RETURN_IF_ERROR(
+        iree_vm_list_pool_create(iree_allocator_system(), &list_pool_));
+  }
+
   vm::ref<iree_vm_list_t> input_list;
-  IREE_RETURN_IF_ERROR(iree_vm_list_create(
-      /*element_type=*/nullptr, input_element_count, iree_allocator_system(),
-      &input_list));
+  IREE_RETURN_IF_ERROR(iree_vm_list_pool_acquire(
+      list_pool_, /*element_type=*/nullptr, input_element_count, &input_list));
 
   iree_hal_allocator_t* allocator = iree_hal_device_allocator(device_);
   iree_hal_memory_type_t input_memory_type =
@@ -118,9 +122,8 @@ Status ContextWrapper::InvokeFunction(const FunctionWrapper& function_wrapper,
 
   // Prepare outputs list to accept results from the invocation.
   vm::ref<iree_vm_list_t> outputs;
-  IREE_RETURN_IF_ERROR(iree_vm_list_create(/*element_type=*/nullptr,
-                                           4 * sizeof(float),
-                                           iree_allocator_system(), &outputs));
+  IREE_RETURN_IF_ERROR(iree_vm_list_pool_acquire(
+      list_pool_, /*element_type=*/nullptr, 4 * sizeof(float), &outputs));
 
   // Synchronously invoke the function.
   IREE_RETURN_IF_ERROR(iree_vm_invoke(context_, *function_wrapper.function(),
@@ -146,6 +149,7 @@ int ContextWrapper::id() const { return iree_vm_context_id(context_); }
 
 ContextWrapper::~ContextWrapper() {
   iree_vm_context_release(context_);
+  iree_vm_list_pool_release(list_pool_);
   iree_vm_module_release(hal_module_);
   iree_hal_device_release(device_);
   iree_hal_driver_release(driver_);
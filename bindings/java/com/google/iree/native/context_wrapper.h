@@ -57,6 +57,8 @@ class ContextWrapper {
   iree_hal_driver_t* driver_ = nullptr;
   iree_hal_device_t* device_ = nullptr;
   iree_vm_module_t* hal_module_ = nullptr;
+  // Pool for invocation argument/result lists, created on first invocation.
+  iree_vm_list_pool_t* list_pool_ = nullptr;
 };
 
 }  // namespace java
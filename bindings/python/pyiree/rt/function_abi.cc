@@ -31,6 +31,11 @@ namespace python {
 
 namespace {
 
+// Minimum alignment of python memory wrapped without copying. Arrays not
+// meeting this (such as those sliced at odd offsets) are copied into aligned
+// device buffers.
+constexpr uintptr_t kMinWrapAlignment = 16;
+
 class SipLinearizeInputsVisitor {
  public:
   SipLinearizeInputsVisitor(SipSignatureParser& parser, py::tuple& py_args,
@@ -286,12 +291,30 @@ VmVariantList PyAllocateResults(FunctionAbi* self, VmVariantList& f_args,
 class PyBufferReleaser {
  public:
   PyBufferReleaser(Py_buffer& b) : b_(b) {}
-  ~PyBufferReleaser() { PyBuffer_Release(&b_); }
+  ~PyBufferReleaser() {
+    if (!detached_) PyBuffer_Release(&b_);
+  }
+
+  // Stops releasing the view on destruction once ownership of it has been
+  // transferred elsewhere.
+  void Detach() { detached_ = true; }
 
  private:
   Py_buffer& b_;
+  bool detached_ = false;
 };
 
+// Releases a Py_buffer owned by a wrapped HAL buffer. Buffers may be destroyed
+// on any thread and with or without the GIL held.
+void ReleaseWrappedPyBuffer(void* self, void* ptr) {
+  auto* view = static_cast<Py_buffer*>(self);
+  if (Py_IsInitialized()) {
+    py::gil_scoped_acquire gil;
+    PyBuffer_Release(view);
+  }
+  delete view;
+}
+
 pybind11::error_already_set RaiseBufferMismatchError(
     std::string message, py::handle obj,
     const RawSignatureParser::Description& desc) {
@@ -722,39 +745,29 @@ void FunctionAbi::PackBuffer(const RawSignatureParser::Description& desc,
   }
   PyBufferReleaser py_view_releaser(py_view);
 
-  // Whether the py object needs to be retained with the argument.
-  // Should be set to true if directly mapping, false if copied.
-  bool depends_on_pyobject = false;
-
   // Verify compatibility.
   absl::InlinedVector<int, 2> dynamic_dims;
   MapBufferAttrs(py_view, desc, dynamic_dims);
 
-  // Allocate a HalBuffer.
+  // Wrap the python memory directly if the device can use it, otherwise
+  // allocate a HalBuffer and copy.
   // This is hard-coded to C-contiguous right now.
   // TODO(laurenzo): Expand to other layouts as needed.
-  // TODO(laurenzo): Wrap and retain original buffer (depends_on_pyobject=true).
-  iree_hal_buffer_t* raw_buffer;
-  CheckApiStatus(iree_hal_allocator_allocate_buffer(
-                     device_.allocator(),
-                     static_cast<iree_hal_memory_type_t>(
-                         IREE_HAL_MEMORY_TYPE_HOST_LOCAL |
-                         IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE),
-                     IREE_HAL_BUFFER_USAGE_ALL, py_view.len, &raw_buffer),
-                 "Failed to allocate device visible buffer");
-  CheckApiStatus(
-      iree_hal_buffer_write_data(raw_buffer, 0, py_view.buf, py_view.len),
-      "Error writing to input buffer");
-
-  // Only capture the reference to the exporting object (incrementing it)
-  // once guaranteed successful.
-  if (depends_on_pyobject) {
-    // Note for future implementation: there needs to be a place to stash
-    // references to be kept alive which back a buffer. This is likely an
-    // additional bag of refs returned from this function, which can then
-    // be attached to an invocation.
-    throw RaisePyError(PyExc_NotImplementedError,
-                       "Dependent buffer arguments not implemented");
+  iree_hal_buffer_t* raw_buffer = TryWrapBuffer(py_view);
+  if (raw_buffer) {
+    // The buffer now owns the view and releases it when destroyed.
+    py_view_releaser.Detach();
+  } else {
+    CheckApiStatus(iree_hal_allocator_allocate_buffer(
+                       device_.allocator(),
+                       static_cast<iree_hal_memory_type_t>(
+                           IREE_HAL_MEMORY_TYPE_HOST_LOCAL |
+                           IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE),
+                       IREE_HAL_BUFFER_USAGE_ALL, py_view.len, &raw_buffer),
+                   "Failed to allocate device visible buffer");
+    CheckApiStatus(
+        iree_hal_buffer_write_data(raw_buffer, 0, py_view.buf, py_view.len),
+        "Error writing to input buffer");
   }
 
   // Create the buffer_view. (note that numpy shape is ssize_t)
@@ -773,6 +786,36 @@ void FunctionAbi::PackBuffer(const RawSignatureParser::Description& desc,
                  "Error moving buffer view");
 }
 
+iree_hal_buffer_t* FunctionAbi::TryWrapBuffer(Py_buffer& py_view) {
+  // Wrapped buffers may be mapped for writing by executables and as such
+  // readonly views (and any that do not meet alignment requirements) must be
+  // copied.
+  if (py_view.readonly ||
+      reinterpret_cast<uintptr_t>(py_view.buf) % kMinWrapAlignment != 0) {
+    return nullptr;
+  }
+  // The buffer may outlive the argument list (such as when stored into a
+  // global or returned as a result) so it takes ownership of the view.
+  auto* owned_view = new Py_buffer(py_view);
+  iree_allocator_t view_allocator = {owned_view, /*alloc=*/nullptr,
+                                     ReleaseWrappedPyBuffer};
+  iree_hal_buffer_t* raw_buffer = nullptr;
+  iree_status_t status = iree_hal_allocator_wrap_buffer(
+      device_.allocator(),
+      static_cast<iree_hal_memory_type_t>(IREE_HAL_MEMORY_TYPE_HOST_LOCAL |
+                                          IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE),
+      IREE_HAL_MEMORY_ACCESS_ALL, IREE_HAL_BUFFER_USAGE_ALL,
+      iree_make_byte_span(py_view.buf, py_view.len), view_allocator,
+      &raw_buffer);
+  if (!iree_status_is_ok(status)) {
+    // Allocators that cannot wrap host memory fall back to copying.
+    iree_status_ignore(status);
+    delete owned_view;
+    return nullptr;
+  }
+  return raw_buffer;
+}
+
 std::vector<std::string> SerializeVmVariantList(VmVariantList& vm_list) {
   size_t size = vm_list.size();
   std::vector<std::string> results;
@@ -114,6 +114,9 @@ class FunctionAbi {
  private:
   void PackBuffer(const RawSignatureParser::Description& desc,
                   py::handle py_arg, VmVariantList& f_args, bool writable);
+  // Wraps the memory of |py_view| in a device buffer without copying.
+  // Returns nullptr if the memory cannot be wrapped and must be copied.
+  iree_hal_buffer_t* TryWrapBuffer(Py_buffer& py_view);
 
   HalDevice device_;
   std::shared_ptr<HostTypeFactory> host_type_factory_;
@@ -16,6 +16,7 @@
 # pylint: disable=broad-except
 """Tests for the function abi."""
 
+import gc
 import re
 
 from absl import logging
@@ -137,6 +138,34 @@ class FunctionAbiTest(absltest.TestCase):
     self.assertEqual(np.float32, result.dtype)
     self.assertEqual((1,), result.shape)
 
+  def test_pack_retains_args(self):
+    fabi = rt.FunctionAbi(self.device, self.htf, ATTRS_SIP_LINEAR_2ARG)
+    arg0 = np.full((1,), 1.5, dtype=np.float32)
+    arg1 = np.full((1,), 2.5, dtype=np.float32)
+    f_args = fabi.pack_inputs(arg0, arg1)
+    expected = fabi.serialize_vm_list(f_args)
+    # Arguments may be wrapped without copying and must remain valid after
+    # the caller drops its references.
+    del arg0
+    del arg1
+    gc.collect()
+    self.assertEqual(expected, fabi.serialize_vm_list(f_args))
+
+  def test_pack_readonly_and_unaligned_args(self):
+    fabi = rt.FunctionAbi(self.device, self.htf, ATTRS_SIP_LINEAR_2ARG)
+    arg0 = np.full((1,), 1.5, dtype=np.float32)
+    arg0.setflags(write=False)
+    # Slicing at an element offset produces a C-contiguous but unaligned view.
+    arg1 = np.full((2,), 2.5, dtype=np.float32)[1:]
+    f_args = fabi.pack_inputs(arg0, arg1)
+    self.assertEqual(
+        "<VmVariantList(2): [HalBufferView(1:0x3000020), HalBufferView(1:0x3000020)]>",
+        repr(f_args))
+    expected_args = fabi.pack_inputs(np.full((1,), 1.5, dtype=np.float32),
+                                     np.full((1,), 2.5, dtype=np.float32))
+    self.assertEqual(fabi.serialize_vm_list(expected_args),
+                     fabi.serialize_vm_list(f_args))
+
   def test_static_arg_success(self):
     fabi = rt.FunctionAbi(self.device, self.htf,
                           ATTRS_1ARG_FLOAT32_10X128X64_TO_SINT32_32X8X64_V1)
@@ -131,7 +131,9 @@ class PyMappedMemory {
     }
   }
   PyMappedMemory(PyMappedMemory&& other)
-      : mapped_memory_(other.mapped_memory_), buf_(std::move(other.buf_)) {}
+      : desc_(std::move(other.desc_)),
+        mapped_memory_(other.mapped_memory_),
+        buf_(std::move(other.buf_)) {}
 
   const Description& desc() const { return desc_; }
 
@@ -43,7 +43,7 @@ class HostTypeFactory {
 
   // Creates a C-contiguous ndarray of the given element_type/dims and backed
   // by the given buffer. The resulting array has no synchronization and is
-  // available for use immediately.
+  // available for use immediately. The buffer memory is mapped and not copied.
   virtual py::object CreateImmediateNdarray(
       AbiConstants::ScalarType element_type, absl::Span<const int> dims,
       HalBuffer buffer);
@@ -30,7 +30,7 @@ __all__ = ["load_module", "load_modules", "Config", "SystemContext"]
 import os
 import sys
 
-from typing import Optional, Sequence, Tuple
+from typing import Any, Optional, Sequence, Tuple
 
 from . import binding as _binding
 
@@ -148,6 +148,27 @@ class BoundFunction:
     unpacked_results = self._abi.unpack_results(results)
     return unpacked_results
 
+  def call_batch(self, batch_args: Sequence[Sequence[Any]]):
+    """Invokes the function once for each tuple of positional arguments.
+
+    The invocations run synchronously in order and share the per-call VM and
+    HAL setup, which amortizes overhead when serving many small requests.
+
+    Args:
+      batch_args: Sequence of positional argument sequences, one per call.
+
+    Returns:
+      A list of the unpacked results of each call.
+    """
+    batch_inputs = [self._abi.pack_inputs(*args) for args in batch_args]
+    batch_results = [
+        self._abi.allocate_results(inputs, static_alloc=False)
+        for inputs in batch_inputs
+    ]
+    self._context._vm_context.invoke_batch(self._vm_function, batch_inputs,
+                                           batch_results)
+    return [self._abi.unpack_results(results) for results in batch_results]
+
   def __repr__(self):
     return f"<BoundFunction {repr(self._abi)} ({repr(self._vm_function)})>"
 
@@ -92,6 +92,17 @@ class SystemApiTest(absltest.TestCase):
     results = f(arg0, arg1)
     np.testing.assert_allclose(results, [4., 10., 18., 28.])
 
+  def test_batch_invoke(self):
+    ctx = rt.SystemContext()
+    ctx.add_module(create_simple_mul_module())
+    f = ctx.modules.arithmetic["simple_mul"]
+    arg0 = np.array([1., 2., 3., 4.], dtype=np.float32)
+    arg1 = np.array([4., 5., 6., 7.], dtype=np.float32)
+    results = f.call_batch([(arg0, arg1), (arg1, arg1)])
+    self.assertEqual(2, len(results))
+    np.testing.assert_allclose(results[0], [4., 10., 18., 28.])
+    np.testing.assert_allclose(results[1], [16., 25., 36., 49.])
+
   def test_serialize_values(self):
     ctx = rt.SystemContext()
     self.assertTrue(ctx.is_dynamic)
@@ -144,6 +144,24 @@ void VmContext::Invoke(iree_vm_function_t f, VmVariantList& inputs,
                  "Error invoking function");
 }
 
+void VmContext::InvokeBatch(iree_vm_function_t f,
+                            std::vector<VmVariantList*> inputs,
+                            std::vector<VmVariantList*> outputs) {
+  if (inputs.size() != outputs.size()) {
+    throw RaiseValueError("Mismatched input and output batch sizes");
+  }
+  std::vector<iree_vm_list_t*> raw_inputs(inputs.size());
+  std::vector<iree_vm_list_t*> raw_outputs(outputs.size());
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    raw_inputs[i] = inputs[i]->raw_ptr();
+    raw_outputs[i] = outputs[i]->raw_ptr();
+  }
+  CheckApiStatus(iree_vm_invoke_batch(raw_ptr(), f, nullptr, raw_inputs.size(),
+                                      raw_inputs.data(), raw_outputs.data(),
+                                      iree_allocator_system()),
+                 "Error invoking function batch");
+}
+
 //------------------------------------------------------------------------------
 // VmModule
 //------------------------------------------------------------------------------
@@ -191,6 +209,21 @@ absl::optional<iree_vm_function_t> VmModule::LookupFunction(
 // VmVariantList
 //------------------------------------------------------------------------------
 
+VmVariantList VmVariantList::Create(iree_host_size_t capacity) {
+  // Intentionally never released: lists may outlive any other owner.
+  static iree_vm_list_pool_t* list_pool = []() {
+    iree_vm_list_pool_t* pool = nullptr;
+    CheckApiStatus(iree_vm_list_pool_create(iree_allocator_system(), &pool),
+                   "Error creating variant list pool");
+    return pool;
+  }();
+  iree_vm_list_t* list;
+  CheckApiStatus(iree_vm_list_pool_acquire(list_pool, /*element_type=*/nullptr,
+                                           capacity, &list),
+                 "Error allocating variant list");
+  return VmVariantList(list);
+}
+
 std::string VmVariantList::DebugString() const {
   // The variant list API requires mutability, so we const cast to it internally
   // so we can maintain a const DebugString() for callers.
@@ -275,7 +308,9 @@ void SetupVmBindings(pybind11::module m) {
       .def_property_readonly("context_id", &VmContext::context_id)
       .def("create_function_abi", &VmContext::CreateFunctionAbi,
            py::arg("device"), py::arg("host_type_factory"), py::arg("f"))
-      .def("invoke", &VmContext::Invoke);
+      .def("invoke", &VmContext::Invoke)
+      .def("invoke_batch", &VmContext::InvokeBatch, py::arg("f"),
+           py::arg("inputs"), py::arg("outputs"));
 
   py::class_<VmModule>(m, "VmModule")
       .def_static("from_flatbuffer", &VmModule::FromFlatbufferBlob)
@@ -15,6 +15,8 @@
 #ifndef IREE_BINDINGS_PYTHON_PYIREE_RT_VM_H_
 #define IREE_BINDINGS_PYTHON_PYIREE_RT_VM_H_
 
+#include <vector>
+
 #include "absl/types/optional.h"
 #include "iree/base/api.h"
 #include "iree/vm/api.h"
@@ -78,13 +80,10 @@ class VmVariantList {
   VmVariantList& operator=(const VmVariantList&) = delete;
   VmVariantList(const VmVariantList&) = delete;
 
-  static VmVariantList Create(iree_host_size_t capacity) {
-    iree_vm_list_t* list;
-    CheckApiStatus(iree_vm_list_create(/*element_type=*/nullptr, capacity,
-                                       iree_allocator_system(), &list),
-                   "Error allocating variant list");
-    return VmVariantList(list);
-  }
+  // Creates a variant list with at least |capacity|. Lists are recycled
+  // through a process-wide pool so that invocation argument and result lists
+  // don't need to be allocated on each call.
+  static VmVariantList Create(iree_host_size_t capacity);
 
   iree_host_size_t size() const { return iree_vm_list_size(list_); }
 
@@ -145,6 +144,11 @@ class VmContext : public ApiRefCounted<VmContext, iree_vm_context_t> {
   void Invoke(iree_vm_function_t f, VmVariantList& inputs,
               VmVariantList& outputs);
 
+  // Synchronously invokes the given function once for each pair of inputs
+  // and outputs, amortizing the per-call overhead across the batch.
+  void InvokeBatch(iree_vm_function_t f, std::vector<VmVariantList*> inputs,
+                   std::vector<VmVariantList*> outputs);
+
   // Creates a function ABI suitable for marshalling function inputs/results.
   std::unique_ptr<FunctionAbi> CreateFunctionAbi(
       HalDevice& device, std::shared_ptr<HostTypeFactory> host_type_factory,
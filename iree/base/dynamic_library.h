@@ -53,6 +53,16 @@ class DynamicLibrary {
   static StatusOr<std::unique_ptr<DynamicLibrary>> Load(
       absl::Span<const char* const> search_file_names);
 
+  // Loads a library directly from the in-memory shared object |file_data|
+  // without touching the filesystem. |debug_name| is used to identify the
+  // library in tools such as debuggers and profilers.
+  //
+  // Returns UNAVAILABLE if the platform does not support loading from memory,
+  // in which case callers should fall back to writing the contents to a file
+  // and using |Load|.
+  static StatusOr<std::unique_ptr<DynamicLibrary>> LoadFromMemory(
+      const char* debug_name, absl::Span<const uint8_t> file_data);
+
   // Gets the name of the library file that is loaded.
   const std::string& file_name() const { return file_name_; }
 
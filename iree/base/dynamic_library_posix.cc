@@ -21,6 +21,22 @@
     defined(IREE_PLATFORM_LINUX)
 
 #include <dlfcn.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(IREE_PLATFORM_LINUX)
+#include <sys/syscall.h>
+#endif  // IREE_PLATFORM_LINUX
+
+// memfd_create is only exposed by glibc 2.27+ and bionic API level 30+ so we
+// call the syscall directly when the kernel headers define it.
+#if defined(IREE_PLATFORM_LINUX) && defined(SYS_memfd_create)
+#define IREE_HAVE_MEMFD_CREATE 1
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif  // MFD_CLOEXEC
+#endif  // IREE_PLATFORM_LINUX && SYS_memfd_create
 
 namespace iree {
 
@@ -31,6 +47,7 @@ class DynamicLibraryPosix : public DynamicLibrary {
     //   Sometimes closing the library can prevent proper symbolization on
     //   crashes or in sampling profilers.
     ::dlclose(library_);
+    if (memfd_ != -1) ::close(memfd_);
   }
 
   static StatusOr<std::unique_ptr<DynamicLibrary>> Load(
@@ -48,15 +65,66 @@ class DynamicLibraryPosix : public DynamicLibrary {
            << "Unable to open dynamic library:'" << dlerror() << "'";
   }
 
+  static StatusOr<std::unique_ptr<DynamicLibrary>> LoadFromMemory(
+      const char* debug_name, absl::Span<const uint8_t> file_data) {
+    IREE_TRACE_SCOPE0("DynamicLibraryPosix::LoadFromMemory");
+
+#if defined(IREE_HAVE_MEMFD_CREATE)
+    // Create an anonymous in-memory file and populate it with the library
+    // contents. The name is only used for /proc/self/maps and debugging.
+    int fd = static_cast<int>(::syscall(SYS_memfd_create, debug_name,
+                                        static_cast<unsigned>(MFD_CLOEXEC)));
+    if (fd == -1) {
+      return UnavailableErrorBuilder(IREE_LOC)
+             << "memfd_create failed: " << ::strerror(errno);
+    }
+    size_t offset = 0;
+    while (offset < file_data.size()) {
+      ssize_t written =
+          ::write(fd, file_data.data() + offset, file_data.size() - offset);
+      if (written == -1) {
+        if (errno == EINTR) continue;
+        int error = errno;
+        ::close(fd);
+        return UnavailableErrorBuilder(IREE_LOC)
+               << "Failed to write library contents to memfd: "
+               << ::strerror(error);
+      }
+      offset += static_cast<size_t>(written);
+    }
+
+    // The loader maps the file by its fd path. The loader matches already
+    // loaded libraries by path so the fd must stay open (and the path unique)
+    // for as long as the library is loaded; otherwise the next in-memory load
+    // that is assigned the same fd would get this library back.
+    std::string fd_path = "/proc/self/fd/" + std::to_string(fd);
+    void* library = ::dlopen(fd_path.c_str(), RTLD_LAZY | RTLD_LOCAL);
+    if (!library) {
+      ::close(fd);
+      return UnavailableErrorBuilder(IREE_LOC)
+             << "Unable to open in-memory dynamic library:'" << dlerror()
+             << "'";
+    }
+    return absl::WrapUnique(new DynamicLibraryPosix(debug_name, library, fd));
+#else
+    return UnavailableErrorBuilder(IREE_LOC)
+           << "Loading dynamic libraries from memory is not supported on this "
+              "platform";
+#endif  // IREE_HAVE_MEMFD_CREATE
+  }
+
   void* GetSymbol(const char* symbol_name) const override {
     return ::dlsym(library_, symbol_name);
   }
 
  private:
-  DynamicLibraryPosix(std::string file_name, void* library)
-      : DynamicLibrary(file_name), library_(library) {}
+  DynamicLibraryPosix(std::string file_name, void* library, int memfd = -1)
+      : DynamicLibrary(file_name), library_(library), memfd_(memfd) {}
 
   void* library_;
+
+  // memfd backing a library loaded from memory or -1. Closed after unloading.
+  int memfd_;
 };
 
 // static
@@ -65,6 +133,12 @@ StatusOr<std::unique_ptr<DynamicLibrary>> DynamicLibrary::Load(
   return DynamicLibraryPosix::Load(search_file_names);
 }
 
+// static
+StatusOr<std::unique_ptr<DynamicLibrary>> DynamicLibrary::LoadFromMemory(
+    const char* debug_name, absl::Span<const uint8_t> file_data) {
+  return DynamicLibraryPosix::LoadFromMemory(debug_name, file_data);
+}
+
 }  // namespace iree
 
 #endif  // IREE_PLATFORM_*
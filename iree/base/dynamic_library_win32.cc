@@ -152,6 +152,14 @@ StatusOr<std::unique_ptr<DynamicLibrary>> DynamicLibrary::Load(
   return DynamicLibraryWin::Load(search_file_names);
 }
 
+// static
+StatusOr<std::unique_ptr<DynamicLibrary>> DynamicLibrary::LoadFromMemory(
+    const char* debug_name, absl::Span<const uint8_t> file_data) {
+  // TODO(#3845): investigate a custom PE loader; LoadLibrary only takes paths.
+  return UnavailableErrorBuilder(IREE_LOC)
+         << "Loading dynamic libraries from memory is not supported on Windows";
+}
+
 }  // namespace iree
 
 #endif  // IREE_PLATFORM_*
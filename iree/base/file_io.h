@@ -15,7 +15,9 @@
 #ifndef IREE_BASE_FILE_IO_H_
 #define IREE_BASE_FILE_IO_H_
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 #include "absl/strings/string_view.h"
 #include "iree/base/status.h"
@@ -46,6 +48,28 @@ Status DeleteFile(const std::string& path);
 Status MoveFile(const std::string& source_path,
                 const std::string& destination_path);
 
+// Updates the last modification time of the file at |path| to now.
+Status TouchFile(const std::string& path);
+
+// Creates the directory at |path| and any missing parent directories.
+// Succeeds if the directory already exists.
+Status CreateDirectories(const std::string& path);
+
+// Information about a file returned by ListDirectory.
+struct FileInfo {
+  // Name of the file within its directory (not the full path).
+  std::string name;
+  // Size of the file contents in bytes.
+  uint64_t size = 0;
+  // Last modification time in platform-dependent units. Only useful for
+  // ordering files relative to each other.
+  uint64_t modification_time = 0;
+};
+
+// Lists the regular files directly within the directory at |path|.
+// Subdirectories and other special files are skipped.
+StatusOr<std::vector<FileInfo>> ListDirectory(const std::string& path);
+
 // Gets a platform and environment-dependent path for temporary files.
 std::string GetTempPath();
 
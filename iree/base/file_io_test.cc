@@ -14,6 +14,8 @@
 
 #include "iree/base/file_io.h"
 
+#include <algorithm>
+
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "iree/base/file_path.h"
@@ -78,6 +80,45 @@ TEST(FileIo, MoveFile) {
   EXPECT_EQ(to_write, read);
 }
 
+TEST(FileIo, CreateAndListDirectory) {
+  char* test_tmpdir = getenv("TEST_TMPDIR");
+  ASSERT_TRUE(test_tmpdir);
+  auto dir_path =
+      file_path::JoinPaths(test_tmpdir, "CreateAndListDirectory/nested");
+  IREE_ASSERT_OK(CreateDirectories(dir_path));
+  // Creating an existing directory is a no-op.
+  IREE_ASSERT_OK(CreateDirectories(dir_path));
+
+  IREE_ASSERT_OK(SetFileContents(file_path::JoinPaths(dir_path, "a.txt"), "a"));
+  IREE_ASSERT_OK(
+      SetFileContents(file_path::JoinPaths(dir_path, "bc.txt"), "bc"));
+  IREE_ASSERT_OK(CreateDirectories(file_path::JoinPaths(dir_path, "subdir")));
+
+  IREE_ASSERT_OK_AND_ASSIGN(auto file_infos, ListDirectory(dir_path));
+  ASSERT_EQ(2u, file_infos.size());
+  std::sort(file_infos.begin(), file_infos.end(),
+            [](const FileInfo& lhs, const FileInfo& rhs) {
+              return lhs.name < rhs.name;
+            });
+  EXPECT_EQ("a.txt", file_infos[0].name);
+  EXPECT_EQ(1u, file_infos[0].size);
+  EXPECT_EQ("bc.txt", file_infos[1].name);
+  EXPECT_EQ(2u, file_infos[1].size);
+}
+
+TEST(FileIo, CreateDirectoriesOverFile) {
+  auto path = GetUniquePath("CreateDirectoriesOverFile");
+  IREE_ASSERT_OK(SetFileContents(path, "file"));
+  EXPECT_THAT(CreateDirectories(path), StatusIs(StatusCode::kAlreadyExists));
+}
+
+TEST(FileIo, TouchFile) {
+  auto path = GetUniquePath("TouchFile");
+  EXPECT_THAT(TouchFile(path), StatusIs(StatusCode::kNotFound));
+  IREE_ASSERT_OK(SetFileContents(path, GetUniqueContents("TouchFile")));
+  IREE_EXPECT_OK(TouchFile(path));
+}
+
 TEST(FileIo, GetTempPath) {
   auto temp_path = GetTempPath();
   EXPECT_NE("", temp_path);
@@ -17,6 +17,8 @@
 #if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_APPLE) || \
     defined(IREE_PLATFORM_LINUX)
 
+#include <dirent.h>
+#include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -112,6 +114,70 @@ Status MoveFile(const std::string& source_path,
   return OkStatus();
 }
 
+Status TouchFile(const std::string& path) {
+  IREE_TRACE_SCOPE0("file_io::TouchFile");
+  if (::utimensat(AT_FDCWD, path.c_str(), /*times=*/nullptr, 0) == -1) {
+    return ErrnoToCanonicalStatusBuilder(errno, IREE_LOC)
+           << "Failed to update modification time of '" << path << "'";
+  }
+  return OkStatus();
+}
+
+Status CreateDirectories(const std::string& path) {
+  IREE_TRACE_SCOPE0("file_io::CreateDirectories");
+  // Create each parent in turn; mkdir fails with EEXIST for any that already
+  // exist, which is fine so long as they are actually directories.
+  for (size_t i = 1; i <= path.size(); ++i) {
+    if (i != path.size() && path[i] != '/') continue;
+    std::string parent_path = path.substr(0, i);
+    if (::mkdir(parent_path.c_str(), 0755) == -1 && errno != EEXIST) {
+      return ErrnoToCanonicalStatusBuilder(errno, IREE_LOC)
+             << "Failed to create directory '" << parent_path << "'";
+    }
+  }
+  struct stat stat_buf;
+  if (stat(path.c_str(), &stat_buf) == -1) {
+    return ErrnoToCanonicalStatusBuilder(errno, IREE_LOC)
+           << "Failed to create directory '" << path << "'";
+  } else if (!S_ISDIR(stat_buf.st_mode)) {
+    return AlreadyExistsErrorBuilder(IREE_LOC)
+           << "'" << path << "' exists and is not a directory";
+  }
+  return OkStatus();
+}
+
+StatusOr<std::vector<FileInfo>> ListDirectory(const std::string& path) {
+  IREE_TRACE_SCOPE0("file_io::ListDirectory");
+  std::unique_ptr<DIR, void (*)(DIR*)> dir = {::opendir(path.c_str()),
+                                              +[](DIR* dir) {
+                                                if (dir) ::closedir(dir);
+                                              }};
+  if (dir == nullptr) {
+    return ErrnoToCanonicalStatusBuilder(errno, IREE_LOC)
+           << "Failed to open directory '" << path << "'";
+  }
+  std::vector<FileInfo> file_infos;
+  while (struct dirent* entry = ::readdir(dir.get())) {
+    struct stat stat_buf;
+    std::string file_path = file_path::JoinPaths(path, entry->d_name);
+    // Files may be deleted concurrently; skip anything we can't stat.
+    if (stat(file_path.c_str(), &stat_buf) == -1) continue;
+    if (!S_ISREG(stat_buf.st_mode)) continue;
+    FileInfo file_info;
+    file_info.name = entry->d_name;
+    file_info.size = static_cast<uint64_t>(stat_buf.st_size);
+#if defined(IREE_PLATFORM_APPLE)
+    const struct timespec& mtime = stat_buf.st_mtimespec;
+#else
+    const struct timespec& mtime = stat_buf.st_mtim;
+#endif  // IREE_PLATFORM_APPLE
+    file_info.modification_time =
+        static_cast<uint64_t>(mtime.tv_sec) * 1000000000ull + mtime.tv_nsec;
+    file_infos.push_back(std::move(file_info));
+  }
+  return file_infos;
+}
+
 std::string GetTempPath() {
   IREE_TRACE_SCOPE0("file_io::GetTempPath");
 
@@ -93,6 +93,81 @@ Status MoveFile(const std::string& source_path,
   return OkStatus();
 }
 
+Status TouchFile(const std::string& path) {
+  IREE_TRACE_SCOPE0("file_io::TouchFile");
+  HANDLE handle = ::CreateFileA(
+      path.c_str(), FILE_WRITE_ATTRIBUTES,
+      FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+      OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (handle == INVALID_HANDLE_VALUE) {
+    return Win32ErrorToCanonicalStatusBuilder(GetLastError(), IREE_LOC)
+           << "Unable to open file " << path;
+  }
+  FILETIME now;
+  ::GetSystemTimeAsFileTime(&now);
+  BOOL result = ::SetFileTime(handle, nullptr, nullptr, &now);
+  DWORD error = GetLastError();
+  ::CloseHandle(handle);
+  if (result == FALSE) {
+    return Win32ErrorToCanonicalStatusBuilder(error, IREE_LOC)
+           << "Unable to update modification time of " << path;
+  }
+  return OkStatus();
+}
+
+Status CreateDirectories(const std::string& path) {
+  IREE_TRACE_SCOPE0("file_io::CreateDirectories");
+  for (size_t i = 1; i <= path.size(); ++i) {
+    if (i != path.size() && path[i] != '/' && path[i] != '\\') continue;
+    // Skip drive roots like `C:`.
+    if (path[i - 1] == ':') continue;
+    std::string parent_path = path.substr(0, i);
+    if (::CreateDirectoryA(parent_path.c_str(), nullptr) == FALSE &&
+        GetLastError() != ERROR_ALREADY_EXISTS) {
+      return Win32ErrorToCanonicalStatusBuilder(GetLastError(), IREE_LOC)
+             << "Unable to create directory " << parent_path;
+    }
+  }
+  DWORD attrs = ::GetFileAttributesA(path.c_str());
+  if (attrs == INVALID_FILE_ATTRIBUTES) {
+    return Win32ErrorToCanonicalStatusBuilder(GetLastError(), IREE_LOC)
+           << "Unable to create directory " << path;
+  } else if (!(attrs & FILE_ATTRIBUTE_DIRECTORY)) {
+    return AlreadyExistsErrorBuilder(IREE_LOC)
+           << path << " exists and is not a directory";
+  }
+  return OkStatus();
+}
+
+StatusOr<std::vector<FileInfo>> ListDirectory(const std::string& path) {
+  IREE_TRACE_SCOPE0("file_io::ListDirectory");
+  std::string search_pattern = file_path::JoinPaths(path, "*");
+  WIN32_FIND_DATAA find_data;
+  HANDLE find_handle = ::FindFirstFileA(search_pattern.c_str(), &find_data);
+  if (find_handle == INVALID_HANDLE_VALUE) {
+    return Win32ErrorToCanonicalStatusBuilder(GetLastError(), IREE_LOC)
+           << "Unable to list directory " << path;
+  }
+  std::vector<FileInfo> file_infos;
+  do {
+    if (find_data.dwFileAttributes &
+        (FILE_ATTRIBUTE_DIRECTORY | FILE_ATTRIBUTE_DEVICE)) {
+      continue;
+    }
+    FileInfo file_info;
+    file_info.name = find_data.cFileName;
+    file_info.size = (static_cast<uint64_t>(find_data.nFileSizeHigh) << 32) |
+                     find_data.nFileSizeLow;
+    file_info.modification_time =
+        (static_cast<uint64_t>(find_data.ftLastWriteTime.dwHighDateTime)
+         << 32) |
+        find_data.ftLastWriteTime.dwLowDateTime;
+    file_infos.push_back(std::move(file_info));
+  } while (::FindNextFileA(find_handle, &find_data) != FALSE);
+  ::FindClose(find_handle);
+  return file_infos;
+}
+
 std::string GetTempPath() {
   IREE_TRACE_SCOPE0("file_io::GetTempPath");
 
@@ -0,0 +1,238 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/base/internal/lz4.h"
+
+#include <string.h>
+
+// Minimum match length encoded by the format; token match lengths are biased
+// by this amount.
+#define IREE_LZ4_MIN_MATCH 4
+// The last match must start at least this many bytes before the end of input.
+#define IREE_LZ4_MF_LIMIT 12
+// The last this many bytes of input are always encoded as literals.
+#define IREE_LZ4_LAST_LITERALS 5
+// Maximum backreference distance representable in the 16-bit offset.
+#define IREE_LZ4_MAX_DISTANCE 65535
+
+// Hash table size used by the compressor (in entries).
+#define IREE_LZ4_HASH_LOG 12
+#define IREE_LZ4_HASH_SIZE (1u << IREE_LZ4_HASH_LOG)
+
+static inline uint32_t iree_lz4_read32(const uint8_t* p) {
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+static inline uint32_t iree_lz4_hash(uint32_t sequence) {
+  return (sequence * 2654435761u) >> (32 - IREE_LZ4_HASH_LOG);
+}
+
+iree_host_size_t iree_lz4_block_compress_bound(iree_host_size_t source_length) {
+  return source_length + source_length / 255 + 16;
+}
+
+// Writes a length continuation as a run of 255 bytes followed by the
+// remainder. Returns NULL if the target would overflow.
+static uint8_t* iree_lz4_write_length(uint8_t* op, const uint8_t* op_end,
+                                      iree_host_size_t length) {
+  while (length >= 255) {
+    if (op >= op_end) return NULL;
+    *op++ = 255;
+    length -= 255;
+  }
+  if (op >= op_end) return NULL;
+  *op++ = (uint8_t)length;
+  return op;
+}
+
+// Emits a single sequence of |literal_length| literals starting at |literals|
+// followed by an optional match. |match_length| of 0 indicates the final
+// literal-only sequence. Returns NULL if the target would overflow.
+static uint8_t* iree_lz4_write_sequence(uint8_t* op, const uint8_t* op_end,
+                                        const uint8_t* literals,
+                                        iree_host_size_t literal_length,
+                                        uint16_t offset,
+                                        iree_host_size_t match_length) {
+  if (op >= op_end) return NULL;
+  uint8_t* token = op++;
+  iree_host_size_t match_code =
+      match_length ? match_length - IREE_LZ4_MIN_MATCH : 0;
+  *token = (uint8_t)(((literal_length >= 15 ? 15 : literal_length) << 4) |
+                     (match_code >= 15 ? 15 : match_code));
+  if (literal_length >= 15) {
+    op = iree_lz4_write_length(op, op_end, literal_length - 15);
+    if (!op) return NULL;
+  }
+  if ((iree_host_size_t)(op_end - op) < literal_length) return NULL;
+  memcpy(op, literals, literal_length);
+  op += literal_length;
+  if (!match_length) return op;
+  if (op_end - op < 2) return NULL;
+  *op++ = (uint8_t)(offset & 0xFF);
+  *op++ = (uint8_t)(offset >> 8);
+  if (match_code >= 15) {
+    op = iree_lz4_write_length(op, op_end, match_code - 15);
+    if (!op) return NULL;
+  }
+  return op;
+}
+
+iree_host_size_t iree_lz4_block_compress(iree_const_byte_span_t source,
+                                         iree_byte_span_t target) {
+  const uint8_t* base = source.data;
+  const iree_host_size_t length = source.data_length;
+  uint8_t* op = target.data;
+  const uint8_t* op_end = target.data + target.data_length;
+
+  const uint8_t* anchor = base;
+  if (length > IREE_LZ4_MF_LIMIT) {
+    // Positions are stored +1 so that 0 can indicate an empty slot.
+    uint32_t hash_table[IREE_LZ4_HASH_SIZE];
+    memset(hash_table, 0, sizeof(hash_table));
+
+    const uint8_t* match_limit = base + length - IREE_LZ4_LAST_LITERALS;
+    const uint8_t* ip_limit = base + length - IREE_LZ4_MF_LIMIT;
+    const uint8_t* ip = base;
+    while (ip < ip_limit) {
+      uint32_t sequence = iree_lz4_read32(ip);
+      uint32_t hash = iree_lz4_hash(sequence);
+      uint32_t candidate = hash_table[hash];
+      hash_table[hash] = (uint32_t)(ip - base) + 1;
+      if (!candidate) {
+        ++ip;
+        continue;
+      }
+      const uint8_t* ref = base + candidate - 1;
+      if (ip - ref > IREE_LZ4_MAX_DISTANCE ||
+          iree_lz4_read32(ref) != sequence) {
+        ++ip;
+        continue;
+      }
+
+      // Extend the match forward as far as allowed.
+      const uint8_t* match_end = ip + IREE_LZ4_MIN_MATCH;
+      ref += IREE_LZ4_MIN_MATCH;
+      while (match_end < match_limit && *match_end == *ref) {
+        ++match_end;
+        ++ref;
+      }
+      iree_host_size_t match_length = (iree_host_size_t)(match_end - ip);
+      uint16_t offset = (uint16_t)(match_end - ref);
+
+      op = iree_lz4_write_sequence(op, op_end, anchor,
+                                   (iree_host_size_t)(ip - anchor), offset,
+                                   match_length);
+      if (!op) return 0;
+      ip = match_end;
+      anchor = ip;
+    }
+  }
+
+  // Final literal run.
+  op = iree_lz4_write_sequence(op, op_end, anchor,
+                               (iree_host_size_t)(base + length - anchor),
+                               /*offset=*/0, /*match_length=*/0);
+  if (!op) return 0;
+  return (iree_host_size_t)(op - target.data);
+}
+
+// Reads a length continuation. Returns false if the input was truncated or
+// the length would overflow.
+static bool iree_lz4_read_length(const uint8_t** ip_ptr, const uint8_t* ip_end,
+                                 iree_host_size_t* length) {
+  const uint8_t* ip = *ip_ptr;
+  uint8_t value = 0;
+  do {
+    if (IREE_UNLIKELY(ip >= ip_end)) return false;
+    value = *ip++;
+    if (IREE_UNLIKELY(*length > SIZE_MAX - value)) return false;
+    *length += value;
+  } while (value == 255);
+  *ip_ptr = ip;
+  return true;
+}
+
+iree_status_t iree_lz4_block_decompress(iree_const_byte_span_t source,
+                                        iree_byte_span_t target) {
+  const uint8_t* ip = source.data;
+  const uint8_t* ip_end = source.data + source.data_length;
+  uint8_t* op = target.data;
+  uint8_t* op_end = target.data + target.data_length;
+
+  while (ip < ip_end) {
+    uint8_t token = *ip++;
+
+    iree_host_size_t literal_length = token >> 4;
+    if (literal_length == 15 &&
+        !iree_lz4_read_length(&ip, ip_end, &literal_length)) {
+      return iree_make_status(IREE_STATUS_DATA_LOSS,
+                              "truncated LZ4 literal length");
+    }
+    if (IREE_UNLIKELY(literal_length > (iree_host_size_t)(ip_end - ip) ||
+                      literal_length > (iree_host_size_t)(op_end - op))) {
+      return iree_make_status(IREE_STATUS_DATA_LOSS,
+                              "LZ4 literal run out of bounds");
+    }
+    memcpy(op, ip, literal_length);
+    op += literal_length;
+    ip += literal_length;
+
+    // The final sequence has only literals.
+    if (ip == ip_end) break;
+
+    if (IREE_UNLIKELY(ip_end - ip < 2)) {
+      return iree_make_status(IREE_STATUS_DATA_LOSS, "truncated LZ4 offset");
+    }
+    iree_host_size_t offset =
+        (iree_host_size_t)ip[0] | ((iree_host_size_t)ip[1] << 8);
+    ip += 2;
+    if (IREE_UNLIKELY(offset == 0 ||
+                      offset > (iree_host_size_t)(op - target.data))) {
+      return iree_make_status(IREE_STATUS_DATA_LOSS,
+                              "LZ4 match offset out of bounds");
+    }
+
+    iree_host_size_t match_length = token & 0xF;
+    if (match_length == 15 &&
+        !iree_lz4_read_length(&ip, ip_end, &match_length)) {
+      return iree_make_status(IREE_STATUS_DATA_LOSS,
+                              "truncated LZ4 match length");
+    }
+    match_length += IREE_LZ4_MIN_MATCH;
+    if (IREE_UNLIKELY(match_length > (iree_host_size_t)(op_end - op))) {
+      return iree_make_status(IREE_STATUS_DATA_LOSS,
+                              "LZ4 match run out of bounds");
+    }
+
+    const uint8_t* match = op - offset;
+    if (offset >= match_length) {
+      memcpy(op, match, match_length);
+      op += match_length;
+    } else {
+      // Overlapping copy (run-length style); must go byte by byte.
+      for (iree_host_size_t i = 0; i < match_length; ++i) *op++ = *match++;
+    }
+  }
+
+  if (IREE_UNLIKELY(op != op_end)) {
+    return iree_make_status(IREE_STATUS_DATA_LOSS,
+                            "LZ4 block decompressed to %zu bytes but expected "
+                            "%zu",
+                            (iree_host_size_t)(op - target.data),
+                            target.data_length);
+  }
+  return iree_ok_status();
+}
@@ -0,0 +1,59 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Minimal LZ4 block format codec.
+//
+// Produces and consumes raw LZ4 blocks (no frame header, checksums, or
+// dictionaries) as documented in:
+// https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+//
+// The compressor is a simple greedy single-pass matcher that favors fast
+// decompression over ratio and is intended for offline use (the compiler). The
+// decompressor is fully bounds checked and safe to run on untrusted input. The
+// output of either is compatible with the reference LZ4 implementation.
+
+#ifndef IREE_BASE_INTERNAL_LZ4_H_
+#define IREE_BASE_INTERNAL_LZ4_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Returns the maximum size of the compressed output for |source_length| bytes
+// of input. Incompressible data expands slightly due to framing.
+iree_host_size_t iree_lz4_block_compress_bound(iree_host_size_t source_length);
+
+// Compresses |source| into |target| as an LZ4 block.
+// |target| should be at least iree_lz4_block_compress_bound bytes.
+// Returns the number of bytes written to |target| or 0 if the target capacity
+// was insufficient.
+iree_host_size_t iree_lz4_block_compress(iree_const_byte_span_t source,
+                                         iree_byte_span_t target);
+
+// Decompresses the LZ4 block in |source| into |target|. The decompressed
+// contents must exactly fill |target|; the size is expected to be stored
+// alongside the compressed data by the producer.
+iree_status_t iree_lz4_block_decompress(iree_const_byte_span_t source,
+                                        iree_byte_span_t target);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_BASE_INTERNAL_LZ4_H_
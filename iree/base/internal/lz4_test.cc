@@ -0,0 +1,134 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/base/internal/lz4.h"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+std::vector<uint8_t> Compress(const std::vector<uint8_t>& source) {
+  std::vector<uint8_t> target(iree_lz4_block_compress_bound(source.size()));
+  iree_host_size_t length = iree_lz4_block_compress(
+      iree_make_const_byte_span(source.data(), source.size()),
+      iree_make_byte_span(target.data(), target.size()));
+  EXPECT_NE(0, length);
+  target.resize(length);
+  return target;
+}
+
+void ExpectRoundTrip(const std::vector<uint8_t>& source) {
+  std::vector<uint8_t> compressed = Compress(source);
+  std::vector<uint8_t> decompressed(source.size());
+  IREE_ASSERT_OK(iree_lz4_block_decompress(
+      iree_make_const_byte_span(compressed.data(), compressed.size()),
+      iree_make_byte_span(decompressed.data(), decompressed.size())));
+  EXPECT_EQ(source, decompressed);
+}
+
+TEST(LZ4Test, RoundTripEmpty) { ExpectRoundTrip({}); }
+
+TEST(LZ4Test, RoundTripTiny) {
+  // Shorter than the minimum match window; stored as literals only.
+  ExpectRoundTrip({1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12});
+}
+
+TEST(LZ4Test, RoundTripRepetitive) {
+  std::vector<uint8_t> source(1024 * 1024);
+  for (size_t i = 0; i < source.size(); ++i) {
+    source[i] = static_cast<uint8_t>((i / 7) % 13);
+  }
+  ExpectRoundTrip(source);
+  EXPECT_LT(Compress(source).size(), source.size() / 100);
+}
+
+TEST(LZ4Test, RoundTripRandom) {
+  std::mt19937 rng(123);
+  std::vector<uint8_t> source(256 * 1024);
+  for (auto& value : source) value = static_cast<uint8_t>(rng());
+  ExpectRoundTrip(source);
+  EXPECT_LE(Compress(source).size(),
+            iree_lz4_block_compress_bound(source.size()));
+}
+
+TEST(LZ4Test, RoundTripSparse) {
+  std::mt19937 rng(456);
+  std::vector<uint8_t> source(512 * 1024);
+  for (auto& value : source) {
+    value = (rng() % 4 == 0) ? static_cast<uint8_t>(rng()) : 0;
+  }
+  ExpectRoundTrip(source);
+}
+
+TEST(LZ4Test, CompressInsufficientCapacity) {
+  std::vector<uint8_t> source(1024, 0xCD);
+  std::vector<uint8_t> target(4);
+  EXPECT_EQ(0, iree_lz4_block_compress(
+                   iree_make_const_byte_span(source.data(), source.size()),
+                   iree_make_byte_span(target.data(), target.size())));
+}
+
+TEST(LZ4Test, DecompressReferenceBlock) {
+  // 3 literals 'abc', match offset 3 length 9, then 5 trailing literals.
+  const uint8_t block[] = {0x35, 'a', 'b', 'c', 0x03, 0x00,
+                           0x50, '1', '2', '3', '4',  '5'};
+  char decompressed[17];
+  IREE_ASSERT_OK(iree_lz4_block_decompress(
+      iree_make_const_byte_span(block, sizeof(block)),
+      iree_make_byte_span(decompressed, sizeof(decompressed))));
+  EXPECT_EQ(0, std::memcmp("abcabcabcabc12345", decompressed,
+                           sizeof(decompressed)));
+}
+
+TEST(LZ4Test, DecompressSizeMismatch) {
+  std::vector<uint8_t> source(4096, 0x11);
+  std::vector<uint8_t> compressed = Compress(source);
+  std::vector<uint8_t> decompressed(source.size() - 1);
+  iree_status_t status = iree_lz4_block_decompress(
+      iree_make_const_byte_span(compressed.data(), compressed.size()),
+      iree_make_byte_span(decompressed.data(), decompressed.size()));
+  EXPECT_TRUE(iree_status_is_data_loss(status));
+  iree_status_ignore(status);
+}
+
+TEST(LZ4Test, DecompressInvalidOffset) {
+  // Match offset points before the start of the output.
+  const uint8_t block[] = {0x10, 'a', 0x05, 0x00, 0x00};
+  std::vector<uint8_t> decompressed(5);
+  iree_status_t status = iree_lz4_block_decompress(
+      iree_make_const_byte_span(block, sizeof(block)),
+      iree_make_byte_span(decompressed.data(), decompressed.size()));
+  EXPECT_TRUE(iree_status_is_data_loss(status));
+  iree_status_ignore(status);
+}
+
+TEST(LZ4Test, DecompressTruncated) {
+  std::vector<uint8_t> source(4096);
+  for (size_t i = 0; i < source.size(); ++i) source[i] = i % 31;
+  std::vector<uint8_t> compressed = Compress(source);
+  std::vector<uint8_t> decompressed(source.size());
+  iree_status_t status = iree_lz4_block_decompress(
+      iree_make_const_byte_span(compressed.data(), compressed.size() / 2),
+      iree_make_byte_span(decompressed.data(), decompressed.size()));
+  EXPECT_TRUE(iree_status_is_data_loss(status));
+  iree_status_ignore(status);
+}
+
+}  // namespace
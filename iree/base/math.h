@@ -273,6 +273,60 @@ static inline uint64_t iree_math_round_up_to_pow2_u64(uint64_t n) {
 #endif  // 1
 }
 
+//==============================================================================
+// Saturating float to integer conversion
+//==============================================================================
+// A plain C cast from a float that is NaN or out of the destination range is
+// undefined behavior and produces different values across architectures (x86
+// returns INT32_MIN while ARM saturates). These clamp to the destination range
+// and map NaN to 0 so that all targets agree with the compiler's constant
+// folding of the same conversions.
+
+// Converts |value| to a signed 8-bit integer, truncating toward zero.
+// NaN converts to 0 and out-of-range values saturate to INT8_MIN/INT8_MAX.
+static inline int8_t iree_math_f32_to_si8_sat(float value) {
+  if (value != value) return 0;
+  if (value >= 128.0f) return INT8_MAX;
+  if (value <= -129.0f) return INT8_MIN;
+  return (int8_t)value;
+}
+
+// Converts |value| to a signed 16-bit integer, truncating toward zero.
+// NaN converts to 0 and out-of-range values saturate to INT16_MIN/INT16_MAX.
+static inline int16_t iree_math_f32_to_si16_sat(float value) {
+  if (value != value) return 0;
+  if (value >= 32768.0f) return INT16_MAX;
+  if (value <= -32769.0f) return INT16_MIN;
+  return (int16_t)value;
+}
+
+// Converts |value| to a signed 32-bit integer, truncating toward zero.
+// NaN converts to 0 and out-of-range values saturate to INT32_MIN/INT32_MAX.
+static inline int32_t iree_math_f32_to_si32_sat(float value) {
+  if (value != value) return 0;
+  if (value >= 2147483648.0f) return INT32_MAX;
+  if (value <= -2147483648.0f) return INT32_MIN;
+  return (int32_t)value;
+}
+
+// Converts |value| to a signed 64-bit integer, truncating toward zero.
+// NaN converts to 0 and out-of-range values saturate to INT64_MIN/INT64_MAX.
+static inline int64_t iree_math_f32_to_si64_sat(float value) {
+  if (value != value) return 0;
+  if (value >= 9223372036854775808.0f) return INT64_MAX;
+  if (value <= -9223372036854775808.0f) return INT64_MIN;
+  return (int64_t)value;
+}
+
+// Converts |value| to an unsigned 32-bit integer, truncating toward zero.
+// NaN and negative values convert to 0 and values >= 2^32 saturate to
+// UINT32_MAX.
+static inline uint32_t iree_math_f32_to_ui32_sat(float value) {
+  if (!(value > 0.0f)) return 0;
+  if (value >= 4294967296.0f) return UINT32_MAX;
+  return (uint32_t)value;
+}
+
 //==============================================================================
 // Pseudo-random number generators (PRNGs): **NOT CRYPTOGRAPHICALLY SECURE*
 //==============================================================================
@@ -14,6 +14,8 @@
 
 #include "iree/base/math.h"
 
+#include <cmath>
+
 #include "iree/testing/gtest.h"
 #include "iree/testing/status_matchers.h"
 
@@ -170,6 +172,81 @@ TEST(RoundingTest, UpToNextPow264) {
   EXPECT_EQ(0ull, iree_math_round_up_to_pow2_u64(kUint64Max));
 }
 
+//==============================================================================
+// Saturating float to integer conversion
+//==============================================================================
+
+TEST(SaturatingConversionTest, F32ToSI32) {
+  EXPECT_EQ(0, iree_math_f32_to_si32_sat(0.0f));
+  EXPECT_EQ(0, iree_math_f32_to_si32_sat(-0.0f));
+  EXPECT_EQ(-3, iree_math_f32_to_si32_sat(-3.75f));
+  EXPECT_EQ(3, iree_math_f32_to_si32_sat(3.75f));
+  EXPECT_EQ(0, iree_math_f32_to_si32_sat(NAN));
+  EXPECT_EQ(0, iree_math_f32_to_si32_sat(-NAN));
+  EXPECT_EQ(INT32_MAX, iree_math_f32_to_si32_sat(INFINITY));
+  EXPECT_EQ(INT32_MIN, iree_math_f32_to_si32_sat(-INFINITY));
+  EXPECT_EQ(INT32_MAX, iree_math_f32_to_si32_sat(2147483648.0f));
+  EXPECT_EQ(INT32_MAX, iree_math_f32_to_si32_sat(1e20f));
+  EXPECT_EQ(INT32_MIN, iree_math_f32_to_si32_sat(-2147483648.0f));
+  EXPECT_EQ(INT32_MIN, iree_math_f32_to_si32_sat(-1e20f));
+  // Largest float below 2^31.
+  EXPECT_EQ(2147483520, iree_math_f32_to_si32_sat(2147483520.0f));
+}
+
+TEST(SaturatingConversionTest, F32ToSI8) {
+  EXPECT_EQ(-3, iree_math_f32_to_si8_sat(-3.75f));
+  EXPECT_EQ(0, iree_math_f32_to_si8_sat(NAN));
+  EXPECT_EQ(INT8_MAX, iree_math_f32_to_si8_sat(INFINITY));
+  EXPECT_EQ(INT8_MIN, iree_math_f32_to_si8_sat(-INFINITY));
+  EXPECT_EQ(INT8_MAX, iree_math_f32_to_si8_sat(128.0f));
+  EXPECT_EQ(127, iree_math_f32_to_si8_sat(127.9f));
+  EXPECT_EQ(-128, iree_math_f32_to_si8_sat(-128.9f));
+  EXPECT_EQ(INT8_MIN, iree_math_f32_to_si8_sat(-129.0f));
+}
+
+TEST(SaturatingConversionTest, F32ToSI16) {
+  EXPECT_EQ(-3, iree_math_f32_to_si16_sat(-3.75f));
+  EXPECT_EQ(0, iree_math_f32_to_si16_sat(NAN));
+  EXPECT_EQ(INT16_MAX, iree_math_f32_to_si16_sat(INFINITY));
+  EXPECT_EQ(INT16_MIN, iree_math_f32_to_si16_sat(-INFINITY));
+  EXPECT_EQ(INT16_MAX, iree_math_f32_to_si16_sat(32768.0f));
+  EXPECT_EQ(32767, iree_math_f32_to_si16_sat(32767.5f));
+  EXPECT_EQ(-32768, iree_math_f32_to_si16_sat(-32768.5f));
+  EXPECT_EQ(INT16_MIN, iree_math_f32_to_si16_sat(-32769.0f));
+}
+
+TEST(SaturatingConversionTest, F32ToSI64) {
+  EXPECT_EQ(-3, iree_math_f32_to_si64_sat(-3.75f));
+  EXPECT_EQ(0, iree_math_f32_to_si64_sat(NAN));
+  EXPECT_EQ(INT64_MAX, iree_math_f32_to_si64_sat(INFINITY));
+  EXPECT_EQ(INT64_MIN, iree_math_f32_to_si64_sat(-INFINITY));
+  EXPECT_EQ(INT64_MAX, iree_math_f32_to_si64_sat(9223372036854775808.0f));
+  EXPECT_EQ(INT64_MAX, iree_math_f32_to_si64_sat(1e30f));
+  EXPECT_EQ(INT64_MIN, iree_math_f32_to_si64_sat(-9223372036854775808.0f));
+  EXPECT_EQ(INT64_MIN, iree_math_f32_to_si64_sat(-1e30f));
+  // Largest float below 2^63.
+  EXPECT_EQ(9223371487098961920ll,
+            iree_math_f32_to_si64_sat(9223371487098961920.0f));
+}
+
+TEST(SaturatingConversionTest, F32ToUI32) {
+  EXPECT_EQ(0u, iree_math_f32_to_ui32_sat(0.0f));
+  EXPECT_EQ(0u, iree_math_f32_to_ui32_sat(-0.0f));
+  EXPECT_EQ(3u, iree_math_f32_to_ui32_sat(3.75f));
+  EXPECT_EQ(0u, iree_math_f32_to_ui32_sat(-3.75f));
+  EXPECT_EQ(0u, iree_math_f32_to_ui32_sat(NAN));
+  EXPECT_EQ(0u, iree_math_f32_to_ui32_sat(-NAN));
+  EXPECT_EQ(UINT32_MAX, iree_math_f32_to_ui32_sat(INFINITY));
+  EXPECT_EQ(0u, iree_math_f32_to_ui32_sat(-INFINITY));
+  EXPECT_EQ(UINT32_MAX, iree_math_f32_to_ui32_sat(4294967296.0f));
+  EXPECT_EQ(UINT32_MAX, iree_math_f32_to_ui32_sat(1e20f));
+  EXPECT_EQ(0u, iree_math_f32_to_ui32_sat(-1e20f));
+  // Values above INT32_MAX must not wrap through a signed conversion.
+  EXPECT_EQ(2147483648u, iree_math_f32_to_ui32_sat(2147483648.0f));
+  // Largest float below 2^32.
+  EXPECT_EQ(4294967040u, iree_math_f32_to_ui32_sat(4294967040.0f));
+}
+
 //==============================================================================
 // Pseudo-random number generators (PRNGs): **NOT CRYPTOGRAPHICALLY SECURE*
 //==============================================================================
@@ -19,6 +19,7 @@
 #include "iree/base/file_io.h"
 #include "iree/base/status.h"
 #include "iree/base/target_platform.h"
+#include "iree/base/testing/dynamic_library_test_library2_embed.h"
 #include "iree/base/testing/dynamic_library_test_library_embed.h"
 #include "iree/testing/gtest.h"
 #include "iree/testing/status_matchers.h"
@@ -95,5 +96,54 @@ TEST_F(DynamicLibraryTest, GetSymbolFailure) {
   EXPECT_EQ(nullptr, unknown_fn);
 }
 
+TEST_F(DynamicLibraryTest, LoadFromMemory) {
+  const auto* file_toc = dynamic_library_test_library_create();
+  auto library_or = DynamicLibrary::LoadFromMemory(
+      "dynamic_library_test_library",
+      absl::MakeConstSpan(reinterpret_cast<const uint8_t*>(file_toc->data),
+                          file_toc->size));
+  if (IsUnavailable(library_or.status())) {
+    GTEST_SKIP() << "In-memory loading not supported on this platform";
+  }
+  IREE_ASSERT_OK(library_or.status());
+  auto library = std::move(library_or).value();
+
+  auto times_two_fn = library->GetSymbol<int (*)(int)>("times_two");
+  ASSERT_NE(nullptr, times_two_fn);
+  EXPECT_EQ(246, times_two_fn(123));
+}
+
+TEST_F(DynamicLibraryTest, LoadDifferentLibrariesFromMemory) {
+  const auto* file_toc = dynamic_library_test_library_create();
+  auto library_or = DynamicLibrary::LoadFromMemory(
+      "dynamic_library_test_library",
+      absl::MakeConstSpan(reinterpret_cast<const uint8_t*>(file_toc->data),
+                          file_toc->size));
+  if (IsUnavailable(library_or.status())) {
+    GTEST_SKIP() << "In-memory loading not supported on this platform";
+  }
+  IREE_ASSERT_OK(library_or.status());
+  auto library = std::move(library_or).value();
+
+  // Both libraries must stay loaded side by side and resolve their own symbols.
+  const auto* file_toc2 = dynamic_library_test_library2_create();
+  IREE_ASSERT_OK_AND_ASSIGN(
+      auto library2,
+      DynamicLibrary::LoadFromMemory(
+          "dynamic_library_test_library2",
+          absl::MakeConstSpan(reinterpret_cast<const uint8_t*>(file_toc2->data),
+                              file_toc2->size)));
+
+  auto times_two_fn = library->GetSymbol<int (*)(int)>("times_two");
+  ASSERT_NE(nullptr, times_two_fn);
+  EXPECT_EQ(246, times_two_fn(123));
+  EXPECT_EQ(nullptr, library->GetSymbol<int (*)(int)>("times_three"));
+
+  auto times_three_fn = library2->GetSymbol<int (*)(int)>("times_three");
+  ASSERT_NE(nullptr, times_three_fn);
+  EXPECT_EQ(369, times_three_fn(123));
+  EXPECT_EQ(nullptr, library2->GetSymbol<int (*)(int)>("times_two"));
+}
+
 }  // namespace
 }  // namespace iree
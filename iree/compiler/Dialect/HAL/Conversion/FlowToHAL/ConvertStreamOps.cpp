@@ -124,18 +124,16 @@ static void allocateOutputBuffers(IREE::Flow::ExStreamFragmentOp streamOp,
   }
 }
 
-// Allocates a transient buffer for use entirely within the command buffer.
-static Value allocateTransientBuffer(Value streamValue, Value allocator,
-                                     ConversionPatternRewriter &rewriter) {
+// Alignment of each transient value within the stream arena. This matches the
+// most restrictive minStorageBufferOffsetAlignment we target so that arena
+// subspans can always be bound directly. Querying the allocator buffer
+// constraints instead would allow tighter packing on devices that permit it.
+static constexpr int64_t kTransientArenaAlignment = 256;
+
+// Computes the byte size required to store the given transient value.
+static Value computeTransientBufferSize(Value streamValue, Value allocator,
+                                        ConversionPatternRewriter &rewriter) {
   Location loc = streamValue.getLoc();
-  // TODO(benvanik): compute from SSA use-def chain uses.
-  IREE::HAL::MemoryTypeBitfield memoryTypes =
-      IREE::HAL::MemoryTypeBitfield::DeviceLocal;
-  IREE::HAL::BufferUsageBitfield bufferUsage =
-      IREE::HAL::BufferUsageBitfield::Dispatch |
-      IREE::HAL::BufferUsageBitfield::Transfer;
-
-  // Compute the allocation size for the value.
   auto elementType = IREE::HAL::getElementTypeValue(
       streamValue.getType().cast<ShapedType>().getElementType());
   if (!elementType) {
@@ -145,25 +143,166 @@ static Value allocateTransientBuffer(Value streamValue, Value allocator,
   if (!shape) {
     return {};
   }
-  auto allocationSize = rewriter
-                            .create<IREE::HAL::AllocatorComputeSizeOp>(
-                                loc, allocator, *shape, elementType.getValue())
-                            .getResult();
+  return rewriter
+      .create<IREE::HAL::AllocatorComputeSizeOp>(loc, allocator, *shape,
+                                                 elementType.getValue())
+      .getResult();
+}
 
-  auto buffer =
+// Returns max(|lhs|, |rhs|) for two device sizes.
+static Value createMaxSize(Location loc, Value lhs, Value rhs,
+                           ConversionPatternRewriter &rewriter) {
+  auto isGreater =
+      rewriter.createOrFold<CmpIOp>(loc, CmpIPredicate::ugt, lhs, rhs);
+  return rewriter.createOrFold<SelectOp>(loc, isGreater, lhs, rhs);
+}
+
+// Rounds |size| up to the next multiple of |alignment| (a power of two).
+static Value createAlignedSize(Location loc, Value size, int64_t alignment,
+                               ConversionPatternRewriter &rewriter) {
+  auto mask = rewriter.createOrFold<mlir::ConstantIndexOp>(loc, alignment - 1);
+  auto invMask =
+      rewriter.createOrFold<mlir::ConstantIndexOp>(loc, ~(alignment - 1));
+  return rewriter.createOrFold<AndOp>(
+      loc, rewriter.createOrFold<AddIOp>(loc, size, mask), invMask);
+}
+
+// Returns the ordinal of the last op in |block| that reads |value| or any
+// identity of it. Values with no uses die where they are defined.
+static unsigned computeLastUse(Value value, unsigned defOrdinal, Block &block,
+                               DenseMap<Operation *, unsigned> &opOrdinals) {
+  unsigned lastUse = defOrdinal;
+  SmallVector<Value, 4> worklist{value};
+  while (!worklist.empty()) {
+    auto aliasValue = worklist.pop_back_val();
+    for (auto *user : aliasValue.getUsers()) {
+      auto *op = block.findAncestorOpInBlock(*user);
+      if (!op) continue;
+      lastUse = std::max(lastUse, opOrdinals[op]);
+      if (isIdentityOp(op) && op->getOperand(0) == aliasValue) {
+        worklist.push_back(op->getResult(0));
+      }
+    }
+  }
+  return lastUse;
+}
+
+// A range of the stream arena shared by transient values with disjoint
+// lifetimes.
+struct TransientSlot {
+  // Size of the largest value assigned to the slot.
+  Value size = nullptr;
+  // Ordinal of the last op that uses any value assigned to the slot.
+  unsigned lastUse = 0;
+  // Values stored in the slot, in definition order.
+  SmallVector<Value, 4> values;
+};
+
+// Packs |transientValues| (in definition order) into a single transient arena
+// allocation and populates the |bufferSet| with buffers referencing their
+// ranges within it.
+//
+// Each value is live from the op defining it until the last op using it (or
+// any identity of it). Values whose live ranges don't overlap are assigned the
+// same slot of the arena so that the total allocation size approximates the
+// peak working set of the stream instead of the sum of all intermediates. The
+// ranges are inclusive so that the operands and results of a single op never
+// alias; reuse across ops is safe as every command is followed by a full
+// execution barrier.
+static LogicalResult packTransientBuffers(
+    IREE::Flow::ExStreamFragmentOp streamOp, ArrayRef<Value> transientValues,
+    BufferSet &bufferSet, ConversionPatternRewriter &rewriter) {
+  if (transientValues.empty()) return success();
+  auto &block = streamOp.body().front();
+  DenseMap<Operation *, unsigned> opOrdinals;
+  for (auto it : llvm::enumerate(block)) {
+    opOrdinals[&it.value()] = it.index();
+  }
+
+  // Greedily assign values to the first slot that has no live values. As
+  // values are visited in definition order this is the classic linear scan
+  // interval partitioning. Slot sizes are not considered and values of very
+  // different static sizes may share a slot sized for the largest of them.
+  SmallVector<TransientSlot, 4> slots;
+  for (auto value : transientValues) {
+    auto size =
+        computeTransientBufferSize(value, bufferSet.allocator, rewriter);
+    if (!size) {
+      return streamOp.emitOpError()
+             << "unable to compute transient buffer size";
+    }
+    unsigned defOrdinal = opOrdinals[value.getDefiningOp()];
+    unsigned lastUse = computeLastUse(value, defOrdinal, block, opOrdinals);
+    auto *slot = llvm::find_if(slots, [&](const TransientSlot &candidate) {
+      return candidate.lastUse < defOrdinal;
+    });
+    if (slot == slots.end()) {
+      slots.push_back({size, lastUse, {}});
+      slot = &slots.back();
+    } else {
+      slot->size = createMaxSize(value.getLoc(), slot->size, size, rewriter);
+      slot->lastUse = lastUse;
+    }
+    slot->values.push_back(value);
+    LLVM_DEBUG(llvm::dbgs() << "    -- ASSIGN SLOT "
+                            << std::distance(slots.begin(), slot) << " ["
+                            << defOrdinal << ", " << lastUse
+                            << "]: " << value << "\n");
+  }
+
+  // Lay out the slots back to back and allocate the arena.
+  Location loc = streamOp.getLoc();
+  SmallVector<Value, 4> slotOffsets;
+  Value arenaSize;
+  if (slots.size() == 1) {
+    arenaSize = slots.front().size;
+  } else {
+    arenaSize = rewriter.createOrFold<mlir::ConstantIndexOp>(loc, 0);
+    for (auto &slot : slots) {
+      slot.size = createAlignedSize(loc, slot.size, kTransientArenaAlignment,
+                                    rewriter);
+      slotOffsets.push_back(arenaSize);
+      arenaSize = rewriter.createOrFold<AddIOp>(loc, arenaSize, slot.size);
+    }
+  }
+
+  // Transient buffers never escape the stream and are always written before
+  // they are read, allowing allocators to skip initialization and reuse them.
+  IREE::HAL::MemoryTypeBitfield memoryTypes =
+      IREE::HAL::MemoryTypeBitfield::Transient |
+      IREE::HAL::MemoryTypeBitfield::DeviceLocal;
+  IREE::HAL::BufferUsageBitfield bufferUsage =
+      IREE::HAL::BufferUsageBitfield::Dispatch |
+      IREE::HAL::BufferUsageBitfield::Transfer;
+  auto arena =
       rewriter
-          .create<IREE::HAL::AllocatorAllocateOp>(loc, allocator, memoryTypes,
-                                                  bufferUsage, allocationSize)
+          .create<IREE::HAL::AllocatorAllocateOp>(
+              loc, bufferSet.allocator, memoryTypes, bufferUsage, arenaSize)
           .getResult();
 
-  return buffer;
+  // A lone slot spans the whole arena and can use it directly.
+  if (slots.size() == 1) {
+    for (auto value : slots.front().values) {
+      bufferSet.rangeMap[value] = BufferRange{arena};
+    }
+    return success();
+  }
+  for (auto it : llvm::enumerate(slots)) {
+    auto slotBuffer = rewriter.createOrFold<IREE::HAL::BufferSubspanOp>(
+        loc, IREE::HAL::BufferType::get(rewriter.getContext()), arena,
+        slotOffsets[it.index()], it.value().size);
+    for (auto value : it.value().values) {
+      bufferSet.rangeMap[value] = BufferRange{slotBuffer};
+    }
+  }
+  return success();
 }
 
 // Allocates transient buffers to store the intra-stream results and populates
 // the |bufferSet| with the new mappings.
-static void allocateTransientBuffers(IREE::Flow::ExStreamFragmentOp streamOp,
-                                     BufferSet &bufferSet,
-                                     ConversionPatternRewriter &rewriter) {
+static LogicalResult allocateTransientBuffers(
+    IREE::Flow::ExStreamFragmentOp streamOp, BufferSet &bufferSet,
+    ConversionPatternRewriter &rewriter) {
   LLVM_DEBUG(llvm::dbgs() << ": HAL allocateTransientBuffers: "
                           << *streamOp.getOperation() << "\n");
 
@@ -208,13 +347,14 @@ static void allocateTransientBuffers(IREE::Flow::ExStreamFragmentOp streamOp,
   // buffer; however, input and output buffers are already assigned to outer
   // operands and results (which may be on identity ops). To handle this,
   // we first propagate all buffers across identity ops, then allocate any
-  // transient buffers on non-identity ops that are still needed. Finally,
-  // propagate across identity ops again (to account for identity ops on
-  // the interior).
+  // transient buffers on non-identity ops that are still needed (packed into a
+  // single arena based on their liveness). Finally, propagate across identity
+  // ops again (to account for identity ops on the interior).
   // Because there may be runs of identity ops, propagation loops until no
   // changes are made.
   while (propagateIdentityBuffers()) {
   }
+  SmallVector<Value, 8> transientValues;
   for (auto &op : streamOp.body().front()) {
     if (isNoOp(&op) || isIdentityOp(&op)) continue;
     for (auto it : llvm::enumerate(op.getResults())) {
@@ -227,13 +367,16 @@ static void allocateTransientBuffers(IREE::Flow::ExStreamFragmentOp streamOp,
       }
       LLVM_DEBUG(llvm::dbgs() << "    -- ALLOCATE BUFFER FOR RESULT("
                               << it.index() << "): " << op << "\n");
-      auto buffer =
-          allocateTransientBuffer(result, bufferSet.allocator, rewriter);
-      bufferSet.rangeMap[result] = BufferRange{buffer};
+      transientValues.push_back(result);
     }
   }
+  if (failed(packTransientBuffers(streamOp, transientValues, bufferSet,
+                                  rewriter))) {
+    return failure();
+  }
   while (propagateIdentityBuffers()) {
   }
+  return success();
 }
 
 // Records a full execution barrier that forces visibility of all buffers.
@@ -569,7 +712,9 @@ class ExStreamFragmentOpConversion
 
     // Allocate buffers for outputs and transient buffers.
     allocateOutputBuffers(streamOp, bufferSet, rewriter);
-    allocateTransientBuffers(streamOp, bufferSet, rewriter);
+    if (failed(allocateTransientBuffers(streamOp, bufferSet, rewriter))) {
+      return failure();
+    }
 
     // Allocate and begin the command buffer.
     // In a real version we would want to pick the device based on the placement
@@ -173,6 +173,18 @@ class ConstantOpConversion : public OpConversionPattern<ConstantOp> {
   LogicalResult matchAndRewrite(
       ConstantOp srcOp, ArrayRef<Value> operands,
       ConversionPatternRewriter &rewriter) const override {
+    if (auto floatAttr = srcOp.getValue().dyn_cast<FloatAttr>()) {
+      if (!floatAttr.getType().isF32()) {
+        return srcOp.emitRemark()
+               << "unsupported const float bit width for dialect";
+      }
+      if (floatAttr.getValue().isPosZero()) {
+        rewriter.replaceOpWithNewOp<IREE::VM::ConstF32ZeroOp>(srcOp);
+      } else {
+        rewriter.replaceOpWithNewOp<IREE::VM::ConstF32Op>(srcOp, floatAttr);
+      }
+      return success();
+    }
     auto integerAttr = srcOp.getValue().dyn_cast<IntegerAttr>();
     if (!integerAttr) {
       return srcOp.emitRemark() << "unsupported const type for dialect";
@@ -262,6 +274,86 @@ class CmpIOpConversion : public OpConversionPattern<CmpIOp> {
   }
 };
 
+class CmpFOpConversion : public OpConversionPattern<CmpFOp> {
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      CmpFOp srcOp, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    CmpFOp::Adaptor srcAdapter(operands);
+    if (!srcAdapter.lhs().getType().isF32()) return failure();
+    auto returnType = rewriter.getIntegerType(32);
+    // The VM only has lt/lte comparisons; gt/gte swap their operands.
+    switch (srcOp.getPredicate()) {
+      case CmpFPredicate::OEQ:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpEQF32OOp>(
+            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
+        return success();
+      case CmpFPredicate::UEQ:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpEQF32UOp>(
+            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
+        return success();
+      case CmpFPredicate::ONE:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpNEF32OOp>(
+            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
+        return success();
+      case CmpFPredicate::UNE:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpNEF32UOp>(
+            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
+        return success();
+      case CmpFPredicate::OLT:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpLTF32OOp>(
+            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
+        return success();
+      case CmpFPredicate::ULT:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpLTF32UOp>(
+            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
+        return success();
+      case CmpFPredicate::OLE:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpLTEF32OOp>(
+            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
+        return success();
+      case CmpFPredicate::ULE:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpLTEF32UOp>(
+            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
+        return success();
+      case CmpFPredicate::OGT:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpLTF32OOp>(
+            srcOp, returnType, srcAdapter.rhs(), srcAdapter.lhs());
+        return success();
+      case CmpFPredicate::UGT:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpLTF32UOp>(
+            srcOp, returnType, srcAdapter.rhs(), srcAdapter.lhs());
+        return success();
+      case CmpFPredicate::OGE:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpLTEF32OOp>(
+            srcOp, returnType, srcAdapter.rhs(), srcAdapter.lhs());
+        return success();
+      case CmpFPredicate::UGE:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpLTEF32UOp>(
+            srcOp, returnType, srcAdapter.rhs(), srcAdapter.lhs());
+        return success();
+      default:
+        return failure();
+    }
+  }
+};
+
+template <typename SrcOpTy, typename DstOpTy>
+class UnaryArithmeticOpConversion : public OpConversionPattern<SrcOpTy> {
+  using OpConversionPattern<SrcOpTy>::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      SrcOpTy srcOp, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    typename SrcOpTy::Adaptor srcAdapter(operands);
+
+    rewriter.replaceOpWithNewOp<DstOpTy>(srcOp, srcAdapter.operand().getType(),
+                                         srcAdapter.operand());
+    return success();
+  }
+};
+
 template <typename SrcOpTy, typename DstOpTy>
 class BinaryArithmeticOpConversion : public OpConversionPattern<SrcOpTy> {
   using OpConversionPattern<SrcOpTy>::OpConversionPattern;
@@ -303,6 +395,25 @@ class ShiftArithmeticOpConversion : public OpConversionPattern<SrcOpTy> {
   }
 };
 
+template <typename SrcOpTy, typename DstOpTy>
+class FloatCastOpConversion : public OpConversionPattern<SrcOpTy> {
+  using OpConversionPattern<SrcOpTy>::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      SrcOpTy srcOp, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    // Only i32<->f32 casts are supported by the VM.
+    auto srcType = operands[0].getType();
+    auto dstType = srcOp.getType();
+    auto isSupported = [](Type type) {
+      return type.isF32() || type.isInteger(32);
+    };
+    if (!isSupported(srcType) || !isSupported(dstType)) return failure();
+    rewriter.replaceOpWithNewOp<DstOpTy>(srcOp, dstType, operands[0]);
+    return success();
+  }
+};
+
 template <typename StdOp>
 class CastingOpConversion : public OpConversionPattern<StdOp> {
   using OpConversionPattern<StdOp>::OpConversionPattern;
@@ -321,6 +432,12 @@ class SelectI32OpConversion : public OpConversionPattern<SelectOp> {
       SelectOp srcOp, ArrayRef<Value> operands,
       ConversionPatternRewriter &rewriter) const override {
     SelectOp::Adaptor srcAdaptor(operands);
+    if (srcAdaptor.true_value().getType().isF32()) {
+      rewriter.replaceOpWithNewOp<IREE::VM::SelectF32Op>(
+          srcOp, srcAdaptor.true_value().getType(), srcAdaptor.condition(),
+          srcAdaptor.true_value(), srcAdaptor.false_value());
+      return success();
+    }
     IntegerType requiredType = IntegerType::get(srcOp.getContext(), 32);
     // Note: This check can correctly just be a verification that
     // actualType == requiredType, but since the VM type conversion also
@@ -397,7 +514,7 @@ void populateStandardToVMPatterns(MLIRContext *context,
                                   TypeConverter &typeConverter,
                                   OwningRewritePatternList &patterns) {
   patterns.insert<BranchOpConversion, CallOpConversion, CmpIOpConversion,
-                  CondBranchOpConversion, ModuleOpConversion,
+                  CmpFOpConversion, CondBranchOpConversion, ModuleOpConversion,
                   ModuleTerminatorOpConversion, FuncOpConversion,
                   ReturnOpConversion, CastingOpConversion<IndexCastOp>,
                   CastingOpConversion<TruncateIOp>, SelectI32OpConversion>(
@@ -419,6 +536,18 @@ void populateStandardToVMPatterns(MLIRContext *context,
               BinaryArithmeticOpConversion<XOrOp, IREE::VM::XorI32Op>>(
           typeConverter, context);
 
+  // Floating-point arithmetic ops
+  patterns.insert<BinaryArithmeticOpConversion<AddFOp, IREE::VM::AddF32Op>,
+                  BinaryArithmeticOpConversion<SubFOp, IREE::VM::SubF32Op>,
+                  BinaryArithmeticOpConversion<MulFOp, IREE::VM::MulF32Op>,
+                  BinaryArithmeticOpConversion<DivFOp, IREE::VM::DivF32Op>,
+                  BinaryArithmeticOpConversion<RemFOp, IREE::VM::RemF32Op>,
+                  UnaryArithmeticOpConversion<AbsFOp, IREE::VM::AbsF32Op>,
+                  UnaryArithmeticOpConversion<NegFOp, IREE::VM::NegF32Op>,
+                  FloatCastOpConversion<SIToFPOp, IREE::VM::CastSI32F32Op>,
+                  FloatCastOpConversion<FPToSIOp, IREE::VM::CastF32SI32Op>>(
+      typeConverter, context);
+
   // Shift ops
   // TODO(laurenzo): The standard dialect is missing shr ops. Add once in place.
   patterns.insert<ShiftArithmeticOpConversion<ShiftLeftOp, IREE::VM::ShlI32Op>>(
@@ -0,0 +1,88 @@
+// RUN: iree-opt -split-input-file -pass-pipeline='test-iree-convert-std-to-vm' -iree-vm-target-extensions=f32 %s | IreeFileCheck %s
+
+// -----
+// CHECK-LABEL: @t001_addf
+module @t001_addf {
+
+module {
+  // CHECK: func @my_fn
+  // CHECK-SAME: %[[ARG0:[a-zA-Z0-9$._-]+]]
+  // CHECK-SAME: %[[ARG1:[a-zA-Z0-9$._-]+]]
+  func @my_fn(%arg0: f32, %arg1: f32) -> (f32) {
+    // CHECK: vm.add.f32 %[[ARG0]], %[[ARG1]]
+    %0 = addf %arg0, %arg1 : f32
+    return %0 : f32
+  }
+}
+
+}
+
+// -----
+// CHECK-LABEL: @t002_negf
+module @t002_negf {
+
+module {
+  // CHECK: func @my_fn
+  // CHECK-SAME: %[[ARG0:[a-zA-Z0-9$._-]+]]
+  func @my_fn(%arg0: f32) -> (f32) {
+    // CHECK: vm.neg.f32 %[[ARG0]]
+    %0 = negf %arg0 : f32
+    return %0 : f32
+  }
+}
+
+}
+
+// -----
+// CHECK-LABEL: @t003_constf
+module @t003_constf {
+
+module {
+  // CHECK: func @my_fn
+  func @my_fn() -> (f32, f32) {
+    // CHECK: vm.const.f32.zero
+    %0 = constant 0.0 : f32
+    // CHECK: vm.const.f32 2.500000e+00
+    %1 = constant 2.5 : f32
+    return %0, %1 : f32, f32
+  }
+}
+
+}
+
+// -----
+// CHECK-LABEL: @t004_cmpf
+module @t004_cmpf {
+
+module {
+  // CHECK: func @my_fn
+  // CHECK-SAME: %[[ARG0:[a-zA-Z0-9$._-]+]]
+  // CHECK-SAME: %[[ARG1:[a-zA-Z0-9$._-]+]]
+  func @my_fn(%arg0: f32, %arg1: f32) -> (i1, i1) {
+    // CHECK: vm.cmp.lt.f32.o %[[ARG0]], %[[ARG1]]
+    %0 = cmpf "olt", %arg0, %arg1 : f32
+    // CHECK: vm.cmp.lte.f32.u %[[ARG1]], %[[ARG0]]
+    %1 = cmpf "uge", %arg0, %arg1 : f32
+    return %0, %1 : i1, i1
+  }
+}
+
+}
+
+// -----
+// CHECK-LABEL: @t005_casts
+module @t005_casts {
+
+module {
+  // CHECK: func @my_fn
+  // CHECK-SAME: %[[ARG0:[a-zA-Z0-9$._-]+]]
+  func @my_fn(%arg0: i32) -> (i32) {
+    // CHECK: %[[F:.+]] = vm.cast.si32.f32 %[[ARG0]] : i32 -> f32
+    %0 = sitofp %arg0 : i32 to f32
+    // CHECK: vm.cast.f32.si32 %[[F]] : f32 -> i32
+    %1 = fptosi %0 : f32 to i32
+    return %1 : i32
+  }
+}
+
+}
@@ -26,6 +26,8 @@ namespace VM {
 enum class OpcodeExtension {
   // Adds ops for manipulating i64 types.
   kI64,
+  // Adds ops for manipulating f32 types.
+  kF32,
 };
 
 // Controls VM translation targets.
@@ -35,6 +37,8 @@ struct TargetOptions {
 
   // Whether the i64 extension is enabled in the target VM.
   bool i64Extension = false;
+  // Whether the f32 extension is enabled in the target VM.
+  bool f32Extension = false;
 
   // Whether to truncate i64 types to i32 when the i64 extension is not
   // enabled.
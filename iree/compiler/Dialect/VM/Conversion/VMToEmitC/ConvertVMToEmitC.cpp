@@ -76,21 +76,207 @@ class ConstOpConversion : public OpConversionPattern<SrcOpTy> {
   StringRef funcName;
 };
 
+// Convert shift operations, passing the shift amount attribute as a trailing
+// argument after the operand.
+template <typename SrcOpTy>
+class ShiftOpConversion : public OpConversionPattern<SrcOpTy> {
+  using OpConversionPattern<SrcOpTy>::OpConversionPattern;
+
+ public:
+  ShiftOpConversion(MLIRContext *context, StringRef funcName)
+      : OpConversionPattern<SrcOpTy>(context), funcName(funcName) {}
+
+ private:
+  LogicalResult matchAndRewrite(
+      SrcOpTy op, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    StringAttr callee = rewriter.getStringAttr(funcName);
+    ArrayAttr args = rewriter.getArrayAttr(
+        {rewriter.getIndexAttr(0), op.amountAttr()});
+    ArrayAttr templateArgs;
+
+    rewriter.replaceOpWithNewOp<emitc::CallOp>(op, op.getType(), callee, args,
+                                               templateArgs, operands);
+
+    return success();
+  }
+
+  StringRef funcName;
+};
+
 }  // namespace
 
 void populateVMToCPatterns(MLIRContext *context,
                            OwningRewritePatternList &patterns) {
-  // Arithmetic
+  // Const
+  patterns.insert<ConstOpConversion<IREE::VM::ConstI32Op>>(context,
+                                                           "vm_const_i32");
+  patterns.insert<ConstOpConversion<IREE::VM::ConstI64Op>>(context,
+                                                           "vm_const_i64");
+  patterns.insert<ConstOpConversion<IREE::VM::ConstF32Op>>(context,
+                                                           "vm_const_f32");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::ConstI32ZeroOp>>(
+      context, "vm_const_i32_zero");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::ConstI64ZeroOp>>(
+      context, "vm_const_i64_zero");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::ConstF32ZeroOp>>(
+      context, "vm_const_f32_zero");
+
+  // Conditional assignment
+  patterns.insert<NoAttributeOpConversion<IREE::VM::SelectI32Op>>(
+      context, "vm_select_i32");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::SelectI64Op>>(
+      context, "vm_select_i64");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::SelectF32Op>>(
+      context, "vm_select_f32");
+
+  // Native integer arithmetic
   patterns.insert<NoAttributeOpConversion<IREE::VM::AddI32Op>>(context,
                                                                "vm_add_i32");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::SubI32Op>>(context,
+                                                               "vm_sub_i32");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::MulI32Op>>(context,
+                                                               "vm_mul_i32");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::DivI32SOp>>(context,
+                                                                "vm_div_i32_s");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::DivI32UOp>>(context,
+                                                                "vm_div_i32_u");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::RemI32SOp>>(context,
+                                                                "vm_rem_i32_s");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::RemI32UOp>>(context,
+                                                                "vm_rem_i32_u");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::NotI32Op>>(context,
+                                                               "vm_not_i32");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::AndI32Op>>(context,
+                                                               "vm_and_i32");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::OrI32Op>>(context,
+                                                              "vm_or_i32");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::XorI32Op>>(context,
+                                                               "vm_xor_i32");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::AddI64Op>>(context,
+                                                               "vm_add_i64");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::SubI64Op>>(context,
+                                                               "vm_sub_i64");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::MulI64Op>>(context,
+                                                               "vm_mul_i64");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::DivI64SOp>>(context,
+                                                                "vm_div_i64_s");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::DivI64UOp>>(context,
+                                                                "vm_div_i64_u");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::RemI64SOp>>(context,
+                                                                "vm_rem_i64_s");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::RemI64UOp>>(context,
+                                                                "vm_rem_i64_u");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::NotI64Op>>(context,
+                                                               "vm_not_i64");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::AndI64Op>>(context,
+                                                               "vm_and_i64");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::OrI64Op>>(context,
+                                                              "vm_or_i64");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::XorI64Op>>(context,
+                                                               "vm_xor_i64");
+
+  // Native floating-point arithmetic
+  patterns.insert<NoAttributeOpConversion<IREE::VM::AddF32Op>>(context,
+                                                               "vm_add_f32");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::SubF32Op>>(context,
+                                                               "vm_sub_f32");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::MulF32Op>>(context,
+                                                               "vm_mul_f32");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::DivF32Op>>(context,
+                                                               "vm_div_f32");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::RemF32Op>>(context,
+                                                               "vm_rem_f32");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::AbsF32Op>>(context,
+                                                               "vm_abs_f32");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::NegF32Op>>(context,
+                                                               "vm_neg_f32");
+
+  // Native bitwise shifts and rotates
+  patterns.insert<ShiftOpConversion<IREE::VM::ShlI32Op>>(context, "vm_shl_i32");
+  patterns.insert<ShiftOpConversion<IREE::VM::ShrI32SOp>>(context,
+                                                          "vm_shr_i32_s");
+  patterns.insert<ShiftOpConversion<IREE::VM::ShrI32UOp>>(context,
+                                                          "vm_shr_i32_u");
+  patterns.insert<ShiftOpConversion<IREE::VM::ShlI64Op>>(context, "vm_shl_i64");
+  patterns.insert<ShiftOpConversion<IREE::VM::ShrI64SOp>>(context,
+                                                          "vm_shr_i64_s");
+  patterns.insert<ShiftOpConversion<IREE::VM::ShrI64UOp>>(context,
+                                                          "vm_shr_i64_u");
+
+  // Casting and type conversion/emulation
+  patterns.insert<NoAttributeOpConversion<IREE::VM::TruncI32I8Op>>(
+      context, "vm_trunc_i32_i8");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::TruncI32I16Op>>(
+      context, "vm_trunc_i32_i16");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::TruncI64I32Op>>(
+      context, "vm_trunc_i64_i32");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::ExtI8I32SOp>>(
+      context, "vm_ext_i8_i32_s");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::ExtI8I32UOp>>(
+      context, "vm_ext_i8_i32_u");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::ExtI16I32SOp>>(
+      context, "vm_ext_i16_i32_s");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::ExtI16I32UOp>>(
+      context, "vm_ext_i16_i32_u");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::ExtI32I64SOp>>(
+      context, "vm_ext_i32_i64_s");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::ExtI32I64UOp>>(
+      context, "vm_ext_i32_i64_u");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::CastSI32F32Op>>(
+      context, "vm_cast_si32_f32");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::CastUI32F32Op>>(
+      context, "vm_cast_ui32_f32");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::CastF32SI32Op>>(
+      context, "vm_cast_f32_si32");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::CastF32UI32Op>>(
+      context, "vm_cast_f32_ui32");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::BitcastI32F32Op>>(
+      context, "vm_bitcast_i32_f32");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::BitcastF32I32Op>>(
+      context, "vm_bitcast_f32_i32");
 
   // Compare
+  patterns.insert<NoAttributeOpConversion<IREE::VM::CmpEQI32Op>>(
+      context, "vm_cmp_eq_i32");
   patterns.insert<NoAttributeOpConversion<IREE::VM::CmpNEI32Op>>(
       context, "vm_cmp_ne_i32");
-
-  // Const
-  patterns.insert<ConstOpConversion<IREE::VM::ConstI32Op>>(context,
-                                                           "vm_const_i32");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::CmpLTI32SOp>>(
+      context, "vm_cmp_lt_i32_s");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::CmpLTI32UOp>>(
+      context, "vm_cmp_lt_i32_u");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::CmpNZI32Op>>(
+      context, "vm_cmp_nz_i32");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::CmpEQI64Op>>(
+      context, "vm_cmp_eq_i64");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::CmpNEI64Op>>(
+      context, "vm_cmp_ne_i64");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::CmpLTI64SOp>>(
+      context, "vm_cmp_lt_i64_s");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::CmpLTI64UOp>>(
+      context, "vm_cmp_lt_i64_u");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::CmpNZI64Op>>(
+      context, "vm_cmp_nz_i64");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::CmpEQF32OOp>>(
+      context, "vm_cmp_eq_f32_o");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::CmpEQF32UOp>>(
+      context, "vm_cmp_eq_f32_u");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::CmpNEF32OOp>>(
+      context, "vm_cmp_ne_f32_o");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::CmpNEF32UOp>>(
+      context, "vm_cmp_ne_f32_u");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::CmpLTF32OOp>>(
+      context, "vm_cmp_lt_f32_o");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::CmpLTF32UOp>>(
+      context, "vm_cmp_lt_f32_u");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::CmpLTEF32OOp>>(
+      context, "vm_cmp_lte_f32_o");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::CmpLTEF32UOp>>(
+      context, "vm_cmp_lte_f32_u");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::CmpNaNF32Op>>(
+      context, "vm_cmp_nan_f32");
+  patterns.insert<NoAttributeOpConversion<IREE::VM::CmpNZF32Op>>(
+      context, "vm_cmp_nz_f32");
 }
 
 namespace IREE {
@@ -115,14 +301,60 @@ class ConvertVMToEmitCPass
     target.addLegalDialect<mlir::emitc::EmitCDialect>();
     target.addLegalDialect<IREE::VM::VMDialect>();
 
-    // Arithmetic
-    target.addIllegalOp<IREE::VM::AddI32Op>();
+    // Const
+    target.addIllegalOp<IREE::VM::ConstI32Op, IREE::VM::ConstI64Op,
+                        IREE::VM::ConstF32Op, IREE::VM::ConstI32ZeroOp,
+                        IREE::VM::ConstI64ZeroOp, IREE::VM::ConstF32ZeroOp>();
+
+    // Conditional assignment
+    target.addIllegalOp<IREE::VM::SelectI32Op, IREE::VM::SelectI64Op,
+                        IREE::VM::SelectF32Op>();
+
+    // Native integer arithmetic
+    target.addIllegalOp<IREE::VM::AddI32Op, IREE::VM::SubI32Op,
+                        IREE::VM::MulI32Op, IREE::VM::DivI32SOp,
+                        IREE::VM::DivI32UOp, IREE::VM::RemI32SOp,
+                        IREE::VM::RemI32UOp, IREE::VM::NotI32Op,
+                        IREE::VM::AndI32Op, IREE::VM::OrI32Op,
+                        IREE::VM::XorI32Op, IREE::VM::AddI64Op,
+                        IREE::VM::SubI64Op, IREE::VM::MulI64Op,
+                        IREE::VM::DivI64SOp, IREE::VM::DivI64UOp,
+                        IREE::VM::RemI64SOp, IREE::VM::RemI64UOp,
+                        IREE::VM::NotI64Op, IREE::VM::AndI64Op,
+                        IREE::VM::OrI64Op, IREE::VM::XorI64Op>();
+
+    // Native floating-point arithmetic
+    target.addIllegalOp<IREE::VM::AddF32Op, IREE::VM::SubF32Op,
+                        IREE::VM::MulF32Op, IREE::VM::DivF32Op,
+                        IREE::VM::RemF32Op, IREE::VM::AbsF32Op,
+                        IREE::VM::NegF32Op>();
+
+    // Native bitwise shifts and rotates
+    target.addIllegalOp<IREE::VM::ShlI32Op, IREE::VM::ShrI32SOp,
+                        IREE::VM::ShrI32UOp, IREE::VM::ShlI64Op,
+                        IREE::VM::ShrI64SOp, IREE::VM::ShrI64UOp>();
+
+    // Casting and type conversion/emulation
+    target.addIllegalOp<IREE::VM::TruncI32I8Op, IREE::VM::TruncI32I16Op,
+                        IREE::VM::TruncI64I32Op, IREE::VM::ExtI8I32SOp,
+                        IREE::VM::ExtI8I32UOp, IREE::VM::ExtI16I32SOp,
+                        IREE::VM::ExtI16I32UOp, IREE::VM::ExtI32I64SOp,
+                        IREE::VM::ExtI32I64UOp, IREE::VM::CastSI32F32Op,
+                        IREE::VM::CastUI32F32Op, IREE::VM::CastF32SI32Op,
+                        IREE::VM::CastF32UI32Op, IREE::VM::BitcastI32F32Op,
+                        IREE::VM::BitcastF32I32Op>();
 
     // Compare
-    target.addIllegalOp<IREE::VM::CmpNEI32Op>();
-
-    // Const
-    target.addIllegalOp<IREE::VM::ConstI32Op>();
+    target.addIllegalOp<IREE::VM::CmpEQI32Op, IREE::VM::CmpNEI32Op,
+                        IREE::VM::CmpLTI32SOp, IREE::VM::CmpLTI32UOp,
+                        IREE::VM::CmpNZI32Op, IREE::VM::CmpEQI64Op,
+                        IREE::VM::CmpNEI64Op, IREE::VM::CmpLTI64SOp,
+                        IREE::VM::CmpLTI64UOp, IREE::VM::CmpNZI64Op,
+                        IREE::VM::CmpEQF32OOp, IREE::VM::CmpEQF32UOp,
+                        IREE::VM::CmpNEF32OOp, IREE::VM::CmpNEF32UOp,
+                        IREE::VM::CmpLTF32OOp, IREE::VM::CmpLTF32UOp,
+                        IREE::VM::CmpLTEF32OOp, IREE::VM::CmpLTEF32UOp,
+                        IREE::VM::CmpNaNF32Op, IREE::VM::CmpNZF32Op>();
 
     if (failed(
             applyFullConversion(getOperation(), target, std::move(patterns)))) {
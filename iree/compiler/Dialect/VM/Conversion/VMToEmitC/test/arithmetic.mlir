@@ -10,3 +10,68 @@ vm.module @module {
     vm.return
   }
 }
+
+// -----
+
+// CHECK: vm.module @module {
+vm.module @module {
+  // CHECK-LABEL: vm.func @sub_i64
+  vm.func @sub_i64(%arg0: i64, %arg1: i64) {
+    // CHECK-NEXT: %0 = emitc.call "vm_sub_i64"(%arg0, %arg1) : (i64, i64) -> i64
+    %0 = vm.sub.i64 %arg0, %arg1 : i64
+    // CHECK-NEXT: vm.return
+    vm.return
+  }
+}
+
+// -----
+
+// CHECK: vm.module @module {
+vm.module @module {
+  // CHECK-LABEL: vm.func @div_i32_u
+  vm.func @div_i32_u(%arg0: i32, %arg1: i32) {
+    // CHECK-NEXT: %0 = emitc.call "vm_div_i32_u"(%arg0, %arg1) : (i32, i32) -> i32
+    %0 = vm.div.i32.u %arg0, %arg1 : i32
+    // CHECK-NEXT: vm.return
+    vm.return
+  }
+}
+
+// -----
+
+// CHECK: vm.module @module {
+vm.module @module {
+  // CHECK-LABEL: vm.func @mul_f32
+  vm.func @mul_f32(%arg0: f32, %arg1: f32) {
+    // CHECK-NEXT: %0 = emitc.call "vm_mul_f32"(%arg0, %arg1) : (f32, f32) -> f32
+    %0 = vm.mul.f32 %arg0, %arg1 : f32
+    // CHECK-NEXT: vm.return
+    vm.return
+  }
+}
+
+// -----
+
+// CHECK: vm.module @module {
+vm.module @module {
+  // CHECK-LABEL: vm.func @shl_i32
+  vm.func @shl_i32(%arg0: i32) {
+    // CHECK-NEXT: %0 = emitc.call "vm_shl_i32"(%arg0) {args = [0 : index, 2 : i8]} : (i32) -> i32
+    %0 = vm.shl.i32 %arg0, 2 : i32
+    // CHECK-NEXT: vm.return
+    vm.return
+  }
+}
+
+// -----
+
+// CHECK: vm.module @module {
+vm.module @module {
+  // CHECK-LABEL: vm.func @select_i32
+  vm.func @select_i32(%arg0: i32, %arg1: i32, %arg2: i32) {
+    // CHECK-NEXT: %0 = emitc.call "vm_select_i32"(%arg0, %arg1, %arg2) : (i32, i32, i32) -> i32
+    %0 = vm.select.i32 %arg0, %arg1, %arg2 : i32
+    // CHECK-NEXT: vm.return
+    vm.return
+  }
+}
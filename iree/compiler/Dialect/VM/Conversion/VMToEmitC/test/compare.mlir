@@ -10,3 +10,29 @@ vm.module @module {
     vm.return
   }
 }
+
+// -----
+
+// CHECK: vm.module @module {
+vm.module @module {
+  // CHECK-LABEL: vm.func @cmp_lt_i64_s
+  vm.func @cmp_lt_i64_s(%arg0 : i64, %arg1 : i64) {
+    // CHECK-NEXT: %0 = emitc.call "vm_cmp_lt_i64_s"(%arg0, %arg1) : (i64, i64) -> i32
+    %0 = vm.cmp.lt.i64.s %arg0, %arg1 : i64
+    // CHECK-NEXT: vm.return
+    vm.return
+  }
+}
+
+// -----
+
+// CHECK: vm.module @module {
+vm.module @module {
+  // CHECK-LABEL: vm.func @cmp_eq_f32_u
+  vm.func @cmp_eq_f32_u(%arg0 : f32, %arg1 : f32) {
+    // CHECK-NEXT: %0 = emitc.call "vm_cmp_eq_f32_u"(%arg0, %arg1) : (f32, f32) -> i32
+    %0 = vm.cmp.eq.f32.u %arg0, %arg1 : f32
+    // CHECK-NEXT: vm.return
+    vm.return
+  }
+}
@@ -14,3 +14,18 @@ vm.module @module {
     vm.return
   }
 }
+
+// -----
+
+// CHECK: vm.module @module {
+vm.module @module {
+  // CHECK-LABEL: vm.func @const_zero
+  vm.func @const_zero() {
+    // CHECK-NEXT: %0 = emitc.call "vm_const_i64_zero"() : () -> i64
+    %0 = vm.const.i64.zero : i64
+    // CHECK-NEXT: %1 = emitc.call "vm_const_f32"() {args = [1.500000e+00 : f32]} : () -> f32
+    %1 = vm.const.f32 1.5 : f32
+    // CHECK-NEXT: vm.return
+    vm.return
+  }
+}
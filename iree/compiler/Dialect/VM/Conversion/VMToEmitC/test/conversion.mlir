@@ -0,0 +1,18 @@
+// RUN: iree-opt -split-input-file -pass-pipeline='vm.module(iree-convert-vm-to-emitc)' %s | IreeFileCheck %s
+
+// CHECK: vm.module @module {
+vm.module @module {
+  // CHECK-LABEL: vm.func @conversions
+  vm.func @conversions(%arg0 : i32, %arg1 : f32) {
+    // CHECK-NEXT: %0 = emitc.call "vm_trunc_i32_i8"(%arg0) : (i32) -> i32
+    %0 = vm.trunc.i32.i8 %arg0 : i32 -> i32
+    // CHECK-NEXT: %1 = emitc.call "vm_ext_i32_i64_s"(%arg0) : (i32) -> i64
+    %1 = vm.ext.i32.i64.s %arg0 : i32 -> i64
+    // CHECK-NEXT: %2 = emitc.call "vm_cast_f32_si32"(%arg1) : (f32) -> i32
+    %2 = vm.cast.f32.si32 %arg1 : f32 -> i32
+    // CHECK-NEXT: %3 = emitc.call "vm_bitcast_i32_f32"(%arg0) : (i32) -> f32
+    %3 = vm.bitcast.i32.f32 %arg0 : i32 -> f32
+    // CHECK-NEXT: vm.return
+    vm.return
+  }
+}
@@ -57,6 +57,9 @@ class VMFuncEncoder {
   // Encodes an integer attribute as a fixed byte length based on bitwidth.
   virtual LogicalResult encodeIntAttr(IntegerAttr value) = 0;
 
+  // Encodes a float attribute as a fixed byte length based on bitwidth.
+  virtual LogicalResult encodeFloatAttr(FloatAttr value) = 0;
+
   // Encodes a variable-length integer array attribute.
   virtual LogicalResult encodeIntArrayAttr(DenseIntElementsAttr value) = 0;
 
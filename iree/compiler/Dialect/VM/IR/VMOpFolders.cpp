@@ -105,8 +105,15 @@ struct DropDefaultConstGlobalOpInitializer : public OpRewritePattern<T> {
   LogicalResult matchAndRewrite(T op,
                                 PatternRewriter &rewriter) const override {
     if (!op.initial_value().hasValue()) return failure();
-    auto value = op.initial_valueAttr().template cast<IntegerAttr>();
-    if (value.getValue() != 0) return failure();
+    Attribute value = op.initial_valueAttr();
+    if (auto intValue = value.template dyn_cast<IntegerAttr>()) {
+      if (intValue.getValue() != 0) return failure();
+    } else if (auto floatValue = value.template dyn_cast<FloatAttr>()) {
+      // -0.0 has a non-zero bit pattern and must be kept.
+      if (!floatValue.getValue().isPosZero()) return failure();
+    } else {
+      return failure();
+    }
     rewriter.replaceOpWithNewOp<T>(op, op.sym_name(), op.is_mutable(),
                                    op.type(),
                                    llvm::to_vector<4>(op->getDialectAttrs()));
@@ -128,6 +135,12 @@ void GlobalI64Op::getCanonicalizationPatterns(OwningRewritePatternList &results,
                  DropDefaultConstGlobalOpInitializer<GlobalI64Op>>(context);
 }
 
+void GlobalF32Op::getCanonicalizationPatterns(OwningRewritePatternList &results,
+                                              MLIRContext *context) {
+  results.insert<InlineConstGlobalOpInitializer<GlobalF32Op>,
+                 DropDefaultConstGlobalOpInitializer<GlobalF32Op>>(context);
+}
+
 void GlobalRefOp::getCanonicalizationPatterns(OwningRewritePatternList &results,
                                               MLIRContext *context) {
   results.insert<InlineConstGlobalOpInitializer<GlobalRefOp>>(context);
@@ -138,7 +151,7 @@ namespace {
 /// Inlines immutable global constants into their loads.
 template <typename LOAD_OP, typename GLOBAL_OP, typename CONST_OP,
           typename CONST_ZERO_OP>
-struct InlineConstGlobalLoadIntegerOp : public OpRewritePattern<LOAD_OP> {
+struct InlineConstGlobalLoadPrimitiveOp : public OpRewritePattern<LOAD_OP> {
   using OpRewritePattern<LOAD_OP>::OpRewritePattern;
   LogicalResult matchAndRewrite(LOAD_OP op,
                                 PatternRewriter &rewriter) const override {
@@ -162,15 +175,22 @@ struct InlineConstGlobalLoadIntegerOp : public OpRewritePattern<LOAD_OP> {
 
 void GlobalLoadI32Op::getCanonicalizationPatterns(
     OwningRewritePatternList &results, MLIRContext *context) {
-  results.insert<InlineConstGlobalLoadIntegerOp<GlobalLoadI32Op, GlobalI32Op,
-                                                ConstI32Op, ConstI32ZeroOp>>(
+  results.insert<InlineConstGlobalLoadPrimitiveOp<GlobalLoadI32Op, GlobalI32Op,
+                                                  ConstI32Op, ConstI32ZeroOp>>(
       context);
 }
 
 void GlobalLoadI64Op::getCanonicalizationPatterns(
     OwningRewritePatternList &results, MLIRContext *context) {
-  results.insert<InlineConstGlobalLoadIntegerOp<GlobalLoadI64Op, GlobalI64Op,
-                                                ConstI64Op, ConstI64ZeroOp>>(
+  results.insert<InlineConstGlobalLoadPrimitiveOp<GlobalLoadI64Op, GlobalI64Op,
+                                                  ConstI64Op, ConstI64ZeroOp>>(
+      context);
+}
+
+void GlobalLoadF32Op::getCanonicalizationPatterns(
+    OwningRewritePatternList &results, MLIRContext *context) {
+  results.insert<InlineConstGlobalLoadPrimitiveOp<GlobalLoadF32Op, GlobalF32Op,
+                                                  ConstF32Op, ConstF32ZeroOp>>(
       context);
 }
 
@@ -233,6 +253,13 @@ void GlobalLoadIndirectI64Op::getCanonicalizationPatterns(
       context);
 }
 
+void GlobalLoadIndirectF32Op::getCanonicalizationPatterns(
+    OwningRewritePatternList &results, MLIRContext *context) {
+  results.insert<
+      PropagateGlobalLoadAddress<GlobalLoadIndirectF32Op, GlobalLoadF32Op>>(
+      context);
+}
+
 void GlobalLoadIndirectRefOp::getCanonicalizationPatterns(
     OwningRewritePatternList &results, MLIRContext *context) {
   results.insert<
@@ -273,6 +300,13 @@ void GlobalStoreIndirectI64Op::getCanonicalizationPatterns(
       context);
 }
 
+void GlobalStoreIndirectF32Op::getCanonicalizationPatterns(
+    OwningRewritePatternList &results, MLIRContext *context) {
+  results.insert<
+      PropagateGlobalStoreAddress<GlobalStoreIndirectF32Op, GlobalStoreF32Op>>(
+      context);
+}
+
 void GlobalStoreIndirectRefOp::getCanonicalizationPatterns(
     OwningRewritePatternList &results, MLIRContext *context) {
   results.insert<
@@ -288,6 +322,8 @@ OpFoldResult ConstI32Op::fold(ArrayRef<Attribute> operands) { return value(); }
 
 OpFoldResult ConstI64Op::fold(ArrayRef<Attribute> operands) { return value(); }
 
+OpFoldResult ConstF32Op::fold(ArrayRef<Attribute> operands) { return value(); }
+
 OpFoldResult ConstI32ZeroOp::fold(ArrayRef<Attribute> operands) {
   return IntegerAttr::get(getResult().getType(), 0);
 }
@@ -296,6 +332,10 @@ OpFoldResult ConstI64ZeroOp::fold(ArrayRef<Attribute> operands) {
   return IntegerAttr::get(getResult().getType(), 0);
 }
 
+OpFoldResult ConstF32ZeroOp::fold(ArrayRef<Attribute> operands) {
+  return FloatAttr::get(getResult().getType(), 0.0);
+}
+
 OpFoldResult ConstRefZeroOp::fold(ArrayRef<Attribute> operands) {
   // TODO(b/144027097): relace unit attr with a proper null ref_ptr attr.
   return UnitAttr::get(getContext());
@@ -332,6 +372,10 @@ OpFoldResult SelectI64Op::fold(ArrayRef<Attribute> operands) {
   return foldSelectOp(*this);
 }
 
+OpFoldResult SelectF32Op::fold(ArrayRef<Attribute> operands) {
+  return foldSelectOp(*this);
+}
+
 OpFoldResult SelectRefOp::fold(ArrayRef<Attribute> operands) {
   return foldSelectOp(*this);
 }
@@ -720,6 +764,56 @@ OpFoldResult XorI64Op::fold(ArrayRef<Attribute> operands) {
   return foldXorOp(*this, operands);
 }
 
+//===----------------------------------------------------------------------===//
+// Native floating-point arithmetic
+//===----------------------------------------------------------------------===//
+
+// NOTE: identities such as x + 0 = x don't hold for floating-point values
+// (-0.0, NaN, etc) so only fully constant operands are folded.
+
+OpFoldResult AddF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldBinaryOp<FloatAttr>(
+      operands, [](const APFloat &a, const APFloat &b) { return a + b; });
+}
+
+OpFoldResult SubF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldBinaryOp<FloatAttr>(
+      operands, [](const APFloat &a, const APFloat &b) { return a - b; });
+}
+
+OpFoldResult MulF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldBinaryOp<FloatAttr>(
+      operands, [](const APFloat &a, const APFloat &b) { return a * b; });
+}
+
+OpFoldResult DivF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldBinaryOp<FloatAttr>(
+      operands, [](const APFloat &a, const APFloat &b) { return a / b; });
+}
+
+OpFoldResult RemF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldBinaryOp<FloatAttr>(
+      operands, [](const APFloat &a, const APFloat &b) {
+        APFloat result = a;
+        result.mod(b);
+        return result;
+      });
+}
+
+OpFoldResult AbsF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldUnaryOp<FloatAttr>(
+      operands, [](const APFloat &a) { return llvm::abs(a); });
+}
+
+OpFoldResult NegF32Op::fold(ArrayRef<Attribute> operands) {
+  if (auto negOp = dyn_cast_or_null<NegF32Op>(operand().getDefiningOp())) {
+    // -(-x) = x
+    return negOp.operand();
+  }
+  return constFoldUnaryOp<FloatAttr>(operands,
+                                     [](const APFloat &a) { return neg(a); });
+}
+
 //===----------------------------------------------------------------------===//
 // Native bitwise shifts and rotates
 //===----------------------------------------------------------------------===//
@@ -1360,6 +1454,78 @@ OpFoldResult CmpNZI64Op::fold(ArrayRef<Attribute> operands) {
       operands, [&](const APInt &a) { return APInt(64, a.getBoolValue()); });
 }
 
+/// Folds a floating-point comparison of two constant scalars to an i32 0/1.
+static Attribute constFoldFloatCmpOp(
+    ArrayRef<Attribute> operands, Type resultType,
+    llvm::function_ref<bool(APFloat::cmpResult)> predicate) {
+  assert(operands.size() == 2 && "binary op takes two operands");
+  auto lhs = operands[0].dyn_cast_or_null<FloatAttr>();
+  auto rhs = operands[1].dyn_cast_or_null<FloatAttr>();
+  if (!lhs || !rhs) return {};
+  bool result = predicate(lhs.getValue().compare(rhs.getValue()));
+  return IntegerAttr::get(resultType, result ? 1 : 0);
+}
+
+OpFoldResult CmpEQF32OOp::fold(ArrayRef<Attribute> operands) {
+  return constFoldFloatCmpOp(operands, getType(), [](APFloat::cmpResult r) {
+    return r == APFloat::cmpEqual;
+  });
+}
+
+OpFoldResult CmpEQF32UOp::fold(ArrayRef<Attribute> operands) {
+  return constFoldFloatCmpOp(operands, getType(), [](APFloat::cmpResult r) {
+    return r == APFloat::cmpEqual || r == APFloat::cmpUnordered;
+  });
+}
+
+OpFoldResult CmpNEF32OOp::fold(ArrayRef<Attribute> operands) {
+  return constFoldFloatCmpOp(operands, getType(), [](APFloat::cmpResult r) {
+    return r == APFloat::cmpLessThan || r == APFloat::cmpGreaterThan;
+  });
+}
+
+OpFoldResult CmpNEF32UOp::fold(ArrayRef<Attribute> operands) {
+  return constFoldFloatCmpOp(operands, getType(), [](APFloat::cmpResult r) {
+    return r != APFloat::cmpEqual;
+  });
+}
+
+OpFoldResult CmpLTF32OOp::fold(ArrayRef<Attribute> operands) {
+  return constFoldFloatCmpOp(operands, getType(), [](APFloat::cmpResult r) {
+    return r == APFloat::cmpLessThan;
+  });
+}
+
+OpFoldResult CmpLTF32UOp::fold(ArrayRef<Attribute> operands) {
+  return constFoldFloatCmpOp(operands, getType(), [](APFloat::cmpResult r) {
+    return r == APFloat::cmpLessThan || r == APFloat::cmpUnordered;
+  });
+}
+
+OpFoldResult CmpLTEF32OOp::fold(ArrayRef<Attribute> operands) {
+  return constFoldFloatCmpOp(operands, getType(), [](APFloat::cmpResult r) {
+    return r == APFloat::cmpLessThan || r == APFloat::cmpEqual;
+  });
+}
+
+OpFoldResult CmpLTEF32UOp::fold(ArrayRef<Attribute> operands) {
+  return constFoldFloatCmpOp(operands, getType(), [](APFloat::cmpResult r) {
+    return r != APFloat::cmpGreaterThan;
+  });
+}
+
+OpFoldResult CmpNaNF32Op::fold(ArrayRef<Attribute> operands) {
+  auto operand = operands[0].dyn_cast_or_null<FloatAttr>();
+  if (!operand) return {};
+  return IntegerAttr::get(getType(), operand.getValue().isNaN() ? 1 : 0);
+}
+
+OpFoldResult CmpNZF32Op::fold(ArrayRef<Attribute> operands) {
+  auto operand = operands[0].dyn_cast_or_null<FloatAttr>();
+  if (!operand) return {};
+  return IntegerAttr::get(getType(), operand.getValue().isZero() ? 0 : 1);
+}
+
 OpFoldResult CmpEQRefOp::fold(ArrayRef<Attribute> operands) {
   if (lhs() == rhs()) {
     // x == x = true
@@ -1740,7 +1906,7 @@ namespace {
 
 /// Rewrites a check op to a cmp and a cond_fail.
 template <typename CheckOp, typename CmpI32Op, typename CmpI64Op,
-          typename CmpRefOp>
+          typename CmpF32Op, typename CmpRefOp>
 struct RewriteCheckToCondFail : public OpRewritePattern<CheckOp> {
   using OpRewritePattern<CheckOp>::OpRewritePattern;
   LogicalResult matchAndRewrite(CheckOp op,
@@ -1760,6 +1926,10 @@ struct RewriteCheckToCondFail : public OpRewritePattern<CheckOp> {
       condValue = rewriter.template createOrFold<CmpI32Op>(
           op.getLoc(), ArrayRef<Type>{condType},
           op.getOperation()->getOperands());
+    } else if (operandType.isF32()) {
+      condValue = rewriter.template createOrFold<CmpF32Op>(
+          op.getLoc(), ArrayRef<Type>{condType},
+          op.getOperation()->getOperands());
     } else {
       return failure();
     }
@@ -1778,23 +1948,20 @@ struct RewriteCheckToCondFail : public OpRewritePattern<CheckOp> {
 
 void CheckEQOp::getCanonicalizationPatterns(OwningRewritePatternList &results,
                                             MLIRContext *context) {
-  results.insert<
-      RewriteCheckToCondFail<CheckEQOp, CmpEQI32Op, CmpEQI64Op, CmpEQRefOp>>(
-      context);
+  results.insert<RewriteCheckToCondFail<CheckEQOp, CmpEQI32Op, CmpEQI64Op,
+                                        CmpEQF32OOp, CmpEQRefOp>>(context);
 }
 
 void CheckNEOp::getCanonicalizationPatterns(OwningRewritePatternList &results,
                                             MLIRContext *context) {
-  results.insert<
-      RewriteCheckToCondFail<CheckNEOp, CmpNEI32Op, CmpNEI64Op, CmpNERefOp>>(
-      context);
+  results.insert<RewriteCheckToCondFail<CheckNEOp, CmpNEI32Op, CmpNEI64Op,
+                                        CmpNEF32UOp, CmpNERefOp>>(context);
 }
 
 void CheckNZOp::getCanonicalizationPatterns(OwningRewritePatternList &results,
                                             MLIRContext *context) {
-  results.insert<
-      RewriteCheckToCondFail<CheckNZOp, CmpNZI32Op, CmpNZI64Op, CmpNZRefOp>>(
-      context);
+  results.insert<RewriteCheckToCondFail<CheckNZOp, CmpNZI32Op, CmpNZI64Op,
+                                        CmpNZF32Op, CmpNZRefOp>>(context);
 }
 
 //===----------------------------------------------------------------------===//
@@ -422,3 +422,45 @@ vm.module @shr_i32_u_folds {
     vm.return %0 : i32
   }
 }
+
+// -----
+
+// CHECK-LABEL: @f32_folds
+vm.module @f32_folds {
+  // CHECK-LABEL: @add_f32_const
+  vm.func @add_f32_const() -> f32 {
+    // CHECK: %0 = vm.const.f32 5.000000e+00 : f32
+    // CHECK-NEXT: vm.return %0 : f32
+    %c1 = vm.const.f32 1.5 : f32
+    %c4 = vm.const.f32 3.5 : f32
+    %0 = vm.add.f32 %c1, %c4 : f32
+    vm.return %0 : f32
+  }
+
+  // CHECK-LABEL: @add_f32_x_0
+  vm.func @add_f32_x_0(%arg0 : f32) -> f32 {
+    // -0.0 + 0.0 = 0.0 so this must not fold away.
+    // CHECK: vm.add.f32
+    %zero = vm.const.f32.zero : f32
+    %0 = vm.add.f32 %arg0, %zero : f32
+    vm.return %0 : f32
+  }
+
+  // CHECK-LABEL: @neg_f32_neg
+  vm.func @neg_f32_neg(%arg0 : f32) -> f32 {
+    // CHECK: vm.return %arg0 : f32
+    %0 = vm.neg.f32 %arg0 : f32
+    %1 = vm.neg.f32 %0 : f32
+    vm.return %1 : f32
+  }
+
+  // CHECK-LABEL: @cmp_lt_f32_o_nan
+  vm.func @cmp_lt_f32_o_nan() -> i32 {
+    // CHECK: %zero = vm.const.i32.zero : i32
+    // CHECK-NEXT: vm.return %zero : i32
+    %nan = vm.const.f32 0x7FC00000 : f32
+    %c1 = vm.const.f32 1.0 : f32
+    %0 = vm.cmp.lt.f32.o %nan, %c1 : f32
+    vm.return %0 : i32
+  }
+}
@@ -153,3 +153,36 @@ vm.module @my_module {
     vm.return %0 : i32
   }
 }
+
+// -----
+
+// CHECK-LABEL: @add_f32
+vm.module @my_module {
+  vm.func @add_f32(%arg0 : f32, %arg1 : f32) -> f32 {
+    // CHECK: %0 = vm.add.f32 %arg0, %arg1 : f32
+    %0 = vm.add.f32 %arg0, %arg1 : f32
+    vm.return %0 : f32
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @rem_f32
+vm.module @my_module {
+  vm.func @rem_f32(%arg0 : f32, %arg1 : f32) -> f32 {
+    // CHECK: %0 = vm.rem.f32 %arg0, %arg1 : f32
+    %0 = vm.rem.f32 %arg0, %arg1 : f32
+    vm.return %0 : f32
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @neg_f32
+vm.module @my_module {
+  vm.func @neg_f32(%arg0 : f32) -> f32 {
+    // CHECK: %0 = vm.neg.f32 %arg0 : f32
+    %0 = vm.neg.f32 %arg0 : f32
+    vm.return %0 : f32
+  }
+}
@@ -155,3 +155,22 @@ vm.module @my_module {
     vm.return %rnz : i32
   }
 }
+
+// -----
+
+// CHECK-LABEL: @cmp_f32
+vm.module @my_module {
+  vm.func @cmp_f32(%arg0 : f32, %arg1 : f32) -> i32 {
+    // CHECK: %0 = vm.cmp.eq.f32.o %arg0, %arg1 : f32
+    %0 = vm.cmp.eq.f32.o %arg0, %arg1 : f32
+    // CHECK-NEXT: %1 = vm.cmp.ne.f32.u %arg0, %arg1 : f32
+    %1 = vm.cmp.ne.f32.u %arg0, %arg1 : f32
+    // CHECK-NEXT: %2 = vm.cmp.lt.f32.o %arg0, %arg1 : f32
+    %2 = vm.cmp.lt.f32.o %arg0, %arg1 : f32
+    // CHECK-NEXT: %3 = vm.cmp.lte.f32.u %arg0, %arg1 : f32
+    %3 = vm.cmp.lte.f32.u %arg0, %arg1 : f32
+    // CHECK-NEXT: %4 = vm.cmp.nan.f32 %arg0 : f32
+    %4 = vm.cmp.nan.f32 %arg0 : f32
+    vm.return %4 : i32
+  }
+}
@@ -65,3 +65,20 @@ vm.module @my_module {
     vm.return %5 : i64
   }
 }
+
+// -----
+
+// CHECK-LABEL: @cast_f32
+vm.module @my_module {
+  vm.func @cast_f32(%arg0 : i32) -> i32 {
+    // CHECK: %0 = vm.cast.si32.f32 %arg0 : i32 -> f32
+    %0 = vm.cast.si32.f32 %arg0 : i32 -> f32
+    // CHECK-NEXT: %1 = vm.cast.f32.ui32 %0 : f32 -> i32
+    %1 = vm.cast.f32.ui32 %0 : f32 -> i32
+    // CHECK-NEXT: %2 = vm.bitcast.i32.f32 %1 : i32 -> f32
+    %2 = vm.bitcast.i32.f32 %1 : i32 -> f32
+    // CHECK-NEXT: %3 = vm.bitcast.f32.i32 %2 : f32 -> i32
+    %3 = vm.bitcast.f32.i32 %2 : f32 -> i32
+    vm.return %3 : i32
+  }
+}
@@ -115,6 +115,22 @@ class V0BytecodeEncoder : public BytecodeEncoder {
     }
   }
 
+  LogicalResult encodeFloatAttr(FloatAttr value) override {
+    auto attr = value.cast<FloatAttr>();
+    unsigned int bitWidth = attr.getType().getIntOrFloatBitWidth();
+    uint64_t limitedValue =
+        attr.getValue().bitcastToAPInt().extractBitsAsZExtValue(bitWidth, 0);
+    switch (bitWidth) {
+      case 32:
+        return writeUint32(static_cast<uint32_t>(limitedValue));
+      case 64:
+        return writeUint64(static_cast<uint64_t>(limitedValue));
+      default:
+        return currentOp_->emitOpError()
+               << "attribute of bitwidth " << bitWidth << " not supported";
+    }
+  }
+
   LogicalResult encodeIntArrayAttr(DenseIntElementsAttr value) override {
     if (value.getNumElements() > UINT16_MAX ||
         failed(writeUint16(value.getNumElements()))) {
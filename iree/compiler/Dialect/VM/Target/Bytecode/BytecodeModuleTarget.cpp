@@ -25,6 +25,7 @@
 #include "iree/compiler/Dialect/VM/IR/VMOps.h"
 #include "iree/compiler/Dialect/VM/Target/Bytecode/BytecodeEncoder.h"
 #include "iree/compiler/Dialect/VM/Target/Bytecode/ConstantEncoder.h"
+#include "iree/compiler/Dialect/VM/Target/CallingConventionUtils.h"
 #include "iree/compiler/Dialect/VM/Transforms/Passes.h"
 #include "iree/compiler/Utils/FlatbufferUtils.h"
 #include "iree/schemas/bytecode_module_def_builder.h"
@@ -200,119 +201,6 @@ static LogicalResult canonicalizeModule(BytecodeTargetOptions targetOptions,
   return success();
 }
 
-// Encodes a type (or a tuple of nested types) to a calling convention string.
-//
-// Examples:
-//  i32              -> i
-//  !vm.ref<...>     -> r
-//  tuple<i32, i64>  -> iI
-static LogicalResult encodeCallingConventionType(Operation *op, Type type,
-                                                 SmallVectorImpl<char> &s) {
-  if (auto refPtrType = type.dyn_cast<IREE::VM::RefType>()) {
-    s.push_back('r');
-    return success();
-  } else if (auto intType = type.dyn_cast<IntegerType>()) {
-    switch (intType.getIntOrFloatBitWidth()) {
-      default:
-      case 32:
-        s.push_back('i');
-        return success();
-      case 64:
-        s.push_back('I');
-        return success();
-    }
-  } else if (auto tupleType = type.dyn_cast<TupleType>()) {
-    // Flatten tuple (so tuple<i32, i64> -> `...iI...`).
-    SmallVector<Type, 4> flattenedTypes;
-    tupleType.getFlattenedTypes(flattenedTypes);
-    for (auto elementType : flattenedTypes) {
-      if (failed(encodeCallingConventionType(op, elementType, s))) {
-        return op->emitError()
-               << "unsupported external calling convention tuple element type "
-               << elementType;
-      }
-    }
-    return success();
-  }
-  return op->emitError() << "unsupported external calling convention type "
-                         << type;
-}
-
-static LogicalResult encodeVariadicCallingConventionType(
-    Operation *op, Type type, SmallVectorImpl<char> &s) {
-  s.push_back('[');
-  auto result = encodeCallingConventionType(op, type, s);
-  s.push_back(']');
-  return result;
-}
-
-// Generates a string encoding the function type for defining the
-// FunctionSignatureDef::calling_convention field for import functions.
-//
-// This differs from makeCallingConventionString in that it supports variadic
-// arguments. Ideally we'd combine the two, but we only have this additional
-// metadata on IREE::VM::ImportOp.
-static Optional<std::string> makeImportCallingConventionString(
-    IREE::VM::ImportOp importOp) {
-  auto functionType = importOp.getType();
-  if (functionType.getNumInputs() == 0 && functionType.getNumResults() == 0) {
-    return std::string{};  // Valid but empty.
-  }
-
-  SmallVector<char, 8> s = {'0'};
-  for (int i = 0; i < functionType.getNumInputs(); ++i) {
-    if (importOp.isFuncArgumentVariadic(i)) {
-      if (failed(encodeVariadicCallingConventionType(
-              importOp, functionType.getInput(i), s))) {
-        return None;
-      }
-    } else {
-      if (failed(encodeCallingConventionType(importOp, functionType.getInput(i),
-                                             s))) {
-        return None;
-      }
-    }
-  }
-  if (functionType.getNumResults() > 0) {
-    s.push_back('.');
-    for (int i = 0; i < functionType.getNumResults(); ++i) {
-      if (failed(encodeCallingConventionType(importOp,
-                                             functionType.getResult(i), s))) {
-        return None;
-      }
-    }
-  }
-  return std::string(s.data(), s.size());
-}
-
-// Generates a string encoding the function type for defining the
-// FunctionSignatureDef::calling_convention field for internal/export functions.
-static Optional<std::string> makeCallingConventionString(
-    IREE::VM::FuncOp funcOp) {
-  auto functionType = funcOp.getType();
-  if (functionType.getNumInputs() == 0 && functionType.getNumResults() == 0) {
-    return std::string{};  // Valid but empty.
-  }
-
-  SmallVector<char, 8> s = {'0'};
-  for (int i = 0; i < functionType.getNumInputs(); ++i) {
-    if (failed(
-            encodeCallingConventionType(funcOp, functionType.getInput(i), s))) {
-      return None;
-    }
-  }
-  if (functionType.getNumResults() > 0) {
-    s.push_back('.');
-    for (int i = 0; i < functionType.getNumResults(); ++i) {
-      if (failed(encodeCallingConventionType(funcOp, functionType.getResult(i),
-                                             s))) {
-        return None;
-      }
-    }
-  }
-  return std::string(s.data(), s.size());
-}
-
 // Creates a FunctionSignatureDef based on the given function metadata.
 // Some fields are not used on all signature defs and added only when present on
 // the argument objects/attrs.
@@ -458,12 +346,13 @@ static LogicalResult buildFlatBufferModule(BytecodeTargetOptions targetOptions,
   // were to serialize all rodata we'd have it in the opposite order as we do
   // in the IR. Though this it isn't required for correctness, enabling file
   // layout planning by preserving the order in the IR is useful.
-  SmallVector<flatbuffers_uint8_vec_ref_t, 8> rodataContentRefs;
+  SmallVector<SerializedConstantRef, 8> rodataContentRefs;
   rodataContentRefs.reserve(rodataOps.size());
   for (auto rodataOp : llvm::reverse(rodataOps)) {
     auto rodataRef =
-        serializeConstant(rodataOp.getLoc(), rodataOp.value(), fbb);
-    if (!rodataRef) {
+        serializeConstant(rodataOp.getLoc(), rodataOp.value(),
+                          targetOptions.rodataCompression, fbb);
+    if (!rodataRef.dataRef) {
       return rodataOp.emitOpError() << "failed to encode";
     }
     rodataContentRefs.push_back(rodataRef);
@@ -528,8 +417,18 @@ static LogicalResult buildFlatBufferModule(BytecodeTargetOptions targetOptions,
   // Serialize metadata that should be near the front of the file.
   auto rodataSegmentRefs = llvm::to_vector<8>(
       llvm::map_range(rodataContentRefs, [&](auto rodataContentRef) {
+        iree_vm_CompressionTypeDef_union_ref_t compressionTypeRef = {};
+        if (rodataContentRef.compression == RodataCompression::kLZ4) {
+          compressionTypeRef = iree_vm_CompressionTypeDef_as_LZ4BlockDataDef(
+              iree_vm_LZ4BlockDataDef_create(
+                  fbb, rodataContentRef.decompressedSize));
+        }
         iree_vm_RodataSegmentDef_start(fbb);
-        iree_vm_RodataSegmentDef_data_add(fbb, rodataContentRef);
+        if (compressionTypeRef.type) {
+          iree_vm_RodataSegmentDef_compression_type_add(fbb,
+                                                        compressionTypeRef);
+        }
+        iree_vm_RodataSegmentDef_data_add(fbb, rodataContentRef.dataRef);
         return iree_vm_RodataSegmentDef_end(fbb);
       }));
   SmallVector<iree_vm_RwdataSegmentDef_ref_t, 8> rwdataSegmentRefs;
@@ -39,6 +39,15 @@ enum class BytecodeOutputFormat {
   kAnnotatedMlirText,
 };
 
+// Compression codec applied to rodata segments.
+enum class RodataCompression {
+  // Segments are stored as-is and can be mapped directly at runtime.
+  kNone,
+  // Segments that compress well are stored as LZ4 blocks and decompressed on
+  // first access at runtime.
+  kLZ4,
+};
+
 // Options that can be provided to bytecode translation.
 struct BytecodeTargetOptions {
   // Format of the module written to the output stream.
@@ -53,6 +62,11 @@ struct BytecodeTargetOptions {
   bool stripSourceMap = false;
   // Strips vm ops with the VM_DebugOnly trait.
   bool stripDebugOps = false;
+
+  // Compression used for rodata segments. Compressed segments shrink the
+  // module on disk but must be decompressed into memory at runtime instead of
+  // being used directly from the (possibly mapped) module file.
+  RodataCompression rodataCompression = RodataCompression::kNone;
 };
 
 // Translates a vm.module to a bytecode module flatbuffer.
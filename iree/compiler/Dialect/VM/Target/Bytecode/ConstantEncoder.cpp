@@ -14,6 +14,10 @@
 
 #include "iree/compiler/Dialect/VM/Target/Bytecode/ConstantEncoder.h"
 
+#include <vector>
+
+#include "iree/base/internal/lz4.h"
+
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/BuiltinTypes.h"
 #include "mlir/IR/Diagnostics.h"
@@ -25,14 +29,11 @@ namespace VM {
 
 // TODO(benvanik): switch to LLVM's BinaryStreamWriter to handle endianness.
 
-static flatbuffers_uint8_vec_ref_t serializeConstantI8Array(
-    DenseIntElementsAttr attr, FlatbufferBuilder &fbb) {
+static void serializeConstantI8Array(DenseIntElementsAttr attr,
+                                     uint8_t *bytePtr) {
   // vm.rodata and other very large constants end up as this; since i8 is i8
   // everywhere (endianness doesn't matter when you have one byte :) we can
   // directly access the data and memcpy.
-  flatbuffers_uint8_vec_start(fbb);
-  uint8_t *bytePtr =
-      flatbuffers_uint8_vec_extend(fbb, attr.getNumElements() * sizeof(int8_t));
   if (attr.isSplat()) {
     // NOTE: this is a slow path and we should have eliminated it earlier on
     // during constant op conversion.
@@ -43,117 +44,148 @@ static flatbuffers_uint8_vec_ref_t serializeConstantI8Array(
     auto rawData = attr.getRawData();
     std::memcpy(bytePtr, rawData.data(), rawData.size());
   }
-  return flatbuffers_uint8_vec_end(fbb);
 }
 
-static flatbuffers_uint8_vec_ref_t serializeConstantI16Array(
-    DenseIntElementsAttr attr, FlatbufferBuilder &fbb) {
-  flatbuffers_uint8_vec_start(fbb);
-  uint8_t *bytePtr = flatbuffers_uint8_vec_extend(
-      fbb, attr.getNumElements() * sizeof(int16_t));
+static void serializeConstantI16Array(DenseIntElementsAttr attr,
+                                      uint8_t *bytePtr) {
   uint16_t *nativePtr = reinterpret_cast<uint16_t *>(bytePtr);
   for (const APInt &value : attr.getIntValues()) {
     *(nativePtr++) = value.extractBitsAsZExtValue(16, 0) & UINT16_MAX;
   }
-  return flatbuffers_uint8_vec_end(fbb);
 }
 
-static flatbuffers_uint8_vec_ref_t serializeConstantI32Array(
-    DenseIntElementsAttr attr, FlatbufferBuilder &fbb) {
-  flatbuffers_uint8_vec_start(fbb);
-  uint8_t *bytePtr = flatbuffers_uint8_vec_extend(
-      fbb, attr.getNumElements() * sizeof(int32_t));
+static void serializeConstantI32Array(DenseIntElementsAttr attr,
+                                      uint8_t *bytePtr) {
   uint32_t *nativePtr = reinterpret_cast<uint32_t *>(bytePtr);
   for (const APInt &value : attr.getIntValues()) {
     *(nativePtr++) = value.extractBitsAsZExtValue(32, 0) & UINT32_MAX;
   }
-  return flatbuffers_uint8_vec_end(fbb);
 }
 
-static flatbuffers_uint8_vec_ref_t serializeConstantI64Array(
-    DenseIntElementsAttr attr, FlatbufferBuilder &fbb) {
-  flatbuffers_uint8_vec_start(fbb);
-  uint8_t *bytePtr = flatbuffers_uint8_vec_extend(
-      fbb, attr.getNumElements() * sizeof(int64_t));
+static void serializeConstantI64Array(DenseIntElementsAttr attr,
+                                      uint8_t *bytePtr) {
   uint64_t *nativePtr = reinterpret_cast<uint64_t *>(bytePtr);
   for (const APInt &value : attr.getIntValues()) {
     *(nativePtr++) = value.extractBitsAsZExtValue(64, 0) & UINT64_MAX;
   }
-  return flatbuffers_uint8_vec_end(fbb);
 }
 
-static flatbuffers_uint8_vec_ref_t serializeConstantF32Array(
-    DenseFPElementsAttr attr, FlatbufferBuilder &fbb) {
-  flatbuffers_uint8_vec_start(fbb);
-  uint8_t *bytePtr =
-      flatbuffers_uint8_vec_extend(fbb, attr.getNumElements() * sizeof(float));
+static void serializeConstantF32Array(DenseFPElementsAttr attr,
+                                      uint8_t *bytePtr) {
   float *nativePtr = reinterpret_cast<float *>(bytePtr);
   for (const APFloat &value : attr.getFloatValues()) {
     *(nativePtr++) = value.convertToFloat();
   }
-  return flatbuffers_uint8_vec_end(fbb);
 }
 
-static flatbuffers_uint8_vec_ref_t serializeConstantF64Array(
-    DenseFPElementsAttr attr, FlatbufferBuilder &fbb) {
-  flatbuffers_uint8_vec_start(fbb);
-  uint8_t *bytePtr =
-      flatbuffers_uint8_vec_extend(fbb, attr.getNumElements() * sizeof(double));
+static void serializeConstantF64Array(DenseFPElementsAttr attr,
+                                      uint8_t *bytePtr) {
   double *nativePtr = reinterpret_cast<double *>(bytePtr);
   for (const APFloat &value : attr.getFloatValues()) {
     *(nativePtr++) = value.convertToDouble();
   }
-  return flatbuffers_uint8_vec_end(fbb);
 }
 
-static flatbuffers_uint8_vec_ref_t serializeConstantF16Array(
-    DenseFPElementsAttr attr, FlatbufferBuilder &fbb) {
-  flatbuffers_uint8_vec_start(fbb);
-  uint8_t *bytePtr = flatbuffers_uint8_vec_extend(
-      fbb, attr.getNumElements() * sizeof(uint16_t));
+static void serializeConstantF16Array(DenseFPElementsAttr attr,
+                                      uint8_t *bytePtr) {
   uint16_t *nativePtr = reinterpret_cast<uint16_t *>(bytePtr);
   for (const APFloat &value : attr.getFloatValues()) {
     *(nativePtr++) =
         value.bitcastToAPInt().extractBitsAsZExtValue(16, 0) & UINT16_MAX;
   }
-  return flatbuffers_uint8_vec_end(fbb);
 }
 
-flatbuffers_uint8_vec_ref_t serializeConstant(Location loc,
-                                              ElementsAttr elementsAttr,
-                                              FlatbufferBuilder &fbb) {
+// Writes the contents of |elementsAttr| to |bytePtr|, which must have storage
+// for all elements. Fails if the element type cannot be encoded.
+static LogicalResult serializeConstantBytes(Location loc,
+                                            ElementsAttr elementsAttr,
+                                            uint8_t *bytePtr) {
   if (auto attr = elementsAttr.dyn_cast<DenseIntElementsAttr>()) {
     switch (attr.getType().getElementTypeBitWidth()) {
       case 8:
-        return serializeConstantI8Array(attr, fbb);
+        serializeConstantI8Array(attr, bytePtr);
+        return success();
       case 16:
-        return serializeConstantI16Array(attr, fbb);
+        serializeConstantI16Array(attr, bytePtr);
+        return success();
       case 32:
-        return serializeConstantI32Array(attr, fbb);
+        serializeConstantI32Array(attr, bytePtr);
+        return success();
       case 64:
-        return serializeConstantI64Array(attr, fbb);
+        serializeConstantI64Array(attr, bytePtr);
+        return success();
       default:
-        emitError(loc) << "unhandled element bitwidth "
-                       << attr.getType().getElementTypeBitWidth();
-        return {};
+        return emitError(loc) << "unhandled element bitwidth "
+                              << attr.getType().getElementTypeBitWidth();
     }
   } else if (auto attr = elementsAttr.dyn_cast<DenseFPElementsAttr>()) {
     switch (attr.getType().getElementTypeBitWidth()) {
       case 16:
-        return serializeConstantF16Array(attr, fbb);
+        serializeConstantF16Array(attr, bytePtr);
+        return success();
       case 32:
-        return serializeConstantF32Array(attr, fbb);
+        serializeConstantF32Array(attr, bytePtr);
+        return success();
       case 64:
-        return serializeConstantF64Array(attr, fbb);
+        serializeConstantF64Array(attr, bytePtr);
+        return success();
       default:
-        emitError(loc) << "unhandled element bitwidth "
-                       << attr.getType().getElementTypeBitWidth();
-        return {};
+        return emitError(loc) << "unhandled element bitwidth "
+                              << attr.getType().getElementTypeBitWidth();
     }
   }
-  emitError(loc) << "unimplemented attribute encoding: "
-                 << elementsAttr.getType();
-  return {};
+  return emitError(loc) << "unimplemented attribute encoding: "
+                        << elementsAttr.getType();
+}
+
+// Segments smaller than this are always stored uncompressed; the savings are
+// not worth the decompression allocation and the flatbuffer table overhead.
+static constexpr size_t kMinCompressedSegmentSize = 4 * 1024;
+
+SerializedConstantRef serializeConstant(Location loc,
+                                        ElementsAttr elementsAttr,
+                                        RodataCompression compression,
+                                        FlatbufferBuilder &fbb) {
+  SerializedConstantRef result;
+  unsigned bitWidth = elementsAttr.getType().getElementTypeBitWidth();
+  size_t totalSize = elementsAttr.getNumElements() * (bitWidth / 8);
+
+  if (compression == RodataCompression::kNone ||
+      totalSize < kMinCompressedSegmentSize) {
+    // Write directly into the flatbuffer to avoid an intermediate copy of
+    // what may be a very large constant.
+    flatbuffers_uint8_vec_start(fbb);
+    uint8_t *bytePtr = flatbuffers_uint8_vec_extend(fbb, totalSize);
+    if (failed(serializeConstantBytes(loc, elementsAttr, bytePtr))) {
+      flatbuffers_uint8_vec_end(fbb);
+      return result;
+    }
+    result.dataRef = flatbuffers_uint8_vec_end(fbb);
+    return result;
+  }
+
+  std::vector<uint8_t> rawData(totalSize);
+  if (failed(serializeConstantBytes(loc, elementsAttr, rawData.data()))) {
+    return result;
+  }
+
+  // Only keep the compressed form if it saves a meaningful amount of space;
+  // already-dense data (quantized weights, executable binaries, etc) usually
+  // doesn't and we'd rather be able to map it directly at runtime.
+  std::vector<uint8_t> compressedData(iree_lz4_block_compress_bound(totalSize));
+  size_t compressedSize = iree_lz4_block_compress(
+      iree_make_const_byte_span(rawData.data(), rawData.size()),
+      iree_make_byte_span(compressedData.data(), compressedData.size()));
+  if (compressedSize && compressedSize <= totalSize - totalSize / 8) {
+    result.dataRef = flatbuffers_uint8_vec_create(fbb, compressedData.data(),
+                                                  compressedSize);
+    result.compression = RodataCompression::kLZ4;
+    result.decompressedSize = totalSize;
+  } else {
+    result.dataRef =
+        flatbuffers_uint8_vec_create(fbb, rawData.data(), rawData.size());
+  }
+  return result;
 }
 
 }  // namespace VM
@@ -15,6 +15,7 @@
 #ifndef IREE_COMPILER_DIALECT_VM_TARGET_BYTECODE_CONSTANTENCODER_H_
 #define IREE_COMPILER_DIALECT_VM_TARGET_BYTECODE_CONSTANTENCODER_H_
 
+#include "iree/compiler/Dialect/VM/Target/Bytecode/BytecodeModuleTarget.h"
 #include "iree/compiler/Utils/FlatbufferUtils.h"
 #include "iree/schemas/bytecode_module_def_builder.h"
 #include "mlir/IR/Attributes.h"
@@ -25,10 +26,25 @@ namespace iree_compiler {
 namespace IREE {
 namespace VM {
 
+// A constant serialized into the FlatBuffer.
+struct SerializedConstantRef {
+  // Reference to the [uint8] vector with the (possibly compressed) contents.
+  // 0 if serialization failed.
+  flatbuffers_uint8_vec_ref_t dataRef = 0;
+  // Compression applied to the contents.
+  RodataCompression compression = RodataCompression::kNone;
+  // Size of the contents after decompression. Only valid if compressed.
+  uint64_t decompressedSize = 0;
+};
+
 // Serializes a constant attribute to the FlatBuffer as a binary blob.
-flatbuffers_uint8_vec_ref_t serializeConstant(Location loc,
-                                              ElementsAttr elementsAttr,
-                                              FlatbufferBuilder &fbb);
+// If |compression| is requested it will be applied only when the constant is
+// large enough and compresses well; callers must check the returned
+// compression type to see what was actually emitted.
+SerializedConstantRef serializeConstant(Location loc,
+                                        ElementsAttr elementsAttr,
+                                        RodataCompression compression,
+                                        FlatbufferBuilder &fbb);
 
 }  // namespace VM
 }  // namespace IREE
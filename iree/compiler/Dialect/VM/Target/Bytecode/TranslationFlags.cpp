@@ -66,6 +66,17 @@ static llvm::cl::opt<bool> stripDebugOpsFlag{
     llvm::cl::init(false),
 };
 
+static llvm::cl::opt<RodataCompression> rodataCompressionFlag{
+    "iree-vm-bytecode-module-rodata-compression",
+    llvm::cl::desc("Compression applied to large rodata segments"),
+    llvm::cl::init(RodataCompression::kNone),
+    llvm::cl::values(
+        clEnumValN(RodataCompression::kNone, "none",
+                   "Uncompressed; segments are used in-place from the module"),
+        clEnumValN(RodataCompression::kLZ4, "lz4",
+                   "LZ4 block compression; decompressed on first use")),
+};
+
 BytecodeTargetOptions getBytecodeTargetOptionsFromFlags() {
   BytecodeTargetOptions targetOptions;
   targetOptions.outputFormat = outputFormatFlag;
@@ -73,6 +84,7 @@ BytecodeTargetOptions getBytecodeTargetOptionsFromFlags() {
   targetOptions.stripSymbols = stripSymbolsFlag;
   targetOptions.stripSourceMap = stripSourceMapFlag;
   targetOptions.stripDebugOps = stripDebugOpsFlag;
+  targetOptions.rodataCompression = rodataCompressionFlag;
   return targetOptions;
 }
 
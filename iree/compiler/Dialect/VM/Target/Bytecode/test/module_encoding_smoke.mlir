@@ -30,3 +30,41 @@ vm.module @simple_module {
   // CHECK-NEXT:   0
   // CHECK-NEXT: ]
 }
+
+// -----
+
+// CHECK: "name": "f32_module"
+vm.module @f32_module {
+  // CHECK: "types": [{
+  // CHECK: "full_name": "f32"
+
+  vm.export @func
+
+  vm.func @func() -> f32 {
+    %0 = vm.const.f32 1.0 : f32
+    vm.return %0 : f32
+  }
+
+  // CHECK: "function_descriptors":
+  // CHECK-NEXT: {
+  // CHECK-NEXT:   "bytecode_offset": 0
+  // CHECK-NEXT:   "bytecode_length": 13
+  // CHECK-NEXT:   "i32_register_count": 1
+  // CHECK-NEXT:   "ref_register_count": 0
+  // CHECK-NEXT: }
+  //      CHECK: "bytecode_data": [
+  // CHECK-NEXT:   161,
+  // CHECK-NEXT:   9,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   128,
+  // CHECK-NEXT:   63,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   84,
+  // CHECK-NEXT:   1,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0
+  // CHECK-NEXT: ]
+}
@@ -0,0 +1,27 @@
+// RUN: iree-translate -split-input-file -iree-vm-ir-to-bytecode-module -iree-vm-bytecode-module-output-format=flatbuffer-text -iree-vm-bytecode-module-rodata-compression=lz4 %s | IreeFileCheck %s
+
+// CHECK: "name": "rodata_compression"
+vm.module @rodata_compression {
+  vm.export @func
+  vm.func @func() {
+    vm.return
+  }
+
+  // CHECK: "rodata_segments": [{
+
+  // Small segments are never compressed.
+  //  CHECK-NOT: "compression_type_type"
+  //      CHECK: "data": [
+  // CHECK-NEXT:   1,
+  // CHECK-NEXT:   2,
+  // CHECK-NEXT:   3
+  // CHECK-NEXT: ]
+  vm.rodata @small_i8s dense<[1, 2, 3]> : tensor<3xi8>
+
+  // Large compressible segments are stored as LZ4 blocks.
+  //      CHECK: "compression_type_type": "LZ4BlockDataDef",
+  // CHECK-NEXT: "compression_type": {
+  // CHECK-NEXT:   "decompressed_size": 32768
+  // CHECK-NEXT: },
+  vm.rodata @splat_float32s dense<1.000000e+00> : tensor<8192xf32>
+}
@@ -14,11 +14,20 @@
 
 #include "iree/compiler/Dialect/VM/Target/C/CModuleTarget.h"
 
-#include "emitc/Target/Cpp.h"
+#include <algorithm>
+
+#include "emitc/Dialect/EmitC/EmitCDialect.h"
 #include "iree/compiler/Dialect/IREE/IR/IREEOps.h"
+#include "iree/compiler/Dialect/IREE/IR/IREETypes.h"
 #include "iree/compiler/Dialect/IREE/Transforms/Passes.h"
 #include "iree/compiler/Dialect/VM/Conversion/VMToEmitC/ConvertVMToEmitC.h"
+#include "iree/compiler/Dialect/VM/Target/CallingConventionUtils.h"
 #include "iree/compiler/Dialect/VM/Transforms/Passes.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/MapVector.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/Format.h"
+#include "mlir/IR/SymbolTable.h"
 #include "mlir/Pass/PassManager.h"
 #include "mlir/Transforms/Passes.h"
 
@@ -27,15 +36,891 @@ namespace iree_compiler {
 namespace IREE {
 namespace VM {
 
+namespace {
+
+// Returns |name| with all characters that are not valid in C identifiers
+// replaced by underscores.
+static std::string sanitizeName(StringRef name) {
+  std::string result = name.str();
+  for (auto &c : result) {
+    if (!llvm::isAlnum(c)) c = '_';
+  }
+  return result;
+}
+
 static std::string buildFunctionName(IREE::VM::ModuleOp &moduleOp,
                                      IREE::VM::FuncOp &funcOp,
                                      bool implSuffix) {
   std::string functionName =
-      std::string(moduleOp.getName()) + "_" + std::string(funcOp.getName());
+      sanitizeName(moduleOp.getName()) + "_" + sanitizeName(funcOp.getName());
 
   return implSuffix ? functionName + "_impl" : functionName;
 }
 
+static int64_t getSymbolOrdinal(Operation *symbolOp) {
+  return symbolOp->getAttrOfType<IntegerAttr>("ordinal").getInt();
+}
+
+static bool isRefType(Type type) { return type.isa<IREE::VM::RefType>(); }
+
+// Returns the C type used to store primitive values of |type|.
+static Optional<StringRef> getCType(Type type) {
+  if (auto intType = type.dyn_cast<IntegerType>()) {
+    return intType.getWidth() == 64 ? StringRef("int64_t")
+                                    : StringRef("int32_t");
+  } else if (type.isF32()) {
+    return StringRef("float");
+  } else if (type.isa<IREE::PtrType>()) {
+    // Global addresses are byte offsets (or ordinals for refs).
+    return StringRef("int32_t");
+  }
+  return None;
+}
+
+// Returns the size in bytes of a primitive |type| in the call ABI buffers.
+static int64_t getPrimitiveABISize(Type type) {
+  return type.getIntOrFloatBitWidth() == 64 ? 8 : 4;
+}
+
+// A byte offset within a packed ABI buffer. The size of iree_vm_ref_t is only
+// known to the C compiler so offsets are kept symbolic.
+struct ABIOffset {
+  int64_t bytes = 0;
+  int64_t refs = 0;
+
+  void advance(Type type) {
+    if (isRefType(type)) {
+      ++refs;
+    } else {
+      bytes += getPrimitiveABISize(type);
+    }
+  }
+
+  bool isZero() const { return bytes == 0 && refs == 0; }
+
+  std::string str() const {
+    std::string result;
+    if (bytes || !refs) result = std::to_string(bytes);
+    if (refs) {
+      if (!result.empty()) result += " + ";
+      if (refs > 1) result += std::to_string(refs) + " * ";
+      result += "sizeof(iree_vm_ref_t)";
+    }
+    return result;
+  }
+};
+
+// Escapes |value| for use within a C string literal.
+static std::string escapeCString(StringRef value) {
+  std::string result;
+  llvm::raw_string_ostream os(result);
+  for (unsigned char c : value) {
+    if (c == '\\' || c == '"') {
+      os << '\\' << c;
+    } else if (llvm::isPrint(c)) {
+      os << c;
+    } else {
+      os << llvm::format("\\%03o", c);
+    }
+  }
+  return os.str();
+}
+
+// Returns an iree_string_view_t initializer for |value|. Static descriptors
+// can't use iree_make_cstring_view in C as it is not a constant expression.
+static std::string makeStringView(StringRef value) {
+  return "{\"" + escapeCString(value) + "\", " +
+         std::to_string(value.size()) + "}";
+}
+
+// Prints a C literal for an emitc.call argument attribute.
+static LogicalResult printLiteral(Operation *op, Attribute attr,
+                                  llvm::raw_ostream &output) {
+  if (auto intAttr = attr.dyn_cast<IntegerAttr>()) {
+    APInt value = intAttr.getValue();
+    if (intAttr.getType().getIntOrFloatBitWidth() == 64) {
+      if (value.isMinSignedValue()) {
+        output << "INT64_MIN";
+      } else {
+        output << "INT64_C(" << value.getSExtValue() << ")";
+      }
+    } else if (value.getBitWidth() == 32 && value.isMinSignedValue()) {
+      output << "INT32_MIN";
+    } else {
+      output << value.getSExtValue();
+    }
+    return success();
+  } else if (auto floatAttr = attr.dyn_cast<FloatAttr>()) {
+    APFloat value = floatAttr.getValue();
+    if (value.isNaN()) {
+      output << "NAN";
+    } else if (value.isInfinity()) {
+      output << (value.isNegative() ? "-INFINITY" : "INFINITY");
+    } else {
+      // 9 significant digits round-trip any float.
+      std::string str;
+      llvm::raw_string_ostream os(str);
+      os << llvm::format("%.9g", value.convertToFloat());
+      os.flush();
+      if (str.find_first_of(".e") == std::string::npos) str += ".0";
+      output << str << "f";
+    }
+    return success();
+  }
+  return op->emitOpError() << "unsupported literal attribute " << attr;
+}
+
+// Module-level information shared by all function emitters.
+struct ModuleInfo {
+  IREE::VM::ModuleOp moduleOp;
+  std::string moduleName;
+  std::string stateType;
+  SymbolTable symbolTable;
+  int64_t globalBytes = 0;
+  int64_t globalRefs = 0;
+  // Names of registered ref types (list element types) by type table index.
+  llvm::MapVector<std::string, int> refTypeNames;
+
+  explicit ModuleInfo(IREE::VM::ModuleOp moduleOp)
+      : moduleOp(moduleOp),
+        moduleName(sanitizeName(moduleOp.getName())),
+        stateType(moduleName + "_state_t"),
+        symbolTable(moduleOp) {}
+};
+
+// Emits the body of a vm.func as a C function.
+//
+// All values are declared at the top of the function so that blocks can be
+// jumped to with goto; ref values live in a zero-initialized array that is
+// released on the way out of the function.
+class FunctionEmitter {
+ public:
+  FunctionEmitter(ModuleInfo &moduleInfo, IREE::VM::FuncOp funcOp)
+      : moduleInfo(moduleInfo), funcOp(funcOp) {}
+
+  LogicalResult emit(llvm::raw_ostream &output);
+
+ private:
+  void assignNames();
+
+  StringRef name(Value value) { return valueNames[value]; }
+  std::string ref(Value value) { return "&" + valueNames[value]; }
+
+  // Emits a check of the local status that exits the function on failure.
+  void emitStatusCheck(llvm::raw_ostream &os);
+  void emitExit(llvm::raw_ostream &os);
+
+  LogicalResult emitOp(Operation &op, llvm::raw_ostream &os);
+  LogicalResult emitEmitCCall(emitc::CallOp callOp, llvm::raw_ostream &os);
+  LogicalResult emitBranchOperands(Block *dest, OperandRange operands,
+                                   llvm::raw_ostream &os);
+  LogicalResult emitCall(Operation *op, FlatSymbolRefAttr calleeAttr,
+                         ArrayRef<int64_t> segmentSizes,
+                         llvm::raw_ostream &os);
+  LogicalResult emitImportCall(Operation *op, IREE::VM::ImportOp importOp,
+                               ArrayRef<int64_t> segmentSizes,
+                               llvm::raw_ostream &os);
+  LogicalResult emitListElementType(Operation *op, Type listType,
+                                    llvm::raw_ostream &os);
+
+  ModuleInfo &moduleInfo;
+  IREE::VM::FuncOp funcOp;
+  llvm::DenseMap<Value, std::string> valueNames;
+  llvm::DenseMap<Block *, int> blockOrdinals;
+  int refCount = 0;
+  bool usesStatus = false;
+};
+
+void FunctionEmitter::assignNames() {
+  int valueOrdinal = 0;
+  int blockOrdinal = 0;
+  auto assignName = [&](Value value) {
+    if (isRefType(value.getType())) {
+      valueNames[value] = "refs[" + std::to_string(refCount++) + "]";
+    } else {
+      valueNames[value] = "v" + std::to_string(valueOrdinal++);
+    }
+  };
+  for (auto &block : funcOp.getBlocks()) {
+    blockOrdinals[&block] = blockOrdinal++;
+    for (auto arg : block.getArguments()) assignName(arg);
+    for (auto &op : block) {
+      for (auto result : op.getResults()) assignName(result);
+    }
+  }
+}
+
+void FunctionEmitter::emitStatusCheck(llvm::raw_ostream &os) {
+  usesStatus = true;
+  if (refCount > 0) {
+    os << "  if (IREE_UNLIKELY(!iree_status_is_ok(status))) goto cleanup;\n";
+  } else {
+    os << "  if (IREE_UNLIKELY(!iree_status_is_ok(status))) return status;\n";
+  }
+}
+
+void FunctionEmitter::emitExit(llvm::raw_ostream &os) {
+  if (refCount > 0) {
+    os << "  goto cleanup;\n";
+  } else if (usesStatus) {
+    os << "  return status;\n";
+  } else {
+    os << "  return iree_ok_status();\n";
+  }
+}
+
+LogicalResult FunctionEmitter::emit(llvm::raw_ostream &output) {
+  assignNames();
+
+  // Emit the body first so we know which locals are required.
+  std::string body;
+  llvm::raw_string_ostream os(body);
+  for (auto &block : funcOp.getBlocks()) {
+    if (!block.isEntryBlock()) {
+      os << "block_" << blockOrdinals[&block] << ":\n";
+    }
+    for (auto &op : block) {
+      if (failed(emitOp(op, os))) return failure();
+    }
+  }
+  os.flush();
+
+  // Signature. Ref arguments are borrowed and results are assigned.
+  auto functionType = funcOp.getType();
+  output << "static iree_status_t "
+         << buildFunctionName(moduleInfo.moduleOp, funcOp, /*implSuffix=*/true)
+         << "(\n    iree_vm_stack_t* stack, " << moduleInfo.stateType
+         << "* state";
+  auto &entryBlock = funcOp.getBlocks().front();
+  for (auto arg : llvm::enumerate(entryBlock.getArguments())) {
+    if (isRefType(arg.value().getType())) {
+      output << ", iree_vm_ref_t* arg" << arg.index();
+    } else {
+      output << ", " << *getCType(arg.value().getType()) << " "
+             << name(arg.value());
+    }
+  }
+  for (auto resultType : llvm::enumerate(functionType.getResults())) {
+    if (isRefType(resultType.value())) {
+      output << ", iree_vm_ref_t* out" << resultType.index();
+    } else {
+      output << ", " << *getCType(resultType.value()) << "* out"
+             << resultType.index();
+    }
+  }
+  output << ") {\n";
+
+  // Locals.
+  if (usesStatus) {
+    output << "  iree_status_t status = iree_ok_status();\n";
+  }
+  if (refCount > 0) {
+    output << "  iree_vm_ref_t refs[" << refCount << "];\n"
+           << "  memset(refs, 0, sizeof(refs));\n";
+  }
+  for (auto &block : funcOp.getBlocks()) {
+    auto declare = [&](Value value) {
+      if (isRefType(value.getType())) return;
+      output << "  " << *getCType(value.getType()) << " " << name(value)
+             << " = 0;\n";
+    };
+    if (!block.isEntryBlock()) {
+      for (auto arg : block.getArguments()) declare(arg);
+    }
+    for (auto &op : block) {
+      for (auto result : op.getResults()) declare(result);
+    }
+  }
+  for (auto arg : llvm::enumerate(entryBlock.getArguments())) {
+    if (isRefType(arg.value().getType())) {
+      output << "  iree_vm_ref_retain(arg" << arg.index() << ", "
+             << ref(arg.value()) << ");\n";
+    }
+  }
+
+  output << body;
+
+  if (refCount > 0) {
+    output << "cleanup:\n"
+           << "  for (int i = 0; i < " << refCount << "; ++i) {\n"
+           << "    iree_vm_ref_release(&refs[i]);\n"
+           << "  }\n"
+           << "  return " << (usesStatus ? "status" : "iree_ok_status()")
+           << ";\n";
+  }
+  output << "}\n";
+  return success();
+}
+
+LogicalResult FunctionEmitter::emitEmitCCall(emitc::CallOp callOp,
+                                             llvm::raw_ostream &os) {
+  os << "  ";
+  if (callOp.getNumResults() == 1) {
+    os << name(callOp.getResult(0)) << " = ";
+  }
+  os << callOp.callee() << "(";
+  auto args = callOp.args();
+  if (!args.hasValue()) {
+    llvm::interleaveComma(callOp.getOperands(), os,
+                          [&](Value operand) { os << name(operand); });
+  } else {
+    bool first = true;
+    for (auto arg : args.getValue()) {
+      if (!first) os << ", ";
+      first = false;
+      if (arg.getType().isIndex()) {
+        int64_t index = arg.cast<IntegerAttr>().getInt();
+        os << name(callOp.getOperand(index));
+      } else if (failed(printLiteral(callOp, arg, os))) {
+        return failure();
+      }
+    }
+  }
+  os << ");\n";
+  return success();
+}
+
+LogicalResult FunctionEmitter::emitBranchOperands(Block *dest,
+                                                  OperandRange operands,
+                                                  llvm::raw_ostream &os) {
+  // Block arguments are assigned as a parallel copy. We only need to go
+  // through temporaries when a destination is also read as a source.
+  bool needsTemporaries = false;
+  for (auto it : llvm::enumerate(operands)) {
+    for (auto destArg : llvm::enumerate(dest->getArguments())) {
+      if (it.value() == destArg.value() && it.index() != destArg.index()) {
+        needsTemporaries = true;
+      }
+    }
+  }
+
+  if (!needsTemporaries) {
+    for (auto it : llvm::zip(operands, dest->getArguments())) {
+      Value operand = std::get<0>(it);
+      Value destArg = std::get<1>(it);
+      if (operand == destArg) continue;
+      if (isRefType(operand.getType())) {
+        os << "  iree_vm_ref_retain(" << ref(operand) << ", " << ref(destArg)
+           << ");\n";
+      } else {
+        os << "  " << name(destArg) << " = " << name(operand) << ";\n";
+      }
+    }
+  } else {
+    os << "  {\n";
+    for (auto it : llvm::enumerate(operands)) {
+      Value operand = it.value();
+      if (isRefType(operand.getType())) {
+        os << "    iree_vm_ref_t t" << it.index()
+           << " = vm_ref_retain_copy(" << ref(operand) << ");\n";
+      } else {
+        os << "    " << *getCType(operand.getType()) << " t" << it.index()
+           << " = " << name(operand) << ";\n";
+      }
+    }
+    for (auto destArg : llvm::enumerate(dest->getArguments())) {
+      if (isRefType(destArg.value().getType())) {
+        os << "    iree_vm_ref_move(&t" << destArg.index() << ", "
+           << ref(destArg.value()) << ");\n";
+      } else {
+        os << "    " << name(destArg.value()) << " = t" << destArg.index()
+           << ";\n";
+      }
+    }
+    os << "  }\n";
+  }
+  os << "  goto block_" << blockOrdinals[dest] << ";\n";
+  return success();
+}
+
+LogicalResult FunctionEmitter::emitCall(Operation *op,
+                                        FlatSymbolRefAttr calleeAttr,
+                                        ArrayRef<int64_t> segmentSizes,
+                                        llvm::raw_ostream &os) {
+  auto *calleeOp = moduleInfo.symbolTable.lookup(calleeAttr.getValue());
+  if (auto importOp = dyn_cast_or_null<IREE::VM::ImportOp>(calleeOp)) {
+    return emitImportCall(op, importOp, segmentSizes, os);
+  }
+  auto calleeFuncOp = dyn_cast_or_null<IREE::VM::FuncOp>(calleeOp);
+  if (!calleeFuncOp) {
+    return op->emitOpError() << "callee " << calleeAttr << " not found";
+  }
+
+  // Internal calls go directly to the implementation function.
+  os << "  status = "
+     << buildFunctionName(moduleInfo.moduleOp, calleeFuncOp,
+                          /*implSuffix=*/true)
+     << "(stack, state";
+  for (auto operand : op->getOperands()) {
+    os << ", "
+       << (isRefType(operand.getType()) ? ref(operand) : name(operand).str());
+  }
+  for (auto result : op->getResults()) {
+    os << ", "
+       << (isRefType(result.getType()) ? ref(result)
+                                       : "&" + name(result).str());
+  }
+  os << ");\n";
+  emitStatusCheck(os);
+  return success();
+}
+
+LogicalResult FunctionEmitter::emitImportCall(Operation *op,
+                                              IREE::VM::ImportOp importOp,
+                                              ArrayRef<int64_t> segmentSizes,
+                                              llvm::raw_ostream &os) {
+  auto importType = importOp.getType();
+
+  // Flattens the import argument types as laid out in the ABI buffer. Each
+  // variadic segment is prefixed by its i32 element count.
+  struct Slot {
+    Type type;
+    Value value;    // null for segment counts
+    int64_t count;  // segment count when value is null
+  };
+  SmallVector<Slot, 8> argumentSlots;
+  auto operandIt = op->operand_begin();
+  for (unsigned i = 0; i < importType.getNumInputs(); ++i) {
+    SmallVector<Type, 4> elementTypes;
+    if (auto tupleType = importType.getInput(i).dyn_cast<TupleType>()) {
+      tupleType.getFlattenedTypes(elementTypes);
+    } else {
+      elementTypes.push_back(importType.getInput(i));
+    }
+    int64_t segmentSize = segmentSizes.empty() ? -1 : segmentSizes[i];
+    int64_t elementCount = 1;
+    if (segmentSize >= 0) {
+      argumentSlots.push_back(
+          {IntegerType::get(32, op->getContext()), nullptr, segmentSize});
+      elementCount = segmentSize;
+    }
+    for (int64_t j = 0; j < elementCount; ++j) {
+      for (auto elementType : elementTypes) {
+        if (operandIt == op->operand_end()) {
+          return op->emitOpError() << "operand count mismatch with import";
+        }
+        argumentSlots.push_back({elementType, *operandIt++, 0});
+      }
+    }
+  }
+
+  ABIOffset argumentSize;
+  for (auto &slot : argumentSlots) argumentSize.advance(slot.type);
+  ABIOffset resultSize;
+  bool hasResultRefs = false;
+  for (auto resultType : importType.getResults()) {
+    resultSize.advance(resultType);
+    hasResultRefs |= isRefType(resultType);
+  }
+
+  os << "  {\n";
+  if (!argumentSize.isZero()) {
+    os << "    uint64_t argument_storage[(" << argumentSize.str()
+       << " + 7) / 8];\n"
+       << "    uint8_t* arguments = (uint8_t*)argument_storage;\n";
+  }
+  if (!resultSize.isZero()) {
+    os << "    uint64_t result_storage[(" << resultSize.str()
+       << " + 7) / 8];\n"
+       << "    uint8_t* results = (uint8_t*)result_storage;\n";
+    if (hasResultRefs) {
+      os << "    memset(result_storage, 0, sizeof(result_storage));\n";
+    }
+  }
+
+  ABIOffset offset;
+  for (auto &slot : argumentSlots) {
+    if (!slot.value) {
+      os << "    vm_global_store_i32(arguments, " << offset.str() << ", "
+         << slot.count << ");\n";
+    } else if (isRefType(slot.type)) {
+      os << "    vm_abi_retain_ref(arguments + " << offset.str() << ", "
+         << ref(slot.value) << ");\n";
+    } else {
+      os << "    memcpy(arguments + " << offset.str() << ", &"
+         << name(slot.value) << ", sizeof(" << name(slot.value) << "));\n";
+    }
+    offset.advance(slot.type);
+  }
+
+  os << "    status = " << moduleInfo.moduleName
+     << "_call_import(stack, state, " << getSymbolOrdinal(importOp) << ", ";
+  if (argumentSize.isZero()) {
+    os << "iree_make_byte_span(NULL, 0)";
+  } else {
+    os << "iree_make_byte_span(arguments, " << argumentSize.str() << ")";
+  }
+  os << ",\n        ";
+  if (resultSize.isZero()) {
+    os << "iree_make_byte_span(NULL, 0)";
+  } else {
+    os << "iree_make_byte_span(results, " << resultSize.str() << ")";
+  }
+  os << ");\n";
+
+  // Primitive results are only valid when the call succeeded. Refs are always
+  // taken from the zeroed buffer so that any the callee assigned before
+  // failing are released along with our other locals.
+  offset = ABIOffset();
+  std::string resultCopies;
+  llvm::raw_string_ostream resultOs(resultCopies);
+  for (auto result : op->getResults()) {
+    if (isRefType(result.getType())) {
+      os << "    vm_abi_take_ref(results + " << offset.str() << ", "
+         << ref(result) << ");\n";
+    } else {
+      resultOs << "      memcpy(&" << name(result) << ", results + "
+               << offset.str() << ", sizeof(" << name(result) << "));\n";
+    }
+    offset.advance(result.getType());
+  }
+  resultOs.flush();
+  if (!resultCopies.empty()) {
+    os << "    if (iree_status_is_ok(status)) {\n"
+       << resultCopies << "    }\n";
+  }
+  os << "  }\n";
+  emitStatusCheck(os);
+  return success();
+}
+
+LogicalResult FunctionEmitter::emitListElementType(Operation *op,
+                                                   Type listType,
+                                                   llvm::raw_ostream &os) {
+  Type elementType = listType.cast<IREE::VM::RefType>()
+                         .getObjectType()
+                         .cast<IREE::VM::ListType>()
+                         .getElementType();
+  if (auto refType = elementType.dyn_cast_or_null<IREE::VM::RefType>()) {
+    elementType = refType.getObjectType();
+  }
+  if (!elementType || elementType.isa<IREE::VM::OpaqueType>()) {
+    os << "iree_vm_type_def_make_variant_type()";
+    return success();
+  } else if (auto intType = elementType.dyn_cast<IntegerType>()) {
+    os << "iree_vm_type_def_make_value_type(IREE_VM_VALUE_TYPE_I"
+       << intType.getWidth() << ")";
+    return success();
+  } else if (elementType.isF32()) {
+    os << "iree_vm_type_def_make_value_type(IREE_VM_VALUE_TYPE_F32)";
+    return success();
+  }
+
+  // Match the bytecode module type resolution: types are looked up by name
+  // without the `!` prefix and all list types resolve to vm.list.
+  std::string typeName;
+  llvm::raw_string_ostream typeNameOs(typeName);
+  elementType.print(typeNameOs);
+  typeNameOs.flush();
+  if (!StringRef(typeName).startswith("!")) {
+    os << "iree_vm_type_def_make_variant_type()";
+    return success();
+  }
+  typeName = typeName.substr(1);
+  if (StringRef(typeName).startswith("vm.list<")) typeName = "vm.list";
+  int typeOrdinal = moduleInfo.refTypeNames
+                        .insert({typeName, moduleInfo.refTypeNames.size()})
+                        .first->second;
+  os << "iree_vm_type_def_make_ref_type(state->types[" << typeOrdinal << "])";
+  return success();
+}
+
+LogicalResult FunctionEmitter::emitOp(Operation &op, llvm::raw_ostream &os) {
+  if (auto callOp = dyn_cast<emitc::CallOp>(op)) {
+    return emitEmitCCall(callOp, os);
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Globals
+  //===--------------------------------------------------------------------===//
+
+  auto globalOrdinal = [&]() {
+    auto globalAttr = op.getAttrOfType<FlatSymbolRefAttr>("global");
+    return getSymbolOrdinal(
+        moduleInfo.symbolTable.lookup(globalAttr.getValue()));
+  };
+  auto primitiveSuffix = [](Type type) -> std::string {
+    if (type.isF32()) return "f32";
+    return type.getIntOrFloatBitWidth() == 64 ? "i64" : "i32";
+  };
+  if (auto addressOp = dyn_cast<IREE::VM::GlobalAddressOp>(op)) {
+    os << "  " << name(addressOp.getResult()) << " = " << globalOrdinal()
+       << ";\n";
+    return success();
+  } else if (isa<IREE::VM::GlobalLoadI32Op, IREE::VM::GlobalLoadI64Op,
+                 IREE::VM::GlobalLoadF32Op>(op)) {
+    Value result = op.getResult(0);
+    os << "  " << name(result) << " = vm_global_load_"
+       << primitiveSuffix(result.getType()) << "(state->rwdata, "
+       << globalOrdinal() << ");\n";
+    return success();
+  } else if (isa<IREE::VM::GlobalStoreI32Op, IREE::VM::GlobalStoreI64Op,
+                 IREE::VM::GlobalStoreF32Op>(op)) {
+    Value value = op.getOperand(0);
+    os << "  vm_global_store_" << primitiveSuffix(value.getType())
+       << "(state->rwdata, " << globalOrdinal() << ", " << name(value)
+       << ");\n";
+    return success();
+  } else if (isa<IREE::VM::GlobalLoadIndirectI32Op,
+                 IREE::VM::GlobalLoadIndirectI64Op,
+                 IREE::VM::GlobalLoadIndirectF32Op>(op)) {
+    Value result = op.getResult(0);
+    os << "  status = vm_global_load_indirect_"
+       << primitiveSuffix(result.getType())
+       << "(state->rwdata, sizeof(state->rwdata), " << name(op.getOperand(0))
+       << ", &" << name(result) << ");\n";
+    emitStatusCheck(os);
+    return success();
+  } else if (isa<IREE::VM::GlobalStoreIndirectI32Op,
+                 IREE::VM::GlobalStoreIndirectI64Op,
+                 IREE::VM::GlobalStoreIndirectF32Op>(op)) {
+    Value value = op.getOperand(0);
+    os << "  status = vm_global_store_indirect_"
+       << primitiveSuffix(value.getType())
+       << "(state->rwdata, sizeof(state->rwdata), " << name(op.getOperand(1))
+       << ", " << name(value) << ");\n";
+    emitStatusCheck(os);
+    return success();
+  } else if (isa<IREE::VM::GlobalLoadRefOp>(op)) {
+    os << "  iree_vm_ref_retain(&state->global_refs[" << globalOrdinal()
+       << "], " << ref(op.getResult(0)) << ");\n";
+    return success();
+  } else if (isa<IREE::VM::GlobalStoreRefOp>(op)) {
+    os << "  iree_vm_ref_retain(" << ref(op.getOperand(0))
+       << ", &state->global_refs[" << globalOrdinal() << "]);\n";
+    return success();
+  } else if (isa<IREE::VM::GlobalLoadIndirectRefOp>(op)) {
+    os << "  status = vm_global_load_indirect_ref(state->global_refs, "
+       << "IREE_ARRAYSIZE(state->global_refs), " << name(op.getOperand(0))
+       << ", " << ref(op.getResult(0)) << ");\n";
+    emitStatusCheck(os);
+    return success();
+  } else if (isa<IREE::VM::GlobalStoreIndirectRefOp>(op)) {
+    os << "  status = vm_global_store_indirect_ref(state->global_refs, "
+       << "IREE_ARRAYSIZE(state->global_refs), " << name(op.getOperand(1))
+       << ", " << ref(op.getOperand(0)) << ");\n";
+    emitStatusCheck(os);
+    return success();
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Constants
+  //===--------------------------------------------------------------------===//
+
+  if (isa<IREE::VM::ConstRefZeroOp>(op)) {
+    os << "  iree_vm_ref_release(" << ref(op.getResult(0)) << ");\n";
+    return success();
+  } else if (auto rodataOp = dyn_cast<IREE::VM::ConstRefRodataOp>(op)) {
+    auto *segmentOp = moduleInfo.symbolTable.lookup(rodataOp.rodata());
+    os << "  status = iree_vm_ref_wrap_retain(&state->rodata_buffers["
+       << getSymbolOrdinal(segmentOp)
+       << "],\n      iree_vm_ro_byte_buffer_type_id(), "
+       << ref(rodataOp.getResult()) << ");\n";
+    emitStatusCheck(os);
+    return success();
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Lists
+  //===--------------------------------------------------------------------===//
+
+  if (auto allocOp = dyn_cast<IREE::VM::ListAllocOp>(op)) {
+    os << "  status = vm_list_alloc(";
+    if (failed(emitListElementType(&op, allocOp.getType(), os))) {
+      return failure();
+    }
+    os << ",\n      " << name(allocOp.getOperand()) << ", state->allocator, "
+       << ref(allocOp.getResult()) << ");\n";
+    emitStatusCheck(os);
+    return success();
+  } else if (isa<IREE::VM::ListReserveOp>(op)) {
+    os << "  status = vm_list_reserve(" << ref(op.getOperand(0)) << ", "
+       << name(op.getOperand(1)) << ");\n";
+    emitStatusCheck(os);
+    return success();
+  } else if (isa<IREE::VM::ListSizeOp>(op)) {
+    os << "  status = vm_list_size(" << ref(op.getOperand(0)) << ", &"
+       << name(op.getResult(0)) << ");\n";
+    emitStatusCheck(os);
+    return success();
+  } else if (isa<IREE::VM::ListResizeOp>(op)) {
+    os << "  status = vm_list_resize(" << ref(op.getOperand(0)) << ", "
+       << name(op.getOperand(1)) << ");\n";
+    emitStatusCheck(os);
+    return success();
+  } else if (isa<IREE::VM::ListGetI32Op, IREE::VM::ListGetI64Op,
+                 IREE::VM::ListGetF32Op>(op)) {
+    Value result = op.getResult(0);
+    os << "  status = vm_list_get_" << primitiveSuffix(result.getType())
+       << "(" << ref(op.getOperand(0)) << ", " << name(op.getOperand(1))
+       << ", &" << name(result) << ");\n";
+    emitStatusCheck(os);
+    return success();
+  } else if (isa<IREE::VM::ListSetI32Op, IREE::VM::ListSetI64Op,
+                 IREE::VM::ListSetF32Op>(op)) {
+    Value value = op.getOperand(2);
+    os << "  status = vm_list_set_" << primitiveSuffix(value.getType())
+       << "(" << ref(op.getOperand(0)) << ", " << name(op.getOperand(1))
+       << ", " << name(value) << ");\n";
+    emitStatusCheck(os);
+    return success();
+  } else if (isa<IREE::VM::ListGetRefOp>(op)) {
+    os << "  status = vm_list_get_ref(" << ref(op.getOperand(0)) << ", "
+       << name(op.getOperand(1)) << ", " << ref(op.getResult(0)) << ");\n";
+    emitStatusCheck(os);
+    return success();
+  } else if (isa<IREE::VM::ListSetRefOp>(op)) {
+    os << "  status = vm_list_set_ref(" << ref(op.getOperand(0)) << ", "
+       << name(op.getOperand(1)) << ", " << ref(op.getOperand(2)) << ");\n";
+    emitStatusCheck(os);
+    return success();
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Conditional assignment and ref comparison
+  //===--------------------------------------------------------------------===//
+
+  if (isa<IREE::VM::SelectRefOp>(op)) {
+    os << "  iree_vm_ref_retain(" << name(op.getOperand(0)) << " ? "
+       << ref(op.getOperand(1)) << " : " << ref(op.getOperand(2)) << ", "
+       << ref(op.getResult(0)) << ");\n";
+    return success();
+  } else if (isa<IREE::VM::SwitchI32Op, IREE::VM::SwitchI64Op,
+                 IREE::VM::SwitchRefOp>(op)) {
+    Value result = op.getResult(0);
+    auto assign = [&](Value value) {
+      if (isRefType(result.getType())) {
+        os << "iree_vm_ref_retain(" << ref(value) << ", " << ref(result)
+           << ");";
+      } else {
+        os << name(result) << " = " << name(value) << ";";
+      }
+    };
+    os << "  switch (" << name(op.getOperand(0)) << ") {\n";
+    for (auto value : llvm::enumerate(op.getOperands().drop_front(2))) {
+      os << "    case " << value.index() << ": ";
+      assign(value.value());
+      os << " break;\n";
+    }
+    os << "    default: ";
+    assign(op.getOperand(1));
+    os << " break;\n  }\n";
+    return success();
+  } else if (isa<IREE::VM::CmpEQRefOp>(op)) {
+    os << "  " << name(op.getResult(0)) << " = vm_cmp_eq_ref("
+       << ref(op.getOperand(0)) << ", " << ref(op.getOperand(1)) << ");\n";
+    return success();
+  } else if (isa<IREE::VM::CmpNERefOp>(op)) {
+    os << "  " << name(op.getResult(0)) << " = vm_cmp_ne_ref("
+       << ref(op.getOperand(0)) << ", " << ref(op.getOperand(1)) << ");\n";
+    return success();
+  } else if (isa<IREE::VM::CmpNZRefOp>(op)) {
+    os << "  " << name(op.getResult(0)) << " = vm_cmp_nz_ref("
+       << ref(op.getOperand(0)) << ");\n";
+    return success();
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Control flow
+  //===--------------------------------------------------------------------===//
+
+  if (auto branchOp = dyn_cast<IREE::VM::BranchOp>(op)) {
+    return emitBranchOperands(branchOp.getDest(), branchOp.getOperands(), os);
+  } else if (auto condBranchOp = dyn_cast<IREE::VM::CondBranchOp>(op)) {
+    os << "  if (" << name(condBranchOp.condition()) << ") {\n";
+    std::string trueBody;
+    llvm::raw_string_ostream trueOs(trueBody);
+    if (failed(emitBranchOperands(condBranchOp.getTrueDest(),
+                                  condBranchOp.getTrueOperands(), trueOs))) {
+      return failure();
+    }
+    trueOs.flush();
+    // Indent the nested branch.
+    SmallVector<StringRef, 8> lines;
+    StringRef(trueBody).split(lines, '\n', -1, /*KeepEmpty=*/false);
+    for (auto line : lines) os << "  " << line << "\n";
+    os << "  }\n";
+    return emitBranchOperands(condBranchOp.getFalseDest(),
+                              condBranchOp.getFalseOperands(), os);
+  } else if (auto callOp = dyn_cast<IREE::VM::CallOp>(op)) {
+    return emitCall(&op, callOp.calleeAttr(), {}, os);
+  } else if (auto callOp = dyn_cast<IREE::VM::CallVariadicOp>(op)) {
+    SmallVector<int64_t, 4> segmentSizes;
+    for (auto segmentSize : callOp.segment_sizes()) {
+      segmentSizes.push_back(segmentSize.getSExtValue());
+    }
+    return emitCall(&op, callOp.calleeAttr(), segmentSizes, os);
+  } else if (auto returnOp = dyn_cast<IREE::VM::ReturnOp>(op)) {
+    for (auto operand : llvm::enumerate(returnOp.getOperands())) {
+      if (isRefType(operand.value().getType())) {
+        os << "  iree_vm_ref_retain(" << ref(operand.value()) << ", out"
+           << operand.index() << ");\n";
+      } else {
+        os << "  *out" << operand.index() << " = " << name(operand.value())
+           << ";\n";
+      }
+    }
+    emitExit(os);
+    return success();
+  } else if (auto failOp = dyn_cast<IREE::VM::FailOp>(op)) {
+    usesStatus = true;
+    os << "  status = iree_status_allocate(\n      (iree_status_code_t)"
+       << name(failOp.status()) << ", \"<vm>\", 0,\n      "
+       << "iree_make_cstring_view(\""
+       << escapeCString(failOp.message().getValueOr("")) << "\"));\n";
+    emitExit(os);
+    return success();
+  } else if (isa<IREE::VM::YieldOp>(op)) {
+    // Native functions always run to completion so yields are no-ops.
+    return success();
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Debugging
+  //===--------------------------------------------------------------------===//
+
+  // These match the bytecode interpreter: tracing and printing are not yet
+  // wired up to anything and breaks continue at their destination as if no
+  // debugger were attached. Operands are owned by the function and released on
+  // exit so there is nothing to discard.
+  if (auto traceOp = dyn_cast<IREE::VM::TraceOp>(op)) {
+    os << "  // vm.trace \"" << escapeCString(traceOp.event_name()) << "\"\n";
+    return success();
+  } else if (auto printOp = dyn_cast<IREE::VM::PrintOp>(op)) {
+    os << "  // vm.print \"" << escapeCString(printOp.message()) << "\"\n";
+    return success();
+  } else if (auto breakOp = dyn_cast<IREE::VM::BreakOp>(op)) {
+    return emitBranchOperands(breakOp.getDest(), breakOp.destOperands(), os);
+  } else if (auto condBreakOp = dyn_cast<IREE::VM::CondBreakOp>(op)) {
+    return emitBranchOperands(condBreakOp.getDest(),
+                              condBreakOp.destOperands(), os);
+  }
+
+  return op.emitOpError() << "not supported by the C target";
+}
+
+// Serializes the contents of |rodataOp| as raw bytes matching the layout used
+// by the bytecode module.
+static LogicalResult serializeRodata(IREE::VM::RodataOp rodataOp,
+                                     std::vector<uint8_t> &bytes) {
+  auto attr = rodataOp.value().dyn_cast<DenseElementsAttr>();
+  unsigned bitWidth =
+      attr ? attr.getType().getElementTypeBitWidth() : /*invalid=*/1;
+  if (!attr || bitWidth % 8 != 0) {
+    return rodataOp.emitOpError()
+           << "unsupported rodata encoding: " << rodataOp.value().getType();
+  }
+  ArrayRef<char> rawData = attr.getRawData();
+  int64_t totalSize = attr.getNumElements() * (bitWidth / 8);
+  bytes.reserve(totalSize);
+  while (static_cast<int64_t>(bytes.size()) < totalSize) {
+    // Splats store a single element.
+    bytes.insert(bytes.end(), rawData.begin(), rawData.end());
+  }
+  bytes.resize(totalSize);
+  return success();
+}
+
 static void printModuleComment(IREE::VM::ModuleOp &moduleOp,
                                llvm::raw_ostream &output) {
   output << "//" << std::string(77, '=') << "\n"
@@ -56,171 +941,367 @@ static void printSeparatingComment(llvm::raw_ostream &output) {
          << std::string(77, '=') << "\n";
 }
 
-static LogicalResult translateCallOpToC(mlir::emitc::CppEmitter &emitter,
-                                        IREE::VM::CallOp callOp,
-                                        llvm::raw_ostream &output) {
-  return success();
-}
+// Emits the module state struct and the rodata contents it references.
+static LogicalResult buildModuleState(ModuleInfo &moduleInfo,
+                                      ArrayRef<IREE::VM::RodataOp> rodataOps,
+                                      int64_t importCount,
+                                      llvm::raw_ostream &output) {
+  const std::string &moduleName = moduleInfo.moduleName;
 
-static LogicalResult translateReturnOpToC(
-    mlir::emitc::CppEmitter &emitter, IREE::VM::ReturnOp returnOp,
-    llvm::raw_ostream &output, std::vector<std::string> resultNames) {
-  for (std::tuple<Value, std::string> tuple :
-       llvm::zip(returnOp.getOperands(), resultNames)) {
-    Value operand = std::get<0>(tuple);
-    std::string resultName = std::get<1>(tuple);
-    output << "*" << resultName << " = " << emitter.getOrCreateName(operand)
-           << ";\n";
+  for (auto rodataOp : rodataOps) {
+    std::vector<uint8_t> bytes;
+    if (failed(serializeRodata(rodataOp, bytes))) return failure();
+    output << "static const uint8_t " << moduleName << "_rodata_"
+           << getSymbolOrdinal(rodataOp) << "_[" << std::max<size_t>(
+                                                     bytes.size(), 1)
+           << "] = {";
+    for (size_t i = 0; i < bytes.size(); ++i) {
+      if (i % 12 == 0) output << "\n   ";
+      output << llvm::format(" 0x%02X,", bytes[i]);
+    }
+    output << "\n};\n";
   }
+  if (!rodataOps.empty()) output << "\n";
 
-  output << "return iree_ok_status();\n";
-
+  // NOTE: zero-length arrays are not valid C so each table has at least one
+  // entry.
+  output << "struct " << moduleName << "_state_s {\n"
+         << "  iree_allocator_t allocator;\n"
+         << "  uint8_t rwdata[" << std::max<int64_t>(moduleInfo.globalBytes, 1)
+         << "];\n"
+         << "  iree_vm_ref_t global_refs["
+         << std::max<int64_t>(moduleInfo.globalRefs, 1) << "];\n"
+         << "  iree_vm_ro_byte_buffer_t rodata_buffers["
+         << std::max<size_t>(rodataOps.size(), 1) << "];\n"
+         << "  iree_vm_function_t imports["
+         << std::max<int64_t>(importCount, 1) << "];\n"
+         << "  iree_vm_ref_type_t types["
+         << std::max<size_t>(moduleInfo.refTypeNames.size(), 1) << "];\n"
+         << "};\n\n";
   return success();
 }
 
-static LogicalResult translateOpToC(mlir::emitc::CppEmitter &emitter,
-                                    Operation &op, llvm::raw_ostream &output,
-                                    std::vector<std::string> resultNames) {
-  if (auto callOp = dyn_cast<IREE::VM::CallOp>(op))
-    return translateCallOpToC(emitter, callOp, output);
-  if (auto returnOp = dyn_cast<IREE::VM::ReturnOp>(op))
-    return translateReturnOpToC(emitter, returnOp, output, resultNames);
-  if (succeeded(emitter.emitOperation(op))) {
-    return success();
+// Emits the shared helper used to issue all import calls.
+static void buildImportCallHelper(ModuleInfo &moduleInfo,
+                                  llvm::raw_ostream &output) {
+  output << "static iree_status_t " << moduleInfo.moduleName
+         << "_call_import(\n    iree_vm_stack_t* stack, "
+         << moduleInfo.stateType << "* state, iree_host_size_t ordinal,\n"
+         << "    iree_byte_span_t arguments, iree_byte_span_t results) {\n"
+         << R"(  iree_vm_function_call_t call;
+  call.function = state->imports[ordinal];
+  call.arguments = arguments;
+  call.results = results;
+  iree_vm_execution_result_t result;
+  memset(&result, 0, sizeof(result));
+  iree_status_t status = call.function.module->begin_call(
+      call.function.module->self, stack, &call, &result);
+  if (IREE_UNLIKELY(!iree_status_is_ok(status))) {
+    return iree_status_annotate(status,
+                                iree_make_cstring_view("while calling import"));
   }
-
-  return failure();
+  if (IREE_UNLIKELY(result.state != IREE_VM_EXECUTION_STATE_COMPLETE)) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "imports called from C modules must not suspend");
+  }
+  return iree_ok_status();
 }
 
-static LogicalResult translateFunctionToC(mlir::emitc::CppEmitter &emitter,
-                                          IREE::VM::ModuleOp &moduleOp,
-                                          IREE::VM::FuncOp &funcOp,
-                                          llvm::raw_ostream &output) {
-  emitc::CppEmitter::Scope scope(emitter);
-
-  // this function later gets wrapped with argument marshalling code
-  std::string functionName =
-      buildFunctionName(moduleOp, funcOp, /*implSuffix=*/true);
-
-  output << "iree_status_t " << functionName << "(";
-
-  mlir::emitc::interleaveCommaWithError(
-      funcOp.getArguments(), output, [&](auto arg) -> LogicalResult {
-        if (failed(emitter.emitType(arg.getType()))) {
-          return failure();
-        }
-        output << " " << emitter.getOrCreateName(arg);
-        return success();
-      });
+)";
+}
 
-  if (funcOp.getNumResults() > 0) {
-    output << ", ";
+// Emits the shim that unpacks the VM ABI for an exported function and calls
+// the implementation.
+static LogicalResult buildExportShim(ModuleInfo &moduleInfo,
+                                     IREE::VM::FuncOp funcOp,
+                                     llvm::raw_ostream &output) {
+  auto functionType = funcOp.getType();
+  ABIOffset argumentSize;
+  int64_t argumentRefCount = 0;
+  for (auto type : functionType.getInputs()) {
+    argumentSize.advance(type);
+    if (isRefType(type)) ++argumentRefCount;
   }
-
-  std::vector<std::string> resultNames;
-  for (size_t idx = 0; idx < funcOp.getNumResults(); idx++) {
-    std::string resultName("out");
-    resultName.append(std::to_string(idx));
-    resultNames.push_back(resultName);
+  ABIOffset resultSize;
+  int64_t resultRefCount = 0;
+  for (auto type : functionType.getResults()) {
+    resultSize.advance(type);
+    if (isRefType(type)) ++resultRefCount;
   }
 
-  mlir::emitc::interleaveCommaWithError(
-      llvm::zip(funcOp.getType().getResults(), resultNames), output,
-      [&](std::tuple<Type, std::string> tuple) -> LogicalResult {
-        Type type = std::get<0>(tuple);
-        std::string resultName = std::get<1>(tuple);
-
-        if (failed(emitter.emitType(type))) {
-          return failure();
-        }
-        output << " *" << resultName;
-        return success();
-      });
+  output << "static iree_status_t "
+         << buildFunctionName(moduleInfo.moduleOp, funcOp, /*implSuffix=*/false)
+         << "_shim(\n    iree_vm_stack_t* stack, "
+            "const iree_vm_function_call_t* call,\n"
+            "    iree_vm_native_function_target_t target_fn, void* module,\n"
+            "    void* module_state, iree_vm_execution_result_t* out_result) "
+            "{\n"
+         << "  " << moduleInfo.stateType << "* state = ("
+         << moduleInfo.stateType << "*)module_state;\n";
+  SmallVector<std::string, 2> sizeChecks;
+  if (!argumentSize.isZero()) {
+    sizeChecks.push_back("call->arguments.data_length < " +
+                         argumentSize.str());
+  }
+  if (!resultSize.isZero()) {
+    sizeChecks.push_back("call->results.data_length < " + resultSize.str());
+  }
+  if (!sizeChecks.empty()) {
+    output << "  if (IREE_UNLIKELY(" << llvm::join(sizeChecks, " ||\n      ")
+           << ")) {\n"
+           << "    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,\n"
+           << "                            \"function ABI buffers too "
+              "small\");\n"
+           << "  }\n";
+  }
 
-  output << ") {\n";
+  // Arguments are owned by the callee: refs are moved out of the buffer.
+  std::string callArgs;
+  ABIOffset offset;
+  int64_t refIndex = 0;
+  if (argumentRefCount > 0) {
+    output << "  iree_vm_ref_t argument_refs[" << argumentRefCount << "];\n"
+           << "  memset(argument_refs, 0, sizeof(argument_refs));\n";
+  }
+  for (auto type : llvm::enumerate(functionType.getInputs())) {
+    if (isRefType(type.value())) {
+      output << "  vm_abi_take_ref(call->arguments.data + " << offset.str()
+             << ", &argument_refs[" << refIndex << "]);\n";
+      callArgs += ", &argument_refs[" + std::to_string(refIndex++) + "]";
+    } else {
+      std::string argName = "arg" + std::to_string(type.index());
+      output << "  " << *getCType(type.value()) << " " << argName << ";\n"
+             << "  memcpy(&" << argName << ", call->arguments.data + "
+             << offset.str() << ", sizeof(" << argName << "));\n";
+      callArgs += ", " + argName;
+    }
+    offset.advance(type.value());
+  }
 
-  for (auto &op : funcOp.getOps()) {
-    if (failed(translateOpToC(emitter, op, output, resultNames))) {
-      return failure();
+  refIndex = 0;
+  if (resultRefCount > 0) {
+    output << "  iree_vm_ref_t result_refs[" << resultRefCount << "];\n"
+           << "  memset(result_refs, 0, sizeof(result_refs));\n";
+  }
+  for (auto type : llvm::enumerate(functionType.getResults())) {
+    if (isRefType(type.value())) {
+      callArgs += ", &result_refs[" + std::to_string(refIndex++) + "]";
+    } else {
+      std::string resultName = "result" + std::to_string(type.index());
+      output << "  " << *getCType(type.value()) << " " << resultName
+             << " = 0;\n";
+      callArgs += ", &" + resultName;
     }
   }
 
-  output << "}\n";
+  output << "  iree_status_t status = "
+         << buildFunctionName(moduleInfo.moduleOp, funcOp, /*implSuffix=*/true)
+         << "(stack, state" << callArgs << ");\n";
+  if (argumentRefCount > 0) {
+    output << "  for (int i = 0; i < " << argumentRefCount << "; ++i) {\n"
+           << "    iree_vm_ref_release(&argument_refs[i]);\n"
+           << "  }\n";
+  }
 
+  offset = ABIOffset();
+  refIndex = 0;
+  if (!functionType.getResults().empty()) {
+    output << "  if (iree_status_is_ok(status)) {\n";
+    for (auto type : llvm::enumerate(functionType.getResults())) {
+      if (isRefType(type.value())) {
+        output << "    vm_abi_move_ref(call->results.data + " << offset.str()
+               << ", &result_refs[" << refIndex++ << "]);\n";
+      } else {
+        output << "    memcpy(call->results.data + " << offset.str()
+               << ", &result" << type.index() << ", sizeof(result"
+               << type.index() << "));\n";
+      }
+      offset.advance(type.value());
+    }
+    output << "  }\n";
+  }
+  if (resultRefCount > 0) {
+    output << "  for (int i = 0; i < " << resultRefCount << "; ++i) {\n"
+           << "    iree_vm_ref_release(&result_refs[i]);\n"
+           << "  }\n";
+  }
+  output << "  return status;\n"
+         << "}\n\n";
   return success();
 }
 
-static LogicalResult buildModuleDescriptors(IREE::VM::ModuleOp &moduleOp,
-                                            llvm::raw_ostream &output) {
-  std::string moduleName = moduleOp.getName().str();
+static LogicalResult buildModuleDescriptors(
+    ModuleInfo &moduleInfo, ArrayRef<IREE::VM::ImportOp> importOps,
+    ArrayRef<IREE::VM::RodataOp> rodataOps, llvm::raw_ostream &output) {
+  IREE::VM::ModuleOp moduleOp = moduleInfo.moduleOp;
+  const std::string &moduleName = moduleInfo.moduleName;
+  const std::string &stateType = moduleInfo.stateType;
+
+  // Exports must be sorted by name for lookup; the function table matches
+  // them 1:1.
+  SmallVector<IREE::VM::ExportOp, 8> exportOps(
+      moduleOp.getOps<IREE::VM::ExportOp>());
+  llvm::sort(exportOps, [](IREE::VM::ExportOp lhs, IREE::VM::ExportOp rhs) {
+    return lhs.export_name() < rhs.export_name();
+  });
+
+  for (auto exportOp : exportOps) {
+    auto funcOp = moduleInfo.symbolTable.lookup<IREE::VM::FuncOp>(
+        exportOp.function_ref());
+    if (failed(buildExportShim(moduleInfo, funcOp, output))) return failure();
+  }
 
   // exports
   std::string exportName = moduleName + "_exports_";
-  // TODO(marbre/simon-camp): Fix generating the calling_convention.
-  /*
   output << "static const iree_vm_native_export_descriptor_t " << exportName
          << "[] = {\n";
-  for (auto exportOp : moduleOp.getOps<IREE::VM::ExportOp>()) {
+  for (auto exportOp : exportOps) {
+    auto funcOp = moduleInfo.symbolTable.lookup<IREE::VM::FuncOp>(
+        exportOp.function_ref());
+    auto callingConvention = makeCallingConventionString(funcOp);
+    if (!callingConvention) {
+      return exportOp.emitError() << "unable to encode calling convention";
+    }
     // TODO(simon-camp) support function-level reflection attributes
-    output << "{iree_make_cstring_view(\"" << exportOp.export_name()
-           << "\"), 0, 0, 0, NULL},\n";
+    output << "    {" << makeStringView(exportOp.export_name()) << ", "
+           << makeStringView(*callingConvention) << ", 0, NULL},\n";
   }
-  output << "};\n";
-  output << "\n";
-  */
+  if (exportOps.empty()) output << "    {{NULL, 0}, {NULL, 0}, 0, NULL},\n";
+  output << "};\n\n";
 
   // imports
   std::string importName = moduleName + "_imports_";
   output << "static const iree_vm_native_import_descriptor_t " << importName
          << "[] = {\n";
-  for (auto importOp : moduleOp.getOps<IREE::VM::ImportOp>()) {
-    output << "{iree_make_cstring_view(\"" << importOp.getName() << "\")},\n";
+  for (auto importOp : importOps) {
+    output << "    {" << makeStringView(importOp.getName()) << "},\n";
   }
-  output << "};\n";
-  output << "\n";
+  if (importOps.empty()) output << "    {{NULL, 0}},\n";
+  output << "};\n\n";
 
   // functions
   std::string functionName = moduleName + "_funcs_";
+  output << "static const iree_vm_native_function_ptr_t " << functionName
+         << "[] = {\n";
+  for (auto exportOp : exportOps) {
+    auto funcOp = moduleInfo.symbolTable.lookup<IREE::VM::FuncOp>(
+        exportOp.function_ref());
+    // Shims call their implementation directly so no target is needed.
+    output << "    {(iree_vm_native_function_shim_t)"
+           << buildFunctionName(moduleOp, funcOp, /*implSuffix=*/false)
+           << "_shim, NULL},\n";
+  }
+  if (exportOps.empty()) output << "    {NULL, NULL},\n";
+  output << "};\n\n";
 
   // module descriptor
   // TODO(simon-camp): support module-level reflection attributes
-  // TODO(marbre/simon-camp): Renable after fix generating the export descriptor
-  /*
   std::string descriptorName = moduleName + "_descriptor_";
-  output << "static const iree_vm_native_module_descriptor_t " << descriptorName
-         << " = {\n"
-         << "iree_make_cstring_view(\"" << moduleName << "\"),\n"
-         << "IREE_ARRAYSIZE(" << importName << "),\n"
-         << importName << ",\n"
-         << "IREE_ARRAYSIZE(" << exportName << "),\n"
-         << exportName << ",\n"
-         << "IREE_ARRAYSIZE(" << functionName << "),\n"
-         << functionName << ",\n"
-         << "0,\n"
-         << "NULL,\n"
-         << "};\n";
-  */
-
-  // TODO(simon-camp) generate boilerplate code
-  //   * module struct
-  //   * module state struct
-  //   * function wrappers
-  //   * function table
-  //   * interface functions
-  //      * create
-  //      * destroy
-  //      * alloc_state
-  //      * free_state
-  //      * resolve_import
+  output << "static const iree_vm_native_module_descriptor_t "
+         << descriptorName << " = {\n"
+         << "    " << makeStringView(moduleOp.getName()) << ",\n"
+         << "    " << importOps.size() << ",\n"
+         << "    " << importName << ",\n"
+         << "    " << exportOps.size() << ",\n"
+         << "    " << exportName << ",\n"
+         << "    " << exportOps.size() << ",\n"
+         << "    " << functionName << ",\n"
+         << "    0,\n"
+         << "    NULL,\n"
+         << "};\n\n";
+
+  // alloc_state
+  output << "static iree_status_t " << moduleName
+         << "_alloc_state(\n    void* self, iree_allocator_t allocator,\n"
+         << "    iree_vm_module_state_t** out_module_state) {\n"
+         << "  " << stateType << "* state = NULL;\n"
+         << "  IREE_RETURN_IF_ERROR(\n"
+         << "      iree_allocator_malloc(allocator, sizeof(*state), "
+            "(void**)&state));\n"
+         << "  memset(state, 0, sizeof(*state));\n"
+         << "  state->allocator = allocator;\n";
+  for (auto rodataOp : rodataOps) {
+    int64_t ordinal = getSymbolOrdinal(rodataOp);
+    auto elementsType = rodataOp.value().getType().cast<ShapedType>();
+    int64_t byteLength = elementsType.getNumElements() *
+                         (elementsType.getElementTypeBitWidth() / 8);
+    output << "  iree_atomic_ref_count_init(&state->rodata_buffers["
+           << ordinal << "].ref_object.counter);\n"
+           << "  state->rodata_buffers[" << ordinal
+           << "].data = iree_make_const_byte_span(\n      " << moduleName
+           << "_rodata_" << ordinal << "_, " << byteLength << ");\n";
+  }
+  for (auto &typeName : moduleInfo.refTypeNames) {
+    output << "  iree_status_t status_" << typeName.second
+           << " = vm_lookup_ref_type(\n      iree_make_cstring_view(\""
+           << typeName.first << "\"), &state->types[" << typeName.second
+           << "]);\n"
+           << "  if (IREE_UNLIKELY(!iree_status_is_ok(status_"
+           << typeName.second << "))) {\n"
+           << "    iree_allocator_free(allocator, state);\n"
+           << "    return status_" << typeName.second << ";\n"
+           << "  }\n";
+  }
+  output << "  *out_module_state = (iree_vm_module_state_t*)state;\n"
+         << "  return iree_ok_status();\n"
+         << "}\n\n";
+
+  // free_state
+  output << "static void " << moduleName
+         << "_free_state(void* self,\n"
+            "    iree_vm_module_state_t* module_state) {\n"
+         << "  " << stateType << "* state = (" << stateType
+         << "*)module_state;\n"
+         << "  for (iree_host_size_t i = 0; i < "
+            "IREE_ARRAYSIZE(state->global_refs); ++i) {\n"
+         << "    iree_vm_ref_release(&state->global_refs[i]);\n"
+         << "  }\n"
+         << "  iree_allocator_free(state->allocator, state);\n"
+         << "}\n\n";
+
+  // resolve_import
+  output << "static iree_status_t " << moduleName
+         << "_resolve_import(\n"
+            "    void* self, iree_vm_module_state_t* module_state,\n"
+            "    iree_host_size_t ordinal, const iree_vm_function_t* "
+            "function,\n"
+            "    const iree_vm_function_signature_t* signature) {\n"
+         << "  " << stateType << "* state = (" << stateType
+         << "*)module_state;\n"
+         << "  if (IREE_UNLIKELY(ordinal >= " << importOps.size() << ")) {\n"
+         << "    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,\n"
+         << "                            \"import ordinal out of range\");\n"
+         << "  }\n"
+         << "  state->imports[ordinal] = *function;\n"
+         << "  return iree_ok_status();\n"
+         << "}\n\n";
+
+  // create
+  output << "static iree_status_t " << moduleName
+         << "_create(iree_allocator_t allocator,\n"
+            "    iree_vm_module_t** out_module) {\n"
+         << "  iree_vm_module_t interface;\n"
+         << "  IREE_RETURN_IF_ERROR(iree_vm_module_initialize(&interface, "
+            "NULL));\n"
+         << "  interface.alloc_state = " << moduleName << "_alloc_state;\n"
+         << "  interface.free_state = " << moduleName << "_free_state;\n"
+         << "  interface.resolve_import = " << moduleName
+         << "_resolve_import;\n"
+         << "  return iree_vm_native_module_create(&interface, &"
+         << descriptorName << ",\n"
+         << "                                      allocator, out_module);\n"
+         << "}\n";
 
-  output << "\n";
   return success();
 }
 
+}  // namespace
+
 // Adapted from BytecodeModuleTarget and extended by C specific passes
 static LogicalResult canonicalizeModule(IREE::VM::ModuleOp moduleOp) {
   bool optimize = true;
-  bool stripDebugOps = true;
+  // Debug ops are emitted the same way the bytecode interpreter runs them.
+  bool stripDebugOps = false;
 
   OwningRewritePatternList patterns;
   ConversionTarget target(*moduleOp.getContext());
@@ -286,6 +1367,44 @@ LogicalResult translateModuleToC(IREE::VM::ModuleOp moduleOp,
            << "failed to canonicalize vm.module to a serializable form";
   }
 
+  ModuleInfo moduleInfo(moduleOp);
+  SmallVector<IREE::VM::ImportOp, 8> importOps;
+  SmallVector<IREE::VM::RodataOp, 8> rodataOps;
+  for (auto &op : moduleOp.getBlock().getOperations()) {
+    if (auto importOp = dyn_cast<IREE::VM::ImportOp>(op)) {
+      importOps.push_back(importOp);
+    } else if (auto rodataOp = dyn_cast<IREE::VM::RodataOp>(op)) {
+      rodataOps.push_back(rodataOp);
+    } else if (isa<IREE::VM::GlobalRefOp>(op)) {
+      ++moduleInfo.globalRefs;
+    } else if (auto globalOp = dyn_cast<VMGlobalOp>(op)) {
+      moduleInfo.globalBytes =
+          std::max(moduleInfo.globalBytes,
+                   globalOp.getOrdinal() + globalOp.getStorageSize());
+    }
+  }
+  auto byOrdinal = [](Operation *lhs, Operation *rhs) {
+    return getSymbolOrdinal(lhs) < getSymbolOrdinal(rhs);
+  };
+  llvm::sort(importOps, [&](IREE::VM::ImportOp lhs, IREE::VM::ImportOp rhs) {
+    return byOrdinal(lhs, rhs);
+  });
+  llvm::sort(rodataOps, [&](IREE::VM::RodataOp lhs, IREE::VM::RodataOp rhs) {
+    return byOrdinal(lhs, rhs);
+  });
+
+  // Translate functions first as they populate the module type table.
+  std::string functions;
+  llvm::raw_string_ostream functionsOs(functions);
+  for (auto funcOp : moduleOp.getOps<IREE::VM::FuncOp>()) {
+    FunctionEmitter emitter(moduleInfo, funcOp);
+    if (failed(emitter.emit(functionsOs))) {
+      return failure();
+    }
+    functionsOs << "\n";
+  }
+  functionsOs.flush();
+
   auto printInclude = [&output](std::string include) {
     output << "#include \"" << include << "\"\n";
   };
@@ -302,24 +1421,38 @@ LogicalResult translateModuleToC(IREE::VM::ModuleOp moduleOp,
 
   printModuleComment(moduleOp, output);
 
-  mlir::emitc::CppEmitter emitter(output);
-  mlir::emitc::CppEmitter::Scope scope(emitter);
+  output << "typedef struct " << moduleInfo.moduleName << "_state_s "
+         << moduleInfo.stateType << ";\n\n";
+  if (failed(buildModuleState(moduleInfo, rodataOps, importOps.size(),
+                              output))) {
+    return failure();
+  }
 
-  // translate functions
+  // Forward declare all functions so they can call each other.
   for (auto funcOp : moduleOp.getOps<IREE::VM::FuncOp>()) {
-    if (failed(translateFunctionToC(emitter, moduleOp, funcOp, output))) {
-      return failure();
-    }
+    StringRef signature = functions;
+    std::string functionName =
+        buildFunctionName(moduleOp, funcOp, /*implSuffix=*/true);
+    size_t start = signature.find("static iree_status_t " + functionName + "(");
+    size_t end = signature.find(" {\n", start);
+    output << signature.substr(start, end - start) << ";\n";
+  }
+  output << "\n";
 
-    output << "\n";
+  if (!importOps.empty()) {
+    buildImportCallHelper(moduleInfo, output);
   }
 
+  // translate functions
+  output << functions;
+
   printSeparatingComment(output);
 
   printModuleComment(moduleOp, output);
 
   // generate module descriptors
-  if (failed(buildModuleDescriptors(moduleOp, output))) {
+  if (failed(buildModuleDescriptors(moduleInfo, importOps, rodataOps,
+                                    output))) {
     return failure();
   }
 
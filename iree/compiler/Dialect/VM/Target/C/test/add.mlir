@@ -1,16 +1,39 @@
 // RUN: iree-translate -iree-vm-ir-to-c-module %s | IreeFileCheck %s
 
 // CHECK: #include "iree/vm/c_funcs.h"
+// CHECK: typedef struct add_module_state_s add_module_state_t;
 vm.module @add_module {
-  // CHECK: iree_status_t add_module_add_1_impl(int32_t v1, int32_t v2, int32_t *out0, int32_t *out1) {
+  // CHECK: static iree_status_t add_module_add_1_impl(
+  // CHECK-NEXT: iree_vm_stack_t* stack, add_module_state_t* state, int32_t v0, int32_t v1, int32_t* out0, int32_t* out1) {
+  // CHECK-NEXT: int32_t v2 = 0;
+  // CHECK-NEXT: int32_t v3 = 0;
   vm.func @add_1(%arg0 : i32, %arg1 : i32) -> (i32, i32) {
-    // CHECK-NEXT: int32_t v3 = vm_add_i32(v1, v2);
+    // CHECK-NEXT: v2 = vm_add_i32(v0, v1);
     %0 = vm.add.i32 %arg0, %arg1 : i32
-    // CHECK-NEXT: int32_t v4 = vm_add_i32(v3, v3);
+    // CHECK-NEXT: v3 = vm_add_i32(v2, v2);
     %1 = vm.add.i32 %0, %0 : i32
-    // CHECK-NEXT: *out0 = v3;
-    // CHECK-NEXT: *out1 = v4;
+    // CHECK-NEXT: *out0 = v2;
+    // CHECK-NEXT: *out1 = v3;
     // CHECK-NEXT: return iree_ok_status();
     vm.return %0, %1 : i32, i32
   }
+  vm.export @add_1
+
+  // CHECK: static iree_status_t add_module_add_1_shim(
+  // CHECK: int32_t arg0;
+  // CHECK-NEXT: memcpy(&arg0, call->arguments.data + 0, sizeof(arg0));
+  // CHECK-NEXT: int32_t arg1;
+  // CHECK-NEXT: memcpy(&arg1, call->arguments.data + 4, sizeof(arg1));
+  // CHECK-NEXT: int32_t result0 = 0;
+  // CHECK-NEXT: int32_t result1 = 0;
+  // CHECK-NEXT: iree_status_t status = add_module_add_1_impl(stack, state, arg0, arg1, &result0, &result1);
+  // CHECK-NEXT: if (iree_status_is_ok(status)) {
+  // CHECK-NEXT: memcpy(call->results.data + 0, &result0, sizeof(result0));
+  // CHECK-NEXT: memcpy(call->results.data + 4, &result1, sizeof(result1));
+
+  // CHECK: static const iree_vm_native_export_descriptor_t add_module_exports_[] = {
+  // CHECK-NEXT: {{[{]}}{"add_1", 5}, {"0ii.ii", 6}, 0, NULL},
+  // CHECK: static const iree_vm_native_function_ptr_t add_module_funcs_[] = {
+  // CHECK-NEXT: {(iree_vm_native_function_shim_t)add_module_add_1_shim, NULL},
+  // CHECK: static iree_status_t add_module_create(iree_allocator_t allocator,
 }
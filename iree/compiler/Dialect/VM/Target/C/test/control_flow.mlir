@@ -0,0 +1,59 @@
+// RUN: iree-translate -iree-vm-ir-to-c-module %s | IreeFileCheck %s
+
+vm.module @control_flow_module {
+  // CHECK-LABEL: static iree_status_t control_flow_module_max_impl(
+  // CHECK-SAME: int32_t v0, int32_t v1, int32_t* out0) {
+  vm.func @max(%arg0 : i32, %arg1 : i32) -> i32 {
+    // CHECK: v2 = vm_cmp_lt_i32_s(v0, v1);
+    %0 = vm.cmp.lt.i32.s %arg0, %arg1 : i32
+    // CHECK-NEXT: if (v2) {
+    // CHECK-NEXT: goto block_1;
+    // CHECK-NEXT: }
+    // CHECK-NEXT: goto block_2;
+    vm.cond_br %0, ^bb1, ^bb2
+  // CHECK-NEXT: block_1:
+  ^bb1:
+    // CHECK-NEXT: *out0 = v1;
+    // CHECK-NEXT: return iree_ok_status();
+    vm.return %arg1 : i32
+  // CHECK-NEXT: block_2:
+  ^bb2:
+    // CHECK-NEXT: *out0 = v0;
+    // CHECK-NEXT: return iree_ok_status();
+    vm.return %arg0 : i32
+  }
+
+  // Block arguments are assigned as a parallel copy; swapping values needs
+  // temporaries.
+  // CHECK-LABEL: static iree_status_t control_flow_module_swap_impl(
+  vm.func @swap(%arg0 : i32, %arg1 : i32, %arg2 : i32) -> i32 {
+    %c1 = vm.const.i32 1 : i32
+    vm.br ^bb1(%arg0, %arg1, %arg2 : i32, i32, i32)
+  ^bb1(%0 : i32, %1 : i32, %2 : i32):
+    %3 = vm.sub.i32 %2, %c1 : i32
+    // CHECK: if ([[COND:v[0-9]+]]) {
+    // CHECK-NEXT: {
+    // CHECK-NEXT: int32_t t0 = [[Y:v[0-9]+]];
+    // CHECK-NEXT: int32_t t1 = [[X:v[0-9]+]];
+    // CHECK-NEXT: int32_t t2 = [[I:v[0-9]+]];
+    // CHECK-NEXT: [[X]] = t0;
+    // CHECK-NEXT: [[Y]] = t1;
+    // CHECK-NEXT: {{v[0-9]+}} = t2;
+    // CHECK-NEXT: }
+    // CHECK-NEXT: goto block_1;
+    // CHECK-NEXT: }
+    %4 = vm.cmp.nz.i32 %3 : i32
+    vm.cond_br %4, ^bb1(%1, %0, %3 : i32, i32, i32), ^bb2
+  ^bb2:
+    vm.return %0 : i32
+  }
+
+  // CHECK-LABEL: static iree_status_t control_flow_module_fail_impl(
+  vm.func @fail(%arg0 : i32) {
+    // CHECK: status = iree_status_allocate(
+    // CHECK-NEXT: (iree_status_code_t)v0, "<vm>", 0,
+    // CHECK-NEXT: iree_make_cstring_view("bad \"value\""));
+    // CHECK-NEXT: return status;
+    vm.fail %arg0, "bad \"value\""
+  }
+}
@@ -0,0 +1,28 @@
+// RUN: iree-translate -iree-vm-ir-to-c-module %s | IreeFileCheck %s
+
+vm.module @debug_ops_module {
+  // CHECK-LABEL: static iree_status_t debug_ops_module_trace_print_impl(
+  vm.func @trace_print(%arg0 : i32, %arg1 : !vm.ref<?>) {
+    // CHECK: // vm.trace "event"
+    vm.trace "event"(%arg0, %arg1) : i32, !vm.ref<?>
+    // CHECK-NEXT: // vm.print "\"message\""
+    vm.print "\"message\""(%arg0) : i32
+    vm.return
+  }
+
+  // Breaks continue at their destination as if no debugger were attached.
+  // CHECK-LABEL: static iree_status_t debug_ops_module_breaks_impl(
+  vm.func @breaks(%arg0 : i32, %arg1 : i32) -> i32 {
+    // CHECK: [[X:v[0-9]+]] = v1;
+    // CHECK-NEXT: goto block_1;
+    vm.break ^bb1(%arg1 : i32)
+  // CHECK-NEXT: block_1:
+  ^bb1(%0 : i32):
+    // CHECK-NEXT: goto block_2;
+    vm.cond_break %arg0, ^bb2
+  // CHECK-NEXT: block_2:
+  ^bb2:
+    // CHECK-NEXT: *out0 = [[X]];
+    vm.return %0 : i32
+  }
+}
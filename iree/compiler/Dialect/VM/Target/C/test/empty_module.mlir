@@ -1,5 +1,11 @@
 // RUN: iree-translate -iree-vm-ir-to-c-module %s | IreeFileCheck %s
 
 // CHECK: #include "iree/vm/c_funcs.h"
+// CHECK: struct empty_module_state_s {
+// CHECK-NEXT: iree_allocator_t allocator;
+// CHECK-NEXT: uint8_t rwdata[1];
 vm.module @empty_module {
 }
+// CHECK: static const iree_vm_native_module_descriptor_t empty_module_descriptor_ = {
+// CHECK-NEXT: {"empty_module", 12},
+// CHECK-NEXT: 0,
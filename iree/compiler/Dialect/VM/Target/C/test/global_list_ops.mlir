@@ -0,0 +1,48 @@
+// RUN: iree-translate -iree-vm-ir-to-c-module %s | IreeFileCheck %s
+
+vm.module @state_module {
+  // CHECK: struct state_module_state_s {
+  // CHECK-NEXT: iree_allocator_t allocator;
+  // CHECK-NEXT: uint8_t rwdata[4];
+  // CHECK-NEXT: iree_vm_ref_t global_refs[1];
+  vm.global.i32 @counter mutable : i32
+  vm.global.ref @cache mutable : !vm.list<i32>
+
+  // CHECK-LABEL: static iree_status_t state_module_increment_impl(
+  // CHECK-SAME: iree_vm_ref_t* arg0, int32_t* out0) {
+  vm.func @increment(%list : !vm.list<i32>) -> i32 {
+    // CHECK: iree_vm_ref_t refs[1];
+    // CHECK-NEXT: memset(refs, 0, sizeof(refs));
+    // CHECK: iree_vm_ref_retain(arg0, &refs[0]);
+    %c1 = vm.const.i32 1 : i32
+    // CHECK: [[COUNT:v[0-9]+]] = vm_global_load_i32(state->rwdata, 0);
+    %0 = vm.global.load.i32 @counter : i32
+    %1 = vm.add.i32 %0, %c1 : i32
+    // CHECK: vm_global_store_i32(state->rwdata, 0, [[NEXT:v[0-9]+]]);
+    vm.global.store.i32 %1, @counter : i32
+    // CHECK-NEXT: status = vm_list_resize(&refs[0], [[NEXT]]);
+    // CHECK-NEXT: if (IREE_UNLIKELY(!iree_status_is_ok(status))) goto cleanup;
+    vm.list.resize %list, %1 : (!vm.list<i32>, i32)
+    // CHECK-NEXT: status = vm_list_set_i32(&refs[0], [[COUNT]], [[NEXT]]);
+    vm.list.set.i32 %list, %0, %1 : (!vm.list<i32>, i32, i32)
+    // CHECK: iree_vm_ref_retain(&refs[0], &state->global_refs[0]);
+    vm.global.store.ref %list, @cache : !vm.list<i32>
+    // CHECK: *out0 = [[NEXT]];
+    // CHECK-NEXT: goto cleanup;
+    // CHECK-NEXT: cleanup:
+    // CHECK-NEXT: for (int i = 0; i < 1; ++i) {
+    // CHECK-NEXT: iree_vm_ref_release(&refs[i]);
+    // CHECK-NEXT: }
+    // CHECK-NEXT: return status;
+    vm.return %1 : i32
+  }
+
+  // CHECK-LABEL: static iree_status_t state_module_alloc_impl(
+  vm.func @alloc(%arg0 : i32) -> !vm.list<?> {
+    // CHECK: status = vm_list_alloc(iree_vm_type_def_make_variant_type(),
+    // CHECK-NEXT: v0, state->allocator, &refs[0]);
+    %list = vm.list.alloc %arg0 : (i32) -> !vm.list<?>
+    // CHECK: iree_vm_ref_retain(&refs[0], out0);
+    vm.return %list : !vm.list<?>
+  }
+}
@@ -0,0 +1,35 @@
+// RUN: iree-translate -iree-vm-ir-to-c-module %s | IreeFileCheck %s
+
+vm.module @import_module {
+  // CHECK: iree_vm_function_t imports[1];
+  vm.import @other.add(%arg0 : i32, %arg1 : !vm.ref<?>) -> i32
+
+  // CHECK: static iree_status_t import_module_call_import(
+
+  // CHECK-LABEL: static iree_status_t import_module_call_impl(
+  vm.func @call(%arg0 : i32, %arg1 : !vm.ref<?>) -> i32 {
+    // CHECK: uint64_t argument_storage[(4 + sizeof(iree_vm_ref_t) + 7) / 8];
+    // CHECK: uint64_t result_storage[(4 + 7) / 8];
+    // CHECK: memcpy(arguments + 0, &v0, sizeof(v0));
+    // CHECK-NEXT: vm_abi_retain_ref(arguments + 4, &refs[0]);
+    // CHECK-NEXT: status = import_module_call_import(stack, state, 0, iree_make_byte_span(arguments, 4 + sizeof(iree_vm_ref_t)),
+    // CHECK-NEXT: iree_make_byte_span(results, 4));
+    // CHECK-NEXT: if (iree_status_is_ok(status)) {
+    // CHECK-NEXT: memcpy(&v1, results + 0, sizeof(v1));
+    // CHECK-NEXT: }
+    // CHECK-NEXT: }
+    // CHECK-NEXT: if (IREE_UNLIKELY(!iree_status_is_ok(status))) goto cleanup;
+    %0 = vm.call @other.add(%arg0, %arg1) : (i32, !vm.ref<?>) -> i32
+    vm.return %0 : i32
+  }
+  vm.export @call
+
+  // CHECK: static iree_status_t import_module_call_shim(
+  // CHECK: vm_abi_take_ref(call->arguments.data + 4, &argument_refs[0]);
+
+  // CHECK: static const iree_vm_native_import_descriptor_t import_module_imports_[] = {
+  // CHECK-NEXT: {{[{]}}{"other.add", 9}},
+
+  // CHECK: static iree_status_t import_module_resolve_import(
+  // CHECK: state->imports[ordinal] = *function;
+}
@@ -73,5 +73,13 @@ StatusOr<ref_ptr<Buffer>> Allocator::WrapMutable(
          << "Allocator does not support wrapping host memory";
 }
 
+StatusOr<ref_ptr<Buffer>> Allocator::WrapMutableWithRelease(
+    MemoryTypeBitfield memory_type, MemoryAccessBitfield allowed_access,
+    BufferUsageBitfield buffer_usage, void* data, size_t data_length,
+    std::function<void()> release_fn) {
+  return UnimplementedErrorBuilder(IREE_LOC)
+         << "Allocator does not support taking ownership of host memory";
+}
+
 }  // namespace hal
 }  // namespace iree
@@ -16,6 +16,7 @@
 #define IREE_HAL_ALLOCATOR_H_
 
 #include <cstddef>
+#include <functional>
 #include <memory>
 
 #include "absl/types/span.h"
@@ -78,6 +79,12 @@ class Allocator : public RefObject<Allocator> {
                                              BufferUsageBitfield buffer_usage,
                                              size_t allocation_size) = 0;
 
+  // Releases any unused memory retained by the allocator for reuse (such as
+  // pooled blocks) back to the system. Buffers that are still live are not
+  // affected. May be called at any time, such as in response to a low memory
+  // notification from the platform.
+  virtual void Trim() {}
+
   // Allocates a buffer from the allocator for use as a constant value.
   // The provided |source_buffer| may be returned if the device can use it
   // directly and otherwise will be copied.
@@ -114,6 +121,15 @@ class Allocator : public RefObject<Allocator> {
                                         MemoryAccessBitfield allowed_access,
                                         BufferUsageBitfield buffer_usage,
                                         absl::Span<T> data);
+
+  // Wraps an existing host allocation and transfers its ownership to the
+  // buffer. |release_fn| is called once the buffer has been destroyed and must
+  // release |data|. If wrapping fails |release_fn| is not called and ownership
+  // remains with the caller.
+  virtual StatusOr<ref_ptr<Buffer>> WrapMutableWithRelease(
+      MemoryTypeBitfield memory_type, MemoryAccessBitfield allowed_access,
+      BufferUsageBitfield buffer_usage, void* data, size_t data_length,
+      std::function<void()> release_fn);
 };
 
 // Inline functions and template definitions follow:
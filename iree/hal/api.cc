@@ -783,24 +783,45 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_hal_allocator_wrap_buffer(
     iree_hal_allocator_t* allocator, iree_hal_memory_type_t memory_type,
     iree_hal_memory_access_t allowed_access,
     iree_hal_buffer_usage_t buffer_usage, iree_byte_span_t data,
-    iree_hal_buffer_t** out_buffer) {
+    iree_allocator_t data_allocator, iree_hal_buffer_t** out_buffer) {
   IREE_TRACE_SCOPE0("iree_hal_allocator_wrap_buffer");
   IREE_ASSERT_ARGUMENT(allocator);
   IREE_ASSERT_ARGUMENT(out_buffer);
   *out_buffer = nullptr;
 
   auto* handle = reinterpret_cast<Allocator*>(allocator);
-  IREE_ASSIGN_OR_RETURN(
-      auto buffer,
-      handle->WrapMutable(static_cast<MemoryTypeBitfield>(memory_type),
-                          static_cast<MemoryAccessBitfield>(allowed_access),
-                          static_cast<BufferUsageBitfield>(buffer_usage),
-                          data.data, data.data_length));
+  ref_ptr<Buffer> buffer;
+  if (data_allocator.free) {
+    IREE_ASSIGN_OR_RETURN(
+        buffer,
+        handle->WrapMutableWithRelease(
+            static_cast<MemoryTypeBitfield>(memory_type),
+            static_cast<MemoryAccessBitfield>(allowed_access),
+            static_cast<BufferUsageBitfield>(buffer_usage), data.data,
+            data.data_length, [data_allocator, data]() {
+              iree_allocator_free(data_allocator, data.data);
+            }));
+  } else {
+    IREE_ASSIGN_OR_RETURN(
+        buffer,
+        handle->WrapMutable(static_cast<MemoryTypeBitfield>(memory_type),
+                            static_cast<MemoryAccessBitfield>(allowed_access),
+                            static_cast<BufferUsageBitfield>(buffer_usage),
+                            data.data, data.data_length));
+  }
 
   *out_buffer = reinterpret_cast<iree_hal_buffer_t*>(buffer.release());
   return iree_ok_status();
 }
 
+IREE_API_EXPORT void IREE_API_CALL
+iree_hal_allocator_trim(iree_hal_allocator_t* allocator) {
+  IREE_TRACE_SCOPE0("iree_hal_allocator_trim");
+  IREE_ASSERT_ARGUMENT(allocator);
+  auto* handle = reinterpret_cast<Allocator*>(allocator);
+  handle->Trim();
+}
+
 //===----------------------------------------------------------------------===//
 // iree::hal::Buffer
 //===----------------------------------------------------------------------===//
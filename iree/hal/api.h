@@ -683,8 +683,11 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_hal_allocator_allocate_buffer(
     iree_hal_buffer_t** out_buffer);
 
 // Wraps an existing host allocation in a buffer.
-// Ownership of the allocation remains with the caller and the memory must
-// remain valid for so long as the buffer may be in use.
+// If |data_allocator| is provided ownership of the allocation is transferred
+// to the buffer and |data| will be freed with it once the buffer has been
+// destroyed. Otherwise (iree_allocator_null()) ownership remains with the
+// caller and the memory must remain valid for so long as the buffer may be in
+// use. On failure ownership always remains with the caller.
 //
 // Fails if the allocator cannot access host memory in this way.
 // |out_buffer| must be released by the caller.
@@ -692,7 +695,13 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_hal_allocator_wrap_buffer(
     iree_hal_allocator_t* allocator, iree_hal_memory_type_t memory_type,
     iree_hal_memory_access_t allowed_access,
     iree_hal_buffer_usage_t buffer_usage, iree_byte_span_t data,
-    iree_hal_buffer_t** out_buffer);
+    iree_allocator_t data_allocator, iree_hal_buffer_t** out_buffer);
+
+// Releases any unused memory retained by the allocator for reuse back to the
+// system. Buffers that are still live are not affected. Applications may call
+// this at any time, such as in response to low memory notifications.
+IREE_API_EXPORT void IREE_API_CALL
+iree_hal_allocator_trim(iree_hal_allocator_t* allocator);
 
 //===----------------------------------------------------------------------===//
 // iree::hal::Buffer
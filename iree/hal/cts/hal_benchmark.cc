@@ -0,0 +1,381 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Microbenchmarks for HAL implementations.
+// Each benchmark is registered once per available driver (named like
+// BM_SemaphoreSignalWake/vmla) so that drivers can be compared against each
+// other and overhead regressions in the HAL API layer show up across all of
+// them. As with the CTS, drivers that are unavailable on the current machine
+// are skipped and each driver and its default device are created only once.
+//
+// All work goes through the C API in iree/hal/api.h to include the cost of the
+// API shims in the measurements.
+//
+// Select a single driver with --benchmark_filter, for example:
+//   --benchmark_filter=/dylib/
+
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "iree/base/api.h"
+#include "iree/base/flags.h"
+#include "iree/base/logging.h"
+#include "iree/base/status.h"
+#include "iree/hal/api.h"
+#include "iree/hal/testing/driver_registry.h"
+
+namespace iree {
+namespace hal {
+namespace cts {
+namespace {
+
+//==============================================================================
+// Utilities
+//==============================================================================
+
+constexpr iree_hal_memory_type_t kDeviceMemoryType =
+    static_cast<iree_hal_memory_type_t>(IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL |
+                                        IREE_HAL_MEMORY_TYPE_HOST_VISIBLE);
+
+iree_hal_buffer_t* AllocateBuffer(iree_hal_device_t* device,
+                                  iree_host_size_t allocation_size) {
+  iree_hal_buffer_t* buffer = NULL;
+  IREE_CHECK_OK(iree_hal_allocator_allocate_buffer(
+      iree_hal_device_allocator(device), kDeviceMemoryType,
+      IREE_HAL_BUFFER_USAGE_ALL, allocation_size, &buffer));
+  return buffer;
+}
+
+iree_hal_command_buffer_t* CreateCommandBuffer(
+    iree_hal_device_t* device, iree_hal_command_category_t categories) {
+  iree_hal_command_buffer_t* command_buffer = NULL;
+  IREE_CHECK_OK(iree_hal_command_buffer_create(
+      device, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT, categories,
+      iree_allocator_system(), &command_buffer));
+  return command_buffer;
+}
+
+// Records a full execution barrier into |command_buffer|.
+void RecordBarrier(iree_hal_command_buffer_t* command_buffer) {
+  IREE_CHECK_OK(iree_hal_command_buffer_execution_barrier(
+      command_buffer, IREE_HAL_EXECUTION_STAGE_COMMAND_RETIRE,
+      IREE_HAL_EXECUTION_STAGE_COMMAND_ISSUE, 0, NULL, 0, NULL));
+}
+
+// Submits |command_buffer| to the device, signaling |semaphore| to |value| on
+// completion, and waits for the signal.
+void SubmitAndWait(iree_hal_device_t* device,
+                   iree_hal_command_category_t categories,
+                   iree_hal_command_buffer_t* command_buffer,
+                   iree_hal_semaphore_t* semaphore, uint64_t value) {
+  iree_hal_submission_batch_t batch;
+  memset(&batch, 0, sizeof(batch));
+  batch.command_buffer_count = 1;
+  batch.command_buffers = &command_buffer;
+  batch.signal_semaphores.count = 1;
+  batch.signal_semaphores.semaphores = &semaphore;
+  batch.signal_semaphores.payload_values = &value;
+  IREE_CHECK_OK(iree_hal_device_queue_submit(device, categories,
+                                             /*queue_affinity=*/0,
+                                             /*batch_count=*/1, &batch));
+  IREE_CHECK_OK(iree_hal_semaphore_wait_with_deadline(
+      semaphore, value, IREE_TIME_INFINITE_FUTURE));
+}
+
+iree_hal_semaphore_t* CreateSemaphore(iree_hal_device_t* device) {
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_CHECK_OK(iree_hal_semaphore_create(device, 0ull,
+                                          iree_allocator_system(), &semaphore));
+  return semaphore;
+}
+
+void TransferSizeArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgName("bytes");
+  for (int64_t size : {4 * 1024, 1024 * 1024, 16 * 1024 * 1024}) {
+    benchmark->Arg(size);
+  }
+}
+
+//==============================================================================
+// Buffers
+//==============================================================================
+
+// Measures allocating and immediately freeing a buffer of range(0) bytes.
+void BM_BufferAllocateFree(benchmark::State& state,
+                           iree_hal_device_t* device) {
+  for (auto _ : state) {
+    iree_hal_buffer_t* buffer = AllocateBuffer(device, state.range(0));
+    benchmark::DoNotOptimize(buffer);
+    iree_hal_buffer_release(buffer);
+  }
+}
+
+// Measures mapping and unmapping an entire buffer of range(0) bytes.
+void BM_BufferMapUnmap(benchmark::State& state, iree_hal_device_t* device) {
+  iree_hal_buffer_t* buffer = AllocateBuffer(device, state.range(0));
+  for (auto _ : state) {
+    iree_hal_mapped_memory_t mapped_memory;
+    IREE_CHECK_OK(iree_hal_buffer_map(buffer, IREE_HAL_MEMORY_ACCESS_READ, 0,
+                                      IREE_WHOLE_BUFFER, &mapped_memory));
+    benchmark::DoNotOptimize(mapped_memory.contents.data);
+    IREE_CHECK_OK(iree_hal_buffer_unmap(buffer, &mapped_memory));
+  }
+  iree_hal_buffer_release(buffer);
+}
+
+//==============================================================================
+// Transfer bandwidth
+//==============================================================================
+
+// Measures filling a buffer of range(0) bytes with a command buffer, including
+// recording and submission.
+void BM_CommandBufferFill(benchmark::State& state, iree_hal_device_t* device) {
+  iree_device_size_t length = state.range(0);
+  iree_hal_buffer_t* buffer = AllocateBuffer(device, length);
+  iree_hal_semaphore_t* semaphore = CreateSemaphore(device);
+  const uint32_t pattern = 0xCAFEF00Du;
+  uint64_t value = 0;
+  for (auto _ : state) {
+    iree_hal_command_buffer_t* command_buffer =
+        CreateCommandBuffer(device, IREE_HAL_COMMAND_CATEGORY_TRANSFER);
+    IREE_CHECK_OK(iree_hal_command_buffer_begin(command_buffer));
+    IREE_CHECK_OK(iree_hal_command_buffer_fill_buffer(
+        command_buffer, buffer, 0, length, &pattern, sizeof(pattern)));
+    IREE_CHECK_OK(iree_hal_command_buffer_end(command_buffer));
+    SubmitAndWait(device, IREE_HAL_COMMAND_CATEGORY_TRANSFER, command_buffer,
+                  semaphore, ++value);
+    iree_hal_command_buffer_release(command_buffer);
+  }
+  state.SetBytesProcessed(state.iterations() * length);
+  iree_hal_semaphore_release(semaphore);
+  iree_hal_buffer_release(buffer);
+}
+
+// Measures copying range(0) bytes between two buffers with a command buffer,
+// including recording and submission.
+void BM_CommandBufferCopy(benchmark::State& state, iree_hal_device_t* device) {
+  iree_device_size_t length = state.range(0);
+  iree_hal_buffer_t* source_buffer = AllocateBuffer(device, length);
+  iree_hal_buffer_t* target_buffer = AllocateBuffer(device, length);
+  IREE_CHECK_OK(iree_hal_buffer_zero(source_buffer, 0, IREE_WHOLE_BUFFER));
+  iree_hal_semaphore_t* semaphore = CreateSemaphore(device);
+  uint64_t value = 0;
+  for (auto _ : state) {
+    iree_hal_command_buffer_t* command_buffer =
+        CreateCommandBuffer(device, IREE_HAL_COMMAND_CATEGORY_TRANSFER);
+    IREE_CHECK_OK(iree_hal_command_buffer_begin(command_buffer));
+    IREE_CHECK_OK(iree_hal_command_buffer_copy_buffer(
+        command_buffer, source_buffer, 0, target_buffer, 0, length));
+    IREE_CHECK_OK(iree_hal_command_buffer_end(command_buffer));
+    SubmitAndWait(device, IREE_HAL_COMMAND_CATEGORY_TRANSFER, command_buffer,
+                  semaphore, ++value);
+    iree_hal_command_buffer_release(command_buffer);
+  }
+  state.SetBytesProcessed(state.iterations() * length);
+  iree_hal_semaphore_release(semaphore);
+  iree_hal_buffer_release(target_buffer);
+  iree_hal_buffer_release(source_buffer);
+}
+
+//==============================================================================
+// Command buffer overhead
+//==============================================================================
+
+// Measures creating and recording a command buffer with range(0) barriers
+// without submitting it. This isolates the per-command recording cost.
+void BM_CommandBufferRecord(benchmark::State& state,
+                            iree_hal_device_t* device) {
+  for (auto _ : state) {
+    iree_hal_command_buffer_t* command_buffer =
+        CreateCommandBuffer(device, IREE_HAL_COMMAND_CATEGORY_ANY);
+    IREE_CHECK_OK(iree_hal_command_buffer_begin(command_buffer));
+    for (int i = 0; i < state.range(0); ++i) {
+      RecordBarrier(command_buffer);
+    }
+    IREE_CHECK_OK(iree_hal_command_buffer_end(command_buffer));
+    iree_hal_command_buffer_release(command_buffer);
+  }
+}
+
+// Measures the round-trip of recording a command buffer with range(0) barriers,
+// submitting it, and waiting for completion. With no commands this is the
+// fixed cost paid by every submission and the floor for any dispatch.
+void BM_CommandBufferRecordSubmit(benchmark::State& state,
+                                  iree_hal_device_t* device) {
+  iree_hal_semaphore_t* semaphore = CreateSemaphore(device);
+  uint64_t value = 0;
+  for (auto _ : state) {
+    iree_hal_command_buffer_t* command_buffer =
+        CreateCommandBuffer(device, IREE_HAL_COMMAND_CATEGORY_ANY);
+    IREE_CHECK_OK(iree_hal_command_buffer_begin(command_buffer));
+    for (int i = 0; i < state.range(0); ++i) {
+      RecordBarrier(command_buffer);
+    }
+    IREE_CHECK_OK(iree_hal_command_buffer_end(command_buffer));
+    SubmitAndWait(device, IREE_HAL_COMMAND_CATEGORY_ANY, command_buffer,
+                  semaphore, ++value);
+    iree_hal_command_buffer_release(command_buffer);
+  }
+  iree_hal_semaphore_release(semaphore);
+}
+
+void CommandCountArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgName("commands");
+  for (int count : {0, 1, 16}) {
+    benchmark->Arg(count);
+  }
+}
+
+//==============================================================================
+// Semaphores
+//==============================================================================
+
+// Measures signaling a semaphore and waiting on the new (already reached)
+// value from the same thread. No thread ever blocks.
+void BM_SemaphoreSignalWait(benchmark::State& state,
+                            iree_hal_device_t* device) {
+  iree_hal_semaphore_t* semaphore = CreateSemaphore(device);
+  uint64_t value = 0;
+  for (auto _ : state) {
+    IREE_CHECK_OK(iree_hal_semaphore_signal(semaphore, ++value));
+    IREE_CHECK_OK(iree_hal_semaphore_wait_with_deadline(
+        semaphore, value, IREE_TIME_INFINITE_FUTURE));
+  }
+  iree_hal_semaphore_release(semaphore);
+}
+
+// Measures the latency of waking a thread blocked on a semaphore by ping-
+// ponging between the benchmark thread and a waiter thread. Each iteration
+// includes two signal->wake transitions.
+void BM_SemaphoreSignalWake(benchmark::State& state,
+                            iree_hal_device_t* device) {
+  iree_hal_semaphore_t* ping = CreateSemaphore(device);
+  iree_hal_semaphore_t* pong = CreateSemaphore(device);
+  std::atomic<bool> should_exit{false};
+  std::thread thread([&]() {
+    for (uint64_t value = 1;; ++value) {
+      IREE_CHECK_OK(iree_hal_semaphore_wait_with_deadline(
+          ping, value, IREE_TIME_INFINITE_FUTURE));
+      if (should_exit.load(std::memory_order_acquire)) break;
+      IREE_CHECK_OK(iree_hal_semaphore_signal(pong, value));
+    }
+  });
+
+  uint64_t value = 0;
+  for (auto _ : state) {
+    IREE_CHECK_OK(iree_hal_semaphore_signal(ping, ++value));
+    IREE_CHECK_OK(iree_hal_semaphore_wait_with_deadline(
+        pong, value, IREE_TIME_INFINITE_FUTURE));
+  }
+
+  should_exit.store(true, std::memory_order_release);
+  IREE_CHECK_OK(iree_hal_semaphore_signal(ping, ++value));
+  thread.join();
+  iree_hal_semaphore_release(pong);
+  iree_hal_semaphore_release(ping);
+}
+
+//==============================================================================
+// Registration
+//==============================================================================
+
+// A driver and its default device shared by all benchmarks for the process.
+struct DriverDevice {
+  iree_hal_driver_t* driver = NULL;
+  iree_hal_device_t* device = NULL;
+};
+
+// Creates the driver named |driver_name| and its default device.
+// Returns false if the driver is unavailable.
+bool CreateDriverDevice(const std::string& driver_name,
+                        DriverDevice* out_driver_device) {
+  iree_status_t status = iree_hal_driver_registry_try_create_by_name(
+      iree_hal_driver_registry_default(),
+      iree_make_string_view(driver_name.data(), driver_name.size()),
+      iree_allocator_system(), &out_driver_device->driver);
+  if (iree_status_is_unavailable(status)) {
+    IREE_LOG(WARNING) << "Skipping driver '" << driver_name
+                      << "' as it is unavailable: "
+                      << Status(std::move(status));
+    return false;
+  }
+  IREE_CHECK_OK(std::move(status));
+  IREE_CHECK_OK(iree_hal_driver_create_default_device(
+      out_driver_device->driver, iree_allocator_system(),
+      &out_driver_device->device));
+  return true;
+}
+
+void RegisterDriverBenchmarks(const std::string& driver_name,
+                              iree_hal_device_t* device) {
+  using BenchmarkFn = void (*)(benchmark::State&, iree_hal_device_t*);
+  auto register_benchmark = [&](const char* name, BenchmarkFn fn) {
+    return benchmark::RegisterBenchmark(
+        (std::string(name) + "/" + driver_name).c_str(),
+        [fn, device](benchmark::State& state) { fn(state, device); });
+  };
+
+  register_benchmark("BM_BufferAllocateFree", BM_BufferAllocateFree)
+      ->Apply(TransferSizeArgs);
+  register_benchmark("BM_BufferMapUnmap", BM_BufferMapUnmap)
+      ->Apply(TransferSizeArgs);
+  register_benchmark("BM_CommandBufferFill", BM_CommandBufferFill)
+      ->Apply(TransferSizeArgs)
+      ->UseRealTime();
+  register_benchmark("BM_CommandBufferCopy", BM_CommandBufferCopy)
+      ->Apply(TransferSizeArgs)
+      ->UseRealTime();
+  register_benchmark("BM_CommandBufferRecord", BM_CommandBufferRecord)
+      ->Apply(CommandCountArgs);
+  register_benchmark("BM_CommandBufferRecordSubmit",
+                     BM_CommandBufferRecordSubmit)
+      ->Apply(CommandCountArgs)
+      ->UseRealTime();
+  register_benchmark("BM_SemaphoreSignalWait", BM_SemaphoreSignalWait);
+  register_benchmark("BM_SemaphoreSignalWake", BM_SemaphoreSignalWake)
+      ->UseRealTime();
+}
+
+}  // namespace
+}  // namespace cts
+}  // namespace hal
+
+extern "C" int main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  iree_flags_parse_checked(&argc, &argv);
+
+  std::vector<hal::cts::DriverDevice> driver_devices;
+  for (const auto& driver_name : hal::testing::EnumerateAvailableDrivers()) {
+    hal::cts::DriverDevice driver_device;
+    if (!hal::cts::CreateDriverDevice(driver_name, &driver_device)) continue;
+    hal::cts::RegisterDriverBenchmarks(driver_name, driver_device.device);
+    driver_devices.push_back(driver_device);
+  }
+
+  ::benchmark::RunSpecifiedBenchmarks();
+
+  // Release devices before drivers and before static destruction so drivers
+  // can clean up while the process is still in a sane state.
+  for (auto& driver_device : driver_devices) {
+    iree_hal_device_release(driver_device.device);
+    iree_hal_driver_release(driver_device.driver);
+  }
+  return 0;
+}
+
+}  // namespace iree
@@ -25,14 +25,16 @@ namespace dylib {
 
 DyLibDevice::DyLibDevice(
     DeviceInfo device_info,
-    std::unique_ptr<host::SchedulingModel> scheduling_model)
-    : HostLocalDevice(std::move(device_info), std::move(scheduling_model)) {}
+    std::unique_ptr<host::SchedulingModel> scheduling_model,
+    ref_ptr<DyLibPersistentCache> persistent_cache)
+    : HostLocalDevice(std::move(device_info), std::move(scheduling_model)),
+      persistent_cache_(std::move(persistent_cache)) {}
 
 DyLibDevice::~DyLibDevice() = default;
 
 ref_ptr<ExecutableCache> DyLibDevice::CreateExecutableCache() {
   IREE_TRACE_SCOPE0("DyLibDevice::CreateExecutableCache");
-  return make_ref<DyLibExecutableCache>();
+  return make_ref<DyLibExecutableCache>(add_ref(persistent_cache_));
 }
 
 }  // namespace dylib
@@ -15,6 +15,8 @@
 #ifndef IREE_HAL_DYLIB_DYLIB_DEVICE_H_
 #define IREE_HAL_DYLIB_DYLIB_DEVICE_H_
 
+#include "iree/base/ref_ptr.h"
+#include "iree/hal/dylib/dylib_persistent_cache.h"
 #include "iree/hal/host/host_local_device.h"
 
 namespace iree {
@@ -23,11 +25,17 @@ namespace dylib {
 
 class DyLibDevice final : public host::HostLocalDevice {
  public:
+  // Executable caches created by the device use |persistent_cache|, if
+  // provided, to persist prepared executables across runs.
   DyLibDevice(DeviceInfo device_info,
-              std::unique_ptr<host::SchedulingModel> scheduling_model);
+              std::unique_ptr<host::SchedulingModel> scheduling_model,
+              ref_ptr<DyLibPersistentCache> persistent_cache = {});
   ~DyLibDevice() override;
 
   ref_ptr<ExecutableCache> CreateExecutableCache() override;
+
+ private:
+  ref_ptr<DyLibPersistentCache> persistent_cache_;
 };
 
 }  // namespace dylib
@@ -19,6 +19,7 @@
 #include "iree/hal/device_info.h"
 #include "iree/hal/dylib/dylib_device.h"
 #include "iree/hal/host/serial/serial_scheduling_model.h"
+#include "iree/hal/host/task/task_scheduling_model.h"
 
 namespace iree {
 namespace hal {
@@ -39,9 +40,19 @@ DeviceInfo GetDefaultDeviceInfo() {
 
 }  // namespace
 
-DyLibDriver::DyLibDriver() : Driver("dylib") {}
+DyLibDriver::DyLibDriver(iree_task_executor_t* executor,
+                         ref_ptr<DyLibPersistentCache> persistent_cache,
+                         int queue_worker_count)
+    : Driver("dylib"),
+      executor_(executor),
+      persistent_cache_(std::move(persistent_cache)),
+      queue_worker_count_(queue_worker_count) {
+  if (executor_) iree_task_executor_retain(executor_);
+}
 
-DyLibDriver::~DyLibDriver() = default;
+DyLibDriver::~DyLibDriver() {
+  if (executor_) iree_task_executor_release(executor_);
+}
 
 StatusOr<std::vector<DeviceInfo>> DyLibDriver::EnumerateAvailableDevices() {
   std::vector<DeviceInfo> device_infos;
@@ -56,9 +67,17 @@ StatusOr<ref_ptr<Device>> DyLibDriver::CreateDefaultDevice() {
 
 StatusOr<ref_ptr<Device>> DyLibDriver::CreateDevice(DriverDeviceID device_id) {
   // Only one device, ignore device_id.
-  auto scheduling_model = std::make_unique<host::SerialSchedulingModel>();
+  std::unique_ptr<host::SchedulingModel> scheduling_model;
+  if (executor_) {
+    scheduling_model = std::make_unique<host::TaskSchedulingModel>(
+        executor_, queue_worker_count_);
+  } else {
+    scheduling_model =
+        std::make_unique<host::SerialSchedulingModel>(queue_worker_count_);
+  }
   return make_ref<DyLibDevice>(GetDefaultDeviceInfo(),
-                               std::move(scheduling_model));
+                               std::move(scheduling_model),
+                               add_ref(persistent_cache_));
 }
 
 }  // namespace dylib
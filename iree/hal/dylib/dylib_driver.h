@@ -15,7 +15,10 @@
 #ifndef IREE_HAL_DYLIB_DYLIB_DRIVER_H_
 #define IREE_HAL_DYLIB_DYLIB_DRIVER_H_
 
+#include "iree/base/ref_ptr.h"
 #include "iree/hal/driver.h"
+#include "iree/hal/dylib/dylib_persistent_cache.h"
+#include "iree/task/executor.h"
 
 namespace iree {
 namespace hal {
@@ -23,7 +26,14 @@ namespace dylib {
 
 class DyLibDriver final : public Driver {
  public:
-  DyLibDriver();
+  // Creates a driver whose devices schedule work on |executor|, if provided.
+  // When |executor| is nullptr devices process all work serially.
+  // All devices share |persistent_cache|, if provided.
+  // Device queues process independent submissions on |queue_worker_count|
+  // threads.
+  explicit DyLibDriver(iree_task_executor_t* executor,
+                       ref_ptr<DyLibPersistentCache> persistent_cache = {},
+                       int queue_worker_count = 1);
   ~DyLibDriver() override;
 
   StatusOr<std::vector<DeviceInfo>> EnumerateAvailableDevices() override;
@@ -31,6 +41,11 @@ class DyLibDriver final : public Driver {
   StatusOr<ref_ptr<Device>> CreateDefaultDevice() override;
 
   StatusOr<ref_ptr<Device>> CreateDevice(DriverDeviceID device_id) override;
+
+ private:
+  iree_task_executor_t* executor_ = nullptr;
+  ref_ptr<DyLibPersistentCache> persistent_cache_;
+  int queue_worker_count_ = 1;
 };
 
 }  // namespace dylib
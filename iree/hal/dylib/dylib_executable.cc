@@ -76,9 +76,26 @@ namespace hal {
 namespace dylib {
 
 // static
-StatusOr<ref_ptr<DyLibExecutable>> DyLibExecutable::Load(ExecutableSpec spec) {
+StatusOr<ref_ptr<DyLibExecutable>> DyLibExecutable::Load(
+    ExecutableSpec spec, DyLibPersistentCache* persistent_cache) {
+  std::string cache_key;
+  if (persistent_cache) {
+    cache_key = DyLibPersistentCache::ComputeKey(spec.executable_data);
+    auto entry_or = persistent_cache->Lookup(cache_key);
+    if (entry_or.ok()) {
+      // The flatbuffer was verified when the entry was stored so we can skip
+      // straight to loading the library.
+      auto executable = make_ref<DyLibExecutable>();
+      if (executable->InitializeFromCache(entry_or.value()).ok()) {
+        return executable;
+      }
+      // Evicted or otherwise unusable; fall back to extracting it again.
+    }
+  }
+
   auto executable = make_ref<DyLibExecutable>();
-  IREE_RETURN_IF_ERROR(executable->Initialize(spec));
+  IREE_RETURN_IF_ERROR(
+      executable->Initialize(spec, persistent_cache, cache_key));
   return executable;
 }
 
@@ -101,7 +118,9 @@ DyLibExecutable::~DyLibExecutable() {
   }
 }
 
-Status DyLibExecutable::Initialize(ExecutableSpec spec) {
+Status DyLibExecutable::Initialize(ExecutableSpec spec,
+                                   DyLibPersistentCache* persistent_cache,
+                                   absl::string_view cache_key) {
   IREE_TRACE_SCOPE0("DyLibExecutable::Initialize");
 
   // Verify and fetch the executable flatbuffer wrapper.
@@ -112,14 +131,104 @@ Status DyLibExecutable::Initialize(ExecutableSpec spec) {
   iree_DyLibExecutableDef_table_t executable_def =
       iree_DyLibExecutableDef_as_root(executable_data.data);
 
-  // Write the embedded library out to a temp file, since all of the dynamic
-  // library APIs work with files. We could instead use in-memory files on
-  // platforms where that is convenient.
+  flatbuffers_uint8_vec_t embedded_library_vec =
+      iree_DyLibExecutableDef_library_embedded_get(executable_def);
+  absl::Span<const uint8_t> embedded_library = absl::MakeConstSpan(
+      embedded_library_vec, flatbuffers_uint8_vec_len(embedded_library_vec));
+  flatbuffers_string_t debug_database_filename =
+      iree_DyLibExecutableDef_debug_database_filename_get(executable_def);
+  flatbuffers_uint8_vec_t debug_database_embedded_vec =
+      iree_DyLibExecutableDef_debug_database_embedded_get(executable_def);
+
+  flatbuffers_string_vec_t entry_points_vec =
+      iree_DyLibExecutableDef_entry_points_get(executable_def);
+  std::vector<std::string> entry_point_names(
+      flatbuffers_string_vec_len(entry_points_vec));
+  for (size_t i = 0; i < entry_point_names.size(); ++i) {
+    flatbuffers_string_t entry_point =
+        flatbuffers_string_vec_at(entry_points_vec, i);
+    entry_point_names[i].assign(entry_point,
+                                flatbuffers_string_len(entry_point));
+  }
+
+  // Store the library in the persistent cache and load it from there so that
+  // future runs can skip all of this. Debug databases are attached by path
+  // and not cached, so executables carrying them always take the slow path.
+  if (persistent_cache &&
+      !flatbuffers_uint8_vec_len(debug_database_embedded_vec)) {
+    auto entry_or = persistent_cache->Insert(cache_key, embedded_library,
+                                             entry_point_names);
+    if (entry_or.ok()) {
+      auto library_or =
+          DynamicLibrary::Load(entry_or.value().library_path.c_str());
+      if (library_or.ok()) {
+        executable_library_ = std::move(library_or).value();
+        return ResolveEntryPoints(entry_point_names);
+      }
+    }
+    // Cache directory unavailable (read-only, full, etc); load directly.
+  }
+
+  // Try loading the library directly from memory first (memfd_create +
+  // dlopen(/proc/self/fd/NN) on Linux/Android). This avoids disk I/O on the
+  // load path and works in read-only containers. Platforms without support
+  // return UNAVAILABLE and we fall back to writing a temp file.
   //
-  // TODO(#3845): use dlopen on an fd with either dlopen(/proc/self/fd/NN),
-  // fdlopen, or android_dlopen_ext to avoid needing to write the file to disk.
-  // Can fallback to memfd_create + dlopen where available, and fallback from
-  // that to disk (maybe just windows/mac).
+  // TODO(#3845): fdlopen/android_dlopen_ext would avoid the /proc dependency.
+  auto library_or =
+      DynamicLibrary::LoadFromMemory("dylib_executable", embedded_library);
+  if (library_or.ok()) {
+    // Debug databases are attached by path and the only platform that uses
+    // them (Windows) never takes this path, so there is nothing to write.
+    executable_library_ = std::move(library_or).value();
+  } else {
+    IREE_RETURN_IF_ERROR(LoadFromTempFile(
+        embedded_library,
+        absl::string_view(debug_database_filename,
+                          flatbuffers_string_len(debug_database_filename)),
+        absl::MakeConstSpan(
+            debug_database_embedded_vec,
+            flatbuffers_uint8_vec_len(debug_database_embedded_vec))));
+  }
+
+  return ResolveEntryPoints(entry_point_names);
+}
+
+Status DyLibExecutable::InitializeFromCache(
+    const DyLibPersistentCache::Entry& entry) {
+  IREE_TRACE_SCOPE0("DyLibExecutable::InitializeFromCache");
+  IREE_ASSIGN_OR_RETURN(executable_library_,
+                        DynamicLibrary::Load(entry.library_path.c_str()));
+  return ResolveEntryPoints(entry.entry_points);
+}
+
+Status DyLibExecutable::ResolveEntryPoints(
+    absl::Span<const std::string> entry_point_names) {
+  entry_functions_.resize(entry_point_names.size());
+  IREE_TRACE(entry_names_.resize(entry_point_names.size()));
+  for (size_t i = 0; i < entry_functions_.size(); ++i) {
+    const std::string& entry_point = entry_point_names[i];
+    void* symbol = executable_library_->GetSymbol(entry_point.c_str());
+    if (!symbol) {
+      return NotFoundErrorBuilder(IREE_LOC)
+             << "Could not find symbol: " << entry_point;
+    }
+    entry_functions_[i] = symbol;
+
+    IREE_TRACE(entry_names_[i] = entry_point);
+  }
+
+  return OkStatus();
+}
+
+Status DyLibExecutable::LoadFromTempFile(
+    absl::Span<const uint8_t> library_data,
+    absl::string_view debug_database_filename,
+    absl::Span<const uint8_t> debug_database_data) {
+  IREE_TRACE_SCOPE0("DyLibExecutable::LoadFromTempFile");
+
+  // Write the embedded library out to a temp file, since all of the dynamic
+  // library APIs work with files.
   std::string base_name = "dylib_executable";
   IREE_ASSIGN_OR_RETURN(auto library_temp_path,
                         file_io::GetTempFile(base_name));
@@ -133,53 +242,28 @@ Status DyLibExecutable::Initialize(ExecutableSpec spec) {
   library_temp_path += ".so";
 #endif
 
-  flatbuffers_uint8_vec_t embedded_library_vec =
-      iree_DyLibExecutableDef_library_embedded_get(executable_def);
   IREE_RETURN_IF_ERROR(file_io::SetFileContents(
       library_temp_path,
-      absl::string_view(reinterpret_cast<const char*>(embedded_library_vec),
-                        flatbuffers_uint8_vec_len(embedded_library_vec))));
+      absl::string_view(reinterpret_cast<const char*>(library_data.data()),
+                        library_data.size())));
 
   IREE_ASSIGN_OR_RETURN(executable_library_,
                         DynamicLibrary::Load(library_temp_path.c_str()));
 
-  flatbuffers_string_t debug_database_filename =
-      iree_DyLibExecutableDef_debug_database_filename_get(executable_def);
-  flatbuffers_uint8_vec_t debug_database_embedded_vec =
-      iree_DyLibExecutableDef_debug_database_embedded_get(executable_def);
-  if (flatbuffers_string_len(debug_database_filename) &&
-      flatbuffers_uint8_vec_len(debug_database_embedded_vec)) {
+  if (!debug_database_filename.empty() && !debug_database_data.empty()) {
     IREE_TRACE_SCOPE0("DyLibExecutable::AttachDebugDatabase");
-    auto debug_database_path = file_path::JoinPaths(
-        file_path::DirectoryName(library_temp_path),
-        absl::string_view(debug_database_filename,
-                          flatbuffers_string_len(debug_database_filename)));
+    auto debug_database_path =
+        file_path::JoinPaths(file_path::DirectoryName(library_temp_path),
+                             debug_database_filename);
     temp_file_paths_.push_back(debug_database_path);
     IREE_IGNORE_ERROR(file_io::SetFileContents(
         debug_database_path,
         absl::string_view(
-            reinterpret_cast<const char*>(debug_database_embedded_vec),
-            flatbuffers_uint8_vec_len(debug_database_embedded_vec))));
+            reinterpret_cast<const char*>(debug_database_data.data()),
+            debug_database_data.size())));
     executable_library_->AttachDebugDatabase(debug_database_path.c_str());
   }
 
-  flatbuffers_string_vec_t entry_points =
-      iree_DyLibExecutableDef_entry_points_get(executable_def);
-  entry_functions_.resize(flatbuffers_string_vec_len(entry_points));
-  IREE_TRACE(entry_names_.resize(flatbuffers_string_vec_len(entry_points)));
-  for (size_t i = 0; i < entry_functions_.size(); ++i) {
-    flatbuffers_string_t entry_point =
-        flatbuffers_string_vec_at(entry_points, i);
-    void* symbol = executable_library_->GetSymbol(entry_point);
-    if (!symbol) {
-      return NotFoundErrorBuilder(IREE_LOC)
-             << "Could not find symbol: " << entry_point;
-    }
-    entry_functions_[i] = symbol;
-
-    IREE_TRACE(entry_names_[i] = entry_point);
-  }
-
   return OkStatus();
 }
 
@@ -207,7 +291,8 @@ DyLibExecutable::PrepareDispatch(const DispatchParams& params) {
   auto dispatch_state = make_ref<DyLibDispatchState>();
   dispatch_state->workgroup_count = params.workgroup_count;
   dispatch_state->workgroup_size = params.workgroup_size;
-  IREE_TRACE(dispatch_state->entry_name = entry_names_[params.entry_point]);
+  IREE_TRACE(dispatch_state->entry_name =
+                 entry_names_[params.entry_point].c_str());
   dispatch_state->entry_function = entry_functions_[params.entry_point];
 
   int binding_count = 0;
@@ -19,9 +19,12 @@
 #include <string>
 
 #include "absl/container/inlined_vector.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "iree/base/dynamic_library.h"
 #include "iree/base/status.h"
 #include "iree/base/tracing.h"
+#include "iree/hal/dylib/dylib_persistent_cache.h"
 #include "iree/hal/executable_spec.h"
 #include "iree/hal/host/host_executable.h"
 
@@ -33,7 +36,12 @@ struct MemrefType;
 
 class DyLibExecutable final : public HostExecutable {
  public:
-  static StatusOr<ref_ptr<DyLibExecutable>> Load(ExecutableSpec spec);
+  // Loads the executable described by |spec|.
+  // If |persistent_cache| is provided the library is loaded from the cache
+  // when present (skipping verification and extraction) and otherwise stored
+  // into it for future runs.
+  static StatusOr<ref_ptr<DyLibExecutable>> Load(
+      ExecutableSpec spec, DyLibPersistentCache* persistent_cache = nullptr);
 
   DyLibExecutable();
   ~DyLibExecutable() override;
@@ -46,13 +54,26 @@ class DyLibExecutable final : public HostExecutable {
                       std::array<uint32_t, 3> workgroup_xyz) override;
 
  private:
-  Status Initialize(ExecutableSpec spec);
+  Status Initialize(ExecutableSpec spec, DyLibPersistentCache* persistent_cache,
+                    absl::string_view cache_key);
+
+  // Loads a library previously stored in the persistent cache.
+  Status InitializeFromCache(const DyLibPersistentCache::Entry& entry);
+
+  // Resolves the exported functions for each entry point.
+  Status ResolveEntryPoints(absl::Span<const std::string> entry_point_names);
+
+  // Writes |library_data| (and its optional debug database) to temp files and
+  // loads the library from disk. Used when in-memory loading is unavailable.
+  Status LoadFromTempFile(absl::Span<const uint8_t> library_data,
+                          absl::string_view debug_database_filename,
+                          absl::Span<const uint8_t> debug_database_data);
 
   absl::InlinedVector<std::string, 4> temp_file_paths_;
   std::unique_ptr<DynamicLibrary> executable_library_;
   std::vector<void*> entry_functions_;
 
-  IREE_TRACE(std::vector<const char*> entry_names_);
+  IREE_TRACE(std::vector<std::string> entry_names_);
 };
 
 }  // namespace dylib
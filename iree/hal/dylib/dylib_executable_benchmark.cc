@@ -0,0 +1,168 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "benchmark/benchmark.h"
+#include "iree/base/dynamic_library.h"
+#include "iree/base/file_io.h"
+#include "iree/base/file_path.h"
+#include "iree/base/logging.h"
+#include "iree/base/testing/dynamic_library_test_library_embed.h"
+#include "iree/hal/dylib/dylib_executable.h"
+#include "iree/hal/dylib/dylib_persistent_cache.h"
+
+// flatcc schemas:
+#include "iree/base/flatcc.h"
+#include "iree/schemas/dylib_executable_def_builder.h"
+
+namespace iree {
+namespace hal {
+namespace dylib {
+namespace {
+
+absl::Span<const uint8_t> GetTestLibraryData() {
+  const auto* file_toc = dynamic_library_test_library_create();
+  return absl::MakeConstSpan(reinterpret_cast<const uint8_t*>(file_toc->data),
+                             file_toc->size);
+}
+
+// Builds a DyLibExecutableDef wrapping the embedded test library as if it had
+// been produced by the compiler.
+std::vector<uint8_t> BuildExecutableDef() {
+  absl::Span<const uint8_t> library_data = GetTestLibraryData();
+
+  flatcc_builder_t builder;
+  flatcc_builder_init(&builder);
+
+  flatbuffers_string_ref_t entry_point_ref =
+      flatbuffers_string_create_str(&builder, "times_two");
+  flatbuffers_string_vec_ref_t entry_points_ref =
+      flatbuffers_string_vec_create(&builder, &entry_point_ref, 1);
+  flatbuffers_uint8_vec_ref_t library_embedded_ref =
+      flatbuffers_uint8_vec_create(&builder, library_data.data(),
+                                   library_data.size());
+
+  iree_DyLibExecutableDef_start_as_root(&builder);
+  iree_DyLibExecutableDef_entry_points_add(&builder, entry_points_ref);
+  iree_DyLibExecutableDef_library_embedded_add(&builder, library_embedded_ref);
+  iree_DyLibExecutableDef_end_as_root(&builder);
+
+  size_t buffer_size = 0;
+  void* buffer = flatcc_builder_finalize_aligned_buffer(&builder, &buffer_size);
+  IREE_CHECK(buffer) << "failed to finalize executable flatbuffer";
+  std::vector<uint8_t> result(static_cast<uint8_t*>(buffer),
+                              static_cast<uint8_t*>(buffer) + buffer_size);
+  flatcc_builder_aligned_free(buffer);
+  flatcc_builder_clear(&builder);
+  return result;
+}
+
+// Loads |state.range(0)| executables per iteration, approximating the cost of
+// preparing all executables in a large module.
+void BM_DyLibExecutableLoad(benchmark::State& state) {
+  std::vector<uint8_t> executable_data = BuildExecutableDef();
+  ExecutableSpec spec;
+  spec.executable_data = absl::MakeConstSpan(executable_data);
+  std::vector<ref_ptr<DyLibExecutable>> executables;
+  executables.reserve(state.range(0));
+  for (auto _ : state) {
+    for (int i = 0; i < state.range(0); ++i) {
+      auto executable_or = DyLibExecutable::Load(spec);
+      IREE_CHECK_OK(executable_or.status());
+      executables.push_back(std::move(executable_or).value());
+    }
+    state.PauseTiming();
+    executables.clear();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DyLibExecutableLoad)->Arg(1)->Arg(100)->Arg(500);
+
+// As BM_DyLibExecutableLoad but with a warm persistent cache, approximating
+// the preparation cost on all but the first run of a process.
+void BM_DyLibExecutableLoadPersistentCache(benchmark::State& state) {
+  std::vector<uint8_t> executable_data = BuildExecutableDef();
+  ExecutableSpec spec;
+  spec.executable_data = absl::MakeConstSpan(executable_data);
+  DyLibPersistentCache::Options cache_options;
+  cache_options.path = file_path::JoinPaths(file_io::GetTempPath(),
+                                            "dylib_executable_benchmark_cache");
+  auto cache_or = DyLibPersistentCache::Open(std::move(cache_options));
+  IREE_CHECK_OK(cache_or.status());
+  auto persistent_cache = std::move(cache_or).value();
+  // Populate the cache as a prior run would have.
+  IREE_CHECK_OK(DyLibExecutable::Load(spec, persistent_cache.get()).status());
+
+  std::vector<ref_ptr<DyLibExecutable>> executables;
+  executables.reserve(state.range(0));
+  for (auto _ : state) {
+    for (int i = 0; i < state.range(0); ++i) {
+      auto executable_or = DyLibExecutable::Load(spec, persistent_cache.get());
+      IREE_CHECK_OK(executable_or.status());
+      executables.push_back(std::move(executable_or).value());
+    }
+    state.PauseTiming();
+    executables.clear();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DyLibExecutableLoadPersistentCache)->Arg(1)->Arg(100)->Arg(500);
+
+// Raw in-memory load cost without any executable parsing.
+void BM_DynamicLibraryLoadFromMemory(benchmark::State& state) {
+  absl::Span<const uint8_t> library_data = GetTestLibraryData();
+  if (!DynamicLibrary::LoadFromMemory("benchmark", library_data).ok()) {
+    state.SkipWithError("in-memory loading not supported on this platform");
+    return;
+  }
+  for (auto _ : state) {
+    auto library_or = DynamicLibrary::LoadFromMemory("benchmark", library_data);
+    IREE_CHECK_OK(library_or.status());
+    state.PauseTiming();
+    library_or.value().reset();
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(BM_DynamicLibraryLoadFromMemory);
+
+// Temp file write + load cost; the fallback path used when in-memory loading
+// is unavailable.
+void BM_DynamicLibraryLoadFromTempFile(benchmark::State& state) {
+  absl::Span<const uint8_t> library_data = GetTestLibraryData();
+  absl::string_view library_contents(
+      reinterpret_cast<const char*>(library_data.data()), library_data.size());
+  for (auto _ : state) {
+    auto temp_path_or = file_io::GetTempFile("dylib_executable_benchmark");
+    IREE_CHECK_OK(temp_path_or.status());
+    std::string temp_path = std::move(temp_path_or).value() + ".so";
+    IREE_CHECK_OK(file_io::SetFileContents(temp_path, library_contents));
+    auto library_or = DynamicLibrary::Load(temp_path.c_str());
+    IREE_CHECK_OK(library_or.status());
+    state.PauseTiming();
+    library_or.value().reset();
+    file_io::DeleteFile(temp_path).IgnoreError();
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(BM_DynamicLibraryLoadFromTempFile);
+
+}  // namespace
+}  // namespace dylib
+}  // namespace hal
+}  // namespace iree
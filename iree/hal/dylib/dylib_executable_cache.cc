@@ -23,7 +23,9 @@ namespace iree {
 namespace hal {
 namespace dylib {
 
-DyLibExecutableCache::DyLibExecutableCache() = default;
+DyLibExecutableCache::DyLibExecutableCache(
+    ref_ptr<DyLibPersistentCache> persistent_cache)
+    : persistent_cache_(std::move(persistent_cache)) {}
 
 DyLibExecutableCache::~DyLibExecutableCache() = default;
 
@@ -36,14 +38,11 @@ StatusOr<ref_ptr<Executable>> DyLibExecutableCache::PrepareExecutable(
     const ExecutableSpec& spec) {
   IREE_TRACE_SCOPE0("DyLibExecutableCache::PrepareExecutable");
 
-  // TODO(scotttodd): Options for using in-memory files where supported, or not
-  //    writing to temp files on disk (and failing if necessary) if not allowed.
-  // TODO(scotttodd): Use stable (possibly temp, but reusable) files when
-  //    ExecutableCachingMode::AllowPersistentCaching is set. For example,
-  //    hash data into a filename and read from / write to GetTempPath() or
-  //    GetCachePath() rather than use GetTempFile().
-
-  return DyLibExecutable::Load(spec);
+  DyLibPersistentCache* persistent_cache =
+      AllBitsSet(mode, ExecutableCachingMode::kAllowPersistentCaching)
+          ? persistent_cache_.get()
+          : nullptr;
+  return DyLibExecutable::Load(spec, persistent_cache);
 }
 
 }  // namespace dylib
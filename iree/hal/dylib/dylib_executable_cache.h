@@ -15,6 +15,8 @@
 #ifndef IREE_HAL_DYLIB_EXECUTABLE_CACHE_H_
 #define IREE_HAL_DYLIB_EXECUTABLE_CACHE_H_
 
+#include "iree/base/ref_ptr.h"
+#include "iree/hal/dylib/dylib_persistent_cache.h"
 #include "iree/hal/executable.h"
 #include "iree/hal/executable_cache.h"
 
@@ -24,7 +26,9 @@ namespace dylib {
 
 class DyLibExecutableCache final : public ExecutableCache {
  public:
-  DyLibExecutableCache();
+  // |persistent_cache| may be nullptr to disable persistent caching.
+  explicit DyLibExecutableCache(
+      ref_ptr<DyLibPersistentCache> persistent_cache = {});
   ~DyLibExecutableCache() override;
 
   bool CanPrepareFormat(ExecutableFormat format) const override;
@@ -32,6 +36,9 @@ class DyLibExecutableCache final : public ExecutableCache {
   StatusOr<ref_ptr<Executable>> PrepareExecutable(
       ExecutableLayout* executable_layout, ExecutableCachingModeBitfield mode,
       const ExecutableSpec& spec) override;
+
+ private:
+  ref_ptr<DyLibPersistentCache> persistent_cache_;
 };
 
 }  // namespace dylib
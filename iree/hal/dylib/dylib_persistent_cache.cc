@@ -0,0 +1,360 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/dylib/dylib_persistent_cache.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <map>
+
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "iree/base/api.h"
+#include "iree/base/file_io.h"
+#include "iree/base/file_path.h"
+#include "iree/base/target_platform.h"
+#include "iree/base/tracing.h"
+
+namespace iree {
+namespace hal {
+namespace dylib {
+
+namespace {
+
+// First line of every manifest. Bump when the cache layout or the way
+// libraries are extracted changes so that stale entries are ignored.
+constexpr char kManifestHeader[] = "iree-dylib-cache-v2";
+constexpr char kManifestExtension[] = ".manifest";
+#if defined(IREE_PLATFORM_WINDOWS)
+constexpr char kLibraryExtension[] = ".dll";
+#else
+constexpr char kLibraryExtension[] = ".so";
+#endif  // IREE_PLATFORM_WINDOWS
+
+// Length of keys produced by ComputeKey: a full hex SHA-256 digest.
+constexpr size_t kKeyLength = 64;
+
+bool IsLowerHex(absl::string_view value) {
+  if (value.empty()) return false;
+  for (char c : value) {
+    if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'))) return false;
+  }
+  return true;
+}
+
+// Returns true if |key| has the form produced by ComputeKey.
+bool IsValidKey(absl::string_view key) {
+  return key.size() == kKeyLength && IsLowerHex(key);
+}
+
+// Returns the key of |file_name| if it is a library or manifest written by the
+// cache and an empty string otherwise. Temporary files are not matched as they
+// may be in the process of being written by another process.
+absl::string_view GetCacheFileKey(absl::string_view file_name) {
+  size_t extension_pos = file_name.find('.');
+  if (extension_pos == absl::string_view::npos) return {};
+  absl::string_view key = file_name.substr(0, extension_pos);
+  absl::string_view extension = file_name.substr(extension_pos);
+  if (extension != kLibraryExtension && extension != kManifestExtension) {
+    return {};
+  }
+  return IsValidKey(key) ? key : absl::string_view{};
+}
+
+// Computes the SHA-256 digest of |data| (FIPS 180-4).
+std::array<uint8_t, 32> Sha256(absl::Span<const uint8_t> data) {
+  static constexpr uint32_t kRoundConstants[64] = {
+      0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+      0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+      0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+      0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+      0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+      0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+      0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+      0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+      0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+      0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+      0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+  };
+  uint32_t state[8] = {
+      0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+      0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+  };
+  auto rotr = [](uint32_t x, int n) { return (x >> n) | (x << (32 - n)); };
+  auto process_block = [&](const uint8_t* block) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; ++i) {
+      w[i] = (static_cast<uint32_t>(block[i * 4]) << 24) |
+             (static_cast<uint32_t>(block[i * 4 + 1]) << 16) |
+             (static_cast<uint32_t>(block[i * 4 + 2]) << 8) |
+             static_cast<uint32_t>(block[i * 4 + 3]);
+    }
+    for (int i = 16; i < 64; ++i) {
+      uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+      uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+      w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int i = 0; i < 64; ++i) {
+      uint32_t s1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+      uint32_t ch = (e & f) ^ (~e & g);
+      uint32_t t1 = h + s1 + ch + kRoundConstants[i] + w[i];
+      uint32_t s0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+      uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+      uint32_t t2 = s0 + maj;
+      h = g;
+      g = f;
+      f = e;
+      e = d + t1;
+      d = c;
+      c = b;
+      b = a;
+      a = t1 + t2;
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+  };
+
+  size_t full_blocks = data.size() / 64;
+  for (size_t i = 0; i < full_blocks; ++i) {
+    process_block(data.data() + i * 64);
+  }
+
+  // Pad the tail with 0x80, zeros and the big-endian bit length.
+  uint8_t tail[128] = {0};
+  size_t tail_length = data.size() - full_blocks * 64;
+  if (tail_length) {
+    std::memcpy(tail, data.data() + full_blocks * 64, tail_length);
+  }
+  tail[tail_length] = 0x80;
+  size_t tail_blocks = tail_length + 1 + 8 <= 64 ? 1 : 2;
+  uint64_t bit_length = static_cast<uint64_t>(data.size()) * 8;
+  for (int i = 0; i < 8; ++i) {
+    tail[tail_blocks * 64 - 1 - i] =
+        static_cast<uint8_t>(bit_length >> (i * 8));
+  }
+  for (size_t i = 0; i < tail_blocks; ++i) {
+    process_block(tail + i * 64);
+  }
+
+  std::array<uint8_t, 32> digest;
+  for (int i = 0; i < 8; ++i) {
+    digest[i * 4] = static_cast<uint8_t>(state[i] >> 24);
+    digest[i * 4 + 1] = static_cast<uint8_t>(state[i] >> 16);
+    digest[i * 4 + 2] = static_cast<uint8_t>(state[i] >> 8);
+    digest[i * 4 + 3] = static_cast<uint8_t>(state[i]);
+  }
+  return digest;
+}
+
+}  // namespace
+
+// static
+StatusOr<ref_ptr<DyLibPersistentCache>> DyLibPersistentCache::Open(
+    Options options) {
+  IREE_TRACE_SCOPE0("DyLibPersistentCache::Open");
+  if (options.path.empty()) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Persistent cache requires a directory path";
+  }
+  IREE_RETURN_IF_ERROR(file_io::CreateDirectories(options.path));
+  auto cache = assign_ref(new DyLibPersistentCache(std::move(options)));
+  IREE_RETURN_IF_ERROR(cache->Trim());
+  return cache;
+}
+
+// static
+std::string DyLibPersistentCache::ComputeKey(
+    absl::Span<const uint8_t> executable_data) {
+  IREE_TRACE_SCOPE0("DyLibPersistentCache::ComputeKey");
+  // Cached libraries are loaded without verification so the key must be
+  // collision resistant even against deliberately crafted executables.
+  std::string key;
+  key.reserve(kKeyLength);
+  for (uint8_t byte : Sha256(executable_data)) {
+    absl::StrAppend(&key, absl::Hex(byte, absl::kZeroPad2));
+  }
+  return key;
+}
+
+DyLibPersistentCache::DyLibPersistentCache(Options options)
+    : options_(std::move(options)) {}
+
+DyLibPersistentCache::~DyLibPersistentCache() = default;
+
+std::string DyLibPersistentCache::GetLibraryPath(absl::string_view key) const {
+  return file_path::JoinPaths(options_.path,
+                              absl::StrCat(key, kLibraryExtension));
+}
+
+std::string DyLibPersistentCache::GetManifestPath(absl::string_view key) const {
+  return file_path::JoinPaths(options_.path,
+                              absl::StrCat(key, kManifestExtension));
+}
+
+StatusOr<DyLibPersistentCache::Entry> DyLibPersistentCache::Lookup(
+    absl::string_view key) {
+  IREE_TRACE_SCOPE0("DyLibPersistentCache::Lookup");
+  std::string manifest_path = GetManifestPath(key);
+  auto manifest_or = file_io::GetFileContents(manifest_path);
+  if (!manifest_or.ok()) {
+    return NotFoundErrorBuilder(IREE_LOC) << "No cache entry for " << key;
+  }
+  std::vector<std::string> lines =
+      absl::StrSplit(manifest_or.value(), '\n', absl::SkipEmpty());
+  if (lines.size() < 2 || lines[0] != kManifestHeader) {
+    return NotFoundErrorBuilder(IREE_LOC)
+           << "Cache entry for " << key << " has an unsupported format";
+  }
+  // The full digest is recorded in the manifest so that an entry is only
+  // used when it was stored for exactly this key.
+  if (lines[1] != key) {
+    return NotFoundErrorBuilder(IREE_LOC)
+           << "Cache entry for " << key << " was stored for another digest";
+  }
+
+  Entry entry;
+  entry.library_path = GetLibraryPath(key);
+  // The library may have been evicted by another process since we read the
+  // manifest; loading can still fail and callers must handle that.
+  IREE_RETURN_IF_ERROR(file_io::FileExists(entry.library_path));
+  entry.entry_points.assign(lines.begin() + 2, lines.end());
+
+  // Mark as most recently used. Failure only affects eviction order.
+  file_io::TouchFile(manifest_path).IgnoreError();
+  return entry;
+}
+
+StatusOr<DyLibPersistentCache::Entry> DyLibPersistentCache::Insert(
+    absl::string_view key, absl::Span<const uint8_t> library_data,
+    absl::Span<const std::string> entry_points) {
+  IREE_TRACE_SCOPE0("DyLibPersistentCache::Insert");
+  if (!IsValidKey(key)) {
+    // Trim only recognizes files named by keys from ComputeKey.
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Cache key '" << key << "' was not produced by ComputeKey";
+  }
+
+  Entry entry;
+  entry.library_path = GetLibraryPath(key);
+  entry.entry_points.assign(entry_points.begin(), entry_points.end());
+
+  std::string manifest = absl::StrCat(kManifestHeader, "\n", key);
+  for (const auto& entry_point : entry_points) {
+    if (entry_point.empty() || entry_point.find('\n') != std::string::npos) {
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "Entry point name '" << entry_point << "' cannot be cached";
+    }
+    absl::StrAppend(&manifest, "\n", entry_point);
+  }
+
+  // The library must be in place before the manifest makes the entry visible.
+  IREE_RETURN_IF_ERROR(WriteFileAtomically(
+      entry.library_path,
+      absl::string_view(reinterpret_cast<const char*>(library_data.data()),
+                        library_data.size())));
+  IREE_RETURN_IF_ERROR(WriteFileAtomically(GetManifestPath(key), manifest));
+
+  IREE_RETURN_IF_ERROR(Trim(key));
+  return entry;
+}
+
+Status DyLibPersistentCache::WriteFileAtomically(const std::string& path,
+                                                 absl::string_view contents) {
+  std::string temp_path =
+      absl::StrCat(path, ".tmp", iree_time_now(), "_", next_temp_file_id_++);
+  IREE_RETURN_IF_ERROR(file_io::SetFileContents(temp_path, contents));
+  auto status = file_io::MoveFile(temp_path, path);
+  if (!status.ok()) {
+    file_io::DeleteFile(temp_path).IgnoreError();
+    // Some platforms don't allow replacing existing (or loaded) files. As the
+    // contents are keyed on their digest an existing file is just as good.
+    if (file_io::FileExists(path).ok()) return OkStatus();
+  }
+  return status;
+}
+
+Status DyLibPersistentCache::Trim(absl::string_view retain_key) {
+  IREE_TRACE_SCOPE0("DyLibPersistentCache::Trim");
+  absl::MutexLock lock(&trim_mutex_);
+
+  IREE_ASSIGN_OR_RETURN(auto file_infos, file_io::ListDirectory(options_.path));
+
+  // Group the cache files by their key. The directory may be shared with
+  // unrelated files (if the user points the cache at /tmp, for example) and
+  // those must never be touched. Temporary files are skipped as well: they are
+  // either about to be renamed into place by another process or were left
+  // behind by one that crashed, and neither case can be told apart here.
+  struct KeyFiles {
+    uint64_t size = 0;
+    uint64_t last_use_time = 0;
+    std::vector<std::string> names;
+  };
+  std::map<std::string, KeyFiles> key_files;
+  uint64_t total_size = 0;
+  for (auto& file_info : file_infos) {
+    absl::string_view key = GetCacheFileKey(file_info.name);
+    if (key.empty()) continue;
+    auto& files = key_files[std::string(key)];
+    files.size += file_info.size;
+    files.last_use_time =
+        std::max(files.last_use_time, file_info.modification_time);
+    files.names.push_back(std::move(file_info.name));
+    total_size += file_info.size;
+  }
+  if (total_size <= options_.max_size_bytes) return OkStatus();
+
+  std::vector<KeyFiles*> lru_order;
+  lru_order.reserve(key_files.size());
+  for (auto& it : key_files) {
+    if (it.first != retain_key) lru_order.push_back(&it.second);
+  }
+  std::sort(lru_order.begin(), lru_order.end(),
+            [](const KeyFiles* lhs, const KeyFiles* rhs) {
+              return lhs->last_use_time < rhs->last_use_time;
+            });
+
+  for (auto* files : lru_order) {
+    if (total_size <= options_.max_size_bytes) break;
+    auto& names = files->names;
+    // Delete the manifest first so the entry is never seen without its
+    // library.
+    std::stable_partition(names.begin(), names.end(),
+                          [](const std::string& name) {
+                            return absl::EndsWith(name, kManifestExtension);
+                          });
+    bool evicted = true;
+    for (const auto& name : names) {
+      evicted &= file_io::DeleteFile(file_path::JoinPaths(options_.path, name))
+                     .ok();
+    }
+    // Files in use may not be deletable on some platforms; they'll be retried
+    // on the next trim.
+    if (evicted) total_size -= files->size;
+  }
+  return OkStatus();
+}
+
+}  // namespace dylib
+}  // namespace hal
+}  // namespace iree
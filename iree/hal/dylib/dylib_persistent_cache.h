@@ -0,0 +1,116 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_DYLIB_DYLIB_PERSISTENT_CACHE_H_
+#define IREE_HAL_DYLIB_DYLIB_PERSISTENT_CACHE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "iree/base/ref_ptr.h"
+#include "iree/base/status.h"
+
+namespace iree {
+namespace hal {
+namespace dylib {
+
+// On-disk cache of the shared libraries extracted from dylib executables.
+//
+// Entries are keyed on the SHA-256 digest of the full executable flatbuffer
+// contents and consist of the extracted library file and a small manifest
+// recording the digest and listing the entry point symbols. A warm lookup only
+// needs to read the manifest and load the cached library, skipping flatbuffer
+// verification and library extraction.
+// Since cached libraries are loaded without verification the cache directory
+// must be as trusted as any other library search path.
+//
+// Files are written under temporary names and renamed into place so that
+// multiple processes may share one cache directory. The manifest is written
+// last and marks an entry as complete. When the total size of the cache files
+// exceeds |Options::max_size_bytes| the least recently used entries (by
+// manifest modification time, which is updated on each hit) are evicted. Only
+// libraries and manifests named by a key from ComputeKey are considered; other
+// files in the directory, including temporary files, are never deleted.
+//
+// Thread-safe.
+class DyLibPersistentCache final : public RefObject<DyLibPersistentCache> {
+ public:
+  struct Options {
+    // Directory the cache files are stored in. Created if needed.
+    std::string path;
+    // Total size of all cache files above which entries are evicted.
+    uint64_t max_size_bytes = 256 * 1024 * 1024;
+  };
+
+  // A cached library and the entry point symbols it exports.
+  struct Entry {
+    std::string library_path;
+    std::vector<std::string> entry_points;
+  };
+
+  // Opens (creating if needed) the cache directory at |options.path| and
+  // evicts entries until it is within the size limit.
+  static StatusOr<ref_ptr<DyLibPersistentCache>> Open(Options options);
+
+  // Returns the cache key for executables with the given flatbuffer contents:
+  // the lowercase hex SHA-256 digest of |executable_data|.
+  static std::string ComputeKey(absl::Span<const uint8_t> executable_data);
+
+  ~DyLibPersistentCache();
+
+  const Options& options() const { return options_; }
+
+  // Looks up the entry stored with |key| and marks it as most recently used.
+  // Returns NOT_FOUND if no complete entry exists.
+  StatusOr<Entry> Lookup(absl::string_view key);
+
+  // Stores |library_data| and its |entry_points| under |key|, replacing any
+  // existing entry, and then evicts old entries as needed. |key| must have been
+  // returned by ComputeKey.
+  StatusOr<Entry> Insert(absl::string_view key,
+                         absl::Span<const uint8_t> library_data,
+                         absl::Span<const std::string> entry_points);
+
+  // Evicts least recently used entries until the cache is within its size
+  // limit. The entry with |retain_key|, if any, is never evicted.
+  Status Trim(absl::string_view retain_key = {});
+
+ private:
+  explicit DyLibPersistentCache(Options options);
+
+  std::string GetLibraryPath(absl::string_view key) const;
+  std::string GetManifestPath(absl::string_view key) const;
+
+  // Writes |contents| to a temporary file and renames it to |path|.
+  Status WriteFileAtomically(const std::string& path,
+                             absl::string_view contents);
+
+  Options options_;
+  std::atomic<uint32_t> next_temp_file_id_{0};
+
+  // Serializes trims within the process. Other processes sharing the
+  // directory may trim concurrently and all file operations tolerate that.
+  absl::Mutex trim_mutex_;
+};
+
+}  // namespace dylib
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_DYLIB_DYLIB_PERSISTENT_CACHE_H_
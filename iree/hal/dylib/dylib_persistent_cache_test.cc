@@ -0,0 +1,228 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/dylib/dylib_persistent_cache.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "iree/base/file_io.h"
+#include "iree/base/file_path.h"
+#include "iree/base/logging.h"
+#include "iree/base/status.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace dylib {
+namespace {
+
+using ::iree::testing::status::StatusIs;
+using ::testing::ElementsAre;
+
+// Opens a cache in a fresh directory unique to |test_name|.
+ref_ptr<DyLibPersistentCache> OpenTestCache(const std::string& test_name,
+                                            uint64_t max_size_bytes) {
+  DyLibPersistentCache::Options options;
+  options.path = file_path::JoinPaths(file_io::GetTempPath(),
+                                      "dylib_persistent_cache_" + test_name);
+  options.max_size_bytes = max_size_bytes;
+  auto file_infos_or = file_io::ListDirectory(options.path);
+  if (file_infos_or.ok()) {
+    for (const auto& file_info : file_infos_or.value()) {
+      IREE_CHECK_OK(file_io::DeleteFile(
+          file_path::JoinPaths(options.path, file_info.name)));
+    }
+  }
+  auto cache_or = DyLibPersistentCache::Open(std::move(options));
+  IREE_CHECK_OK(cache_or.status());
+  return std::move(cache_or).value();
+}
+
+std::vector<uint8_t> MakeData(uint8_t value, size_t size) {
+  return std::vector<uint8_t>(size, value);
+}
+
+// Returns a valid cache key unique to |value|.
+std::string MakeKey(uint8_t value) {
+  return DyLibPersistentCache::ComputeKey(MakeData(value, 8));
+}
+
+TEST(DyLibPersistentCacheTest, ComputeKey) {
+  auto data_a = MakeData(1, 100);
+  auto data_b = MakeData(2, 100);
+  auto data_c = MakeData(1, 101);
+  std::string key_a = DyLibPersistentCache::ComputeKey(data_a);
+  EXPECT_EQ(key_a, DyLibPersistentCache::ComputeKey(data_a));
+  EXPECT_NE(key_a, DyLibPersistentCache::ComputeKey(data_b));
+  EXPECT_NE(key_a, DyLibPersistentCache::ComputeKey(data_c));
+  // Keys are used as file names and '.' separates the extension.
+  EXPECT_EQ(std::string::npos, key_a.find('.'));
+}
+
+// Keys are full SHA-256 digests; checked against the FIPS 180-4 examples.
+TEST(DyLibPersistentCacheTest, ComputeKeyIsSha256) {
+  auto make_bytes = [](const std::string& value) {
+    return std::vector<uint8_t>(value.begin(), value.end());
+  };
+  EXPECT_EQ("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855",
+            DyLibPersistentCache::ComputeKey({}));
+  EXPECT_EQ("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad",
+            DyLibPersistentCache::ComputeKey(make_bytes("abc")));
+  // Two blocks, with the padding spilling into the second.
+  EXPECT_EQ("248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1",
+            DyLibPersistentCache::ComputeKey(make_bytes(
+                "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")));
+  EXPECT_EQ("cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0",
+            DyLibPersistentCache::ComputeKey(MakeData('a', 1000000)));
+}
+
+TEST(DyLibPersistentCacheTest, LookupMissing) {
+  auto cache = OpenTestCache("LookupMissing", 1024 * 1024);
+  EXPECT_THAT(cache->Lookup("missing"), StatusIs(StatusCode::kNotFound));
+}
+
+TEST(DyLibPersistentCacheTest, InsertLookup) {
+  auto cache = OpenTestCache("InsertLookup", 1024 * 1024);
+  auto library_data = MakeData(7, 64);
+  std::string key = DyLibPersistentCache::ComputeKey(library_data);
+  std::vector<std::string> entry_points = {"entry_a", "entry_b"};
+  IREE_ASSERT_OK_AND_ASSIGN(auto inserted_entry,
+                            cache->Insert(key, library_data, entry_points));
+
+  IREE_ASSERT_OK_AND_ASSIGN(auto entry, cache->Lookup(key));
+  EXPECT_EQ(inserted_entry.library_path, entry.library_path);
+  EXPECT_THAT(entry.entry_points, ElementsAre("entry_a", "entry_b"));
+  IREE_ASSERT_OK_AND_ASSIGN(auto library_contents,
+                            file_io::GetFileContents(entry.library_path));
+  EXPECT_EQ(std::string(library_data.begin(), library_data.end()),
+            library_contents);
+
+  // Entries are visible to other instances sharing the directory.
+  DyLibPersistentCache::Options other_options = cache->options();
+  IREE_ASSERT_OK_AND_ASSIGN(auto other_cache,
+                            DyLibPersistentCache::Open(other_options));
+  IREE_EXPECT_OK(other_cache->Lookup(key).status());
+}
+
+TEST(DyLibPersistentCacheTest, InsertReplaces) {
+  auto cache = OpenTestCache("InsertReplaces", 1024 * 1024);
+  auto library_data = MakeData(3, 32);
+  std::string key = MakeKey(1);
+  IREE_ASSERT_OK(cache->Insert(key, library_data, {"a"}).status());
+  IREE_ASSERT_OK(cache->Insert(key, library_data, {"b"}).status());
+  IREE_ASSERT_OK_AND_ASSIGN(auto entry, cache->Lookup(key));
+  EXPECT_THAT(entry.entry_points, ElementsAre("b"));
+}
+
+TEST(DyLibPersistentCacheTest, InsertInvalidKey) {
+  auto cache = OpenTestCache("InsertInvalidKey", 1024 * 1024);
+  EXPECT_THAT(cache->Insert("key", MakeData(1, 16), {"a"}),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+TEST(DyLibPersistentCacheTest, UnsupportedManifest) {
+  auto cache = OpenTestCache("UnsupportedManifest", 1024 * 1024);
+  std::string key = MakeKey(1);
+  IREE_ASSERT_OK(cache->Insert(key, MakeData(1, 16), {"a"}).status());
+  IREE_ASSERT_OK(file_io::SetFileContents(
+      file_path::JoinPaths(cache->options().path, key + ".manifest"),
+      "iree-dylib-cache-v0\na"));
+  EXPECT_THAT(cache->Lookup(key), StatusIs(StatusCode::kNotFound));
+}
+
+TEST(DyLibPersistentCacheTest, ManifestDigestMismatch) {
+  auto cache = OpenTestCache("ManifestDigestMismatch", 1024 * 1024);
+  std::string key = MakeKey(1);
+  IREE_ASSERT_OK(cache->Insert(key, MakeData(1, 16), {"a"}).status());
+  // A manifest recording another digest must not be used for |key|.
+  IREE_ASSERT_OK(file_io::SetFileContents(
+      file_path::JoinPaths(cache->options().path, key + ".manifest"),
+      "iree-dylib-cache-v2\n" + MakeKey(2) + "\na"));
+  EXPECT_THAT(cache->Lookup(key), StatusIs(StatusCode::kNotFound));
+}
+
+TEST(DyLibPersistentCacheTest, EvictsLeastRecentlyUsed) {
+  // Room for about three 1000 byte libraries (plus their manifests).
+  auto cache = OpenTestCache("EvictsLeastRecentlyUsed", 3500);
+  auto library_data = MakeData(9, 1000);
+  // Modification times may have coarse granularity on some file systems.
+  auto wait = []() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  };
+  std::string key_a = MakeKey(1);
+  std::string key_b = MakeKey(2);
+  std::string key_c = MakeKey(3);
+  std::string key_d = MakeKey(4);
+  IREE_ASSERT_OK(cache->Insert(key_a, library_data, {"f"}).status());
+  wait();
+  IREE_ASSERT_OK(cache->Insert(key_b, library_data, {"f"}).status());
+  wait();
+  IREE_ASSERT_OK(cache->Insert(key_c, library_data, {"f"}).status());
+  wait();
+  IREE_ASSERT_OK(cache->Lookup(key_a).status());
+  wait();
+  IREE_ASSERT_OK(cache->Insert(key_d, library_data, {"f"}).status());
+
+  EXPECT_THAT(cache->Lookup(key_b), StatusIs(StatusCode::kNotFound));
+  IREE_EXPECT_OK(cache->Lookup(key_a).status());
+  IREE_EXPECT_OK(cache->Lookup(key_c).status());
+  IREE_EXPECT_OK(cache->Lookup(key_d).status());
+}
+
+TEST(DyLibPersistentCacheTest, RetainsEntryLargerThanLimit) {
+  auto cache = OpenTestCache("RetainsEntryLargerThanLimit", 100);
+  std::string key_a = MakeKey(1);
+  std::string key_b = MakeKey(2);
+  IREE_ASSERT_OK(cache->Insert(key_a, MakeData(1, 1000), {"f"}).status());
+  IREE_ASSERT_OK(cache->Insert(key_b, MakeData(2, 1000), {"f"}).status());
+  // The newest entry is kept so that it can be loaded.
+  EXPECT_THAT(cache->Lookup(key_a), StatusIs(StatusCode::kNotFound));
+  IREE_EXPECT_OK(cache->Lookup(key_b).status());
+}
+
+TEST(DyLibPersistentCacheTest, TrimIgnoresForeignFiles) {
+  auto cache = OpenTestCache("TrimIgnoresForeignFiles", 100);
+  const std::string& path = cache->options().path;
+  std::string key_a = MakeKey(1);
+  // Unrelated files, files that only look like cache files, and another
+  // process's in-flight temporary file.
+  std::vector<std::string> foreign_names = {
+      "notes.txt",
+      "a.manifest",
+      key_a + ".txt",
+      key_a + ".so.tmp1234_0",
+  };
+  for (const auto& name : foreign_names) {
+    IREE_ASSERT_OK(file_io::SetFileContents(file_path::JoinPaths(path, name),
+                                            std::string(1000, 'x')));
+  }
+
+  IREE_ASSERT_OK(cache->Insert(key_a, MakeData(1, 1000), {"f"}).status());
+  IREE_ASSERT_OK(cache->Insert(MakeKey(2), MakeData(2, 1000), {"f"}).status());
+  EXPECT_THAT(cache->Lookup(key_a), StatusIs(StatusCode::kNotFound));
+  for (const auto& name : foreign_names) {
+    IREE_EXPECT_OK(file_io::FileExists(file_path::JoinPaths(path, name)))
+        << name;
+  }
+}
+
+}  // namespace
+}  // namespace dylib
+}  // namespace hal
+}  // namespace iree
@@ -16,7 +16,19 @@
 
 #include <inttypes.h>
 
+#include <algorithm>
+#include <string>
+
+#include "absl/flags/flag.h"
 #include "iree/hal/dylib/dylib_driver.h"
+#include "iree/hal/host/task/shared_executor.h"
+
+ABSL_FLAG(std::string, dylib_cache_path, "",
+          "Directory used to persist extracted executable libraries across "
+          "runs. Persistent caching is disabled when empty.");
+ABSL_FLAG(int, dylib_cache_max_size_mb, 256,
+          "Size limit of the persistent executable cache directory above "
+          "which least recently used entries are evicted.");
 
 #define IREE_HAL_DYLIB_DRIVER_ID 0x58444C4Cu  // XDLL
 
@@ -42,7 +54,25 @@ static iree_status_t iree_hal_dylib_driver_factory_try_create(
                             " is provided by this factory",
                             driver_id);
   }
-  auto* driver = new iree::hal::dylib::DyLibDriver();
+  iree::ref_ptr<iree::hal::dylib::DyLibPersistentCache> persistent_cache;
+  std::string cache_path = absl::GetFlag(FLAGS_dylib_cache_path);
+  if (!cache_path.empty()) {
+    iree::hal::dylib::DyLibPersistentCache::Options cache_options;
+    cache_options.path = std::move(cache_path);
+    cache_options.max_size_bytes =
+        static_cast<uint64_t>(
+            std::max(0, absl::GetFlag(FLAGS_dylib_cache_max_size_mb))) *
+        1024 * 1024;
+    IREE_ASSIGN_OR_RETURN(persistent_cache,
+                          iree::hal::dylib::DyLibPersistentCache::Open(
+                              std::move(cache_options)));
+  }
+  IREE_ASSIGN_OR_RETURN(auto executor,
+                        iree::hal::host::AcquireSharedTaskExecutor());
+  auto* driver = new iree::hal::dylib::DyLibDriver(
+      executor, std::move(persistent_cache),
+      iree::hal::host::GetHostQueueWorkerCount());
+  if (executor) iree_task_executor_release(executor);
   *out_driver = reinterpret_cast<iree_hal_driver_t*>(driver);
   return iree_ok_status();
 }
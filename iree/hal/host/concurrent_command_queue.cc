@@ -0,0 +1,280 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/concurrent_command_queue.h"
+
+#include "absl/memory/memory.h"
+#include "absl/time/time.h"
+#include "iree/base/logging.h"
+#include "iree/base/tracing.h"
+#include "iree/hal/host/condvar_semaphore.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+
+ConcurrentCommandQueue::ConcurrentCommandQueue(
+    std::unique_ptr<CommandQueue> target_queue, int worker_count)
+    : CommandQueue(target_queue->name(), target_queue->supported_categories()),
+      target_queue_(std::move(target_queue)) {
+  IREE_TRACE_SCOPE0("ConcurrentCommandQueue::ctor");
+  IREE_CHECK_GT(worker_count, 0);
+  iree_notification_initialize(&worker_notification_);
+  IREE_TRACE_SET_PLOT_TYPE("hal.host_queue.depth",
+                           IREE_TRACING_PLOT_TYPE_NUMBER);
+  IREE_TRACE_SET_PLOT_TYPE("hal.host_queue.wait_us",
+                           IREE_TRACING_PLOT_TYPE_NUMBER);
+  workers_.reserve(worker_count);
+  for (int i = 0; i < worker_count; ++i) {
+    workers_.emplace_back([this]() { WorkerMain(); });
+  }
+}
+
+ConcurrentCommandQueue::~ConcurrentCommandQueue() {
+  IREE_TRACE_SCOPE0("ConcurrentCommandQueue::dtor");
+  {
+    // Signal to the workers that we want to stop. They will finish processing
+    // any queued submissions before exiting.
+    absl::MutexLock lock(&mutex_);
+    has_shutdown_ = true;
+    NotifyStateChanged();
+  }
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+
+  // Ensure we shut down OK.
+  {
+    absl::MutexLock lock(&mutex_);
+    IREE_CHECK(list_.empty())
+        << "Dirty shutdown of concurrent queue (unexpected thread exit?)";
+  }
+  iree_notification_deinitialize(&worker_notification_);
+}
+
+void ConcurrentCommandQueue::NotifyStateChanged() {
+  IREE_TRACE_PLOT_VALUE_I64("hal.host_queue.depth", list_.size());
+  state_changed_.SignalAll();
+  iree_notification_post(&worker_notification_, IREE_ALL_WAITERS);
+}
+
+void ConcurrentCommandQueue::SetWatchingWaitSemaphores(Submission* submission,
+                                                       bool watching) {
+  if (submission->is_watching == watching) return;
+  submission->is_watching = watching;
+  for (auto& wait_point :
+       submission->pending_batches.front().wait_semaphores) {
+    auto* semaphore = reinterpret_cast<CondVarSemaphore*>(wait_point.semaphore);
+    if (watching) {
+      semaphore->AddNotification(&worker_notification_);
+    } else {
+      semaphore->RemoveNotification(&worker_notification_);
+    }
+  }
+}
+
+ConcurrentCommandQueue::Submission*
+ConcurrentCommandQueue::TakeReadySubmission() {
+  for (auto* submission : list_) {
+    if (submission->is_running) continue;
+    bool is_ready = true;
+    for (auto& wait_point :
+         submission->pending_batches.front().wait_semaphores) {
+      auto* semaphore =
+          reinterpret_cast<CondVarSemaphore*>(wait_point.semaphore);
+      auto value_or = semaphore->Query();
+      if (!value_or.ok()) {
+        // Batch dependencies failed; set the permanent error flag and abort
+        // so we don't try to process anything else.
+        permanent_error_ = std::move(value_or).status();
+        FailAllPending(permanent_error_);
+        return nullptr;
+      } else if (value_or.value() < wait_point.value) {
+        is_ready = false;
+        break;
+      }
+    }
+    if (is_ready) return submission;
+  }
+  return nullptr;
+}
+
+void ConcurrentCommandQueue::WorkerMain() {
+  IREE_TRACE_SET_THREAD_NAME(target_queue_->name().c_str());
+
+  mutex_.Lock();
+  while (true) {
+    // Prepare to wait before checking the semaphores so that any signal that
+    // happens after the check (from this queue, another queue, or the host)
+    // posts the notification and wakes us.
+    iree_wait_token_t wait_token =
+        iree_notification_prepare_wait(&worker_notification_);
+    Submission* submission = TakeReadySubmission();
+    if (!submission) {
+      // Exit when there are no more submissions to process and an exit was
+      // requested (or we errored out).
+      if (list_.empty() && has_shutdown_) {
+        iree_notification_cancel_wait(&worker_notification_);
+        break;
+      }
+      mutex_.Unlock();
+      iree_notification_commit_wait(&worker_notification_, wait_token);
+      mutex_.Lock();
+      continue;
+    }
+    iree_notification_cancel_wait(&worker_notification_);
+
+    // Claim the submission so no other worker runs its batches. The batch
+    // storage is stable while the submission is running as only the claiming
+    // worker may modify or complete it.
+    submission->is_running = true;
+    SetWatchingWaitSemaphores(submission, false);
+    const PendingBatch& batch = submission->pending_batches.front();
+    IREE_TRACE(int64_t wait_us =
+                   (iree_time_now() - submission->ready_time_ns) / 1000);
+    IREE_TRACE(int64_t depth = list_.size());
+    IREE_TRACE_PLOT_VALUE_I64("hal.host_queue.wait_us", wait_us);
+
+    // Release the lock while we perform the processing so that other workers
+    // and threads can make progress.
+    mutex_.Unlock();
+    IREE_TRACE_ZONE_BEGIN_NAMED(z0, "ConcurrentCommandQueue::ProcessBatch");
+    IREE_TRACE_ZONE_APPEND_TEXT(z0, name().data(), name().size());
+    IREE_TRACE_ZONE_APPEND_VALUE(z0, wait_us);
+    IREE_TRACE_ZONE_APPEND_VALUE(z0, depth);
+    auto status = ProcessBatch(batch);
+    IREE_TRACE_ZONE_END(z0);
+    mutex_.Lock();
+
+    submission->is_running = false;
+    if (!status.ok()) {
+      // Batch failed; set the permanent error flag and abort so we don't try
+      // to process anything else.
+      if (permanent_error_.ok()) permanent_error_ = Status(status);
+      CompleteSubmission(submission, std::move(status));
+      FailAllPending(permanent_error_);
+    } else {
+      submission->pending_batches.erase(
+          submission->pending_batches.begin());
+      if (!permanent_error_.ok()) {
+        // Another submission failed while we were running.
+        CompleteSubmission(submission, permanent_error_);
+      } else if (submission->pending_batches.empty()) {
+        // All work for this submission completed successfully.
+        CompleteSubmission(submission, OkStatus());
+      } else {
+        submission->ready_time_ns = iree_time_now();
+        SetWatchingWaitSemaphores(submission, true);
+      }
+    }
+    NotifyStateChanged();
+  }
+  mutex_.Unlock();
+}
+
+Status ConcurrentCommandQueue::ProcessBatch(const PendingBatch& batch) {
+  // Relay the command buffers to the target queue.
+  // Since we are taking care of all synchronization they don't need any
+  // waiters or semaphores.
+  IREE_RETURN_IF_ERROR(target_queue_->Submit({{}, batch.command_buffers, {}}));
+
+  // Signal all semaphores to allow them to unblock waiters.
+  for (auto& signal_point : batch.signal_semaphores) {
+    auto* semaphore =
+        reinterpret_cast<CondVarSemaphore*>(signal_point.semaphore);
+    IREE_RETURN_IF_ERROR(semaphore->Signal(signal_point.value));
+  }
+  return OkStatus();
+}
+
+void ConcurrentCommandQueue::CompleteSubmission(Submission* submission,
+                                                Status status) {
+  IREE_TRACE_SCOPE0("ConcurrentCommandQueue::CompleteSubmission");
+  SetWatchingWaitSemaphores(submission, false);
+  if (!status.ok()) {
+    // Fail all pending batch semaphores that we would have signaled.
+    for (auto& batch : submission->pending_batches) {
+      for (auto& signal_point : batch.signal_semaphores) {
+        auto* semaphore =
+            reinterpret_cast<CondVarSemaphore*>(signal_point.semaphore);
+        semaphore->Fail(status);
+      }
+    }
+    submission->pending_batches.clear();
+  }
+  list_.take(submission).reset();
+}
+
+void ConcurrentCommandQueue::FailAllPending(Status status) {
+  IREE_TRACE_SCOPE0("ConcurrentCommandQueue::FailAllPending");
+  auto* submission = list_.front();
+  while (submission) {
+    auto* next_submission = list_.next(submission);
+    if (!submission->is_running) {
+      CompleteSubmission(submission, status);
+    }
+    submission = next_submission;
+  }
+}
+
+Status ConcurrentCommandQueue::Submit(
+    absl::Span<const SubmissionBatch> batches) {
+  IREE_TRACE_SCOPE0("ConcurrentCommandQueue::Submit");
+  if (batches.empty()) return OkStatus();
+
+  absl::MutexLock lock(&mutex_);
+  if (has_shutdown_) {
+    return FailedPreconditionErrorBuilder(IREE_LOC)
+           << "Cannot enqueue new submissions; queue is exiting";
+  } else if (!permanent_error_.ok()) {
+    return permanent_error_;
+  }
+
+  // Add to list in submission order.
+  auto submission = absl::make_unique<Submission>();
+  submission->pending_batches.resize(batches.size());
+  for (int i = 0; i < batches.size(); ++i) {
+    submission->pending_batches[i] = PendingBatch{
+        {batches[i].wait_semaphores.begin(), batches[i].wait_semaphores.end()},
+        {batches[i].command_buffers.begin(), batches[i].command_buffers.end()},
+        {batches[i].signal_semaphores.begin(),
+         batches[i].signal_semaphores.end()},
+    };
+  }
+  submission->ready_time_ns = iree_time_now();
+  SetWatchingWaitSemaphores(submission.get(), true);
+  list_.push_back(std::move(submission));
+  NotifyStateChanged();
+  return OkStatus();
+}
+
+Status ConcurrentCommandQueue::WaitIdle(Time deadline_ns) {
+  IREE_TRACE_SCOPE0("ConcurrentCommandQueue::WaitIdle");
+
+  // Wait until the deadline or there are no more pending submissions.
+  absl::MutexLock lock(&mutex_);
+  absl::Time deadline = absl::FromUnixNanos(static_cast<int64_t>(deadline_ns));
+  while (!list_.empty() && permanent_error_.ok()) {
+    if (state_changed_.WaitWithDeadline(&mutex_, deadline) &&
+        !list_.empty() && permanent_error_.ok()) {
+      return DeadlineExceededErrorBuilder(IREE_LOC)
+             << "Deadline exceeded waiting for concurrent queue to go idle";
+    }
+  }
+  return permanent_error_;
+}
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
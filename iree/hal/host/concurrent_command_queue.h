@@ -0,0 +1,142 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_HOST_CONCURRENT_COMMAND_QUEUE_H_
+#define IREE_HAL_HOST_CONCURRENT_COMMAND_QUEUE_H_
+
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/synchronization/mutex.h"
+#include "iree/base/intrusive_list.h"
+#include "iree/base/status.h"
+#include "iree/base/synchronization.h"
+#include "iree/base/time.h"
+#include "iree/hal/command_queue.h"
+#include "iree/hal/semaphore.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+
+// Concurrent command queue wrapper.
+// This creates a bounded pool of worker threads that perform CommandQueue
+// operations against the provided |target_queue|. Unlike AsyncCommandQueue,
+// which runs all submissions FIFO on a single thread, independent submissions
+// run concurrently as soon as their wait semaphores are satisfied.
+//
+// Batches within a single Submit call execute in order. Batches from different
+// Submit calls are ordered only by their semaphores: a submission may start
+// ahead of one submitted earlier that is still waiting.
+//
+// Target queues will receive submissions containing only command buffers as
+// all semaphore synchronization is handled by the wrapper and must be safe to
+// call from multiple threads concurrently.
+//
+// Queue depth and the time submissions spend waiting to start are reported
+// through tracing.
+//
+// ConcurrentCommandQueue (as with CommandQueue) is thread-safe.
+class ConcurrentCommandQueue final : public CommandQueue {
+ public:
+  ConcurrentCommandQueue(std::unique_ptr<CommandQueue> target_queue,
+                         int worker_count);
+  ~ConcurrentCommandQueue() override;
+
+  Status Submit(absl::Span<const SubmissionBatch> batches) override;
+
+  Status WaitIdle(Time deadline_ns) override;
+
+ private:
+  // A submitted command buffer batch and its synchronization information.
+  struct PendingBatch {
+    absl::InlinedVector<SemaphoreValue, 4> wait_semaphores;
+    absl::InlinedVector<CommandBuffer*, 4> command_buffers;
+    absl::InlinedVector<SemaphoreValue, 4> signal_semaphores;
+  };
+  struct Submission : public IntrusiveLinkBase<void> {
+    // Batches remaining in submission order; the front batch runs next.
+    absl::InlinedVector<PendingBatch, 4> pending_batches;
+    // Time the submission was enqueued (or its last batch completed).
+    iree_time_t ready_time_ns = 0;
+    // True while a worker is processing the front batch.
+    bool is_running = false;
+    // True while the front batch wait semaphores post worker_notification_.
+    bool is_watching = false;
+  };
+
+  // Thread entry point for the worker threads.
+  // Waits for submissions to become ready and processes them eagerly.
+  void WorkerMain();
+
+  // Returns the first submission that is not running and whose front batch
+  // has all of its wait semaphores signaled, or nullptr if none are ready.
+  // Submissions whose wait semaphores have failed are completed with the
+  // failure and put the queue into the permanent error state.
+  Submission* TakeReadySubmission() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Dispatches the command buffers of |batch| to the target queue and signals
+  // its semaphores. Called without the lock held.
+  Status ProcessBatch(const PendingBatch& batch);
+
+  // Completes a submission. Any remaining batches will have their semaphores
+  // signaled for failure.
+  void CompleteSubmission(Submission* submission, Status status)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Fails all pending submissions that are not currently running with the
+  // given status. Running submissions are failed by their worker.
+  void FailAllPending(Status status) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Notifies workers and waiters that the queue state has changed.
+  void NotifyStateChanged() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Registers (or unregisters) worker_notification_ with the wait semaphores
+  // of the front batch of |submission| so that workers blocked waiting for a
+  // ready submission wake when any of them are signaled.
+  void SetWatchingWaitSemaphores(Submission* submission, bool watching)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // CommandQueue that the concurrent queue relays submissions into.
+  std::unique_ptr<CommandQueue> target_queue_;
+
+  // Worker threads that run the WorkerMain() function.
+  std::vector<std::thread> workers_;
+
+  mutable absl::Mutex mutex_;
+  absl::CondVar state_changed_;
+
+  // Posted when the queue state changes or a semaphore that a pending batch is
+  // waiting on is signaled. Workers block on this when no batch is ready.
+  iree_notification_t worker_notification_;
+
+  // True to exit the workers after all submissions complete.
+  bool has_shutdown_ ABSL_GUARDED_BY(mutex_) = false;
+
+  // A sticky error that is set on the first failed submit. All future
+  // submissions will be rejected.
+  Status permanent_error_ ABSL_GUARDED_BY(mutex_);
+
+  // Pending and running submissions in submission order.
+  IntrusiveList<std::unique_ptr<Submission>> list_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_HOST_CONCURRENT_COMMAND_QUEUE_H_
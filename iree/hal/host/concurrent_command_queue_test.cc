@@ -0,0 +1,250 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/concurrent_command_queue.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/synchronization/mutex.h"
+#include "iree/base/status.h"
+#include "iree/base/time.h"
+#include "iree/hal/command_queue.h"
+#include "iree/hal/host/condvar_semaphore.h"
+#include "iree/hal/testing/mock_command_buffer.h"
+#include "iree/hal/testing/mock_command_queue.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+namespace {
+
+using ::testing::_;
+
+using testing::MockCommandBuffer;
+using testing::MockCommandQueue;
+
+// Suspends execution of the calling thread for the given |duration_ms|.
+inline void Sleep(std::chrono::milliseconds duration_ms) {
+  std::this_thread::sleep_for(duration_ms);
+}
+
+struct ConcurrentCommandQueueTest : public ::testing::Test {
+  static constexpr int kWorkerCount = 2;
+
+  MockCommandQueue* mock_target_queue;
+  std::unique_ptr<CommandQueue> command_queue;
+
+  void SetUp() override {
+    auto mock_queue = absl::make_unique<MockCommandQueue>(
+        "mock", CommandCategory::kTransfer | CommandCategory::kDispatch);
+    mock_target_queue = mock_queue.get();
+    command_queue = absl::make_unique<ConcurrentCommandQueue>(
+        std::move(mock_queue), kWorkerCount);
+  }
+
+  void TearDown() override {
+    command_queue.reset();
+    mock_target_queue = nullptr;
+  }
+};
+
+// Tests that submitting a command buffer and immediately waiting will not
+// deadlock.
+TEST_F(ConcurrentCommandQueueTest, BlockingSubmit) {
+  auto cmd_buffer = make_ref<MockCommandBuffer>(CommandBufferMode::kOneShot,
+                                                CommandCategory::kTransfer);
+
+  EXPECT_CALL(*mock_target_queue, Submit(_))
+      .WillOnce([&](absl::Span<const SubmissionBatch> batches) {
+        IREE_CHECK_EQ(1, batches.size());
+        IREE_CHECK_EQ(1, batches[0].command_buffers.size());
+        IREE_CHECK_EQ(cmd_buffer.get(), batches[0].command_buffers[0]);
+        return OkStatus();
+      });
+  CondVarSemaphore semaphore(0ull);
+  IREE_ASSERT_OK(
+      command_queue->Submit({{}, {cmd_buffer.get()}, {{&semaphore, 1ull}}}));
+  IREE_ASSERT_OK(semaphore.Wait(1ull, InfiniteFuture()));
+}
+
+// Tests that independent submissions execute concurrently.
+TEST_F(ConcurrentCommandQueueTest, IndependentSubmissionsOverlap) {
+  std::atomic<int> started{0};
+  std::atomic<int> in_flight{0};
+  std::atomic<int> peak_in_flight{0};
+  EXPECT_CALL(*mock_target_queue, Submit(_))
+      .Times(kWorkerCount)
+      .WillRepeatedly([&](absl::Span<const SubmissionBatch> batches) {
+        ++started;
+        int count = ++in_flight;
+        peak_in_flight = std::max(peak_in_flight.load(), count);
+        // Wait (bounded) for the other submission to start.
+        for (int i = 0; i < 500 && started < kWorkerCount; ++i) {
+          Sleep(std::chrono::milliseconds(10));
+        }
+        peak_in_flight = std::max(peak_in_flight.load(), in_flight.load());
+        --in_flight;
+        return OkStatus();
+      });
+
+  std::vector<ref_ptr<MockCommandBuffer>> cmd_buffers;
+  std::vector<std::unique_ptr<CondVarSemaphore>> semaphores;
+  for (int i = 0; i < kWorkerCount; ++i) {
+    cmd_buffers.push_back(make_ref<MockCommandBuffer>(
+        CommandBufferMode::kOneShot, CommandCategory::kTransfer));
+    semaphores.push_back(absl::make_unique<CondVarSemaphore>(0ull));
+    IREE_ASSERT_OK(command_queue->Submit(
+        {{}, {cmd_buffers[i].get()}, {{semaphores[i].get(), 1ull}}}));
+  }
+  IREE_ASSERT_OK(command_queue->WaitIdle());
+  EXPECT_EQ(kWorkerCount, peak_in_flight.load());
+}
+
+// Tests that a submission waiting on a semaphore does not block independent
+// submissions made after it and runs once its wait is satisfied.
+TEST_F(ConcurrentCommandQueueTest, WaitSemaphoresOrderSubmissions) {
+  absl::Mutex order_mutex;
+  std::vector<CommandBuffer*> order;
+  EXPECT_CALL(*mock_target_queue, Submit(_))
+      .Times(2)
+      .WillRepeatedly([&](absl::Span<const SubmissionBatch> batches) {
+        absl::MutexLock lock(&order_mutex);
+        order.push_back(batches[0].command_buffers[0]);
+        return OkStatus();
+      });
+
+  auto cmd_buffer_0 = make_ref<MockCommandBuffer>(CommandBufferMode::kOneShot,
+                                                  CommandCategory::kTransfer);
+  auto cmd_buffer_1 = make_ref<MockCommandBuffer>(CommandBufferMode::kOneShot,
+                                                  CommandCategory::kTransfer);
+
+  // Submission 0 depends on submission 1, which is made after it.
+  CondVarSemaphore semaphore_0(0ull);
+  CondVarSemaphore semaphore_1(0ull);
+  IREE_ASSERT_OK(command_queue->Submit(
+      {{{&semaphore_1, 1ull}}, {cmd_buffer_0.get()}, {{&semaphore_0, 1ull}}}));
+  IREE_ASSERT_OK(command_queue->Submit(
+      {{}, {cmd_buffer_1.get()}, {{&semaphore_1, 1ull}}}));
+  IREE_ASSERT_OK(semaphore_0.Wait(1ull, InfiniteFuture()));
+  IREE_ASSERT_OK(command_queue->WaitIdle());
+
+  absl::MutexLock lock(&order_mutex);
+  ASSERT_EQ(2, order.size());
+  EXPECT_EQ(cmd_buffer_1.get(), order[0]);
+  EXPECT_EQ(cmd_buffer_0.get(), order[1]);
+}
+
+// Tests that a submission waiting on a semaphore signaled by the host (and not
+// by any queue) runs once the semaphore is signaled.
+TEST_F(ConcurrentCommandQueueTest, HostSignaledWait) {
+  EXPECT_CALL(*mock_target_queue, Submit(_))
+      .WillOnce([](absl::Span<const SubmissionBatch> batches) {
+        return OkStatus();
+      });
+
+  auto cmd_buffer = make_ref<MockCommandBuffer>(CommandBufferMode::kOneShot,
+                                                CommandCategory::kTransfer);
+  CondVarSemaphore wait_semaphore(0ull);
+  CondVarSemaphore signal_semaphore(0ull);
+  IREE_ASSERT_OK(command_queue->Submit({{{&wait_semaphore, 1ull}},
+                                        {cmd_buffer.get()},
+                                        {{&signal_semaphore, 1ull}}}));
+
+  // Give the workers time to go idle before signaling from the host.
+  Sleep(std::chrono::milliseconds(50));
+  IREE_ASSERT_OK(wait_semaphore.Signal(1ull));
+  IREE_ASSERT_OK(signal_semaphore.Wait(1ull, InfiniteFuture()));
+  IREE_ASSERT_OK(command_queue->WaitIdle());
+}
+
+// Tests that batches within a single submission execute in order.
+TEST_F(ConcurrentCommandQueueTest, BatchesExecuteInOrder) {
+  absl::Mutex order_mutex;
+  std::vector<CommandBuffer*> order;
+  EXPECT_CALL(*mock_target_queue, Submit(_))
+      .Times(2)
+      .WillRepeatedly([&](absl::Span<const SubmissionBatch> batches) {
+        Sleep(std::chrono::milliseconds(10));
+        absl::MutexLock lock(&order_mutex);
+        order.push_back(batches[0].command_buffers[0]);
+        return OkStatus();
+      });
+
+  auto cmd_buffer_0 = make_ref<MockCommandBuffer>(CommandBufferMode::kOneShot,
+                                                  CommandCategory::kTransfer);
+  auto cmd_buffer_1 = make_ref<MockCommandBuffer>(CommandBufferMode::kOneShot,
+                                                  CommandCategory::kTransfer);
+  CommandBuffer* cmd_buffers_0[] = {cmd_buffer_0.get()};
+  CommandBuffer* cmd_buffers_1[] = {cmd_buffer_1.get()};
+  CondVarSemaphore semaphore(0ull);
+  SemaphoreValue signal_point = {&semaphore, 1ull};
+  SubmissionBatch batches[] = {
+      {{}, cmd_buffers_0, {}},
+      {{}, cmd_buffers_1, absl::MakeConstSpan(&signal_point, 1)},
+  };
+  IREE_ASSERT_OK(command_queue->Submit(batches));
+  IREE_ASSERT_OK(semaphore.Wait(1ull, InfiniteFuture()));
+
+  absl::MutexLock lock(&order_mutex);
+  ASSERT_EQ(2, order.size());
+  EXPECT_EQ(cmd_buffer_0.get(), order[0]);
+  EXPECT_EQ(cmd_buffer_1.get(), order[1]);
+}
+
+// Tests that a failure with a dependent submission pending causes the
+// dependent submission to fail as well and that failures are sticky.
+TEST_F(ConcurrentCommandQueueTest, FailuresCascadeAcrossSubmits) {
+  EXPECT_CALL(*mock_target_queue, Submit(_))
+      .WillOnce([](absl::Span<const SubmissionBatch> batches) {
+        Sleep(std::chrono::milliseconds(100));
+        return DataLossErrorBuilder(IREE_LOC);
+      });
+
+  auto cmd_buffer_0 = make_ref<MockCommandBuffer>(CommandBufferMode::kOneShot,
+                                                  CommandCategory::kTransfer);
+  auto cmd_buffer_1 = make_ref<MockCommandBuffer>(CommandBufferMode::kOneShot,
+                                                  CommandCategory::kTransfer);
+
+  CondVarSemaphore semaphore_0(0ull);
+  IREE_ASSERT_OK(command_queue->Submit(
+      {{}, {cmd_buffer_0.get()}, {{&semaphore_0, 1ull}}}));
+  CondVarSemaphore semaphore_1(0ull);
+  IREE_ASSERT_OK(command_queue->Submit(
+      {{{&semaphore_0, 1ull}}, {cmd_buffer_1.get()}, {{&semaphore_1, 1ull}}}));
+
+  EXPECT_TRUE(IsDataLoss(command_queue->WaitIdle()));
+  EXPECT_TRUE(IsDataLoss(semaphore_0.Wait(1ull, InfiniteFuture())));
+  EXPECT_TRUE(IsDataLoss(semaphore_1.Wait(1ull, InfiniteFuture())));
+
+  // Future submits should fail.
+  auto cmd_buffer_2 = make_ref<MockCommandBuffer>(CommandBufferMode::kOneShot,
+                                                  CommandCategory::kTransfer);
+  CondVarSemaphore semaphore_2(0ull);
+  EXPECT_TRUE(IsDataLoss(command_queue->Submit(
+      {{}, {cmd_buffer_2.get()}, {{&semaphore_2, 1ull}}})));
+}
+
+}  // namespace
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
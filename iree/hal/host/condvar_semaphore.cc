@@ -14,6 +14,7 @@
 
 #include "iree/hal/host/condvar_semaphore.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
 
@@ -48,6 +49,7 @@ Status CondVarSemaphore::Signal(uint64_t value) {
     return InvalidArgumentErrorBuilder(IREE_LOC)
            << "Semaphore values must be monotonically increasing";
   }
+  PostNotifications();
   return OkStatus();
 }
 
@@ -55,6 +57,25 @@ void CondVarSemaphore::Fail(Status status) {
   absl::MutexLock lock(&mutex_);
   status_ = std::move(status);
   value_.store(UINT64_MAX, std::memory_order_release);
+  PostNotifications();
+}
+
+void CondVarSemaphore::AddNotification(iree_notification_t* notification) {
+  absl::MutexLock lock(&mutex_);
+  notifications_.push_back(notification);
+}
+
+void CondVarSemaphore::RemoveNotification(iree_notification_t* notification) {
+  absl::MutexLock lock(&mutex_);
+  auto it =
+      std::find(notifications_.begin(), notifications_.end(), notification);
+  if (it != notifications_.end()) notifications_.erase(it);
+}
+
+void CondVarSemaphore::PostNotifications() {
+  for (auto* notification : notifications_) {
+    iree_notification_post(notification, IREE_ALL_WAITERS);
+  }
 }
 
 // static
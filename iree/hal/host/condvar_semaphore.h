@@ -19,9 +19,11 @@
 #include <cstdint>
 
 #include "absl/base/thread_annotations.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "iree/base/status.h"
+#include "iree/base/synchronization.h"
 #include "iree/hal/semaphore.h"
 
 namespace iree {
@@ -48,7 +50,18 @@ class CondVarSemaphore final : public Semaphore {
   void Fail(Status status) override;
   Status Wait(uint64_t value, Time deadline_ns) override;
 
+  // Registers |notification| to be posted each time the semaphore is signaled
+  // or failed. This allows a thread to block on a set of semaphores that
+  // changes over time (along with its own state) instead of polling them.
+  // The same notification may be added multiple times and must be removed once
+  // for each time it was added prior to being deinitialized.
+  void AddNotification(iree_notification_t* notification);
+  void RemoveNotification(iree_notification_t* notification);
+
  private:
+  // Posts all registered notifications.
+  void PostNotifications() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
   // The mutex is not required to query the value; this lets us quickly check if
   // a required value has been exceeded. The mutex is only used to update and
   // notify waiters.
@@ -58,6 +71,10 @@ class CondVarSemaphore final : public Semaphore {
   // changes.
   mutable absl::Mutex mutex_;
   Status status_ ABSL_GUARDED_BY(mutex_);
+
+  // Notifications posted on each value change.
+  absl::InlinedVector<iree_notification_t*, 2> notifications_
+      ABSL_GUARDED_BY(mutex_);
 };
 
 }  // namespace host
@@ -18,6 +18,7 @@
 #include <thread>  // NOLINT
 
 #include "iree/base/status.h"
+#include "iree/base/synchronization.h"
 #include "iree/testing/gtest.h"
 #include "iree/testing/status_matchers.h"
 
@@ -139,6 +140,29 @@ TEST(CondVarSemaphoreTest, FailNotifies) {
   ASSERT_TRUE(got_failure);
 }
 
+// Tests that registered notifications are posted when the semaphore changes.
+TEST(CondVarSemaphoreTest, NotificationWakesWaiter) {
+  iree_notification_t notification;
+  iree_notification_initialize(&notification);
+  CondVarSemaphore semaphore(0u);
+  semaphore.AddNotification(&notification);
+  std::thread thread([&]() {
+    while (true) {
+      iree_wait_token_t wait_token =
+          iree_notification_prepare_wait(&notification);
+      if (semaphore.Query().value() >= 1u) {
+        iree_notification_cancel_wait(&notification);
+        break;
+      }
+      iree_notification_commit_wait(&notification, wait_token);
+    }
+  });
+  IREE_ASSERT_OK(semaphore.Signal(1u));
+  thread.join();
+  semaphore.RemoveNotification(&notification);
+  iree_notification_deinitialize(&notification);
+}
+
 }  // namespace
 }  // namespace host
 }  // namespace hal
@@ -14,10 +14,15 @@
 
 #include "iree/hal/host/host_local_allocator.h"
 
+#include <array>
 #include <cstdlib>
+#include <cstring>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
 #include "iree/base/status.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/host/host_buffer.h"
@@ -26,9 +31,161 @@ namespace iree {
 namespace hal {
 namespace host {
 
-HostLocalAllocator::HostLocalAllocator() = default;
+namespace {
 
-HostLocalAllocator::~HostLocalAllocator() = default;
+// Smallest pooled block size (256B). Smaller allocations are rounded up.
+constexpr int kMinSizeClassLog2 = 8;
+// One free list per power-of-two up to the full 64-bit address space.
+constexpr int kSizeClassCount = 64;
+
+// Returns the log2 of the smallest pooled block that can hold |size| bytes.
+int ComputeSizeClass(size_t size) {
+  int size_class = kMinSizeClassLog2;
+  while ((static_cast<size_t>(1) << size_class) < size) ++size_class;
+  return size_class;
+}
+
+}  // namespace
+
+// Free lists of host heap blocks bucketed by power-of-two size class.
+// Referenced by the allocator and every pooled buffer so that buffers may be
+// released after the allocator has been destroyed.
+//
+// Thread-safe.
+class HostLocalAllocator::BlockPool final : public RefObject<BlockPool> {
+ public:
+  explicit BlockPool(size_t max_retained_bytes)
+      : max_retained_bytes_(max_retained_bytes) {}
+
+  ~BlockPool() { Trim(); }
+
+  size_t retained_bytes() const {
+    absl::MutexLock lock(&mutex_);
+    return retained_bytes_;
+  }
+
+  // Returns a block of 2^|size_class| bytes or nullptr if the system is out of
+  // memory. The first |zero_length| bytes of the block will be zeroed.
+  void* Acquire(int size_class, size_t zero_length) {
+    void* block = nullptr;
+    {
+      absl::MutexLock lock(&mutex_);
+      auto& free_list = free_lists_[size_class];
+      if (!free_list.empty()) {
+        block = free_list.back();
+        free_list.pop_back();
+        retained_bytes_ -= static_cast<size_t>(1) << size_class;
+      }
+    }
+    if (block) {
+      if (zero_length) std::memset(block, 0, zero_length);
+      return block;
+    }
+    IREE_TRACE_SCOPE0("HostLocalAllocator::BlockPool::AcquireNew");
+    size_t block_size = static_cast<size_t>(1) << size_class;
+    return zero_length ? std::calloc(1, block_size) : std::malloc(block_size);
+  }
+
+  // Returns |block| to the free list for |size_class|, or to the system if
+  // retaining it would exceed the pool budget.
+  void Release(void* block, int size_class) {
+    size_t block_size = static_cast<size_t>(1) << size_class;
+    {
+      absl::MutexLock lock(&mutex_);
+      if (retained_bytes_ + block_size <= max_retained_bytes_) {
+        free_lists_[size_class].push_back(block);
+        retained_bytes_ += block_size;
+        return;
+      }
+    }
+    std::free(block);
+  }
+
+  // Returns all retained blocks to the system.
+  void Trim() {
+    IREE_TRACE_SCOPE0("HostLocalAllocator::BlockPool::Trim");
+    std::array<std::vector<void*>, kSizeClassCount> free_lists;
+    {
+      absl::MutexLock lock(&mutex_);
+      std::swap(free_lists, free_lists_);
+      retained_bytes_ = 0;
+    }
+    for (auto& free_list : free_lists) {
+      for (void* block : free_list) std::free(block);
+    }
+  }
+
+ private:
+  const size_t max_retained_bytes_;
+  mutable absl::Mutex mutex_;
+  size_t retained_bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+  std::array<std::vector<void*>, kSizeClassCount> free_lists_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+// A host buffer whose storage is returned to a BlockPool upon destruction.
+class HostLocalAllocator::PooledBuffer final : public HostBuffer {
+ public:
+  PooledBuffer(Allocator* allocator, MemoryTypeBitfield memory_type,
+               BufferUsageBitfield usage, device_size_t allocation_size,
+               void* data, ref_ptr<BlockPool> block_pool, int size_class)
+      : HostBuffer(allocator, memory_type, MemoryAccess::kAll, usage,
+                   allocation_size, data, /*owns_data=*/false),
+        block_pool_(std::move(block_pool)),
+        size_class_(size_class) {}
+
+  ~PooledBuffer() override {
+    block_pool_->Release(mutable_data(), size_class_);
+  }
+
+ private:
+  ref_ptr<BlockPool> block_pool_;
+  int size_class_;
+};
+
+// A host buffer wrapping memory owned by someone else that calls a release
+// function upon destruction.
+class HostLocalAllocator::ReleasedBuffer final : public HostBuffer {
+ public:
+  ReleasedBuffer(Allocator* allocator, MemoryTypeBitfield memory_type,
+                 MemoryAccessBitfield allowed_access, BufferUsageBitfield usage,
+                 device_size_t allocation_size, void* data,
+                 std::function<void()> release_fn)
+      : HostBuffer(allocator, memory_type, allowed_access, usage,
+                   allocation_size, data, /*owns_data=*/false),
+        release_fn_(std::move(release_fn)) {}
+
+  ~ReleasedBuffer() override {
+    if (release_fn_) release_fn_();
+  }
+
+ private:
+  std::function<void()> release_fn_;
+};
+
+HostLocalAllocator::HostLocalAllocator()
+    : HostLocalAllocator(HostLocalAllocatorOptions{}) {}
+
+HostLocalAllocator::HostLocalAllocator(HostLocalAllocatorOptions options)
+    : options_(options) {
+  if (options_.enable_pooling) {
+    block_pool_ = make_ref<BlockPool>(options_.max_retained_bytes);
+  }
+}
+
+HostLocalAllocator::~HostLocalAllocator() {
+  // Live buffers keep the pool alive but there's no one left to reuse the
+  // blocks they release.
+  Trim();
+}
+
+size_t HostLocalAllocator::retained_bytes() const {
+  return block_pool_ ? block_pool_->retained_bytes() : 0;
+}
+
+void HostLocalAllocator::Trim() {
+  if (block_pool_) block_pool_->Trim();
+}
 
 bool HostLocalAllocator::CanUseBufferLike(
     Allocator* source_allocator, MemoryTypeBitfield memory_type,
@@ -95,7 +252,27 @@ StatusOr<ref_ptr<Buffer>> HostLocalAllocator::Allocate(
   // Make compatible with our requirements.
   IREE_RETURN_IF_ERROR(MakeCompatible(&memory_type, &buffer_usage));
 
-  void* malloced_data = std::calloc(1, allocation_size);
+  // Transient buffers are always fully written before being read and can skip
+  // the (potentially expensive) zero fill.
+  bool zero_fill = options_.zero_transient_buffers ||
+                   !AnyBitSet(memory_type & MemoryType::kTransient);
+
+  if (block_pool_ && allocation_size <= options_.max_pooled_allocation_size) {
+    int size_class = ComputeSizeClass(allocation_size);
+    void* block =
+        block_pool_->Acquire(size_class, zero_fill ? allocation_size : 0);
+    if (!block) {
+      return ResourceExhaustedErrorBuilder(IREE_LOC)
+             << "Failed to malloc " << (static_cast<size_t>(1) << size_class)
+             << " bytes";
+    }
+    return make_ref<PooledBuffer>(this, memory_type, buffer_usage,
+                                  allocation_size, block,
+                                  add_ref(block_pool_), size_class);
+  }
+
+  void* malloced_data = zero_fill ? std::calloc(1, allocation_size)
+                                  : std::malloc(allocation_size);
   if (!malloced_data) {
     return ResourceExhaustedErrorBuilder(IREE_LOC)
            << "Failed to malloc " << allocation_size << " bytes";
@@ -107,6 +284,35 @@ StatusOr<ref_ptr<Buffer>> HostLocalAllocator::Allocate(
   return buffer;
 }
 
+StatusOr<ref_ptr<Buffer>> HostLocalAllocator::WrapMutable(
+    MemoryTypeBitfield memory_type, MemoryAccessBitfield allowed_access,
+    BufferUsageBitfield buffer_usage, void* data, size_t data_length) {
+  return WrapMutableWithRelease(memory_type, allowed_access, buffer_usage, data,
+                                data_length, /*release_fn=*/nullptr);
+}
+
+StatusOr<ref_ptr<Buffer>> HostLocalAllocator::WrapMutableWithRelease(
+    MemoryTypeBitfield memory_type, MemoryAccessBitfield allowed_access,
+    BufferUsageBitfield buffer_usage, void* data, size_t data_length,
+    std::function<void()> release_fn) {
+  IREE_TRACE_SCOPE0("HostLocalAllocator::WrapMutableWithRelease");
+
+  if (!CanAllocate(memory_type, buffer_usage, data_length)) {
+    return FailedPreconditionErrorBuilder(IREE_LOC)
+           << "Wrapping not supported; memory_type="
+           << MemoryTypeString(memory_type)
+           << ", buffer_usage=" << BufferUsageString(buffer_usage)
+           << ", data_length=" << data_length;
+  }
+
+  // Make compatible with our requirements.
+  IREE_RETURN_IF_ERROR(MakeCompatible(&memory_type, &buffer_usage));
+
+  return make_ref<ReleasedBuffer>(this, memory_type, allowed_access,
+                                  buffer_usage, data_length, data,
+                                  std::move(release_fn));
+}
+
 }  // namespace host
 }  // namespace hal
 }  // namespace iree
@@ -16,8 +16,10 @@
 #define IREE_HAL_HOST_LOCAL_ALLOCATOR_H_
 
 #include <cstddef>
+#include <functional>
 #include <memory>
 
+#include "iree/base/ref_ptr.h"
 #include "iree/base/status.h"
 #include "iree/hal/allocator.h"
 #include "iree/hal/buffer.h"
@@ -26,6 +28,26 @@ namespace iree {
 namespace hal {
 namespace host {
 
+struct HostLocalAllocatorOptions {
+  // Pools allocations in power-of-two size classes so that buffers released
+  // back to the allocator can be reused without returning to the system heap.
+  // Each allocator (and thus each device) has its own free lists.
+  bool enable_pooling = true;
+
+  // Zero-fills buffers allocated with MemoryType::kTransient. Transient buffers
+  // are produced and consumed entirely within a single submission and are
+  // always written before they are read so zeroing them is usually wasted
+  // work. Buffers without the kTransient bit are always zero-filled.
+  bool zero_transient_buffers = false;
+
+  // Allocations larger than this bypass the pool and go directly to the heap.
+  size_t max_pooled_allocation_size = 64 * 1024 * 1024;
+
+  // Maximum total size of unused blocks retained in the free lists. Blocks
+  // released while over this limit are returned to the system immediately.
+  size_t max_retained_bytes = 256 * 1024 * 1024;
+};
+
 // An allocator implementation that allocates buffers from host memory.
 // This can be used for drivers that do not have a memory space of their own.
 //
@@ -33,11 +55,22 @@ namespace host {
 // the 'device' in the case of a host-local queue *is* the host. To keep code
 // written initially for a host-local queue working when other queues are used
 // the allocator only works with buffers that are kDeviceVisible.
+//
+// When pooling is enabled released buffer storage is retained in size-class
+// free lists and reused by subsequent allocations of the same class. Pooled
+// storage is kept alive by the buffers referencing it and as such buffers may
+// safely outlive the allocator.
 class HostLocalAllocator : public Allocator {
  public:
   HostLocalAllocator();
+  explicit HostLocalAllocator(HostLocalAllocatorOptions options);
   ~HostLocalAllocator() override;
 
+  const HostLocalAllocatorOptions& options() const { return options_; }
+
+  // Total size of unused blocks currently retained in the free lists.
+  size_t retained_bytes() const;
+
   bool CanUseBufferLike(Allocator* source_allocator,
                         MemoryTypeBitfield memory_type,
                         BufferUsageBitfield buffer_usage,
@@ -53,6 +86,29 @@ class HostLocalAllocator : public Allocator {
   StatusOr<ref_ptr<Buffer>> Allocate(MemoryTypeBitfield memory_type,
                                      BufferUsageBitfield buffer_usage,
                                      size_t allocation_size) override;
+
+  // Wraps existing host memory without copying. The buffer does not take
+  // ownership of |data| and the caller must keep it alive for as long as the
+  // buffer (and any buffer derived from it) is in use.
+  StatusOr<ref_ptr<Buffer>> WrapMutable(MemoryTypeBitfield memory_type,
+                                        MemoryAccessBitfield allowed_access,
+                                        BufferUsageBitfield buffer_usage,
+                                        void* data,
+                                        size_t data_length) override;
+  StatusOr<ref_ptr<Buffer>> WrapMutableWithRelease(
+      MemoryTypeBitfield memory_type, MemoryAccessBitfield allowed_access,
+      BufferUsageBitfield buffer_usage, void* data, size_t data_length,
+      std::function<void()> release_fn) override;
+
+  void Trim() override;
+
+ private:
+  class BlockPool;
+  class PooledBuffer;
+  class ReleasedBuffer;
+
+  HostLocalAllocatorOptions options_;
+  ref_ptr<BlockPool> block_pool_;
 };
 
 }  // namespace host
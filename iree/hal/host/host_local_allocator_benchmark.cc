@@ -0,0 +1,110 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "iree/base/api.h"
+#include "iree/base/logging.h"
+#include "iree/hal/api.h"
+#include "iree/hal/host/host_local_allocator.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+namespace {
+
+// Intermediate buffers as allocated by compiled programs (see
+// allocateTransientBuffer in the FlowToHAL stream conversion).
+constexpr iree_hal_memory_type_t kTransientMemoryType =
+    IREE_HAL_MEMORY_TYPE_TRANSIENT | IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+constexpr iree_hal_buffer_usage_t kTransientBufferUsage =
+    IREE_HAL_BUFFER_USAGE_DISPATCH | IREE_HAL_BUFFER_USAGE_TRANSFER;
+
+iree_hal_allocator_t* CreateAllocator(bool enable_pooling) {
+  HostLocalAllocatorOptions options;
+  options.enable_pooling = enable_pooling;
+  return reinterpret_cast<iree_hal_allocator_t*>(
+      new HostLocalAllocator(options));
+}
+
+// Allocates and immediately releases a single buffer of state.range(0) bytes.
+void AllocateReleaseLoop(benchmark::State& state, bool enable_pooling,
+                         iree_hal_memory_type_t memory_type) {
+  iree_hal_allocator_t* allocator = CreateAllocator(enable_pooling);
+  iree_host_size_t allocation_size = state.range(0);
+  for (auto _ : state) {
+    iree_hal_buffer_t* buffer = nullptr;
+    IREE_CHECK_OK(iree_hal_allocator_allocate_buffer(
+        allocator, memory_type, kTransientBufferUsage, allocation_size,
+        &buffer));
+    benchmark::DoNotOptimize(buffer);
+    iree_hal_buffer_release(buffer);
+  }
+  state.SetItemsProcessed(state.iterations());
+  iree_hal_allocator_release(allocator);
+}
+
+void BM_AllocateBufferHeap(benchmark::State& state) {
+  AllocateReleaseLoop(state, /*enable_pooling=*/false,
+                      IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL);
+}
+BENCHMARK(BM_AllocateBufferHeap)->Range(256, 16 * 1024 * 1024);
+
+void BM_AllocateBufferPooled(benchmark::State& state) {
+  AllocateReleaseLoop(state, /*enable_pooling=*/true,
+                      IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL);
+}
+BENCHMARK(BM_AllocateBufferPooled)->Range(256, 16 * 1024 * 1024);
+
+void BM_AllocateBufferPooledTransient(benchmark::State& state) {
+  AllocateReleaseLoop(state, /*enable_pooling=*/true, kTransientMemoryType);
+}
+BENCHMARK(BM_AllocateBufferPooledTransient)->Range(256, 16 * 1024 * 1024);
+
+// Models a single invocation: allocates state.range(0) intermediates of mixed
+// sizes, touches each, and then releases them all.
+void InvocationLoop(benchmark::State& state, bool enable_pooling) {
+  iree_hal_allocator_t* allocator = CreateAllocator(enable_pooling);
+  std::vector<iree_hal_buffer_t*> buffers(state.range(0));
+  for (auto _ : state) {
+    for (size_t i = 0; i < buffers.size(); ++i) {
+      iree_host_size_t allocation_size = (1 + i % 8) * 4096;
+      IREE_CHECK_OK(iree_hal_allocator_allocate_buffer(
+          allocator, kTransientMemoryType, kTransientBufferUsage,
+          allocation_size, &buffers[i]));
+      uint8_t pattern = 0xCD;
+      IREE_CHECK_OK(iree_hal_buffer_fill(buffers[i], 0, allocation_size,
+                                         &pattern, sizeof(pattern)));
+    }
+    for (auto* buffer : buffers) iree_hal_buffer_release(buffer);
+  }
+  state.SetItemsProcessed(state.iterations() * buffers.size());
+  iree_hal_allocator_release(allocator);
+}
+
+void BM_InvocationHeap(benchmark::State& state) {
+  InvocationLoop(state, /*enable_pooling=*/false);
+}
+BENCHMARK(BM_InvocationHeap)->Arg(16)->Arg(64);
+
+void BM_InvocationPooled(benchmark::State& state) {
+  InvocationLoop(state, /*enable_pooling=*/true);
+}
+BENCHMARK(BM_InvocationPooled)->Arg(16)->Arg(64);
+
+}  // namespace
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,192 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/host_local_allocator.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "iree/base/status.h"
+#include "iree/hal/host/host_buffer.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+namespace {
+
+using ::iree::testing::status::StatusIs;
+
+constexpr MemoryTypeBitfield kMemoryType = MemoryType::kDeviceLocal;
+const MemoryTypeBitfield kTransientMemoryType =
+    MemoryType::kTransient | MemoryType::kDeviceLocal;
+const BufferUsageBitfield kBufferUsage =
+    BufferUsage::kDispatch | BufferUsage::kTransfer;
+
+const void* GetData(Buffer* buffer) {
+  return static_cast<HostBuffer*>(buffer)->data();
+}
+
+bool IsZeroFilled(Buffer* buffer) {
+  const uint8_t* data = static_cast<const uint8_t*>(GetData(buffer));
+  for (device_size_t i = 0; i < buffer->byte_length(); ++i) {
+    if (data[i]) return false;
+  }
+  return true;
+}
+
+// Tests that released blocks are reused by allocations in the same size class.
+TEST(HostLocalAllocatorTest, PooledReuse) {
+  HostLocalAllocator allocator;
+  IREE_ASSERT_OK_AND_ASSIGN(
+      auto buffer_a, allocator.Allocate(kMemoryType, kBufferUsage, 1000));
+  EXPECT_EQ(1000u, buffer_a->byte_length());
+  const void* data_a = GetData(buffer_a.get());
+  buffer_a.reset();
+  EXPECT_EQ(1024u, allocator.retained_bytes());
+
+  // 1000 and 1010 both round up to the 1024 byte class.
+  IREE_ASSERT_OK_AND_ASSIGN(
+      auto buffer_b, allocator.Allocate(kMemoryType, kBufferUsage, 1010));
+  EXPECT_EQ(data_a, GetData(buffer_b.get()));
+  EXPECT_EQ(0u, allocator.retained_bytes());
+}
+
+// Tests that reused blocks are zeroed for non-transient buffers.
+TEST(HostLocalAllocatorTest, ZeroFillOnReuse) {
+  HostLocalAllocator allocator;
+  IREE_ASSERT_OK_AND_ASSIGN(
+      auto buffer_a, allocator.Allocate(kMemoryType, kBufferUsage, 512));
+  uint8_t pattern = 0xCD;
+  IREE_ASSERT_OK(buffer_a->Fill8(0, kWholeBuffer, pattern));
+  buffer_a.reset();
+
+  IREE_ASSERT_OK_AND_ASSIGN(
+      auto buffer_b, allocator.Allocate(kMemoryType, kBufferUsage, 512));
+  EXPECT_TRUE(IsZeroFilled(buffer_b.get()));
+}
+
+// Tests that transient buffers skip the zero fill unless requested.
+TEST(HostLocalAllocatorTest, TransientSkipsZeroFill) {
+  HostLocalAllocatorOptions options;
+  options.zero_transient_buffers = false;
+  HostLocalAllocator allocator(options);
+  IREE_ASSERT_OK_AND_ASSIGN(
+      auto buffer_a, allocator.Allocate(kMemoryType, kBufferUsage, 512));
+  uint8_t pattern = 0xCD;
+  IREE_ASSERT_OK(buffer_a->Fill8(0, kWholeBuffer, pattern));
+  buffer_a.reset();
+
+  IREE_ASSERT_OK_AND_ASSIGN(
+      auto buffer_b,
+      allocator.Allocate(kTransientMemoryType, kBufferUsage, 512));
+  EXPECT_EQ(0xCD, static_cast<const uint8_t*>(GetData(buffer_b.get()))[0]);
+}
+
+// Tests that blocks are not retained beyond the configured budget.
+TEST(HostLocalAllocatorTest, RetentionLimit) {
+  HostLocalAllocatorOptions options;
+  options.max_retained_bytes = 4096;
+  HostLocalAllocator allocator(options);
+  IREE_ASSERT_OK_AND_ASSIGN(
+      auto buffer_a, allocator.Allocate(kMemoryType, kBufferUsage, 4096));
+  IREE_ASSERT_OK_AND_ASSIGN(
+      auto buffer_b, allocator.Allocate(kMemoryType, kBufferUsage, 4096));
+  buffer_a.reset();
+  buffer_b.reset();
+  EXPECT_EQ(4096u, allocator.retained_bytes());
+}
+
+// Tests that large allocations bypass the pool entirely.
+TEST(HostLocalAllocatorTest, LargeAllocationsUnpooled) {
+  HostLocalAllocatorOptions options;
+  options.max_pooled_allocation_size = 1024;
+  HostLocalAllocator allocator(options);
+  IREE_ASSERT_OK_AND_ASSIGN(
+      auto buffer, allocator.Allocate(kMemoryType, kBufferUsage, 2048));
+  EXPECT_TRUE(IsZeroFilled(buffer.get()));
+  buffer.reset();
+  EXPECT_EQ(0u, allocator.retained_bytes());
+}
+
+// Tests that trimming releases all retained blocks.
+TEST(HostLocalAllocatorTest, Trim) {
+  HostLocalAllocator allocator;
+  for (size_t size : {256, 1024, 65536}) {
+    IREE_ASSERT_OK_AND_ASSIGN(
+        auto buffer, allocator.Allocate(kMemoryType, kBufferUsage, size));
+  }
+  EXPECT_EQ(256u + 1024u + 65536u, allocator.retained_bytes());
+  allocator.Trim();
+  EXPECT_EQ(0u, allocator.retained_bytes());
+}
+
+// Tests that buffers may be released after their allocator.
+TEST(HostLocalAllocatorTest, BufferOutlivesAllocator) {
+  ref_ptr<Buffer> buffer;
+  {
+    HostLocalAllocator allocator;
+    IREE_ASSERT_OK_AND_ASSIGN(
+        buffer, allocator.Allocate(kMemoryType, kBufferUsage, 128));
+  }
+  EXPECT_TRUE(IsZeroFilled(buffer.get()));
+  buffer.reset();
+}
+
+// Tests that wrapped memory is used in-place and not owned by the buffer.
+TEST(HostLocalAllocatorTest, WrapMutable) {
+  HostLocalAllocator allocator;
+  uint8_t data[64] = {0};
+  IREE_ASSERT_OK_AND_ASSIGN(
+      auto buffer, allocator.WrapMutable(kMemoryType, MemoryAccess::kAll,
+                                         kBufferUsage, data, sizeof(data)));
+  EXPECT_EQ(data, GetData(buffer.get()));
+  EXPECT_EQ(sizeof(data), buffer->byte_length());
+  IREE_ASSERT_OK(buffer->Fill8(0, kWholeBuffer, static_cast<uint8_t>(0xAB)));
+  EXPECT_EQ(0xAB, data[sizeof(data) - 1]);
+  buffer.reset();
+  EXPECT_EQ(0u, allocator.retained_bytes());
+}
+
+// Tests that the release function runs only once the buffer is destroyed.
+TEST(HostLocalAllocatorTest, WrapMutableWithRelease) {
+  HostLocalAllocator allocator;
+  uint8_t data[64] = {0};
+  int release_count = 0;
+  IREE_ASSERT_OK_AND_ASSIGN(
+      auto buffer, allocator.WrapMutableWithRelease(
+                       kMemoryType, MemoryAccess::kAll, kBufferUsage, data,
+                       sizeof(data), [&]() { ++release_count; }));
+  EXPECT_EQ(data, GetData(buffer.get()));
+  IREE_ASSERT_OK_AND_ASSIGN(auto subspan, Buffer::Subspan(buffer, 16, 16));
+  buffer.reset();
+  EXPECT_EQ(0, release_count);
+  subspan.reset();
+  EXPECT_EQ(1, release_count);
+}
+
+// Tests that wrapping host-only memory types is rejected.
+TEST(HostLocalAllocatorTest, WrapRequiresDeviceVisible) {
+  HostLocalAllocator allocator;
+  uint8_t data[64] = {0};
+  EXPECT_THAT(allocator.WrapMutable(MemoryType::kHostLocal, MemoryAccess::kAll,
+                                    kBufferUsage, data, sizeof(data)),
+              StatusIs(StatusCode::kFailedPrecondition));
+}
+
+}  // namespace
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
@@ -15,6 +15,7 @@
 #include "iree/hal/host/serial/serial_scheduling_model.h"
 
 #include "iree/base/tracing.h"
+#include "iree/hal/host/concurrent_command_queue.h"
 #include "iree/hal/host/condvar_semaphore.h"
 #include "iree/hal/host/inproc_command_buffer.h"
 #include "iree/hal/host/nop_event.h"
@@ -30,8 +31,8 @@ namespace {
 // A CommandQueue that performs no synchronization (semaphores/fences) and just
 // directly executes command buffers inline.
 //
-// This is meant to be wrapped by SyncCommandQueue or AsyncCommandQueue that
-// themselves perform the synchronization/threading/etc. As such we ignore
+// This is meant to be wrapped by AsyncCommandQueue or ConcurrentCommandQueue
+// that themselves perform the synchronization/threading/etc. As such we ignore
 // all semaphores in the provided batches under the assumption that if Submit is
 // being called then all dependencies are valid. The wrapping queue is also
 // responsible for signaling the fence as well as propagating errors in a way
@@ -82,15 +83,21 @@ class UnsynchronizedCommandQueue final : public CommandQueue {
 
 }  // namespace
 
-SerialSchedulingModel::SerialSchedulingModel() {
+SerialSchedulingModel::SerialSchedulingModel(int queue_worker_count) {
   // We currently only expose a single command queue.
   auto command_queue = absl::make_unique<UnsynchronizedCommandQueue>(
       "cpu0", CommandCategory::kTransfer | CommandCategory::kDispatch);
 
-  // Wrap in the simple async command queue.
-  auto async_command_queue =
-      absl::make_unique<AsyncCommandQueue>(std::move(command_queue));
-  command_queues_.push_back(std::move(async_command_queue));
+  // Wrap in the simple async command queue or, if requested, one that runs
+  // independent submissions concurrently. The unsynchronized queue has no
+  // state and is safe to submit to from multiple threads.
+  if (queue_worker_count > 1) {
+    command_queues_.push_back(absl::make_unique<ConcurrentCommandQueue>(
+        std::move(command_queue), queue_worker_count));
+  } else {
+    command_queues_.push_back(
+        absl::make_unique<AsyncCommandQueue>(std::move(command_queue)));
+  }
 }
 
 SerialSchedulingModel::~SerialSchedulingModel() = default;
@@ -28,9 +28,13 @@ namespace host {
 // core. This is a reference implementation that has no dependencies beyond
 // std::thread and allows us to quickly bring up new platforms and more easily
 // debug/profile as we won't have OS fibers/other weird constructs involved.
+//
+// When |queue_worker_count| is greater than 1 independent submissions are
+// processed concurrently on that many queue threads (see
+// ConcurrentCommandQueue).
 class SerialSchedulingModel final : public SchedulingModel {
  public:
-  SerialSchedulingModel();
+  explicit SerialSchedulingModel(int queue_worker_count = 1);
   ~SerialSchedulingModel() override;
 
   absl::Span<CommandQueue*> dispatch_queues() const override {
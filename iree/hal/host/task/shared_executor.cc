@@ -0,0 +1,87 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/task/shared_executor.h"
+
+#include <algorithm>
+
+#include "absl/base/attributes.h"
+#include "absl/flags/flag.h"
+#include "absl/synchronization/mutex.h"
+#include "iree/base/tracing.h"
+#include "iree/task/topology.h"
+#include "iree/task/tuning.h"
+
+ABSL_FLAG(bool, task_executor, true,
+          "Executes dylib and vmla dispatches on a shared multi-threaded task "
+          "executor. When disabled all work runs serially on the queue "
+          "thread.");
+ABSL_FLAG(int, task_worker_count, 0,
+          "Maximum number of task executor worker threads; 0 creates one "
+          "worker per physical core.");
+ABSL_FLAG(int, host_queue_worker_count, 1,
+          "Number of threads each dylib and vmla device queue uses to process "
+          "independent submissions concurrently; 1 processes submissions in "
+          "FIFO order.");
+
+namespace iree {
+namespace hal {
+namespace host {
+namespace {
+
+ABSL_CONST_INIT absl::Mutex shared_executor_mutex(absl::kConstInit);
+
+// NOTE: the shared executor lives for the lifetime of the process.
+iree_task_executor_t* shared_executor ABSL_GUARDED_BY(shared_executor_mutex) =
+    nullptr;
+
+}  // namespace
+
+StatusOr<iree_task_executor_t*> AcquireSharedTaskExecutor() {
+  if (!absl::GetFlag(FLAGS_task_executor)) return nullptr;
+
+  absl::MutexLock lock(&shared_executor_mutex);
+  if (!shared_executor) {
+    IREE_TRACE_SCOPE0("AcquireSharedTaskExecutor");
+    int worker_count = absl::GetFlag(FLAGS_task_worker_count);
+    if (worker_count < 0) {
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "--task_worker_count must be >= 0 (got " << worker_count
+             << ")";
+    }
+    iree_host_size_t max_core_count =
+        worker_count > 0 ? worker_count : IREE_TASK_EXECUTOR_MAX_WORKER_COUNT;
+
+    iree_allocator_t allocator = iree_allocator_system();
+    iree_task_topology_t* topology = nullptr;
+    IREE_RETURN_IF_ERROR(iree_task_topology_from_physical_cores(
+        max_core_count, allocator, &topology));
+    iree_status_t status = iree_task_executor_create(
+        IREE_TASK_SCHEDULING_MODE_RESERVED, topology, allocator,
+        &shared_executor);
+    iree_task_topology_free(topology);
+    IREE_RETURN_IF_ERROR(status);
+  }
+
+  iree_task_executor_retain(shared_executor);
+  return shared_executor;
+}
+
+int GetHostQueueWorkerCount() {
+  return std::max(1, absl::GetFlag(FLAGS_host_queue_worker_count));
+}
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
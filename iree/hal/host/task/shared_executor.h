@@ -0,0 +1,46 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_HOST_TASK_SHARED_EXECUTOR_H_
+#define IREE_HAL_HOST_TASK_SHARED_EXECUTOR_H_
+
+#include "iree/base/status.h"
+#include "iree/task/executor.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+
+// Returns the process-wide task executor shared by all host-local devices.
+// The executor is lazily created on first use as configured by the
+// --task_executor and --task_worker_count flags. Sharing one executor across
+// drivers and devices ensures we never oversubscribe the machine with more
+// worker threads than there are cores.
+//
+// The returned executor is retained and must be released by the caller with
+// iree_task_executor_release. Returns nullptr (and OK) if the task executor is
+// disabled and callers should fall back to serial scheduling.
+StatusOr<iree_task_executor_t*> AcquireSharedTaskExecutor();
+
+// Returns the number of threads each host-local device queue uses to process
+// independent submissions concurrently as configured by the
+// --host_queue_worker_count flag. A value of 1 processes submissions in FIFO
+// order on a single thread.
+int GetHostQueueWorkerCount();
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_HOST_TASK_SHARED_EXECUTOR_H_
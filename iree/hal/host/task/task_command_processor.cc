@@ -0,0 +1,536 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/task/task_command_processor.h"
+
+#include <cstring>
+
+#include "iree/base/status.h"
+#include "iree/base/tracing.h"
+#include "iree/hal/host/host_descriptor_set.h"
+#include "iree/hal/host/host_executable_layout.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+
+// Arguments for a transfer command executed as an IREE_TASK_TYPE_CALL.
+struct TaskCommandProcessor::TransferCmd {
+  enum class Type {
+    kFillBuffer,
+    kUpdateBuffer,
+    kCopyBuffer,
+  };
+  Type type;
+  TaskCommandProcessor* processor = nullptr;
+  Buffer* source_buffer = nullptr;
+  const void* source_data = nullptr;
+  device_size_t source_offset = 0;
+  Buffer* target_buffer = nullptr;
+  device_size_t target_offset = 0;
+  device_size_t length = 0;
+  uint32_t pattern = 0;
+  size_t pattern_length = 0;
+};
+
+// Arguments for a dispatch executed as an IREE_TASK_TYPE_DISPATCH.
+struct TaskCommandProcessor::DispatchCmd {
+  TaskCommandProcessor* processor = nullptr;
+  HostExecutable* executable = nullptr;
+  ref_ptr<HostExecutable::DispatchState> dispatch_state;
+
+  // Indirect dispatch parameters captured at the time of recording and used
+  // to prepare the dispatch once the workgroup count is available.
+  int32_t entry_point = 0;
+  Buffer* workgroups_buffer = nullptr;
+  device_size_t workgroups_offset = 0;
+  uint32_t workgroup_count[3] = {0, 0, 0};
+  PushConstantBlock push_constants;
+  absl::InlinedVector<absl::InlinedVector<DescriptorSet::Binding, 8>, 2>
+      descriptor_sets;
+};
+
+// Workgroup size passed to the task system; unused for scheduling as each
+// HostExecutable tile processes an entire workgroup.
+static const uint32_t kTaskWorkgroupSize[3] = {1, 1, 1};
+
+TaskCommandProcessor::TaskCommandProcessor(
+    iree_task_scope_t* scope, CommandCategoryBitfield command_categories)
+    : CommandBuffer(CommandBufferMode::kOneShot, command_categories),
+      scope_(scope) {}
+
+TaskCommandProcessor::~TaskCommandProcessor() {
+  for (auto* dispatch_cmd : dispatch_cmds_) {
+    dispatch_cmd->~DispatchCmd();
+  }
+}
+
+template <typename T>
+T* TaskCommandProcessor::AllocateTask() {
+  // Tasks require iree_max_align_t alignment while the arena only guarantees
+  // pointer alignment so we overallocate and align ourselves.
+  constexpr size_t kAlignment = alignof(T);
+  uint8_t* storage = arena_.AllocateBytes(sizeof(T) + kAlignment);
+  uintptr_t aligned_ptr = (reinterpret_cast<uintptr_t>(storage) + kAlignment -
+                           1) & ~(kAlignment - 1);
+  return new (reinterpret_cast<void*>(aligned_ptr)) T();
+}
+
+void TaskCommandProcessor::AppendToStage(iree_task_t* head_task,
+                                         iree_task_t* tail_task) {
+  stage_head_tasks_.push_back(head_task);
+  stage_tail_tasks_.push_back(tail_task);
+}
+
+void TaskCommandProcessor::LinkPreviousStage(
+    absl::Span<iree_task_t* const> head_tasks) {
+  if (previous_tail_tasks_.empty()) {
+    // First stage; heads are ready immediately upon submission.
+    root_tasks_.insert(root_tasks_.end(), head_tasks.begin(), head_tasks.end());
+    return;
+  }
+
+  if (head_tasks.size() == 1) {
+    // Fan-in directly to the single head task; no barrier indirection needed.
+    for (auto* tail_task : previous_tail_tasks_) {
+      iree_task_set_completion_task(tail_task, head_tasks[0]);
+    }
+  } else {
+    // Join the previous stage with a barrier that fans out to all heads.
+    auto dependent_tasks = arena_.AllocateSpan<iree_task_t*>(head_tasks.size());
+    std::memcpy(dependent_tasks.data(), head_tasks.data(),
+                head_tasks.size() * sizeof(iree_task_t*));
+    auto* barrier_task = AllocateTask<iree_task_barrier_t>();
+    iree_task_barrier_initialize(scope_, dependent_tasks.size(),
+                                 dependent_tasks.data(), barrier_task);
+    for (auto* tail_task : previous_tail_tasks_) {
+      iree_task_set_completion_task(tail_task, &barrier_task->header);
+    }
+  }
+  previous_tail_tasks_.clear();
+}
+
+void TaskCommandProcessor::FlushStage() {
+  if (stage_head_tasks_.empty()) return;
+  LinkPreviousStage(absl::MakeConstSpan(stage_head_tasks_));
+  previous_tail_tasks_ = std::move(stage_tail_tasks_);
+  stage_head_tasks_.clear();
+  stage_tail_tasks_.clear();
+}
+
+Status TaskCommandProcessor::Begin() {
+  IREE_TRACE_SCOPE0("TaskCommandProcessor::Begin");
+  is_recording_ = true;
+  return OkStatus();
+}
+
+Status TaskCommandProcessor::End() {
+  IREE_TRACE_SCOPE0("TaskCommandProcessor::End");
+  is_recording_ = false;
+
+  FlushStage();
+  if (previous_tail_tasks_.empty()) {
+    // No commands were recorded; nothing to submit.
+    return OkStatus();
+  }
+
+  // Terminate the DAG with a fence that notifies the scope when all tasks
+  // have retired.
+  fence_task_ = AllocateTask<iree_task_fence_t>();
+  iree_task_fence_initialize(scope_, fence_task_);
+  iree_task_t* fence_header = &fence_task_->header;
+  LinkPreviousStage(absl::MakeConstSpan(&fence_header, 1));
+  return OkStatus();
+}
+
+Status TaskCommandProcessor::ExecutionBarrier(
+    ExecutionStageBitfield source_stage_mask,
+    ExecutionStageBitfield target_stage_mask,
+    absl::Span<const MemoryBarrier> memory_barriers,
+    absl::Span<const BufferBarrier> buffer_barriers) {
+  IREE_TRACE_SCOPE0("TaskCommandProcessor::ExecutionBarrier");
+  FlushStage();
+  return OkStatus();
+}
+
+Status TaskCommandProcessor::SignalEvent(
+    Event* event, ExecutionStageBitfield source_stage_mask) {
+  IREE_TRACE_SCOPE0("TaskCommandProcessor::SignalEvent");
+  // No-op; events are treated as full barriers by WaitEvents.
+  return OkStatus();
+}
+
+Status TaskCommandProcessor::ResetEvent(
+    Event* event, ExecutionStageBitfield source_stage_mask) {
+  IREE_TRACE_SCOPE0("TaskCommandProcessor::ResetEvent");
+  // No-op; events are treated as full barriers by WaitEvents.
+  return OkStatus();
+}
+
+Status TaskCommandProcessor::WaitEvents(
+    absl::Span<Event*> events, ExecutionStageBitfield source_stage_mask,
+    ExecutionStageBitfield target_stage_mask,
+    absl::Span<const MemoryBarrier> memory_barriers,
+    absl::Span<const BufferBarrier> buffer_barriers) {
+  IREE_TRACE_SCOPE0("TaskCommandProcessor::WaitEvents");
+  // Event signal points are not tracked so waits flush the entire stage. This
+  // is conservative but always correct.
+  FlushStage();
+  return OkStatus();
+}
+
+Status TaskCommandProcessor::RecordTransfer(TransferCmd* cmd) {
+  cmd->processor = this;
+  auto* call_task = AllocateTask<iree_task_call_t>();
+  iree_task_call_initialize(
+      scope_,
+      iree_task_make_closure(&TaskCommandProcessor::ExecuteTransfer,
+                             reinterpret_cast<uintptr_t>(cmd)),
+      call_task);
+  AppendToStage(&call_task->header, &call_task->header);
+  return OkStatus();
+}
+
+// static
+iree_status_t TaskCommandProcessor::ExecuteTransfer(uintptr_t user_context,
+                                                    uintptr_t task_context) {
+  IREE_TRACE_SCOPE0("TaskCommandProcessor::ExecuteTransfer");
+  auto* cmd = reinterpret_cast<TransferCmd*>(user_context);
+  if (cmd->processor->has_failed_.load(std::memory_order_relaxed)) {
+    return iree_ok_status();
+  }
+  Status status;
+  switch (cmd->type) {
+    case TransferCmd::Type::kFillBuffer:
+      status = cmd->target_buffer->Fill(cmd->target_offset, cmd->length,
+                                        &cmd->pattern, cmd->pattern_length);
+      break;
+    case TransferCmd::Type::kUpdateBuffer:
+      status = cmd->target_buffer->WriteData(
+          cmd->target_offset,
+          static_cast<const uint8_t*>(cmd->source_data) + cmd->source_offset,
+          cmd->length);
+      break;
+    case TransferCmd::Type::kCopyBuffer:
+      status =
+          cmd->target_buffer->CopyData(cmd->target_offset, cmd->source_buffer,
+                                       cmd->source_offset, cmd->length);
+      break;
+  }
+  if (!status.ok()) return cmd->processor->FailSubmission(std::move(status));
+  return iree_ok_status();
+}
+
+Status TaskCommandProcessor::FillBuffer(Buffer* target_buffer,
+                                        device_size_t target_offset,
+                                        device_size_t length,
+                                        const void* pattern,
+                                        size_t pattern_length) {
+  IREE_TRACE_SCOPE0("TaskCommandProcessor::FillBuffer");
+  if (pattern_length > sizeof(uint32_t)) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Fill patterns must be 1, 2, or 4 bytes (got " << pattern_length
+           << ")";
+  }
+  auto* cmd = arena_.Allocate<TransferCmd>();
+  cmd->type = TransferCmd::Type::kFillBuffer;
+  cmd->target_buffer = target_buffer;
+  cmd->target_offset = target_offset;
+  cmd->length = length;
+  std::memcpy(&cmd->pattern, pattern, pattern_length);
+  cmd->pattern_length = pattern_length;
+  return RecordTransfer(cmd);
+}
+
+Status TaskCommandProcessor::DiscardBuffer(Buffer* buffer) {
+  IREE_TRACE_SCOPE0("TaskCommandProcessor::DiscardBuffer");
+  // No-op as we don't support lazily allocated buffers.
+  return OkStatus();
+}
+
+Status TaskCommandProcessor::UpdateBuffer(const void* source_buffer,
+                                          device_size_t source_offset,
+                                          Buffer* target_buffer,
+                                          device_size_t target_offset,
+                                          device_size_t length) {
+  IREE_TRACE_SCOPE0("TaskCommandProcessor::UpdateBuffer");
+  // NOTE: the source data is owned by the command buffer being processed and
+  // remains valid until the submission completes.
+  auto* cmd = arena_.Allocate<TransferCmd>();
+  cmd->type = TransferCmd::Type::kUpdateBuffer;
+  cmd->source_data = source_buffer;
+  cmd->source_offset = source_offset;
+  cmd->target_buffer = target_buffer;
+  cmd->target_offset = target_offset;
+  cmd->length = length;
+  return RecordTransfer(cmd);
+}
+
+Status TaskCommandProcessor::CopyBuffer(Buffer* source_buffer,
+                                        device_size_t source_offset,
+                                        Buffer* target_buffer,
+                                        device_size_t target_offset,
+                                        device_size_t length) {
+  IREE_TRACE_SCOPE0("TaskCommandProcessor::CopyBuffer");
+  auto* cmd = arena_.Allocate<TransferCmd>();
+  cmd->type = TransferCmd::Type::kCopyBuffer;
+  cmd->source_buffer = source_buffer;
+  cmd->source_offset = source_offset;
+  cmd->target_buffer = target_buffer;
+  cmd->target_offset = target_offset;
+  cmd->length = length;
+  return RecordTransfer(cmd);
+}
+
+Status TaskCommandProcessor::PushConstants(ExecutableLayout* executable_layout,
+                                           size_t offset,
+                                           absl::Span<const uint32_t> values) {
+  IREE_TRACE_SCOPE0("TaskCommandProcessor::PushConstants");
+  if (offset + values.size() > push_constants_.values.size()) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Push constants out of range";
+  }
+  for (int i = 0; i < values.size(); ++i) {
+    push_constants_.values[offset + i] = values[i];
+  }
+  return OkStatus();
+}
+
+Status TaskCommandProcessor::PushDescriptorSet(
+    ExecutableLayout* executable_layout, int32_t set,
+    absl::Span<const DescriptorSet::Binding> bindings) {
+  IREE_TRACE_SCOPE0("TaskCommandProcessor::PushDescriptorSet");
+  if (!AnyBitSet(command_categories() & CommandCategory::kDispatch)) {
+    return FailedPreconditionErrorBuilder(IREE_LOC)
+           << "Command processor does not support dispatch operations";
+  }
+
+  auto* host_executable_layout =
+      static_cast<HostExecutableLayout*>(executable_layout);
+  descriptor_sets_.resize(host_executable_layout->set_count());
+  if (set < 0 || set >= descriptor_sets_.size()) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Set " << set << " out of range (" << descriptor_sets_.size()
+           << ")";
+  }
+
+  auto& set_bindings = descriptor_sets_[set];
+  set_bindings.resize(bindings.size());
+  for (size_t i = 0; i < bindings.size(); ++i) {
+    set_bindings[i] = bindings[i];
+  }
+
+  return OkStatus();
+}
+
+Status TaskCommandProcessor::BindDescriptorSet(
+    ExecutableLayout* executable_layout, int32_t set,
+    DescriptorSet* descriptor_set,
+    absl::Span<const device_size_t> dynamic_offsets) {
+  IREE_TRACE_SCOPE0("TaskCommandProcessor::BindDescriptorSet");
+  if (!AnyBitSet(command_categories() & CommandCategory::kDispatch)) {
+    return FailedPreconditionErrorBuilder(IREE_LOC)
+           << "Command processor does not support dispatch operations";
+  }
+
+  auto* host_executable_layout =
+      static_cast<HostExecutableLayout*>(executable_layout);
+  descriptor_sets_.resize(host_executable_layout->set_count());
+  if (set < 0 || set >= descriptor_sets_.size()) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Set " << set << " out of range (" << descriptor_sets_.size()
+           << ")";
+  }
+
+  auto* host_descriptor_set = static_cast<HostDescriptorSet*>(descriptor_set);
+  auto* set_bindings = &descriptor_sets_[set];
+  *set_bindings = {host_descriptor_set->bindings().begin(),
+                   host_descriptor_set->bindings().end()};
+  if (!dynamic_offsets.empty()) {
+    auto dynamic_binding_map =
+        host_executable_layout->GetDynamicBindingMap(set);
+    if (dynamic_offsets.size() != dynamic_binding_map.size()) {
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "Dynamic offset count mismatch (provided "
+             << dynamic_offsets.size() << " but expected "
+             << dynamic_binding_map.size() << ")";
+    }
+    for (int i = 0; i < dynamic_binding_map.size(); ++i) {
+      (*set_bindings)[dynamic_binding_map[i]].offset += dynamic_offsets[i];
+    }
+  }
+
+  return OkStatus();
+}
+
+Status TaskCommandProcessor::Dispatch(Executable* executable,
+                                      int32_t entry_point,
+                                      std::array<uint32_t, 3> workgroups) {
+  IREE_TRACE_SCOPE0("TaskCommandProcessor::Dispatch");
+
+  HostExecutable::DispatchParams params;
+  params.entry_point = entry_point;
+  params.workgroup_count = workgroups;
+  params.push_constants = &push_constants_;
+  absl::InlinedVector<absl::Span<const DescriptorSet::Binding>, 2>
+      descriptor_sets(descriptor_sets_.size());
+  for (int i = 0; i < descriptor_sets_.size(); ++i) {
+    descriptor_sets[i] = absl::MakeConstSpan(descriptor_sets_[i]);
+  }
+  params.set_bindings = descriptor_sets;
+
+  // Prepare the dispatch now while we have the push constants and bindings
+  // available; host executables copy out everything they need.
+  auto* cmd = arena_.Allocate<DispatchCmd>();
+  dispatch_cmds_.push_back(cmd);
+  cmd->processor = this;
+  cmd->executable = static_cast<HostExecutable*>(executable);
+  IREE_ASSIGN_OR_RETURN(cmd->dispatch_state,
+                        cmd->executable->PrepareDispatch(params));
+
+  auto* dispatch_task = AllocateTask<iree_task_dispatch_t>();
+  iree_task_dispatch_initialize(
+      scope_,
+      iree_task_make_closure(&TaskCommandProcessor::ExecuteDispatchTile,
+                             reinterpret_cast<uintptr_t>(cmd)),
+      kTaskWorkgroupSize, workgroups.data(), dispatch_task);
+  AppendToStage(&dispatch_task->header, &dispatch_task->header);
+  return OkStatus();
+}
+
+Status TaskCommandProcessor::DispatchIndirect(
+    Executable* executable, int32_t entry_point, Buffer* workgroups_buffer,
+    device_size_t workgroups_offset) {
+  IREE_TRACE_SCOPE0("TaskCommandProcessor::DispatchIndirect");
+
+  // The workgroup count may be produced by earlier commands in the submission
+  // so we defer preparation until just before the dispatch is issued.
+  auto* cmd = arena_.Allocate<DispatchCmd>();
+  dispatch_cmds_.push_back(cmd);
+  cmd->processor = this;
+  cmd->executable = static_cast<HostExecutable*>(executable);
+  cmd->entry_point = entry_point;
+  cmd->workgroups_buffer = workgroups_buffer;
+  cmd->workgroups_offset = workgroups_offset;
+  cmd->push_constants = push_constants_;
+  cmd->descriptor_sets = descriptor_sets_;
+
+  auto* prepare_task = AllocateTask<iree_task_call_t>();
+  iree_task_call_initialize(
+      scope_,
+      iree_task_make_closure(&TaskCommandProcessor::PrepareIndirectDispatch,
+                             reinterpret_cast<uintptr_t>(cmd)),
+      prepare_task);
+
+  auto* dispatch_task = AllocateTask<iree_task_dispatch_t>();
+  iree_task_dispatch_initialize_indirect(
+      scope_,
+      iree_task_make_closure(&TaskCommandProcessor::ExecuteDispatchTile,
+                             reinterpret_cast<uintptr_t>(cmd)),
+      kTaskWorkgroupSize, cmd->workgroup_count, dispatch_task);
+  iree_task_set_completion_task(&prepare_task->header, &dispatch_task->header);
+
+  AppendToStage(&prepare_task->header, &dispatch_task->header);
+  return OkStatus();
+}
+
+// static
+iree_status_t TaskCommandProcessor::PrepareIndirectDispatch(
+    uintptr_t user_context, uintptr_t task_context) {
+  IREE_TRACE_SCOPE0("TaskCommandProcessor::PrepareIndirectDispatch");
+  auto* cmd = reinterpret_cast<DispatchCmd*>(user_context);
+  if (cmd->processor->has_failed_.load(std::memory_order_relaxed)) {
+    return iree_ok_status();
+  }
+
+  std::array<uint32_t, 3> workgroup_count;
+  Status status = cmd->workgroups_buffer->ReadData(
+      cmd->workgroups_offset, workgroup_count.data(), sizeof(uint32_t) * 3);
+  if (!status.ok()) return cmd->processor->FailSubmission(std::move(status));
+
+  HostExecutable::DispatchParams params;
+  params.entry_point = cmd->entry_point;
+  params.workgroup_count = workgroup_count;
+  params.push_constants = &cmd->push_constants;
+  absl::InlinedVector<absl::Span<const DescriptorSet::Binding>, 2>
+      descriptor_sets(cmd->descriptor_sets.size());
+  for (int i = 0; i < cmd->descriptor_sets.size(); ++i) {
+    descriptor_sets[i] = absl::MakeConstSpan(cmd->descriptor_sets[i]);
+  }
+  params.set_bindings = descriptor_sets;
+
+  auto dispatch_state_or = cmd->executable->PrepareDispatch(params);
+  if (!dispatch_state_or.ok()) {
+    return cmd->processor->FailSubmission(
+        std::move(dispatch_state_or).status());
+  }
+  cmd->dispatch_state = std::move(dispatch_state_or).value();
+
+  // Only publish the workgroup count once the dispatch is prepared; the
+  // dispatch task samples it after this task retires.
+  std::memcpy(cmd->workgroup_count, workgroup_count.data(),
+              sizeof(cmd->workgroup_count));
+  return iree_ok_status();
+}
+
+// static
+iree_status_t TaskCommandProcessor::ExecuteDispatchTile(
+    uintptr_t user_context, uintptr_t task_context) {
+  auto* cmd = reinterpret_cast<DispatchCmd*>(user_context);
+  if (cmd->processor->has_failed_.load(std::memory_order_relaxed)) {
+    return iree_ok_status();
+  }
+  const auto* tile_context =
+      reinterpret_cast<const iree_task_tile_context_t*>(task_context);
+  Status status = cmd->executable->DispatchTile(
+      cmd->dispatch_state.get(),
+      {tile_context->workgroup_xyz[0], tile_context->workgroup_xyz[1],
+       tile_context->workgroup_xyz[2]});
+  if (!status.ok()) return cmd->processor->FailSubmission(std::move(status));
+  return iree_ok_status();
+}
+
+iree_status_t TaskCommandProcessor::FailSubmission(Status status) {
+  // NOTE: the task system does not yet support failing tasks (#4026) so we
+  // stash the failure on the scope and let the remaining tasks retire as
+  // no-ops.
+  has_failed_.store(true, std::memory_order_relaxed);
+  iree_task_scope_fail(scope_, /*task=*/nullptr, status.release());
+  return iree_ok_status();
+}
+
+Status TaskCommandProcessor::Submit(iree_task_executor_t* executor) {
+  IREE_TRACE_SCOPE0("TaskCommandProcessor::Submit");
+  if (is_recording_) {
+    return FailedPreconditionErrorBuilder(IREE_LOC)
+           << "Command processor must end recording prior to submission";
+  }
+  if (!fence_task_) return OkStatus();
+
+  iree_task_submission_t submission;
+  iree_task_submission_initialize(&submission);
+  for (auto* root_task : root_tasks_) {
+    iree_task_submission_enqueue(&submission, root_task);
+  }
+  IREE_RETURN_IF_ERROR(iree_task_executor_submit(executor, &submission));
+  IREE_RETURN_IF_ERROR(iree_task_executor_flush(executor));
+
+  IREE_RETURN_IF_ERROR(
+      iree_task_scope_wait_idle(scope_, IREE_TIME_INFINITE_FUTURE));
+  return iree_task_scope_consume_status(scope_);
+}
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,179 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_HOST_TASK_TASK_COMMAND_PROCESSOR_H_
+#define IREE_HAL_HOST_TASK_TASK_COMMAND_PROCESSOR_H_
+
+#include <atomic>
+#include <vector>
+
+#include "absl/container/inlined_vector.h"
+#include "iree/base/arena.h"
+#include "iree/hal/command_buffer.h"
+#include "iree/hal/host/host_executable.h"
+#include "iree/task/executor.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+
+// Host-local command processor that translates commands into a DAG of
+// iree_task_t that can be executed on an iree_task_executor_t.
+//
+// Commands recorded between two execution barriers have no ordering
+// requirements and are allowed to execute concurrently. Each ExecutionBarrier
+// closes the current stage and all commands recorded after it will wait for
+// all commands in the prior stage to complete. Dispatches are issued as
+// IREE_TASK_TYPE_DISPATCH tasks so that their tiles are distributed across all
+// workers in the executor.
+//
+// All tasks and their arguments are allocated from an arena owned by the
+// processor and the processor must remain live until Submit returns.
+//
+// Thread-compatible (as with CommandBuffer itself).
+class TaskCommandProcessor final : public CommandBuffer {
+ public:
+  TaskCommandProcessor(iree_task_scope_t* scope,
+                       CommandCategoryBitfield command_categories);
+  ~TaskCommandProcessor() override;
+
+  bool is_recording() const override { return is_recording_; }
+
+  Status Begin() override;
+  Status End() override;
+
+  Status ExecutionBarrier(
+      ExecutionStageBitfield source_stage_mask,
+      ExecutionStageBitfield target_stage_mask,
+      absl::Span<const MemoryBarrier> memory_barriers,
+      absl::Span<const BufferBarrier> buffer_barriers) override;
+
+  Status SignalEvent(Event* event,
+                     ExecutionStageBitfield source_stage_mask) override;
+
+  Status ResetEvent(Event* event,
+                    ExecutionStageBitfield source_stage_mask) override;
+
+  Status WaitEvents(absl::Span<Event*> events,
+                    ExecutionStageBitfield source_stage_mask,
+                    ExecutionStageBitfield target_stage_mask,
+                    absl::Span<const MemoryBarrier> memory_barriers,
+                    absl::Span<const BufferBarrier> buffer_barriers) override;
+
+  Status FillBuffer(Buffer* target_buffer, device_size_t target_offset,
+                    device_size_t length, const void* pattern,
+                    size_t pattern_length) override;
+
+  Status DiscardBuffer(Buffer* buffer) override;
+
+  Status UpdateBuffer(const void* source_buffer, device_size_t source_offset,
+                      Buffer* target_buffer, device_size_t target_offset,
+                      device_size_t length) override;
+
+  Status CopyBuffer(Buffer* source_buffer, device_size_t source_offset,
+                    Buffer* target_buffer, device_size_t target_offset,
+                    device_size_t length) override;
+
+  Status PushConstants(ExecutableLayout* executable_layout, size_t offset,
+                       absl::Span<const uint32_t> values) override;
+
+  Status PushDescriptorSet(
+      ExecutableLayout* executable_layout, int32_t set,
+      absl::Span<const DescriptorSet::Binding> bindings) override;
+
+  Status BindDescriptorSet(
+      ExecutableLayout* executable_layout, int32_t set,
+      DescriptorSet* descriptor_set,
+      absl::Span<const device_size_t> dynamic_offsets) override;
+
+  Status Dispatch(Executable* executable, int32_t entry_point,
+                  std::array<uint32_t, 3> workgroups) override;
+
+  Status DispatchIndirect(Executable* executable, int32_t entry_point,
+                          Buffer* workgroups_buffer,
+                          device_size_t workgroups_offset) override;
+
+  // Submits the recorded task DAG to |executor| and blocks the caller until
+  // all tasks have retired. Returns the first failure of any task, if any.
+  // The processor must have ended recording prior to submission.
+  Status Submit(iree_task_executor_t* executor);
+
+ private:
+  struct TransferCmd;
+  struct DispatchCmd;
+
+  // Allocates an aligned task of type T from the arena.
+  template <typename T>
+  T* AllocateTask();
+
+  // Adds a task chain to the current stage. |head_task| will wait for the
+  // prior stage to complete and |tail_task| will be waited on by the next.
+  void AppendToStage(iree_task_t* head_task, iree_task_t* tail_task);
+
+  // Closes the current stage, if it has any tasks, such that all subsequently
+  // recorded commands wait on it.
+  void FlushStage();
+
+  // Wires up the tails of the previous stage to the given |head_tasks|.
+  void LinkPreviousStage(absl::Span<iree_task_t* const> head_tasks);
+
+  // Records a transfer operation as a call task.
+  Status RecordTransfer(TransferCmd* cmd);
+
+  static iree_status_t ExecuteTransfer(uintptr_t user_context,
+                                       uintptr_t task_context);
+  static iree_status_t PrepareIndirectDispatch(uintptr_t user_context,
+                                               uintptr_t task_context);
+  static iree_status_t ExecuteDispatchTile(uintptr_t user_context,
+                                           uintptr_t task_context);
+
+  // Records |status| as the permanent failure of the submission and returns
+  // OK so that the executor continues draining the remaining tasks.
+  iree_status_t FailSubmission(Status status);
+
+  bool is_recording_ = false;
+
+  // Scope all tasks are attributed to. Owned by the submitting queue.
+  iree_task_scope_t* scope_ = nullptr;
+
+  // Storage for all tasks and command arguments.
+  Arena arena_;
+
+  // Set after the first failure to skip executing any remaining commands.
+  std::atomic<bool> has_failed_{false};
+
+  // Root tasks from the first stage that are ready upon submission.
+  absl::InlinedVector<iree_task_t*, 8> root_tasks_;
+  // Head/tail tasks of all commands in the stage currently being recorded.
+  absl::InlinedVector<iree_task_t*, 8> stage_head_tasks_;
+  absl::InlinedVector<iree_task_t*, 8> stage_tail_tasks_;
+  // Tail tasks of the last closed stage that the next stage must wait on.
+  absl::InlinedVector<iree_task_t*, 8> previous_tail_tasks_;
+  // Fence signaled when all tasks have retired.
+  iree_task_fence_t* fence_task_ = nullptr;
+
+  // Dispatch commands that hold references to their prepared dispatch state.
+  // The arena does not run destructors so we release them explicitly.
+  std::vector<DispatchCmd*> dispatch_cmds_;
+
+  PushConstantBlock push_constants_;
+  absl::InlinedVector<absl::InlinedVector<DescriptorSet::Binding, 8>, 2>
+      descriptor_sets_;
+};
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_HOST_TASK_TASK_COMMAND_PROCESSOR_H_
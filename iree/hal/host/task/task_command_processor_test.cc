@@ -0,0 +1,120 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/task/task_command_processor.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "iree/base/status.h"
+#include "iree/hal/heap_buffer.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+namespace {
+
+class TaskCommandProcessorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    iree_task_topology_t* topology = nullptr;
+    IREE_ASSERT_OK(iree_task_topology_from_group_count(
+        /*group_count=*/4, iree_allocator_system(), &topology));
+    IREE_ASSERT_OK(iree_task_executor_create(
+        IREE_TASK_SCHEDULING_MODE_RESERVED, topology, iree_allocator_system(),
+        &executor_));
+    iree_task_topology_free(topology);
+    iree_task_scope_initialize(iree_make_cstring_view("test"), &scope_);
+  }
+
+  void TearDown() override {
+    iree_task_scope_deinitialize(&scope_);
+    iree_task_executor_release(executor_);
+  }
+
+  iree_task_executor_t* executor_ = nullptr;
+  iree_task_scope_t scope_;
+};
+
+// Tests that a processor with no commands recorded can still be submitted.
+TEST_F(TaskCommandProcessorTest, Empty) {
+  TaskCommandProcessor processor(&scope_, CommandCategory::kTransfer);
+  IREE_ASSERT_OK(processor.Begin());
+  IREE_ASSERT_OK(processor.End());
+  IREE_ASSERT_OK(processor.Submit(executor_));
+}
+
+// Tests that commands separated by barriers observe the results of the
+// commands in the prior stage.
+TEST_F(TaskCommandProcessorTest, BarrierOrdering) {
+  auto buffer_a = HeapBuffer::Allocate(
+      BufferUsage::kTransfer | BufferUsage::kMapping, 64);
+  auto buffer_b = HeapBuffer::Allocate(
+      BufferUsage::kTransfer | BufferUsage::kMapping, 64);
+  auto buffer_c = HeapBuffer::Allocate(
+      BufferUsage::kTransfer | BufferUsage::kMapping, 64);
+
+  TaskCommandProcessor processor(&scope_, CommandCategory::kTransfer);
+  IREE_ASSERT_OK(processor.Begin());
+  // Stage 0: two independent fills that may run concurrently.
+  uint8_t pattern_a = 0xAB;
+  IREE_ASSERT_OK(processor.FillBuffer(buffer_a.get(), 0, 64, &pattern_a, 1));
+  uint8_t pattern_c = 0xCD;
+  IREE_ASSERT_OK(processor.FillBuffer(buffer_c.get(), 0, 32, &pattern_c, 1));
+  IREE_ASSERT_OK(processor.ExecutionBarrier(
+      ExecutionStage::kTransfer, ExecutionStage::kTransfer, {}, {}));
+  // Stage 1: copies depending on both fills.
+  IREE_ASSERT_OK(
+      processor.CopyBuffer(buffer_a.get(), 0, buffer_b.get(), 0, 32));
+  IREE_ASSERT_OK(
+      processor.CopyBuffer(buffer_c.get(), 0, buffer_b.get(), 32, 32));
+  IREE_ASSERT_OK(processor.End());
+  IREE_ASSERT_OK(processor.Submit(executor_));
+
+  std::vector<uint8_t> actual(64);
+  IREE_ASSERT_OK(buffer_b->ReadData(0, actual.data(), actual.size()));
+  std::vector<uint8_t> expected(64);
+  std::fill(expected.begin(), expected.begin() + 32, 0xAB);
+  std::fill(expected.begin() + 32, expected.end(), 0xCD);
+  EXPECT_EQ(expected, actual);
+}
+
+// Tests that failures in any task are propagated back to the submitter.
+TEST_F(TaskCommandProcessorTest, FailurePropagation) {
+  auto buffer = HeapBuffer::Allocate(
+      BufferUsage::kTransfer | BufferUsage::kMapping, 16);
+
+  TaskCommandProcessor processor(&scope_, CommandCategory::kTransfer);
+  IREE_ASSERT_OK(processor.Begin());
+  uint32_t pattern = 0;
+  // Out of bounds of the 16 byte buffer.
+  IREE_ASSERT_OK(processor.FillBuffer(buffer.get(), 0, 1024, &pattern, 4));
+  IREE_ASSERT_OK(processor.End());
+  EXPECT_FALSE(processor.Submit(executor_).ok());
+
+  // The scope should be reusable after the failure was consumed.
+  TaskCommandProcessor next_processor(&scope_, CommandCategory::kTransfer);
+  IREE_ASSERT_OK(next_processor.Begin());
+  IREE_ASSERT_OK(next_processor.FillBuffer(buffer.get(), 0, 16, &pattern, 4));
+  IREE_ASSERT_OK(next_processor.End());
+  IREE_ASSERT_OK(next_processor.Submit(executor_));
+}
+
+}  // namespace
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
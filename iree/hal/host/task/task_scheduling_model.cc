@@ -0,0 +1,159 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/task/task_scheduling_model.h"
+
+#include "iree/base/tracing.h"
+#include "iree/hal/host/concurrent_command_queue.h"
+#include "iree/hal/host/condvar_semaphore.h"
+#include "iree/hal/host/inproc_command_buffer.h"
+#include "iree/hal/host/nop_event.h"
+#include "iree/hal/host/serial/async_command_queue.h"
+#include "iree/hal/host/task/task_command_processor.h"
+#include "iree/task/scope.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+namespace {
+
+// A CommandQueue that performs no synchronization (semaphores/fences) and
+// executes command buffers on a task executor, blocking until they complete.
+//
+// This is meant to be wrapped by AsyncCommandQueue or ConcurrentCommandQueue
+// that perform the semaphore synchronization and ordering of submissions. Each
+// command buffer is translated into a task DAG that fans out across all
+// executor workers. Submit may be called from multiple threads concurrently as
+// each call tracks completion with its own task scope.
+class TaskCommandQueue final : public CommandQueue {
+ public:
+  TaskCommandQueue(std::string name,
+                   CommandCategoryBitfield supported_categories,
+                   iree_task_executor_t* executor)
+      : CommandQueue(std::move(name), supported_categories),
+        executor_(executor) {
+    iree_task_executor_retain(executor_);
+  }
+
+  ~TaskCommandQueue() override { iree_task_executor_release(executor_); }
+
+  Status Submit(absl::Span<const SubmissionBatch> batches) override {
+    IREE_TRACE_SCOPE0("TaskCommandQueue::Submit");
+    for (auto& batch : batches) {
+      IREE_DCHECK(batch.wait_semaphores.empty() &&
+                  batch.signal_semaphores.empty())
+          << "Semaphores must be handled by the wrapping queue";
+      IREE_RETURN_IF_ERROR(ProcessCommandBuffers(batch.command_buffers));
+    }
+    return OkStatus();
+  }
+
+  Status WaitIdle(Time deadline_ns) override {
+    // No-op; Submit blocks until all tasks it issued have completed.
+    return OkStatus();
+  }
+
+ private:
+  // Processes each command buffer in-turn with a fresh processor.
+  // This ensures we don't have any state that can carry across buffers.
+  Status ProcessCommandBuffers(
+      absl::Span<CommandBuffer* const> command_buffers) {
+    IREE_TRACE_SCOPE0("TaskCommandQueue::ProcessCommandBuffers");
+    iree_task_scope_t scope;
+    iree_task_scope_initialize(
+        iree_make_string_view(name().data(), name().size()), &scope);
+    Status status;
+    for (auto* command_buffer : command_buffers) {
+      auto* inproc_command_buffer =
+          static_cast<InProcCommandBuffer*>(command_buffer->impl());
+      TaskCommandProcessor command_processor(&scope, supported_categories());
+      status = inproc_command_buffer->Process(&command_processor);
+      if (status.ok()) status = command_processor.Submit(executor_);
+      if (!status.ok()) break;
+    }
+    IREE_IGNORE_ERROR(
+        iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
+    iree_task_scope_deinitialize(&scope);
+    return status;
+  }
+
+  iree_task_executor_t* executor_ = nullptr;
+};
+
+}  // namespace
+
+TaskSchedulingModel::TaskSchedulingModel(iree_task_executor_t* executor,
+                                         int queue_worker_count)
+    : executor_(executor) {
+  iree_task_executor_retain(executor_);
+
+  // We currently only expose a single command queue.
+  auto command_queue = absl::make_unique<TaskCommandQueue>(
+      "cpu0", CommandCategory::kTransfer | CommandCategory::kDispatch,
+      executor_);
+
+  // Wrap in the simple async command queue or, if requested, one that issues
+  // independent submissions concurrently.
+  if (queue_worker_count > 1) {
+    command_queues_.push_back(absl::make_unique<ConcurrentCommandQueue>(
+        std::move(command_queue), queue_worker_count));
+  } else {
+    command_queues_.push_back(
+        absl::make_unique<AsyncCommandQueue>(std::move(command_queue)));
+  }
+}
+
+TaskSchedulingModel::~TaskSchedulingModel() {
+  // Queues must be torn down prior to releasing the executor they use.
+  command_queues_.clear();
+  iree_task_executor_release(executor_);
+}
+
+StatusOr<ref_ptr<CommandBuffer>> TaskSchedulingModel::CreateCommandBuffer(
+    CommandBufferModeBitfield mode,
+    CommandCategoryBitfield command_categories) {
+  return make_ref<InProcCommandBuffer>(mode, command_categories);
+}
+
+StatusOr<ref_ptr<Event>> TaskSchedulingModel::CreateEvent() {
+  return make_ref<NopEvent>();
+}
+
+StatusOr<ref_ptr<Semaphore>> TaskSchedulingModel::CreateSemaphore(
+    uint64_t initial_value) {
+  return make_ref<CondVarSemaphore>(initial_value);
+}
+
+Status TaskSchedulingModel::WaitAllSemaphores(
+    absl::Span<const SemaphoreValue> semaphores, Time deadline_ns) {
+  return CondVarSemaphore::WaitForSemaphores(semaphores, /*wait_all=*/true,
+                                             deadline_ns);
+}
+
+StatusOr<int> TaskSchedulingModel::WaitAnySemaphore(
+    absl::Span<const SemaphoreValue> semaphores, Time deadline_ns) {
+  return CondVarSemaphore::WaitForSemaphores(semaphores, /*wait_all=*/false,
+                                             deadline_ns);
+}
+
+Status TaskSchedulingModel::WaitIdle(Time deadline_ns) {
+  for (auto& command_queue : command_queues_) {
+    IREE_RETURN_IF_ERROR(command_queue->WaitIdle(deadline_ns));
+  }
+  return OkStatus();
+}
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
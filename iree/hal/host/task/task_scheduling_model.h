@@ -0,0 +1,78 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_HOST_TASK_TASK_SCHEDULING_MODEL_H_
+#define IREE_HAL_HOST_TASK_TASK_SCHEDULING_MODEL_H_
+
+#include "absl/container/inlined_vector.h"
+#include "iree/base/memory.h"
+#include "iree/hal/host/scheduling_model.h"
+#include "iree/task/executor.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+
+// Performs host-local scheduling by way of the iree/task/ system.
+// Submissions are processed in-order on a queue thread (as with the
+// SerialSchedulingModel) but the commands within each command buffer are
+// translated into a task DAG and executed on a shared iree_task_executor_t.
+// Dispatch workgroups are distributed across all workers in the executor and
+// commands between execution barriers may run concurrently.
+//
+// The executor may be shared across any number of devices (and drivers) in
+// the process; each submission uses its own task scope for tracking completion
+// and failures.
+class TaskSchedulingModel final : public SchedulingModel {
+ public:
+  // Creates a scheduling model that schedules work on |executor|.
+  // The executor will be retained for the lifetime of the scheduling model.
+  // When |queue_worker_count| is greater than 1 independent submissions are
+  // issued to the executor concurrently from that many queue threads.
+  explicit TaskSchedulingModel(iree_task_executor_t* executor,
+                               int queue_worker_count = 1);
+  ~TaskSchedulingModel() override;
+
+  absl::Span<CommandQueue*> dispatch_queues() const override {
+    return RawPtrSpan(absl::MakeSpan(command_queues_));
+  }
+
+  absl::Span<CommandQueue*> transfer_queues() const override {
+    return RawPtrSpan(absl::MakeSpan(command_queues_));
+  }
+
+  StatusOr<ref_ptr<CommandBuffer>> CreateCommandBuffer(
+      CommandBufferModeBitfield mode,
+      CommandCategoryBitfield command_categories) override;
+
+  StatusOr<ref_ptr<Event>> CreateEvent() override;
+
+  StatusOr<ref_ptr<Semaphore>> CreateSemaphore(uint64_t initial_value) override;
+
+  Status WaitAllSemaphores(absl::Span<const SemaphoreValue> semaphores,
+                           Time deadline_ns) override;
+  StatusOr<int> WaitAnySemaphore(absl::Span<const SemaphoreValue> semaphores,
+                                 Time deadline_ns) override;
+  Status WaitIdle(Time deadline_ns) override;
+
+ private:
+  iree_task_executor_t* executor_ = nullptr;
+  mutable absl::InlinedVector<std::unique_ptr<CommandQueue>, 4> command_queues_;
+};
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_HOST_TASK_TASK_SCHEDULING_MODEL_H_
@@ -34,11 +34,20 @@
 #ifndef IREE_HAL_VMLA_OP_KERNELS_H_
 #define IREE_HAL_VMLA_OP_KERNELS_H_
 
+#include <algorithm>
 #include <cstdint>
-
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "iree/base/status.h"
 #include "iree/base/tracing.h"
+#include "iree/hal/vmla/thread_pool.h"
 
 namespace iree {
 namespace hal {
@@ -168,10 +177,19 @@ struct Reverse {
                         absl::Span<const int32_t> dimensions);
 };
 
+// Stable argsort of each row (the innermost dimension) of |src_buffer| in
+// ascending order. Integer and float rows are radix sorted and all others are
+// merge sorted. -0.0 and 0.0 are treated as equal and NaNs order after
+// (or, when negative, before) all other values.
+//
+// VMLA dispatches run as a single workgroup so the kernel is the only place
+// the work can be split: independent rows are sorted across |thread_pool| (the
+// device pool) when there is enough work, and on the calling thread otherwise.
 struct Sort {
   template <typename T>
   static Status Execute(absl::Span<const T> src_buffer,
-                        absl::Span<int32_t> dst_buffer, ShapeSpan src_shape);
+                        absl::Span<int32_t> dst_buffer, ShapeSpan src_shape,
+                        ThreadPool* thread_pool = nullptr);
 };
 
 struct Broadcast {
@@ -388,10 +406,99 @@ struct Convert {
                         absl::Span<DST> dst_buffer);
 };
 
+// Options for the kernel runtime state of a VMLA device.
+struct RuntimeStateOptions {
+  // Maximum number of threads a single kernel invocation (such as a large
+  // matmul) may use, including the calling thread. All kernels on the device
+  // share one pool.
+  int max_thread_count = 1;
+
+  // Caches the packed form of constant GEMM operands (such as weights) so that
+  // they are only packed on first use.
+  bool enable_prepacked_cache = true;
+};
+
+// Thread-safe cache of data kernels derive from constant operands, such as
+// filters repacked into the layout a GEMM expects. Entries are keyed on the
+// owner of the constant (the executable whose rodata it lives in), its address
+// and kernel-specific parameters describing the derived form, and stay valid
+// until ReleaseOwner is called for the owner.
+class PrepackedCache {
+ public:
+  // Returns the data derived from |data| of |owner| as described by |params|,
+  // calling |pack| to produce it if not yet cached. Concurrent first uses may
+  // each pack the data but all callers receive the same entry.
+  template <typename T, typename PackFn>
+  std::shared_ptr<const std::vector<T>> GetOrPack(
+      const void* owner, const void* data, absl::Span<const int32_t> params,
+      PackFn pack) {
+    Key key{owner, data, sizeof(T), {params.begin(), params.end()}};
+    {
+      absl::MutexLock lock(&mutex_);
+      auto it = entries_.find(key);
+      if (it != entries_.end()) {
+        return std::static_pointer_cast<const std::vector<T>>(it->second);
+      }
+    }
+    auto packed = std::make_shared<std::vector<T>>();
+    pack(packed.get());
+    absl::MutexLock lock(&mutex_);
+    auto it = entries_.emplace(std::move(key), std::move(packed)).first;
+    return std::static_pointer_cast<const std::vector<T>>(it->second);
+  }
+
+  // Drops all entries of |owner|. Must be called before the constant data of
+  // |owner| is freed or reused. Entries still held by callers remain valid.
+  void ReleaseOwner(const void* owner) {
+    absl::MutexLock lock(&mutex_);
+    for (auto it = entries_.begin(); it != entries_.end();) {
+      if (it->first.owner == owner) {
+        entries_.erase(it++);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  size_t size() const {
+    absl::MutexLock lock(&mutex_);
+    return entries_.size();
+  }
+
+ private:
+  struct Key {
+    const void* owner;
+    const void* data;
+    size_t element_size;
+    absl::InlinedVector<int32_t, 8> params;
+
+    bool operator==(const Key& other) const {
+      return owner == other.owner && data == other.data &&
+             element_size == other.element_size && params == other.params;
+    }
+    template <typename H>
+    friend H AbslHashValue(H h, const Key& key) {
+      return H::combine(std::move(h), key.owner, key.data, key.element_size,
+                        key.params);
+    }
+  };
+
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<Key, std::shared_ptr<const void>> entries_
+      ABSL_GUARDED_BY(mutex_);
+};
+
 struct MatMul {
   struct RuntimeState;
 
-  static std::unique_ptr<RuntimeState> CreateRuntimeState();
+  // Creates a runtime state that splits large GEMMs across |thread_pool|.
+  static std::unique_ptr<RuntimeState> CreateRuntimeState(
+      const RuntimeStateOptions& options, ThreadPool* thread_pool);
+
+  // Drops everything cached for the constant operands of |owner|. Must be
+  // called before the storage of any constant operand of |owner| passed to
+  // Execute or Conv2DGemm::Execute is freed or reused.
+  static void ReleaseConstants(RuntimeState* runtime_state, const void* owner);
 
   template <typename T, typename ACC>
   struct Buffers {
@@ -410,6 +517,12 @@ struct MatMul {
     // for per-channel.
     absl::Span<const ACC> multiplier_mantissa_buffer;
     absl::Span<const int32_t> multiplier_exponent_buffer;
+
+    // Whether the operand contents are immutable and may have their packed
+    // form cached across calls until MatMul::ReleaseConstants is called for
+    // the executable owning them.
+    bool lhs_is_constant = false;
+    bool rhs_is_constant = false;
   };
 
   template <typename T, typename ACC>
@@ -417,9 +530,45 @@ struct MatMul {
                         const Buffers<T, ACC>& buffers);
 };
 
+// Conv2D lowered to GEMMs by unrolling input patches (im2col) and multiplying
+// them with the filter using the MatMul runtime state. Supports the same
+// strides, padding, dilations, and feature groups as Conv2D. Element types
+// without a GEMM implementation and shapes where each group reduces to a
+// single input and output channel (depthwise) use Conv2D instead.
+//
+// Unlike Conv2D the contents of |dst_buffer| are overwritten rather than
+// accumulated into. |filter_owner| is the executable owning |filter_buffer| if
+// the filter is constant, allowing packed forms of it to be cached until
+// MatMul::ReleaseConstants is called for the owner, and nullptr otherwise.
+struct Conv2DGemm {
+  template <typename T>
+  static Status Execute(MatMul::RuntimeState* runtime_state,
+                        absl::Span<const T> input_buffer, ShapeSpan input_shape,
+                        absl::Span<const T> filter_buffer,
+                        ShapeSpan filter_shape, absl::Span<T> dst_buffer,
+                        ShapeSpan dst_shape, ShapeSpan strides, ShapeSpan pad_h,
+                        ShapeSpan pad_w, ShapeSpan lhs_dilation,
+                        ShapeSpan rhs_dilation, const int32_t groups,
+                        const void* filter_owner = nullptr);
+};
+
+// Kernel runtime state shared by all executables and tiles running on a VMLA
+// device. Owns the pool of threads that kernels split large operations across.
+//
+// Thread-safe.
 struct RuntimeState {
-  std::unique_ptr<MatMul::RuntimeState> mat_mul_state =
-      MatMul::CreateRuntimeState();
+  explicit RuntimeState(const RuntimeStateOptions& options = {})
+      : thread_pool(std::max(1, options.max_thread_count) - 1),
+        mat_mul_state(MatMul::CreateRuntimeState(options, &thread_pool)) {}
+
+  // Drops everything cached for the constants of |owner|.
+  // See MatMul::ReleaseConstants.
+  void ReleaseConstants(const void* owner) {
+    MatMul::ReleaseConstants(mat_mul_state.get(), owner);
+  }
+
+  ThreadPool thread_pool;
+  std::unique_ptr<MatMul::RuntimeState> mat_mul_state;
 };
 
 struct ReduceSum {
@@ -497,6 +646,7 @@ struct PoolingMax {
 // Inconsistent automated formatting here. Just disable clang-format (for now?).
 // clang-format off
 #include "iree/hal/vmla/op_kernels_generic.h"  // IWYU pragma: export
+#include "iree/hal/vmla/op_kernels_simd.h"  // IWYU pragma: export
 #include "iree/hal/vmla/op_kernels_ruy.h"  // IWYU pragma: export
 #include "iree/hal/vmla/op_kernels_fft.h"  // IWYU pragma: export
 // clang-format on
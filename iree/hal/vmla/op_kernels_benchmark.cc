@@ -0,0 +1,334 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "iree/base/logging.h"
+#include "iree/hal/vmla/op_kernels.h"
+
+namespace iree {
+namespace hal {
+namespace vmla {
+namespace kernels {
+namespace {
+
+// A single-example NHWC convolution with an HWIO filter.
+struct ConvShape {
+  const char* name;
+  int32_t input_h, input_w, input_c;
+  int32_t kernel_h, kernel_w;
+  int32_t output_c;
+  int32_t stride;
+  int32_t pad;
+  int32_t groups;
+};
+
+// Common layers from ResNet-50 and MobileNetV2 at 224x224.
+const ConvShape kConvShapes[] = {
+    {"resnet_stem_7x7s2", 224, 224, 3, 7, 7, 64, 2, 3, 1},
+    {"resnet_3x3", 56, 56, 64, 3, 3, 64, 1, 1, 1},
+    {"resnet_3x3s2", 28, 28, 128, 3, 3, 256, 2, 1, 1},
+    {"resnet_1x1", 28, 28, 128, 1, 1, 512, 1, 0, 1},
+    {"mobilenet_1x1", 56, 56, 24, 1, 1, 144, 1, 0, 1},
+    {"mobilenet_dw_3x3", 112, 112, 32, 3, 3, 32, 1, 1, 32},
+    {"grouped_3x3", 28, 28, 128, 3, 3, 128, 1, 1, 4},
+};
+
+template <typename T>
+struct ConvBuffers {
+  explicit ConvBuffers(const ConvShape& shape) {
+    const int32_t input_group_size = shape.input_c / shape.groups;
+    const int32_t output_group_size = shape.output_c / shape.groups;
+    const int32_t output_h =
+        (shape.input_h + 2 * shape.pad - shape.kernel_h) / shape.stride + 1;
+    const int32_t output_w =
+        (shape.input_w + 2 * shape.pad - shape.kernel_w) / shape.stride + 1;
+    input_shape = {shape.input_h, shape.input_w, shape.input_c};
+    // Conv2D indexes grouped filters by the full input channel.
+    filter_shape = {shape.kernel_h, shape.kernel_w,
+                    shape.groups == 1 ? input_group_size : shape.input_c,
+                    output_group_size};
+    dst_shape = {output_h, output_w, shape.output_c};
+    strides = {shape.stride, shape.stride};
+    pad_h = {shape.pad, shape.pad};
+    pad_w = {shape.pad, shape.pad};
+    input.resize(GetElementCount(input_shape));
+    filter.resize(GetElementCount(filter_shape));
+    dst.resize(GetElementCount(dst_shape));
+    for (size_t i = 0; i < input.size(); ++i) input[i] = T(i % 7);
+    for (size_t i = 0; i < filter.size(); ++i) filter[i] = T(i % 5);
+    macs = static_cast<int64_t>(dst.size()) * shape.kernel_h *
+           shape.kernel_w * input_group_size;
+  }
+
+  std::vector<int32_t> input_shape, filter_shape, dst_shape;
+  std::vector<int32_t> strides, pad_h, pad_w;
+  std::vector<int32_t> dilation = {1, 1};
+  std::vector<T> input, filter, dst;
+  int64_t macs = 0;
+};
+
+template <typename T>
+void BM_Conv2DReference(benchmark::State& state) {
+  const ConvShape& shape = kConvShapes[state.range(0)];
+  ConvBuffers<T> buffers(shape);
+  for (auto _ : state) {
+    std::fill(buffers.dst.begin(), buffers.dst.end(), T(0));
+    IREE_CHECK_OK(Conv2D::Execute<T>(
+        buffers.input, buffers.input_shape, buffers.filter,
+        buffers.filter_shape, absl::MakeSpan(buffers.dst), buffers.dst_shape,
+        buffers.strides, buffers.pad_h, buffers.pad_w, buffers.dilation,
+        buffers.dilation, shape.groups));
+    benchmark::DoNotOptimize(buffers.dst.data());
+  }
+  state.SetLabel(shape.name);
+  state.SetItemsProcessed(state.iterations() * buffers.macs);
+}
+
+template <typename T>
+void BM_Conv2DGemm(benchmark::State& state) {
+  const ConvShape& shape = kConvShapes[state.range(0)];
+  ConvBuffers<T> buffers(shape);
+  RuntimeState runtime_state;
+  for (auto _ : state) {
+    IREE_CHECK_OK(Conv2DGemm::Execute<T>(
+        runtime_state.mat_mul_state.get(), buffers.input, buffers.input_shape,
+        buffers.filter, buffers.filter_shape, absl::MakeSpan(buffers.dst),
+        buffers.dst_shape, buffers.strides, buffers.pad_h, buffers.pad_w,
+        buffers.dilation, buffers.dilation, shape.groups));
+    benchmark::DoNotOptimize(buffers.dst.data());
+  }
+  state.SetLabel(shape.name);
+  state.SetItemsProcessed(state.iterations() * buffers.macs);
+}
+
+constexpr int kConvShapeCount = sizeof(kConvShapes) / sizeof(kConvShapes[0]);
+
+BENCHMARK_TEMPLATE(BM_Conv2DReference, float)
+    ->DenseRange(0, kConvShapeCount - 1)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Conv2DGemm, float)
+    ->DenseRange(0, kConvShapeCount - 1)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Conv2DReference, int8_t)
+    ->DenseRange(0, kConvShapeCount - 1)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Conv2DGemm, int8_t)
+    ->DenseRange(0, kConvShapeCount - 1)
+    ->Unit(benchmark::kMillisecond);
+
+// Elementwise kernels are measured in bytes read and written per second at a
+// cache-resident size and a size that streams from memory. The second argument
+// selects the SIMD instruction set used (when supported by the machine).
+void ElementwiseArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int64_t count : {int64_t{1} << 12, int64_t{1} << 22}) {
+#if defined(IREE_VMLA_SIMD_X86) || defined(IREE_VMLA_SIMD_NEON)
+    for (auto isa : {simd::Isa::kSse2, simd::Isa::kAvx2, simd::Isa::kNeon}) {
+      if (simd::IsIsaSupported(isa)) {
+        benchmark->Args({count, static_cast<int64_t>(isa)});
+      }
+    }
+#else
+    benchmark->Args({count, 0});
+#endif  // IREE_VMLA_SIMD_X86 || IREE_VMLA_SIMD_NEON
+  }
+}
+
+// Switches the kernels to the instruction set in range(1) and returns the
+// element count in range(0).
+size_t SetUpElementwise(benchmark::State& state) {
+#if defined(IREE_VMLA_SIMD_X86) || defined(IREE_VMLA_SIMD_NEON)
+  auto isa = static_cast<simd::Isa>(state.range(1));
+  simd::SetActiveIsaForTesting(isa);
+  state.SetLabel(simd::GetIsaName(isa));
+#else
+  state.SetLabel("generic");
+#endif  // IREE_VMLA_SIMD_X86 || IREE_VMLA_SIMD_NEON
+  return static_cast<size_t>(state.range(0));
+}
+
+// Positive values in [0.5, 2.5) so that all ops (including log) stay in range.
+template <typename T>
+std::vector<T> MakeElementwiseInput(size_t count, int seed) {
+  std::vector<T> v(count);
+  for (size_t i = 0; i < count; ++i) {
+    v[i] = static_cast<T>(0.5 + ((i * 31 + seed) % 64) / 32.0);
+  }
+  return v;
+}
+
+template <typename Kernel, typename T>
+void BM_ElementwiseUnary(benchmark::State& state) {
+  size_t count = SetUpElementwise(state);
+  auto src = MakeElementwiseInput<T>(count, 0);
+  std::vector<T> dst(count);
+  for (auto _ : state) {
+    IREE_CHECK_OK(Kernel::template Execute<T>(src, absl::MakeSpan(dst)));
+    benchmark::DoNotOptimize(dst.data());
+  }
+  state.SetBytesProcessed(state.iterations() * count * 2 * sizeof(T));
+}
+
+template <typename Kernel, typename T>
+void BM_ElementwiseBinary(benchmark::State& state) {
+  size_t count = SetUpElementwise(state);
+  auto lhs = MakeElementwiseInput<T>(count, 0);
+  auto rhs = MakeElementwiseInput<T>(count, 7);
+  std::vector<T> dst(count);
+  for (auto _ : state) {
+    IREE_CHECK_OK(Kernel::template Execute<T>(lhs, rhs, absl::MakeSpan(dst)));
+    benchmark::DoNotOptimize(dst.data());
+  }
+  state.SetBytesProcessed(state.iterations() * count * 3 * sizeof(T));
+}
+
+template <typename Kernel, typename T>
+void BM_ElementwiseBroadcast(benchmark::State& state) {
+  size_t count = SetUpElementwise(state);
+  auto lhs = MakeElementwiseInput<T>(count, 0);
+  std::vector<T> dst(count);
+  for (auto _ : state) {
+    IREE_CHECK_OK(Kernel::template Execute<T>(lhs, static_cast<T>(3),
+                                              absl::MakeSpan(dst)));
+    benchmark::DoNotOptimize(dst.data());
+  }
+  state.SetBytesProcessed(state.iterations() * count * 2 * sizeof(T));
+}
+
+template <typename Kernel, typename T>
+void BM_ElementwiseCompare(benchmark::State& state) {
+  size_t count = SetUpElementwise(state);
+  auto lhs = MakeElementwiseInput<T>(count, 0);
+  auto rhs = MakeElementwiseInput<T>(count, 7);
+  std::vector<uint8_t> dst(count);
+  for (auto _ : state) {
+    IREE_CHECK_OK(Kernel::template Execute<T>(lhs, rhs, absl::MakeSpan(dst)));
+    benchmark::DoNotOptimize(dst.data());
+  }
+  state.SetBytesProcessed(state.iterations() * count * (2 * sizeof(T) + 1));
+}
+
+template <typename T>
+void BM_ElementwiseSelect(benchmark::State& state) {
+  size_t count = SetUpElementwise(state);
+  auto cond = MakeElementwiseInput<uint8_t>(count, 0);
+  for (auto& value : cond) value &= 1;
+  auto lhs = MakeElementwiseInput<T>(count, 0);
+  auto rhs = MakeElementwiseInput<T>(count, 7);
+  std::vector<T> dst(count);
+  for (auto _ : state) {
+    IREE_CHECK_OK(Select::Execute<T>(cond, lhs, rhs, absl::MakeSpan(dst)));
+    benchmark::DoNotOptimize(dst.data());
+  }
+  state.SetBytesProcessed(state.iterations() * count * (3 * sizeof(T) + 1));
+}
+
+// Add<int8_t>, Mul<int32_t> and Sqrt use the generic kernels and show the
+// scalar baseline.
+BENCHMARK_TEMPLATE(BM_ElementwiseBinary, Add, float)->Apply(ElementwiseArgs);
+BENCHMARK_TEMPLATE(BM_ElementwiseBinary, Add, int32_t)->Apply(ElementwiseArgs);
+BENCHMARK_TEMPLATE(BM_ElementwiseBinary, Add, int8_t)->Apply(ElementwiseArgs);
+BENCHMARK_TEMPLATE(BM_ElementwiseBinary, Mul, float)->Apply(ElementwiseArgs);
+BENCHMARK_TEMPLATE(BM_ElementwiseBinary, Mul, int32_t)->Apply(ElementwiseArgs);
+BENCHMARK_TEMPLATE(BM_ElementwiseBinary, Div, float)->Apply(ElementwiseArgs);
+BENCHMARK_TEMPLATE(BM_ElementwiseBinary, Max, float)->Apply(ElementwiseArgs);
+BENCHMARK_TEMPLATE(BM_ElementwiseBinary, Max, int32_t)->Apply(ElementwiseArgs);
+BENCHMARK_TEMPLATE(BM_ElementwiseBinary, Xor, uint32_t)
+    ->Apply(ElementwiseArgs);
+BENCHMARK_TEMPLATE(BM_ElementwiseBroadcast, And, uint8_t)
+    ->Apply(ElementwiseArgs);
+BENCHMARK_TEMPLATE(BM_ElementwiseUnary, Abs, float)->Apply(ElementwiseArgs);
+BENCHMARK_TEMPLATE(BM_ElementwiseUnary, Exp, float)->Apply(ElementwiseArgs);
+BENCHMARK_TEMPLATE(BM_ElementwiseUnary, Log, float)->Apply(ElementwiseArgs);
+BENCHMARK_TEMPLATE(BM_ElementwiseUnary, Tanh, float)->Apply(ElementwiseArgs);
+BENCHMARK_TEMPLATE(BM_ElementwiseUnary, Sqrt, float)->Apply(ElementwiseArgs);
+BENCHMARK_TEMPLATE(BM_ElementwiseCompare, CompareLT, float)
+    ->Apply(ElementwiseArgs);
+BENCHMARK_TEMPLATE(BM_ElementwiseCompare, CompareLT, int32_t)
+    ->Apply(ElementwiseArgs);
+BENCHMARK_TEMPLATE(BM_ElementwiseSelect, uint32_t)->Apply(ElementwiseArgs);
+BENCHMARK_TEMPLATE(BM_ElementwiseSelect, uint8_t)->Apply(ElementwiseArgs);
+
+// Sorts range(0) rows of range(1) elements using up to range(2) threads.
+template <typename T>
+std::vector<T> MakeSortInput(size_t count) {
+  std::vector<T> src(count);
+  uint32_t state = 1;
+  for (auto& value : src) {
+    state = state * 1664525u + 1013904223u;
+    value = static_cast<T>(static_cast<int32_t>(state) / 65536);
+  }
+  return src;
+}
+
+// The index-indirect std::stable_sort Sort used previously, for comparison.
+template <typename T>
+void BM_SortReference(benchmark::State& state) {
+  size_t sort_size = state.range(1);
+  auto src = MakeSortInput<T>(state.range(0) * sort_size);
+  std::vector<int32_t> dst(src.size());
+  for (auto _ : state) {
+    for (size_t i = 0; i < src.size(); i += sort_size) {
+      const T* values = src.data() + i;
+      std::iota(dst.begin() + i, dst.begin() + i + sort_size, 0);
+      std::stable_sort(dst.begin() + i, dst.begin() + i + sort_size,
+                       [values](int32_t lhs, int32_t rhs) {
+                         return values[lhs] < values[rhs];
+                       });
+    }
+    benchmark::DoNotOptimize(dst.data());
+  }
+  state.SetItemsProcessed(state.iterations() * src.size());
+}
+
+template <typename T>
+void BM_Sort(benchmark::State& state) {
+  size_t sort_size = state.range(1);
+  auto src = MakeSortInput<T>(state.range(0) * sort_size);
+  std::vector<int32_t> shape = {static_cast<int32_t>(state.range(0)),
+                                static_cast<int32_t>(sort_size)};
+  std::vector<int32_t> dst(src.size());
+  ThreadPool thread_pool(static_cast<int>(state.range(2)) - 1);
+  for (auto _ : state) {
+    IREE_CHECK_OK(
+        Sort::Execute<T>(src, absl::MakeSpan(dst), shape, &thread_pool));
+    benchmark::DoNotOptimize(dst.data());
+  }
+  state.SetItemsProcessed(state.iterations() * src.size());
+}
+
+void SortArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->Args({64, 100, 1})
+      ->Args({8, 30000, 1})
+      ->Args({8, 30000, 4})
+      ->Args({1, 1000000, 1})
+      ->Unit(benchmark::kMicrosecond);
+}
+
+BENCHMARK_TEMPLATE(BM_SortReference, int32_t)->Apply(SortArgs);
+BENCHMARK_TEMPLATE(BM_Sort, int32_t)->Apply(SortArgs);
+BENCHMARK_TEMPLATE(BM_SortReference, float)->Apply(SortArgs);
+BENCHMARK_TEMPLATE(BM_Sort, float)->Apply(SortArgs);
+BENCHMARK_TEMPLATE(BM_Sort, int8_t)->Apply(SortArgs);
+BENCHMARK_TEMPLATE(BM_Sort, double)->Apply(SortArgs);
+
+}  // namespace
+}  // namespace kernels
+}  // namespace vmla
+}  // namespace hal
+}  // namespace iree
@@ -17,9 +17,12 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <iostream>
 #include <iterator>
 #include <numeric>
+#include <type_traits>
+#include <vector>
 
 #include "absl/container/flat_hash_set.h"
 #include "absl/container/inlined_vector.h"
@@ -175,9 +178,9 @@ Status Conv2D::Execute(absl::Span<const T> input_buffer, ShapeSpan input_shape,
       filter_shape[2] * filter_shape[3], filter_shape[3], 1};
   const std::array<int32_t, 3> dst_strides = {dst_shape[1] * dst_shape[2],
                                               dst_shape[2], 1};
-  // Direct 2d (grouped) convolution slow implementation. ref:
+  // Direct 2d (grouped) convolution reference implementation. ref:
   // https://www.tensorflow.org/versions/r2.0/api_docs/python/tf/nn/convolution)
-  // TODO(ataei): Implement tiled GEMM based implementation.
+  // See Conv2DGemm for the im2col+GEMM implementation used by the runtime.
   const int output_group_size = dst_shape[2] / groups;
   const int input_group_size = input_shape[2] / groups;
   for (int ho = 0; ho < dst_shape[0]; ho++) {
@@ -558,22 +561,238 @@ Status Reverse::Execute(absl::Span<const T> src_buffer,
   return OkStatus();
 }
 
+namespace impl {
+
+// Calls |fn(begin, end)| for contiguous ranges covering [0, row_count) split
+// across |thread_pool| (if any) such that each range has at least
+// |min_slice_rows| rows.
+template <typename Fn>
+void ParallelForRows(ThreadPool* thread_pool, size_t row_count,
+                     size_t min_slice_rows, const Fn& fn) {
+  const size_t slice_count =
+      thread_pool ? std::min<size_t>(thread_pool->max_concurrency(),
+                                     row_count / std::max<size_t>(
+                                                     min_slice_rows, 1))
+                  : 1;
+  if (slice_count <= 1) {
+    fn(size_t{0}, row_count);
+    return;
+  }
+  const size_t slice_rows = (row_count + slice_count - 1) / slice_count;
+  thread_pool->ParallelFor(static_cast<int>(slice_count), [&](int i) {
+    const size_t begin = i * slice_rows;
+    const size_t end = std::min(row_count, begin + slice_rows);
+    if (begin < end) fn(begin, end);
+  });
+}
+
+// Maps values to unsigned keys whose order matches the values for radix
+// sorting. Types without a mapping are merge sorted.
+template <typename T, typename Enable = void>
+struct RadixSortKey {
+  static constexpr bool kSupported = false;
+  using Key = void;
+};
+
 template <typename T>
-Status Sort::Execute(absl::Span<const T> src_buffer,
-                     absl::Span<int32_t> dst_buffer, ShapeSpan src_shape) {
-  int elements = src_buffer.size();
-  const int sort_size = src_shape.back();
-
-  for (int i = 0; i < elements; i += sort_size) {
-    auto src_subspan = src_buffer.subspan(i, sort_size);
-    auto dst_subspan = dst_buffer.subspan(i, sort_size);
-    std::iota(dst_subspan.begin(), dst_subspan.end(), 0);
-    std::stable_sort(dst_subspan.begin(), dst_subspan.end(),
-                     [&src_subspan](int32_t i1, int32_t i2) {
-                       return src_subspan[i1] < src_subspan[i2];
-                     });
+struct RadixSortKey<
+    T, typename std::enable_if<std::is_integral<T>::value &&
+                               !std::is_same<T, bool>::value &&
+                               sizeof(T) <= sizeof(uint32_t)>::type> {
+  static constexpr bool kSupported = true;
+  using Key = typename std::make_unsigned<T>::type;
+  static Key Get(T value) {
+    Key key = static_cast<Key>(value);
+    // Flip the sign bit so that negative values order first.
+    if (std::is_signed<T>::value) {
+      key ^= static_cast<Key>(Key{1} << (sizeof(Key) * 8 - 1));
+    }
+    return key;
+  }
+};
+
+template <>
+struct RadixSortKey<float> {
+  static constexpr bool kSupported = true;
+  using Key = uint32_t;
+  static Key Get(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    // -0.0 == 0.0 and must keep its position relative to 0.0.
+    if (bits == 0x80000000u) bits = 0;
+    // Flipping all bits of negative values reverses their (sign-magnitude)
+    // order and setting the sign bit of positive ones moves them after.
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+  }
+};
+
+// Rows shorter than this are merge sorted; radix sort has a fixed cost per
+// pass and digit.
+constexpr size_t kMinRadixSortSize = 256;
+
+// Minimum number of elements sorted by each slice of rows to amortize waking
+// pool threads.
+constexpr size_t kMinSortElementsPerSlice = 64 * 1024;
+
+template <typename T>
+struct SortEntry {
+  T value;
+  int32_t index;
+};
+
+// Stable bottom-up merge sort of |entries| by value using |scratch| (of the
+// same size). Returns whichever of the two holds the result.
+template <typename T>
+SortEntry<T>* MergeSortEntries(SortEntry<T>* entries, SortEntry<T>* scratch,
+                               size_t count) {
+  auto less = [](const SortEntry<T>& lhs, const SortEntry<T>& rhs) {
+    return lhs.value < rhs.value;
+  };
+  // Insertion sort short runs first; merging them is not worth it.
+  constexpr size_t kRunSize = 16;
+  for (size_t begin = 0; begin < count; begin += kRunSize) {
+    size_t end = std::min(begin + kRunSize, count);
+    for (size_t i = begin + 1; i < end; ++i) {
+      SortEntry<T> entry = entries[i];
+      size_t j = i;
+      for (; j > begin && less(entry, entries[j - 1]); --j) {
+        entries[j] = entries[j - 1];
+      }
+      entries[j] = entry;
+    }
+  }
+  SortEntry<T>* src = entries;
+  SortEntry<T>* dst = scratch;
+  for (size_t width = kRunSize; width < count; width *= 2) {
+    for (size_t begin = 0; begin < count; begin += 2 * width) {
+      size_t mid = std::min(begin + width, count);
+      size_t end = std::min(begin + 2 * width, count);
+      std::merge(src + begin, src + mid, src + mid, src + end, dst + begin,
+                 less);
+    }
+    std::swap(src, dst);
+  }
+  return src;
+}
+
+// Per-thread storage reused across the rows a thread sorts. Radix sortable
+// types are merge sorted (when short) by their keys so that both paths order
+// -0.0 and NaNs the same way.
+template <typename T>
+struct SortScratch {
+  using Key = typename std::conditional<RadixSortKey<T>::kSupported,
+                                        typename RadixSortKey<T>::Key,
+                                        T>::type;
+  std::vector<SortEntry<Key>> entries;
+  std::vector<Key> keys;
+  std::vector<int32_t> indices;
+};
+
+// Merge sorts |count| values produced by |get_value(i)|, writing the sorted
+// indices to |dst|.
+template <typename V, typename GetValue>
+void MergeSortRow(size_t count, const GetValue& get_value,
+                  absl::Span<int32_t> dst,
+                  std::vector<SortEntry<V>>* storage) {
+  storage->resize(count * 2);
+  SortEntry<V>* entries = storage->data();
+  for (size_t i = 0; i < count; ++i) {
+    entries[i] = {get_value(i), static_cast<int32_t>(i)};
+  }
+  SortEntry<V>* sorted = MergeSortEntries(entries, entries + count, count);
+  for (size_t i = 0; i < count; ++i) dst[i] = sorted[i].index;
+}
+
+template <typename T>
+void SortRow(std::false_type /*radix*/, absl::Span<const T> src,
+             absl::Span<int32_t> dst, SortScratch<T>* scratch) {
+  MergeSortRow(
+      src.size(), [&src](size_t i) { return src[i]; }, dst,
+      &scratch->entries);
+}
+
+// LSD radix sort with one 8-bit digit per pass. All digit histograms are built
+// in a single pass over the keys and passes where every key has the same digit
+// (common for small value ranges) are skipped.
+template <typename T>
+void SortRow(std::true_type /*radix*/, absl::Span<const T> src,
+             absl::Span<int32_t> dst, SortScratch<T>* scratch) {
+  using KeyTraits = RadixSortKey<T>;
+  using Key = typename KeyTraits::Key;
+  constexpr int kPassCount = sizeof(Key);
+
+  size_t count = src.size();
+  if (count < kMinRadixSortSize) {
+    MergeSortRow(
+        count, [&src](size_t i) { return KeyTraits::Get(src[i]); }, dst,
+        &scratch->entries);
+    return;
+  }
+
+  scratch->keys.resize(count * 2);
+  scratch->indices.resize(count * 2);
+  Key* keys = scratch->keys.data();
+  int32_t* indices = scratch->indices.data();
+  Key* alt_keys = keys + count;
+  int32_t* alt_indices = indices + count;
+
+  size_t histograms[kPassCount][256] = {};
+  for (size_t i = 0; i < count; ++i) {
+    Key key = KeyTraits::Get(src[i]);
+    keys[i] = key;
+    indices[i] = static_cast<int32_t>(i);
+    for (int pass = 0; pass < kPassCount; ++pass) {
+      ++histograms[pass][(key >> (pass * 8)) & 0xFF];
+    }
   }
 
+  for (int pass = 0; pass < kPassCount; ++pass) {
+    const int shift = pass * 8;
+    size_t* histogram = histograms[pass];
+    if (histogram[(keys[0] >> shift) & 0xFF] == count) continue;
+    size_t offset = 0;
+    for (int digit = 0; digit < 256; ++digit) {
+      size_t digit_count = histogram[digit];
+      histogram[digit] = offset;
+      offset += digit_count;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      size_t position = histogram[(keys[i] >> shift) & 0xFF]++;
+      alt_keys[position] = keys[i];
+      alt_indices[position] = indices[i];
+    }
+    std::swap(keys, alt_keys);
+    std::swap(indices, alt_indices);
+  }
+
+  std::memcpy(dst.data(), indices, count * sizeof(int32_t));
+}
+
+}  // namespace impl
+
+template <typename T>
+Status Sort::Execute(absl::Span<const T> src_buffer,
+                     absl::Span<int32_t> dst_buffer, ShapeSpan src_shape,
+                     ThreadPool* thread_pool) {
+  const size_t elements = src_buffer.size();
+  const size_t sort_size = src_shape.back();
+  if (elements == 0 || sort_size == 0) return OkStatus();
+  const size_t row_count = elements / sort_size;
+
+  const size_t min_slice_rows =
+      (impl::kMinSortElementsPerSlice + sort_size - 1) / sort_size;
+  impl::ParallelForRows(
+      thread_pool, row_count, min_slice_rows, [&](size_t begin, size_t end) {
+        impl::SortScratch<T> scratch;
+        for (size_t row = begin; row < end; ++row) {
+          impl::SortRow(
+              std::integral_constant<bool,
+                                     impl::RadixSortKey<T>::kSupported>(),
+              src_buffer.subspan(row * sort_size, sort_size),
+              dst_buffer.subspan(row * sort_size, sort_size), &scratch);
+        }
+      });
+
   return OkStatus();
 }
 
@@ -15,11 +15,18 @@
 #ifndef IREE_HAL_VMLA_OP_KERNELS_RUY_H_
 #define IREE_HAL_VMLA_OP_KERNELS_RUY_H_
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
 #include <type_traits>
+#include <vector>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/memory/memory.h"
+#include "absl/synchronization/mutex.h"
+#include "iree/base/api.h"
 #include "iree/base/status.h"
+#include "iree/hal/vmla/scratch_arena.h"
 #include "ruy/context.h"
 #include "ruy/mul_params.h"
 #include "ruy/ruy.h"
@@ -29,17 +36,116 @@ namespace hal {
 namespace vmla {
 namespace kernels {
 
-// TODO(benvanik): something more clever for making this shareable.
-// Maybe a factory fn based on the impl selected?
+// Large GEMMs are split into slices that run on the device thread pool. Each
+// slice borrows a single-threaded ruy context for its duration; contexts are
+// only created when all existing ones are in use so there are at most as many
+// as slices running concurrently, and they are shared by every executable on
+// the device.
+//
+// ruy caches the packed form of constant operands within each context keyed on
+// their address. Those caches cannot be evicted per executable so releasing the
+// constants of any executable bumps |constants_generation| and contexts clear
+// their cache when next borrowed. Data VMLA packs itself is kept in
+// |prepacked_cache| and released per executable.
 struct MatMul::RuntimeState {
-  // TODO(benvanik): share the thread pool but keep context per-fiber?
-  ruy::Context context;
+  struct RuyContext {
+    ruy::Context context;
+    // Value of |constants_generation| when the context cache was last cleared.
+    uint64_t constants_generation = 0;
+  };
+
+  RuntimeState(const RuntimeStateOptions& options, ThreadPool* thread_pool)
+      : thread_pool(thread_pool),
+        enable_prepacked_cache(options.enable_prepacked_cache) {}
+
+  // Borrows a context not in use by any other slice.
+  std::unique_ptr<RuyContext> AcquireContext() {
+    std::unique_ptr<RuyContext> ruy_context;
+    {
+      absl::MutexLock lock(&mutex);
+      if (!free_contexts.empty()) {
+        ruy_context = std::move(free_contexts.back());
+        free_contexts.pop_back();
+      }
+    }
+    uint64_t generation = constants_generation.load();
+    if (!ruy_context) {
+      ruy_context = absl::make_unique<RuyContext>();
+      ruy_context->context.set_max_num_threads(1);
+    } else if (ruy_context->constants_generation != generation) {
+      ruy_context->context.ClearPrepackedCache();
+    }
+    ruy_context->constants_generation = generation;
+    return ruy_context;
+  }
+
+  void ReleaseContext(std::unique_ptr<RuyContext> ruy_context) {
+    absl::MutexLock lock(&mutex);
+    free_contexts.push_back(std::move(ruy_context));
+  }
+
+  ThreadPool* const thread_pool;
+  const bool enable_prepacked_cache;
+  PrepackedCache prepacked_cache;
+  std::atomic<uint64_t> constants_generation{0};
+
+  absl::Mutex mutex;
+  std::vector<std::unique_ptr<RuyContext>> free_contexts ABSL_GUARDED_BY(mutex);
 };
 
-inline std::unique_ptr<MatMul::RuntimeState> MatMul::CreateRuntimeState() {
-  return absl::make_unique<RuntimeState>();
+inline std::unique_ptr<MatMul::RuntimeState> MatMul::CreateRuntimeState(
+    const RuntimeStateOptions& options, ThreadPool* thread_pool) {
+  return absl::make_unique<RuntimeState>(options, thread_pool);
 }
 
+inline void MatMul::ReleaseConstants(RuntimeState* runtime_state,
+                                     const void* owner) {
+  runtime_state->prepacked_cache.ReleaseOwner(owner);
+  ++runtime_state->constants_generation;
+}
+
+// Allows ruy to cache the packed form of |matrix| if it is constant.
+// ruy keys the cache on the data pointer and layout so this is only valid
+// until MatMul::ReleaseConstants is called for the owner of the data.
+template <typename T>
+void SetRuyCachePolicy(const MatMul::RuntimeState* runtime_state,
+                       bool is_constant, ruy::Matrix<T>* matrix) {
+  if (is_constant && runtime_state->enable_prepacked_cache) {
+    matrix->set_cache_policy(ruy::CachePolicy::kCacheIfLargeSpeedup);
+  }
+}
+
+namespace impl {
+
+// GEMMs are only split when each slice has at least this many rows (so that
+// packing the other operand in every slice is amortized) and this many
+// multiply-accumulates (so that the work outweighs waking pool threads).
+constexpr int kGemmMinSliceRows = 16;
+constexpr int64_t kGemmMinSliceMacs = 64 * 1024;
+
+// Splits |rows| into slices across the device thread pool and calls
+// |fn(context, row_begin, row_count)| for each with a borrowed ruy context.
+template <typename Fn>
+void RunGemmSlices(MatMul::RuntimeState* runtime_state, int rows,
+                   int64_t macs_per_row, const Fn& fn) {
+  const int slice_count = static_cast<int>(std::max<int64_t>(
+      1, std::min<int64_t>(
+             {runtime_state->thread_pool->max_concurrency(),
+              rows / kGemmMinSliceRows,
+              rows * macs_per_row / kGemmMinSliceMacs})));
+  const int slice_rows = (rows + slice_count - 1) / slice_count;
+  runtime_state->thread_pool->ParallelFor(slice_count, [&](int i) {
+    const int row_begin = i * slice_rows;
+    const int row_count = std::min(slice_rows, rows - row_begin);
+    if (row_count <= 0) return;
+    auto ruy_context = runtime_state->AcquireContext();
+    fn(&ruy_context->context, row_begin, row_count);
+    runtime_state->ReleaseContext(std::move(ruy_context));
+  });
+}
+
+}  // namespace impl
+
 // Floating-point case.
 template <typename ACC, typename T>
 struct MakeRuyMulParamsImpl {
@@ -93,29 +199,379 @@ void MakeRuyMulParams(const MatMul::Buffers<T, ACC>& buffers,
 template <typename T, typename ACC>
 Status MatMul::Execute(RuntimeState* runtime_state,
                        const Buffers<T, ACC>& buffers) {
-  ruy::Matrix<T> lhs;
-  lhs.set_data(buffers.lhs_buffer.data());
-  ruy::MakeSimpleLayout(buffers.lhs_shape[0], buffers.lhs_shape[1],
-                        ruy::Order::kRowMajor, lhs.mutable_layout());
+  // ruy computes dst[rows, cols] = lhs[rows, depth] * rhs[depth, cols] with a
+  // row-major lhs and column-major rhs and dst. Slices split the operand that
+  // is not constant so that each context packs (and caches) the constant one
+  // whole.
+  const int rows = buffers.dst_shape[1];
+  const int cols = buffers.dst_shape[0];
+  const int lhs_depth = buffers.lhs_shape[1];
+  const int rhs_depth = buffers.rhs_shape[1];
+  const bool split_cols = buffers.lhs_is_constant && !buffers.rhs_is_constant;
+  impl::RunGemmSlices(
+      runtime_state, split_cols ? cols : rows,
+      static_cast<int64_t>(lhs_depth) * (split_cols ? rows : cols),
+      [&](ruy::Context* context, int begin, int count) {
+        const int row_begin = split_cols ? 0 : begin;
+        const int row_count = split_cols ? rows : count;
+        const int col_begin = split_cols ? begin : 0;
+        const int col_count = split_cols ? count : cols;
+
+        ruy::Matrix<T> lhs;
+        lhs.set_data(buffers.lhs_buffer.data() + row_begin * lhs_depth);
+        ruy::MakeSimpleLayout(row_count, lhs_depth, ruy::Order::kRowMajor,
+                              lhs.mutable_layout());
+        SetRuyCachePolicy(runtime_state, buffers.lhs_is_constant, &lhs);
+
+        ruy::Matrix<T> rhs;
+        rhs.set_data(buffers.rhs_buffer.data() + col_begin * rhs_depth);
+        ruy::MakeSimpleLayout(rhs_depth, col_count, ruy::Order::kColMajor,
+                              rhs.mutable_layout());
+        SetRuyCachePolicy(runtime_state, buffers.rhs_is_constant, &rhs);
+
+        ruy::Matrix<T> dst;
+        dst.set_data(buffers.dst_buffer.data() + col_begin * rows +
+                     row_begin);
+        ruy::MakeSimpleLayout(row_count, col_count, ruy::Order::kColMajor,
+                              dst.mutable_layout());
+        dst.mutable_layout()->set_stride(rows);
+
+        // Bias and per-channel multipliers are per destination row.
+        Buffers<T, ACC> slice_buffers = buffers;
+        if (!slice_buffers.bias_buffer.empty()) {
+          slice_buffers.bias_buffer =
+              buffers.bias_buffer.subspan(row_begin, row_count);
+        }
+        if (slice_buffers.multiplier_mantissa_buffer.size() > 1) {
+          slice_buffers.multiplier_mantissa_buffer =
+              buffers.multiplier_mantissa_buffer.subspan(row_begin, row_count);
+          slice_buffers.multiplier_exponent_buffer =
+              buffers.multiplier_exponent_buffer.subspan(row_begin, row_count);
+        }
+        ruy::MulParams<ACC, T> mul_params;
+        MakeRuyMulParams(slice_buffers, &mul_params);
+
+        ruy::Mul(lhs, rhs, mul_params, context, &dst);
+      });
+  return OkStatus();
+}
+
+namespace impl {
+
+// Element types with a ruy GEMM path for Conv2DGemm and their accumulators.
+template <typename T>
+struct ConvGemmTraits {
+  static constexpr bool kSupported = false;
+  using AccumType = T;
+};
+template <>
+struct ConvGemmTraits<float> {
+  static constexpr bool kSupported = true;
+  using AccumType = float;
+};
+template <>
+struct ConvGemmTraits<int8_t> {
+  static constexpr bool kSupported = true;
+  using AccumType = int32_t;
+};
+
+// Maximum number of elements in the im2col patch matrix. Output rows are
+// processed in tiles so that scratch usage is independent of the image size.
+constexpr int kConvGemmMaxPatchElements = 64 * 1024;
+
+// Scratch storage for the duration of a kernel call. Allocated from the
+// scratch arena of the dispatching tile when it fits and the system allocator
+// otherwise.
+template <typename T>
+class ScratchBuffer {
+ public:
+  ScratchBuffer() = default;
+  ~ScratchBuffer() {
+    if (data_) iree_allocator_free(allocator_, data_);
+  }
+  ScratchBuffer(const ScratchBuffer&) = delete;
+  ScratchBuffer& operator=(const ScratchBuffer&) = delete;
+
+  Status Allocate(size_t count) {
+    const iree_host_size_t byte_length = count * sizeof(T);
+    allocator_ =
+        ScratchArena::AllocatorFor(byte_length, iree_allocator_system());
+    IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+        allocator_, byte_length, reinterpret_cast<void**>(&data_)));
+    return OkStatus();
+  }
+
+  T* data() const { return data_; }
+
+ private:
+  iree_allocator_t allocator_;
+  T* data_ = nullptr;
+};
+
+// dst[rows, cols] = lhs[rows, depth] * rhs[depth, cols] with all matrices
+// row-major and the given row strides. Rows are split across the device thread
+// pool.
+template <typename T, typename ACC>
+void RuyGemmRowMajor(MatMul::RuntimeState* runtime_state, int rows, int depth,
+                     int cols, const T* lhs, int lhs_stride, const T* rhs,
+                     int rhs_stride, bool rhs_is_constant, ACC* dst,
+                     int dst_stride) {
+  RunGemmSlices(
+      runtime_state, rows, static_cast<int64_t>(depth) * cols,
+      [&](ruy::Context* context, int row_begin, int row_count) {
+        ruy::Matrix<T> lhs_matrix;
+        lhs_matrix.set_data(lhs + row_begin * lhs_stride);
+        ruy::MakeSimpleLayout(row_count, depth, ruy::Order::kRowMajor,
+                              lhs_matrix.mutable_layout());
+        lhs_matrix.mutable_layout()->set_stride(lhs_stride);
 
-  ruy::Matrix<T> rhs;
-  rhs.set_data(buffers.rhs_buffer.data());
-  ruy::MakeSimpleLayout(buffers.rhs_shape[1], buffers.rhs_shape[0],
-                        ruy::Order::kColMajor, rhs.mutable_layout());
+        ruy::Matrix<T> rhs_matrix;
+        rhs_matrix.set_data(rhs);
+        ruy::MakeSimpleLayout(depth, cols, ruy::Order::kRowMajor,
+                              rhs_matrix.mutable_layout());
+        rhs_matrix.mutable_layout()->set_stride(rhs_stride);
+        SetRuyCachePolicy(runtime_state, rhs_is_constant, &rhs_matrix);
 
-  ruy::Matrix<T> dst;
-  dst.set_data(buffers.dst_buffer.data());
-  ruy::MakeSimpleLayout(buffers.dst_shape[1], buffers.dst_shape[0],
-                        ruy::Order::kColMajor, dst.mutable_layout());
+        ruy::Matrix<ACC> dst_matrix;
+        dst_matrix.set_data(dst + row_begin * dst_stride);
+        ruy::MakeSimpleLayout(row_count, cols, ruy::Order::kRowMajor,
+                              dst_matrix.mutable_layout());
+        dst_matrix.mutable_layout()->set_stride(dst_stride);
 
-  ruy::MulParams<ACC, T> mul_params;
-  MakeRuyMulParams(buffers, &mul_params);
+        ruy::MulParams<ACC, ACC> mul_params;
+
+        ruy::Mul(lhs_matrix, rhs_matrix, mul_params, context, &dst_matrix);
+      });
+}
+
+// Runs a GEMM into a destination of type T. Types narrower than their
+// accumulator are computed into |accum_scratch| (of at least rows * cols
+// elements) and then truncated, matching the wrapping behavior of the
+// reference Conv2D.
+template <typename T, typename ACC>
+struct ConvGemmToDst {
+  static constexpr bool kNeedsAccumScratch = true;
+  static void Run(MatMul::RuntimeState* runtime_state, int rows, int depth,
+                  int cols, const T* lhs, int lhs_stride, const T* rhs,
+                  int rhs_stride, bool rhs_is_constant, T* dst, int dst_stride,
+                  ACC* accum_scratch) {
+    RuyGemmRowMajor(runtime_state, rows, depth, cols, lhs, lhs_stride, rhs,
+                    rhs_stride, rhs_is_constant, accum_scratch, cols);
+    for (int i = 0; i < rows; ++i) {
+      const ACC* accum_row = accum_scratch + i * cols;
+      T* dst_row = dst + i * dst_stride;
+      for (int j = 0; j < cols; ++j) {
+        dst_row[j] = static_cast<T>(accum_row[j]);
+      }
+    }
+  }
+};
+template <typename T>
+struct ConvGemmToDst<T, T> {
+  static constexpr bool kNeedsAccumScratch = false;
+  static void Run(MatMul::RuntimeState* runtime_state, int rows, int depth,
+                  int cols, const T* lhs, int lhs_stride, const T* rhs,
+                  int rhs_stride, bool rhs_is_constant, T* dst, int dst_stride,
+                  T* accum_scratch) {
+    RuyGemmRowMajor(runtime_state, rows, depth, cols, lhs, lhs_stride, rhs,
+                    rhs_stride, rhs_is_constant, dst, dst_stride);
+  }
+};
+
+// Types without a GEMM path use the reference implementation.
+template <typename T>
+Status Conv2DGemmImpl(std::false_type, MatMul::RuntimeState* runtime_state,
+                      absl::Span<const T> input_buffer, ShapeSpan input_shape,
+                      absl::Span<const T> filter_buffer, ShapeSpan filter_shape,
+                      absl::Span<T> dst_buffer, ShapeSpan dst_shape,
+                      ShapeSpan strides, ShapeSpan pad_h, ShapeSpan pad_w,
+                      ShapeSpan lhs_dilation, ShapeSpan rhs_dilation,
+                      const int32_t groups, const void* filter_owner) {
+  std::fill(dst_buffer.begin(), dst_buffer.end(), T(0));
+  return Conv2D::Execute<T>(input_buffer, input_shape, filter_buffer,
+                            filter_shape, dst_buffer, dst_shape, strides, pad_h,
+                            pad_w, lhs_dilation, rhs_dilation, groups);
+}
+
+template <typename T>
+Status Conv2DGemmImpl(std::true_type, MatMul::RuntimeState* runtime_state,
+                      absl::Span<const T> input_buffer, ShapeSpan input_shape,
+                      absl::Span<const T> filter_buffer, ShapeSpan filter_shape,
+                      absl::Span<T> dst_buffer, ShapeSpan dst_shape,
+                      ShapeSpan strides, ShapeSpan pad_h, ShapeSpan pad_w,
+                      ShapeSpan lhs_dilation, ShapeSpan rhs_dilation,
+                      const int32_t groups, const void* filter_owner) {
+  using ACC = typename ConvGemmTraits<T>::AccumType;
 
-  ruy::Mul(lhs, rhs, mul_params, &runtime_state->context, &dst);
+  const int input_h = input_shape[0];
+  const int input_w = input_shape[1];
+  const int input_c = input_shape[2];
+  const int kernel_h = filter_shape[0];
+  const int kernel_w = filter_shape[1];
+  const int dst_h = dst_shape[0];
+  const int dst_w = dst_shape[1];
+  const int dst_c = dst_shape[2];
+  const int input_group_size = input_c / groups;
+  const int output_group_size = dst_c / groups;
 
+  // Depthwise convolutions would turn into a GEMV per group and are faster
+  // computed directly.
+  if (input_group_size == 1 && output_group_size == 1) {
+    return Conv2DGemmImpl<T>(std::false_type{}, runtime_state, input_buffer,
+                             input_shape, filter_buffer, filter_shape,
+                             dst_buffer, dst_shape, strides, pad_h, pad_w,
+                             lhs_dilation, rhs_dilation, groups,
+                             filter_owner);
+  }
+
+  // Same filter indexing as the reference Conv2D.
+  const int filter_stride_h =
+      filter_shape[1] * filter_shape[2] * filter_shape[3];
+  const int filter_stride_w = filter_shape[2] * filter_shape[3];
+  const int filter_stride_c = filter_shape[3];
+
+  // Each group multiplies its [rows, group_depth] patch columns with a
+  // [group_depth, output_group_size] filter matrix whose rows are ordered
+  // (kh, kw, ci). A plain HWIO filter is already in this form; otherwise the
+  // per-group matrices are packed out of the filter.
+  const int rows = dst_h * dst_w;
+  const int group_depth = kernel_h * kernel_w * input_group_size;
+  const int depth = group_depth * groups;
+  const T* filter_data = filter_buffer.data();
+  int filter_row_stride = filter_stride_c;
+  int filter_group_stride = 0;
+  bool filter_is_constant = filter_owner != nullptr;
+  std::shared_ptr<const std::vector<T>> packed_filter;
+  if (groups != 1 || filter_shape[2] != input_c) {
+    auto pack_filter = [&](std::vector<T>* packed) {
+      packed->resize(groups * group_depth * output_group_size);
+      T* packed_row = packed->data();
+      for (int g = 0; g < groups; ++g) {
+        for (int kh = 0; kh < kernel_h; ++kh) {
+          for (int kw = 0; kw < kernel_w; ++kw) {
+            for (int ci = 0; ci < input_group_size; ++ci) {
+              const T* filter_row =
+                  filter_data + kh * filter_stride_h + kw * filter_stride_w +
+                  (g * input_group_size + ci) * filter_stride_c;
+              std::copy_n(filter_row, output_group_size, packed_row);
+              packed_row += output_group_size;
+            }
+          }
+        }
+      }
+    };
+    // Constant filters are packed once and kept until their executable is
+    // released, which also lets ruy cache the packed copy. Others are packed
+    // into a transient copy that must not be cached.
+    filter_is_constant =
+        filter_is_constant && runtime_state->enable_prepacked_cache;
+    if (filter_is_constant) {
+      const int32_t pack_params[] = {filter_shape[0], filter_shape[1],
+                                     filter_shape[2], filter_shape[3], input_c,
+                                     groups};
+      packed_filter = runtime_state->prepacked_cache.GetOrPack<T>(
+          filter_owner, filter_data, pack_params, pack_filter);
+    } else {
+      auto transient_filter = std::make_shared<std::vector<T>>();
+      pack_filter(transient_filter.get());
+      packed_filter = std::move(transient_filter);
+    }
+    filter_data = packed_filter->data();
+    filter_row_stride = output_group_size;
+    filter_group_stride = group_depth * output_group_size;
+  }
+
+  // 1x1 unit-stride convolutions are a GEMM directly on the input.
+  const bool is_pointwise =
+      kernel_h == 1 && kernel_w == 1 && groups == 1 && strides[0] == 1 &&
+      strides[1] == 1 && pad_h[0] == 0 && pad_w[0] == 0 &&
+      lhs_dilation[0] == 1 && lhs_dilation[1] == 1 && dst_h == input_h &&
+      dst_w == input_w;
+  ScratchBuffer<ACC> accum_scratch;
+  if (is_pointwise) {
+    if (ConvGemmToDst<T, ACC>::kNeedsAccumScratch) {
+      IREE_RETURN_IF_ERROR(accum_scratch.Allocate(rows * dst_c));
+    }
+    ConvGemmToDst<T, ACC>::Run(runtime_state, rows, input_c, dst_c,
+                               input_buffer.data(), input_c, filter_data,
+                               filter_row_stride, filter_is_constant,
+                               dst_buffer.data(), dst_c, accum_scratch.data());
+    return OkStatus();
+  }
+
+  const int tile_rows =
+      std::max(1, std::min(rows, kConvGemmMaxPatchElements / depth));
+  ScratchBuffer<T> patches;
+  IREE_RETURN_IF_ERROR(patches.Allocate(tile_rows * depth));
+  if (ConvGemmToDst<T, ACC>::kNeedsAccumScratch) {
+    IREE_RETURN_IF_ERROR(
+        accum_scratch.Allocate(tile_rows * output_group_size));
+  }
+  for (int row_begin = 0; row_begin < rows; row_begin += tile_rows) {
+    const int row_count = std::min(tile_rows, rows - row_begin);
+
+    // Unroll the input windows for this tile of output pixels into rows of
+    // patches with columns ordered (g, kh, kw, ci).
+    for (int r = 0; r < row_count; ++r) {
+      const int ho = (row_begin + r) / dst_w;
+      const int wo = (row_begin + r) % dst_w;
+      T* patch = patches.data() + r * depth;
+      for (int g = 0; g < groups; ++g) {
+        for (int kh = 0; kh < kernel_h; ++kh) {
+          int ih = ho * strides[0] + kh * rhs_dilation[0] - pad_h[0];
+          bool is_valid_h = ih >= 0 && ih % lhs_dilation[0] == 0;
+          ih /= lhs_dilation[0];
+          is_valid_h = is_valid_h && ih < input_h;
+          for (int kw = 0; kw < kernel_w; ++kw) {
+            int iw = wo * strides[1] + kw * rhs_dilation[1] - pad_w[0];
+            bool is_valid_w = iw >= 0 && iw % lhs_dilation[1] == 0;
+            iw /= lhs_dilation[1];
+            is_valid_w = is_valid_w && iw < input_w;
+            if (is_valid_h && is_valid_w) {
+              std::copy_n(input_buffer.data() + (ih * input_w + iw) * input_c +
+                              g * input_group_size,
+                          input_group_size, patch);
+            } else {
+              std::fill_n(patch, input_group_size, T(0));
+            }
+            patch += input_group_size;
+          }
+        }
+      }
+    }
+
+    for (int g = 0; g < groups; ++g) {
+      ConvGemmToDst<T, ACC>::Run(
+          runtime_state, row_count, group_depth, output_group_size,
+          patches.data() + g * group_depth, depth,
+          filter_data + g * filter_group_stride, filter_row_stride,
+          filter_is_constant,
+          dst_buffer.data() + row_begin * dst_c + g * output_group_size, dst_c,
+          accum_scratch.data());
+    }
+  }
   return OkStatus();
 }
 
+}  // namespace impl
+
+template <typename T>
+Status Conv2DGemm::Execute(MatMul::RuntimeState* runtime_state,
+                           absl::Span<const T> input_buffer,
+                           ShapeSpan input_shape,
+                           absl::Span<const T> filter_buffer,
+                           ShapeSpan filter_shape, absl::Span<T> dst_buffer,
+                           ShapeSpan dst_shape, ShapeSpan strides,
+                           ShapeSpan pad_h, ShapeSpan pad_w,
+                           ShapeSpan lhs_dilation, ShapeSpan rhs_dilation,
+                           const int32_t groups, const void* filter_owner) {
+  return impl::Conv2DGemmImpl<T>(
+      std::integral_constant<bool, impl::ConvGemmTraits<T>::kSupported>{},
+      runtime_state, input_buffer, input_shape, filter_buffer, filter_shape,
+      dst_buffer, dst_shape, strides, pad_h, pad_w, lhs_dilation, rhs_dilation,
+      groups, filter_owner);
+}
+
 }  // namespace kernels
 }  // namespace vmla
 }  // namespace hal
@@ -0,0 +1,619 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// SIMD variants of the elementwise kernels in op_kernels_generic.h.
+//
+// The loops and math live in op_kernels_simd_impl.h, which is included once
+// per instruction set with |V| aliased to a small traits struct wrapping that
+// instruction set's intrinsics. The kernels below specialize the generic
+// templates for the common types and dispatch to the best instruction set
+// supported by the CPU at runtime:
+//   x86-64:  SSE2 (baseline) and AVX2+FMA (when supported by the compiler)
+//   aarch64: NEON
+// Other architectures (and IREE_VMLA_SIMD_DISABLE builds) use the generic
+// kernels.
+//
+// Integer, bitwise, comparison and min/max results are bit-exact with the
+// generic kernels. Exp, Log and Tanh use polynomial approximations accurate to
+// a few ULP that handle infinities, NaNs and denormals like std::.
+
+#ifndef IREE_HAL_VMLA_OP_KERNELS_SIMD_H_
+#define IREE_HAL_VMLA_OP_KERNELS_SIMD_H_
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include "absl/types/span.h"
+#include "iree/base/status.h"
+#include "iree/base/target_platform.h"
+
+#if !defined(IREE_VMLA_SIMD_DISABLE)
+#if defined(IREE_ARCH_X86_64)
+#define IREE_VMLA_SIMD_X86 1
+#if defined(__GNUC__) || defined(__clang__) || defined(__AVX2__)
+#define IREE_VMLA_SIMD_AVX2 1
+#endif  // __GNUC__ || __clang__ || __AVX2__
+#elif defined(IREE_ARCH_ARM_64)
+#define IREE_VMLA_SIMD_NEON 1
+#endif  // IREE_ARCH_*
+#endif  // !IREE_VMLA_SIMD_DISABLE
+
+#if defined(IREE_VMLA_SIMD_X86)
+#include <emmintrin.h>
+#if defined(IREE_VMLA_SIMD_AVX2)
+#include <immintrin.h>
+#endif  // IREE_VMLA_SIMD_AVX2
+#elif defined(IREE_VMLA_SIMD_NEON)
+#include <arm_neon.h>
+#endif  // IREE_VMLA_SIMD_*
+
+#if defined(IREE_VMLA_SIMD_X86) || defined(IREE_VMLA_SIMD_NEON)
+
+namespace iree {
+namespace hal {
+namespace vmla {
+namespace kernels {
+namespace simd {
+
+enum class Isa {
+  kSse2,
+  kAvx2,
+  kNeon,
+};
+
+inline const char* GetIsaName(Isa isa) {
+  switch (isa) {
+    case Isa::kSse2:
+      return "sse2";
+    case Isa::kAvx2:
+      return "avx2";
+    case Isa::kNeon:
+      return "neon";
+  }
+  return "unknown";
+}
+
+// Returns true if kernels for |isa| are compiled in and the CPU supports them.
+inline bool IsIsaSupported(Isa isa) {
+  switch (isa) {
+#if defined(IREE_VMLA_SIMD_X86)
+    case Isa::kSse2:
+      return true;
+    case Isa::kAvx2:
+#if !defined(IREE_VMLA_SIMD_AVX2)
+      return false;
+#elif defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+      return true;
+#else
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif  // IREE_VMLA_SIMD_AVX2
+#elif defined(IREE_VMLA_SIMD_NEON)
+    case Isa::kNeon:
+      return true;
+#endif  // IREE_VMLA_SIMD_*
+    default:
+      return false;
+  }
+}
+
+inline Isa DetectIsa() {
+#if defined(IREE_VMLA_SIMD_X86)
+  return IsIsaSupported(Isa::kAvx2) ? Isa::kAvx2 : Isa::kSse2;
+#else
+  return Isa::kNeon;
+#endif  // IREE_VMLA_SIMD_X86
+}
+
+inline std::atomic<Isa>& ActiveIsaStorage() {
+  static std::atomic<Isa> isa{DetectIsa()};
+  return isa;
+}
+
+// Returns the instruction set the kernels dispatch to.
+inline Isa GetActiveIsa() {
+  return ActiveIsaStorage().load(std::memory_order_relaxed);
+}
+
+// Overrides the detected instruction set. |isa| must be supported.
+// Only for tests and benchmarks comparing implementations; kernels running
+// concurrently may use either instruction set while it changes.
+inline void SetActiveIsaForTesting(Isa isa) {
+  ActiveIsaStorage().store(isa, std::memory_order_relaxed);
+}
+
+//===----------------------------------------------------------------------===//
+// SSE2
+//===----------------------------------------------------------------------===//
+
+#if defined(IREE_VMLA_SIMD_X86)
+
+struct Sse2Traits {
+  static constexpr int kLanes = 4;
+  using F = __m128;   // float lanes
+  using I = __m128i;  // int32 lanes (or raw bytes)
+  using M = __m128;   // all-ones/all-zeros lane masks
+
+  static F Load(const float* p) { return _mm_loadu_ps(p); }
+  static I Load(const int32_t* p) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  }
+  static void Store(float* p, F v) { _mm_storeu_ps(p, v); }
+  static void Store(int32_t* p, I v) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+  }
+  static I LoadBytes(const uint8_t* p) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  }
+  static void StoreBytes(uint8_t* p, I v) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+  }
+
+  static F Splat(float v) { return _mm_set1_ps(v); }
+  static I Splat(int32_t v) { return _mm_set1_epi32(v); }
+  static I SplatBytes(uint8_t v) { return _mm_set1_epi8(static_cast<char>(v)); }
+  static I SplatBytes(uint16_t v) {
+    return _mm_set1_epi16(static_cast<int16_t>(v));
+  }
+  static I SplatBytes(uint32_t v) {
+    return _mm_set1_epi32(static_cast<int32_t>(v));
+  }
+
+  static F Add(F a, F b) { return _mm_add_ps(a, b); }
+  static F Sub(F a, F b) { return _mm_sub_ps(a, b); }
+  static F Mul(F a, F b) { return _mm_mul_ps(a, b); }
+  static F Div(F a, F b) { return _mm_div_ps(a, b); }
+  static F MulAdd(F a, F b, F c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+  static F Abs(F a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+  static F Neg(F a) { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+
+  static M Eq(F a, F b) { return _mm_cmpeq_ps(a, b); }
+  static M Ne(F a, F b) { return _mm_cmpneq_ps(a, b); }
+  static M Lt(F a, F b) { return _mm_cmplt_ps(a, b); }
+  static M Le(F a, F b) { return _mm_cmple_ps(a, b); }
+  static M Gt(F a, F b) { return _mm_cmpgt_ps(a, b); }
+  static M Ge(F a, F b) { return _mm_cmpge_ps(a, b); }
+  static M IsNan(F a) { return _mm_cmpunord_ps(a, a); }
+  static M Not(M a) { return _mm_xor_ps(a, _mm_castsi128_ps(AllOnes())); }
+  static F Select(M m, F a, F b) {
+    return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));
+  }
+
+  static I Add(I a, I b) { return _mm_add_epi32(a, b); }
+  static I Sub(I a, I b) { return _mm_sub_epi32(a, b); }
+  static I And(I a, I b) { return _mm_and_si128(a, b); }
+  static I Or(I a, I b) { return _mm_or_si128(a, b); }
+  static I Xor(I a, I b) { return _mm_xor_si128(a, b); }
+  static I AllOnes() { return _mm_set1_epi32(-1); }
+  template <int N>
+  static I ShiftLeft(I a) {
+    return _mm_slli_epi32(a, N);
+  }
+  template <int N>
+  static I ShiftRightArithmetic(I a) {
+    return _mm_srai_epi32(a, N);
+  }
+  template <int N>
+  static I ShiftRightLogical(I a) {
+    return _mm_srli_epi32(a, N);
+  }
+  static M Eq(I a, I b) { return _mm_castsi128_ps(_mm_cmpeq_epi32(a, b)); }
+  static M Lt(I a, I b) { return _mm_castsi128_ps(_mm_cmplt_epi32(a, b)); }
+  static M Gt(I a, I b) { return _mm_castsi128_ps(_mm_cmpgt_epi32(a, b)); }
+  static I Select(M m, I a, I b) {
+    I mi = _mm_castps_si128(m);
+    return _mm_or_si128(_mm_and_si128(mi, a), _mm_andnot_si128(mi, b));
+  }
+
+  // Rounds to nearest (even) in the default rounding mode.
+  static I RoundToInt(F a) { return _mm_cvtps_epi32(a); }
+  static F ToFloat(I a) { return _mm_cvtepi32_ps(a); }
+  static F AsFloat(I a) { return _mm_castsi128_ps(a); }
+  static I AsInt(F a) { return _mm_castps_si128(a); }
+
+  // Loads kLanes bytes of 0/non-0 booleans as a lane mask.
+  static M LoadMask(const uint8_t* p) {
+    int32_t bits;
+    std::memcpy(&bits, p, sizeof(bits));
+    I zero = _mm_setzero_si128();
+    I v = _mm_cvtsi32_si128(bits);
+    v = _mm_unpacklo_epi8(v, zero);
+    v = _mm_unpacklo_epi16(v, zero);
+    return _mm_castsi128_ps(_mm_cmpgt_epi32(v, zero));
+  }
+  // Stores a lane mask as kLanes bytes of 0/1 booleans.
+  static void StoreMask(uint8_t* p, M m) {
+    I v = _mm_and_si128(_mm_castps_si128(m), _mm_set1_epi32(1));
+    v = _mm_packs_epi32(v, v);
+    v = _mm_packus_epi16(v, v);
+    int32_t bits = _mm_cvtsi128_si32(v);
+    std::memcpy(p, &bits, sizeof(bits));
+  }
+
+};
+
+namespace sse2 {
+using V = Sse2Traits;
+#include "iree/hal/vmla/op_kernels_simd_impl.h"  // IWYU pragma: keep
+}  // namespace sse2
+
+#endif  // IREE_VMLA_SIMD_X86
+
+//===----------------------------------------------------------------------===//
+// AVX2 + FMA
+//===----------------------------------------------------------------------===//
+
+#if defined(IREE_VMLA_SIMD_AVX2)
+
+// Compile the AVX2 kernels for AVX2 regardless of the baseline target; they
+// are only called when the CPU supports it.
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2,fma"))), \
+                             apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#endif  // __clang__
+
+struct Avx2Traits {
+  static constexpr int kLanes = 8;
+  using F = __m256;
+  using I = __m256i;
+  using M = __m256;
+
+  static F Load(const float* p) { return _mm256_loadu_ps(p); }
+  static I Load(const int32_t* p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+  }
+  static void Store(float* p, F v) { _mm256_storeu_ps(p, v); }
+  static void Store(int32_t* p, I v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+  }
+  static I LoadBytes(const uint8_t* p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+  }
+  static void StoreBytes(uint8_t* p, I v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+  }
+
+  static F Splat(float v) { return _mm256_set1_ps(v); }
+  static I Splat(int32_t v) { return _mm256_set1_epi32(v); }
+  static I SplatBytes(uint8_t v) {
+    return _mm256_set1_epi8(static_cast<char>(v));
+  }
+  static I SplatBytes(uint16_t v) {
+    return _mm256_set1_epi16(static_cast<int16_t>(v));
+  }
+  static I SplatBytes(uint32_t v) {
+    return _mm256_set1_epi32(static_cast<int32_t>(v));
+  }
+
+  static F Add(F a, F b) { return _mm256_add_ps(a, b); }
+  static F Sub(F a, F b) { return _mm256_sub_ps(a, b); }
+  static F Mul(F a, F b) { return _mm256_mul_ps(a, b); }
+  static F Div(F a, F b) { return _mm256_div_ps(a, b); }
+  static F MulAdd(F a, F b, F c) { return _mm256_fmadd_ps(a, b, c); }
+  static F Abs(F a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+  static F Neg(F a) { return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f)); }
+
+  static M Eq(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+  static M Ne(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_NEQ_UQ); }
+  static M Lt(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+  static M Le(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+  static M Gt(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+  static M Ge(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+  static M IsNan(F a) { return _mm256_cmp_ps(a, a, _CMP_UNORD_Q); }
+  static M Not(M a) { return _mm256_xor_ps(a, _mm256_castsi256_ps(AllOnes())); }
+  static F Select(M m, F a, F b) { return _mm256_blendv_ps(b, a, m); }
+
+  static I Add(I a, I b) { return _mm256_add_epi32(a, b); }
+  static I Sub(I a, I b) { return _mm256_sub_epi32(a, b); }
+  static I And(I a, I b) { return _mm256_and_si256(a, b); }
+  static I Or(I a, I b) { return _mm256_or_si256(a, b); }
+  static I Xor(I a, I b) { return _mm256_xor_si256(a, b); }
+  static I AllOnes() { return _mm256_set1_epi32(-1); }
+  template <int N>
+  static I ShiftLeft(I a) {
+    return _mm256_slli_epi32(a, N);
+  }
+  template <int N>
+  static I ShiftRightArithmetic(I a) {
+    return _mm256_srai_epi32(a, N);
+  }
+  template <int N>
+  static I ShiftRightLogical(I a) {
+    return _mm256_srli_epi32(a, N);
+  }
+  static M Eq(I a, I b) {
+    return _mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b));
+  }
+  static M Lt(I a, I b) {
+    return _mm256_castsi256_ps(_mm256_cmpgt_epi32(b, a));
+  }
+  static M Gt(I a, I b) {
+    return _mm256_castsi256_ps(_mm256_cmpgt_epi32(a, b));
+  }
+  static I Select(M m, I a, I b) {
+    return _mm256_blendv_epi8(b, a, _mm256_castps_si256(m));
+  }
+
+  static I RoundToInt(F a) { return _mm256_cvtps_epi32(a); }
+  static F ToFloat(I a) { return _mm256_cvtepi32_ps(a); }
+  static F AsFloat(I a) { return _mm256_castsi256_ps(a); }
+  static I AsInt(F a) { return _mm256_castps_si256(a); }
+
+  static M LoadMask(const uint8_t* p) {
+    I v = _mm256_cvtepu8_epi32(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+    return _mm256_castsi256_ps(
+        _mm256_cmpgt_epi32(v, _mm256_setzero_si256()));
+  }
+  static void StoreMask(uint8_t* p, M m) {
+    I v = _mm256_and_si256(_mm256_castps_si256(m), _mm256_set1_epi32(1));
+    __m128i lo = _mm256_castsi256_si128(v);
+    __m128i hi = _mm256_extracti128_si256(v, 1);
+    __m128i packed = _mm_packs_epi32(lo, hi);
+    packed = _mm_packus_epi16(packed, packed);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(p), packed);
+  }
+
+};
+
+namespace avx2 {
+using V = Avx2Traits;
+#include "iree/hal/vmla/op_kernels_simd_impl.h"  // IWYU pragma: keep
+}  // namespace avx2
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif  // __clang__
+
+#endif  // IREE_VMLA_SIMD_AVX2
+
+//===----------------------------------------------------------------------===//
+// NEON (aarch64)
+//===----------------------------------------------------------------------===//
+
+#if defined(IREE_VMLA_SIMD_NEON)
+
+struct NeonTraits {
+  static constexpr int kLanes = 4;
+  using F = float32x4_t;
+  using I = int32x4_t;
+  using M = uint32x4_t;
+
+  static F Load(const float* p) { return vld1q_f32(p); }
+  static I Load(const int32_t* p) { return vld1q_s32(p); }
+  static void Store(float* p, F v) { vst1q_f32(p, v); }
+  static void Store(int32_t* p, I v) { vst1q_s32(p, v); }
+  static I LoadBytes(const uint8_t* p) {
+    return vreinterpretq_s32_u8(vld1q_u8(p));
+  }
+  static void StoreBytes(uint8_t* p, I v) {
+    vst1q_u8(p, vreinterpretq_u8_s32(v));
+  }
+
+  static F Splat(float v) { return vdupq_n_f32(v); }
+  static I Splat(int32_t v) { return vdupq_n_s32(v); }
+  static I SplatBytes(uint8_t v) { return vreinterpretq_s32_u8(vdupq_n_u8(v)); }
+  static I SplatBytes(uint16_t v) {
+    return vreinterpretq_s32_u16(vdupq_n_u16(v));
+  }
+  static I SplatBytes(uint32_t v) {
+    return vreinterpretq_s32_u32(vdupq_n_u32(v));
+  }
+
+  static F Add(F a, F b) { return vaddq_f32(a, b); }
+  static F Sub(F a, F b) { return vsubq_f32(a, b); }
+  static F Mul(F a, F b) { return vmulq_f32(a, b); }
+  static F Div(F a, F b) { return vdivq_f32(a, b); }
+  static F MulAdd(F a, F b, F c) { return vfmaq_f32(c, a, b); }
+  static F Abs(F a) { return vabsq_f32(a); }
+  static F Neg(F a) { return vnegq_f32(a); }
+
+  static M Eq(F a, F b) { return vceqq_f32(a, b); }
+  static M Ne(F a, F b) { return vmvnq_u32(vceqq_f32(a, b)); }
+  static M Lt(F a, F b) { return vcltq_f32(a, b); }
+  static M Le(F a, F b) { return vcleq_f32(a, b); }
+  static M Gt(F a, F b) { return vcgtq_f32(a, b); }
+  static M Ge(F a, F b) { return vcgeq_f32(a, b); }
+  static M IsNan(F a) { return vmvnq_u32(vceqq_f32(a, a)); }
+  static M Not(M a) { return vmvnq_u32(a); }
+  static F Select(M m, F a, F b) { return vbslq_f32(m, a, b); }
+
+  static I Add(I a, I b) { return vaddq_s32(a, b); }
+  static I Sub(I a, I b) { return vsubq_s32(a, b); }
+  static I And(I a, I b) { return vandq_s32(a, b); }
+  static I Or(I a, I b) { return vorrq_s32(a, b); }
+  static I Xor(I a, I b) { return veorq_s32(a, b); }
+  static I AllOnes() { return vdupq_n_s32(-1); }
+  template <int N>
+  static I ShiftLeft(I a) {
+    return vshlq_n_s32(a, N);
+  }
+  template <int N>
+  static I ShiftRightArithmetic(I a) {
+    return vshrq_n_s32(a, N);
+  }
+  template <int N>
+  static I ShiftRightLogical(I a) {
+    return vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(a), N));
+  }
+  static M Eq(I a, I b) { return vceqq_s32(a, b); }
+  static M Lt(I a, I b) { return vcltq_s32(a, b); }
+  static M Gt(I a, I b) { return vcgtq_s32(a, b); }
+  static I Select(M m, I a, I b) { return vbslq_s32(m, a, b); }
+
+  static I RoundToInt(F a) { return vcvtnq_s32_f32(a); }
+  static F ToFloat(I a) { return vcvtq_f32_s32(a); }
+  static F AsFloat(I a) { return vreinterpretq_f32_s32(a); }
+  static I AsInt(F a) { return vreinterpretq_s32_f32(a); }
+
+  static M LoadMask(const uint8_t* p) {
+    uint32_t bits;
+    std::memcpy(&bits, p, sizeof(bits));
+    uint16x8_t wide = vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(bits)));
+    return vcgtq_u32(vmovl_u16(vget_low_u16(wide)), vdupq_n_u32(0));
+  }
+  static void StoreMask(uint8_t* p, M m) {
+    uint16x4_t narrow = vmovn_u32(vandq_u32(m, vdupq_n_u32(1)));
+    uint8x8_t bytes = vmovn_u16(vcombine_u16(narrow, narrow));
+    uint32_t bits = vget_lane_u32(vreinterpret_u32_u8(bytes), 0);
+    std::memcpy(p, &bits, sizeof(bits));
+  }
+
+};
+
+namespace neon {
+using V = NeonTraits;
+#include "iree/hal/vmla/op_kernels_simd_impl.h"  // IWYU pragma: keep
+}  // namespace neon
+
+#endif  // IREE_VMLA_SIMD_NEON
+
+}  // namespace simd
+
+//===----------------------------------------------------------------------===//
+// Kernel specializations
+//===----------------------------------------------------------------------===//
+
+// Calls simd::<isa>::|fn| for the active instruction set.
+#if defined(IREE_VMLA_SIMD_X86) && defined(IREE_VMLA_SIMD_AVX2)
+#define IREE_VMLA_SIMD_DISPATCH(fn, ...)          \
+  do {                                            \
+    if (simd::GetActiveIsa() == simd::Isa::kAvx2) { \
+      simd::avx2::fn(__VA_ARGS__);                \
+    } else {                                      \
+      simd::sse2::fn(__VA_ARGS__);                \
+    }                                             \
+  } while (false)
+#elif defined(IREE_VMLA_SIMD_X86)
+#define IREE_VMLA_SIMD_DISPATCH(fn, ...) simd::sse2::fn(__VA_ARGS__)
+#else
+#define IREE_VMLA_SIMD_DISPATCH(fn, ...) simd::neon::fn(__VA_ARGS__)
+#endif  // IREE_VMLA_SIMD_*
+
+#define IREE_VMLA_SIMD_UNARY_KERNEL(kernel, type, fn)                      \
+  template <>                                                              \
+  inline Status kernel::Execute<type>(absl::Span<const type> src_buffer,   \
+                                      absl::Span<type> dst_buffer) {       \
+    IREE_VMLA_SIMD_DISPATCH(fn, src_buffer.data(), dst_buffer.data(),      \
+                            dst_buffer.size());                            \
+    return OkStatus();                                                     \
+  }
+
+#define IREE_VMLA_SIMD_BINARY_KERNEL(kernel, type, fn)                     \
+  template <>                                                              \
+  inline Status kernel::Execute<type>(absl::Span<const type> lhs_buffer,   \
+                                      absl::Span<const type> rhs_buffer,   \
+                                      absl::Span<type> dst_buffer) {       \
+    IREE_VMLA_SIMD_DISPATCH(fn, lhs_buffer.data(), rhs_buffer.data(),      \
+                            dst_buffer.data(), dst_buffer.size());         \
+    return OkStatus();                                                     \
+  }
+
+#define IREE_VMLA_SIMD_BROADCAST_KERNEL(kernel, type, fn)                  \
+  template <>                                                              \
+  inline Status kernel::Execute<type>(absl::Span<const type> lhs_buffer,   \
+                                      type rhs,                            \
+                                      absl::Span<type> dst_buffer) {       \
+    IREE_VMLA_SIMD_DISPATCH(fn, lhs_buffer.data(), rhs, dst_buffer.data(), \
+                            dst_buffer.size());                            \
+    return OkStatus();                                                     \
+  }
+
+#define IREE_VMLA_SIMD_COMPARE_KERNEL(kernel, type, fn)                    \
+  template <>                                                              \
+  inline Status kernel::Execute<type>(absl::Span<const type> lhs_buffer,   \
+                                      absl::Span<const type> rhs_buffer,   \
+                                      absl::Span<uint8_t> dst_buffer) {    \
+    IREE_VMLA_SIMD_DISPATCH(fn, lhs_buffer.data(), rhs_buffer.data(),      \
+                            dst_buffer.data(), dst_buffer.size());         \
+    return OkStatus();                                                     \
+  }
+
+IREE_VMLA_SIMD_BINARY_KERNEL(Add, float, AddF32)
+IREE_VMLA_SIMD_BINARY_KERNEL(Add, int32_t, AddI32)
+IREE_VMLA_SIMD_BINARY_KERNEL(Sub, float, SubF32)
+IREE_VMLA_SIMD_BINARY_KERNEL(Sub, int32_t, SubI32)
+IREE_VMLA_SIMD_BINARY_KERNEL(Mul, float, MulF32)
+IREE_VMLA_SIMD_BINARY_KERNEL(Div, float, DivF32)
+IREE_VMLA_SIMD_BINARY_KERNEL(Min, float, MinF32)
+IREE_VMLA_SIMD_BINARY_KERNEL(Min, int32_t, MinI32)
+IREE_VMLA_SIMD_BINARY_KERNEL(Max, float, MaxF32)
+IREE_VMLA_SIMD_BINARY_KERNEL(Max, int32_t, MaxI32)
+IREE_VMLA_SIMD_UNARY_KERNEL(Abs, float, AbsF32)
+IREE_VMLA_SIMD_UNARY_KERNEL(Neg, float, NegF32)
+IREE_VMLA_SIMD_UNARY_KERNEL(Exp, float, ExpF32)
+IREE_VMLA_SIMD_UNARY_KERNEL(Log, float, LogF32)
+IREE_VMLA_SIMD_UNARY_KERNEL(Tanh, float, TanhF32)
+
+IREE_VMLA_SIMD_COMPARE_KERNEL(CompareEQ, float, CompareEQF32)
+IREE_VMLA_SIMD_COMPARE_KERNEL(CompareNE, float, CompareNEF32)
+IREE_VMLA_SIMD_COMPARE_KERNEL(CompareLT, float, CompareLTF32)
+IREE_VMLA_SIMD_COMPARE_KERNEL(CompareLE, float, CompareLEF32)
+IREE_VMLA_SIMD_COMPARE_KERNEL(CompareGT, float, CompareGTF32)
+IREE_VMLA_SIMD_COMPARE_KERNEL(CompareGE, float, CompareGEF32)
+IREE_VMLA_SIMD_COMPARE_KERNEL(CompareEQ, int32_t, CompareEQI32)
+IREE_VMLA_SIMD_COMPARE_KERNEL(CompareNE, int32_t, CompareNEI32)
+IREE_VMLA_SIMD_COMPARE_KERNEL(CompareLT, int32_t, CompareLTI32)
+IREE_VMLA_SIMD_COMPARE_KERNEL(CompareLE, int32_t, CompareLEI32)
+IREE_VMLA_SIMD_COMPARE_KERNEL(CompareGT, int32_t, CompareGTI32)
+IREE_VMLA_SIMD_COMPARE_KERNEL(CompareGE, int32_t, CompareGEI32)
+
+IREE_VMLA_SIMD_BINARY_KERNEL(And, uint8_t, And)
+IREE_VMLA_SIMD_BINARY_KERNEL(And, uint16_t, And)
+IREE_VMLA_SIMD_BINARY_KERNEL(And, uint32_t, And)
+IREE_VMLA_SIMD_BINARY_KERNEL(Or, uint8_t, Or)
+IREE_VMLA_SIMD_BINARY_KERNEL(Or, uint16_t, Or)
+IREE_VMLA_SIMD_BINARY_KERNEL(Or, uint32_t, Or)
+IREE_VMLA_SIMD_BINARY_KERNEL(Xor, uint8_t, Xor)
+IREE_VMLA_SIMD_BINARY_KERNEL(Xor, uint16_t, Xor)
+IREE_VMLA_SIMD_BINARY_KERNEL(Xor, uint32_t, Xor)
+IREE_VMLA_SIMD_BROADCAST_KERNEL(And, uint8_t, AndBroadcast)
+IREE_VMLA_SIMD_BROADCAST_KERNEL(And, uint16_t, AndBroadcast)
+IREE_VMLA_SIMD_BROADCAST_KERNEL(And, uint32_t, AndBroadcast)
+IREE_VMLA_SIMD_BROADCAST_KERNEL(Xor, uint8_t, XorBroadcast)
+IREE_VMLA_SIMD_BROADCAST_KERNEL(Xor, uint16_t, XorBroadcast)
+IREE_VMLA_SIMD_BROADCAST_KERNEL(Xor, uint32_t, XorBroadcast)
+
+template <>
+inline Status Select::Execute<uint32_t>(absl::Span<const uint8_t> cond_buffer,
+                                        absl::Span<const uint32_t> lhs_buffer,
+                                        absl::Span<const uint32_t> rhs_buffer,
+                                        absl::Span<uint32_t> dst_buffer) {
+  IREE_VMLA_SIMD_DISPATCH(SelectX32, cond_buffer.data(), lhs_buffer.data(),
+                          rhs_buffer.data(), dst_buffer.data(),
+                          dst_buffer.size());
+  return OkStatus();
+}
+
+#undef IREE_VMLA_SIMD_UNARY_KERNEL
+#undef IREE_VMLA_SIMD_BINARY_KERNEL
+#undef IREE_VMLA_SIMD_BROADCAST_KERNEL
+#undef IREE_VMLA_SIMD_COMPARE_KERNEL
+#undef IREE_VMLA_SIMD_DISPATCH
+
+}  // namespace kernels
+}  // namespace vmla
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_VMLA_SIMD_X86 || IREE_VMLA_SIMD_NEON
+
+#endif  // IREE_HAL_VMLA_OP_KERNELS_SIMD_H_
@@ -0,0 +1,467 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Instruction set independent SIMD elementwise loops and math.
+//
+// NOTE: this file has no include guard and is included multiple times by
+// op_kernels_simd.h, each time within a namespace that aliases |V| to the
+// traits of one instruction set. All functions must only use |V| so that they
+// are compiled for (and inlined within) that instruction set.
+
+using F = V::F;
+using I = V::I;
+using M = V::M;
+
+//===----------------------------------------------------------------------===//
+// Math
+//===----------------------------------------------------------------------===//
+
+// exp(x) using the Cephes expf range reduction and polynomial.
+inline F Exp(F x) {
+  // Beyond this range the result is 0/denormal-underflowed or +inf.
+  F clamped = V::Select(V::Lt(x, V::Splat(-104.0f)), V::Splat(-104.0f), x);
+  clamped = V::Select(V::Gt(clamped, V::Splat(89.0f)), V::Splat(89.0f),
+                      clamped);
+
+  // x = n * ln(2) + r with |r| <= ln(2)/2.
+  I n = V::RoundToInt(V::Mul(clamped, V::Splat(1.44269504088896341f)));
+  F n_float = V::ToFloat(n);
+  F r = V::Sub(clamped, V::Mul(n_float, V::Splat(0.693359375f)));
+  r = V::Sub(r, V::Mul(n_float, V::Splat(-2.12194440e-4f)));
+
+  F p = V::Splat(1.9875691500E-4f);
+  p = V::MulAdd(p, r, V::Splat(1.3981999507E-3f));
+  p = V::MulAdd(p, r, V::Splat(8.3334519073E-3f));
+  p = V::MulAdd(p, r, V::Splat(4.1665795894E-2f));
+  p = V::MulAdd(p, r, V::Splat(1.6666665459E-1f));
+  p = V::MulAdd(p, r, V::Splat(5.0000001201E-1f));
+  F y = V::Add(V::MulAdd(p, V::Mul(r, r), r), V::Splat(1.0f));
+
+  // Scale by 2^n in two steps as n may be outside of the normal exponent
+  // range; the second multiply produces denormals/0 and inf as needed.
+  I n_half = V::ShiftRightArithmetic<1>(n);
+  I n_rest = V::Sub(n, n_half);
+  F scale_half =
+      V::AsFloat(V::ShiftLeft<23>(V::Add(n_half, V::Splat(int32_t{127}))));
+  F scale_rest =
+      V::AsFloat(V::ShiftLeft<23>(V::Add(n_rest, V::Splat(int32_t{127}))));
+  F result = V::Mul(V::Mul(y, scale_half), scale_rest);
+  return V::Select(V::IsNan(x), x, result);
+}
+
+// log(x) using the Cephes logf range reduction and polynomial.
+inline F Log(F x) {
+  // Scale denormals into the normal range so the exponent can be extracted.
+  M is_denormal = V::Lt(x, V::Splat(1.17549435e-38f));
+  F scaled = V::Select(is_denormal, V::Mul(x, V::Splat(8388608.0f)), x);
+  I exponent_bias = V::Select(is_denormal, V::Splat(int32_t{126 + 23}),
+                              V::Splat(int32_t{126}));
+
+  // x = m * 2^e with m in [0.5, 1).
+  I bits = V::AsInt(scaled);
+  I e = V::Sub(V::ShiftRightLogical<23>(bits), exponent_bias);
+  F m = V::AsFloat(V::Or(V::And(bits, V::Splat(int32_t{0x007FFFFF})),
+                         V::Splat(int32_t{0x3F000000})));
+
+  // Keep m in [sqrt(0.5), sqrt(2)) for accuracy: t = m - 1 (or 2m - 1).
+  M is_small = V::Lt(m, V::Splat(0.707106781186547524f));
+  F e_float = V::Sub(V::ToFloat(e),
+                     V::Select(is_small, V::Splat(1.0f), V::Splat(0.0f)));
+  F t = V::Sub(V::Add(m, V::Select(is_small, m, V::Splat(0.0f))),
+               V::Splat(1.0f));
+  F z = V::Mul(t, t);
+
+  F p = V::Splat(7.0376836292E-2f);
+  p = V::MulAdd(p, t, V::Splat(-1.1514610310E-1f));
+  p = V::MulAdd(p, t, V::Splat(1.1676998740E-1f));
+  p = V::MulAdd(p, t, V::Splat(-1.2420140846E-1f));
+  p = V::MulAdd(p, t, V::Splat(1.4249322787E-1f));
+  p = V::MulAdd(p, t, V::Splat(-1.6668057665E-1f));
+  p = V::MulAdd(p, t, V::Splat(2.0000714765E-1f));
+  p = V::MulAdd(p, t, V::Splat(-2.4999993993E-1f));
+  p = V::MulAdd(p, t, V::Splat(3.3333331174E-1f));
+  F y = V::Mul(V::Mul(p, t), z);
+  y = V::MulAdd(e_float, V::Splat(-2.12194440e-4f), y);
+  y = V::MulAdd(z, V::Splat(-0.5f), y);
+  F result = V::Add(t, y);
+  result = V::MulAdd(e_float, V::Splat(0.693359375f), result);
+
+  const float kInf = std::numeric_limits<float>::infinity();
+  result = V::Select(V::Eq(x, V::Splat(0.0f)), V::Splat(-kInf), result);
+  result = V::Select(V::Eq(x, V::Splat(kInf)), x, result);
+  // Negative inputs and NaNs produce NaN.
+  M is_invalid = V::Not(V::Ge(x, V::Splat(0.0f)));
+  return V::Select(is_invalid,
+                   V::Splat(std::numeric_limits<float>::quiet_NaN()), result);
+}
+
+// tanh(x) using the Cephes tanhf polynomial for small |x| and
+// 1 - 2 / (exp(2|x|) + 1) otherwise.
+inline F Tanh(F x) {
+  F abs_x = V::Abs(x);
+
+  F z = V::Mul(x, x);
+  F p = V::Splat(-5.70498872745E-3f);
+  p = V::MulAdd(p, z, V::Splat(2.06390887954E-2f));
+  p = V::MulAdd(p, z, V::Splat(-5.37397155531E-2f));
+  p = V::MulAdd(p, z, V::Splat(1.33314422036E-1f));
+  p = V::MulAdd(p, z, V::Splat(-3.33332819422E-1f));
+  F small_result = V::MulAdd(V::Mul(p, z), x, x);
+  // The polynomial rounds -0 to +0; tanh(+-0) is +-0.
+  small_result = V::Select(V::Eq(x, V::Splat(0.0f)), x, small_result);
+
+  F e = Exp(V::Add(abs_x, abs_x));
+  F large_result = V::Sub(
+      V::Splat(1.0f), V::Div(V::Splat(2.0f), V::Add(e, V::Splat(1.0f))));
+  large_result = V::Select(V::Lt(x, V::Splat(0.0f)), V::Neg(large_result),
+                           large_result);
+
+  // NaNs take the large path and stay NaN.
+  return V::Select(V::Lt(abs_x, V::Splat(0.625f)), small_result,
+                   large_result);
+}
+
+//===----------------------------------------------------------------------===//
+// Per-element operations
+//===----------------------------------------------------------------------===//
+// Each operation is a struct with a static Apply so that it can be passed to
+// the loops below without relying on lambdas inheriting target attributes.
+
+struct AddOp {
+  template <typename T>
+  static T Apply(T a, T b) {
+    return V::Add(a, b);
+  }
+};
+struct SubOp {
+  template <typename T>
+  static T Apply(T a, T b) {
+    return V::Sub(a, b);
+  }
+};
+struct MulOp {
+  static F Apply(F a, F b) { return V::Mul(a, b); }
+};
+struct DivOp {
+  static F Apply(F a, F b) { return V::Div(a, b); }
+};
+// Min/Max match std::min/std::max (and the generic kernels) exactly,
+// including which operand is returned for NaNs and signed zeros.
+struct MinOp {
+  template <typename T>
+  static T Apply(T a, T b) {
+    return V::Select(V::Lt(b, a), b, a);
+  }
+};
+struct MaxOp {
+  template <typename T>
+  static T Apply(T a, T b) {
+    return V::Select(V::Lt(a, b), b, a);
+  }
+};
+struct AndOp {
+  static I Apply(I a, I b) { return V::And(a, b); }
+};
+struct OrOp {
+  static I Apply(I a, I b) { return V::Or(a, b); }
+};
+struct XorOp {
+  static I Apply(I a, I b) { return V::Xor(a, b); }
+};
+
+struct AbsOp {
+  static F Apply(F a) { return V::Abs(a); }
+};
+struct NegOp {
+  static F Apply(F a) { return V::Neg(a); }
+};
+struct ExpOp {
+  static F Apply(F a) { return Exp(a); }
+};
+struct LogOp {
+  static F Apply(F a) { return Log(a); }
+};
+struct TanhOp {
+  static F Apply(F a) { return Tanh(a); }
+};
+
+struct CompareEQOp {
+  template <typename T>
+  static M Apply(T a, T b) {
+    return V::Eq(a, b);
+  }
+};
+struct CompareNEOp {
+  template <typename T>
+  static M Apply(T a, T b) {
+    return V::Not(V::Eq(a, b));
+  }
+};
+struct CompareLTOp {
+  template <typename T>
+  static M Apply(T a, T b) {
+    return V::Lt(a, b);
+  }
+};
+struct CompareLEOp {
+  static M Apply(F a, F b) { return V::Le(a, b); }
+  static M Apply(I a, I b) { return V::Not(V::Gt(a, b)); }
+};
+struct CompareGTOp {
+  template <typename T>
+  static M Apply(T a, T b) {
+    return V::Gt(a, b);
+  }
+};
+struct CompareGEOp {
+  static M Apply(F a, F b) { return V::Ge(a, b); }
+  static M Apply(I a, I b) { return V::Not(V::Lt(a, b)); }
+};
+
+//===----------------------------------------------------------------------===//
+// Loops
+//===----------------------------------------------------------------------===//
+// Tails shorter than a vector are copied through stack buffers so that every
+// element goes through exactly the same arithmetic.
+
+template <typename Op, typename T>
+inline void UnaryLoop(const T* src, T* dst, size_t count) {
+  size_t i = 0;
+  for (; i + V::kLanes <= count; i += V::kLanes) {
+    V::Store(dst + i, Op::Apply(V::Load(src + i)));
+  }
+  if (i < count) {
+    T src_tail[V::kLanes] = {};
+    T dst_tail[V::kLanes];
+    std::memcpy(src_tail, src + i, (count - i) * sizeof(T));
+    V::Store(dst_tail, Op::Apply(V::Load(src_tail)));
+    std::memcpy(dst + i, dst_tail, (count - i) * sizeof(T));
+  }
+}
+
+template <typename Op, typename T>
+inline void BinaryLoop(const T* lhs, const T* rhs, T* dst, size_t count) {
+  size_t i = 0;
+  for (; i + V::kLanes <= count; i += V::kLanes) {
+    V::Store(dst + i, Op::Apply(V::Load(lhs + i), V::Load(rhs + i)));
+  }
+  if (i < count) {
+    T lhs_tail[V::kLanes] = {};
+    T rhs_tail[V::kLanes] = {};
+    T dst_tail[V::kLanes];
+    std::memcpy(lhs_tail, lhs + i, (count - i) * sizeof(T));
+    std::memcpy(rhs_tail, rhs + i, (count - i) * sizeof(T));
+    V::Store(dst_tail, Op::Apply(V::Load(lhs_tail), V::Load(rhs_tail)));
+    std::memcpy(dst + i, dst_tail, (count - i) * sizeof(T));
+  }
+}
+
+template <typename Op, typename T>
+inline void CompareLoop(const T* lhs, const T* rhs, uint8_t* dst,
+                        size_t count) {
+  size_t i = 0;
+  for (; i + V::kLanes <= count; i += V::kLanes) {
+    V::StoreMask(dst + i, Op::Apply(V::Load(lhs + i), V::Load(rhs + i)));
+  }
+  if (i < count) {
+    T lhs_tail[V::kLanes] = {};
+    T rhs_tail[V::kLanes] = {};
+    uint8_t dst_tail[V::kLanes];
+    std::memcpy(lhs_tail, lhs + i, (count - i) * sizeof(T));
+    std::memcpy(rhs_tail, rhs + i, (count - i) * sizeof(T));
+    V::StoreMask(dst_tail, Op::Apply(V::Load(lhs_tail), V::Load(rhs_tail)));
+    std::memcpy(dst + i, dst_tail, count - i);
+  }
+}
+
+// Bitwise operations work on raw bytes regardless of the element type.
+template <typename Op>
+inline void BitwiseLoop(const uint8_t* lhs, const uint8_t* rhs, uint8_t* dst,
+                        size_t byte_count) {
+  constexpr size_t kBytes = V::kLanes * sizeof(int32_t);
+  size_t i = 0;
+  for (; i + kBytes <= byte_count; i += kBytes) {
+    V::StoreBytes(dst + i,
+                  Op::Apply(V::LoadBytes(lhs + i), V::LoadBytes(rhs + i)));
+  }
+  if (i < byte_count) {
+    uint8_t lhs_tail[kBytes] = {};
+    uint8_t rhs_tail[kBytes] = {};
+    uint8_t dst_tail[kBytes];
+    std::memcpy(lhs_tail, lhs + i, byte_count - i);
+    std::memcpy(rhs_tail, rhs + i, byte_count - i);
+    V::StoreBytes(dst_tail,
+                  Op::Apply(V::LoadBytes(lhs_tail), V::LoadBytes(rhs_tail)));
+    std::memcpy(dst + i, dst_tail, byte_count - i);
+  }
+}
+
+// As BitwiseLoop with the rhs broadcast from a splatted scalar. Vectors always
+// start on an element boundary so the splat pattern lines up.
+template <typename Op>
+inline void BitwiseBroadcastLoop(const uint8_t* lhs, I rhs, uint8_t* dst,
+                                 size_t byte_count) {
+  constexpr size_t kBytes = V::kLanes * sizeof(int32_t);
+  size_t i = 0;
+  for (; i + kBytes <= byte_count; i += kBytes) {
+    V::StoreBytes(dst + i, Op::Apply(V::LoadBytes(lhs + i), rhs));
+  }
+  if (i < byte_count) {
+    uint8_t lhs_tail[kBytes] = {};
+    uint8_t dst_tail[kBytes];
+    std::memcpy(lhs_tail, lhs + i, byte_count - i);
+    V::StoreBytes(dst_tail, Op::Apply(V::LoadBytes(lhs_tail), rhs));
+    std::memcpy(dst + i, dst_tail, byte_count - i);
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// Entry points
+//===----------------------------------------------------------------------===//
+
+inline void AddF32(const float* lhs, const float* rhs, float* dst,
+                   size_t count) {
+  BinaryLoop<AddOp>(lhs, rhs, dst, count);
+}
+inline void AddI32(const int32_t* lhs, const int32_t* rhs, int32_t* dst,
+                   size_t count) {
+  BinaryLoop<AddOp>(lhs, rhs, dst, count);
+}
+inline void SubF32(const float* lhs, const float* rhs, float* dst,
+                   size_t count) {
+  BinaryLoop<SubOp>(lhs, rhs, dst, count);
+}
+inline void SubI32(const int32_t* lhs, const int32_t* rhs, int32_t* dst,
+                   size_t count) {
+  BinaryLoop<SubOp>(lhs, rhs, dst, count);
+}
+inline void MulF32(const float* lhs, const float* rhs, float* dst,
+                   size_t count) {
+  BinaryLoop<MulOp>(lhs, rhs, dst, count);
+}
+inline void DivF32(const float* lhs, const float* rhs, float* dst,
+                   size_t count) {
+  BinaryLoop<DivOp>(lhs, rhs, dst, count);
+}
+inline void MinF32(const float* lhs, const float* rhs, float* dst,
+                   size_t count) {
+  BinaryLoop<MinOp>(lhs, rhs, dst, count);
+}
+inline void MinI32(const int32_t* lhs, const int32_t* rhs, int32_t* dst,
+                   size_t count) {
+  BinaryLoop<MinOp>(lhs, rhs, dst, count);
+}
+inline void MaxF32(const float* lhs, const float* rhs, float* dst,
+                   size_t count) {
+  BinaryLoop<MaxOp>(lhs, rhs, dst, count);
+}
+inline void MaxI32(const int32_t* lhs, const int32_t* rhs, int32_t* dst,
+                   size_t count) {
+  BinaryLoop<MaxOp>(lhs, rhs, dst, count);
+}
+
+inline void AbsF32(const float* src, float* dst, size_t count) {
+  UnaryLoop<AbsOp>(src, dst, count);
+}
+inline void NegF32(const float* src, float* dst, size_t count) {
+  UnaryLoop<NegOp>(src, dst, count);
+}
+inline void ExpF32(const float* src, float* dst, size_t count) {
+  UnaryLoop<ExpOp>(src, dst, count);
+}
+inline void LogF32(const float* src, float* dst, size_t count) {
+  UnaryLoop<LogOp>(src, dst, count);
+}
+inline void TanhF32(const float* src, float* dst, size_t count) {
+  UnaryLoop<TanhOp>(src, dst, count);
+}
+
+#define IREE_VMLA_SIMD_COMPARE_ENTRY(name, op, type)                  \
+  inline void name(const type* lhs, const type* rhs, uint8_t* dst,    \
+                   size_t count) {                                    \
+    CompareLoop<op>(lhs, rhs, dst, count);                            \
+  }
+IREE_VMLA_SIMD_COMPARE_ENTRY(CompareEQF32, CompareEQOp, float)
+IREE_VMLA_SIMD_COMPARE_ENTRY(CompareNEF32, CompareNEOp, float)
+IREE_VMLA_SIMD_COMPARE_ENTRY(CompareLTF32, CompareLTOp, float)
+IREE_VMLA_SIMD_COMPARE_ENTRY(CompareLEF32, CompareLEOp, float)
+IREE_VMLA_SIMD_COMPARE_ENTRY(CompareGTF32, CompareGTOp, float)
+IREE_VMLA_SIMD_COMPARE_ENTRY(CompareGEF32, CompareGEOp, float)
+IREE_VMLA_SIMD_COMPARE_ENTRY(CompareEQI32, CompareEQOp, int32_t)
+IREE_VMLA_SIMD_COMPARE_ENTRY(CompareNEI32, CompareNEOp, int32_t)
+IREE_VMLA_SIMD_COMPARE_ENTRY(CompareLTI32, CompareLTOp, int32_t)
+IREE_VMLA_SIMD_COMPARE_ENTRY(CompareLEI32, CompareLEOp, int32_t)
+IREE_VMLA_SIMD_COMPARE_ENTRY(CompareGTI32, CompareGTOp, int32_t)
+IREE_VMLA_SIMD_COMPARE_ENTRY(CompareGEI32, CompareGEOp, int32_t)
+#undef IREE_VMLA_SIMD_COMPARE_ENTRY
+
+// Selects 32-bit values (of any type) from |lhs| where |cond| is non-zero
+// and from |rhs| otherwise.
+inline void SelectX32(const uint8_t* cond, const uint32_t* lhs,
+                      const uint32_t* rhs, uint32_t* dst, size_t count) {
+  const int32_t* lhs_i32 = reinterpret_cast<const int32_t*>(lhs);
+  const int32_t* rhs_i32 = reinterpret_cast<const int32_t*>(rhs);
+  int32_t* dst_i32 = reinterpret_cast<int32_t*>(dst);
+  size_t i = 0;
+  for (; i + V::kLanes <= count; i += V::kLanes) {
+    V::Store(dst_i32 + i, V::Select(V::LoadMask(cond + i),
+                                    V::Load(lhs_i32 + i),
+                                    V::Load(rhs_i32 + i)));
+  }
+  if (i < count) {
+    uint8_t cond_tail[V::kLanes] = {};
+    int32_t lhs_tail[V::kLanes] = {};
+    int32_t rhs_tail[V::kLanes] = {};
+    int32_t dst_tail[V::kLanes];
+    std::memcpy(cond_tail, cond + i, count - i);
+    std::memcpy(lhs_tail, lhs_i32 + i, (count - i) * sizeof(int32_t));
+    std::memcpy(rhs_tail, rhs_i32 + i, (count - i) * sizeof(int32_t));
+    V::Store(dst_tail, V::Select(V::LoadMask(cond_tail), V::Load(lhs_tail),
+                                 V::Load(rhs_tail)));
+    std::memcpy(dst_i32 + i, dst_tail, (count - i) * sizeof(int32_t));
+  }
+}
+
+template <typename T>
+inline void And(const T* lhs, const T* rhs, T* dst, size_t count) {
+  BitwiseLoop<AndOp>(reinterpret_cast<const uint8_t*>(lhs),
+                     reinterpret_cast<const uint8_t*>(rhs),
+                     reinterpret_cast<uint8_t*>(dst), count * sizeof(T));
+}
+template <typename T>
+inline void Or(const T* lhs, const T* rhs, T* dst, size_t count) {
+  BitwiseLoop<OrOp>(reinterpret_cast<const uint8_t*>(lhs),
+                    reinterpret_cast<const uint8_t*>(rhs),
+                    reinterpret_cast<uint8_t*>(dst), count * sizeof(T));
+}
+template <typename T>
+inline void Xor(const T* lhs, const T* rhs, T* dst, size_t count) {
+  BitwiseLoop<XorOp>(reinterpret_cast<const uint8_t*>(lhs),
+                     reinterpret_cast<const uint8_t*>(rhs),
+                     reinterpret_cast<uint8_t*>(dst), count * sizeof(T));
+}
+template <typename T>
+inline void AndBroadcast(const T* lhs, T rhs, T* dst, size_t count) {
+  BitwiseBroadcastLoop<AndOp>(reinterpret_cast<const uint8_t*>(lhs),
+                              V::SplatBytes(rhs),
+                              reinterpret_cast<uint8_t*>(dst),
+                              count * sizeof(T));
+}
+template <typename T>
+inline void XorBroadcast(const T* lhs, T rhs, T* dst, size_t count) {
+  BitwiseBroadcastLoop<XorOp>(reinterpret_cast<const uint8_t*>(lhs),
+                              V::SplatBytes(rhs),
+                              reinterpret_cast<uint8_t*>(dst),
+                              count * sizeof(T));
+}
@@ -14,8 +14,17 @@
 
 #include "iree/hal/vmla/op_kernels.h"
 
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <set>
+#include <thread>  // NOLINT
+#include <vector>
+
 #include "absl/container/inlined_vector.h"
+#include "absl/synchronization/mutex.h"
 #include "iree/base/memory.h"
+#include "iree/hal/vmla/scratch_arena.h"
 #include "iree/testing/gtest.h"
 #include "iree/testing/status_matchers.h"
 
@@ -536,6 +545,293 @@ TEST(Conv2d, DepthwiseConv) {
   }
 }
 
+TEST(PrepackedCache, CachesPerOwnerAndParams) {
+  PrepackedCache cache;
+  int owner_a = 0;
+  int owner_b = 0;
+  const float data[4] = {1, 2, 3, 4};
+  int pack_count = 0;
+  auto pack = [&](std::vector<float>* packed) {
+    ++pack_count;
+    packed->assign(std::begin(data), std::end(data));
+  };
+  const int32_t params_1[] = {1};
+  const int32_t params_2[] = {2};
+  auto entry_a1 = cache.GetOrPack<float>(&owner_a, data, params_1, pack);
+  EXPECT_EQ(entry_a1, cache.GetOrPack<float>(&owner_a, data, params_1, pack));
+  EXPECT_EQ(1, pack_count);
+  auto entry_a2 = cache.GetOrPack<float>(&owner_a, data, params_2, pack);
+  auto entry_b1 = cache.GetOrPack<float>(&owner_b, data, params_1, pack);
+  EXPECT_NE(entry_a1, entry_a2);
+  EXPECT_NE(entry_a1, entry_b1);
+  EXPECT_EQ(3, pack_count);
+  EXPECT_EQ(3u, cache.size());
+
+  cache.ReleaseOwner(&owner_a);
+  EXPECT_EQ(1u, cache.size());
+  EXPECT_EQ(4u, entry_a1->size());
+  EXPECT_EQ(entry_b1, cache.GetOrPack<float>(&owner_b, data, params_1, pack));
+  EXPECT_EQ(3, pack_count);
+}
+
+// Checks MatMul against a naive reference with enough work that it is split
+// into slices across the device thread pool.
+void ExpectSlicedMatMulMatchesReference(bool lhs_is_constant,
+                                        bool rhs_is_constant) {
+  constexpr int kRows = 128;
+  constexpr int kDepth = 96;
+  constexpr int kCols = 112;
+  Shape lhs_shape = {kRows, kDepth};
+  Shape rhs_shape = {kCols, kDepth};
+  Shape dst_shape = {kCols, kRows};
+  std::vector<float> lhs_buffer(kRows * kDepth);
+  std::vector<float> rhs_buffer(kCols * kDepth);
+  std::vector<float> bias_buffer(kRows);
+  for (size_t i = 0; i < lhs_buffer.size(); ++i) lhs_buffer[i] = i % 7 - 3.0f;
+  for (size_t i = 0; i < rhs_buffer.size(); ++i) rhs_buffer[i] = i % 5 - 2.0f;
+  for (size_t i = 0; i < bias_buffer.size(); ++i) bias_buffer[i] = i % 3;
+
+  std::vector<float> expected_dst(kCols * kRows);
+  for (int n = 0; n < kCols; ++n) {
+    for (int m = 0; m < kRows; ++m) {
+      float sum = bias_buffer[m];
+      for (int k = 0; k < kDepth; ++k) {
+        sum += lhs_buffer[m * kDepth + k] * rhs_buffer[n * kDepth + k];
+      }
+      expected_dst[n * kRows + m] = sum;
+    }
+  }
+
+  RuntimeStateOptions options;
+  options.max_thread_count = 4;
+  RuntimeState runtime_state(options);
+  for (int run = 0; run < 2; ++run) {
+    std::vector<float> dst_buffer(expected_dst.size(), 1.0f);
+    MatMul::Buffers<float, float> buffers;
+    buffers.lhs_shape = lhs_shape;
+    buffers.lhs_buffer = lhs_buffer;
+    buffers.rhs_shape = rhs_shape;
+    buffers.rhs_buffer = rhs_buffer;
+    buffers.dst_shape = dst_shape;
+    buffers.dst_buffer = absl::MakeSpan(dst_buffer);
+    buffers.bias_buffer = bias_buffer;
+    buffers.lhs_is_constant = lhs_is_constant;
+    buffers.rhs_is_constant = rhs_is_constant;
+    IREE_ASSERT_OK(MatMul::Execute(runtime_state.mat_mul_state.get(), buffers));
+    for (size_t i = 0; i < dst_buffer.size(); ++i) {
+      EXPECT_EQ(expected_dst[i], dst_buffer[i]) << "mismatch at " << i;
+    }
+  }
+  runtime_state.ReleaseConstants(&lhs_buffer);
+}
+
+TEST(MatMul, SlicedRows) {
+  ExpectSlicedMatMulMatchesReference(/*lhs_is_constant=*/false,
+                                     /*rhs_is_constant=*/true);
+}
+
+TEST(MatMul, SlicedCols) {
+  ExpectSlicedMatMulMatchesReference(/*lhs_is_constant=*/true,
+                                     /*rhs_is_constant=*/false);
+}
+
+struct Conv2DParams {
+  Shape input_shape;
+  Shape filter_shape;
+  Shape dst_shape;
+  Shape strides = {1, 1};
+  Shape pad_h = {0, 0};
+  Shape pad_w = {0, 0};
+  Shape lhs_dilation = {1, 1};
+  Shape rhs_dilation = {1, 1};
+  int32_t groups = 1;
+};
+
+// Checks that Conv2DGemm produces the same results as the reference Conv2D.
+// When |filter_is_constant| is set the convolution is run twice so that the
+// second run may use the prepacked filter.
+template <typename T>
+void ExpectConv2DGemmMatchesReference(
+    const Conv2DParams& params, const RuntimeStateOptions& options = {},
+    bool filter_is_constant = false) {
+  std::vector<T> input_buffer(GetShapeElementCount(params.input_shape));
+  std::vector<T> filter_buffer(GetShapeElementCount(params.filter_shape));
+  for (size_t i = 0; i < input_buffer.size(); ++i) {
+    input_buffer[i] = static_cast<T>(static_cast<int>(i % 7) - 3);
+  }
+  for (size_t i = 0; i < filter_buffer.size(); ++i) {
+    filter_buffer[i] = static_cast<T>(static_cast<int>(i % 5) - 2);
+  }
+
+  std::vector<T> expected_dst(GetShapeElementCount(params.dst_shape), T(0));
+  IREE_ASSERT_OK(Conv2D::Execute<T>(
+      input_buffer, params.input_shape, filter_buffer, params.filter_shape,
+      absl::MakeSpan(expected_dst), params.dst_shape, params.strides,
+      params.pad_h, params.pad_w, params.lhs_dilation, params.rhs_dilation,
+      params.groups));
+
+  RuntimeState runtime_state(options);
+  const void* filter_owner = filter_is_constant ? &filter_buffer : nullptr;
+  for (int run = 0; run < (filter_is_constant ? 2 : 1); ++run) {
+    // Start with garbage in the output as it should be overwritten.
+    std::vector<T> dst_buffer(expected_dst.size(), T(1));
+    IREE_ASSERT_OK(Conv2DGemm::Execute<T>(
+        runtime_state.mat_mul_state.get(), input_buffer, params.input_shape,
+        filter_buffer, params.filter_shape, absl::MakeSpan(dst_buffer),
+        params.dst_shape, params.strides, params.pad_h, params.pad_w,
+        params.lhs_dilation, params.rhs_dilation, params.groups,
+        filter_owner));
+
+    for (size_t i = 0; i < dst_buffer.size(); ++i) {
+      EXPECT_EQ(expected_dst[i], dst_buffer[i]) << "mismatch at " << i;
+    }
+  }
+  runtime_state.ReleaseConstants(filter_owner);
+}
+
+TEST(Conv2dGemm, NoDilation) {
+  Conv2DParams params;
+  params.input_shape = {4, 5, 2};
+  params.filter_shape = {3, 2, 2, 1};
+  params.dst_shape = {2, 4, 1};
+  ExpectConv2DGemmMatchesReference<float>(params);
+  ExpectConv2DGemmMatchesReference<int8_t>(params);
+}
+
+TEST(Conv2dGemm, StridedPadded) {
+  Conv2DParams params;
+  params.input_shape = {9, 9, 3};
+  params.filter_shape = {3, 3, 3, 4};
+  params.dst_shape = {5, 5, 4};
+  params.strides = {2, 2};
+  params.pad_h = {1, 1};
+  params.pad_w = {1, 1};
+  ExpectConv2DGemmMatchesReference<float>(params);
+  ExpectConv2DGemmMatchesReference<int8_t>(params);
+}
+
+TEST(Conv2dGemm, RhsDilation) {
+  Conv2DParams params;
+  params.input_shape = {8, 8, 2};
+  params.filter_shape = {3, 3, 2, 3};
+  params.dst_shape = {4, 4, 3};
+  params.rhs_dilation = {2, 2};
+  ExpectConv2DGemmMatchesReference<float>(params);
+}
+
+TEST(Conv2dGemm, LhsDilation) {
+  Conv2DParams params;
+  params.input_shape = {4, 4, 2};
+  params.filter_shape = {3, 3, 2, 2};
+  params.dst_shape = {5, 5, 2};
+  params.lhs_dilation = {2, 2};
+  ExpectConv2DGemmMatchesReference<float>(params);
+}
+
+TEST(Conv2dGemm, Grouped) {
+  Conv2DParams params;
+  params.input_shape = {5, 5, 4};
+  params.filter_shape = {3, 3, 4, 3};
+  params.dst_shape = {3, 3, 6};
+  params.groups = 2;
+  ExpectConv2DGemmMatchesReference<float>(params);
+  ExpectConv2DGemmMatchesReference<int8_t>(params);
+  ExpectConv2DGemmMatchesReference<float>(params, {},
+                                          /*filter_is_constant=*/true);
+  ExpectConv2DGemmMatchesReference<int8_t>(params, {},
+                                           /*filter_is_constant=*/true);
+}
+
+TEST(Conv2dGemm, DepthwiseMultiplier) {
+  Conv2DParams params;
+  params.input_shape = {4, 5, 2};
+  params.filter_shape = {3, 2, 2, 2};
+  params.dst_shape = {2, 4, 4};
+  params.groups = 2;
+  ExpectConv2DGemmMatchesReference<float>(params);
+}
+
+TEST(Conv2dGemm, Depthwise) {
+  Conv2DParams params;
+  params.input_shape = {6, 6, 3};
+  params.filter_shape = {3, 3, 3, 1};
+  params.dst_shape = {4, 4, 3};
+  params.groups = 3;
+  ExpectConv2DGemmMatchesReference<float>(params);
+}
+
+TEST(Conv2dGemm, Pointwise) {
+  Conv2DParams params;
+  params.input_shape = {4, 4, 8};
+  params.filter_shape = {1, 1, 8, 5};
+  params.dst_shape = {4, 4, 5};
+  ExpectConv2DGemmMatchesReference<float>(params);
+  ExpectConv2DGemmMatchesReference<int8_t>(params);
+}
+
+TEST(Conv2dGemm, MultipleTiles) {
+  Conv2DParams params;
+  params.input_shape = {40, 40, 16};
+  params.filter_shape = {3, 3, 16, 8};
+  params.dst_shape = {38, 38, 8};
+  ExpectConv2DGemmMatchesReference<float>(params);
+}
+
+TEST(Conv2dGemm, UnsupportedType) {
+  Conv2DParams params;
+  params.input_shape = {9, 9, 3};
+  params.filter_shape = {3, 3, 3, 4};
+  params.dst_shape = {4, 4, 4};
+  params.strides = {2, 2};
+  ExpectConv2DGemmMatchesReference<int32_t>(params);
+}
+
+// Grouped filters are repacked before the GEMM; constant ones only once.
+// Runs within a tile so that scratch comes from the arena.
+TEST(Conv2dGemm, CachesPackedConstantFilter) {
+  ScratchArena::TileScope tile_scope;
+  Conv2DParams params;
+  params.input_shape = {5, 5, 4};
+  params.filter_shape = {3, 3, 4, 3};
+  params.dst_shape = {3, 3, 6};
+  params.groups = 2;
+  std::vector<float> input_buffer(GetShapeElementCount(params.input_shape));
+  std::vector<float> filter_buffer(GetShapeElementCount(params.filter_shape));
+  std::vector<float> dst_buffer(GetShapeElementCount(params.dst_shape));
+  RuntimeState runtime_state;
+  auto execute = [&](const void* filter_owner) {
+    IREE_ASSERT_OK(Conv2DGemm::Execute<float>(
+        runtime_state.mat_mul_state.get(), input_buffer, params.input_shape,
+        filter_buffer, params.filter_shape, absl::MakeSpan(dst_buffer),
+        params.dst_shape, params.strides, params.pad_h, params.pad_w,
+        params.lhs_dilation, params.rhs_dilation, params.groups,
+        filter_owner));
+  };
+  auto& prepacked_cache = runtime_state.mat_mul_state->prepacked_cache;
+
+  execute(/*filter_owner=*/nullptr);
+  EXPECT_EQ(0u, prepacked_cache.size());
+  execute(&filter_buffer);
+  execute(&filter_buffer);
+  EXPECT_EQ(1u, prepacked_cache.size());
+  runtime_state.ReleaseConstants(&filter_buffer);
+  EXPECT_EQ(0u, prepacked_cache.size());
+}
+
+TEST(Conv2dGemm, MultithreadedConstantFilter) {
+  Conv2DParams params;
+  params.input_shape = {40, 40, 16};
+  params.filter_shape = {3, 3, 16, 32};
+  params.dst_shape = {38, 38, 32};
+  RuntimeStateOptions options;
+  options.max_thread_count = 4;
+  options.enable_prepacked_cache = true;
+  ExpectConv2DGemmMatchesReference<float>(params, options,
+                                          /*filter_is_constant=*/true);
+  ExpectConv2DGemmMatchesReference<int8_t>(params, options,
+                                           /*filter_is_constant=*/true);
+}
+
 TEST(Transpose, 2Dimen) {
   Shape src_shape = {2, 3};
   Shape dst_shape = {3, 2};
@@ -579,6 +875,430 @@ TEST(Transpose, 3Dimen) {
   EXPECT_EQ(dst_buffer, expected_dst);
 }
 
+// Argsorts each row of |src| with std::stable_sort as a reference.
+template <typename T>
+std::vector<int32_t> ReferenceSort(const std::vector<T>& src,
+                                   size_t sort_size) {
+  std::vector<int32_t> dst(src.size());
+  for (size_t row = 0; row < src.size() / sort_size; ++row) {
+    auto begin = dst.begin() + row * sort_size;
+    std::iota(begin, begin + sort_size, 0);
+    const T* values = src.data() + row * sort_size;
+    std::stable_sort(begin, begin + sort_size, [values](int32_t a, int32_t b) {
+      return values[a] < values[b];
+    });
+  }
+  return dst;
+}
+
+template <typename T>
+void ExpectSortMatchesReference(size_t row_count, size_t sort_size,
+                                ThreadPool* thread_pool = nullptr) {
+  std::vector<T> src(row_count * sort_size);
+  uint32_t state = 12345;
+  for (auto& value : src) {
+    state = state * 1664525u + 1013904223u;
+    // Mix of small (many duplicates) and full range values.
+    value = (state & 0x100)
+                ? static_cast<T>(static_cast<int>(state >> 24) - 128)
+                : static_cast<T>(state);
+  }
+  Shape shape = {static_cast<int32_t>(row_count),
+                 static_cast<int32_t>(sort_size)};
+  std::vector<int32_t> dst(src.size());
+  IREE_EXPECT_OK(
+      Sort::Execute<T>(src, absl::MakeSpan(dst), shape, thread_pool));
+  EXPECT_EQ(ReferenceSort(src, sort_size), dst);
+}
+
+TEST(Sort, SmallRows) {
+  ExpectSortMatchesReference<int8_t>(3, 17);
+  ExpectSortMatchesReference<int16_t>(3, 17);
+  ExpectSortMatchesReference<int32_t>(3, 17);
+  ExpectSortMatchesReference<uint32_t>(3, 17);
+  ExpectSortMatchesReference<float>(3, 17);
+  ExpectSortMatchesReference<double>(3, 17);
+}
+
+TEST(Sort, LargeRows) {
+  ExpectSortMatchesReference<int8_t>(2, 5000);
+  ExpectSortMatchesReference<int16_t>(2, 5000);
+  ExpectSortMatchesReference<int32_t>(2, 30000);
+  ExpectSortMatchesReference<uint32_t>(2, 30000);
+  ExpectSortMatchesReference<float>(2, 30000);
+  ExpectSortMatchesReference<double>(2, 30000);
+}
+
+TEST(Sort, ManyRows) {
+  ExpectSortMatchesReference<int32_t>(37, 10000);
+  ExpectSortMatchesReference<float>(37, 10000);
+  ExpectSortMatchesReference<double>(37, 10000);
+}
+
+// Each slice blocks until all slices have started, so this only completes if
+// the rows are split across max_concurrency() threads running at once.
+TEST(Sort, ParallelForRowsRunsConcurrently) {
+  ThreadPool thread_pool(3);
+  struct Barrier {
+    int count;
+    int started_count;
+  } barrier = {thread_pool.max_concurrency(), 0};
+  absl::Mutex mutex;
+  std::set<std::thread::id> thread_ids;
+  std::vector<int> row_slices(100, -1);
+  impl::ParallelForRows(
+      &thread_pool, row_slices.size(), 10, [&](size_t begin, size_t end) {
+        absl::MutexLock lock(&mutex);
+        ++barrier.started_count;
+        thread_ids.insert(std::this_thread::get_id());
+        for (size_t row = begin; row < end; ++row) {
+          EXPECT_EQ(-1, row_slices[row]);
+          row_slices[row] = static_cast<int>(begin);
+        }
+        mutex.Await(absl::Condition(
+            +[](Barrier* barrier) {
+              return barrier->started_count == barrier->count;
+            },
+            &barrier));
+      });
+  EXPECT_EQ(barrier.count, thread_ids.size());
+  for (int row_slice : row_slices) EXPECT_NE(-1, row_slice);
+}
+
+// Sized so that rows are split across all threads of the pool.
+TEST(Sort, Multithreaded) {
+  ThreadPool thread_pool(3);
+  ExpectSortMatchesReference<int32_t>(8, 40000, &thread_pool);
+  ExpectSortMatchesReference<float>(8, 40000, &thread_pool);
+  ExpectSortMatchesReference<double>(8, 40000, &thread_pool);
+  ExpectSortMatchesReference<int16_t>(300, 1000, &thread_pool);
+}
+
+TEST(Sort, FloatSpecialValues) {
+  const float kInf = std::numeric_limits<float>::infinity();
+  const float kNaN = std::numeric_limits<float>::quiet_NaN();
+  std::vector<float> row = {0.0f, kNaN, -0.0f, -kInf, 1.0f, kInf, -1.0f, 0.0f};
+  // Both the merge (short row) and radix (long row) paths.
+  for (size_t sort_size : {row.size(), size_t{512}}) {
+    SCOPED_TRACE(sort_size);
+    std::vector<float> src(sort_size, 2.0f);
+    std::copy(row.begin(), row.end(), src.begin());
+    Shape shape = {static_cast<int32_t>(sort_size)};
+    std::vector<int32_t> dst(sort_size);
+    IREE_EXPECT_OK(Sort::Execute<float>(src, absl::MakeSpan(dst), shape));
+    std::vector<int32_t> expected_head = {3, 6, 0, 2, 7, 4};
+    EXPECT_EQ(expected_head,
+              std::vector<int32_t>(dst.begin(), dst.begin() + 6));
+    EXPECT_EQ(5, dst[sort_size - 2]);
+    EXPECT_EQ(1, dst[sort_size - 1]);
+  }
+}
+
+TEST(Sort, Empty) {
+  std::vector<float> src;
+  std::vector<int32_t> dst;
+  Shape shape = {4, 0};
+  IREE_EXPECT_OK(Sort::Execute<float>(src, absl::MakeSpan(dst), shape));
+}
+
+// Runs |fn| once with each instruction set the elementwise kernels support on
+// this machine (or once with the generic kernels if there is no SIMD layer).
+template <typename Fn>
+void ForEachElementwiseIsa(Fn fn) {
+#if defined(IREE_VMLA_SIMD_X86) || defined(IREE_VMLA_SIMD_NEON)
+  simd::Isa detected_isa = simd::GetActiveIsa();
+  for (auto isa : {simd::Isa::kSse2, simd::Isa::kAvx2, simd::Isa::kNeon}) {
+    if (!simd::IsIsaSupported(isa)) continue;
+    SCOPED_TRACE(simd::GetIsaName(isa));
+    simd::SetActiveIsaForTesting(isa);
+    fn();
+  }
+  simd::SetActiveIsaForTesting(detected_isa);
+#else
+  fn();
+#endif  // IREE_VMLA_SIMD_X86 || IREE_VMLA_SIMD_NEON
+}
+
+// Lengths covering empty buffers, partial vectors and vectors plus tails.
+const size_t kElementwiseLengths[] = {0, 1, 3, 4, 5, 7, 8, 9, 15, 16, 17, 33};
+
+// Interesting float values (including the special ones) cycled through the
+// test buffers; lhs and rhs use different offsets so all pairs are mixed.
+const float kSpecialFloats[] = {
+    0.0f,
+    -0.0f,
+    1.0f,
+    -1.5f,
+    3.25f,
+    -1e-3f,
+    1e30f,
+    -1e30f,
+    1e-40f,  // denormal
+    std::numeric_limits<float>::infinity(),
+    -std::numeric_limits<float>::infinity(),
+    std::numeric_limits<float>::quiet_NaN(),
+    7.0f,
+};
+constexpr size_t kSpecialFloatCount =
+    sizeof(kSpecialFloats) / sizeof(kSpecialFloats[0]);
+
+std::vector<float> MakeSpecialFloats(size_t size, size_t offset) {
+  std::vector<float> v(size);
+  for (size_t i = 0; i < size; ++i) {
+    v[i] = kSpecialFloats[(i * 5 + offset) % kSpecialFloatCount];
+  }
+  return v;
+}
+
+std::vector<int32_t> MakeMixedInts(size_t size, int32_t seed,
+                                   bool include_limits = true) {
+  std::vector<int32_t> v(size);
+  for (size_t i = 0; i < size; ++i) {
+    v[i] = static_cast<int32_t>((i * 7919 + seed) % 17) - 8;
+  }
+  if (include_limits && size > 0) v[0] = std::numeric_limits<int32_t>::min();
+  if (include_limits && size > 2) v[2] = std::numeric_limits<int32_t>::max();
+  return v;
+}
+
+// Compares floats bitwise, treating all NaNs as equal.
+void ExpectSameFloats(const std::vector<float>& expected,
+                      const std::vector<float>& actual) {
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    if (std::isnan(expected[i])) {
+      EXPECT_TRUE(std::isnan(actual[i])) << "at " << i;
+    } else {
+      uint32_t expected_bits, actual_bits;
+      std::memcpy(&expected_bits, &expected[i], sizeof(expected_bits));
+      std::memcpy(&actual_bits, &actual[i], sizeof(actual_bits));
+      EXPECT_EQ(expected_bits, actual_bits)
+          << "at " << i << ": " << expected[i] << " vs " << actual[i];
+    }
+  }
+}
+
+template <typename Kernel>
+void ExpectBinaryMatches(const std::vector<float>& lhs,
+                         const std::vector<float>& rhs,
+                         float (*scalar_fn)(float, float)) {
+  std::vector<float> expected(lhs.size());
+  for (size_t i = 0; i < lhs.size(); ++i) {
+    expected[i] = scalar_fn(lhs[i], rhs[i]);
+  }
+  std::vector<float> actual(lhs.size());
+  IREE_EXPECT_OK(
+      Kernel::template Execute<float>(lhs, rhs, absl::MakeSpan(actual)));
+  ExpectSameFloats(expected, actual);
+}
+
+TEST(Elementwise, BinaryF32) {
+  ForEachElementwiseIsa([]() {
+    for (size_t length : kElementwiseLengths) {
+      SCOPED_TRACE(length);
+      auto lhs = MakeSpecialFloats(length, 0);
+      auto rhs = MakeSpecialFloats(length, 3);
+      ExpectBinaryMatches<Add>(lhs, rhs,
+                               [](float a, float b) { return a + b; });
+      ExpectBinaryMatches<Sub>(lhs, rhs,
+                               [](float a, float b) { return a - b; });
+      ExpectBinaryMatches<Mul>(lhs, rhs,
+                               [](float a, float b) { return a * b; });
+      ExpectBinaryMatches<Div>(lhs, rhs,
+                               [](float a, float b) { return a / b; });
+      ExpectBinaryMatches<Min>(
+          lhs, rhs, [](float a, float b) { return std::min(a, b); });
+      ExpectBinaryMatches<Max>(
+          lhs, rhs, [](float a, float b) { return std::max(a, b); });
+    }
+  });
+}
+
+TEST(Elementwise, BinaryI32) {
+  ForEachElementwiseIsa([]() {
+    for (size_t length : kElementwiseLengths) {
+      SCOPED_TRACE(length);
+      auto lhs = MakeMixedInts(length, 1);
+      auto rhs = MakeMixedInts(length, 5);
+      std::vector<int32_t> dst(length);
+      IREE_EXPECT_OK(Min::Execute<int32_t>(lhs, rhs, absl::MakeSpan(dst)));
+      for (size_t i = 0; i < length; ++i) {
+        EXPECT_EQ(std::min(lhs[i], rhs[i]), dst[i]);
+      }
+      IREE_EXPECT_OK(Max::Execute<int32_t>(lhs, rhs, absl::MakeSpan(dst)));
+      for (size_t i = 0; i < length; ++i) {
+        EXPECT_EQ(std::max(lhs[i], rhs[i]), dst[i]);
+      }
+      // Avoid signed overflow in the reference.
+      lhs = MakeMixedInts(length, 1, /*include_limits=*/false);
+      rhs = MakeMixedInts(length, 5, /*include_limits=*/false);
+      IREE_EXPECT_OK(Add::Execute<int32_t>(lhs, rhs, absl::MakeSpan(dst)));
+      for (size_t i = 0; i < length; ++i) {
+        EXPECT_EQ(lhs[i] + rhs[i], dst[i]);
+      }
+      IREE_EXPECT_OK(Sub::Execute<int32_t>(lhs, rhs, absl::MakeSpan(dst)));
+      for (size_t i = 0; i < length; ++i) {
+        EXPECT_EQ(lhs[i] - rhs[i], dst[i]);
+      }
+    }
+  });
+}
+
+template <typename T>
+void ExpectComparesMatch(const std::vector<T>& lhs, const std::vector<T>& rhs) {
+  std::vector<uint8_t> dst(lhs.size());
+  auto expect_matches = [&](const char* name, bool (*scalar_fn)(T, T)) {
+    SCOPED_TRACE(name);
+    for (size_t i = 0; i < lhs.size(); ++i) {
+      EXPECT_EQ(scalar_fn(lhs[i], rhs[i]) ? 1u : 0u, dst[i]) << "at " << i;
+    }
+  };
+  IREE_EXPECT_OK(CompareEQ::Execute<T>(lhs, rhs, absl::MakeSpan(dst)));
+  expect_matches("eq", [](T a, T b) { return a == b; });
+  IREE_EXPECT_OK(CompareNE::Execute<T>(lhs, rhs, absl::MakeSpan(dst)));
+  expect_matches("ne", [](T a, T b) { return a != b; });
+  IREE_EXPECT_OK(CompareLT::Execute<T>(lhs, rhs, absl::MakeSpan(dst)));
+  expect_matches("lt", [](T a, T b) { return a < b; });
+  IREE_EXPECT_OK(CompareLE::Execute<T>(lhs, rhs, absl::MakeSpan(dst)));
+  expect_matches("le", [](T a, T b) { return a <= b; });
+  IREE_EXPECT_OK(CompareGT::Execute<T>(lhs, rhs, absl::MakeSpan(dst)));
+  expect_matches("gt", [](T a, T b) { return a > b; });
+  IREE_EXPECT_OK(CompareGE::Execute<T>(lhs, rhs, absl::MakeSpan(dst)));
+  expect_matches("ge", [](T a, T b) { return a >= b; });
+}
+
+TEST(Elementwise, Compare) {
+  ForEachElementwiseIsa([]() {
+    for (size_t length : kElementwiseLengths) {
+      SCOPED_TRACE(length);
+      ExpectComparesMatch<float>(MakeSpecialFloats(length, 0),
+                                 MakeSpecialFloats(length, 2));
+      ExpectComparesMatch<int32_t>(MakeMixedInts(length, 0),
+                                   MakeMixedInts(length, 3));
+    }
+  });
+}
+
+TEST(Elementwise, Select) {
+  ForEachElementwiseIsa([]() {
+    for (size_t length : kElementwiseLengths) {
+      SCOPED_TRACE(length);
+      std::vector<uint8_t> cond(length);
+      std::vector<uint32_t> lhs(length), rhs(length), dst(length);
+      for (size_t i = 0; i < length; ++i) {
+        // Any non-zero value is true.
+        cond[i] = (i % 3 == 0) ? 0 : static_cast<uint8_t>(i * 37);
+        lhs[i] = 0x80000000u + static_cast<uint32_t>(i);
+        rhs[i] = static_cast<uint32_t>(i);
+      }
+      IREE_EXPECT_OK(
+          Select::Execute<uint32_t>(cond, lhs, rhs, absl::MakeSpan(dst)));
+      for (size_t i = 0; i < length; ++i) {
+        EXPECT_EQ(cond[i] ? lhs[i] : rhs[i], dst[i]) << "at " << i;
+      }
+    }
+  });
+}
+
+template <typename T>
+void ExpectBitwiseMatches(size_t length) {
+  std::vector<T> lhs(length), rhs(length), dst(length);
+  for (size_t i = 0; i < length; ++i) {
+    lhs[i] = static_cast<T>(0x9E3779B9u * (i + 1));
+    rhs[i] = static_cast<T>(0x85EBCA6Bu * (i + 3));
+  }
+  const T scalar = static_cast<T>(0xA5C3F00Fu);
+  IREE_EXPECT_OK(And::Execute<T>(lhs, rhs, absl::MakeSpan(dst)));
+  for (size_t i = 0; i < length; ++i) EXPECT_EQ(T(lhs[i] & rhs[i]), dst[i]);
+  IREE_EXPECT_OK(Or::Execute<T>(lhs, rhs, absl::MakeSpan(dst)));
+  for (size_t i = 0; i < length; ++i) EXPECT_EQ(T(lhs[i] | rhs[i]), dst[i]);
+  IREE_EXPECT_OK(Xor::Execute<T>(lhs, rhs, absl::MakeSpan(dst)));
+  for (size_t i = 0; i < length; ++i) EXPECT_EQ(T(lhs[i] ^ rhs[i]), dst[i]);
+  IREE_EXPECT_OK(And::Execute<T>(lhs, scalar, absl::MakeSpan(dst)));
+  for (size_t i = 0; i < length; ++i) EXPECT_EQ(T(lhs[i] & scalar), dst[i]);
+  IREE_EXPECT_OK(Xor::Execute<T>(lhs, scalar, absl::MakeSpan(dst)));
+  for (size_t i = 0; i < length; ++i) EXPECT_EQ(T(lhs[i] ^ scalar), dst[i]);
+}
+
+TEST(Elementwise, Bitwise) {
+  ForEachElementwiseIsa([]() {
+    for (size_t length : kElementwiseLengths) {
+      SCOPED_TRACE(length);
+      ExpectBitwiseMatches<uint8_t>(length);
+      ExpectBitwiseMatches<uint16_t>(length);
+      ExpectBitwiseMatches<uint32_t>(length);
+    }
+  });
+}
+
+TEST(Elementwise, AbsNeg) {
+  ForEachElementwiseIsa([]() {
+    auto src = MakeSpecialFloats(kSpecialFloatCount * 2, 0);
+    std::vector<float> dst(src.size()), expected(src.size());
+    IREE_EXPECT_OK(Abs::Execute<float>(src, absl::MakeSpan(dst)));
+    for (size_t i = 0; i < src.size(); ++i) expected[i] = std::abs(src[i]);
+    ExpectSameFloats(expected, dst);
+    IREE_EXPECT_OK(Neg::Execute<float>(src, absl::MakeSpan(dst)));
+    for (size_t i = 0; i < src.size(); ++i) expected[i] = -src[i];
+    ExpectSameFloats(expected, dst);
+  });
+}
+
+// Checks a fast approximation against the double precision |reference| at
+// values spanning the whole float range plus the special values.
+template <typename Kernel>
+void ExpectApproximates(double (*reference)(double), float min_value,
+                        float max_value, float max_ulps) {
+  std::vector<float> src = MakeSpecialFloats(kSpecialFloatCount, 0);
+  for (float x = min_value; x < max_value;
+       x += (max_value - min_value) / 9973.0f) {
+    src.push_back(x);
+  }
+  for (float x = 1e-38f; x < 1e38f; x *= 1.7f) {
+    src.push_back(x);
+    src.push_back(-x);
+  }
+  std::vector<float> dst(src.size());
+  IREE_EXPECT_OK(Kernel::template Execute<float>(src, absl::MakeSpan(dst)));
+  for (size_t i = 0; i < src.size(); ++i) {
+    float expected = static_cast<float>(reference(src[i]));
+    if (std::isnan(expected)) {
+      EXPECT_TRUE(std::isnan(dst[i])) << "for " << src[i];
+    } else if (std::isinf(expected) || expected == 0.0f) {
+      EXPECT_EQ(expected, dst[i]) << "for " << src[i];
+      EXPECT_EQ(std::signbit(expected), std::signbit(dst[i]))
+          << "for " << src[i];
+    } else {
+      // Denormal results have fewer bits of precision.
+      float ulp = std::max(std::abs(expected) *
+                               std::numeric_limits<float>::epsilon(),
+                           std::numeric_limits<float>::denorm_min());
+      EXPECT_NEAR(expected, dst[i], max_ulps * ulp) << "for " << src[i];
+    }
+  }
+}
+
+TEST(Elementwise, Exp) {
+  ForEachElementwiseIsa([]() {
+    ExpectApproximates<Exp>([](double x) { return std::exp(x); }, -110.0f,
+                            90.0f, 2.0f);
+  });
+}
+
+TEST(Elementwise, Log) {
+  ForEachElementwiseIsa([]() {
+    ExpectApproximates<Log>([](double x) { return std::log(x); }, 1e-6f,
+                            100.0f, 2.0f);
+  });
+}
+
+TEST(Elementwise, Tanh) {
+  ForEachElementwiseIsa([]() {
+    ExpectApproximates<Tanh>([](double x) { return std::tanh(x); }, -10.0f,
+                             10.0f, 2.0f);
+  });
+}
+
 }  // namespace
 }  // namespace kernels
 }  // namespace vmla
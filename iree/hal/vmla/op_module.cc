@@ -19,6 +19,7 @@
 #include "absl/types/span.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/vmla/op_kernels.h"
+#include "iree/hal/vmla/scratch_arena.h"
 #include "iree/vm/module_abi_packing.h"
 
 //===----------------------------------------------------------------------===//
@@ -91,6 +92,15 @@ StatusOr<vm::ref<Buffer>> Buffer::WrapMutable(void* data, size_t data_length,
   return std::move(buffer);
 }
 
+// static
+StatusOr<vm::ref<Buffer>> Buffer::WrapConstant(const void* data,
+                                               size_t data_length,
+                                               iree_allocator_t allocator) {
+  IREE_ASSIGN_OR_RETURN(auto buffer, Wrap(data, data_length, allocator));
+  buffer->is_constant_ = true;
+  return std::move(buffer);
+}
+
 Buffer::~Buffer() {
   if (!parent_) {
     iree_allocator_free(allocator_, data_);
@@ -192,7 +202,12 @@ class VMLAModuleState final {
                   kernels::RuntimeState* kernel_state)
       : allocator_(allocator), kernel_state_(kernel_state) {}
 
-  ~VMLAModuleState() = default;
+  // Binds the state to the executable whose rodata constant buffers passed to
+  // it live in. Kernels only cache data derived from constant buffers once
+  // bound, as the cache is released per executable.
+  void BindExecutable(const void* executable_key) {
+    executable_key_ = executable_key;
+  }
 
   //===--------------------------------------------------------------------===//
   // vmla.interface.*
@@ -224,18 +239,22 @@ class VMLAModuleState final {
     external_allocator.free = +[](void* self, void* ptr) {
       vm::assign_ref(reinterpret_cast<iree_vm_ro_byte_buffer_t*>(self)).reset();
     };
-    return Buffer::Wrap(value->data.data, value->data.data_length,
-                        external_allocator);
+    return Buffer::WrapConstant(value->data.data, value->data.data_length,
+                                external_allocator);
   }
 
   StatusOr<vm::ref<Buffer>> BufferAlloc(iree_vmla_size_t byte_length) {
     IREE_TRACE_SCOPE0("VMLAModuleState::BufferAlloc");
-    return Buffer::Allocate(byte_length, allocator_);
+    return Buffer::Allocate(
+        byte_length, ScratchArena::AllocatorFor(byte_length, allocator_));
   }
 
   StatusOr<vm::ref<Buffer>> BufferClone(const vm::ref<Buffer>& src) {
     IREE_TRACE_SCOPE0("VMLAModuleState::BufferClone");
-    IREE_ASSIGN_OR_RETURN(auto dst, Buffer::Allocate(src->size(), allocator_));
+    IREE_ASSIGN_OR_RETURN(
+        auto dst,
+        Buffer::Allocate(src->size(),
+                         ScratchArena::AllocatorFor(src->size(), allocator_)));
     std::memcpy(dst->data(), src->data(), dst->size());
     return std::move(dst);
   }
@@ -280,6 +299,9 @@ class VMLAModuleState final {
     external_allocator.free = +[](void* self, void* ptr) {
       vm::assign_ref(reinterpret_cast<Buffer*>(self)).reset();
     };
+    if (src->is_constant()) {
+      return Buffer::WrapConstant(data, data_length, external_allocator);
+    }
     return Buffer::Wrap(data, data_length, external_allocator);
   }
 
@@ -647,7 +669,8 @@ class VMLAModuleState final {
               const vm::ref<Buffer>& dst) {                                  \
     IREE_TRACE_SCOPE0("VMLAModuleState::" #name);                            \
     return kernels::Sort::Execute<type>(src->As<type>(), dst->As<int32_t>(), \
-                                        src_shape);                          \
+                                        src_shape,                           \
+                                        &kernel_state_->thread_pool);        \
   }
 
   IREE_VMLA_SORT_OP(SortI8, int8_t);
@@ -695,15 +718,16 @@ class VMLAModuleState final {
   // VMLA Ops: Convolution
   //===--------------------------------------------------------------------===//
 
-  Status ConvF32F32F32(
-      const vm::ref<Buffer>& input, iree_vmla_shape_t input_shape,
-      const vm::ref<Buffer>& filter, iree_vmla_shape_t filter_shape,
-      const vm::ref<Buffer>& dst, iree_vmla_shape_t dst_shape,
-      absl::Span<const int32_t> window_strides,
-      absl::Span<const int32_t> padding, absl::Span<const int32_t> lhs_dilation,
-      absl::Span<const int32_t> rhs_dilation, const int32_t feature_group_count,
-      const int32_t batch_group_count) {
-    IREE_TRACE_SCOPE0("VMLAModuleState::ConvF32F32F32");
+  template <typename T>
+  Status Conv(const vm::ref<Buffer>& input, iree_vmla_shape_t input_shape,
+              const vm::ref<Buffer>& filter, iree_vmla_shape_t filter_shape,
+              const vm::ref<Buffer>& dst, iree_vmla_shape_t dst_shape,
+              absl::Span<const int32_t> window_strides,
+              absl::Span<const int32_t> padding,
+              absl::Span<const int32_t> lhs_dilation,
+              absl::Span<const int32_t> rhs_dilation,
+              const int32_t feature_group_count,
+              const int32_t batch_group_count) {
     if (input_shape.size() != 4 || filter_shape.size() != 4 ||
         dst_shape.size() != 4) {
       return InvalidArgumentErrorBuilder(IREE_LOC)
@@ -718,9 +742,9 @@ class VMLAModuleState final {
     const auto pad_w = padding.subspan(2, 2);
     const auto window_strides_2d = window_strides.subspan(0, 2);
 
-    const float* raw_inputs_data = input->As<float>().data();
-    const float* raw_filter_data = filter->As<float>().data();
-    float* raw_dst_data = dst->As<float>().data();
+    const T* raw_inputs_data = input->As<T>().data();
+    const T* raw_filter_data = filter->As<T>().data();
+    T* raw_dst_data = dst->As<T>().data();
     auto filter_buffer = absl::MakeConstSpan(
         raw_filter_data, kernels::GetElementCount(filter_shape_4d));
 
@@ -732,15 +756,34 @@ class VMLAModuleState final {
           absl::MakeConstSpan(raw_inputs_data + i * input_stride, input_stride);
       auto output_example =
           absl::MakeSpan(raw_dst_data + i * output_stride, output_stride);
-      IREE_RETURN_IF_ERROR(kernels::Conv2D::Execute(
-          input_example, input_example_shape, filter_buffer, filter_shape_4d,
-          output_example, output_example_shape, window_strides_2d, pad_h, pad_w,
+      IREE_RETURN_IF_ERROR(kernels::Conv2DGemm::Execute(
+          kernel_state_->mat_mul_state.get(), input_example,
+          input_example_shape, filter_buffer, filter_shape_4d, output_example,
+          output_example_shape, window_strides_2d, pad_h, pad_w,
           lhs_dilation.subspan(0, 2), rhs_dilation.subspan(0, 2),
-          feature_group_count));
+          feature_group_count, ConstantOwner(*filter)));
     }
     return OkStatus();
   }
 
+#define IREE_VMLA_CONV_OP(name, type)                                        \
+  Status name(const vm::ref<Buffer>& input, iree_vmla_shape_t input_shape,   \
+              const vm::ref<Buffer>& filter, iree_vmla_shape_t filter_shape, \
+              const vm::ref<Buffer>& dst, iree_vmla_shape_t dst_shape,       \
+              absl::Span<const int32_t> window_strides,                      \
+              absl::Span<const int32_t> padding,                             \
+              absl::Span<const int32_t> lhs_dilation,                        \
+              absl::Span<const int32_t> rhs_dilation,                        \
+              const int32_t feature_group_count,                             \
+              const int32_t batch_group_count) {                             \
+    IREE_TRACE_SCOPE0("VMLAModuleState::" #name);                            \
+    return Conv<type>(input, input_shape, filter, filter_shape, dst,         \
+                      dst_shape, window_strides, padding, lhs_dilation,      \
+                      rhs_dilation, feature_group_count, batch_group_count); \
+  }
+  IREE_VMLA_CONV_OP(ConvI8I8I8, int8_t);
+  IREE_VMLA_CONV_OP(ConvF32F32F32, float);
+
   //===--------------------------------------------------------------------===//
   // VMLA Ops: GEMM/GEMV
   //===--------------------------------------------------------------------===//
@@ -781,6 +824,8 @@ class VMLAModuleState final {
       buffers.dst_buffer = absl::MakeSpan(dst_batch_base + i * dst_batch_stride,
                                           dst_batch_stride);
       buffers.dst_shape = dst_batch_element_shape2;
+      buffers.lhs_is_constant = ConstantOwner(*lhs) != nullptr;
+      buffers.rhs_is_constant = ConstantOwner(*rhs) != nullptr;
 
       IREE_RETURN_IF_ERROR(kernels::MatMul::Execute(
           kernel_state_->mat_mul_state.get(), buffers));
@@ -842,13 +887,22 @@ class VMLAModuleState final {
   IREE_VMLA_POOLING_OP(PoolingMaxF32, kernels::PoolingMax, float);
 
  private:
+  // Returns the executable owning |buffer| if its contents are constant and
+  // may be cached by kernels, or nullptr.
+  const void* ConstantOwner(const Buffer& buffer) const {
+    return buffer.is_constant() ? executable_key_ : nullptr;
+  }
+
   iree_allocator_t allocator_;
 
-  // NOTE: kernel state must be externally synchronized as it is shared across
-  // all contexts using the VMLA module. This is fine in our current design as
-  // we only ever execute a single context at a time but if we start to allow
-  // concurrency across contexts we'll need to introduce locks.
-  kernels::RuntimeState* kernel_state_ = nullptr;
+  // Device-level kernel state owned by the VMLAModule and shared by the states
+  // of all contexts.
+  kernels::RuntimeState* kernel_state_;
+
+  // Executable whose rodata constant buffers are views into. Kernels key data
+  // cached for constants on it so that it can be released with the executable
+  // before the memory is reused.
+  const void* executable_key_ = nullptr;
 };
 
 //===----------------------------------------------------------------------===//
@@ -1049,6 +1103,7 @@ static const vm::NativeFunction<VMLAModuleState> kVMLAModuleFunctions[] = {
     vm::MakeNativeFunction("batch.matmul.f32f32.f32",
                            &VMLAModuleState::BatchMatMulF32F32F32),
 
+    vm::MakeNativeFunction("conv.i8i8.i8", &VMLAModuleState::ConvI8I8I8),
     vm::MakeNativeFunction("conv.f32f32.f32", &VMLAModuleState::ConvF32F32F32)};
 
 // Per-device VMLA module.
@@ -1060,9 +1115,11 @@ static const vm::NativeFunction<VMLAModuleState> kVMLAModuleFunctions[] = {
 // Thread-safe.
 class VMLAModule final : public vm::NativeModule<VMLAModuleState> {
  public:
-  explicit VMLAModule(iree_allocator_t allocator)
+  VMLAModule(const kernels::RuntimeStateOptions& options,
+             iree_allocator_t allocator)
       : vm::NativeModule<VMLAModuleState>(
-            "vmla", allocator, absl::MakeConstSpan(kVMLAModuleFunctions)) {}
+            "vmla", allocator, absl::MakeConstSpan(kVMLAModuleFunctions)),
+        kernel_state_(options) {}
   ~VMLAModule() = default;
 
   Status Initialize() {
@@ -1077,26 +1134,51 @@ class VMLAModule final : public vm::NativeModule<VMLAModuleState> {
     return state;
   }
 
+  kernels::RuntimeState* kernel_state() { return &kernel_state_; }
+
  private:
-  // NOTE: shared across all contexts with the VMLA module loaded. See
-  // VMLAModuleState::kernel_state_ for more information.
+  // Kernel runtime state (thread pool, prepacked caches) shared by all
+  // contexts the module is loaded into.
   kernels::RuntimeState kernel_state_;
 };
 
 }  // namespace
 
 Status ModuleCreate(iree_allocator_t allocator, iree_vm_module_t** out_module) {
+  return ModuleCreate(kernels::RuntimeStateOptions{}, allocator, out_module);
+}
+
+Status ModuleCreate(const kernels::RuntimeStateOptions& options,
+                    iree_allocator_t allocator, iree_vm_module_t** out_module) {
   if (!out_module) {
     return InvalidArgumentErrorBuilder(IREE_LOC)
            << "out_module must not be null";
   }
   *out_module = nullptr;
-  auto module = std::make_unique<VMLAModule>(allocator);
+  auto module = std::make_unique<VMLAModule>(options, allocator);
   IREE_RETURN_IF_ERROR(module->Initialize());
   *out_module = module.release()->interface();
   return OkStatus();
 }
 
+Status ModuleStateBindExecutable(iree_vm_context_t* context,
+                                 iree_vm_module_t* vmla_module,
+                                 const void* executable_key) {
+  iree_vm_module_state_t* module_state = nullptr;
+  IREE_RETURN_IF_ERROR(iree_vm_context_resolve_module_state(
+      context, vmla_module, &module_state));
+  reinterpret_cast<VMLAModuleState*>(module_state)
+      ->BindExecutable(executable_key);
+  return OkStatus();
+}
+
+void ModuleReleaseExecutable(iree_vm_module_t* vmla_module,
+                             const void* executable_key) {
+  auto* module = static_cast<VMLAModule*>(
+      reinterpret_cast<vm::NativeModule<VMLAModuleState>*>(vmla_module->self));
+  module->kernel_state()->ReleaseConstants(executable_key);
+}
+
 }  // namespace vmla
 }  // namespace hal
 }  // namespace iree
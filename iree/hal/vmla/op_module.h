@@ -33,6 +33,10 @@ namespace iree {
 namespace hal {
 namespace vmla {
 
+namespace kernels {
+struct RuntimeStateOptions;
+}  // namespace kernels
+
 using iree_vmla_size_t = uint32_t;
 using iree_vmla_shape_t = absl::Span<const int32_t>;
 
@@ -59,12 +63,23 @@ class Buffer final : public RefObject<Buffer> {
   static StatusOr<vm::ref<Buffer>> WrapMutable(void* data, size_t data_length,
                                                iree_allocator_t allocator);
 
+  // Wraps immutable data (such as executable rodata) whose contents will not
+  // change for the lifetime of the buffer. See is_constant.
+  static StatusOr<vm::ref<Buffer>> WrapConstant(const void* data,
+                                                size_t data_length,
+                                                iree_allocator_t allocator);
+
   ~Buffer();
 
   constexpr const void* data() const { return data_; }
   constexpr void* data() { return data_; }
   constexpr size_t size() const { return data_length_; }
 
+  // True if the contents are immutable for the lifetime of the buffer.
+  // Kernels may cache data derived from constant buffers keyed on their
+  // address.
+  bool is_constant() const { return is_constant_; }
+
   template <typename T>
   absl::Span<const T> As() const {
     return absl::MakeConstSpan(reinterpret_cast<const T*>(data_),
@@ -92,6 +107,7 @@ class Buffer final : public RefObject<Buffer> {
   void* data_ = nullptr;
   size_t data_length_ = 0;
   iree_allocator_t allocator_;
+  bool is_constant_ = false;
 };
 
 class Interface final : public RefObject<Interface> {
@@ -127,8 +143,28 @@ class Interface final : public RefObject<Interface> {
 
 Status ModuleRegisterTypes();
 
+// Creates a VMLA module with the default kernel runtime state options.
 Status ModuleCreate(iree_allocator_t allocator, iree_vm_module_t** out_module);
 
+// Creates a VMLA module whose kernels use runtime state (thread pools, caches,
+// etc) configured by |options|. The runtime state is owned by the module and
+// shared by all contexts it is loaded into.
+Status ModuleCreate(const kernels::RuntimeStateOptions& options,
+                    iree_allocator_t allocator, iree_vm_module_t** out_module);
+
+// Binds the state of |vmla_module| in |context| to |executable_key|, the
+// executable whose rodata the constant buffers seen by the context live in.
+// Kernels only cache data derived from constant buffers of bound contexts.
+Status ModuleStateBindExecutable(iree_vm_context_t* context,
+                                 iree_vm_module_t* vmla_module,
+                                 const void* executable_key);
+
+// Drops everything kernels of |vmla_module| cached for constants of
+// |executable_key|. Must be called once all contexts bound to the executable
+// have been released and before its rodata is freed.
+void ModuleReleaseExecutable(iree_vm_module_t* vmla_module,
+                             const void* executable_key);
+
 }  // namespace vmla
 }  // namespace hal
 }  // namespace iree
@@ -16,8 +16,16 @@
 
 #include <inttypes.h>
 
+#include "absl/flags/flag.h"
+#include "iree/hal/host/task/shared_executor.h"
 #include "iree/hal/vmla/vmla_driver.h"
 
+ABSL_FLAG(int, vmla_max_thread_count, 1,
+          "Maximum number of threads a single VMLA kernel may use. Values <= 0 "
+          "use all available hardware threads.");
+ABSL_FLAG(bool, vmla_prepacked_cache, true,
+          "Caches packed constant GEMM operands (weights) across dispatches.");
+
 #define IREE_HAL_VMLA_DRIVER_ID 0x564D4C41u  // VMLA
 
 static iree_status_t iree_hal_vmla_driver_factory_enumerate(
@@ -42,7 +50,19 @@ static iree_status_t iree_hal_vmla_driver_factory_try_create(
                             " is provided by this factory",
                             driver_id);
   }
-  IREE_ASSIGN_OR_RETURN(auto driver, iree::hal::vmla::VMLADriver::Create());
+  IREE_ASSIGN_OR_RETURN(auto executor,
+                        iree::hal::host::AcquireSharedTaskExecutor());
+  iree::hal::vmla::VMLADeviceOptions device_options;
+  device_options.max_kernel_thread_count =
+      absl::GetFlag(FLAGS_vmla_max_thread_count);
+  device_options.enable_prepacked_cache =
+      absl::GetFlag(FLAGS_vmla_prepacked_cache);
+  device_options.queue_worker_count =
+      iree::hal::host::GetHostQueueWorkerCount();
+  auto driver_or =
+      iree::hal::vmla::VMLADriver::Create(executor, device_options);
+  if (executor) iree_task_executor_release(executor);
+  IREE_ASSIGN_OR_RETURN(auto driver, std::move(driver_or));
   *out_driver = reinterpret_cast<iree_hal_driver_t*>(driver.release());
   return iree_ok_status();
 }
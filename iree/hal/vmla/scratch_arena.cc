@@ -0,0 +1,134 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/vmla/scratch_arena.h"
+
+#include <atomic>
+#include <cstring>
+
+#include "iree/base/arena.h"
+#include "iree/base/tracing.h"
+
+namespace iree {
+namespace hal {
+namespace vmla {
+
+namespace {
+
+// Allocations are padded to this size so that each allocation starts aligned
+// for SIMD kernels.
+constexpr iree_host_size_t kAllocationAlignment = 16;
+
+iree_host_size_t AlignAllocation(iree_host_size_t byte_length) {
+  return iree_math_align(byte_length, kAllocationAlignment);
+}
+
+// Arena memory shared between a thread and the buffers allocated from it.
+// Holds one reference for each live allocation plus one for the owning thread
+// so that buffers escaping a tile keep the memory alive after the thread moves
+// on to a new region.
+struct ScratchRegion {
+  ScratchRegion() : arena(ScratchArena::kBlockSize) {
+    IREE_TRACE_SET_PLOT_TYPE("vmla.scratch_bytes",
+                             IREE_TRACING_PLOT_TYPE_MEMORY);
+  }
+
+  std::atomic<int32_t> ref_count{1};
+  Arena arena;
+};
+
+void ReleaseRegion(ScratchRegion* region) {
+  if (region->ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    delete region;
+  }
+}
+
+iree_status_t RegionAllocate(void* self, iree_allocation_mode_t mode,
+                             iree_host_size_t byte_length, void** out_ptr) {
+  if (mode & IREE_ALLOCATION_MODE_TRY_REUSE_EXISTING) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "scratch allocations cannot be reallocated");
+  }
+  auto* region = static_cast<ScratchRegion*>(self);
+  uint8_t* ptr = region->arena.AllocateBytes(AlignAllocation(byte_length));
+  if (mode & IREE_ALLOCATION_MODE_ZERO_CONTENTS) {
+    std::memset(ptr, 0, byte_length);
+  }
+  region->ref_count.fetch_add(1, std::memory_order_relaxed);
+  *out_ptr = ptr;
+  return iree_ok_status();
+}
+
+void RegionFree(void* self, void* ptr) {
+  // Memory is reclaimed in bulk when the region is reset or deleted.
+  ReleaseRegion(static_cast<ScratchRegion*>(self));
+}
+
+struct ThreadState {
+  ~ThreadState() {
+    if (region) ReleaseRegion(region);
+  }
+
+  // Region allocations are currently served from, created on demand.
+  ScratchRegion* region = nullptr;
+  // Depth of the active TileScopes on the thread.
+  int scope_depth = 0;
+};
+
+thread_local ThreadState thread_state;
+
+}  // namespace
+
+ScratchArena::TileScope::TileScope() { ++thread_state.scope_depth; }
+
+ScratchArena::TileScope::~TileScope() {
+  auto& state = thread_state;
+  if (--state.scope_depth > 0) return;
+  ScratchRegion* region = state.region;
+  if (!region) return;
+
+  IREE_TRACE_PLOT_VALUE_I64("vmla.scratch_bytes",
+                            region->arena.bytes_allocated());
+
+  // Only this thread can add references so if no allocations are live we can
+  // safely reuse the region.
+  if (region->ref_count.load(std::memory_order_acquire) == 1) {
+    region->arena.Reset();
+  } else {
+    // Buffers outlived the tile; leave the region to them and start a new one
+    // on the next allocation.
+    ReleaseRegion(region);
+    state.region = nullptr;
+  }
+}
+
+// static
+iree_allocator_t ScratchArena::AllocatorFor(iree_host_size_t byte_length,
+                                            iree_allocator_t fallback) {
+  auto& state = thread_state;
+  if (state.scope_depth == 0 || byte_length == 0 ||
+      AlignAllocation(byte_length) > kBlockSize) {
+    return fallback;
+  }
+  if (!state.region) state.region = new ScratchRegion();
+  iree_allocator_t allocator;
+  allocator.self = state.region;
+  allocator.alloc = RegionAllocate;
+  allocator.free = RegionFree;
+  return allocator;
+}
+
+}  // namespace vmla
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,67 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_VMLA_SCRATCH_ARENA_H_
+#define IREE_HAL_VMLA_SCRATCH_ARENA_H_
+
+#include <cstddef>
+
+#include "iree/base/api.h"
+
+namespace iree {
+namespace hal {
+namespace vmla {
+
+// Per-thread scratch arena for intermediate VMLA buffers.
+// Buffers allocated by VMLA ops while a dispatch tile is running are almost
+// always dead by the time the tile returns. While a TileScope is active on the
+// calling thread allocations are bump-allocated from the thread's arena and the
+// arena is reset when the scope ends, replacing a malloc/free pair per
+// intermediate buffer with a pointer bump.
+//
+// Buffers that outlive their tile (such as those stored in module globals) keep
+// the arena memory they were allocated from alive and the thread starts over
+// with fresh arena memory instead of resetting.
+//
+// The bytes used by each tile are reported to the `vmla.scratch_bytes` plot
+// when tracing is enabled.
+class ScratchArena {
+ public:
+  // Size of each arena block. Larger allocations use the fallback allocator.
+  static constexpr size_t kBlockSize = 256 * 1024;
+
+  // Marks the execution of a dispatch tile on the calling thread.
+  // Scopes may nest; the arena is reset when the outermost scope ends.
+  class TileScope {
+   public:
+    TileScope();
+    ~TileScope();
+    TileScope(const TileScope&) = delete;
+    TileScope& operator=(const TileScope&) = delete;
+  };
+
+  // Returns an allocator to use for a single allocation of |byte_length|
+  // bytes. Within a TileScope this is the scratch arena of the calling thread
+  // if the allocation fits; otherwise |fallback| is returned.
+  // The returned allocator must only be used for one allocation, but the
+  // allocation may be freed from any thread.
+  static iree_allocator_t AllocatorFor(iree_host_size_t byte_length,
+                                       iree_allocator_t fallback);
+};
+
+}  // namespace vmla
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_VMLA_SCRATCH_ARENA_H_
@@ -0,0 +1,135 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/vmla/scratch_arena.h"
+
+#include <cstdint>
+#include <cstring>
+#include <thread>  // NOLINT
+
+#include "iree/testing/gtest.h"
+
+namespace iree {
+namespace hal {
+namespace vmla {
+namespace {
+
+bool IsFallback(iree_allocator_t allocator) {
+  iree_allocator_t fallback = iree_allocator_system();
+  return allocator.self == fallback.self && allocator.alloc == fallback.alloc &&
+         allocator.free == fallback.free;
+}
+
+uint8_t* Allocate(iree_allocator_t allocator, iree_host_size_t byte_length) {
+  void* ptr = nullptr;
+  IREE_CHECK_OK(iree_allocator_malloc(allocator, byte_length, &ptr));
+  return static_cast<uint8_t*>(ptr);
+}
+
+TEST(ScratchArenaTest, FallbackOutsideOfTiles) {
+  EXPECT_TRUE(IsFallback(
+      ScratchArena::AllocatorFor(128, iree_allocator_system())));
+}
+
+TEST(ScratchArenaTest, FallbackForUnsupportedSizes) {
+  ScratchArena::TileScope scope;
+  EXPECT_TRUE(
+      IsFallback(ScratchArena::AllocatorFor(0, iree_allocator_system())));
+  EXPECT_TRUE(IsFallback(ScratchArena::AllocatorFor(
+      ScratchArena::kBlockSize + 1, iree_allocator_system())));
+  EXPECT_FALSE(IsFallback(ScratchArena::AllocatorFor(
+      ScratchArena::kBlockSize, iree_allocator_system())));
+}
+
+TEST(ScratchArenaTest, AlignedAndZeroed) {
+  ScratchArena::TileScope scope;
+  for (iree_host_size_t byte_length : {1, 3, 17, 64}) {
+    auto allocator =
+        ScratchArena::AllocatorFor(byte_length, iree_allocator_system());
+    uint8_t* ptr = Allocate(allocator, byte_length);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(ptr) % 16);
+    for (iree_host_size_t i = 0; i < byte_length; ++i) {
+      EXPECT_EQ(0, ptr[i]);
+    }
+    std::memset(ptr, 0xCD, byte_length);
+    iree_allocator_free(allocator, ptr);
+  }
+}
+
+TEST(ScratchArenaTest, ResetBetweenTiles) {
+  uint8_t* first_ptr = nullptr;
+  {
+    ScratchArena::TileScope scope;
+    auto allocator = ScratchArena::AllocatorFor(64, iree_allocator_system());
+    first_ptr = Allocate(allocator, 64);
+    std::memset(first_ptr, 0xCD, 64);
+    iree_allocator_free(allocator, first_ptr);
+  }
+  {
+    ScratchArena::TileScope scope;
+    auto allocator = ScratchArena::AllocatorFor(64, iree_allocator_system());
+    uint8_t* second_ptr = Allocate(allocator, 64);
+    EXPECT_EQ(first_ptr, second_ptr);
+    EXPECT_EQ(0, second_ptr[0]);
+    iree_allocator_free(allocator, second_ptr);
+  }
+}
+
+TEST(ScratchArenaTest, NestedScopesResetOnOutermost) {
+  ScratchArena::TileScope outer_scope;
+  auto allocator = ScratchArena::AllocatorFor(64, iree_allocator_system());
+  uint8_t* outer_ptr = Allocate(allocator, 64);
+  {
+    ScratchArena::TileScope inner_scope;
+    auto inner_allocator =
+        ScratchArena::AllocatorFor(64, iree_allocator_system());
+    uint8_t* inner_ptr = Allocate(inner_allocator, 64);
+    EXPECT_NE(outer_ptr, inner_ptr);
+    iree_allocator_free(inner_allocator, inner_ptr);
+  }
+  auto next_allocator = ScratchArena::AllocatorFor(64, iree_allocator_system());
+  uint8_t* next_ptr = Allocate(next_allocator, 64);
+  EXPECT_NE(outer_ptr, next_ptr);
+  iree_allocator_free(next_allocator, next_ptr);
+  iree_allocator_free(allocator, outer_ptr);
+}
+
+// Allocations that outlive their tile must remain valid (even when freed from
+// another thread) and must not be handed out again by later tiles.
+TEST(ScratchArenaTest, EscapedAllocationsRemainValid) {
+  iree_allocator_t escaped_allocator;
+  uint8_t* escaped_ptr = nullptr;
+  {
+    ScratchArena::TileScope scope;
+    escaped_allocator = ScratchArena::AllocatorFor(64, iree_allocator_system());
+    escaped_ptr = Allocate(escaped_allocator, 64);
+    std::memset(escaped_ptr, 0xCD, 64);
+  }
+  {
+    ScratchArena::TileScope scope;
+    auto allocator = ScratchArena::AllocatorFor(64, iree_allocator_system());
+    uint8_t* ptr = Allocate(allocator, 64);
+    EXPECT_NE(escaped_ptr, ptr);
+    iree_allocator_free(allocator, ptr);
+  }
+  EXPECT_EQ(0xCD, escaped_ptr[63]);
+  std::thread thread(
+      [&]() { iree_allocator_free(escaped_allocator, escaped_ptr); });
+  thread.join();
+}
+
+}  // namespace
+}  // namespace vmla
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,115 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/vmla/thread_pool.h"
+
+#include <algorithm>
+
+#include "iree/base/tracing.h"
+
+namespace iree {
+namespace hal {
+namespace vmla {
+
+ThreadPool::ThreadPool(int thread_count) {
+  threads_.reserve(std::max(0, thread_count));
+  for (int i = 0; i < thread_count; ++i) {
+    threads_.emplace_back([this]() { ThreadMain(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    absl::MutexLock lock(&mutex_);
+    has_shutdown_ = true;
+    work_available_.SignalAll();
+  }
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void ThreadPool::ThreadMain() {
+  IREE_TRACE_SET_THREAD_NAME("vmla-kernel");
+  absl::MutexLock lock(&mutex_);
+  while (true) {
+    Job* job = nullptr;
+    int index = 0;
+    if (ClaimWork(&job, &index)) {
+      RunWork(job, index);
+    } else if (has_shutdown_) {
+      break;
+    } else {
+      work_available_.Wait(&mutex_);
+    }
+  }
+}
+
+bool ThreadPool::ClaimWork(Job** out_job, int* out_index) {
+  if (jobs_.empty()) return false;
+  Job* job = jobs_.front();
+  *out_job = job;
+  *out_index = job->next_index++;
+  if (job->next_index == job->count) jobs_.pop_front();
+  return true;
+}
+
+void ThreadPool::RunWork(Job* job, int index) {
+  mutex_.Unlock();
+  (*job->fn)(index);
+  mutex_.Lock();
+  // The job lives on the stack of the thread that called ParallelFor and may
+  // be gone as soon as the last call is marked complete.
+  if (++job->completed_count == job->count) work_completed_.SignalAll();
+}
+
+void ThreadPool::ParallelFor(int count, const std::function<void(int)>& fn) {
+  if (count <= 0) return;
+  if (count == 1 || threads_.empty()) {
+    for (int i = 0; i < count; ++i) fn(i);
+    return;
+  }
+
+  IREE_TRACE_SCOPE0("ThreadPool::ParallelFor");
+  Job job;
+  job.fn = &fn;
+  job.count = count;
+
+  absl::MutexLock lock(&mutex_);
+  jobs_.push_back(&job);
+  if (count - 1 >= thread_count()) {
+    work_available_.SignalAll();
+  } else {
+    for (int i = 0; i < count - 1; ++i) work_available_.Signal();
+  }
+
+  // Work on our own job until all of its indices have been claimed. Indices of
+  // other jobs are left to the pool threads and their callers.
+  while (job.next_index < job.count) {
+    // Our job may not be at the front of the queue but nothing else will
+    // claim it out of order; take indices directly.
+    int index = job.next_index++;
+    if (job.next_index == job.count) {
+      jobs_.erase(std::find(jobs_.begin(), jobs_.end(), &job));
+    }
+    RunWork(&job, index);
+  }
+  while (job.completed_count < job.count) {
+    work_completed_.Wait(&mutex_);
+  }
+}
+
+}  // namespace vmla
+}  // namespace hal
+}  // namespace iree
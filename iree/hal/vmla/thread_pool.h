@@ -0,0 +1,96 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_VMLA_THREAD_POOL_H_
+#define IREE_HAL_VMLA_THREAD_POOL_H_
+
+#include <deque>
+#include <functional>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+
+namespace iree {
+namespace hal {
+namespace vmla {
+
+// Pool of threads that VMLA kernels split large operations across.
+// One pool is owned by each VMLA device and shared by all executables and
+// tiles dispatched on it so that the number of kernel threads is bounded
+// regardless of how many tiles run concurrently.
+//
+// The thread calling ParallelFor always works on its own calls alongside the
+// pool threads. Concurrent (or nested) ParallelFor calls therefore make
+// progress even when every pool thread is busy and a pool with no threads runs
+// everything on the caller.
+//
+// Thread-safe.
+class ThreadPool final {
+ public:
+  // Creates a pool with |thread_count| threads in addition to callers.
+  explicit ThreadPool(int thread_count);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // Number of threads owned by the pool (not counting callers).
+  int thread_count() const { return static_cast<int>(threads_.size()); }
+
+  // Maximum number of threads a single ParallelFor may run on.
+  int max_concurrency() const { return thread_count() + 1; }
+
+  // Calls |fn| with each index in [0, count) and returns once all calls have
+  // completed. Calls may run concurrently in any order on the pool threads and
+  // the calling thread.
+  void ParallelFor(int count, const std::function<void(int)>& fn);
+
+ private:
+  struct Job {
+    const std::function<void(int)>* fn = nullptr;
+    int count = 0;
+    // Next index to be claimed.
+    int next_index = 0;
+    // Number of calls that have returned.
+    int completed_count = 0;
+  };
+
+  void ThreadMain();
+
+  // Claims the next index of the front job, removing the job from the queue
+  // once all of its indices are claimed. Returns false if there is no work.
+  bool ClaimWork(Job** out_job, int* out_index)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Runs a claimed index of |job| without the lock held.
+  void RunWork(Job* job, int index) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  absl::Mutex mutex_;
+  absl::CondVar work_available_;
+  absl::CondVar work_completed_;
+  bool has_shutdown_ ABSL_GUARDED_BY(mutex_) = false;
+
+  // Jobs with indices remaining to be claimed in submission order.
+  std::deque<Job*> jobs_ ABSL_GUARDED_BY(mutex_);
+
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace vmla
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_VMLA_THREAD_POOL_H_
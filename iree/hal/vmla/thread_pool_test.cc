@@ -0,0 +1,93 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/vmla/thread_pool.h"
+
+#include <atomic>
+#include <set>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "iree/testing/gtest.h"
+
+namespace iree {
+namespace hal {
+namespace vmla {
+namespace {
+
+TEST(ThreadPoolTest, NoThreadsRunsOnCaller) {
+  ThreadPool thread_pool(0);
+  EXPECT_EQ(1, thread_pool.max_concurrency());
+  std::vector<std::thread::id> thread_ids(8);
+  thread_pool.ParallelFor(thread_ids.size(), [&](int i) {
+    thread_ids[i] = std::this_thread::get_id();
+  });
+  for (auto thread_id : thread_ids) {
+    EXPECT_EQ(std::this_thread::get_id(), thread_id);
+  }
+}
+
+TEST(ThreadPoolTest, RunsEachIndexOnce) {
+  ThreadPool thread_pool(3);
+  std::vector<std::atomic<int>> counts(1000);
+  for (auto& count : counts) count = 0;
+  thread_pool.ParallelFor(counts.size(), [&](int i) { ++counts[i]; });
+  for (auto& count : counts) EXPECT_EQ(1, count.load());
+}
+
+// Each call blocks until all calls have started, so this only completes if the
+// calls run on max_concurrency() distinct threads at the same time.
+TEST(ThreadPoolTest, RunsConcurrently) {
+  ThreadPool thread_pool(3);
+  struct Barrier {
+    int count;
+    int started_count;
+  } barrier = {thread_pool.max_concurrency(), 0};
+  absl::Mutex mutex;
+  std::set<std::thread::id> thread_ids;
+  thread_pool.ParallelFor(barrier.count, [&](int i) {
+    absl::MutexLock lock(&mutex);
+    ++barrier.started_count;
+    thread_ids.insert(std::this_thread::get_id());
+    mutex.Await(absl::Condition(
+        +[](Barrier* barrier) {
+          return barrier->started_count == barrier->count;
+        },
+        &barrier));
+  });
+  EXPECT_EQ(barrier.count, thread_ids.size());
+}
+
+// Callers work on their own calls so concurrent and nested calls complete even
+// with more callers than pool threads.
+TEST(ThreadPoolTest, ConcurrentAndNestedCalls) {
+  ThreadPool thread_pool(2);
+  std::atomic<int> total{0};
+  std::vector<std::thread> callers;
+  for (int i = 0; i < 4; ++i) {
+    callers.emplace_back([&]() {
+      thread_pool.ParallelFor(8, [&](int i) {
+        thread_pool.ParallelFor(8, [&](int j) { ++total; });
+      });
+    });
+  }
+  for (auto& caller : callers) caller.join();
+  EXPECT_EQ(4 * 8 * 8, total.load());
+}
+
+}  // namespace
+}  // namespace vmla
+}  // namespace hal
+}  // namespace iree
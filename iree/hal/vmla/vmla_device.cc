@@ -14,15 +14,46 @@
 
 #include "iree/hal/vmla/vmla_device.h"
 
+#include <algorithm>
+#include <thread>
+
 #include "absl/memory/memory.h"
 #include "iree/base/status.h"
 #include "iree/base/tracing.h"
+#include "iree/hal/vmla/op_kernels.h"
+#include "iree/hal/vmla/op_module.h"
 #include "iree/hal/vmla/vmla_cache.h"
 
 namespace iree {
 namespace hal {
 namespace vmla {
 
+// static
+StatusOr<ref_ptr<VMLADevice>> VMLADevice::Create(
+    DeviceInfo device_info,
+    std::unique_ptr<host::SchedulingModel> scheduling_model,
+    iree_vm_instance_t* instance, const VMLADeviceOptions& options) {
+  IREE_TRACE_SCOPE0("VMLADevice::Create");
+
+  kernels::RuntimeStateOptions runtime_state_options;
+  runtime_state_options.max_thread_count = options.max_kernel_thread_count;
+  if (runtime_state_options.max_thread_count <= 0) {
+    runtime_state_options.max_thread_count =
+        std::max(1u, std::thread::hardware_concurrency());
+  }
+  runtime_state_options.enable_prepacked_cache = options.enable_prepacked_cache;
+
+  iree_vm_module_t* vmla_module = nullptr;
+  IREE_RETURN_IF_ERROR(ModuleCreate(runtime_state_options,
+                                    iree_allocator_system(), &vmla_module))
+      << "VMLA device module creation failed";
+  auto device =
+      make_ref<VMLADevice>(std::move(device_info), std::move(scheduling_model),
+                           instance, vmla_module);
+  iree_vm_module_release(vmla_module);
+  return device;
+}
+
 VMLADevice::VMLADevice(DeviceInfo device_info,
                        std::unique_ptr<host::SchedulingModel> scheduling_model,
                        iree_vm_instance_t* instance,
@@ -16,6 +16,7 @@
 #define IREE_HAL_VMLA_VMLA_DEVICE_H_
 
 #include "iree/base/memory.h"
+#include "iree/base/status.h"
 #include "iree/hal/host/host_local_device.h"
 #include "iree/vm/api.h"
 
@@ -23,8 +24,35 @@ namespace iree {
 namespace hal {
 namespace vmla {
 
+// Device-level configuration of the VMLA kernels.
+struct VMLADeviceOptions {
+  // Maximum number of threads a single kernel (such as a large matmul or
+  // convolution) may use, including the dispatching thread. The device owns
+  // one pool of max_kernel_thread_count - 1 threads shared by all executables
+  // and tiles. Values <= 0 use the number of hardware threads available.
+  int max_kernel_thread_count = 1;
+
+  // Caches the packed form of constant GEMM operands (such as weights stored
+  // in executable rodata) so that they are only packed on first use. The cache
+  // is shared by the device and entries are dropped when their executable is
+  // unloaded.
+  bool enable_prepacked_cache = true;
+
+  // Number of threads the device queue uses to process independent
+  // submissions concurrently. 1 processes submissions in FIFO order.
+  int queue_worker_count = 1;
+};
+
 class VMLADevice final : public host::HostLocalDevice {
  public:
+  // Creates a device with its own VMLA module instance configured by
+  // |options|. Kernel runtime state (thread pool, prepacked operand cache) is
+  // owned by the module and shared by all executables on the device.
+  static StatusOr<ref_ptr<VMLADevice>> Create(
+      DeviceInfo device_info,
+      std::unique_ptr<host::SchedulingModel> scheduling_model,
+      iree_vm_instance_t* instance, const VMLADeviceOptions& options);
+
   explicit VMLADevice(DeviceInfo device_info,
                       std::unique_ptr<host::SchedulingModel> scheduling_model,
                       iree_vm_instance_t* instance,
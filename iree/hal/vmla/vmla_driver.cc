@@ -19,6 +19,7 @@
 #include "iree/base/tracing.h"
 #include "iree/hal/device_info.h"
 #include "iree/hal/host/serial/serial_scheduling_model.h"
+#include "iree/hal/host/task/task_scheduling_model.h"
 #include "iree/hal/vmla/op_module.h"
 #include "iree/hal/vmla/vmla_device.h"
 
@@ -42,7 +43,8 @@ DeviceInfo GetDefaultDeviceInfo() {
 }  // namespace
 
 // static
-StatusOr<ref_ptr<Driver>> VMLADriver::Create() {
+StatusOr<ref_ptr<Driver>> VMLADriver::Create(
+    iree_task_executor_t* executor, const VMLADeviceOptions& device_options) {
   IREE_TRACE_SCOPE0("VMLADriver::Create");
 
   // NOTE: we could use our own allocator here to hide these from any default
@@ -55,21 +57,23 @@ StatusOr<ref_ptr<Driver>> VMLADriver::Create() {
   IREE_RETURN_IF_ERROR(ModuleRegisterTypes())
       << "VMLA type registration failed";
 
-  iree_vm_module_t* vmla_module = nullptr;
-  IREE_RETURN_IF_ERROR(ModuleCreate(iree_allocator_system(), &vmla_module))
-      << "VMLA shared module creation failed";
-
-  return make_ref<VMLADriver>(instance, vmla_module);
+  return make_ref<VMLADriver>(instance, executor, device_options);
 }
 
 VMLADriver::VMLADriver(iree_vm_instance_t* instance,
-                       iree_vm_module_t* vmla_module)
-    : Driver("vmla"), instance_(instance), vmla_module_(vmla_module) {}
+                       iree_task_executor_t* executor,
+                       const VMLADeviceOptions& device_options)
+    : Driver("vmla"),
+      instance_(instance),
+      executor_(executor),
+      device_options_(device_options) {
+  if (executor_) iree_task_executor_retain(executor_);
+}
 
 VMLADriver::~VMLADriver() {
   IREE_TRACE_SCOPE0("VMLADriver::dtor");
-  iree_vm_module_release(vmla_module_);
   iree_vm_instance_release(instance_);
+  if (executor_) iree_task_executor_release(executor_);
 }
 
 StatusOr<std::vector<DeviceInfo>> VMLADriver::EnumerateAvailableDevices() {
@@ -83,10 +87,18 @@ StatusOr<ref_ptr<Device>> VMLADriver::CreateDefaultDevice() {
 }
 
 StatusOr<ref_ptr<Device>> VMLADriver::CreateDevice(DriverDeviceID device_id) {
-  auto scheduling_model = std::make_unique<host::SerialSchedulingModel>();
-  auto device =
-      make_ref<VMLADevice>(GetDefaultDeviceInfo(), std::move(scheduling_model),
-                           instance_, vmla_module_);
+  std::unique_ptr<host::SchedulingModel> scheduling_model;
+  if (executor_) {
+    scheduling_model = std::make_unique<host::TaskSchedulingModel>(
+        executor_, device_options_.queue_worker_count);
+  } else {
+    scheduling_model = std::make_unique<host::SerialSchedulingModel>(
+        device_options_.queue_worker_count);
+  }
+  IREE_ASSIGN_OR_RETURN(
+      auto device,
+      VMLADevice::Create(GetDefaultDeviceInfo(), std::move(scheduling_model),
+                         instance_, device_options_));
   return device;
 }
 
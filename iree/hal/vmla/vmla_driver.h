@@ -16,6 +16,8 @@
 #define IREE_HAL_VMLA_VMLA_DRIVER_H_
 
 #include "iree/hal/driver.h"
+#include "iree/hal/vmla/vmla_device.h"
+#include "iree/task/executor.h"
 #include "iree/vm/api.h"
 
 namespace iree {
@@ -24,9 +26,15 @@ namespace vmla {
 
 class VMLADriver final : public Driver {
  public:
-  static StatusOr<ref_ptr<Driver>> Create();
-
-  VMLADriver(iree_vm_instance_t* instance, iree_vm_module_t* vmla_module);
+  // Creates a driver whose devices schedule work on |executor|, if provided.
+  // When |executor| is nullptr devices process all work serially.
+  // Each device created by the driver is configured with |device_options|.
+  static StatusOr<ref_ptr<Driver>> Create(
+      iree_task_executor_t* executor,
+      const VMLADeviceOptions& device_options = {});
+
+  VMLADriver(iree_vm_instance_t* instance, iree_task_executor_t* executor,
+             const VMLADeviceOptions& device_options);
   ~VMLADriver() override;
 
   StatusOr<std::vector<DeviceInfo>> EnumerateAvailableDevices() override;
@@ -37,7 +45,8 @@ class VMLADriver final : public Driver {
 
  private:
   iree_vm_instance_t* instance_ = nullptr;
-  iree_vm_module_t* vmla_module_ = nullptr;
+  iree_task_executor_t* executor_ = nullptr;
+  VMLADeviceOptions device_options_;
 };
 
 }  // namespace vmla
@@ -14,10 +14,13 @@
 
 #include "iree/hal/vmla/vmla_executable.h"
 
+#include <cstddef>
+
 #include "iree/base/status.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/host/host_buffer.h"
 #include "iree/hal/vmla/op_module.h"
+#include "iree/hal/vmla/scratch_arena.h"
 #include "iree/vm/bytecode_module.h"
 
 // flatcc schemas:
@@ -92,10 +95,51 @@ VMLAExecutable::VMLAExecutable(ExecutableSpec spec, bool allow_aliasing_data)
   }
 }
 
+struct VMLAExecutable::DispatchContext {
+  ~DispatchContext() {
+    ResetStack();
+    iree_vm_context_release(context);
+  }
+
+  // Returns the stack bound to the context, initializing it if required.
+  iree_vm_stack_t* stack() {
+    if (!stack_) {
+      IREE_IGNORE_ERROR(iree_vm_stack_initialize(
+          iree_make_byte_span(stack_storage_, sizeof(stack_storage_)),
+          iree_vm_context_state_resolver(context), iree_allocator_system(),
+          &stack_));
+    }
+    return stack_;
+  }
+
+  // Unwinds and releases the stack. Must be called after a failed call as
+  // frames may remain on the stack.
+  void ResetStack() {
+    if (stack_) iree_vm_stack_deinitialize(stack_);
+    stack_ = nullptr;
+  }
+
+  iree_vm_context_t* context = nullptr;
+
+ private:
+  iree_vm_stack_t* stack_ = nullptr;
+  alignas(16) uint8_t stack_storage_[IREE_VM_STACK_DEFAULT_SIZE];
+};
+
 VMLAExecutable::~VMLAExecutable() {
   IREE_TRACE_SCOPE0("VMLAExecutable::dtor");
-  iree_vm_context_release(context_);
-  context_ = nullptr;
+  {
+    absl::MutexLock lock(&context_mutex_);
+    free_contexts_.clear();
+    contexts_.clear();
+  }
+  // Kernel caches are shared by the device and may hold data derived from our
+  // rodata, which is freed along with us.
+  if (modules_[0]) ModuleReleaseExecutable(modules_[0], this);
+  for (auto* module : modules_) {
+    iree_vm_module_release(module);
+  }
+  iree_vm_instance_release(instance_);
 }
 
 Status VMLAExecutable::Initialize(iree_vm_instance_t* instance,
@@ -121,6 +165,13 @@ Status VMLAExecutable::Initialize(iree_vm_instance_t* instance,
       &bytecode_module))
       << "Failed to load executable bytecode module";
 
+  // Contexts are created on demand as tiles are dispatched concurrently so the
+  // modules are kept for the lifetime of the executable.
+  instance_ = instance;
+  iree_vm_instance_retain(instance_);
+  modules_ = {vmla_module, bytecode_module};
+  iree_vm_module_retain(vmla_module);
+
   entry_functions_.resize(
       iree_vm_module_signature(bytecode_module).export_function_count);
   for (size_t i = 0; i < entry_functions_.size(); ++i) {
@@ -129,19 +180,58 @@ Status VMLAExecutable::Initialize(iree_vm_instance_t* instance,
         &entry_functions_[i], nullptr));
   }
 
-  // Create context and initialize shared state. Note that each executable here
-  // has its own context (and thus its own vmla.interface instance).
-  std::array<iree_vm_module_t*, 2> modules = {vmla_module, bytecode_module};
-  auto result = StatusBuilder(iree_vm_context_create_with_modules(
-                                  instance, modules.data(), modules.size(),
-                                  iree_allocator_system(), &context_),
-                              IREE_LOC)
-                << "Failed resolving imports for executable module";
-  iree_vm_module_release(bytecode_module);
+  // Create the first context now so that import resolution failures are
+  // reported at load time. Note that each executable here has its own contexts
+  // (and thus its own vmla.interface instances).
+  IREE_ASSIGN_OR_RETURN(auto* dispatch_context, AcquireContext());
+  ReleaseContext(dispatch_context);
+  return OkStatus();
+}
+
+StatusOr<VMLAExecutable::DispatchContext*> VMLAExecutable::AcquireContext() {
+  {
+    absl::MutexLock lock(&context_mutex_);
+    if (!free_contexts_.empty()) {
+      auto* dispatch_context = free_contexts_.back();
+      free_contexts_.pop_back();
+      return dispatch_context;
+    }
+  }
+
+  // All contexts are in use by concurrently executing tiles; create another
+  // with its own module states. This only happens until the pool reaches the
+  // number of workers dispatching into this executable.
+  IREE_TRACE_SCOPE0("VMLAExecutable::AcquireContext#create");
+  auto dispatch_context = std::make_unique<DispatchContext>();
+  IREE_RETURN_IF_ERROR(iree_vm_context_create_with_modules(
+      instance_, modules_.data(), modules_.size(), iree_allocator_system(),
+      &dispatch_context->context))
+      << "Failed resolving imports for executable module";
+  IREE_RETURN_IF_ERROR(ModuleStateBindExecutable(dispatch_context->context,
+                                                 modules_[0], this));
+  absl::MutexLock lock(&context_mutex_);
+  contexts_.push_back(std::move(dispatch_context));
+  return contexts_.back().get();
+}
 
-  return std::move(result);
+void VMLAExecutable::ReleaseContext(DispatchContext* dispatch_context) {
+  absl::MutexLock lock(&context_mutex_);
+  free_contexts_.push_back(dispatch_context);
 }
 
+// Argument buffer layout of entry points using the direct calling convention
+// of `(!vmla.interface, i32, i32, i32) -> ()`. Values are tightly packed as
+// the VM ABI expects.
+struct DirectCallArguments {
+  iree_vm_ref_t interface_ref;
+  int32_t workgroup_xyz[3];
+};
+static_assert(offsetof(DirectCallArguments, workgroup_xyz) ==
+                  sizeof(iree_vm_ref_t),
+              "direct call arguments must match the VM ABI packing");
+static constexpr iree_host_size_t kDirectCallArgumentsSize =
+    sizeof(iree_vm_ref_t) + 3 * sizeof(int32_t);
+
 struct VMLADispatchState : public HostExecutable::DispatchState {
   VMLADispatchState() { interface_ref = Interface_retain_ref(&interface); }
   ~VMLADispatchState() override { iree_vm_ref_release(&interface_ref); }
@@ -150,6 +240,10 @@ struct VMLADispatchState : public HostExecutable::DispatchState {
   Interface interface;
   iree_vm_ref_t interface_ref;
   iree_host_size_t input_list_size = 0;
+
+  // True if the function uses the direct calling convention and can be called
+  // with DirectCallArguments instead of going through iree_vm_invoke.
+  bool is_direct_call = false;
 };
 
 StatusOr<ref_ptr<HostExecutable::DispatchState>>
@@ -166,6 +260,17 @@ VMLAExecutable::PrepareDispatch(const DispatchParams& params) {
   dispatch_state->input_list_size = iree_vm_list_storage_size(
       /*element_type=*/nullptr, /*interface*/ 1 + /*workgroup_xyz[3]*/ 3);
 
+  iree_vm_function_signature_t signature =
+      iree_vm_function_signature(&dispatch_state->function);
+  iree_string_view_t cconv_arguments = iree_string_view_empty();
+  iree_string_view_t cconv_results = iree_string_view_empty();
+  IREE_RETURN_IF_ERROR(iree_vm_function_call_get_cconv_fragments(
+      &signature, &cconv_arguments, &cconv_results));
+  dispatch_state->is_direct_call =
+      iree_string_view_equal(cconv_arguments,
+                             iree_make_cstring_view("riii")) &&
+      iree_string_view_is_empty(cconv_results);
+
   auto* interface = &dispatch_state->interface;
   IREE_RETURN_IF_ERROR(interface->SetConstants(params.push_constants->values));
 
@@ -195,6 +300,24 @@ Status VMLAExecutable::DispatchTile(DispatchState* state,
   IREE_TRACE_SCOPE_DYNAMIC(
       iree_vm_function_name(&dispatch_state->function).data);
 
+  // Intermediate buffers allocated by the tile come from the thread's scratch
+  // arena and are reclaimed together when the tile completes.
+  ScratchArena::TileScope scratch_scope;
+
+  // Tiles of the same dispatch may run concurrently on multiple workers and
+  // each needs exclusive use of a context.
+  IREE_ASSIGN_OR_RETURN(auto* dispatch_context, AcquireContext());
+  Status status =
+      dispatch_state->is_direct_call
+          ? DispatchTileDirect(dispatch_context, dispatch_state, workgroup_xyz)
+          : DispatchTileInvoke(dispatch_context, dispatch_state, workgroup_xyz);
+  ReleaseContext(dispatch_context);
+  return status;
+}
+
+Status VMLAExecutable::DispatchTileInvoke(
+    DispatchContext* dispatch_context, VMLADispatchState* dispatch_state,
+    std::array<uint32_t, 3> workgroup_xyz) {
   auto* input_list_storage = alloca(dispatch_state->input_list_size);
   iree_vm_list_t* input_list = nullptr;
   IREE_RETURN_IF_ERROR(iree_vm_list_initialize(
@@ -207,17 +330,56 @@ Status VMLAExecutable::DispatchTile(DispatchState* state,
     iree_vm_list_push_value(input_list, &value);
   }
 
-  // TODO(benvanik): switch to direct calling to avoid the invoke overhead.
-  auto status =
-      Status(iree_vm_invoke(context(), dispatch_state->function,
-                            /*policy=*/nullptr, input_list,
-                            /*outputs=*/nullptr, iree_allocator_system()));
+  auto status = Status(iree_vm_invoke(
+      dispatch_context->context, dispatch_state->function,
+      /*policy=*/nullptr, input_list, /*outputs=*/nullptr,
+      iree_allocator_system()));
 
   iree_vm_list_deinitialize(input_list);
 
   return status;
 }
 
+Status VMLAExecutable::DispatchTileDirect(
+    DispatchContext* dispatch_context, VMLADispatchState* dispatch_state,
+    std::array<uint32_t, 3> workgroup_xyz) {
+  // Marshal the arguments directly into the ABI buffer. The callee takes
+  // ownership of the interface ref so we must retain it for each call.
+  DirectCallArguments arguments;
+  iree_vm_ref_retain(&dispatch_state->interface_ref, &arguments.interface_ref);
+  for (size_t i = 0; i < workgroup_xyz.size(); ++i) {
+    arguments.workgroup_xyz[i] = static_cast<int32_t>(workgroup_xyz[i]);
+  }
+
+  iree_vm_function_call_t call;
+  call.function = dispatch_state->function;
+  call.arguments = iree_make_byte_span(&arguments, kDirectCallArgumentsSize);
+  call.results = iree_make_byte_span(nullptr, 0);
+
+  iree_vm_stack_t* stack = dispatch_context->stack();
+  iree_vm_module_t* module = call.function.module;
+  iree_vm_execution_result_t result;
+  iree_status_t status =
+      module->begin_call(module->self, stack, &call, &result);
+  while (iree_status_is_ok(status) &&
+         result.state != IREE_VM_EXECUTION_STATE_COMPLETE) {
+    // Dispatch functions are not expected to yield but we handle it the same
+    // way as iree_vm_invoke does for correctness.
+    if (result.state == IREE_VM_EXECUTION_STATE_WAIT && result.wait_fn) {
+      status = result.wait_fn(result.wait_state, IREE_TIME_INFINITE_FUTURE);
+      if (!iree_status_is_ok(status)) break;
+    }
+    status = module->resume_call(module->self, stack, &call, &result);
+  }
+  if (!iree_status_is_ok(status)) {
+    iree_vm_function_signature_t signature =
+        iree_vm_function_signature(&call.function);
+    iree_vm_function_call_release(&call, &signature);
+    dispatch_context->ResetStack();
+  }
+  return Status(std::move(status));
+}
+
 }  // namespace vmla
 }  // namespace hal
 }  // namespace iree
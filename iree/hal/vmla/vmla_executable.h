@@ -15,9 +15,13 @@
 #ifndef IREE_HAL_VMLA_VMLA_EXECUTABLE_H_
 #define IREE_HAL_VMLA_VMLA_EXECUTABLE_H_
 
+#include <array>
+#include <memory>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/container/inlined_vector.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "iree/base/status.h"
 #include "iree/hal/executable_spec.h"
@@ -29,6 +33,7 @@ namespace hal {
 namespace vmla {
 
 class Interface;
+struct VMLADispatchState;
 
 class VMLAExecutable final : public HostExecutable {
  public:
@@ -47,9 +52,6 @@ class VMLAExecutable final : public HostExecutable {
     return spec_.executable_data;
   }
 
-  // VM context containing the loaded executable module.
-  iree_vm_context_t* context() const { return context_; }
-
   // Entry point functions in export order.
   absl::Span<const iree_vm_function_t> entry_functions() const {
     return absl::MakeConstSpan(entry_functions_);
@@ -61,14 +63,44 @@ class VMLAExecutable final : public HostExecutable {
                       std::array<uint32_t, 3> workgroup_xyz) override;
 
  private:
+  // A VM context (and the module states within it) along with a stack bound to
+  // it. Contexts are thread-compatible so each is only ever used by one tile at
+  // a time.
+  struct DispatchContext;
+
   Status Initialize(iree_vm_instance_t* instance,
                     iree_vm_module_t* vmla_module);
 
+  // Returns a context that is not in use by any other tile, creating a new one
+  // if all existing contexts are in use. The context must be returned with
+  // ReleaseContext once the tile completes.
+  StatusOr<DispatchContext*> AcquireContext();
+  void ReleaseContext(DispatchContext* dispatch_context);
+
+  // Calls the dispatch function with iree_vm_invoke.
+  Status DispatchTileInvoke(DispatchContext* dispatch_context,
+                            VMLADispatchState* dispatch_state,
+                            std::array<uint32_t, 3> workgroup_xyz);
+
+  // Calls the dispatch function directly on the context stack, bypassing the
+  // list marshaling and calling convention parsing of iree_vm_invoke.
+  Status DispatchTileDirect(DispatchContext* dispatch_context,
+                            VMLADispatchState* dispatch_state,
+                            std::array<uint32_t, 3> workgroup_xyz);
+
   ExecutableSpec spec_;
   std::vector<uint8_t> cloned_executable_data_;
 
-  iree_vm_context_t* context_ = nullptr;
+  // Modules loaded into each context, in import resolution order.
+  iree_vm_instance_t* instance_ = nullptr;
+  std::array<iree_vm_module_t*, 2> modules_ = {nullptr, nullptr};
   absl::InlinedVector<iree_vm_function_t, 4> entry_functions_;
+
+  // Grows to the maximum number of tiles concurrently dispatched.
+  absl::Mutex context_mutex_;
+  std::vector<std::unique_ptr<DispatchContext>> contexts_
+      ABSL_GUARDED_BY(context_mutex_);
+  std::vector<DispatchContext*> free_contexts_ ABSL_GUARDED_BY(context_mutex_);
 };
 
 }  // namespace vmla
@@ -136,9 +136,15 @@ class HALModuleState final {
       const vm::ref<iree_hal_command_buffer_t>& command_buffer) {
     IREE_TRACE_SCOPE0("HALModuleState::ExSubmitAndWait");
 
-    vm::ref<iree_hal_semaphore_t> semaphore;
-    IREE_RETURN_IF_ERROR(iree_hal_semaphore_create(
-        device.get(), 0ull, iree_allocator_system(), &semaphore));
+    // The timeline semaphore is reused across submissions (and thus across
+    // the invocations of a batch) so long as they target the same device.
+    if (!submit_semaphore_ || submit_device_.get() != device.get()) {
+      submit_semaphore_.reset();
+      IREE_RETURN_IF_ERROR(iree_hal_semaphore_create(
+          device.get(), 0ull, iree_allocator_system(), &submit_semaphore_));
+      submit_device_ = vm::retain_ref(device.get());
+      submit_value_ = 0ull;
+    }
 
     iree_hal_submission_batch_t batch;
     memset(&batch, 0, sizeof(batch));
@@ -146,15 +152,23 @@ class HALModuleState final {
     iree_hal_command_buffer_t* command_buffer_ptrs[] = {command_buffer.get()};
     batch.command_buffers = command_buffer_ptrs;
     batch.signal_semaphores.count = 1;
-    iree_hal_semaphore_t* semaphore_ptrs[] = {semaphore.get()};
+    iree_hal_semaphore_t* semaphore_ptrs[] = {submit_semaphore_.get()};
     batch.signal_semaphores.semaphores = semaphore_ptrs;
-    uint64_t signal_value = 1ull;
+    uint64_t signal_value = submit_value_ + 1;
     batch.signal_semaphores.payload_values = &signal_value;
-    IREE_RETURN_IF_ERROR(iree_hal_device_queue_submit(
+    Status status(iree_hal_device_queue_submit(
         device.get(), IREE_HAL_COMMAND_CATEGORY_ANY, 0, 1, &batch));
-
-    IREE_RETURN_IF_ERROR(iree_hal_semaphore_wait_with_deadline(
-        semaphore.get(), 1ull, IREE_TIME_INFINITE_FUTURE));
+    if (status.ok()) {
+      status = Status(iree_hal_semaphore_wait_with_deadline(
+          submit_semaphore_.get(), signal_value, IREE_TIME_INFINITE_FUTURE));
+    }
+    if (!status.ok()) {
+      // The semaphore may be left in a failed state; recreate it on the next
+      // submission.
+      submit_semaphore_.reset();
+      return status;
+    }
+    submit_value_ = signal_value;
 
     {
       IREE_TRACE_SCOPE0("HALModuleState::DeferredReleases");
@@ -722,16 +736,30 @@ class HALModuleState final {
     return OkStatus();
   }
 
-  StatusOr<int32_t> SemaphoreAwait(
+  // Suspends the calling invocation instead of blocking the thread when the
+  // semaphore has not yet reached |new_value|. The await is polled again when
+  // the invocation is resumed.
+  StatusOr<vm::Waitable<int32_t>> SemaphoreAwait(
       const vm::ref<iree_hal_semaphore_t>& semaphore, uint32_t new_value) {
-    // TODO(benvanik): coroutine magic.
     iree_status_t status = iree_hal_semaphore_wait_with_deadline(
-        semaphore.get(), new_value, IREE_TIME_INFINITE_FUTURE);
+        semaphore.get(), new_value, IREE_TIME_INFINITE_PAST);
     if (iree_status_is_ok(status)) {
-      return 0;
+      return vm::Waitable<int32_t>(0);
     } else if (iree_status_is_deadline_exceeded(status)) {
-      // Propagate deadline exceeded back to the VM.
-      return static_cast<int32_t>(iree_status_consume_code(status));
+      iree_status_ignore(status);
+      // The semaphore is kept alive by the suspended call arguments.
+      iree_hal_semaphore_t* semaphore_ptr = semaphore.get();
+      return vm::Waitable<int32_t>::Wait(
+          [semaphore_ptr, new_value](iree_time_t deadline) -> Status {
+            iree_status_t status = iree_hal_semaphore_wait_with_deadline(
+                semaphore_ptr, new_value, deadline);
+            if (iree_status_is_deadline_exceeded(status)) {
+              return Status(std::move(status));
+            }
+            // Failures are reported by the await when it is resumed.
+            iree_status_ignore(status);
+            return OkStatus();
+          });
     }
     return Status(std::move(status));
   }
@@ -741,6 +769,12 @@ class HALModuleState final {
   ref_ptr<Device> shared_device_;
 
   std::vector<iree_vm_ref_t> deferred_releases_;
+
+  // Timeline semaphore signaled by ExSubmitAndWait submissions to
+  // |submit_device_| and the last payload value signaled.
+  vm::ref<iree_hal_device_t> submit_device_;
+  vm::ref<iree_hal_semaphore_t> submit_semaphore_;
+  uint64_t submit_value_ = 0ull;
 };
 
 //===----------------------------------------------------------------------===//
@@ -0,0 +1,280 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Runs the functions from iree/vm/bytecode_module_benchmark.mlir compiled to a
+// native C module side-by-side with the bytecode interpreter so the two
+// execution strategies can be compared directly.
+
+#include <array>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "benchmark/benchmark.h"
+#include "iree/base/api.h"
+#include "iree/base/logging.h"
+#include "iree/vm/api.h"
+#include "iree/vm/bytecode_module.h"
+#include "iree/vm/bytecode_module_benchmark_module.h"
+
+// Defines bytecode_module_benchmark_create.
+#include "iree/samples/emitc_modules/c_module_benchmark_module.module"
+
+namespace {
+
+// vm.import @native_import_module.add_1(%arg0 : i32) -> i32
+static iree_status_t native_import_module_add_1(
+    iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
+    iree_vm_native_function_target_t target_fn, void* module,
+    void* module_state, iree_vm_execution_result_t* out_result) {
+  int32_t arg0 = *reinterpret_cast<int32_t*>(call->arguments.data);
+  int32_t ret0 = arg0 + 1;
+  *reinterpret_cast<int32_t*>(call->results.data) = ret0;
+  return iree_ok_status();
+}
+
+// vm.import @native_import_module.add_1_x2(%a : i32, %b : i32) -> (i32, i32)
+static iree_status_t native_import_module_add_1_x2(
+    iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
+    iree_vm_native_function_target_t target_fn, void* module,
+    void* module_state, iree_vm_execution_result_t* out_result) {
+  const int32_t* args = reinterpret_cast<const int32_t*>(call->arguments.data);
+  int32_t* rets = reinterpret_cast<int32_t*>(call->results.data);
+  rets[0] = args[0] + 1;
+  rets[1] = args[1] + 1;
+  return iree_ok_status();
+}
+
+// vm.import @native_import_module.add_1_ref(%ref : !vm.ref<?>, %arg : i32)
+//     -> i32
+static iree_status_t native_import_module_add_1_ref(
+    iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
+    iree_vm_native_function_target_t target_fn, void* module,
+    void* module_state, iree_vm_execution_result_t* out_result) {
+  // Drop the ref (we own it) and add 1 to arg.
+  iree_vm_ref_release(reinterpret_cast<iree_vm_ref_t*>(call->arguments.data));
+  int32_t arg;
+  memcpy(&arg, call->arguments.data + sizeof(iree_vm_ref_t), sizeof(arg));
+  int32_t ret = arg + 1;
+  memcpy(call->results.data, &ret, sizeof(ret));
+  return iree_ok_status();
+}
+
+static const iree_vm_native_export_descriptor_t
+    native_import_module_exports_[] = {
+        {iree_make_cstring_view("add_1"), iree_make_cstring_view("0i.i"), 0,
+         NULL},
+        {iree_make_cstring_view("add_1_ref"), iree_make_cstring_view("0ri.i"),
+         0, NULL},
+        {iree_make_cstring_view("add_1_x2"), iree_make_cstring_view("0ii.ii"),
+         0, NULL},
+};
+static const iree_vm_native_function_ptr_t native_import_module_funcs_[] = {
+    {(iree_vm_native_function_shim_t)native_import_module_add_1, NULL},
+    {(iree_vm_native_function_shim_t)native_import_module_add_1_ref, NULL},
+    {(iree_vm_native_function_shim_t)native_import_module_add_1_x2, NULL},
+};
+static_assert(IREE_ARRAYSIZE(native_import_module_funcs_) ==
+                  IREE_ARRAYSIZE(native_import_module_exports_),
+              "function pointer table must be 1:1 with exports");
+static const iree_vm_native_module_descriptor_t
+    native_import_module_descriptor_ = {
+        iree_make_cstring_view("native_import_module"),
+        0,
+        NULL,
+        IREE_ARRAYSIZE(native_import_module_exports_),
+        native_import_module_exports_,
+        IREE_ARRAYSIZE(native_import_module_funcs_),
+        native_import_module_funcs_,
+        0,
+        NULL,
+};
+
+static iree_status_t native_import_module_create(
+    iree_allocator_t allocator, iree_vm_module_t** out_module) {
+  iree_vm_module_t interface;
+  IREE_RETURN_IF_ERROR(iree_vm_module_initialize(&interface, NULL));
+  return iree_vm_native_module_create(
+      &interface, &native_import_module_descriptor_, allocator, out_module);
+}
+
+enum class ModuleKind {
+  kBytecode,
+  kC,
+};
+
+static iree_status_t CreateModule(ModuleKind kind,
+                                  iree_vm_module_t** out_module) {
+  switch (kind) {
+    case ModuleKind::kBytecode: {
+      const auto* module_file_toc =
+          iree::vm::bytecode_module_benchmark_module_create();
+      return iree_vm_bytecode_module_create(
+          iree_const_byte_span_t{
+              reinterpret_cast<const uint8_t*>(module_file_toc->data),
+              module_file_toc->size},
+          iree_allocator_null(), iree_allocator_system(), out_module);
+    }
+    case ModuleKind::kC:
+      return bytecode_module_benchmark_create(iree_allocator_system(),
+                                              out_module);
+  }
+  return iree_make_status(IREE_STATUS_INVALID_ARGUMENT, "unknown module kind");
+}
+
+// Benchmarks the given exported function, optionally passing in arguments.
+static iree_status_t RunFunction(benchmark::State& state, ModuleKind kind,
+                                 absl::string_view function_name,
+                                 absl::Span<const int32_t> i32_args,
+                                 int result_count, int64_t batch_size = 1) {
+  iree_vm_instance_t* instance = NULL;
+  IREE_CHECK_OK(iree_vm_instance_create(iree_allocator_system(), &instance));
+
+  iree_vm_module_t* import_module = NULL;
+  IREE_CHECK_OK(
+      native_import_module_create(iree_allocator_system(), &import_module));
+
+  iree_vm_module_t* module = nullptr;
+  IREE_CHECK_OK(CreateModule(kind, &module));
+
+  std::array<iree_vm_module_t*, 2> modules = {import_module, module};
+  iree_vm_context_t* context = NULL;
+  IREE_CHECK_OK(iree_vm_context_create_with_modules(
+      instance, modules.data(), modules.size(), iree_allocator_system(),
+      &context));
+
+  iree_vm_function_t function;
+  IREE_CHECK_OK(iree_vm_context_resolve_function(
+      context,
+      iree_make_string_view(function_name.data(), function_name.size()),
+      &function));
+
+  iree_vm_function_call_t call;
+  memset(&call, 0, sizeof(call));
+  call.function = function;
+  call.arguments =
+      iree_make_byte_span(iree_alloca(i32_args.size() * sizeof(int32_t)),
+                          i32_args.size() * sizeof(int32_t));
+  call.results =
+      iree_make_byte_span(iree_alloca(result_count * sizeof(int32_t)),
+                          result_count * sizeof(int32_t));
+
+  IREE_VM_INLINE_STACK_INITIALIZE(
+      stack, iree_vm_context_state_resolver(context), iree_allocator_system());
+  while (state.KeepRunningBatch(batch_size)) {
+    for (iree_host_size_t i = 0; i < i32_args.size(); ++i) {
+      reinterpret_cast<int32_t*>(call.arguments.data)[i] = i32_args[i];
+    }
+
+    iree_vm_execution_result_t result;
+    IREE_CHECK_OK(module->begin_call(module->self, stack, &call, &result));
+  }
+  iree_vm_stack_deinitialize(stack);
+
+  iree_vm_module_release(import_module);
+  iree_vm_module_release(module);
+  iree_vm_context_release(context);
+  iree_vm_instance_release(instance);
+
+  return iree_ok_status();
+}
+
+static void BM_ModuleCreateStateBytecode(benchmark::State& state) {
+  iree_vm_module_t* module = nullptr;
+  IREE_CHECK_OK(CreateModule(ModuleKind::kBytecode, &module));
+  while (state.KeepRunning()) {
+    iree_vm_module_state_t* module_state;
+    module->alloc_state(module->self, iree_allocator_system(), &module_state);
+    benchmark::DoNotOptimize(module_state);
+    module->free_state(module->self, module_state);
+  }
+  iree_vm_module_release(module);
+}
+BENCHMARK(BM_ModuleCreateStateBytecode);
+
+static void BM_ModuleCreateStateC(benchmark::State& state) {
+  iree_vm_module_t* module = nullptr;
+  IREE_CHECK_OK(CreateModule(ModuleKind::kC, &module));
+  while (state.KeepRunning()) {
+    iree_vm_module_state_t* module_state;
+    module->alloc_state(module->self, iree_allocator_system(), &module_state);
+    benchmark::DoNotOptimize(module_state);
+    module->free_state(module->self, module_state);
+  }
+  iree_vm_module_release(module);
+}
+BENCHMARK(BM_ModuleCreateStateC);
+
+#define IREE_C_MODULE_BENCHMARK(name, function, args, result_count,         \
+                                batch_size)                                 \
+  static void BM_##name##Bytecode(benchmark::State& state) {                \
+    IREE_CHECK_OK(RunFunction(state, ModuleKind::kBytecode,                 \
+                              "bytecode_module_benchmark." function, args,  \
+                              result_count, batch_size));                   \
+  }                                                                         \
+  BENCHMARK(BM_##name##Bytecode);                                           \
+  static void BM_##name##C(benchmark::State& state) {                       \
+    IREE_CHECK_OK(RunFunction(state, ModuleKind::kC,                        \
+                              "bytecode_module_benchmark." function, args,  \
+                              result_count, batch_size));                   \
+  }                                                                         \
+  BENCHMARK(BM_##name##C);
+
+IREE_C_MODULE_BENCHMARK(EmptyFunc, "empty_func", {}, /*result_count=*/0,
+                        /*batch_size=*/1);
+IREE_C_MODULE_BENCHMARK(CallInternalFunc, "call_internal_func", {100},
+                        /*result_count=*/1, /*batch_size=*/20);
+IREE_C_MODULE_BENCHMARK(CallImportedFunc, "call_imported_func", {100},
+                        /*result_count=*/1, /*batch_size=*/20);
+IREE_C_MODULE_BENCHMARK(CallImportedFuncX2, "call_imported_func_x2", {100},
+                        /*result_count=*/1, /*batch_size=*/10);
+IREE_C_MODULE_BENCHMARK(CallImportedFuncRef, "call_imported_func_ref", {100},
+                        /*result_count=*/1, /*batch_size=*/10);
+
+static void BM_LoopSumBytecode(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(state, ModuleKind::kBytecode,
+                            "bytecode_module_benchmark.loop_sum",
+                            {static_cast<int32_t>(state.range(0))},
+                            /*result_count=*/1,
+                            /*batch_size=*/state.range(0)));
+}
+BENCHMARK(BM_LoopSumBytecode)->Arg(100000);
+
+static void BM_LoopSumC(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(state, ModuleKind::kC,
+                            "bytecode_module_benchmark.loop_sum",
+                            {static_cast<int32_t>(state.range(0))},
+                            /*result_count=*/1,
+                            /*batch_size=*/state.range(0)));
+}
+BENCHMARK(BM_LoopSumC)->Arg(100000);
+
+static void BM_LoopSumF32Bytecode(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(state, ModuleKind::kBytecode,
+                            "bytecode_module_benchmark.loop_sum_f32",
+                            {static_cast<int32_t>(state.range(0))},
+                            /*result_count=*/1,
+                            /*batch_size=*/state.range(0)));
+}
+BENCHMARK(BM_LoopSumF32Bytecode)->Arg(100000);
+
+static void BM_LoopSumF32C(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(state, ModuleKind::kC,
+                            "bytecode_module_benchmark.loop_sum_f32",
+                            {static_cast<int32_t>(state.range(0))},
+                            /*result_count=*/1,
+                            /*batch_size=*/state.range(0)));
+}
+BENCHMARK(BM_LoopSumF32C)->Arg(100000);
+
+}  // namespace
@@ -188,6 +188,19 @@ void iree_task_executor_release(iree_task_executor_t* executor) {
   }
 }
 
+void iree_task_executor_query_statistics(
+    iree_task_executor_t* executor,
+    iree_task_executor_statistics_t* out_statistics) {
+  memset(out_statistics, 0, sizeof(*out_statistics));
+  for (iree_host_size_t i = 0; i < executor->worker_count; ++i) {
+    iree_task_worker_t* worker = &executor->workers[i];
+    out_statistics->theft_attempt_count += iree_atomic_load_int64(
+        &worker->theft_attempt_count, iree_memory_order_relaxed);
+    out_statistics->theft_success_count += iree_atomic_load_int64(
+        &worker->theft_success_count, iree_memory_order_relaxed);
+  }
+}
+
 // Schedules a generic task to a worker matching its affinity.
 // The task will be posted to the worker mailbox and available for the worker to
 // begin processing as soon as the |post_batch| is submitted.
@@ -321,6 +321,24 @@ void iree_task_executor_release(iree_task_executor_t* executor);
 
 // TODO(benvanik): scheduling mode mutation, compute quota control, etc.
 
+// Statistics aggregated across all workers in an executor.
+// Counters increase monotonically over the lifetime of the executor; diff two
+// queries to measure an interval.
+typedef struct {
+  // Number of times a worker ran out of local work and tried to steal tasks
+  // from other workers.
+  int64_t theft_attempt_count;
+  // Number of theft attempts that stole at least one task.
+  int64_t theft_success_count;
+} iree_task_executor_statistics_t;
+
+// Queries the current |executor| statistics.
+// Safe to call from any thread while work is executing though the counters of
+// each worker are sampled independently and may not be mutually consistent.
+void iree_task_executor_query_statistics(
+    iree_task_executor_t* executor,
+    iree_task_executor_statistics_t* out_statistics);
+
 // Submits a batch of tasks for execution.
 // The submission represents a DAG of tasks all reachable from the initial
 // submission lists.
@@ -0,0 +1,316 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Benchmarks for the task executor and its supporting structures.
+// These are intended to provide data for the knobs in iree/task/tuning.h and
+// to catch regressions in scheduling overhead. Work performed by tasks is kept
+// small so that the executor itself dominates the measurements.
+//
+// For numbers stable enough to compare across changes pin the CPU frequency
+// and run with repetitions, for example:
+//   --benchmark_repetitions=10 --benchmark_report_aggregates_only=true
+//
+// Executor benchmarks report work-stealing counters per iteration:
+//   theft_attempts: times a worker ran dry and tried to steal
+//   thefts: attempts that stole at least one task
+
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "iree/base/api.h"
+#include "iree/base/status.h"
+#include "iree/task/executor.h"
+#include "iree/task/pool.h"
+#include "iree/task/scope.h"
+#include "iree/task/submission.h"
+#include "iree/task/task.h"
+#include "iree/task/topology.h"
+
+namespace {
+
+//==============================================================================
+// Utilities
+//==============================================================================
+
+// Emulates |count| units of work performed by a task.
+void SpinWork(int count) {
+  int data = 0;
+  for (int i = 0; i < count; ++i) {
+    ++data;
+    benchmark::DoNotOptimize(data);
+  }
+}
+
+// An executor with |worker_count| unpinned workers and a scope for submissions.
+class BenchmarkExecutor {
+ public:
+  explicit BenchmarkExecutor(int worker_count) {
+    iree_task_topology_t* topology = NULL;
+    IREE_CHECK_OK(iree_task_topology_from_group_count(
+        worker_count, iree_allocator_system(), &topology));
+    IREE_CHECK_OK(iree_task_executor_create(IREE_TASK_SCHEDULING_MODE_RESERVED,
+                                            topology, iree_allocator_system(),
+                                            &executor_));
+    iree_task_topology_free(topology);
+    iree_task_scope_initialize(iree_make_cstring_view("benchmark"), &scope_);
+  }
+
+  ~BenchmarkExecutor() {
+    iree_task_scope_deinitialize(&scope_);
+    iree_task_executor_release(executor_);
+  }
+
+  iree_task_scope_t* scope() { return &scope_; }
+
+  // Submits the DAG starting at |head| and waits for it to complete.
+  // |tail| is the last task in the DAG and will be given a fence so that the
+  // scope can track completion.
+  void SubmitAndWait(iree_task_t* head, iree_task_t* tail) {
+    iree_task_fence_t fence;
+    iree_task_fence_initialize(&scope_, &fence);
+    iree_task_set_completion_task(tail, &fence.header);
+
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    iree_task_submission_enqueue(&submission, head);
+    IREE_CHECK_OK(iree_task_executor_submit(executor_, &submission));
+    IREE_CHECK_OK(iree_task_executor_flush(executor_));
+    IREE_CHECK_OK(
+        iree_task_scope_wait_idle(&scope_, IREE_TIME_INFINITE_FUTURE));
+  }
+
+  // Starts tracking executor counters for reporting at the end of a run.
+  void BeginCounters() {
+    iree_task_executor_query_statistics(executor_, &begin_statistics_);
+  }
+
+  // Reports executor counters accumulated since BeginCounters as per-iteration
+  // averages.
+  void ReportCounters(benchmark::State& state) {
+    iree_task_executor_statistics_t end_statistics;
+    iree_task_executor_query_statistics(executor_, &end_statistics);
+    state.counters["theft_attempts"] = benchmark::Counter(
+        static_cast<double>(end_statistics.theft_attempt_count -
+                            begin_statistics_.theft_attempt_count),
+        benchmark::Counter::kAvgIterations);
+    state.counters["thefts"] = benchmark::Counter(
+        static_cast<double>(end_statistics.theft_success_count -
+                            begin_statistics_.theft_success_count),
+        benchmark::Counter::kAvgIterations);
+  }
+
+ private:
+  iree_task_executor_t* executor_ = NULL;
+  iree_task_scope_t scope_;
+  iree_task_executor_statistics_t begin_statistics_;
+};
+
+//==============================================================================
+// Submit-to-completion latency
+//==============================================================================
+
+// Measures the round-trip of submitting a single trivial task and waiting for
+// the scope to go idle. This is the fixed overhead paid by every submission.
+void BM_SubmitToCompletion(benchmark::State& state) {
+  BenchmarkExecutor executor(state.range(0));
+  iree_task_call_t call;
+  auto closure = iree_task_make_closure(
+      [](uintptr_t user_context, uintptr_t task_context) {
+        return iree_ok_status();
+      },
+      0);
+
+  // Warm up so that worker startup is not included in the measurements.
+  iree_task_call_initialize(executor.scope(), closure, &call);
+  executor.SubmitAndWait(&call.header, &call.header);
+
+  executor.BeginCounters();
+  for (auto _ : state) {
+    iree_task_call_initialize(executor.scope(), closure, &call);
+    executor.SubmitAndWait(&call.header, &call.header);
+  }
+  executor.ReportCounters(state);
+}
+BENCHMARK(BM_SubmitToCompletion)
+    ->ArgName("workers")
+    ->RangeMultiplier(2)
+    ->Range(1, 64)
+    ->UseRealTime();
+
+//==============================================================================
+// Fan-out/fan-in DAG throughput
+//==============================================================================
+
+// Measures a barrier fanning out to |width| independent calls that all join on
+// a single call. Reports the fanned-out calls executed per second.
+void BM_FanOutFanIn(benchmark::State& state) {
+  BenchmarkExecutor executor(state.range(0));
+  int width = state.range(1);
+  auto closure = iree_task_make_closure(
+      [](uintptr_t user_context, uintptr_t task_context) {
+        SpinWork(static_cast<int>(user_context));
+        return iree_ok_status();
+      },
+      /*work=*/64);
+  auto join_closure = iree_task_make_closure(
+      [](uintptr_t user_context, uintptr_t task_context) {
+        return iree_ok_status();
+      },
+      0);
+
+  std::vector<iree_task_call_t> calls(width);
+  std::vector<iree_task_t*> call_tasks(width);
+  for (int i = 0; i < width; ++i) call_tasks[i] = &calls[i].header;
+  iree_task_barrier_t barrier;
+  iree_task_call_t join;
+  auto run_once = [&]() {
+    iree_task_call_initialize(executor.scope(), join_closure, &join);
+    for (auto& call : calls) {
+      iree_task_call_initialize(executor.scope(), closure, &call);
+      iree_task_set_completion_task(&call.header, &join.header);
+    }
+    iree_task_barrier_initialize(executor.scope(), call_tasks.size(),
+                                 call_tasks.data(), &barrier);
+    executor.SubmitAndWait(&barrier.header, &join.header);
+  };
+
+  run_once();
+  executor.BeginCounters();
+  for (auto _ : state) {
+    run_once();
+  }
+  executor.ReportCounters(state);
+  state.SetItemsProcessed(state.iterations() * width);
+}
+void FanOutFanInArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"workers", "width"});
+  for (int workers : {1, 4, 16, 64}) {
+    for (int width : {16, 256}) {
+      benchmark->Args({workers, width});
+    }
+  }
+}
+BENCHMARK(BM_FanOutFanIn)->Apply(FanOutFanInArgs)->UseRealTime();
+
+//==============================================================================
+// Dispatch slice vs. shard scaling
+//==============================================================================
+
+// Tiles per dispatch; large enough to produce many slices/shard reservations.
+constexpr uint32_t kDispatchTileCount = 4096;
+
+// Work performed per tile. When |user_context| is non-zero the first 1/8th of
+// the tiles are 16x more expensive to force imbalance and exercise stealing.
+iree_status_t DispatchTile(uintptr_t user_context, uintptr_t task_context) {
+  const auto* tile_context =
+      reinterpret_cast<const iree_task_tile_context_t*>(task_context);
+  bool heavy = user_context &&
+               tile_context->workgroup_xyz[0] < kDispatchTileCount / 8;
+  SpinWork(heavy ? 16 * 64 : 64);
+  return iree_ok_status();
+}
+
+// Measures a dispatch of kDispatchTileCount tiles across range(0) workers.
+// range(1) selects a uniform (0) or skewed (1) per-tile cost.
+void BenchmarkDispatch(benchmark::State& state, bool sliced) {
+  BenchmarkExecutor executor(state.range(0));
+  auto closure = iree_task_make_closure(DispatchTile, state.range(1));
+  const uint32_t workgroup_size[3] = {1, 1, 1};
+  const uint32_t workgroup_count[3] = {kDispatchTileCount, 1, 1};
+
+  iree_task_dispatch_t dispatch;
+  auto run_once = [&]() {
+    iree_task_dispatch_initialize(executor.scope(), closure, workgroup_size,
+                                  workgroup_count, &dispatch);
+    if (sliced) dispatch.header.flags |= IREE_TASK_FLAG_DISPATCH_SLICED;
+    executor.SubmitAndWait(&dispatch.header, &dispatch.header);
+  };
+
+  run_once();
+  executor.BeginCounters();
+  for (auto _ : state) {
+    run_once();
+  }
+  executor.ReportCounters(state);
+  state.SetItemsProcessed(state.iterations() * kDispatchTileCount);
+}
+
+void DispatchArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"workers", "skewed"});
+  for (int workers = 1; workers <= 64; workers *= 2) {
+    for (int skewed : {0, 1}) {
+      benchmark->Args({workers, skewed});
+    }
+  }
+}
+
+void BM_DispatchSliced(benchmark::State& state) {
+  BenchmarkDispatch(state, /*sliced=*/true);
+}
+BENCHMARK(BM_DispatchSliced)->Apply(DispatchArgs)->UseRealTime();
+
+void BM_DispatchSharded(benchmark::State& state) {
+  BenchmarkDispatch(state, /*sliced=*/false);
+}
+BENCHMARK(BM_DispatchSharded)->Apply(DispatchArgs)->UseRealTime();
+
+//==============================================================================
+// iree_task_pool_t
+//==============================================================================
+
+// Pool shared by all benchmark threads, sized like the executor shard pool.
+// Never deinitialized as benchmark threads may still be running at exit.
+iree_task_pool_t* SharedTaskPool() {
+  static iree_task_pool_t* pool = ([]() -> iree_task_pool_t* {
+    auto* pool = new iree_task_pool_t();
+    IREE_CHECK_OK(iree_task_pool_initialize(iree_allocator_system(),
+                                            sizeof(iree_task_dispatch_shard_t),
+                                            /*initial_capacity=*/64, pool));
+    return pool;
+  })();
+  return pool;
+}
+
+// Acquires a task from |pool| and associates it with the pool as the task
+// initializers in the executor do.
+iree_task_t* AcquireTask(iree_task_pool_t* pool) {
+  iree_task_t* task = NULL;
+  IREE_CHECK_OK(iree_task_pool_acquire(pool, &task));
+  task->pool = pool;
+  return task;
+}
+
+// Measures acquiring and immediately releasing a single task with range(0)
+// tasks held by each thread across iterations to vary the pool depth.
+void BM_PoolAcquireRelease(benchmark::State& state) {
+  iree_task_pool_t* pool = SharedTaskPool();
+  std::vector<iree_task_t*> held_tasks(state.range(0));
+  for (auto& task : held_tasks) task = AcquireTask(pool);
+  for (auto _ : state) {
+    iree_task_t* task = AcquireTask(pool);
+    benchmark::DoNotOptimize(task);
+    iree_task_pool_release(pool, task);
+  }
+  for (auto* task : held_tasks) {
+    iree_task_pool_release(pool, task);
+  }
+}
+BENCHMARK(BM_PoolAcquireRelease)
+    ->ArgName("held")
+    ->Arg(0)
+    ->Arg(16)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+
+}  // namespace
@@ -14,9 +14,12 @@
 
 #include "iree/task/executor.h"
 
+#include <chrono>
 #include <thread>
 
 #include "iree/base/math.h"
+#include "iree/base/synchronization.h"
+#include "iree/task/executor_impl.h"
 #include "iree/testing/gtest.h"
 #include "iree/testing/status_matchers.h"
 
@@ -178,4 +181,85 @@ TEST(ExecutorTest, Any) {
   iree_task_executor_release(executor);
 }
 
+// Regression test for a lost wakeup: a worker that readies a fence merges it
+// into the executor and then tries to coordinate. If another thread holds the
+// coordinator lock at that moment (and has already drained the incoming lists)
+// the worker must wait for the lock instead of going idle, otherwise nothing
+// ever schedules the fence and the scope never goes idle.
+TEST(ExecutorTest, WorkerReadiesFenceWhileCoordinatorLocked) {
+  iree_allocator_t allocator = iree_allocator_system();
+
+  iree_task_topology_t* topology = NULL;
+  IREE_ASSERT_OK(iree_task_topology_from_group_count(/*group_count=*/2,
+                                                     allocator, &topology));
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(IREE_TASK_SCHEDULING_MODE_RESERVED,
+                                           topology, allocator, &executor));
+  iree_task_topology_free(topology);
+
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("scope"), &scope);
+
+  struct State {
+    iree_atomic_int32_t call_started;
+    iree_atomic_int32_t lock_held;
+  } state;
+  iree_atomic_store_int32(&state.call_started, 0, iree_memory_order_relaxed);
+  iree_atomic_store_int32(&state.lock_held, 0, iree_memory_order_relaxed);
+
+  // The call blocks until the test thread holds the coordinator lock so that
+  // the worker's post-execution coordination always finds it taken.
+  iree_task_call_t call;
+  iree_task_call_initialize(
+      &scope,
+      iree_task_make_closure(
+          [](uintptr_t user_context, uintptr_t task_context) {
+            auto* state = (State*)user_context;
+            iree_atomic_store_int32(&state->call_started, 1,
+                                    iree_memory_order_release);
+            while (!iree_atomic_load_int32(&state->lock_held,
+                                           iree_memory_order_acquire)) {
+              std::this_thread::yield();
+            }
+            return iree_ok_status();
+          },
+          (uintptr_t)&state),
+      &call);
+  iree_task_fence_t fence;
+  iree_task_fence_initialize(&scope, &fence);
+  iree_task_set_completion_task(&call.header, &fence.header);
+
+  iree_task_submission_t submission;
+  iree_task_submission_initialize(&submission);
+  iree_task_submission_enqueue(&submission, &call.header);
+  IREE_ASSERT_OK(iree_task_executor_submit(executor, &submission));
+  IREE_ASSERT_OK(iree_task_executor_flush(executor));
+
+  // Wait for the call to be running on a worker, then hold the coordinator
+  // lock across the completion of the call and the merge of the fence.
+  while (!iree_atomic_load_int32(&state.call_started,
+                                 iree_memory_order_acquire)) {
+    std::this_thread::yield();
+  }
+  iree_slim_mutex_lock(&executor->coordinator_mutex);
+  iree_atomic_store_int32(&state.lock_held, 1, iree_memory_order_release);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  iree_slim_mutex_unlock(&executor->coordinator_mutex);
+
+  // The fence must be scheduled without any further submissions or flushes.
+  // iree_task_scope_wait_idle ignores its deadline so poll to fail instead of
+  // hanging if the fence was lost.
+  for (int i = 0; i < 5000 && !iree_task_scope_is_idle(&scope); ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_TRUE(iree_task_scope_is_idle(&scope));
+
+  // Unstick the fence (if it was lost) so that the scope can be torn down.
+  IREE_ASSERT_OK(iree_task_executor_flush(executor));
+  IREE_ASSERT_OK(iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
+
+  iree_task_scope_deinitialize(&scope);
+  iree_task_executor_release(executor);
+}
+
 }  // namespace
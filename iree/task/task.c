@@ -75,8 +75,12 @@ void iree_task_discard(iree_task_t* task, iree_task_list_t* discard_worklist) {
     case IREE_TASK_TYPE_FENCE: {
       // TODO(benvanik): signal as error.
       // iree_task_fence_t* fence_task = (iree_task_fence_t*)task;
-      iree_atomic_fetch_sub_int32(&task->scope->pending_submissions, 1,
-                                  iree_memory_order_relaxed);
+      if (iree_atomic_fetch_sub_int32(&task->scope->pending_submissions, 1,
+                                      iree_memory_order_acq_rel) == 1) {
+        // Ensure waiters are woken even if the submission never completed.
+        iree_notification_post(&task->scope->idle_notification,
+                               IREE_ALL_WAITERS);
+      }
       break;
     }
     case IREE_TASK_TYPE_WAIT:
@@ -36,6 +36,10 @@ iree_status_t iree_task_worker_initialize(
       executor->worker_count / IREE_TASK_EXECUTOR_MAX_THEFT_ATTEMPTS_DIVISOR;
   iree_prng_minilcg128_initialize(iree_prng_splitmix64_next(seed_prng),
                                   &out_worker->theft_prng);
+  iree_atomic_store_int64(&out_worker->theft_attempt_count, 0,
+                          iree_memory_order_relaxed);
+  iree_atomic_store_int64(&out_worker->theft_success_count, 0,
+                          iree_memory_order_relaxed);
 
   iree_task_worker_state_t initial_state = IREE_TASK_WORKER_STATE_RUNNING;
   if (executor->scheduling_mode &
@@ -163,11 +167,24 @@ iree_task_t* iree_task_worker_try_steal_task(iree_task_worker_t* worker,
   return NULL;
 }
 
+// Increments a statistics |counter| owned by the worker thread.
+// As only the worker writes its counters this avoids the locked read-modify-
+// write of an atomic add while still allowing other threads to read them.
+static inline void iree_task_worker_increment_counter(
+    iree_atomic_int64_t* counter) {
+  iree_atomic_store_int64(
+      counter, iree_atomic_load_int64(counter, iree_memory_order_relaxed) + 1,
+      iree_memory_order_relaxed);
+}
+
 // Executes a task on a worker.
 // Only task types that are scheduled to workers are handled; all others must be
-// handled by the coordinator during scheduling.
+// handled by the coordinator during scheduling. |out_merged| is set to true if
+// the task readied other tasks that were merged into the executor and will need
+// coordination.
 static iree_status_t iree_task_worker_execute(iree_task_worker_t* worker,
-                                              iree_task_t* task) {
+                                              iree_task_t* task,
+                                              bool* out_merged) {
   // Execute the task and resolve the task and gather any tasks that are now
   // ready for submission to the executor. They'll be scheduled the next time
   // the coordinator runs.
@@ -204,14 +221,17 @@ static iree_status_t iree_task_worker_execute(iree_task_worker_t* worker,
 
   if (!iree_task_submission_is_empty(&pending_submission)) {
     iree_task_executor_merge_submission(worker->executor, &pending_submission);
+    *out_merged = true;
   }
   return iree_ok_status();
 }
 
 // Pumps the worker thread once, processing a single task.
 // Returns true if pumping should continue as there are more tasks remaining or
-// false if the caller should wait for more tasks to be posted.
-static bool iree_task_worker_pump_once(iree_task_worker_t* worker) {
+// false if the caller should wait for more tasks to be posted. |out_merged| is
+// set to true if the task readied other tasks that need coordination.
+static bool iree_task_worker_pump_once(iree_task_worker_t* worker,
+                                       bool* out_merged) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
   // Check the local work queue for any work we know we should start
@@ -242,6 +262,8 @@ static bool iree_task_worker_pump_once(iree_task_worker_t* worker) {
         worker->executor, worker->constructive_sharing_mask,
         worker->max_theft_attempts, &worker->theft_prng,
         &worker->local_task_queue);
+    iree_task_worker_increment_counter(&worker->theft_attempt_count);
+    if (task) iree_task_worker_increment_counter(&worker->theft_success_count);
   }
 
   // No tasks to run; let the caller know we want to wait for more.
@@ -252,7 +274,7 @@ static bool iree_task_worker_pump_once(iree_task_worker_t* worker) {
 
   // Execute the task (may call out to arbitrary user code and may submit more
   // tasks for execution).
-  iree_status_t status = iree_task_worker_execute(worker, task);
+  iree_status_t status = iree_task_worker_execute(worker, task, out_merged);
 
   // TODO(#4026): propagate failure to task scope.
   // We currently drop the error on the floor here; that's because the error
@@ -294,7 +316,8 @@ static void iree_task_worker_pump_until_exit(iree_task_worker_t* worker) {
                                             ~worker->worker_bit,
                                             iree_memory_order_relaxed);
 
-    while (iree_task_worker_pump_once(worker)) {
+    bool merged = false;
+    while (iree_task_worker_pump_once(worker, &merged)) {
       // All work done ^, which will return false when the worker should wait.
     }
 
@@ -306,8 +329,14 @@ static void iree_task_worker_pump_until_exit(iree_task_worker_t* worker) {
 
     // First self-nominate; this *may* do something or just be ignored (if
     // another worker is already coordinating).
+    //
+    // If we readied tasks and merged them into the executor we must not skip
+    // coordination: the current coordinator may have already drained the
+    // incoming lists before our merge and nothing else would pick the tasks up
+    // before everyone went idle. Waiting for the lock ensures they get
+    // scheduled by us if not by the other coordinator.
     iree_task_executor_coordinate(worker->executor, worker,
-                                  /*speculative=*/true);
+                                  /*speculative=*/!merged);
 
     // If nothing has been enqueued since we started this loop (so even
     // coordination didn't find anything) we go idle. Otherwise we fall
@@ -108,6 +108,12 @@ typedef struct iree_task_worker_s {
   // Only ever touched by the worker thread as it steals work.
   iree_prng_minilcg128_state_t theft_prng;
 
+  // Work-stealing statistics. Only ever written by the worker thread (so no
+  // read-modify-write contention) but may be read from any thread when
+  // aggregated by iree_task_executor_query_statistics.
+  iree_atomic_int64_t theft_attempt_count;
+  iree_atomic_int64_t theft_success_count;
+
   // Thread handle of the worker. If the thread has exited the handle will
   // remain valid so that the executor can query its state.
   iree_thread_t* thread;
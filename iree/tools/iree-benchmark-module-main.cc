@@ -12,14 +12,26 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <thread>  // NOLINT
+
 #include "absl/flags/flag.h"
 #include "absl/flags/internal/parse.h"
 #include "absl/flags/usage.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/time.h"
 #include "benchmark/benchmark.h"
-#include "iree/base/file_io.h"
 #include "iree/base/flags.h"
 #include "iree/base/status.h"
+#include "iree/base/target_platform.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/drivers/init.h"
 #include "iree/modules/hal/hal_module.h"
@@ -27,6 +39,11 @@
 #include "iree/vm/api.h"
 #include "iree/vm/bytecode_module.h"
 
+#if defined(IREE_PLATFORM_APPLE) || defined(IREE_PLATFORM_ANDROID) || \
+    defined(IREE_PLATFORM_LINUX)
+#include <sys/resource.h>
+#endif  // IREE_PLATFORM_APPLE || IREE_PLATFORM_ANDROID || IREE_PLATFORM_LINUX
+
 ABSL_FLAG(std::string, module_file, "-",
           "File containing the module to load that contains the entry "
           "function. Defaults to stdin.");
@@ -54,9 +71,72 @@ ABSL_FLAG(std::string, function_inputs_file, "",
           "Provides a file for input shapes and optional values (see "
           "ParseToVariantListFromFile in vm_util.h for details)");
 
+ABSL_FLAG(int32_t, batch_size, 1,
+          "Number of invocations of the function performed per benchmark "
+          "iteration with iree_vm_invoke_batch. All invocations use the same "
+          "inputs. Values greater than 1 measure the amortized per-call cost "
+          "and report it as items/s.");
+
+ABSL_FLAG(int32_t, load_threads, 0,
+          "Number of client threads issuing invocations concurrently. When "
+          "greater than 0 the benchmark library is bypassed and a load test is "
+          "run against each selected function instead, reporting latency "
+          "percentiles, achieved QPS, and peak RSS as JSON.");
+
+ABSL_FLAG(std::string, load_context_mode, "per_thread",
+          "How client threads share VM contexts in load mode: 'per_thread' "
+          "gives each client its own context and 'shared' has all clients "
+          "invoke on a single context. Contexts are thread-compatible so "
+          "invocations on a shared context are serialized.");
+
+ABSL_FLAG(double, load_qps, 0,
+          "Aggregate arrival rate across all clients in load mode. 0 runs "
+          "closed-loop with each client issuing its next invocation as soon as "
+          "the previous one completes. Values greater than 0 run open-loop "
+          "with arrivals at fixed intervals; latency is measured from the "
+          "scheduled arrival so time queued behind slow invocations counts.");
+
+ABSL_FLAG(absl::Duration, load_warmup, absl::Seconds(1),
+          "Time spent issuing invocations in load mode before latencies are "
+          "recorded.");
+
+ABSL_FLAG(absl::Duration, load_duration, absl::Seconds(10),
+          "Time spent recording latencies in load mode after the warmup.");
+
+ABSL_FLAG(std::string, load_output, "-",
+          "File the load mode JSON report is written to. Defaults to stdout.");
+
 namespace iree {
 namespace {
 
+static void BenchmarkFunctionBatch(
+    iree_vm_context_t* context, iree_vm_function_t function,
+    iree_vm_list_t* inputs,
+    const std::vector<RawSignatureParser::Description>& output_descs,
+    int32_t batch_size, benchmark::State& state) {
+  std::vector<iree_vm_list_t*> batch_inputs(batch_size, inputs);
+  // Output lists are reused across iterations; each invocation releases the
+  // results of the previous one when it resets the list.
+  std::vector<vm::ref<iree_vm_list_t>> outputs(batch_size);
+  std::vector<iree_vm_list_t*> batch_outputs(batch_size);
+  for (int32_t i = 0; i < batch_size; ++i) {
+    IREE_CHECK_OK(iree_vm_list_create(/*element_type=*/nullptr,
+                                      output_descs.size(),
+                                      iree_allocator_system(), &outputs[i]));
+    batch_outputs[i] = outputs[i].get();
+  }
+
+  // Benchmarking loop.
+  for (auto _ : state) {
+    IREE_TRACE_SCOPE0("BenchmarkIteration");
+    IREE_TRACE_FRAME_MARK_NAMED("Iteration");
+    IREE_CHECK_OK(iree_vm_invoke_batch(
+        context, function, /*policy=*/nullptr, batch_size, batch_inputs.data(),
+        batch_outputs.data(), iree_allocator_system()));
+  }
+  state.SetItemsProcessed(state.iterations() * batch_size);
+}
+
 static void BenchmarkFunction(
     const std::string& benchmark_name, iree_vm_context_t* context,
     iree_vm_function_t function, iree_vm_list_t* inputs,
@@ -65,14 +145,24 @@ static void BenchmarkFunction(
   IREE_TRACE_SCOPE_DYNAMIC(benchmark_name.c_str());
   IREE_TRACE_FRAME_MARK();
 
+  int32_t batch_size = absl::GetFlag(FLAGS_batch_size);
+  if (batch_size > 1) {
+    BenchmarkFunctionBatch(context, function, inputs, output_descs, batch_size,
+                           state);
+    return;
+  }
+
+  // Output list reused across iterations to keep list allocation out of the
+  // measured invocation path.
+  vm::ref<iree_vm_list_t> outputs;
+  IREE_CHECK_OK(iree_vm_list_create(/*element_type=*/nullptr,
+                                    output_descs.size(),
+                                    iree_allocator_system(), &outputs));
+
   // Benchmarking loop.
   for (auto _ : state) {
     IREE_TRACE_SCOPE0("BenchmarkIteration");
     IREE_TRACE_FRAME_MARK_NAMED("Iteration");
-    vm::ref<iree_vm_list_t> outputs;
-    IREE_CHECK_OK(iree_vm_list_create(/*element_type=*/nullptr,
-                                      output_descs.size(),
-                                      iree_allocator_system(), &outputs));
     IREE_CHECK_OK(iree_vm_invoke(context, function, /*policy=*/nullptr, inputs,
                                  outputs.get(), iree_allocator_system()));
   }
@@ -105,17 +195,238 @@ void RegisterModuleBenchmarks(
       ->Unit(benchmark::kMillisecond);
 }
 
-StatusOr<std::string> GetModuleContentsFromFlags() {
-  IREE_TRACE_SCOPE0("GetModuleContentsFromFlags");
-  auto module_file = absl::GetFlag(FLAGS_module_file);
-  std::string contents;
-  if (module_file == "-") {
-    contents = std::string{std::istreambuf_iterator<char>(std::cin),
-                           std::istreambuf_iterator<char>()};
-  } else {
-    IREE_ASSIGN_OR_RETURN(contents, file_io::GetFileContents(module_file));
+using LoadClock = std::chrono::steady_clock;
+
+// Arrival schedule shared by all load clients.
+struct LoadSchedule {
+  // Time the first invocation may be issued.
+  LoadClock::time_point start_time;
+  // Invocations issued before this time are warmup and not recorded.
+  LoadClock::time_point measure_time;
+  // No invocations are issued at or after this time.
+  LoadClock::time_point end_time;
+  // Aggregate arrival rate for open-loop runs or 0 for closed-loop runs.
+  double qps;
+  // Next open-loop arrival index to claim.
+  std::atomic<int64_t> next_arrival{0};
+};
+
+// Latencies and completion time recorded by a single load client.
+struct LoadClientResult {
+  std::vector<int64_t> latencies_ns;
+  LoadClock::time_point last_completion_time;
+  Status status;
+};
+
+// Issues invocations of |function| on |context| according to |schedule| until
+// the schedule ends. |context_mutex| is held across each invocation when the
+// context is shared with other clients and may be nullptr otherwise.
+static Status RunLoadClient(iree_vm_context_t* context,
+                            absl::Mutex* context_mutex,
+                            iree_vm_function_t function,
+                            iree_vm_list_t* inputs,
+                            iree_host_size_t output_count,
+                            LoadSchedule* schedule, LoadClientResult* result) {
+  IREE_TRACE_SCOPE0("RunLoadClient");
+  vm::ref<iree_vm_list_t> outputs;
+  IREE_RETURN_IF_ERROR(iree_vm_list_create(/*element_type=*/nullptr,
+                                           output_count,
+                                           iree_allocator_system(), &outputs));
+  while (true) {
+    LoadClock::time_point issue_time;
+    if (schedule->qps > 0) {
+      // Open-loop: claim the next arrival slot and wait for it. A client that
+      // falls behind issues immediately and the delay shows up as latency.
+      int64_t arrival = schedule->next_arrival.fetch_add(1);
+      issue_time = schedule->start_time +
+                   std::chrono::duration_cast<LoadClock::duration>(
+                       std::chrono::duration<double>(arrival / schedule->qps));
+      if (issue_time >= schedule->end_time) break;
+      std::this_thread::sleep_until(issue_time);
+    } else {
+      issue_time = LoadClock::now();
+      if (issue_time >= schedule->end_time) break;
+    }
+
+    {
+      IREE_TRACE_SCOPE0("LoadInvocation");
+      absl::MutexLockMaybe lock(context_mutex);
+      IREE_RETURN_IF_ERROR(iree_vm_invoke(context, function, /*policy=*/nullptr,
+                                          inputs, outputs.get(),
+                                          iree_allocator_system()));
+    }
+
+    auto completion_time = LoadClock::now();
+    if (issue_time >= schedule->measure_time) {
+      result->latencies_ns.push_back(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(completion_time -
+                                                               issue_time)
+              .count());
+      result->last_completion_time = completion_time;
+    }
+  }
+  return OkStatus();
+}
+
+// Returns the peak resident set size of the process in bytes or 0 if the
+// platform does not expose it.
+static int64_t GetPeakResidentSetSize() {
+#if defined(IREE_PLATFORM_APPLE)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+  return static_cast<int64_t>(usage.ru_maxrss);
+#elif defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+  return static_cast<int64_t>(usage.ru_maxrss) * 1024;
+#else
+  return 0;
+#endif  // IREE_PLATFORM_*
+}
+
+// Summary of a load test run against a single function.
+struct LoadReport {
+  std::string function_name;
+  int64_t invocations = 0;
+  double seconds = 0;
+  double achieved_qps = 0;
+  int64_t min_ns = 0;
+  double mean_ns = 0;
+  int64_t p50_ns = 0;
+  int64_t p90_ns = 0;
+  int64_t p99_ns = 0;
+  int64_t p999_ns = 0;
+  int64_t max_ns = 0;
+  int64_t peak_rss_bytes = 0;
+};
+
+// Returns the nearest-rank |percentile| (0-1] of |sorted_values|.
+static int64_t NearestRankPercentile(const std::vector<int64_t>& sorted_values,
+                                     double percentile) {
+  if (sorted_values.empty()) return 0;
+  size_t rank = static_cast<size_t>(
+      std::ceil(percentile * static_cast<double>(sorted_values.size())));
+  rank = std::min(std::max(rank, static_cast<size_t>(1)), sorted_values.size());
+  return sorted_values[rank - 1];
+}
+
+static LoadReport SummarizeLoad(const std::string& function_name,
+                                const LoadSchedule& schedule,
+                                std::vector<LoadClientResult>& results) {
+  LoadReport report;
+  report.function_name = function_name;
+
+  std::vector<int64_t> latencies_ns;
+  LoadClock::time_point last_completion_time = schedule.measure_time;
+  for (auto& result : results) {
+    latencies_ns.insert(latencies_ns.end(), result.latencies_ns.begin(),
+                        result.latencies_ns.end());
+    if (!result.latencies_ns.empty()) {
+      last_completion_time =
+          std::max(last_completion_time, result.last_completion_time);
+    }
+  }
+  std::sort(latencies_ns.begin(), latencies_ns.end());
+
+  // The measured window runs until the last recorded invocation completes so
+  // that invocations issued near the end are not counted as free.
+  report.invocations = static_cast<int64_t>(latencies_ns.size());
+  report.seconds = std::chrono::duration<double>(
+                       std::max(last_completion_time, schedule.end_time) -
+                       schedule.measure_time)
+                       .count();
+  report.achieved_qps =
+      report.seconds > 0 ? report.invocations / report.seconds : 0;
+  if (!latencies_ns.empty()) {
+    double total_ns = 0;
+    for (int64_t latency_ns : latencies_ns) total_ns += latency_ns;
+    report.min_ns = latencies_ns.front();
+    report.mean_ns = total_ns / latencies_ns.size();
+    report.p50_ns = NearestRankPercentile(latencies_ns, 0.50);
+    report.p90_ns = NearestRankPercentile(latencies_ns, 0.90);
+    report.p99_ns = NearestRankPercentile(latencies_ns, 0.99);
+    report.p999_ns = NearestRankPercentile(latencies_ns, 0.999);
+    report.max_ns = latencies_ns.back();
+  }
+  report.peak_rss_bytes = GetPeakResidentSetSize();
+  return report;
+}
+
+// Writes |value| as a JSON string literal.
+static void WriteJsonString(std::ostream& os, absl::string_view value) {
+  os << '"';
+  for (char c : value) {
+    switch (c) {
+      case '"':
+        os << "\\\"";
+        break;
+      case '\\':
+        os << "\\\\";
+        break;
+      case '\n':
+        os << "\\n";
+        break;
+      default:
+        os << c;
+        break;
+    }
+  }
+  os << '"';
+}
+
+// Writes the load mode report as JSON. Keys are emitted in a fixed order with
+// one value per line so that reports from different runs diff cleanly.
+static void WriteLoadReportJson(std::ostream& os,
+                                const std::vector<LoadReport>& reports) {
+  auto us = [](double ns) { return ns / 1000.0; };
+  os << std::fixed << std::setprecision(3);
+  os << "{\n";
+  os << "  \"config\": {\n";
+  os << "    \"driver\": ";
+  WriteJsonString(os, absl::GetFlag(FLAGS_driver));
+  os << ",\n";
+  os << "    \"module_file\": ";
+  WriteJsonString(os, absl::GetFlag(FLAGS_module_file));
+  os << ",\n";
+  os << "    \"threads\": " << absl::GetFlag(FLAGS_load_threads) << ",\n";
+  os << "    \"context_mode\": ";
+  WriteJsonString(os, absl::GetFlag(FLAGS_load_context_mode));
+  os << ",\n";
+  os << "    \"arrival\": ";
+  WriteJsonString(os, absl::GetFlag(FLAGS_load_qps) > 0 ? "open_loop"
+                                                        : "closed_loop");
+  os << ",\n";
+  os << "    \"target_qps\": " << absl::GetFlag(FLAGS_load_qps) << ",\n";
+  os << "    \"warmup_seconds\": "
+     << absl::ToDoubleSeconds(absl::GetFlag(FLAGS_load_warmup)) << ",\n";
+  os << "    \"duration_seconds\": "
+     << absl::ToDoubleSeconds(absl::GetFlag(FLAGS_load_duration)) << "\n";
+  os << "  },\n";
+  os << "  \"results\": [";
+  for (size_t i = 0; i < reports.size(); ++i) {
+    const auto& report = reports[i];
+    os << (i ? ",\n" : "\n");
+    os << "    {\n";
+    os << "      \"function\": ";
+    WriteJsonString(os, report.function_name);
+    os << ",\n";
+    os << "      \"invocations\": " << report.invocations << ",\n";
+    os << "      \"seconds\": " << report.seconds << ",\n";
+    os << "      \"achieved_qps\": " << report.achieved_qps << ",\n";
+    os << "      \"latency_us\": {\n";
+    os << "        \"min\": " << us(report.min_ns) << ",\n";
+    os << "        \"mean\": " << us(report.mean_ns) << ",\n";
+    os << "        \"p50\": " << us(report.p50_ns) << ",\n";
+    os << "        \"p90\": " << us(report.p90_ns) << ",\n";
+    os << "        \"p99\": " << us(report.p99_ns) << ",\n";
+    os << "        \"p999\": " << us(report.p999_ns) << ",\n";
+    os << "        \"max\": " << us(report.max_ns) << "\n";
+    os << "      },\n";
+    os << "      \"peak_rss_bytes\": " << report.peak_rss_bytes << "\n";
+    os << "    }";
   }
-  return contents;
+  os << (reports.empty() ? "]\n" : "\n  ]\n");
+  os << "}\n";
 }
 
 // TODO(hanchung): Consider to refactor this out and reuse in iree-run-module.
@@ -151,22 +462,124 @@ class IREEBenchmark {
       IREE_RETURN_IF_ERROR(Init());
     }
 
-    auto function_name = absl::GetFlag(FLAGS_entry_function);
-    if (!function_name.empty()) {
-      IREE_RETURN_IF_ERROR(RegisterSpecificFunction(function_name));
+    std::vector<FunctionTarget> targets;
+    IREE_RETURN_IF_ERROR(ResolveFunctions(&targets));
+    for (const auto& target : targets) {
+      RegisterModuleBenchmarks(target.name, context_, target.function,
+                               target.inputs, target.output_descs);
+    }
+    return iree::OkStatus();
+  }
+
+  // Runs a load test against each selected function and writes the JSON
+  // report to --load_output.
+  Status RunLoad() {
+    IREE_TRACE_SCOPE0("IREEBenchmark::RunLoad");
+
+    int32_t thread_count = absl::GetFlag(FLAGS_load_threads);
+    auto context_mode = absl::GetFlag(FLAGS_load_context_mode);
+    bool shared_context = context_mode == "shared";
+    if (!shared_context && context_mode != "per_thread") {
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "Unknown --load_context_mode '" << context_mode
+             << "'; expected 'per_thread' or 'shared'";
+    } else if (absl::GetFlag(FLAGS_load_qps) < 0) {
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "--load_qps must be non-negative";
+    } else if (absl::GetFlag(FLAGS_load_duration) <= absl::ZeroDuration()) {
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "--load_duration must be positive";
+    }
+
+    if (!instance_ || !device_ || !hal_module_ || !context_ || !input_module_) {
+      IREE_RETURN_IF_ERROR(Init());
+    }
+    std::vector<FunctionTarget> targets;
+    IREE_RETURN_IF_ERROR(ResolveFunctions(&targets));
+
+    // Per-thread contexts share the modules and device but have their own
+    // module state.
+    std::vector<iree_vm_context_t*> contexts(thread_count, context_);
+    if (!shared_context) {
+      for (auto& context : contexts) {
+        context = nullptr;
+        IREE_RETURN_IF_ERROR(CreateContext(&context));
+      }
+    }
+    struct ContextReleaser {
+      std::vector<iree_vm_context_t*>* contexts;
+      bool owned;
+      ~ContextReleaser() {
+        if (!owned) return;
+        for (auto* context : *contexts) iree_vm_context_release(context);
+      }
+    } context_releaser = {&contexts, !shared_context};
+
+    std::vector<LoadReport> reports;
+    for (const auto& target : targets) {
+      IREE_TRACE_SCOPE_DYNAMIC(target.name.c_str());
+      LoadSchedule schedule;
+      schedule.qps = absl::GetFlag(FLAGS_load_qps);
+      absl::Mutex context_mutex;
+      absl::Notification start_notification;
+      std::vector<LoadClientResult> results(thread_count);
+      std::vector<std::thread> threads;
+      threads.reserve(thread_count);
+      for (int32_t i = 0; i < thread_count; ++i) {
+        threads.emplace_back([&, i]() {
+          start_notification.WaitForNotification();
+          results[i].status = RunLoadClient(
+              contexts[i], shared_context ? &context_mutex : nullptr,
+              target.function, target.inputs, target.output_descs.size(),
+              &schedule, &results[i]);
+        });
+      }
+
+      // Start all clients together once they have been spun up.
+      schedule.start_time = LoadClock::now();
+      schedule.measure_time =
+          schedule.start_time +
+          absl::ToChronoNanoseconds(absl::GetFlag(FLAGS_load_warmup));
+      schedule.end_time =
+          schedule.measure_time +
+          absl::ToChronoNanoseconds(absl::GetFlag(FLAGS_load_duration));
+      start_notification.Notify();
+      for (auto& thread : threads) thread.join();
+
+      for (auto& result : results) {
+        IREE_RETURN_IF_ERROR(result.status)
+            << "Load client failed invoking '" << target.name << "'";
+      }
+      reports.push_back(SummarizeLoad(target.name, schedule, results));
+    }
+
+    auto output_path = absl::GetFlag(FLAGS_load_output);
+    if (output_path.empty() || output_path == "-") {
+      WriteLoadReportJson(std::cout, reports);
     } else {
-      IREE_RETURN_IF_ERROR(RegisterAllExportedFunctions());
+      std::ofstream output_file(output_path);
+      if (!output_file) {
+        return UnavailableErrorBuilder(IREE_LOC)
+               << "Unable to open load report output '" << output_path << "'";
+      }
+      WriteLoadReportJson(output_file, reports);
     }
     return iree::OkStatus();
   }
 
  private:
+  // An exported function selected for benchmarking and its invocation I/O.
+  struct FunctionTarget {
+    std::string name;
+    iree_vm_function_t function;
+    iree_vm_list_t* inputs;
+    std::vector<RawSignatureParser::Description> output_descs;
+  };
+
   Status Init() {
     IREE_TRACE_SCOPE0("IREEBenchmark::Init");
     IREE_TRACE_FRAME_MARK_BEGIN_NAMED("init");
 
-    IREE_ASSIGN_OR_RETURN(module_data_, GetModuleContentsFromFlags());
-
     IREE_RETURN_IF_ERROR(iree_hal_module_register_types());
     IREE_RETURN_IF_ERROR(
         iree_vm_instance_create(iree_allocator_system(), &instance_));
@@ -175,21 +588,37 @@ class IREEBenchmark {
     IREE_RETURN_IF_ERROR(
         iree::CreateDevice(absl::GetFlag(FLAGS_driver), &device_));
     IREE_RETURN_IF_ERROR(CreateHalModule(device_, &hal_module_));
-    IREE_RETURN_IF_ERROR(LoadBytecodeModule(module_data_, &input_module_));
+    IREE_RETURN_IF_ERROR(LoadBytecodeModuleFromFile(
+        absl::GetFlag(FLAGS_module_file), &input_module_));
+
+    IREE_RETURN_IF_ERROR(CreateContext(&context_));
 
+    IREE_TRACE_FRAME_MARK_END_NAMED("init");
+    return iree::OkStatus();
+  }
+
+  // Creates a new context containing the HAL and input modules.
+  Status CreateContext(iree_vm_context_t** out_context) {
     // Order matters. The input module will likely be dependent on the hal
     // module.
     std::array<iree_vm_module_t*, 2> modules = {hal_module_, input_module_};
-    IREE_RETURN_IF_ERROR(iree_vm_context_create_with_modules(
-        instance_, modules.data(), modules.size(), iree_allocator_system(),
-        &context_));
+    return iree_vm_context_create_with_modules(instance_, modules.data(),
+                                               modules.size(),
+                                               iree_allocator_system(),
+                                               out_context);
+  }
 
-    IREE_TRACE_FRAME_MARK_END_NAMED("init");
-    return iree::OkStatus();
+  Status ResolveFunctions(std::vector<FunctionTarget>* targets) {
+    auto function_name = absl::GetFlag(FLAGS_entry_function);
+    if (!function_name.empty()) {
+      return ResolveSpecificFunction(function_name, targets);
+    }
+    return ResolveAllExportedFunctions(targets);
   }
 
-  Status RegisterSpecificFunction(const std::string& function_name) {
-    IREE_TRACE_SCOPE0("IREEBenchmark::RegisterSpecificFunction");
+  Status ResolveSpecificFunction(const std::string& function_name,
+                                 std::vector<FunctionTarget>* targets) {
+    IREE_TRACE_SCOPE0("IREEBenchmark::ResolveSpecificFunction");
 
     iree_vm_function_t function;
     IREE_RETURN_IF_ERROR(input_module_->lookup_function(
@@ -214,13 +643,13 @@ class IREEBenchmark {
 
     // Creates output singnature.
     IREE_ASSIGN_OR_RETURN(auto output_descs, ParseOutputSignature(function));
-    RegisterModuleBenchmarks(function_name, context_, function, inputs_.get(),
-                             output_descs);
+    targets->push_back(
+        {function_name, function, inputs_.get(), std::move(output_descs)});
     return iree::OkStatus();
   }
 
-  Status RegisterAllExportedFunctions() {
-    IREE_TRACE_SCOPE0("IREEBenchmark::RegisterAllExportedFunctions");
+  Status ResolveAllExportedFunctions(std::vector<FunctionTarget>* targets) {
+    IREE_TRACE_SCOPE0("IREEBenchmark::ResolveAllExportedFunctions");
     iree_vm_function_t function;
     iree_vm_module_signature_t signature =
         input_module_->signature(input_module_->self);
@@ -239,13 +668,12 @@ class IREEBenchmark {
                << "'";
       }
       IREE_ASSIGN_OR_RETURN(auto output_descs, ParseOutputSignature(function));
-      iree::RegisterModuleBenchmarks(function_name, context_, function,
-                                     /*inputs=*/nullptr, output_descs);
+      targets->push_back({function_name, function, /*inputs=*/nullptr,
+                          std::move(output_descs)});
     }
     return iree::OkStatus();
   }
 
-  std::string module_data_;
   iree_vm_instance_t* instance_;
   iree_hal_device_t* device_;
   iree_vm_module_t* hal_module_;
@@ -277,6 +705,11 @@ int main(int argc, char** argv) {
       "    [--function_inputs=2xi32=1 2,1x2xf32=2 1 | \n"
       "     --function_inputs_file=file_with_function_inputs]\n"
       "    [--driver=vmla]\n"
+      "    [--load_threads=<clients> [--load_context_mode=per_thread|shared]\n"
+      "     [--load_qps=<arrivals/s>] [--load_warmup=1s]\n"
+      "     [--load_duration=10s] [--load_output=report.json]]\n"
+      "      Runs a multi-client load test instead of the benchmark library\n"
+      "      and writes latency percentiles and throughput as JSON\n"
       "\n\n"
       "  Optional flags from third_party/benchmark/src/benchmark.cc:\n"
       "    [--benchmark_list_tests={true|false}]\n"
@@ -301,6 +734,14 @@ int main(int argc, char** argv) {
       iree_hal_driver_registry_default()));
 
   iree::IREEBenchmark iree_benchmark;
+  if (absl::GetFlag(FLAGS_load_threads) > 0) {
+    auto status = iree_benchmark.RunLoad();
+    if (!status.ok()) {
+      std::cout << status << std::endl;
+      return static_cast<int>(status.code());
+    }
+    return 0;
+  }
   auto status = iree_benchmark.Register();
   if (!status.ok()) {
     std::cout << status << std::endl;
@@ -16,7 +16,6 @@
 
 #include "absl/flags/flag.h"
 #include "absl/strings/string_view.h"
-#include "iree/base/file_io.h"
 #include "iree/base/flags.h"
 #include "iree/base/status.h"
 #include "iree/base/tracing.h"
@@ -55,19 +54,6 @@ ABSL_FLAG(std::string, function_inputs_file, "",
 namespace iree {
 namespace {
 
-StatusOr<std::string> GetModuleContentsFromFlags() {
-  IREE_TRACE_SCOPE0("GetModuleContentsFromFlags");
-  auto module_file = absl::GetFlag(FLAGS_module_file);
-  std::string contents;
-  if (module_file == "-") {
-    contents = std::string{std::istreambuf_iterator<char>(std::cin),
-                           std::istreambuf_iterator<char>()};
-  } else {
-    IREE_ASSIGN_OR_RETURN(contents, file_io::GetFileContents(module_file));
-  }
-  return contents;
-}
-
 Status Run() {
   IREE_TRACE_SCOPE0("iree-run-module");
 
@@ -78,9 +64,9 @@ Status Run() {
       iree_vm_instance_create(iree_allocator_system(), &instance))
       << "creating instance";
 
-  IREE_ASSIGN_OR_RETURN(auto module_data, GetModuleContentsFromFlags());
   iree_vm_module_t* input_module = nullptr;
-  IREE_RETURN_IF_ERROR(LoadBytecodeModule(module_data, &input_module));
+  IREE_RETURN_IF_ERROR(LoadBytecodeModuleFromFile(
+      absl::GetFlag(FLAGS_module_file), &input_module));
 
   iree_hal_device_t* device = nullptr;
   IREE_RETURN_IF_ERROR(CreateDevice(absl::GetFlag(FLAGS_driver), &device));
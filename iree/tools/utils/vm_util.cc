@@ -14,6 +14,9 @@
 
 #include "iree/tools/utils/vm_util.h"
 
+#include <cstring>
+#include <iostream>
+#include <iterator>
 #include <ostream>
 
 #include "absl/strings/numbers.h"
@@ -22,8 +25,10 @@
 #include "absl/strings/strip.h"
 #include "absl/types/span.h"
 #include "iree/base/file_io.h"
+#include "iree/base/file_mapping.h"
 #include "iree/base/signature_mangle.h"
 #include "iree/base/status.h"
+#include "iree/base/tracing.h"
 #include "iree/hal/api.h"
 #include "iree/modules/hal/hal_module.h"
 #include "iree/vm/bytecode_module.h"
@@ -256,4 +261,53 @@ Status LoadBytecodeModule(absl::string_view module_data,
       << "Deserializing module";
   return OkStatus();
 }
+
+// Releases the FileMapping stashed in the allocator |self| when the module
+// frees its flatbuffer data. |ptr| points into the mapping and is not owned.
+static void ReleaseFileMappingAllocation(void* self, void* ptr) {
+  static_cast<FileMapping*>(self)->ReleaseReference();
+}
+
+Status LoadBytecodeModuleFromFile(const std::string& path,
+                                  iree_vm_module_t** out_module) {
+  IREE_TRACE_SCOPE0("LoadBytecodeModuleFromFile");
+
+  if (path == "-") {
+    // stdin can't be mapped so read it into a heap allocation that the module
+    // will take ownership of.
+    std::string contents{std::istreambuf_iterator<char>(std::cin),
+                         std::istreambuf_iterator<char>()};
+    void* module_data = nullptr;
+    IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+        iree_allocator_system(), contents.size(), &module_data));
+    std::memcpy(module_data, contents.data(), contents.size());
+    iree_status_t status = iree_vm_bytecode_module_create(
+        iree_make_const_byte_span(module_data, contents.size()),
+        iree_allocator_system(), iree_allocator_system(), out_module);
+    if (!iree_status_is_ok(status)) {
+      iree_allocator_free(iree_allocator_system(), module_data);
+    }
+    IREE_RETURN_IF_ERROR(status) << "Deserializing module from stdin";
+    return OkStatus();
+  }
+
+  IREE_ASSIGN_OR_RETURN(auto file_mapping, FileMapping::OpenRead(path));
+  auto module_data = file_mapping->data();
+
+  // The module frees its flatbuffer data with the provided allocator; we
+  // route that to dropping our reference to the mapping so that the file stays
+  // mapped for exactly as long as the module is alive.
+  iree_allocator_t flatbuffer_allocator = {
+      /*self=*/file_mapping.get(),
+      /*alloc=*/nullptr,
+      /*free=*/ReleaseFileMappingAllocation,
+  };
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_module_create(
+      iree_make_const_byte_span(module_data.data(), module_data.size()),
+      flatbuffer_allocator, iree_allocator_system(), out_module))
+      << "Deserializing module '" << path << "'";
+  file_mapping.release();
+  return OkStatus();
+}
+
 }  // namespace iree
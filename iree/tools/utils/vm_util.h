@@ -17,6 +17,7 @@
 
 #include <iostream>
 #include <ostream>
+#include <string>
 #include <vector>
 
 #include "absl/types/span.h"
@@ -93,6 +94,14 @@ Status CreateHalModule(iree_hal_device_t* device,
 Status LoadBytecodeModule(absl::string_view module_data,
                           iree_vm_module_t** out_module);
 
+// Loads a VM bytecode module from the file at |path|, or stdin if |path| is
+// "-". Files are memory-mapped and the mapping is kept alive by the module so
+// that rodata and embedded executables are paged in lazily on first use and
+// physical pages can be shared across processes loading the same file.
+// The returned |out_module| must be released by the caller.
+Status LoadBytecodeModuleFromFile(const std::string& path,
+                                  iree_vm_module_t** out_module);
+
 }  // namespace iree
 
 #endif  // IREE_TOOLS_UTILS_VM_UTIL_H_
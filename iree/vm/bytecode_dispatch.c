@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <math.h>
 #include <string.h>
 
 #include "iree/base/math.h"
@@ -199,7 +200,8 @@ static iree_status_t iree_vm_bytecode_external_enter(
   const uint8_t* p = arguments.data;
   for (iree_host_size_t i = 0; i < cconv_arguments.size; ++i) {
     switch (cconv_arguments.data[i]) {
-      case IREE_VM_CCONV_TYPE_INT32: {
+      case IREE_VM_CCONV_TYPE_INT32:
+      case IREE_VM_CCONV_TYPE_FLOAT32: {
         uint16_t dst_reg = i32_reg++;
         memcpy(&callee_registers.i32[dst_reg & callee_registers.i32_mask], p,
                sizeof(int32_t));
@@ -240,7 +242,8 @@ static iree_status_t iree_vm_bytecode_external_leave(
   for (iree_host_size_t i = 0; i < cconv_results.size; ++i) {
     uint16_t src_reg = src_reg_list->registers[i];
     switch (cconv_results.data[i]) {
-      case IREE_VM_CCONV_TYPE_INT32: {
+      case IREE_VM_CCONV_TYPE_INT32:
+      case IREE_VM_CCONV_TYPE_FLOAT32: {
         memcpy(p, &callee_registers->i32[src_reg & callee_registers->i32_mask],
                sizeof(int32_t));
         p += sizeof(int32_t);
@@ -379,7 +382,8 @@ static void iree_vm_bytecode_populate_import_cconv_arguments(
   for (iree_host_size_t i = 0, seg_i = 0, reg_i = 0; i < cconv_arguments.size;
        ++i, ++seg_i) {
     switch (cconv_arguments.data[i]) {
-      case IREE_VM_CCONV_TYPE_INT32: {
+      case IREE_VM_CCONV_TYPE_INT32:
+      case IREE_VM_CCONV_TYPE_FLOAT32: {
         memcpy(p,
                &caller_registers.i32[src_reg_list->registers[reg_i++] &
                                      caller_registers.i32_mask],
@@ -422,7 +426,8 @@ static void iree_vm_bytecode_populate_import_cconv_arguments(
                ++i) {
             // TODO(benvanik): share with switch above.
             switch (cconv_arguments.data[i]) {
-              case IREE_VM_CCONV_TYPE_INT32: {
+              case IREE_VM_CCONV_TYPE_INT32:
+              case IREE_VM_CCONV_TYPE_FLOAT32: {
                 memcpy(p,
                        &caller_registers.i32[src_reg_list->registers[reg_i++] &
                                              caller_registers.i32_mask],
@@ -452,38 +457,43 @@ static void iree_vm_bytecode_populate_import_cconv_arguments(
   }
 }
 
-// Issues a populated import call and marshals the results into |dst_reg_list|.
-static iree_status_t iree_vm_bytecode_issue_import_call(
-    iree_vm_stack_t* stack, const iree_vm_function_call_t call,
-    iree_string_view_t cconv_results,
-    const iree_vm_register_list_t* IREE_RESTRICT dst_reg_list,
-    iree_vm_stack_frame_t** out_caller_frame,
-    iree_vm_registers_t* out_caller_registers,
-    iree_vm_execution_result_t* out_result) {
-  // Call external function.
-  iree_status_t call_status = call.function.module->begin_call(
-      call.function.module->self, stack, &call, out_result);
-  if (IREE_UNLIKELY(!iree_status_is_ok(call_status))) {
-    // TODO(benvanik): set execution result to failure/capture stack.
-    return iree_status_annotate(call_status,
-                                iree_make_cstring_view("while calling import"));
+// Populates import call arguments for signatures that only contain 32-bit
+// primitives (IREE_VM_BYTECODE_IMPORT_THUNK_PRIMITIVE_32).
+static void iree_vm_bytecode_populate_import_primitive_32_arguments(
+    iree_string_view_t cconv_arguments,
+    const iree_vm_registers_t caller_registers,
+    const iree_vm_register_list_t* IREE_RESTRICT src_reg_list,
+    iree_byte_span_t storage) {
+  int32_t* IREE_RESTRICT p = (int32_t*)storage.data;
+  for (iree_host_size_t i = 0; i < cconv_arguments.size; ++i) {
+    p[i] = caller_registers
+               .i32[src_reg_list->registers[i] & caller_registers.i32_mask];
   }
+}
 
-  // NOTE: we don't support yielding within imported functions right now so it's
-  // safe to assume the stack is still valid here. If the called function can
-  // yield then we'll need to requery all pointers here.
-  *out_caller_frame = iree_vm_stack_current_frame(stack);
-  *out_caller_registers =
-      iree_vm_bytecode_get_register_storage(*out_caller_frame);
-
-  // Marshal outputs from the ABI results buffer to registers.
-  iree_vm_registers_t caller_registers = *out_caller_registers;
-  uint8_t* IREE_RESTRICT p = call.results.data;
+// Marshals import call |results| from the ABI results buffer into the
+// |dst_reg_list| registers of the caller.
+static void iree_vm_bytecode_marshal_import_results(
+    const iree_vm_bytecode_import_t* import, iree_byte_span_t results,
+    const iree_vm_register_list_t* IREE_RESTRICT dst_reg_list,
+    const iree_vm_registers_t caller_registers) {
+  iree_string_view_t cconv_results = import->results;
+  if (import->thunk == IREE_VM_BYTECODE_IMPORT_THUNK_PRIMITIVE_32) {
+    const int32_t* IREE_RESTRICT p = (const int32_t*)results.data;
+    for (iree_host_size_t i = 0;
+         i < cconv_results.size && i < dst_reg_list->size; ++i) {
+      caller_registers
+          .i32[dst_reg_list->registers[i] & caller_registers.i32_mask] = p[i];
+    }
+    return;
+  }
+  uint8_t* IREE_RESTRICT p = results.data;
   for (iree_host_size_t i = 0; i < cconv_results.size && i < dst_reg_list->size;
        ++i) {
     uint16_t dst_reg = dst_reg_list->registers[i];
     switch (cconv_results.data[i]) {
       case IREE_VM_CCONV_TYPE_INT32:
+      case IREE_VM_CCONV_TYPE_FLOAT32:
         memcpy(&caller_registers.i32[dst_reg & caller_registers.i32_mask], p,
                sizeof(int32_t));
         p += sizeof(int32_t);
@@ -502,7 +512,97 @@ static iree_status_t iree_vm_bytecode_issue_import_call(
         break;
     }
   }
+}
 
+// Returns the offset of the results within a combined import call buffer
+// holding |argument_buffer_size| bytes of arguments followed by the results.
+static inline iree_host_size_t iree_vm_bytecode_import_results_offset(
+    iree_host_size_t argument_buffer_size) {
+  return (argument_buffer_size + 7) & ~(iree_host_size_t)7;
+}
+
+// Splits |storage| into the ABI argument/result buffers of |call|.
+// Buffers are only zeroed when they hold refs as ref assignment releases any
+// existing value; primitives are always written before they are read.
+static void iree_vm_bytecode_prepare_import_buffers(
+    const iree_vm_bytecode_import_t* import, uint8_t* storage,
+    iree_host_size_t argument_buffer_size, iree_vm_function_call_t* call) {
+  call->arguments = iree_make_byte_span(storage, argument_buffer_size);
+  call->results = iree_make_byte_span(
+      storage + iree_vm_bytecode_import_results_offset(argument_buffer_size),
+      import->result_buffer_size);
+  if (import->flags & IREE_VM_BYTECODE_IMPORT_FLAG_ARGUMENT_REFS) {
+    memset(call->arguments.data, 0, call->arguments.data_length);
+  }
+  if (import->flags & IREE_VM_BYTECODE_IMPORT_FLAG_RESULT_REFS) {
+    memset(call->results.data, 0, call->results.data_length);
+  }
+}
+
+// Leaves all frames above |depth| that an import call failed to clean up so
+// that the caller frame is back on top of the |stack|.
+static void iree_vm_bytecode_unwind_import_frames(iree_vm_stack_t* stack,
+                                                  int32_t depth) {
+  iree_vm_stack_frame_t* frame = iree_vm_stack_current_frame(stack);
+  while (frame && frame->depth > depth) {
+    iree_status_ignore(iree_vm_stack_function_leave(stack));
+    frame = iree_vm_stack_current_frame(stack);
+  }
+}
+
+// Issues a populated import call and marshals the results into |dst_reg_list|.
+//
+// If the import suspends (yields or waits) its frame is left on the stack and
+// the pending call is recorded on the caller frame so that resuming can
+// complete it. |out_result| will have a non-complete state in that case and
+// the caller must stop dispatching.
+static iree_status_t iree_vm_bytecode_issue_import_call(
+    iree_vm_stack_t* stack, const iree_vm_bytecode_import_t* import,
+    const iree_vm_function_call_t call,
+    const iree_vm_register_list_t* IREE_RESTRICT dst_reg_list,
+    iree_vm_stack_frame_t** out_caller_frame,
+    iree_vm_registers_t* out_caller_registers,
+    iree_vm_execution_result_t* out_result) {
+  int32_t caller_depth = iree_vm_stack_current_frame(stack)->depth;
+
+  // Call external function.
+  iree_status_t call_status = call.function.module->begin_call(
+      call.function.module->self, stack, &call, out_result);
+  if (IREE_UNLIKELY(!iree_status_is_ok(call_status))) {
+    // TODO(benvanik): set execution result to failure/capture stack.
+    iree_vm_bytecode_unwind_import_frames(stack, caller_depth);
+    return iree_status_annotate(call_status,
+                                iree_make_cstring_view("while calling import"));
+  }
+
+  if (IREE_UNLIKELY(out_result->state != IREE_VM_EXECUTION_STATE_COMPLETE)) {
+    // The import suspended with its frame on top of ours. We only know how to
+    // get back to the pending call if it's the direct child of the caller.
+    iree_vm_stack_frame_t* caller_frame = iree_vm_stack_parent_frame(stack);
+    if (IREE_UNLIKELY(!caller_frame || caller_frame->depth != caller_depth)) {
+      iree_vm_bytecode_unwind_import_frames(stack, caller_depth);
+      memset(out_result, 0, sizeof(*out_result));
+      return iree_make_status(
+          IREE_STATUS_FAILED_PRECONDITION,
+          "imports may only suspend from their entry frame");
+    }
+    iree_vm_bytecode_frame_storage_t* caller_storage =
+        (iree_vm_bytecode_frame_storage_t*)iree_vm_stack_frame_storage(
+            caller_frame);
+    caller_storage->return_registers = dst_reg_list;
+    caller_storage->pending_import = import;
+    *out_caller_frame = caller_frame;
+    return iree_ok_status();
+  }
+
+  // The callee may have grown the stack so we need to requery all pointers.
+  *out_caller_frame = iree_vm_stack_current_frame(stack);
+  *out_caller_registers =
+      iree_vm_bytecode_get_register_storage(*out_caller_frame);
+
+  // Marshal outputs from the ABI results buffer to registers.
+  iree_vm_bytecode_marshal_import_results(import, call.results, dst_reg_list,
+                                          *out_caller_registers);
   return iree_ok_status();
 }
 
@@ -530,20 +630,27 @@ static iree_status_t iree_vm_bytecode_call_import(
   call.function = import->function;
   IREE_DISPATCH_LOG_CALL(&call.function);
 
+  // Allocate ABI argument/result storage in one go. Sizes were precomputed
+  // when the import was resolved.
+  uint8_t* storage = (uint8_t*)iree_alloca(
+      iree_vm_bytecode_import_results_offset(import->argument_buffer_size) +
+      import->result_buffer_size);
+  iree_vm_bytecode_prepare_import_buffers(
+      import, storage, import->argument_buffer_size, &call);
+
   // Marshal inputs from registers to the ABI arguments buffer.
-  call.arguments.data_length = import->argument_buffer_size;
-  call.arguments.data = iree_alloca(call.arguments.data_length);
-  memset(call.arguments.data, 0, call.arguments.data_length);
-  iree_vm_bytecode_populate_import_cconv_arguments(
-      import->arguments, caller_registers,
-      /*segment_size_list=*/NULL, src_reg_list, call.arguments);
+  if (import->thunk == IREE_VM_BYTECODE_IMPORT_THUNK_PRIMITIVE_32) {
+    iree_vm_bytecode_populate_import_primitive_32_arguments(
+        import->arguments, caller_registers, src_reg_list, call.arguments);
+  } else {
+    iree_vm_bytecode_populate_import_cconv_arguments(
+        import->arguments, caller_registers,
+        /*segment_size_list=*/NULL, src_reg_list, call.arguments);
+  }
 
   // Issue the call and handle results.
-  call.results.data_length = import->result_buffer_size;
-  call.results.data = iree_alloca(call.results.data_length);
-  memset(call.results.data, 0, call.results.data_length);
-  return iree_vm_bytecode_issue_import_call(stack, call, import->results,
-                                            dst_reg_list, out_caller_frame,
+  return iree_vm_bytecode_issue_import_call(stack, import, call, dst_reg_list,
+                                            out_caller_frame,
                                             out_caller_registers, out_result);
 }
 
@@ -574,10 +681,14 @@ static iree_status_t iree_vm_bytecode_call_import_variadic(
 
   // Allocate ABI argument/result storage taking into account the variadic
   // segments.
+  iree_host_size_t argument_buffer_size = 0;
   IREE_RETURN_IF_ERROR(iree_vm_function_call_compute_cconv_fragment_size(
-      import->arguments, segment_size_list, &call.arguments.data_length));
-  call.arguments.data = iree_alloca(call.arguments.data_length);
-  memset(call.arguments.data, 0, call.arguments.data_length);
+      import->arguments, segment_size_list, &argument_buffer_size));
+  uint8_t* storage = (uint8_t*)iree_alloca(
+      iree_vm_bytecode_import_results_offset(argument_buffer_size) +
+      import->result_buffer_size);
+  iree_vm_bytecode_prepare_import_buffers(import, storage,
+                                          argument_buffer_size, &call);
 
   // Marshal inputs from registers to the ABI arguments buffer.
   iree_vm_bytecode_populate_import_cconv_arguments(
@@ -585,14 +696,90 @@ static iree_status_t iree_vm_bytecode_call_import_variadic(
       call.arguments);
 
   // Issue the call and handle results.
-  call.results.data_length = import->result_buffer_size;
-  call.results.data = iree_alloca(call.results.data_length);
-  memset(call.results.data, 0, call.results.data_length);
-  return iree_vm_bytecode_issue_import_call(stack, call, import->results,
-                                            dst_reg_list, out_caller_frame,
+  return iree_vm_bytecode_issue_import_call(stack, import, call, dst_reg_list,
+                                            out_caller_frame,
                                             out_caller_registers, out_result);
 }
 
+// Records the state needed to resume dispatch at |frame| after suspending.
+// The frame pc must already be stored.
+static void iree_vm_bytecode_suspend_frame(iree_vm_stack_frame_t* frame,
+                                           int32_t entry_frame_depth) {
+  iree_vm_bytecode_frame_storage_t* storage =
+      (iree_vm_bytecode_frame_storage_t*)iree_vm_stack_frame_storage(frame);
+  storage->entry_frame_depth = entry_frame_depth;
+}
+
+// Resumes a suspended execution from the top of the |stack|.
+// If the execution was suspended in an import call the import is resumed first
+// and - if it completes - its results are marshaled into the caller registers.
+// |out_result| will have a non-complete state if the import suspended again.
+static iree_status_t iree_vm_bytecode_external_resume(
+    iree_vm_stack_t* stack, iree_vm_bytecode_module_t* module,
+    iree_vm_stack_frame_t** out_frame, iree_vm_registers_t* out_registers,
+    int32_t* out_entry_frame_depth, iree_vm_execution_result_t* out_result) {
+  iree_vm_stack_frame_t* frame = iree_vm_stack_current_frame(stack);
+  if (IREE_UNLIKELY(!frame)) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "no suspended execution to resume");
+  }
+
+  if (frame->function.module != &module->interface) {
+    // Suspended within an import called from the parent frame.
+    iree_vm_stack_frame_t* caller_frame = iree_vm_stack_parent_frame(stack);
+    iree_vm_bytecode_frame_storage_t* caller_storage =
+        caller_frame && caller_frame->function.module == &module->interface
+            ? (iree_vm_bytecode_frame_storage_t*)iree_vm_stack_frame_storage(
+                  caller_frame)
+            : NULL;
+    if (IREE_UNLIKELY(!caller_storage || !caller_storage->pending_import)) {
+      return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                              "suspended frame is not resumable by module");
+    }
+    const iree_vm_bytecode_import_t* import = caller_storage->pending_import;
+    iree_vm_function_call_t call;
+    memset(&call, 0, sizeof(call));
+    call.function = import->function;
+    call.results.data_length = import->result_buffer_size;
+    call.results.data = iree_alloca(call.results.data_length);
+    if (import->flags & IREE_VM_BYTECODE_IMPORT_FLAG_RESULT_REFS) {
+      memset(call.results.data, 0, call.results.data_length);
+    }
+    int32_t caller_depth = caller_frame->depth;
+    iree_status_t resume_status = import->function.module->resume_call(
+        import->function.module->self, stack, &call, out_result);
+    if (IREE_UNLIKELY(!iree_status_is_ok(resume_status))) {
+      iree_vm_bytecode_unwind_import_frames(stack, caller_depth);
+      caller_storage =
+          (iree_vm_bytecode_frame_storage_t*)iree_vm_stack_frame_storage(
+              iree_vm_stack_current_frame(stack));
+      caller_storage->pending_import = NULL;
+      return iree_status_annotate(
+          resume_status, iree_make_cstring_view("while resuming import"));
+    }
+    if (out_result->state != IREE_VM_EXECUTION_STATE_COMPLETE) {
+      // Still pending; our frame remains suspended as-is.
+      return iree_ok_status();
+    }
+
+    // The import has left its frame and the stack may have been reallocated.
+    frame = iree_vm_stack_current_frame(stack);
+    caller_storage =
+        (iree_vm_bytecode_frame_storage_t*)iree_vm_stack_frame_storage(frame);
+    caller_storage->pending_import = NULL;
+    iree_vm_bytecode_marshal_import_results(
+        import, call.results, caller_storage->return_registers,
+        iree_vm_bytecode_get_register_storage(frame));
+  }
+
+  iree_vm_bytecode_frame_storage_t* storage =
+      (iree_vm_bytecode_frame_storage_t*)iree_vm_stack_frame_storage(frame);
+  *out_frame = frame;
+  *out_registers = iree_vm_bytecode_get_register_storage(frame);
+  *out_entry_frame_depth = storage->entry_frame_depth;
+  return iree_ok_status();
+}
+
 //===----------------------------------------------------------------------===//
 // Main interpreter dispatch routine
 //===----------------------------------------------------------------------===//
@@ -600,21 +787,33 @@ static iree_status_t iree_vm_bytecode_call_import_variadic(
 iree_status_t iree_vm_bytecode_dispatch(
     iree_vm_stack_t* stack, iree_vm_bytecode_module_t* module,
     const iree_vm_function_call_t* call, iree_string_view_t cconv_arguments,
-    iree_string_view_t cconv_results, iree_vm_execution_result_t* out_result) {
+    iree_string_view_t cconv_results, bool is_resume,
+    iree_vm_execution_result_t* out_result) {
   memset(out_result, 0, sizeof(*out_result));
 
   // When required emit the dispatch tables here referencing the labels we are
   // defining below.
   DEFINE_DISPATCH_TABLES();
 
-  // Enter function (as this is the initial call).
-  // The callee's return will take care of storing the output registers when it
-  // actually does return, either immediately or in the future via a resume.
+  // Enter function (as this is the initial call) or pick up the suspended
+  // frame. The callee's return will take care of storing the output registers
+  // when it actually does return, either immediately or in the future via a
+  // resume.
   iree_vm_stack_frame_t* current_frame = NULL;
   iree_vm_registers_t regs;
-  IREE_RETURN_IF_ERROR(
-      iree_vm_bytecode_external_enter(stack, call->function, cconv_arguments,
-                                      call->arguments, &current_frame, &regs));
+  int32_t entry_frame_depth = 0;
+  if (!is_resume) {
+    IREE_RETURN_IF_ERROR(iree_vm_bytecode_external_enter(
+        stack, call->function, cconv_arguments, call->arguments,
+        &current_frame, &regs));
+    entry_frame_depth = current_frame->depth;
+  } else {
+    IREE_RETURN_IF_ERROR(iree_vm_bytecode_external_resume(
+        stack, module, &current_frame, &regs, &entry_frame_depth, out_result));
+    if (out_result->state != IREE_VM_EXECUTION_STATE_COMPLETE) {
+      return iree_ok_status();
+    }
+  }
 
   // Primary dispatch state. This is our 'native stack frame' and really
   // just enough to make dereferencing common addresses (like the current
@@ -630,7 +829,6 @@ iree_status_t iree_vm_bytecode_dispatch(
       module->function_descriptor_table[current_frame->function.ordinal]
           .bytecode_offset;
   iree_vm_source_offset_t pc = current_frame->pc;
-  const int32_t entry_frame_depth = current_frame->depth;
 
   BEGIN_DISPATCH_CORE() {
     //===------------------------------------------------------------------===//
@@ -790,11 +988,17 @@ iree_status_t iree_vm_bytecode_dispatch(
             "rodata ref ordinal out of range: %d (table=%zu)", rodata_ordinal,
             module_state->rodata_ref_count);
       }
+      iree_vm_ro_byte_buffer_t* buffer =
+          &module_state->rodata_ref_table[rodata_ordinal];
+      if (IREE_UNLIKELY(!iree_vm_bytecode_rodata_is_resident(buffer))) {
+        // Lazily decompress on first access; no-op for uncompressed segments.
+        IREE_RETURN_IF_ERROR(iree_vm_bytecode_module_state_ensure_rodata(
+            module, module_state, rodata_ordinal));
+      }
       bool result_is_move;
       iree_vm_ref_t* result = VM_DecResultRegRef("value", &result_is_move);
       IREE_RETURN_IF_ERROR(iree_vm_ref_wrap_retain(
-          &module_state->rodata_ref_table[rodata_ordinal],
-          iree_vm_ro_byte_buffer_type_id(), result));
+          buffer, iree_vm_ro_byte_buffer_type_id(), result));
     });
 
     //===------------------------------------------------------------------===//
@@ -1132,6 +1336,11 @@ iree_status_t iree_vm_bytecode_dispatch(
         IREE_RETURN_IF_ERROR(iree_vm_bytecode_call_import(
             stack, module_state, function_ordinal, regs, src_reg_list,
             dst_reg_list, &current_frame, &regs, out_result));
+        if (IREE_UNLIKELY(out_result->state !=
+                          IREE_VM_EXECUTION_STATE_COMPLETE)) {
+          iree_vm_bytecode_suspend_frame(current_frame, entry_frame_depth);
+          return iree_ok_status();
+        }
       } else {
         // Switch execution to the target function and continue running in the
         // bytecode dispatcher.
@@ -1171,6 +1380,11 @@ iree_status_t iree_vm_bytecode_dispatch(
       IREE_RETURN_IF_ERROR(iree_vm_bytecode_call_import_variadic(
           stack, module_state, function_ordinal, regs, segment_size_list,
           src_reg_list, dst_reg_list, &current_frame, &regs, out_result));
+      if (IREE_UNLIKELY(out_result->state !=
+                        IREE_VM_EXECUTION_STATE_COMPLETE)) {
+        iree_vm_bytecode_suspend_frame(current_frame, entry_frame_depth);
+        return iree_ok_status();
+      }
     });
 
     DISPATCH_OP(CORE, Return, {
@@ -1212,7 +1426,10 @@ iree_status_t iree_vm_bytecode_dispatch(
     //===------------------------------------------------------------------===//
 
     DISPATCH_OP(CORE, Yield, {
-      // TODO(benvanik): yield with execution results.
+      // Suspend execution; resuming will continue with the next op.
+      current_frame->pc = pc;
+      iree_vm_bytecode_suspend_frame(current_frame, entry_frame_depth);
+      out_result->state = IREE_VM_EXECUTION_STATE_YIELD;
       return iree_ok_status();
     });
 
@@ -1259,6 +1476,85 @@ iree_status_t iree_vm_bytecode_dispatch(
       pc = block_pc;
     });
 
+    //===------------------------------------------------------------------===//
+    // Fused superinstructions
+    //===------------------------------------------------------------------===//
+    // These are never emitted by the compiler and are only produced by
+    // iree_vm_bytecode_fuse_function when the module is loaded. The first op
+    // of a pair has its opcode replaced and the second op is left untouched.
+
+// Takes the branch of a vm.cond_br following a fused compare. The condition
+// register was verified at load time to be the compare result so we skip the
+// opcode and condition operand and use the value we just computed.
+#define DISPATCH_FUSED_COND_BRANCH(condition)                                \
+  {                                                                          \
+    pc += 1 + kRegSize;                                                      \
+    int32_t true_block_pc = VM_DecBranchTarget("true_dest");                 \
+    const iree_vm_register_remap_list_t* true_remap_list =                   \
+        VM_DecBranchOperands("true_operands");                               \
+    int32_t false_block_pc = VM_DecBranchTarget("false_dest");               \
+    const iree_vm_register_remap_list_t* false_remap_list =                  \
+        VM_DecBranchOperands("false_operands");                              \
+    if (condition) {                                                         \
+      pc = true_block_pc;                                                    \
+      iree_vm_bytecode_dispatch_remap_branch_registers(regs, true_remap_list); \
+    } else {                                                                 \
+      pc = false_block_pc;                                                   \
+      iree_vm_bytecode_dispatch_remap_branch_registers(regs,                 \
+                                                       false_remap_list);    \
+    }                                                                        \
+  }
+
+#define DISPATCH_OP_CORE_FUSED_CMP_I32_COND_BRANCH(op_name, type, op) \
+  DISPATCH_OP(CORE, op_name, {                                        \
+    int32_t lhs = VM_DecOperandRegI32("lhs");                         \
+    int32_t rhs = VM_DecOperandRegI32("rhs");                         \
+    int32_t* result = VM_DecResultRegI32("result");                   \
+    int32_t condition = (((type)lhs)op((type)rhs)) ? 1 : 0;           \
+    *result = condition;                                              \
+    DISPATCH_FUSED_COND_BRANCH(condition);                            \
+  });
+
+    DISPATCH_OP_CORE_FUSED_CMP_I32_COND_BRANCH(FusedCmpEQI32CondBranch,
+                                               int32_t, ==);
+    DISPATCH_OP_CORE_FUSED_CMP_I32_COND_BRANCH(FusedCmpNEI32CondBranch,
+                                               int32_t, !=);
+    DISPATCH_OP_CORE_FUSED_CMP_I32_COND_BRANCH(FusedCmpLTI32SCondBranch,
+                                               int32_t, <);
+    DISPATCH_OP_CORE_FUSED_CMP_I32_COND_BRANCH(FusedCmpLTI32UCondBranch,
+                                               uint32_t, <);
+    DISPATCH_OP(CORE, FusedCmpNZI32CondBranch, {
+      int32_t operand = VM_DecOperandRegI32("operand");
+      int32_t* result = VM_DecResultRegI32("result");
+      int32_t condition = (operand != 0) ? 1 : 0;
+      *result = condition;
+      DISPATCH_FUSED_COND_BRANCH(condition);
+    });
+
+    DISPATCH_OP(CORE, FusedConstI32AddI32, {
+      int32_t value = VM_DecIntAttr32("value");
+      int32_t* result = VM_DecResultRegI32("result");
+      *result = value;
+      DISPATCH_FUSED_NEXT(CORE, AddI32);
+    });
+
+    DISPATCH_OP(CORE, FusedGlobalLoadRefCall, {
+      uint32_t global = VM_DecGlobalAttr("global");
+      if (IREE_UNLIKELY(global >= module_state->global_ref_count)) {
+        return iree_make_status(
+            IREE_STATUS_OUT_OF_RANGE,
+            "global ref ordinal out of range: %d (table=%zu)", global,
+            module_state->global_ref_count);
+      }
+      const iree_vm_type_def_t* type_def = VM_DecTypeOf("value");
+      bool result_is_move;
+      iree_vm_ref_t* result = VM_DecResultRegRef("value", &result_is_move);
+      iree_vm_ref_t* global_ref = &module_state->global_ref_table[global];
+      IREE_RETURN_IF_ERROR(iree_vm_ref_retain_or_move_checked(
+          result_is_move, global_ref, type_def->ref_type, result));
+      DISPATCH_FUSED_NEXT(CORE, Call);
+    });
+
     //===------------------------------------------------------------------===//
     // Extension trampolines
     //===------------------------------------------------------------------===//
@@ -1491,8 +1787,235 @@ iree_status_t iree_vm_bytecode_dispatch(
     }
     END_DISPATCH_PREFIX();
 
-    DISPATCH_OP(CORE, PrefixExtF32,
-                { return iree_make_status(IREE_STATUS_UNIMPLEMENTED); });
+    BEGIN_DISPATCH_PREFIX(PrefixExtF32, EXT_F32) {
+#if IREE_VM_EXT_F32_ENABLE
+      //===----------------------------------------------------------------===//
+      // ExtF32: Globals
+      //===----------------------------------------------------------------===//
+
+      DISPATCH_OP(EXT_F32, GlobalLoadF32, {
+        uint32_t byte_offset = VM_DecGlobalAttr("global");
+        if (IREE_UNLIKELY(byte_offset >=
+                          module_state->rwdata_storage.data_length)) {
+          return iree_make_status(
+              IREE_STATUS_OUT_OF_RANGE,
+              "global byte_offset out of range: %d (rwdata=%zu)", byte_offset,
+              module_state->rwdata_storage.data_length);
+        }
+        float* value = VM_DecResultRegF32("value");
+        const float* global_ptr =
+            (const float*)(module_state->rwdata_storage.data + byte_offset);
+        *value = *global_ptr;
+      });
+
+      DISPATCH_OP(EXT_F32, GlobalStoreF32, {
+        uint32_t byte_offset = VM_DecGlobalAttr("global");
+        if (IREE_UNLIKELY(byte_offset >=
+                          module_state->rwdata_storage.data_length)) {
+          return iree_make_status(
+              IREE_STATUS_OUT_OF_RANGE,
+              "global byte_offset out of range: %d (rwdata=%zu)", byte_offset,
+              module_state->rwdata_storage.data_length);
+        }
+        float value = VM_DecOperandRegF32("value");
+        float* global_ptr =
+            (float*)(module_state->rwdata_storage.data + byte_offset);
+        *global_ptr = value;
+      });
+
+      DISPATCH_OP(EXT_F32, GlobalLoadIndirectF32, {
+        uint32_t byte_offset = VM_DecOperandRegI32("global");
+        if (IREE_UNLIKELY(byte_offset >=
+                          module_state->rwdata_storage.data_length)) {
+          return iree_make_status(
+              IREE_STATUS_OUT_OF_RANGE,
+              "global byte_offset out of range: %d (rwdata=%zu)", byte_offset,
+              module_state->rwdata_storage.data_length);
+        }
+        float* value = VM_DecResultRegF32("value");
+        const float* global_ptr =
+            (const float*)(module_state->rwdata_storage.data + byte_offset);
+        *value = *global_ptr;
+      });
+
+      DISPATCH_OP(EXT_F32, GlobalStoreIndirectF32, {
+        uint32_t byte_offset = VM_DecOperandRegI32("global");
+        if (IREE_UNLIKELY(byte_offset >=
+                          module_state->rwdata_storage.data_length)) {
+          return iree_make_status(
+              IREE_STATUS_OUT_OF_RANGE,
+              "global byte_offset out of range: %d (rwdata=%zu)", byte_offset,
+              module_state->rwdata_storage.data_length);
+        }
+        float value = VM_DecOperandRegF32("value");
+        float* global_ptr =
+            (float*)(module_state->rwdata_storage.data + byte_offset);
+        *global_ptr = value;
+      });
+
+      //===----------------------------------------------------------------===//
+      // ExtF32: Constants
+      //===----------------------------------------------------------------===//
+
+      DISPATCH_OP(EXT_F32, ConstF32, {
+        float value = VM_DecFloatAttr32("value");
+        float* result = VM_DecResultRegF32("result");
+        *result = value;
+      });
+
+      DISPATCH_OP(EXT_F32, ConstF32Zero, {
+        float* result = VM_DecResultRegF32("result");
+        *result = 0;
+      });
+
+      //===----------------------------------------------------------------===//
+      // ExtF32: Lists
+      //===----------------------------------------------------------------===//
+
+      DISPATCH_OP(EXT_F32, ListGetF32, {
+        bool list_is_move;
+        iree_vm_ref_t* list_ref = VM_DecOperandRegRef("list", &list_is_move);
+        iree_vm_list_t* list = iree_vm_list_deref(list_ref);
+        if (IREE_UNLIKELY(!list)) {
+          return iree_make_status(IREE_STATUS_INVALID_ARGUMENT, "list is null");
+        }
+        uint32_t index = VM_DecOperandRegI32("index");
+        float* result = VM_DecResultRegF32("result");
+        iree_vm_value_t value;
+        IREE_RETURN_IF_ERROR(iree_vm_list_get_value_as(
+            list, index, IREE_VM_VALUE_TYPE_F32, &value));
+        *result = value.f32;
+      });
+
+      DISPATCH_OP(EXT_F32, ListSetF32, {
+        bool list_is_move;
+        iree_vm_ref_t* list_ref = VM_DecOperandRegRef("list", &list_is_move);
+        iree_vm_list_t* list = iree_vm_list_deref(list_ref);
+        if (IREE_UNLIKELY(!list)) {
+          return iree_make_status(IREE_STATUS_INVALID_ARGUMENT, "list is null");
+        }
+        uint32_t index = VM_DecOperandRegI32("index");
+        float raw_value = VM_DecOperandRegF32("value");
+        iree_vm_value_t value = iree_vm_value_make_f32(raw_value);
+        IREE_RETURN_IF_ERROR(iree_vm_list_set_value(list, index, &value));
+      });
+
+      //===----------------------------------------------------------------===//
+      // ExtF32: Conditional assignment
+      //===----------------------------------------------------------------===//
+
+      DISPATCH_OP(EXT_F32, SelectF32, {
+        int32_t condition = VM_DecOperandRegI32("condition");
+        float true_value = VM_DecOperandRegF32("true_value");
+        float false_value = VM_DecOperandRegF32("false_value");
+        float* result = VM_DecResultRegF32("result");
+        *result = condition ? true_value : false_value;
+      });
+
+      //===----------------------------------------------------------------===//
+      // ExtF32: Native floating-point arithmetic
+      //===----------------------------------------------------------------===//
+
+#define DISPATCH_OP_EXT_F32_UNARY_ALU_F32(op_name, expr) \
+  DISPATCH_OP(EXT_F32, op_name, {                        \
+    float operand = VM_DecOperandRegF32("operand");      \
+    float* result = VM_DecResultRegF32("result");        \
+    *result = (expr);                                    \
+  });
+
+#define DISPATCH_OP_EXT_F32_BINARY_ALU_F32(op_name, expr) \
+  DISPATCH_OP(EXT_F32, op_name, {                         \
+    float lhs = VM_DecOperandRegF32("lhs");               \
+    float rhs = VM_DecOperandRegF32("rhs");               \
+    float* result = VM_DecResultRegF32("result");         \
+    *result = (expr);                                     \
+  });
+
+      DISPATCH_OP_EXT_F32_BINARY_ALU_F32(AddF32, lhs + rhs);
+      DISPATCH_OP_EXT_F32_BINARY_ALU_F32(SubF32, lhs - rhs);
+      DISPATCH_OP_EXT_F32_BINARY_ALU_F32(MulF32, lhs * rhs);
+      DISPATCH_OP_EXT_F32_BINARY_ALU_F32(DivF32, lhs / rhs);
+      DISPATCH_OP_EXT_F32_BINARY_ALU_F32(RemF32, fmodf(lhs, rhs));
+      DISPATCH_OP_EXT_F32_UNARY_ALU_F32(AbsF32, fabsf(operand));
+      DISPATCH_OP_EXT_F32_UNARY_ALU_F32(NegF32, -operand);
+
+      //===----------------------------------------------------------------===//
+      // ExtF32: Casting and type conversion/emulation
+      //===----------------------------------------------------------------===//
+
+#define DISPATCH_OP_EXT_F32_CAST_TO_F32(op_name, src_type) \
+  DISPATCH_OP(EXT_F32, op_name, {                          \
+    int32_t operand = VM_DecOperandRegI32("operand");      \
+    float* result = VM_DecResultRegF32("result");          \
+    *result = (float)((src_type)operand);                  \
+  });
+
+  // NaN and out-of-range operands saturate instead of hitting the undefined
+  // behavior of a plain C cast; see iree_math_f32_to_si32_sat.
+#define DISPATCH_OP_EXT_F32_CAST_FROM_F32(op_name, convert_fn) \
+  DISPATCH_OP(EXT_F32, op_name, {                              \
+    float operand = VM_DecOperandRegF32("operand");            \
+    int32_t* result = VM_DecResultRegI32("result");            \
+    *result = (int32_t)convert_fn(operand);                    \
+  });
+
+      DISPATCH_OP_EXT_F32_CAST_TO_F32(CastSI32F32, int32_t);
+      DISPATCH_OP_EXT_F32_CAST_TO_F32(CastUI32F32, uint32_t);
+      DISPATCH_OP_EXT_F32_CAST_FROM_F32(CastF32SI32,
+                                        iree_math_f32_to_si32_sat);
+      DISPATCH_OP_EXT_F32_CAST_FROM_F32(CastF32UI32,
+                                        iree_math_f32_to_ui32_sat);
+
+      // Bitcasts share the i32 register bank and are just register moves.
+      DISPATCH_OP(EXT_F32, BitcastI32F32, {
+        int32_t operand = VM_DecOperandRegI32("operand");
+        int32_t* result = VM_DecResultRegI32("result");
+        *result = operand;
+      });
+
+      DISPATCH_OP(EXT_F32, BitcastF32I32, {
+        int32_t operand = VM_DecOperandRegI32("operand");
+        int32_t* result = VM_DecResultRegI32("result");
+        *result = operand;
+      });
+
+      //===----------------------------------------------------------------===//
+      // ExtF32: Comparison ops
+      //===----------------------------------------------------------------===//
+      // Ordered (O) comparisons are false if either operand is NaN while
+      // unordered (U) comparisons are true.
+
+#define DISPATCH_OP_EXT_F32_CMP_F32(op_name, expr)  \
+  DISPATCH_OP(EXT_F32, op_name, {                   \
+    float lhs = VM_DecOperandRegF32("lhs");         \
+    float rhs = VM_DecOperandRegF32("rhs");         \
+    int32_t* result = VM_DecResultRegI32("result"); \
+    *result = (expr) ? 1 : 0;                       \
+  });
+
+      DISPATCH_OP_EXT_F32_CMP_F32(CmpEQF32O, lhs == rhs);
+      DISPATCH_OP_EXT_F32_CMP_F32(CmpEQF32U, !(lhs < rhs || lhs > rhs));
+      DISPATCH_OP_EXT_F32_CMP_F32(CmpNEF32O, lhs < rhs || lhs > rhs);
+      DISPATCH_OP_EXT_F32_CMP_F32(CmpNEF32U, lhs != rhs);
+      DISPATCH_OP_EXT_F32_CMP_F32(CmpLTF32O, lhs < rhs);
+      DISPATCH_OP_EXT_F32_CMP_F32(CmpLTF32U, !(lhs >= rhs));
+      DISPATCH_OP_EXT_F32_CMP_F32(CmpLTEF32O, lhs <= rhs);
+      DISPATCH_OP_EXT_F32_CMP_F32(CmpLTEF32U, !(lhs > rhs));
+      DISPATCH_OP(EXT_F32, CmpNaNF32, {
+        float operand = VM_DecOperandRegF32("operand");
+        int32_t* result = VM_DecResultRegI32("result");
+        *result = isnan(operand) ? 1 : 0;
+      });
+      DISPATCH_OP(EXT_F32, CmpNZF32, {
+        float operand = VM_DecOperandRegF32("operand");
+        int32_t* result = VM_DecResultRegI32("result");
+        *result = (operand != 0) ? 1 : 0;
+      });
+#else
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED);
+#endif  // IREE_VM_EXT_F32_ENABLE
+    }
+    END_DISPATCH_PREFIX();
 
     DISPATCH_OP(CORE, PrefixExtF64,
                 { return iree_make_status(IREE_STATUS_UNIMPLEMENTED); });
@@ -1502,3 +2025,371 @@ iree_status_t iree_vm_bytecode_dispatch(
   }
   END_DISPATCH_CORE();
 }
+
+//===----------------------------------------------------------------------===//
+// Load-time superinstruction fusion
+//===----------------------------------------------------------------------===//
+
+// Advances |pc| past |length| bytes if they are all before |end|.
+static inline bool iree_vm_bytecode_scan_bytes(iree_host_size_t length,
+                                               iree_host_size_t end,
+                                               iree_host_size_t* pc) {
+  if (length > end - *pc) return false;
+  *pc += length;
+  return true;
+}
+
+// Advances |pc| past a uint16_t count-prefixed list of |element_size| byte
+// elements as used by register lists, branch operands, and strings.
+static inline bool iree_vm_bytecode_scan_list(const uint8_t* bytecode_data,
+                                              iree_host_size_t element_size,
+                                              iree_host_size_t end,
+                                              iree_host_size_t* inout_pc) {
+  iree_host_size_t pc = *inout_pc;
+  if (!iree_vm_bytecode_scan_bytes(kRegSize, end, inout_pc)) return false;
+  return iree_vm_bytecode_scan_bytes((iree_host_size_t)OP_I16(0) * element_size,
+                                     end, inout_pc);
+}
+
+// NOTE: this must be kept in sync with the op encodings in VMOps.td.
+// bytecode_op_encoding_test.cc scans a module that uses every op in
+// generated/bytecode_op_table.h and will fail if an entry is missing or wrong.
+bool iree_vm_bytecode_scan_op(iree_const_byte_span_t bytecode,
+                              iree_host_size_t pc,
+                              iree_host_size_t* out_next_pc) {
+  const uint8_t* bytecode_data = bytecode.data;
+  iree_host_size_t end = bytecode.data_length;
+  // Sizes of the fixed-length operand encodings.
+  enum {
+    R = sizeof(uint16_t),  // register
+    A = sizeof(uint32_t),  // i32/f32 attribute, symbol ordinal, or type ID
+    I64 = sizeof(uint64_t),
+  };
+#define SCAN_BYTES(length) \
+  if (!iree_vm_bytecode_scan_bytes((length), end, &pc)) return false;
+#define SCAN_LIST(element_size)                                           \
+  if (!iree_vm_bytecode_scan_list(bytecode_data, (element_size), end, &pc)) \
+    return false;
+
+  SCAN_BYTES(1);
+  switch (bytecode_data[pc - 1]) {
+    case IREE_VM_OP_CORE_ConstI32Zero:
+    case IREE_VM_OP_CORE_ConstRefZero:
+      SCAN_BYTES(R);
+      break;
+    case IREE_VM_OP_CORE_GlobalLoadIndirectI32:
+    case IREE_VM_OP_CORE_GlobalStoreIndirectI32:
+    case IREE_VM_OP_CORE_ListReserve:
+    case IREE_VM_OP_CORE_ListSize:
+    case IREE_VM_OP_CORE_ListResize:
+    case IREE_VM_OP_CORE_NotI32:
+    case IREE_VM_OP_CORE_TruncI32I8:
+    case IREE_VM_OP_CORE_TruncI32I16:
+    case IREE_VM_OP_CORE_ExtI8I32S:
+    case IREE_VM_OP_CORE_ExtI8I32U:
+    case IREE_VM_OP_CORE_ExtI16I32S:
+    case IREE_VM_OP_CORE_ExtI16I32U:
+    case IREE_VM_OP_CORE_CmpNZI32:
+    case IREE_VM_OP_CORE_CmpNZRef:
+      SCAN_BYTES(R + R);
+      break;
+    case IREE_VM_OP_CORE_ListGetI32:
+    case IREE_VM_OP_CORE_ListSetI32:
+    case IREE_VM_OP_CORE_ListSetRef:
+    case IREE_VM_OP_CORE_AddI32:
+    case IREE_VM_OP_CORE_SubI32:
+    case IREE_VM_OP_CORE_MulI32:
+    case IREE_VM_OP_CORE_DivI32S:
+    case IREE_VM_OP_CORE_DivI32U:
+    case IREE_VM_OP_CORE_RemI32S:
+    case IREE_VM_OP_CORE_RemI32U:
+    case IREE_VM_OP_CORE_AndI32:
+    case IREE_VM_OP_CORE_OrI32:
+    case IREE_VM_OP_CORE_XorI32:
+    case IREE_VM_OP_CORE_CmpEQI32:
+    case IREE_VM_OP_CORE_CmpNEI32:
+    case IREE_VM_OP_CORE_CmpLTI32S:
+    case IREE_VM_OP_CORE_CmpLTI32U:
+    case IREE_VM_OP_CORE_CmpEQRef:
+    case IREE_VM_OP_CORE_CmpNERef:
+      SCAN_BYTES(R + R + R);
+      break;
+    case IREE_VM_OP_CORE_SelectI32:
+      SCAN_BYTES(R + R + R + R);
+      break;
+    case IREE_VM_OP_CORE_ShlI32:
+    case IREE_VM_OP_CORE_ShrI32S:
+    case IREE_VM_OP_CORE_ShrI32U:
+      SCAN_BYTES(R + 1 + R);
+      break;
+    case IREE_VM_OP_CORE_GlobalLoadI32:
+    case IREE_VM_OP_CORE_GlobalStoreI32:
+    case IREE_VM_OP_CORE_ConstI32:
+    case IREE_VM_OP_CORE_ConstRefRodata:
+      SCAN_BYTES(A + R);
+      break;
+    case IREE_VM_OP_CORE_GlobalLoadRef:
+    case IREE_VM_OP_CORE_GlobalStoreRef:
+      SCAN_BYTES(A + A + R);
+      break;
+    case IREE_VM_OP_CORE_GlobalLoadIndirectRef:
+    case IREE_VM_OP_CORE_GlobalStoreIndirectRef:
+    case IREE_VM_OP_CORE_ListAlloc:
+      SCAN_BYTES(R + A + R);
+      break;
+    case IREE_VM_OP_CORE_ListGetRef:
+      SCAN_BYTES(R + R + A + R);
+      break;
+    case IREE_VM_OP_CORE_SelectRef:
+      SCAN_BYTES(R + A + R + R + R);
+      break;
+    case IREE_VM_OP_CORE_SwitchI32:
+      SCAN_BYTES(R + A);
+      SCAN_LIST(R);
+      SCAN_BYTES(R);
+      break;
+    case IREE_VM_OP_CORE_SwitchRef:
+      SCAN_BYTES(R + A + R);
+      SCAN_LIST(R);
+      SCAN_BYTES(R);
+      break;
+    case IREE_VM_OP_CORE_Branch:
+    case IREE_VM_OP_CORE_Break:
+    case IREE_VM_OP_CORE_CondBreak:
+      SCAN_BYTES(A);
+      SCAN_LIST(R + R);
+      break;
+    case IREE_VM_OP_CORE_CondBranch:
+      SCAN_BYTES(R + A);
+      SCAN_LIST(R + R);
+      SCAN_BYTES(A);
+      SCAN_LIST(R + R);
+      break;
+    case IREE_VM_OP_CORE_Call:
+      SCAN_BYTES(A);
+      SCAN_LIST(R);
+      SCAN_LIST(R);
+      break;
+    case IREE_VM_OP_CORE_CallVariadic:
+      SCAN_BYTES(A);
+      SCAN_LIST(R);
+      SCAN_LIST(R);
+      SCAN_LIST(R);
+      break;
+    case IREE_VM_OP_CORE_Return:
+      SCAN_LIST(R);
+      break;
+    case IREE_VM_OP_CORE_Fail:
+      SCAN_BYTES(R);
+      SCAN_LIST(1);
+      break;
+    case IREE_VM_OP_CORE_Yield:
+      break;
+    case IREE_VM_OP_CORE_Trace:
+    case IREE_VM_OP_CORE_Print:
+      SCAN_LIST(1);
+      SCAN_LIST(R);
+      break;
+    case IREE_VM_OP_CORE_PrefixExtI64:
+      SCAN_BYTES(1);
+      switch (bytecode_data[pc - 1]) {
+        case IREE_VM_OP_EXT_I64_ConstI64Zero:
+          SCAN_BYTES(R);
+          break;
+        case IREE_VM_OP_EXT_I64_GlobalLoadIndirectI64:
+        case IREE_VM_OP_EXT_I64_GlobalStoreIndirectI64:
+        case IREE_VM_OP_EXT_I64_NotI64:
+        case IREE_VM_OP_EXT_I64_TruncI64I32:
+        case IREE_VM_OP_EXT_I64_ExtI32I64S:
+        case IREE_VM_OP_EXT_I64_ExtI32I64U:
+        case IREE_VM_OP_EXT_I64_CmpNZI64:
+          SCAN_BYTES(R + R);
+          break;
+        case IREE_VM_OP_EXT_I64_ListGetI64:
+        case IREE_VM_OP_EXT_I64_ListSetI64:
+        case IREE_VM_OP_EXT_I64_AddI64:
+        case IREE_VM_OP_EXT_I64_SubI64:
+        case IREE_VM_OP_EXT_I64_MulI64:
+        case IREE_VM_OP_EXT_I64_DivI64S:
+        case IREE_VM_OP_EXT_I64_DivI64U:
+        case IREE_VM_OP_EXT_I64_RemI64S:
+        case IREE_VM_OP_EXT_I64_RemI64U:
+        case IREE_VM_OP_EXT_I64_AndI64:
+        case IREE_VM_OP_EXT_I64_OrI64:
+        case IREE_VM_OP_EXT_I64_XorI64:
+        case IREE_VM_OP_EXT_I64_CmpEQI64:
+        case IREE_VM_OP_EXT_I64_CmpNEI64:
+        case IREE_VM_OP_EXT_I64_CmpLTI64S:
+        case IREE_VM_OP_EXT_I64_CmpLTI64U:
+          SCAN_BYTES(R + R + R);
+          break;
+        case IREE_VM_OP_EXT_I64_SelectI64:
+          SCAN_BYTES(R + R + R + R);
+          break;
+        case IREE_VM_OP_EXT_I64_ShlI64:
+        case IREE_VM_OP_EXT_I64_ShrI64S:
+        case IREE_VM_OP_EXT_I64_ShrI64U:
+          SCAN_BYTES(R + 1 + R);
+          break;
+        case IREE_VM_OP_EXT_I64_GlobalLoadI64:
+        case IREE_VM_OP_EXT_I64_GlobalStoreI64:
+          SCAN_BYTES(A + R);
+          break;
+        case IREE_VM_OP_EXT_I64_ConstI64:
+          SCAN_BYTES(I64 + R);
+          break;
+        case IREE_VM_OP_EXT_I64_SwitchI64:
+          SCAN_BYTES(R + I64);
+          SCAN_LIST(R);
+          SCAN_BYTES(R);
+          break;
+        default:
+          return false;
+      }
+      break;
+    case IREE_VM_OP_CORE_PrefixExtF32:
+      SCAN_BYTES(1);
+      switch (bytecode_data[pc - 1]) {
+        case IREE_VM_OP_EXT_F32_ConstF32Zero:
+          SCAN_BYTES(R);
+          break;
+        case IREE_VM_OP_EXT_F32_GlobalLoadIndirectF32:
+        case IREE_VM_OP_EXT_F32_GlobalStoreIndirectF32:
+        case IREE_VM_OP_EXT_F32_AbsF32:
+        case IREE_VM_OP_EXT_F32_NegF32:
+        case IREE_VM_OP_EXT_F32_CastSI32F32:
+        case IREE_VM_OP_EXT_F32_CastUI32F32:
+        case IREE_VM_OP_EXT_F32_CastF32SI32:
+        case IREE_VM_OP_EXT_F32_CastF32UI32:
+        case IREE_VM_OP_EXT_F32_BitcastI32F32:
+        case IREE_VM_OP_EXT_F32_BitcastF32I32:
+        case IREE_VM_OP_EXT_F32_CmpNaNF32:
+        case IREE_VM_OP_EXT_F32_CmpNZF32:
+          SCAN_BYTES(R + R);
+          break;
+        case IREE_VM_OP_EXT_F32_ListGetF32:
+        case IREE_VM_OP_EXT_F32_ListSetF32:
+        case IREE_VM_OP_EXT_F32_AddF32:
+        case IREE_VM_OP_EXT_F32_SubF32:
+        case IREE_VM_OP_EXT_F32_MulF32:
+        case IREE_VM_OP_EXT_F32_DivF32:
+        case IREE_VM_OP_EXT_F32_RemF32:
+        case IREE_VM_OP_EXT_F32_CmpEQF32O:
+        case IREE_VM_OP_EXT_F32_CmpEQF32U:
+        case IREE_VM_OP_EXT_F32_CmpNEF32O:
+        case IREE_VM_OP_EXT_F32_CmpNEF32U:
+        case IREE_VM_OP_EXT_F32_CmpLTF32O:
+        case IREE_VM_OP_EXT_F32_CmpLTF32U:
+        case IREE_VM_OP_EXT_F32_CmpLTEF32O:
+        case IREE_VM_OP_EXT_F32_CmpLTEF32U:
+          SCAN_BYTES(R + R + R);
+          break;
+        case IREE_VM_OP_EXT_F32_SelectF32:
+          SCAN_BYTES(R + R + R + R);
+          break;
+        case IREE_VM_OP_EXT_F32_GlobalLoadF32:
+        case IREE_VM_OP_EXT_F32_GlobalStoreF32:
+        case IREE_VM_OP_EXT_F32_ConstF32:
+          SCAN_BYTES(A + R);
+          break;
+        default:
+          return false;
+      }
+      break;
+    default:
+      // Unknown, reserved, or fused opcodes.
+      return false;
+  }
+
+#undef SCAN_BYTES
+#undef SCAN_LIST
+  *out_next_pc = pc;
+  return true;
+}
+
+// Returns the fused opcode for the op pair starting at |pc| and |next_pc| or
+// 0 if the pair cannot be fused.
+static uint8_t iree_vm_bytecode_select_fused_op(const uint8_t* bytecode_data,
+                                                iree_host_size_t pc,
+                                                iree_host_size_t next_pc) {
+  uint8_t opcode = bytecode_data[pc];
+  uint8_t next_opcode = bytecode_data[next_pc];
+  if (next_opcode == IREE_VM_OP_CORE_CondBranch) {
+    uint8_t fused_opcode = 0;
+    switch (opcode) {
+      case IREE_VM_OP_CORE_CmpEQI32:
+        fused_opcode = IREE_VM_OP_CORE_FusedCmpEQI32CondBranch;
+        break;
+      case IREE_VM_OP_CORE_CmpNEI32:
+        fused_opcode = IREE_VM_OP_CORE_FusedCmpNEI32CondBranch;
+        break;
+      case IREE_VM_OP_CORE_CmpLTI32S:
+        fused_opcode = IREE_VM_OP_CORE_FusedCmpLTI32SCondBranch;
+        break;
+      case IREE_VM_OP_CORE_CmpLTI32U:
+        fused_opcode = IREE_VM_OP_CORE_FusedCmpLTI32UCondBranch;
+        break;
+      case IREE_VM_OP_CORE_CmpNZI32:
+        fused_opcode = IREE_VM_OP_CORE_FusedCmpNZI32CondBranch;
+        break;
+      default:
+        return 0;
+    }
+    // The fused handler branches on the compare result directly and requires
+    // that it be the register the vm.cond_br tests. The result register is
+    // the last operand of the compare and the condition is the first operand
+    // of the branch.
+    uint16_t result_reg = 0;
+    memcpy(&result_reg, &bytecode_data[next_pc - kRegSize], kRegSize);
+    uint16_t condition_reg = 0;
+    memcpy(&condition_reg, &bytecode_data[next_pc + 1], kRegSize);
+    return result_reg == condition_reg ? fused_opcode : 0;
+  } else if (opcode == IREE_VM_OP_CORE_ConstI32 &&
+             next_opcode == IREE_VM_OP_CORE_AddI32) {
+    return IREE_VM_OP_CORE_FusedConstI32AddI32;
+  } else if (opcode == IREE_VM_OP_CORE_GlobalLoadRef &&
+             next_opcode == IREE_VM_OP_CORE_Call) {
+    return IREE_VM_OP_CORE_FusedGlobalLoadRefCall;
+  }
+  return 0;
+}
+
+iree_status_t iree_vm_bytecode_fuse_function(iree_byte_span_t bytecode_data) {
+#if IREE_VM_BYTECODE_FUSION_ENABLE
+  // Walk the function once to ensure we can find every op boundary. If any op
+  // can't be measured we leave the function as-is as fusing based on a bad
+  // boundary would corrupt the operands of the ops around it.
+  iree_const_byte_span_t function_data =
+      iree_make_const_byte_span(bytecode_data.data, bytecode_data.data_length);
+  iree_host_size_t end = bytecode_data.data_length;
+  iree_host_size_t pc = 0;
+  while (pc < end) {
+    uint8_t opcode = bytecode_data.data[pc];
+    if (IREE_UNLIKELY(opcode >= IREE_VM_OP_CORE_FusedCmpEQI32CondBranch &&
+                      opcode <= IREE_VM_OP_CORE_FusedGlobalLoadRefCall)) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "fused opcode 0x%02X at pc %zu is reserved for "
+                              "runtime use",
+                              opcode, pc);
+    }
+    if (!iree_vm_bytecode_scan_op(function_data, pc, &pc)) {
+      return iree_ok_status();
+    }
+  }
+
+  // Rewrite the first op of each fusable pair. Pairs never overlap as none of
+  // the ops that may begin a pair can also end one.
+  pc = 0;
+  while (pc < end) {
+    iree_host_size_t next_pc = 0;
+    iree_vm_bytecode_scan_op(function_data, pc, &next_pc);
+    if (next_pc < end) {
+      uint8_t fused_opcode =
+          iree_vm_bytecode_select_fused_op(bytecode_data.data, pc, next_pc);
+      if (fused_opcode) bytecode_data.data[pc] = fused_opcode;
+    }
+    pc = next_pc;
+  }
+#endif  // IREE_VM_BYTECODE_FUSION_ENABLE
+  return iree_ok_status();
+}
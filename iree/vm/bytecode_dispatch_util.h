@@ -25,7 +25,7 @@
 
 // TODO(benvanik): make a compiler setting.
 #define IREE_VM_EXT_I64_ENABLE 1
-#define IREE_VM_EXT_F32_ENABLE 0
+#define IREE_VM_EXT_F32_ENABLE 1
 #define IREE_VM_EXT_F64_ENABLE 0
 
 //===----------------------------------------------------------------------===//
@@ -95,6 +95,16 @@ typedef struct {
   // will be stored by callees upon return.
   const iree_vm_register_list_t* return_registers;
 
+  // Import whose call has been suspended; set only while the frame is waiting
+  // for the import to complete. Results are marshaled into |return_registers|
+  // when resumed.
+  const iree_vm_bytecode_import_t* pending_import;
+
+  // Depth of the frame entered by the external caller that began execution.
+  // Only valid while execution is suspended with this frame as the resume
+  // point.
+  int32_t entry_frame_depth;
+
   // Counts of each register type rounded up to the next power of two.
   iree_host_size_t i32_register_count;
   iree_host_size_t ref_register_count;
@@ -191,6 +201,13 @@ static const int kRegSize = sizeof(uint16_t);
       ((uint64_t)bytecode_data[pc + 7 + (i)] << 56)
 #endif  // IREE_ENDIANNESS_LITTLE
 
+// Reinterprets the bits of a 32-bit value read from the bytecode as a float.
+static inline float iree_vm_bytecode_f32_from_bits(uint32_t bits) {
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
 //===----------------------------------------------------------------------===//
 // Utilities matching the tablegen op encoding scheme
 //===----------------------------------------------------------------------===//
@@ -219,6 +236,9 @@ static const int kRegSize = sizeof(uint16_t);
 #define VM_DecTypeOf(name) VM_DecType(name)
 #define VM_DecIntAttr32(name) VM_DecConstI32(name)
 #define VM_DecIntAttr64(name) VM_DecConstI64(name)
+#define VM_DecFloatAttr32(name)               \
+  iree_vm_bytecode_f32_from_bits(OP_I32(0)); \
+  pc += 4;
 #define VM_DecStrAttr(name, out_str)                     \
   (out_str)->size = (iree_host_size_t)OP_I16(0);         \
   (out_str)->data = (const char*)&bytecode_data[pc + 2]; \
@@ -235,6 +255,9 @@ static const int kRegSize = sizeof(uint16_t);
 #define VM_DecOperandRegI64(name)                           \
   *((int64_t*)&regs.i32[OP_I16(0) & (regs.i32_mask & ~1)]); \
   pc += kRegSize;
+#define VM_DecOperandRegF32(name)                 \
+  *((float*)&regs.i32[OP_I16(0) & regs.i32_mask]); \
+  pc += kRegSize;
 #define VM_DecOperandRegRef(name, out_is_move)             \
   &regs.ref[OP_I16(0) & regs.ref_mask];                    \
   *(out_is_move) = OP_I16(0) & IREE_REF_REGISTER_MOVE_BIT; \
@@ -249,6 +272,9 @@ static const int kRegSize = sizeof(uint16_t);
 #define VM_DecResultRegI64(name)                           \
   ((int64_t*)&regs.i32[OP_I16(0) & (regs.i32_mask & ~1)]); \
   pc += kRegSize;
+#define VM_DecResultRegF32(name)                 \
+  ((float*)&regs.i32[OP_I16(0) & regs.i32_mask]); \
+  pc += kRegSize;
 #define VM_DecResultRegRef(name, out_is_move)              \
   &regs.ref[OP_I16(0) & regs.ref_mask];                    \
   *(out_is_move) = OP_I16(0) & IREE_REF_REGISTER_MOVE_BIT; \
@@ -298,10 +324,19 @@ static const int kRegSize = sizeof(uint16_t);
 #else
 #define DEFINE_DISPATCH_TABLE_EXT_I64()
 #endif  // IREE_VM_EXT_I64_ENABLE
+#if IREE_VM_EXT_F32_ENABLE
+#define DECLARE_DISPATCH_EXT_F32_OPC(ordinal, name) &&_dispatch_EXT_F32_##name,
+#define DEFINE_DISPATCH_TABLE_EXT_F32()                                       \
+  static const void* kDispatchTable_EXT_F32[256] = {IREE_VM_OP_EXT_F32_TABLE( \
+      DECLARE_DISPATCH_EXT_F32_OPC, DECLARE_DISPATCH_EXT_RSV)};
+#else
+#define DEFINE_DISPATCH_TABLE_EXT_F32()
+#endif  // IREE_VM_EXT_F32_ENABLE
 
-#define DEFINE_DISPATCH_TABLES() \
-  DEFINE_DISPATCH_TABLE_CORE();  \
-  DEFINE_DISPATCH_TABLE_EXT_I64();
+#define DEFINE_DISPATCH_TABLES()   \
+  DEFINE_DISPATCH_TABLE_CORE();    \
+  DEFINE_DISPATCH_TABLE_EXT_I64(); \
+  DEFINE_DISPATCH_TABLE_EXT_F32();
 
 #define DISPATCH_UNHANDLED_CORE()                                           \
   _dispatch_unhandled : {                                                   \
@@ -320,6 +355,12 @@ static const int kRegSize = sizeof(uint16_t);
   while (1)
 #define END_DISPATCH_PREFIX() goto* kDispatchTable_CORE[bytecode_data[pc++]];
 
+// Continues a fused superinstruction with the handler of the second op in the
+// pair, skipping its opcode byte and the indirect table dispatch.
+#define DISPATCH_FUSED_NEXT(ext, op_name) \
+  ++pc;                                   \
+  goto _dispatch_##ext##_##op_name;
+
 #else
 
 // Switch-based dispatch. This is strictly less efficient than the computed
@@ -358,6 +399,10 @@ static const int kRegSize = sizeof(uint16_t);
   break;                      \
   }
 
+// The second op in a fused pair is left intact in the bytecode so the switch
+// loop can dispatch it normally.
+#define DISPATCH_FUSED_NEXT(ext, op_name)
+
 #endif  // IREE_DISPATCH_MODE_COMPUTED_GOTO
 
 #endif  // IREE_VM_BYTECODE_DISPATCH_UTIL_H_
@@ -16,6 +16,7 @@
 
 #include "iree/base/alignment.h"
 #include "iree/base/api.h"
+#include "iree/base/internal/lz4.h"
 #include "iree/base/tracing.h"
 #include "iree/vm/api.h"
 #include "iree/vm/bytecode_module_impl.h"
@@ -55,6 +56,9 @@ static iree_vm_type_def_t iree_vm_bytecode_module_resolve_type(
   } else if (iree_vm_flatbuffer_strcmp(full_name,
                                        iree_make_cstring_view("i64")) == 0) {
     result.value_type = IREE_VM_VALUE_TYPE_I64;
+  } else if (iree_vm_flatbuffer_strcmp(full_name,
+                                       iree_make_cstring_view("f32")) == 0) {
+    result.value_type = IREE_VM_VALUE_TYPE_F32;
   } else if (full_name[0] == '!') {
     // Note that we drop the ! prefix:
     iree_string_view_t type_name = {full_name + 1,
@@ -235,6 +239,37 @@ static iree_status_t iree_vm_bytecode_module_flatbuffer_verify(
     // TODO(benvanik): run bytecode verifier on contents.
   }
 
+  iree_vm_RodataSegmentDef_vec_t rodata_segments =
+      iree_vm_BytecodeModuleDef_rodata_segments(module_def);
+  for (size_t i = 0; i < iree_vm_RodataSegmentDef_vec_len(rodata_segments);
+       ++i) {
+    iree_vm_RodataSegmentDef_table_t segment =
+        iree_vm_RodataSegmentDef_vec_at(rodata_segments, i);
+    switch (iree_vm_RodataSegmentDef_compression_type_type(segment)) {
+      case iree_vm_CompressionTypeDef_NONE:
+      case iree_vm_CompressionTypeDef_UncompressedDataDef:
+        break;
+      case iree_vm_CompressionTypeDef_LZ4BlockDataDef: {
+        iree_vm_LZ4BlockDataDef_table_t lz4_def =
+            (iree_vm_LZ4BlockDataDef_table_t)
+                iree_vm_RodataSegmentDef_compression_type(segment);
+        uint64_t decompressed_size =
+            iree_vm_LZ4BlockDataDef_decompressed_size(lz4_def);
+        if (decompressed_size > SIZE_MAX) {
+          return iree_make_status(
+              IREE_STATUS_INVALID_ARGUMENT,
+              "rodata[%zu] decompressed size exceeds host size", i);
+        }
+        break;
+      }
+      default:
+        return iree_make_status(
+            IREE_STATUS_UNIMPLEMENTED,
+            "rodata[%zu] uses an unsupported compression type %d", i,
+            (int)iree_vm_RodataSegmentDef_compression_type_type(segment));
+    }
+  }
+
   return iree_ok_status();
 }
 
@@ -567,6 +602,9 @@ static iree_status_t iree_vm_bytecode_module_alloc_state(
   iree_vm_bytecode_module_layout_state(module_def, state);
 
   // Setup rodata segments to point directly at the flatbuffer memory.
+  // Compressed segments are left NULL with their decompressed length and will
+  // be decompressed on first access by
+  // iree_vm_bytecode_module_state_ensure_rodata.
   iree_vm_RodataSegmentDef_vec_t rodata_segments =
       iree_vm_BytecodeModuleDef_rodata_segments(module_def);
   for (int i = 0; i < state->rodata_ref_count; ++i) {
@@ -574,9 +612,19 @@ static iree_status_t iree_vm_bytecode_module_alloc_state(
         iree_vm_RodataSegmentDef_vec_at(rodata_segments, i);
     iree_vm_ro_byte_buffer_t* ref = &state->rodata_ref_table[i];
     iree_atomic_ref_count_init(&ref->ref_object.counter);
-    ref->data.data = iree_vm_RodataSegmentDef_data(segment);
-    ref->data.data_length =
-        flatbuffers_uint8_vec_len(iree_vm_RodataSegmentDef_data(segment));
+    if (iree_vm_RodataSegmentDef_compression_type_type(segment) ==
+        iree_vm_CompressionTypeDef_LZ4BlockDataDef) {
+      iree_vm_LZ4BlockDataDef_table_t lz4_def =
+          (iree_vm_LZ4BlockDataDef_table_t)
+              iree_vm_RodataSegmentDef_compression_type(segment);
+      ref->data.data = NULL;
+      ref->data.data_length =
+          (iree_host_size_t)iree_vm_LZ4BlockDataDef_decompressed_size(lz4_def);
+    } else {
+      ref->data.data = iree_vm_RodataSegmentDef_data(segment);
+      ref->data.data_length =
+          flatbuffers_uint8_vec_len(iree_vm_RodataSegmentDef_data(segment));
+    }
   }
 
   *out_module_state = (iree_vm_module_state_t*)state;
@@ -597,11 +645,102 @@ static void iree_vm_bytecode_module_free_state(
     iree_vm_ref_release(&state->global_ref_table[i]);
   }
 
+  // Free any rodata segments we decompressed.
+  iree_vm_bytecode_module_t* module = (iree_vm_bytecode_module_t*)self;
+  iree_vm_RodataSegmentDef_vec_t rodata_segments =
+      iree_vm_BytecodeModuleDef_rodata_segments(module->def);
+  for (int i = 0; i < state->rodata_ref_count; ++i) {
+    iree_vm_RodataSegmentDef_table_t segment =
+        iree_vm_RodataSegmentDef_vec_at(rodata_segments, i);
+    if (iree_vm_RodataSegmentDef_compression_type_type(segment) ==
+        iree_vm_CompressionTypeDef_LZ4BlockDataDef) {
+      iree_allocator_free(state->allocator,
+                          (void*)state->rodata_ref_table[i].data.data);
+    }
+  }
+
   iree_allocator_free(state->allocator, module_state);
 
   IREE_TRACE_ZONE_END(z0);
 }
 
+iree_status_t iree_vm_bytecode_module_state_ensure_rodata(
+    iree_vm_bytecode_module_t* module,
+    const iree_vm_bytecode_module_state_t* state, iree_host_size_t ordinal) {
+  iree_vm_ro_byte_buffer_t* ref = &state->rodata_ref_table[ordinal];
+  if (IREE_LIKELY(iree_vm_bytecode_rodata_is_resident(ref))) {
+    return iree_ok_status();
+  }
+
+  iree_vm_RodataSegmentDef_table_t segment = iree_vm_RodataSegmentDef_vec_at(
+      iree_vm_BytecodeModuleDef_rodata_segments(module->def), ordinal);
+  flatbuffers_uint8_vec_t compressed_data =
+      iree_vm_RodataSegmentDef_data(segment);
+  switch (iree_vm_RodataSegmentDef_compression_type_type(segment)) {
+    case iree_vm_CompressionTypeDef_LZ4BlockDataDef:
+      break;
+    default:
+      // Uncompressed but missing/empty data; nothing to do.
+      return iree_ok_status();
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, ref->data.data_length);
+
+  // Decompress into storage owned by the module state; it is freed along with
+  // the state in iree_vm_bytecode_module_free_state.
+  uint8_t* decompressed_data = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(state->allocator,
+                                iree_max(1, ref->data.data_length),
+                                (void**)&decompressed_data));
+  iree_status_t status = iree_lz4_block_decompress(
+      iree_make_const_byte_span(compressed_data,
+                                flatbuffers_uint8_vec_len(compressed_data)),
+      iree_make_byte_span(decompressed_data, ref->data.data_length));
+  if (iree_status_is_ok(status)) {
+    // Publish the decompressed data. The length was set when the state was
+    // allocated and never changes. If another thread published its copy first
+    // we use that one and drop ours.
+    uintptr_t expected_data = 0;
+    if (!iree_atomic_compare_exchange_strong_ptr(
+            (iree_atomic_ptr_t*)&ref->data.data, &expected_data,
+            (uintptr_t)decompressed_data, iree_memory_order_acq_rel,
+            iree_memory_order_acquire)) {
+      iree_allocator_free(state->allocator, decompressed_data);
+    }
+  } else {
+    iree_allocator_free(state->allocator, decompressed_data);
+    status = iree_status_annotate_f(status, "decompressing rodata[%zu]",
+                                    ordinal);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Returns true if all values in |cconv_fragment| are 32-bit primitives.
+static bool iree_vm_bytecode_cconv_fragment_is_primitive_32(
+    iree_string_view_t cconv_fragment) {
+  for (iree_host_size_t i = 0; i < cconv_fragment.size; ++i) {
+    switch (cconv_fragment.data[i]) {
+      case IREE_VM_CCONV_TYPE_INT32:
+      case IREE_VM_CCONV_TYPE_FLOAT32:
+        break;
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
+// Returns true if any value in |cconv_fragment| is a ref.
+static bool iree_vm_bytecode_cconv_fragment_has_refs(
+    iree_string_view_t cconv_fragment) {
+  return iree_string_view_find_char(cconv_fragment, IREE_VM_CCONV_TYPE_REF,
+                                    0) != IREE_STRING_VIEW_NPOS;
+}
+
 static iree_status_t iree_vm_bytecode_module_resolve_import(
     void* self, iree_vm_module_state_t* module_state, iree_host_size_t ordinal,
     const iree_vm_function_t* function,
@@ -643,32 +782,37 @@ static iree_status_t iree_vm_bytecode_module_resolve_import(
   import->argument_buffer_size = (uint16_t)argument_buffer_size;
   import->result_buffer_size = (uint16_t)result_buffer_size;
 
+  // Select the marshaling thunk used by vm.call for the import.
+  import->thunk = IREE_VM_BYTECODE_IMPORT_THUNK_GENERIC;
+  import->flags = 0;
+  if (iree_vm_bytecode_cconv_fragment_is_primitive_32(import->arguments) &&
+      iree_vm_bytecode_cconv_fragment_is_primitive_32(import->results)) {
+    import->thunk = IREE_VM_BYTECODE_IMPORT_THUNK_PRIMITIVE_32;
+  }
+  if (iree_vm_bytecode_cconv_fragment_has_refs(import->arguments)) {
+    import->flags |= IREE_VM_BYTECODE_IMPORT_FLAG_ARGUMENT_REFS;
+  }
+  if (iree_vm_bytecode_cconv_fragment_has_refs(import->results)) {
+    import->flags |= IREE_VM_BYTECODE_IMPORT_FLAG_RESULT_REFS;
+  }
+
   return iree_ok_status();
 }
 
-static iree_status_t iree_vm_bytecode_module_begin_call(
-    void* self, iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
-    iree_vm_execution_result_t* out_result) {
-  // NOTE: any work here adds directly to the invocation time. Avoid doing too
-  // much work or touching too many unlikely-to-be-cached structures (such as
-  // walking the FlatBuffer, which may cause page faults).
-  IREE_TRACE_ZONE_BEGIN(z0);
-  IREE_ASSERT_ARGUMENT(out_result);
-  memset(out_result, 0, sizeof(iree_vm_execution_result_t));
-
+// Looks up the calling convention of the function targeted by |call|.
+static iree_status_t iree_vm_bytecode_module_get_call_cconv(
+    iree_vm_bytecode_module_t* module, const iree_vm_function_call_t* call,
+    iree_string_view_t* out_cconv_arguments,
+    iree_string_view_t* out_cconv_results) {
   // Only internal functions store the information needed for execution. We
   // allow exports here as well to make things easier to call externally.
   iree_vm_function_t function = call->function;
   if (function.linkage != IREE_VM_FUNCTION_LINKAGE_INTERNAL) {
-    IREE_RETURN_AND_END_ZONE_IF_ERROR(
-        z0,
-        iree_vm_bytecode_module_get_function(
-            self, function.linkage, function.ordinal, &function, NULL, NULL));
+    IREE_RETURN_IF_ERROR(iree_vm_bytecode_module_get_function(
+        module, function.linkage, function.ordinal, &function, NULL, NULL));
   }
 
-  iree_vm_bytecode_module_t* module = (iree_vm_bytecode_module_t*)self;
   if (function.ordinal >= module->function_descriptor_count) {
-    IREE_TRACE_ZONE_END(z0);
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
                             "function ordinal out of range (0 < %u < %zu)",
                             function.ordinal,
@@ -699,16 +843,56 @@ static iree_status_t iree_vm_bytecode_module_begin_call(
   signature.calling_convention.data = calling_convention;
   signature.calling_convention.size =
       flatbuffers_string_len(calling_convention);
+  return iree_vm_function_call_get_cconv_fragments(
+      &signature, out_cconv_arguments, out_cconv_results);
+}
+
+static iree_status_t iree_vm_bytecode_module_begin_call(
+    void* self, iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
+    iree_vm_execution_result_t* out_result) {
+  // NOTE: any work here adds directly to the invocation time. Avoid doing too
+  // much work or touching too many unlikely-to-be-cached structures (such as
+  // walking the FlatBuffer, which may cause page faults).
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_ASSERT_ARGUMENT(out_result);
+  memset(out_result, 0, sizeof(iree_vm_execution_result_t));
+
+  iree_vm_bytecode_module_t* module = (iree_vm_bytecode_module_t*)self;
   iree_string_view_t cconv_arguments = iree_string_view_empty();
   iree_string_view_t cconv_results = iree_string_view_empty();
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, iree_vm_function_call_get_cconv_fragments(
-              &signature, &cconv_arguments, &cconv_results));
+      z0, iree_vm_bytecode_module_get_call_cconv(
+              module, call, &cconv_arguments, &cconv_results));
 
   // Jump into the dispatch routine to execute bytecode until the function
   // either returns (synchronous) or yields (asynchronous).
-  iree_status_t status = iree_vm_bytecode_dispatch(
-      stack, module, call, cconv_arguments, cconv_results, out_result);
+  iree_status_t status =
+      iree_vm_bytecode_dispatch(stack, module, call, cconv_arguments,
+                                cconv_results, /*is_resume=*/false, out_result);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static iree_status_t iree_vm_bytecode_module_resume_call(
+    void* self, iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
+    iree_vm_execution_result_t* out_result) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_ASSERT_ARGUMENT(out_result);
+  memset(out_result, 0, sizeof(iree_vm_execution_result_t));
+
+  // The results of the call are only needed once the entry frame returns but
+  // we can't tell ahead of time whether that happens during this resume.
+  iree_vm_bytecode_module_t* module = (iree_vm_bytecode_module_t*)self;
+  iree_string_view_t cconv_arguments = iree_string_view_empty();
+  iree_string_view_t cconv_results = iree_string_view_empty();
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_vm_bytecode_module_get_call_cconv(
+              module, call, &cconv_arguments, &cconv_results));
+
+  // Continue dispatch from the suspended frame at the top of the stack.
+  iree_status_t status =
+      iree_vm_bytecode_dispatch(stack, module, call, cconv_arguments,
+                                cconv_results, /*is_resume=*/true, out_result);
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
@@ -745,11 +929,22 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_bytecode_module_create(
   size_t type_table_size =
       iree_vm_TypeDef_vec_len(type_defs) * sizeof(iree_vm_type_def_t);
 
+  // Fusing superinstructions rewrites the bytecode and needs it writable. The
+  // flatbuffer may be read-only (embedded in a binary or a file mapping) so the
+  // bytecode section is always copied into the module allocation and fused
+  // there; rodata is never copied and the flatbuffer is never written.
+  flatbuffers_uint8_vec_t bytecode_data =
+      iree_vm_BytecodeModuleDef_bytecode_data(module_def);
+  size_t bytecode_size = flatbuffers_uint8_vec_len(bytecode_data);
+  size_t bytecode_copy_size =
+      IREE_VM_BYTECODE_FUSION_ENABLE ? bytecode_size : 0;
+
   iree_vm_bytecode_module_t* module = NULL;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, iree_allocator_malloc(
-              allocator, sizeof(iree_vm_bytecode_module_t) + type_table_size,
-              (void**)&module));
+      z0, iree_allocator_malloc(allocator,
+                                sizeof(iree_vm_bytecode_module_t) +
+                                    type_table_size + bytecode_copy_size,
+                                (void**)&module));
   module->allocator = allocator;
 
   iree_vm_FunctionDescriptor_vec_t function_descriptors =
@@ -758,10 +953,14 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_bytecode_module_create(
       iree_vm_FunctionDescriptor_vec_len(function_descriptors);
   module->function_descriptor_table = function_descriptors;
 
-  flatbuffers_uint8_vec_t bytecode_data =
-      iree_vm_BytecodeModuleDef_bytecode_data(module_def);
-  module->bytecode_data = iree_make_const_byte_span(
-      bytecode_data, flatbuffers_uint8_vec_len(bytecode_data));
+  uint8_t* fused_bytecode_data = (uint8_t*)bytecode_data;
+  if (bytecode_copy_size > 0) {
+    fused_bytecode_data =
+        (uint8_t*)module + sizeof(iree_vm_bytecode_module_t) + type_table_size;
+    memcpy(fused_bytecode_data, bytecode_data, bytecode_copy_size);
+  }
+  module->bytecode_data =
+      iree_make_const_byte_span(fused_bytecode_data, bytecode_size);
 
   module->flatbuffer_data = flatbuffer_data;
   module->flatbuffer_allocator = flatbuffer_allocator;
@@ -778,6 +977,27 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_bytecode_module_create(
     return resolve_status;
   }
 
+  IREE_TRACE_ZONE_BEGIN_NAMED(z2, "iree_vm_bytecode_fuse_function");
+  iree_status_t fuse_status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < module->function_descriptor_count; ++i) {
+    const iree_vm_FunctionDescriptor_t* function_descriptor =
+        &module->function_descriptor_table[i];
+    fuse_status = iree_vm_bytecode_fuse_function(iree_make_byte_span(
+        fused_bytecode_data + function_descriptor->bytecode_offset,
+        function_descriptor->bytecode_length));
+    if (!iree_status_is_ok(fuse_status)) {
+      fuse_status = iree_status_annotate_f(
+          fuse_status, "while fusing functions[%zu]", i);
+      break;
+    }
+  }
+  IREE_TRACE_ZONE_END(z2);
+  if (!iree_status_is_ok(fuse_status)) {
+    iree_allocator_free(allocator, module);
+    IREE_TRACE_ZONE_END(z0);
+    return fuse_status;
+  }
+
   iree_vm_module_initialize(&module->interface, module);
   module->interface.destroy = iree_vm_bytecode_module_destroy;
   module->interface.name = iree_vm_bytecode_module_name;
@@ -788,6 +1008,7 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_bytecode_module_create(
   module->interface.free_state = iree_vm_bytecode_module_free_state;
   module->interface.resolve_import = iree_vm_bytecode_module_resolve_import;
   module->interface.begin_call = iree_vm_bytecode_module_begin_call;
+  module->interface.resume_call = iree_vm_bytecode_module_resume_call;
   module->interface.get_function_reflection_attr =
       iree_vm_bytecode_module_get_function_reflection_attr;
 
@@ -28,6 +28,10 @@ extern "C" {
 // If a |flatbuffer_allocator| is provided then it will be used to free the
 // |flatbuffer_data| when the module is destroyed and otherwise the ownership of
 // the flatbuffer_data remains with the caller.
+//
+// The interpreter rewrites hot op pairs in the bytecode when the module is
+// loaded. |flatbuffer_data| is never written: the bytecode section is copied
+// into the module and rewritten there while rodata stays in |flatbuffer_data|.
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_bytecode_module_create(
     iree_const_byte_span_t flatbuffer_data,
     iree_allocator_t flatbuffer_allocator, iree_allocator_t allocator,
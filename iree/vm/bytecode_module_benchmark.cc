@@ -42,13 +42,47 @@ static iree_status_t native_import_module_add_1(
   return iree_ok_status();
 }
 
+// vm.import @native_import_module.add_1_x2(%a : i32, %b : i32) -> (i32, i32)
+static iree_status_t native_import_module_add_1_x2(
+    iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
+    iree_vm_native_function_target_t target_fn, void* module,
+    void* module_state, iree_vm_execution_result_t* out_result) {
+  // Add 1 to both args and return them.
+  const int32_t* args = reinterpret_cast<const int32_t*>(call->arguments.data);
+  int32_t* rets = reinterpret_cast<int32_t*>(call->results.data);
+  rets[0] = args[0] + 1;
+  rets[1] = args[1] + 1;
+  return iree_ok_status();
+}
+
+// vm.import @native_import_module.add_1_ref(%ref : !vm.ref<?>, %arg : i32)
+//     -> i32
+static iree_status_t native_import_module_add_1_ref(
+    iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
+    iree_vm_native_function_target_t target_fn, void* module,
+    void* module_state, iree_vm_execution_result_t* out_result) {
+  // Drop the ref (we own it) and add 1 to arg.
+  iree_vm_ref_release(reinterpret_cast<iree_vm_ref_t*>(call->arguments.data));
+  int32_t arg;
+  memcpy(&arg, call->arguments.data + sizeof(iree_vm_ref_t), sizeof(arg));
+  int32_t ret = arg + 1;
+  memcpy(call->results.data, &ret, sizeof(ret));
+  return iree_ok_status();
+}
+
 static const iree_vm_native_export_descriptor_t
     native_import_module_exports_[] = {
         {iree_make_cstring_view("add_1"), iree_make_cstring_view("0i.i"), 0,
          NULL},
+        {iree_make_cstring_view("add_1_ref"), iree_make_cstring_view("0ri.i"),
+         0, NULL},
+        {iree_make_cstring_view("add_1_x2"), iree_make_cstring_view("0ii.ii"),
+         0, NULL},
 };
 static const iree_vm_native_function_ptr_t native_import_module_funcs_[] = {
     {(iree_vm_native_function_shim_t)native_import_module_add_1, NULL},
+    {(iree_vm_native_function_shim_t)native_import_module_add_1_ref, NULL},
+    {(iree_vm_native_function_shim_t)native_import_module_add_1_x2, NULL},
 };
 static_assert(IREE_ARRAYSIZE(native_import_module_funcs_) ==
                   IREE_ARRAYSIZE(native_import_module_exports_),
@@ -277,6 +311,33 @@ static void BM_CallImportedFuncBytecode(benchmark::State& state) {
 }
 BENCHMARK(BM_CallImportedFuncBytecode);
 
+static void BM_CallImportedFuncX2Bytecode(benchmark::State& state) {
+  IREE_CHECK_OK(
+      RunFunction(state, "bytecode_module_benchmark.call_imported_func_x2",
+                  {100},
+                  /*result_count=*/1,
+                  /*batch_size=*/10));
+}
+BENCHMARK(BM_CallImportedFuncX2Bytecode);
+
+static void BM_CallImportedFuncRefBytecode(benchmark::State& state) {
+  IREE_CHECK_OK(
+      RunFunction(state, "bytecode_module_benchmark.call_imported_func_ref",
+                  {100},
+                  /*result_count=*/1,
+                  /*batch_size=*/10));
+}
+BENCHMARK(BM_CallImportedFuncRefBytecode);
+
+static void BM_LoopCallImportedFuncGlobalRefBytecode(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(
+      state, "bytecode_module_benchmark.loop_call_imported_func_global_ref",
+      {static_cast<int32_t>(state.range(0))},
+      /*result_count=*/1,
+      /*batch_size=*/state.range(0)));
+}
+BENCHMARK(BM_LoopCallImportedFuncGlobalRefBytecode)->Arg(10000);
+
 static void BM_LoopSumReference(benchmark::State& state) {
   static auto work = +[](int x) {
     benchmark::DoNotOptimize(x);
@@ -305,4 +366,32 @@ static void BM_LoopSumBytecode(benchmark::State& state) {
 }
 BENCHMARK(BM_LoopSumBytecode)->Arg(100000);
 
+static void BM_LoopSumF32Reference(benchmark::State& state) {
+  static auto work = +[](float x) {
+    benchmark::DoNotOptimize(x);
+    return x;
+  };
+  static auto loop = +[](int count) {
+    float sum = 0.0f;
+    for (int i = 0; i < count; ++i) {
+      benchmark::DoNotOptimize(sum = work(sum + 0.5f));
+    }
+    return sum;
+  };
+  while (state.KeepRunningBatch(state.range(0))) {
+    float ret = loop(static_cast<int>(state.range(0)));
+    benchmark::DoNotOptimize(ret);
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_LoopSumF32Reference)->Arg(100000);
+
+static void BM_LoopSumF32Bytecode(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(state, "bytecode_module_benchmark.loop_sum_f32",
+                            {static_cast<int32_t>(state.range(0))},
+                            /*result_count=*/1,
+                            /*batch_size=*/state.range(0)));
+}
+BENCHMARK(BM_LoopSumF32Bytecode)->Arg(100000);
+
 }  // namespace
@@ -63,6 +63,59 @@ vm.module @bytecode_module_benchmark {
     vm.return %20 : i32
   }
 
+  // Measures the cost of a call to an imported function with multiple
+  // arguments and results.
+  vm.import @native_import_module.add_1_x2(%a : i32, %b : i32) -> (i32, i32)
+  vm.export @call_imported_func_x2
+  vm.func @call_imported_func_x2(%arg0 : i32) -> i32 {
+    %0:2 = vm.call @native_import_module.add_1_x2(%arg0, %arg0) : (i32, i32) -> (i32, i32)
+    %1:2 = vm.call @native_import_module.add_1_x2(%0#1, %0#0) : (i32, i32) -> (i32, i32)
+    %2:2 = vm.call @native_import_module.add_1_x2(%1#1, %1#0) : (i32, i32) -> (i32, i32)
+    %3:2 = vm.call @native_import_module.add_1_x2(%2#1, %2#0) : (i32, i32) -> (i32, i32)
+    %4:2 = vm.call @native_import_module.add_1_x2(%3#1, %3#0) : (i32, i32) -> (i32, i32)
+    %5:2 = vm.call @native_import_module.add_1_x2(%4#1, %4#0) : (i32, i32) -> (i32, i32)
+    %6:2 = vm.call @native_import_module.add_1_x2(%5#1, %5#0) : (i32, i32) -> (i32, i32)
+    %7:2 = vm.call @native_import_module.add_1_x2(%6#1, %6#0) : (i32, i32) -> (i32, i32)
+    %8:2 = vm.call @native_import_module.add_1_x2(%7#1, %7#0) : (i32, i32) -> (i32, i32)
+    %9:2 = vm.call @native_import_module.add_1_x2(%8#1, %8#0) : (i32, i32) -> (i32, i32)
+    vm.return %9#0 : i32
+  }
+
+  // Measures the cost of a call to an imported function taking a ref.
+  vm.import @native_import_module.add_1_ref(%ref : !vm.ref<?>, %arg : i32) -> i32
+  vm.export @call_imported_func_ref
+  vm.func @call_imported_func_ref(%arg0 : i32) -> i32 {
+    %null = vm.const.ref.zero : !vm.ref<?>
+    %0 = vm.call @native_import_module.add_1_ref(%null, %arg0) : (!vm.ref<?>, i32) -> i32
+    %1 = vm.call @native_import_module.add_1_ref(%null, %0) : (!vm.ref<?>, i32) -> i32
+    %2 = vm.call @native_import_module.add_1_ref(%null, %1) : (!vm.ref<?>, i32) -> i32
+    %3 = vm.call @native_import_module.add_1_ref(%null, %2) : (!vm.ref<?>, i32) -> i32
+    %4 = vm.call @native_import_module.add_1_ref(%null, %3) : (!vm.ref<?>, i32) -> i32
+    %5 = vm.call @native_import_module.add_1_ref(%null, %4) : (!vm.ref<?>, i32) -> i32
+    %6 = vm.call @native_import_module.add_1_ref(%null, %5) : (!vm.ref<?>, i32) -> i32
+    %7 = vm.call @native_import_module.add_1_ref(%null, %6) : (!vm.ref<?>, i32) -> i32
+    %8 = vm.call @native_import_module.add_1_ref(%null, %7) : (!vm.ref<?>, i32) -> i32
+    %9 = vm.call @native_import_module.add_1_ref(%null, %8) : (!vm.ref<?>, i32) -> i32
+    vm.return %9 : i32
+  }
+
+  // Measures the cost of a loop shaped like the ones HAL modules use when
+  // recording commands: each iteration loads a ref from a global and passes
+  // it to an imported function.
+  vm.global.ref @device mutable : !vm.ref<?>
+  vm.export @loop_call_imported_func_global_ref
+  vm.func @loop_call_imported_func_global_ref(%count : i32) -> i32 {
+    %i0 = vm.const.i32.zero : i32
+    vm.br ^loop(%i0 : i32)
+  ^loop(%i : i32):
+    %device = vm.global.load.ref @device : !vm.ref<?>
+    %in = vm.call @native_import_module.add_1_ref(%device, %i) : (!vm.ref<?>, i32) -> i32
+    %cmp = vm.cmp.lt.i32.s %in, %count : i32
+    vm.cond_br %cmp, ^loop(%in : i32), ^loop_exit(%in : i32)
+  ^loop_exit(%ie : i32):
+    vm.return %ie : i32
+  }
+
   // Measures the cost of a simple for-loop.
   vm.export @loop_sum
   vm.func @loop_sum(%count : i32) -> i32 {
@@ -76,4 +129,21 @@ vm.module @bytecode_module_benchmark {
   ^loop_exit(%ie : i32):
     vm.return %ie : i32
   }
+
+  // Measures the cost of a simple for-loop with a floating-point accumulator.
+  vm.export @loop_sum_f32
+  vm.func @loop_sum_f32(%count : i32) -> f32 {
+    %c1 = vm.const.i32 1 : i32
+    %i0 = vm.const.i32.zero : i32
+    %step = vm.const.f32 0.5 : f32
+    %sum0 = vm.const.f32.zero : f32
+    vm.br ^loop(%i0, %sum0 : i32, f32)
+  ^loop(%i : i32, %sum : f32):
+    %in = vm.add.i32 %i, %c1 : i32
+    %sumn = vm.add.f32 %sum, %step : f32
+    %cmp = vm.cmp.lt.i32.s %in, %count : i32
+    vm.cond_br %cmp, ^loop(%in, %sumn : i32, f32), ^loop_exit(%sumn : f32)
+  ^loop_exit(%sume : f32):
+    vm.return %sume : f32
+  }
 }
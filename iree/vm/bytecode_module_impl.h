@@ -24,6 +24,7 @@
 #endif  // _MSC_VER
 
 #include "iree/base/api.h"
+#include "iree/base/atomics.h"
 #include "iree/vm/api.h"
 
 // NOTE: include order matters:
@@ -62,7 +63,9 @@ typedef struct {
   iree_host_size_t function_descriptor_count;
   const iree_vm_FunctionDescriptor_t* function_descriptor_table;
 
-  // A pointer to the bytecode data embedded within the module.
+  // The bytecode data embedded within the module. Hot op pairs are rewritten
+  // into fused superinstructions when the module is loaded in a copy owned by
+  // the module allocation.
   iree_const_byte_span_t bytecode_data;
 
   // Allocator this module was allocated with and must be freed with.
@@ -78,6 +81,29 @@ typedef struct {
   iree_vm_type_def_t* type_table;
 } iree_vm_bytecode_module_t;
 
+// Marshaling thunk selected for an import when it is resolved.
+// Thunks let the interpreter skip scanning the calling convention string on
+// each call for common signatures.
+enum iree_vm_bytecode_import_thunk_e {
+  // Marshals values by walking the cconv fragments. Required for variadic
+  // signatures and any signature the other thunks don't handle.
+  IREE_VM_BYTECODE_IMPORT_THUNK_GENERIC = 0,
+  // All arguments and results are 32-bit primitives (i32/f32). Values are
+  // copied directly between registers and the tightly packed ABI buffers.
+  IREE_VM_BYTECODE_IMPORT_THUNK_PRIMITIVE_32 = 1,
+};
+typedef uint8_t iree_vm_bytecode_import_thunk_t;
+
+enum iree_vm_bytecode_import_flag_e {
+  // Arguments contain refs and the ABI buffer must be zeroed before moving
+  // values into it (as ref assignment releases any existing value).
+  IREE_VM_BYTECODE_IMPORT_FLAG_ARGUMENT_REFS = 1u << 0,
+  // Results contain refs and the ABI buffer must be zeroed before the callee
+  // assigns into it.
+  IREE_VM_BYTECODE_IMPORT_FLAG_RESULT_REFS = 1u << 1,
+};
+typedef uint8_t iree_vm_bytecode_import_flags_t;
+
 // A resolved and split import in the module state table.
 //
 // NOTE: a table of these are stored per module per context so ideally we'd
@@ -98,6 +124,10 @@ typedef struct {
   // don't support variadic values (yet).
   uint16_t argument_buffer_size;
   uint16_t result_buffer_size;
+
+  // Marshaling thunk and buffer requirements precompiled from the signature.
+  iree_vm_bytecode_import_thunk_t thunk;
+  iree_vm_bytecode_import_flags_t flags;
 } iree_vm_bytecode_import_t;
 
 // Per-instance module state.
@@ -115,8 +145,9 @@ typedef struct {
 
   // TODO(benvanik): move to iree_vm_bytecode_module_t if always static.
   // Initialized references to rodata segments.
-  // Right now these don't do much, however we can perform lazy caching and
-  // on-the-fly decompression using this information.
+  // Uncompressed segments point directly into the module flatbuffer while
+  // compressed segments have a NULL data pointer (with the decompressed
+  // length) until first accessed and decompressed into state-owned memory.
   iree_host_size_t rodata_ref_count;
   iree_vm_ro_byte_buffer_t* rodata_ref_table;
 
@@ -128,16 +159,59 @@ typedef struct {
   iree_allocator_t allocator;
 } iree_vm_bytecode_module_state_t;
 
+// Returns true if the data of rodata segment |ref| is resident.
+// Compressed segments are published by
+// iree_vm_bytecode_module_state_ensure_rodata and this may race with that.
+static inline bool iree_vm_bytecode_rodata_is_resident(
+    const iree_vm_ro_byte_buffer_t* ref) {
+  return iree_atomic_load_ptr((iree_atomic_ptr_t*)&ref->data.data,
+                              iree_memory_order_acquire) != 0;
+}
+
+// Ensures that rodata segment |ordinal| is resident, decompressing it into
+// memory owned by |state| on first access if the segment is compressed.
+// |ordinal| must be in range. Safe to call concurrently on the same state; if
+// multiple threads race to decompress a segment only one copy is kept.
+iree_status_t iree_vm_bytecode_module_state_ensure_rodata(
+    iree_vm_bytecode_module_t* module,
+    const iree_vm_bytecode_module_state_t* state, iree_host_size_t ordinal);
+
 // Begins (or resumes) execution of the current frame and continues until
 // either a yield or return. |out_result| will contain the result status for
-// continuation, if needed.
+// continuation, if needed. When |is_resume| is true execution continues from
+// the suspended frame at the top of |stack| and the |call| arguments are
+// ignored.
 iree_status_t iree_vm_bytecode_dispatch(iree_vm_stack_t* stack,
                                         iree_vm_bytecode_module_t* module,
                                         const iree_vm_function_call_t* call,
                                         iree_string_view_t cconv_arguments,
                                         iree_string_view_t cconv_results,
+                                        bool is_resume,
                                         iree_vm_execution_result_t* out_result);
 
+// Enables load-time rewriting of hot op pairs into fused superinstructions.
+// Disable to compare against the unfused dispatch loop.
+//
+// Only opcodes are rewritten: operands keep their bytecode encoding and are
+// decoded at dispatch time as with unfused ops. A pre-decoded form with
+// register offsets resolved at load time is not implemented.
+#if !defined(IREE_VM_BYTECODE_FUSION_ENABLE)
+#define IREE_VM_BYTECODE_FUSION_ENABLE 1
+#endif  // !IREE_VM_BYTECODE_FUSION_ENABLE
+
+// Computes the offset of the op following the one at |pc| in |bytecode_data|
+// based on the encodings the compiler uses (see VMOps.td). Returns false if the
+// op is not known or extends past the end of the data.
+bool iree_vm_bytecode_scan_op(iree_const_byte_span_t bytecode_data,
+                              iree_host_size_t pc,
+                              iree_host_size_t* out_next_pc);
+
+// Rewrites hot op pairs in a single function's |bytecode_data| into fused
+// superinstructions in-place. Ops keep their encoding and offsets so the
+// result can be dispatched with the same pcs and branch targets. Functions
+// containing ops that cannot be measured are left unmodified.
+iree_status_t iree_vm_bytecode_fuse_function(iree_byte_span_t bytecode_data);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -0,0 +1,136 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the on-disk size and startup cost of modules with uncompressed and
+// LZ4-compressed rodata segments. The same source module is compiled twice
+// with different -iree-vm-bytecode-module-rodata-compression settings.
+
+#include "benchmark/benchmark.h"
+#include "iree/base/api.h"
+#include "iree/base/logging.h"
+#include "iree/vm/api.h"
+#include "iree/vm/bytecode_module.h"
+#include "iree/vm/bytecode_module_rodata_benchmark_lz4_module.h"
+#include "iree/vm/bytecode_module_rodata_benchmark_module.h"
+
+namespace {
+
+struct ModuleFile {
+  const char* data;
+  size_t size;
+};
+
+ModuleFile GetModuleFile(int64_t compressed) {
+  const auto* file_toc =
+      compressed ? iree::vm::bytecode_module_rodata_benchmark_lz4_module_create()
+                 : iree::vm::bytecode_module_rodata_benchmark_module_create();
+  return {file_toc->data, file_toc->size};
+}
+
+// Loads the module and creates a context, as would happen during application
+// startup. Compressed segments are not touched yet so this should be ~free.
+void BM_ModuleLoad(benchmark::State& state) {
+  ModuleFile module_file = GetModuleFile(state.range(0));
+  iree_vm_instance_t* instance = nullptr;
+  IREE_CHECK_OK(iree_vm_instance_create(iree_allocator_system(), &instance));
+  for (auto _ : state) {
+    iree_vm_module_t* module = nullptr;
+    IREE_CHECK_OK(iree_vm_bytecode_module_create(
+        iree_make_const_byte_span(module_file.data, module_file.size),
+        iree_allocator_null(), iree_allocator_system(), &module));
+    iree_vm_context_t* context = nullptr;
+    IREE_CHECK_OK(iree_vm_context_create_with_modules(
+        instance, &module, /*module_count=*/1, iree_allocator_system(),
+        &context));
+    iree_vm_context_release(context);
+    iree_vm_module_release(module);
+  }
+  iree_vm_instance_release(instance);
+  state.counters["module_bytes"] = static_cast<double>(module_file.size);
+}
+BENCHMARK(BM_ModuleLoad)->ArgName("lz4")->Arg(0)->Arg(1);
+
+// Creates a context and accesses the rodata once; for compressed modules this
+// includes the one-time decompression cost.
+void BM_FirstRodataAccess(benchmark::State& state) {
+  ModuleFile module_file = GetModuleFile(state.range(0));
+  iree_vm_instance_t* instance = nullptr;
+  IREE_CHECK_OK(iree_vm_instance_create(iree_allocator_system(), &instance));
+  iree_vm_module_t* module = nullptr;
+  IREE_CHECK_OK(iree_vm_bytecode_module_create(
+      iree_make_const_byte_span(module_file.data, module_file.size),
+      iree_allocator_null(), iree_allocator_system(), &module));
+  iree_vm_function_t function;
+  IREE_CHECK_OK(iree_vm_module_lookup_function_by_name(
+      module, IREE_VM_FUNCTION_LINKAGE_EXPORT,
+      iree_make_cstring_view("get_weights"), &function));
+  iree_vm_list_t* outputs = nullptr;
+  IREE_CHECK_OK(iree_vm_list_create(/*element_type=*/nullptr, 1,
+                                    iree_allocator_system(), &outputs));
+
+  for (auto _ : state) {
+    iree_vm_context_t* context = nullptr;
+    IREE_CHECK_OK(iree_vm_context_create_with_modules(
+        instance, &module, /*module_count=*/1, iree_allocator_system(),
+        &context));
+    IREE_CHECK_OK(iree_vm_invoke(context, function, /*policy=*/nullptr,
+                                 /*inputs=*/nullptr, outputs,
+                                 iree_allocator_system()));
+    IREE_CHECK_OK(iree_vm_list_resize(outputs, 0));
+    iree_vm_context_release(context);
+  }
+
+  iree_vm_list_release(outputs);
+  iree_vm_module_release(module);
+  iree_vm_instance_release(instance);
+  state.SetBytesProcessed(state.iterations() * 262144 * sizeof(float));
+}
+BENCHMARK(BM_FirstRodataAccess)->ArgName("lz4")->Arg(0)->Arg(1);
+
+// Repeated rodata access on a warm context; compression must not affect this.
+void BM_SteadyStateRodataAccess(benchmark::State& state) {
+  ModuleFile module_file = GetModuleFile(state.range(0));
+  iree_vm_instance_t* instance = nullptr;
+  IREE_CHECK_OK(iree_vm_instance_create(iree_allocator_system(), &instance));
+  iree_vm_module_t* module = nullptr;
+  IREE_CHECK_OK(iree_vm_bytecode_module_create(
+      iree_make_const_byte_span(module_file.data, module_file.size),
+      iree_allocator_null(), iree_allocator_system(), &module));
+  iree_vm_context_t* context = nullptr;
+  IREE_CHECK_OK(iree_vm_context_create_with_modules(
+      instance, &module, /*module_count=*/1, iree_allocator_system(),
+      &context));
+  iree_vm_function_t function;
+  IREE_CHECK_OK(iree_vm_module_lookup_function_by_name(
+      module, IREE_VM_FUNCTION_LINKAGE_EXPORT,
+      iree_make_cstring_view("get_weights"), &function));
+  iree_vm_list_t* outputs = nullptr;
+  IREE_CHECK_OK(iree_vm_list_create(/*element_type=*/nullptr, 1,
+                                    iree_allocator_system(), &outputs));
+
+  for (auto _ : state) {
+    IREE_CHECK_OK(iree_vm_invoke(context, function, /*policy=*/nullptr,
+                                 /*inputs=*/nullptr, outputs,
+                                 iree_allocator_system()));
+    IREE_CHECK_OK(iree_vm_list_resize(outputs, 0));
+  }
+
+  iree_vm_list_release(outputs);
+  iree_vm_context_release(context);
+  iree_vm_module_release(module);
+  iree_vm_instance_release(instance);
+}
+BENCHMARK(BM_SteadyStateRodataAccess)->ArgName("lz4")->Arg(0)->Arg(1);
+
+}  // namespace
@@ -0,0 +1,12 @@
+// Module with a single large rodata segment used to measure the size and
+// startup cost of compressed vs. uncompressed rodata.
+vm.module @bytecode_module_rodata_benchmark {
+  // 1MB of highly compressible weights.
+  vm.rodata @weights dense<1.000000e+00> : tensor<262144xf32>
+
+  vm.export @get_weights
+  vm.func @get_weights() -> !vm.ref<!iree.byte_buffer> {
+    %weights = vm.const.ref.rodata @weights : !vm.ref<!iree.byte_buffer>
+    vm.return %weights : !vm.ref<!iree.byte_buffer>
+  }
+}
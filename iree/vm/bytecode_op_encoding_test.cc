@@ -0,0 +1,122 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Checks the op lengths used by iree_vm_bytecode_scan_op (and thus bytecode
+// fusion) against the encodings the compiler actually produces. The test
+// module uses every op in the op tables; if an op is added to VMOps.td without
+// updating the scan table, or its encoding changes, this test fails.
+
+#include <bitset>
+#include <cstring>
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/vm/bytecode_module_impl.h"
+#include "iree/vm/bytecode_op_encoding_test_module.h"
+#include "iree/vm/generated/bytecode_op_table.h"
+
+namespace {
+
+using OpcodeSet = std::bitset<256>;
+
+// Walks every internal function in the module with iree_vm_bytecode_scan_op
+// and records which opcodes were seen. Extension opcodes are recorded in the
+// set for their prefix.
+void ScanAllFunctions(OpcodeSet* out_core_ops, OpcodeSet* out_ext_i64_ops,
+                      OpcodeSet* out_ext_f32_ops) {
+  const auto* module_file_toc =
+      iree::vm::bytecode_op_encoding_test_module_create();
+  const uint8_t* flatbuffer_data =
+      reinterpret_cast<const uint8_t*>(module_file_toc->data);
+  ASSERT_EQ(0, iree_vm_BytecodeModuleDef_verify_as_root(flatbuffer_data,
+                                                        module_file_toc->size));
+  iree_vm_BytecodeModuleDef_table_t module_def =
+      iree_vm_BytecodeModuleDef_as_root(flatbuffer_data);
+
+  flatbuffers_uint8_vec_t bytecode_data =
+      iree_vm_BytecodeModuleDef_bytecode_data(module_def);
+  iree_vm_FunctionDescriptor_vec_t function_descriptors =
+      iree_vm_BytecodeModuleDef_function_descriptors(module_def);
+  size_t function_count =
+      iree_vm_FunctionDescriptor_vec_len(function_descriptors);
+  ASSERT_GT(function_count, 0);
+
+  for (size_t i = 0; i < function_count; ++i) {
+    const iree_vm_FunctionDescriptor_t* function_descriptor =
+        iree_vm_FunctionDescriptor_vec_at(function_descriptors, i);
+    ASSERT_LE(function_descriptor->bytecode_offset +
+                  function_descriptor->bytecode_length,
+              flatbuffers_uint8_vec_len(bytecode_data));
+    iree_const_byte_span_t function_data = iree_make_const_byte_span(
+        bytecode_data + function_descriptor->bytecode_offset,
+        function_descriptor->bytecode_length);
+
+    iree_host_size_t pc = 0;
+    while (pc < function_data.data_length) {
+      uint8_t opcode = function_data.data[pc];
+      out_core_ops->set(opcode);
+      if (pc + 1 < function_data.data_length) {
+        uint8_t ext_opcode = function_data.data[pc + 1];
+        if (opcode == IREE_VM_OP_CORE_PrefixExtI64) {
+          out_ext_i64_ops->set(ext_opcode);
+        } else if (opcode == IREE_VM_OP_CORE_PrefixExtF32) {
+          out_ext_f32_ops->set(ext_opcode);
+        }
+      }
+      iree_host_size_t next_pc = 0;
+      ASSERT_TRUE(iree_vm_bytecode_scan_op(function_data, pc, &next_pc))
+          << "function " << i << ": unknown or truncated op 0x" << std::hex
+          << static_cast<int>(opcode) << std::dec << " at pc " << pc;
+      ASSERT_GT(next_pc, pc);
+      pc = next_pc;
+    }
+    // A length that is too long for any op would run off the end of the
+    // function (caught above) and a length that is too short desynchronizes the
+    // scan so that it almost always lands mid-op or fails to end exactly here.
+    EXPECT_EQ(pc, function_data.data_length) << "function " << i;
+  }
+}
+
+TEST(BytecodeOpEncodingTest, ScanCoversEveryOp) {
+  OpcodeSet core_ops, ext_i64_ops, ext_f32_ops;
+  ScanAllFunctions(&core_ops, &ext_i64_ops, &ext_f32_ops);
+  if (HasFatalFailure()) return;
+
+  // Fused ops are only produced by the loader and the f64 extension is not yet
+  // implemented so neither can appear in compiled modules.
+  auto is_runtime_only = [](const char* name) {
+    return strncmp(name, "Fused", 5) == 0 || strcmp(name, "PrefixExtF64") == 0;
+  };
+#define EXPECT_CORE_OP_SEEN(opcode, name)                     \
+  if (!is_runtime_only(#name)) {                              \
+    EXPECT_TRUE(core_ops.test(IREE_VM_OP_CORE_##name))        \
+        << "no vm op in the test module encodes to " #name;  \
+  }
+#define EXPECT_EXT_I64_OP_SEEN(opcode, name)                  \
+  EXPECT_TRUE(ext_i64_ops.test(IREE_VM_OP_EXT_I64_##name))    \
+      << "no vm op in the test module encodes to " #name;
+#define EXPECT_EXT_F32_OP_SEEN(opcode, name)                  \
+  EXPECT_TRUE(ext_f32_ops.test(IREE_VM_OP_EXT_F32_##name))    \
+      << "no vm op in the test module encodes to " #name;
+#define IGNORE_RESERVED(...)
+  IREE_VM_OP_CORE_TABLE(EXPECT_CORE_OP_SEEN, IGNORE_RESERVED);
+  IREE_VM_OP_EXT_I64_TABLE(EXPECT_EXT_I64_OP_SEEN, IGNORE_RESERVED);
+  IREE_VM_OP_EXT_F32_TABLE(EXPECT_EXT_F32_OP_SEEN, IGNORE_RESERVED);
+#undef IGNORE_RESERVED
+#undef EXPECT_EXT_F32_OP_SEEN
+#undef EXPECT_EXT_I64_OP_SEEN
+#undef EXPECT_CORE_OP_SEEN
+}
+
+}  // namespace
@@ -0,0 +1,308 @@
+// Uses every op in generated/bytecode_op_table.h at least once so that
+// bytecode_op_encoding_test.cc can check the runtime's op length table against
+// the encodings produced by the compiler. The functions are never executed.
+//
+// This must be compiled with -iree-vm-bytecode-module-optimize=false so that
+// no ops get folded away or rewritten into others.
+
+vm.module @bytecode_op_encoding_test {
+
+  vm.import @import_fn(%arg0 : i32) -> i32
+  vm.import @variadic_fn(%arg0 : i32, %arg1 : i32 ...) -> i32
+
+  vm.rodata @buf0 dense<[0, 1, 2]> : tensor<3xi8>
+
+  vm.global.i32 @g_i32 mutable : i32
+  vm.global.i64 @g_i64 mutable : i64
+  vm.global.f32 @g_f32 mutable : f32
+  vm.global.ref @g_ref mutable : !vm.ref<?>
+
+  //===--------------------------------------------------------------------===//
+  // Globals
+  //===--------------------------------------------------------------------===//
+
+  vm.export @globals
+  vm.func @globals(%i32 : i32, %ref : !vm.ref<?>) -> (i32, !vm.ref<?>) {
+    vm.global.store.i32 %i32, @g_i32 : i32
+    %0 = vm.global.load.i32 @g_i32 : i32
+    %p0 = vm.global.address @g_i32 : !iree.ptr<i32>
+    vm.global.store.indirect.i32 %0, %p0 : i32 -> !iree.ptr<i32>
+    %1 = vm.global.load.indirect.i32 %p0 : !iree.ptr<i32> -> i32
+    vm.global.store.ref %ref, @g_ref : !vm.ref<?>
+    %2 = vm.global.load.ref @g_ref : !vm.ref<?>
+    %p1 = vm.global.address @g_ref : !iree.ptr<!vm.ref<?>>
+    vm.global.store.indirect.ref %2, %p1 : !vm.ref<?> -> !iree.ptr<!vm.ref<?>>
+    %3 = vm.global.load.indirect.ref %p1 : !iree.ptr<!vm.ref<?>> -> !vm.ref<?>
+    vm.return %1, %3 : i32, !vm.ref<?>
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Constants
+  //===--------------------------------------------------------------------===//
+
+  vm.export @constants
+  vm.func @constants() -> (i32, i32, !vm.ref<?>, !vm.ref<!iree.byte_buffer>) {
+    %0 = vm.const.i32.zero : i32
+    %1 = vm.const.i32 1 : i32
+    %2 = vm.const.ref.zero : !vm.ref<?>
+    %3 = vm.const.ref.rodata @buf0 : !vm.ref<!iree.byte_buffer>
+    vm.return %0, %1, %2, %3 : i32, i32, !vm.ref<?>, !vm.ref<!iree.byte_buffer>
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Lists
+  //===--------------------------------------------------------------------===//
+
+  vm.export @lists
+  vm.func @lists(%capacity : i32, %ref : !vm.ref<?>) -> (i32, i32, !vm.ref<?>) {
+    %list = vm.list.alloc %capacity : (i32) -> !vm.list<i32>
+    vm.list.reserve %list, %capacity : (!vm.list<i32>, i32)
+    vm.list.resize %list, %capacity : (!vm.list<i32>, i32)
+    %0 = vm.list.size %list : (!vm.list<i32>) -> i32
+    vm.list.set.i32 %list, %0, %capacity : (!vm.list<i32>, i32, i32)
+    %1 = vm.list.get.i32 %list, %0 : (!vm.list<i32>, i32) -> i32
+    %refs = vm.list.alloc %capacity : (i32) -> !vm.list<!vm.ref<?>>
+    vm.list.set.ref %refs, %0, %ref : (!vm.list<!vm.ref<?>>, i32, !vm.ref<?>)
+    %2 = vm.list.get.ref %refs, %0 : (!vm.list<!vm.ref<?>>, i32) -> !vm.ref<?>
+    vm.return %0, %1, %2 : i32, i32, !vm.ref<?>
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Conditional assignment
+  //===--------------------------------------------------------------------===//
+
+  vm.export @assignment
+  vm.func @assignment(%cond : i32, %a : i32, %b : i32,
+                      %ra : !vm.ref<?>, %rb : !vm.ref<?>) ->
+      (i32, !vm.ref<?>, i32, !vm.ref<?>) {
+    %0 = vm.select.i32 %cond, %a, %b : i32
+    %1 = vm.select.ref %cond, %ra, %rb : !vm.ref<?>
+    %2 = vm.switch.i32 %cond[%a, %b] else %cond : i32
+    %3 = vm.switch.ref %cond[%ra, %rb] else %ra : !vm.ref<?>
+    vm.return %0, %1, %2, %3 : i32, !vm.ref<?>, i32, !vm.ref<?>
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Native integer arithmetic, bitwise ops, and shifts
+  //===--------------------------------------------------------------------===//
+
+  vm.export @arithmetic_i32
+  vm.func @arithmetic_i32(%a : i32, %b : i32) ->
+      (i32, i32, i32, i32, i32, i32, i32) {
+    %0 = vm.add.i32 %a, %b : i32
+    %1 = vm.sub.i32 %a, %b : i32
+    %2 = vm.mul.i32 %a, %b : i32
+    %3 = vm.div.i32.s %a, %b : i32
+    %4 = vm.div.i32.u %a, %b : i32
+    %5 = vm.rem.i32.s %a, %b : i32
+    %6 = vm.rem.i32.u %a, %b : i32
+    vm.return %0, %1, %2, %3, %4, %5, %6 : i32, i32, i32, i32, i32, i32, i32
+  }
+
+  vm.export @bitwise_i32
+  vm.func @bitwise_i32(%a : i32, %b : i32) ->
+      (i32, i32, i32, i32, i32, i32, i32) {
+    %0 = vm.not.i32 %a : i32
+    %1 = vm.and.i32 %a, %b : i32
+    %2 = vm.or.i32 %a, %b : i32
+    %3 = vm.xor.i32 %a, %b : i32
+    %4 = vm.shl.i32 %a, 2 : i32
+    %5 = vm.shr.i32.s %a, 2 : i32
+    %6 = vm.shr.i32.u %a, 2 : i32
+    vm.return %0, %1, %2, %3, %4, %5, %6 : i32, i32, i32, i32, i32, i32, i32
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Casting and type conversion/emulation
+  //===--------------------------------------------------------------------===//
+
+  vm.export @conversion_i32
+  vm.func @conversion_i32(%a : i32) -> (i32, i32, i32, i32, i32, i32) {
+    %0 = vm.trunc.i32.i8 %a : i32 -> i32
+    %1 = vm.trunc.i32.i16 %a : i32 -> i32
+    %2 = vm.ext.i8.i32.s %a : i32 -> i32
+    %3 = vm.ext.i8.i32.u %a : i32 -> i32
+    %4 = vm.ext.i16.i32.s %a : i32 -> i32
+    %5 = vm.ext.i16.i32.u %a : i32 -> i32
+    vm.return %0, %1, %2, %3, %4, %5 : i32, i32, i32, i32, i32, i32
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Comparison ops
+  //===--------------------------------------------------------------------===//
+
+  vm.export @comparison_i32
+  vm.func @comparison_i32(%a : i32, %b : i32, %ra : !vm.ref<?>,
+                          %rb : !vm.ref<?>) ->
+      (i32, i32, i32, i32, i32, i32, i32, i32) {
+    %0 = vm.cmp.eq.i32 %a, %b : i32
+    %1 = vm.cmp.ne.i32 %a, %b : i32
+    %2 = vm.cmp.lt.i32.s %a, %b : i32
+    %3 = vm.cmp.lt.i32.u %a, %b : i32
+    %4 = vm.cmp.nz.i32 %a : i32
+    %5 = vm.cmp.eq.ref %ra, %rb : !vm.ref<?>
+    %6 = vm.cmp.ne.ref %ra, %rb : !vm.ref<?>
+    %7 = vm.cmp.nz.ref %ra : !vm.ref<?>
+    vm.return %0, %1, %2, %3, %4, %5, %6, %7 :
+        i32, i32, i32, i32, i32, i32, i32, i32
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Control flow
+  //===--------------------------------------------------------------------===//
+
+  vm.export @control_flow
+  vm.func @control_flow(%cond : i32, %a : i32, %b : i32) -> i32 {
+    vm.cond_br %cond, ^bb1(%a : i32), ^bb2(%b : i32)
+  ^bb1(%0 : i32):
+    vm.br ^bb2(%0 : i32)
+  ^bb2(%1 : i32):
+    vm.return %1 : i32
+  }
+
+  vm.export @calls
+  vm.func @calls(%a : i32, %b : i32) -> (i32, i32) {
+    %0 = vm.call @import_fn(%a) : (i32) -> i32
+    %1 = vm.call.variadic @variadic_fn(%a, [%a, %b]) : (i32, i32 ...) -> i32
+    vm.return %0, %1 : i32, i32
+  }
+
+  vm.export @fail
+  vm.func @fail(%code : i32) {
+    vm.fail %code, "message"
+  }
+
+  vm.export @yield
+  vm.func @yield() {
+    vm.yield
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Debugging
+  //===--------------------------------------------------------------------===//
+
+  vm.export @debugging
+  vm.func @debugging(%cond : i32, %a : i32) {
+    vm.trace "event"(%cond, %a) : i32, i32
+    vm.print "message"(%cond, %a) : i32, i32
+    vm.break ^bb1(%a : i32)
+  ^bb1(%0 : i32):
+    vm.cond_break %cond, ^bb2(%0 : i32)
+  ^bb2(%1 : i32):
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // ExtI64: 64-bit integer ops
+  //===--------------------------------------------------------------------===//
+
+  vm.export @ext_i64
+  vm.func @ext_i64(%a : i64, %b : i64, %i : i32) ->
+      (i64, i64, i64, i64, i64, i64, i64, i64, i64, i64, i64, i64, i64, i64,
+       i64, i64, i64) {
+    %0 = vm.const.i64.zero : i64
+    %1 = vm.const.i64 1 : i64
+    vm.global.store.i64 %a, @g_i64 : i64
+    %2 = vm.global.load.i64 @g_i64 : i64
+    %p = vm.global.address @g_i64 : !iree.ptr<i64>
+    vm.global.store.indirect.i64 %a, %p : i64 -> !iree.ptr<i64>
+    %3 = vm.global.load.indirect.i64 %p : !iree.ptr<i64> -> i64
+    %list = vm.list.alloc %i : (i32) -> !vm.list<i64>
+    vm.list.set.i64 %list, %i, %a : (!vm.list<i64>, i32, i64)
+    %4 = vm.list.get.i64 %list, %i : (!vm.list<i64>, i32) -> i64
+    %5 = vm.select.i64 %i, %a, %b : i64
+    %6 = vm.switch.i64 %i[%a, %b] else %0 : i64
+    %7 = vm.add.i64 %a, %b : i64
+    %8 = vm.sub.i64 %a, %b : i64
+    %9 = vm.mul.i64 %a, %b : i64
+    %10 = vm.div.i64.s %a, %b : i64
+    %11 = vm.div.i64.u %a, %b : i64
+    %12 = vm.rem.i64.s %a, %b : i64
+    %13 = vm.rem.i64.u %a, %b : i64
+    %14 = vm.not.i64 %a : i64
+    %15 = vm.and.i64 %a, %b : i64
+    %16 = vm.or.i64 %a, %b : i64
+    %17 = vm.xor.i64 %a, %b : i64
+    vm.return %1, %2, %3, %4, %5, %6, %7, %8, %9, %10, %11, %12, %13, %14,
+        %15, %16, %17 : i64, i64, i64, i64, i64, i64, i64, i64, i64, i64, i64,
+        i64, i64, i64, i64, i64, i64
+  }
+
+  vm.export @ext_i64_conversion
+  vm.func @ext_i64_conversion(%a : i64, %b : i64, %i : i32) ->
+      (i64, i64, i64, i32, i64, i64, i32, i32, i32, i32, i32, i32) {
+    %0 = vm.shl.i64 %a, 2 : i64
+    %1 = vm.shr.i64.s %a, 2 : i64
+    %2 = vm.shr.i64.u %a, 2 : i64
+    %3 = vm.trunc.i64.i32 %a : i64 -> i32
+    %4 = vm.ext.i32.i64.s %i : i32 -> i64
+    %5 = vm.ext.i32.i64.u %i : i32 -> i64
+    %6 = vm.cmp.eq.i64 %a, %b : i64
+    %7 = vm.cmp.ne.i64 %a, %b : i64
+    %8 = vm.cmp.lt.i64.s %a, %b : i64
+    %9 = vm.cmp.lt.i64.u %a, %b : i64
+    %10 = vm.cmp.nz.i64 %a : i64
+    vm.return %0, %1, %2, %3, %4, %5, %6, %7, %8, %9, %10, %10 :
+        i64, i64, i64, i32, i64, i64, i32, i32, i32, i32, i32, i32
+  }
+
+  //===--------------------------------------------------------------------===//
+  // ExtF32: 32-bit floating-point ops
+  //===--------------------------------------------------------------------===//
+
+  vm.export @ext_f32
+  vm.func @ext_f32(%a : f32, %b : f32, %i : i32) ->
+      (f32, f32, f32, f32, f32, f32, f32, f32, f32, f32, f32, f32, f32, f32) {
+    %0 = vm.const.f32.zero : f32
+    %1 = vm.const.f32 1.5 : f32
+    vm.global.store.f32 %a, @g_f32 : f32
+    %2 = vm.global.load.f32 @g_f32 : f32
+    %p = vm.global.address @g_f32 : !iree.ptr<f32>
+    vm.global.store.indirect.f32 %a, %p : f32 -> !iree.ptr<f32>
+    %3 = vm.global.load.indirect.f32 %p : !iree.ptr<f32> -> f32
+    %list = vm.list.alloc %i : (i32) -> !vm.list<f32>
+    vm.list.set.f32 %list, %i, %a : (!vm.list<f32>, i32, f32)
+    %4 = vm.list.get.f32 %list, %i : (!vm.list<f32>, i32) -> f32
+    %5 = vm.select.f32 %i, %a, %b : f32
+    %6 = vm.add.f32 %a, %b : f32
+    %7 = vm.sub.f32 %a, %b : f32
+    %8 = vm.mul.f32 %a, %b : f32
+    %9 = vm.div.f32 %a, %b : f32
+    %10 = vm.rem.f32 %a, %b : f32
+    %11 = vm.abs.f32 %a : f32
+    %12 = vm.neg.f32 %a : f32
+    vm.return %0, %1, %2, %3, %4, %5, %6, %7, %8, %9, %10, %11, %12, %12 :
+        f32, f32, f32, f32, f32, f32, f32, f32, f32, f32, f32, f32, f32, f32
+  }
+
+  vm.export @ext_f32_conversion
+  vm.func @ext_f32_conversion(%a : f32, %b : f32, %i : i32) ->
+      (f32, f32, i32, i32, f32, i32) {
+    %0 = vm.cast.si32.f32 %i : i32 -> f32
+    %1 = vm.cast.ui32.f32 %i : i32 -> f32
+    %2 = vm.cast.f32.si32 %a : f32 -> i32
+    %3 = vm.cast.f32.ui32 %a : f32 -> i32
+    %4 = vm.bitcast.i32.f32 %i : i32 -> f32
+    %5 = vm.bitcast.f32.i32 %a : f32 -> i32
+    vm.return %0, %1, %2, %3, %4, %5 : f32, f32, i32, i32, f32, i32
+  }
+
+  vm.export @ext_f32_comparison
+  vm.func @ext_f32_comparison(%a : f32, %b : f32) ->
+      (i32, i32, i32, i32, i32, i32, i32, i32, i32, i32) {
+    %0 = vm.cmp.eq.f32.o %a, %b : f32
+    %1 = vm.cmp.eq.f32.u %a, %b : f32
+    %2 = vm.cmp.ne.f32.o %a, %b : f32
+    %3 = vm.cmp.ne.f32.u %a, %b : f32
+    %4 = vm.cmp.lt.f32.o %a, %b : f32
+    %5 = vm.cmp.lt.f32.u %a, %b : f32
+    %6 = vm.cmp.lte.f32.o %a, %b : f32
+    %7 = vm.cmp.lte.f32.u %a, %b : f32
+    %8 = vm.cmp.nz.f32 %a : f32
+    %9 = vm.cmp.nan.f32 %a : f32
+    vm.return %0, %1, %2, %3, %4, %5, %6, %7, %8, %9 :
+        i32, i32, i32, i32, i32, i32, i32, i32, i32, i32
+  }
+
+}
@@ -15,15 +15,594 @@
 #ifndef IREE_VM_C_FUNCS_H_
 #define IREE_VM_C_FUNCS_H_
 
+// Implementations of the VM ops for modules compiled to C with the
+// -iree-vm-ir-to-c-module translation. Semantics must match the bytecode
+// interpreter in iree/vm/bytecode_dispatch.c.
+
+#include <math.h>
 #include <stdint.h>
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/base/math.h"
+#include "iree/vm/builtin_types.h"
+#include "iree/vm/list.h"
+#include "iree/vm/ref.h"
+#include "iree/vm/type_def.h"
+#include "iree/vm/value.h"
+
+//===----------------------------------------------------------------------===//
+// Constants
+//===----------------------------------------------------------------------===//
+
+static inline int32_t vm_const_i32(int32_t a) { return a; }
+static inline int32_t vm_const_i32_zero() { return 0; }
+static inline int64_t vm_const_i64(int64_t a) { return a; }
+static inline int64_t vm_const_i64_zero() { return 0; }
+static inline float vm_const_f32(float a) { return a; }
+static inline float vm_const_f32_zero() { return 0.0f; }
+
+//===----------------------------------------------------------------------===//
+// Conditional assignment
+//===----------------------------------------------------------------------===//
+
+static inline int32_t vm_select_i32(int32_t condition, int32_t true_value,
+                                    int32_t false_value) {
+  return condition ? true_value : false_value;
+}
+static inline int64_t vm_select_i64(int32_t condition, int64_t true_value,
+                                    int64_t false_value) {
+  return condition ? true_value : false_value;
+}
+static inline float vm_select_f32(int32_t condition, float true_value,
+                                  float false_value) {
+  return condition ? true_value : false_value;
+}
+
+//===----------------------------------------------------------------------===//
+// Native integer arithmetic
+//===----------------------------------------------------------------------===//
+// Signed overflow wraps as it does in the interpreter registers.
+
+static inline int32_t vm_add_i32(int32_t lhs, int32_t rhs) {
+  return (int32_t)((uint32_t)lhs + (uint32_t)rhs);
+}
+static inline int32_t vm_sub_i32(int32_t lhs, int32_t rhs) {
+  return (int32_t)((uint32_t)lhs - (uint32_t)rhs);
+}
+static inline int32_t vm_mul_i32(int32_t lhs, int32_t rhs) {
+  return (int32_t)((uint32_t)lhs * (uint32_t)rhs);
+}
+static inline int32_t vm_div_i32_s(int32_t lhs, int32_t rhs) {
+  return lhs / rhs;
+}
+static inline int32_t vm_div_i32_u(int32_t lhs, int32_t rhs) {
+  return (int32_t)((uint32_t)lhs / (uint32_t)rhs);
+}
+static inline int32_t vm_rem_i32_s(int32_t lhs, int32_t rhs) {
+  return lhs % rhs;
+}
+static inline int32_t vm_rem_i32_u(int32_t lhs, int32_t rhs) {
+  return (int32_t)((uint32_t)lhs % (uint32_t)rhs);
+}
+static inline int32_t vm_not_i32(int32_t operand) {
+  return (int32_t)(~(uint32_t)operand);
+}
+static inline int32_t vm_and_i32(int32_t lhs, int32_t rhs) {
+  return lhs & rhs;
+}
+static inline int32_t vm_or_i32(int32_t lhs, int32_t rhs) {
+  return lhs | rhs;
+}
+static inline int32_t vm_xor_i32(int32_t lhs, int32_t rhs) {
+  return lhs ^ rhs;
+}
+
+static inline int64_t vm_add_i64(int64_t lhs, int64_t rhs) {
+  return (int64_t)((uint64_t)lhs + (uint64_t)rhs);
+}
+static inline int64_t vm_sub_i64(int64_t lhs, int64_t rhs) {
+  return (int64_t)((uint64_t)lhs - (uint64_t)rhs);
+}
+static inline int64_t vm_mul_i64(int64_t lhs, int64_t rhs) {
+  return (int64_t)((uint64_t)lhs * (uint64_t)rhs);
+}
+static inline int64_t vm_div_i64_s(int64_t lhs, int64_t rhs) {
+  return lhs / rhs;
+}
+static inline int64_t vm_div_i64_u(int64_t lhs, int64_t rhs) {
+  return (int64_t)((uint64_t)lhs / (uint64_t)rhs);
+}
+static inline int64_t vm_rem_i64_s(int64_t lhs, int64_t rhs) {
+  return lhs % rhs;
+}
+static inline int64_t vm_rem_i64_u(int64_t lhs, int64_t rhs) {
+  return (int64_t)((uint64_t)lhs % (uint64_t)rhs);
+}
+static inline int64_t vm_not_i64(int64_t operand) {
+  return (int64_t)(~(uint64_t)operand);
+}
+static inline int64_t vm_and_i64(int64_t lhs, int64_t rhs) {
+  return lhs & rhs;
+}
+static inline int64_t vm_or_i64(int64_t lhs, int64_t rhs) {
+  return lhs | rhs;
+}
+static inline int64_t vm_xor_i64(int64_t lhs, int64_t rhs) {
+  return lhs ^ rhs;
+}
+
+//===----------------------------------------------------------------------===//
+// Native floating-point arithmetic
+//===----------------------------------------------------------------------===//
+
+static inline float vm_add_f32(float lhs, float rhs) {
+  return lhs + rhs;
+}
+static inline float vm_sub_f32(float lhs, float rhs) {
+  return lhs - rhs;
+}
+static inline float vm_mul_f32(float lhs, float rhs) {
+  return lhs * rhs;
+}
+static inline float vm_div_f32(float lhs, float rhs) {
+  return lhs / rhs;
+}
+static inline float vm_rem_f32(float lhs, float rhs) {
+  return fmodf(lhs, rhs);
+}
+static inline float vm_abs_f32(float operand) {
+  return fabsf(operand);
+}
+static inline float vm_neg_f32(float operand) {
+  return -operand;
+}
+
+//===----------------------------------------------------------------------===//
+// Native bitwise shifts and rotates
+//===----------------------------------------------------------------------===//
+
+static inline int32_t vm_shl_i32(int32_t operand, int8_t amount) {
+  return (int32_t)((uint32_t)operand << amount);
+}
+static inline int32_t vm_shr_i32_s(int32_t operand, int8_t amount) {
+  return operand >> amount;
+}
+static inline int32_t vm_shr_i32_u(int32_t operand, int8_t amount) {
+  return (int32_t)((uint32_t)operand >> amount);
+}
+static inline int64_t vm_shl_i64(int64_t operand, int8_t amount) {
+  return (int64_t)((uint64_t)operand << amount);
+}
+static inline int64_t vm_shr_i64_s(int64_t operand, int8_t amount) {
+  return operand >> amount;
+}
+static inline int64_t vm_shr_i64_u(int64_t operand, int8_t amount) {
+  return (int64_t)((uint64_t)operand >> amount);
+}
+
+//===----------------------------------------------------------------------===//
+// Casting and type conversion/emulation
+//===----------------------------------------------------------------------===//
+
+static inline int32_t vm_trunc_i32_i8(int32_t operand) {
+  return (int32_t)(uint8_t)operand;
+}
+static inline int32_t vm_trunc_i32_i16(int32_t operand) {
+  return (int32_t)(uint16_t)operand;
+}
+static inline int32_t vm_trunc_i64_i32(int64_t operand) {
+  return (int32_t)(uint32_t)operand;
+}
+static inline int32_t vm_ext_i8_i32_s(int32_t operand) {
+  return (int32_t)(int8_t)operand;
+}
+static inline int32_t vm_ext_i8_i32_u(int32_t operand) {
+  return (int32_t)(uint8_t)operand;
+}
+static inline int32_t vm_ext_i16_i32_s(int32_t operand) {
+  return (int32_t)(int16_t)operand;
+}
+static inline int32_t vm_ext_i16_i32_u(int32_t operand) {
+  return (int32_t)(uint16_t)operand;
+}
+static inline int64_t vm_ext_i32_i64_s(int32_t operand) {
+  return (int64_t)operand;
+}
+static inline int64_t vm_ext_i32_i64_u(int32_t operand) {
+  return (int64_t)(uint32_t)operand;
+}
+static inline float vm_cast_si32_f32(int32_t operand) {
+  return (float)operand;
+}
+static inline float vm_cast_ui32_f32(int32_t operand) {
+  return (float)(uint32_t)operand;
+}
+static inline int32_t vm_cast_f32_si32(float operand) {
+  return iree_math_f32_to_si32_sat(operand);
+}
+static inline int32_t vm_cast_f32_ui32(float operand) {
+  return (int32_t)iree_math_f32_to_ui32_sat(operand);
+}
+static inline float vm_bitcast_i32_f32(int32_t operand) {
+  float result;
+  memcpy(&result, &operand, sizeof(result));
+  return result;
+}
+static inline int32_t vm_bitcast_f32_i32(float operand) {
+  int32_t result;
+  memcpy(&result, &operand, sizeof(result));
+  return result;
+}
+
+//===----------------------------------------------------------------------===//
+// Comparison ops
+//===----------------------------------------------------------------------===//
+
+static inline int32_t vm_cmp_eq_i32(int32_t lhs, int32_t rhs) {
+  return (lhs == rhs) ? 1 : 0;
+}
+static inline int32_t vm_cmp_ne_i32(int32_t lhs, int32_t rhs) {
+  return (lhs != rhs) ? 1 : 0;
+}
+static inline int32_t vm_cmp_lt_i32_s(int32_t lhs, int32_t rhs) {
+  return (lhs < rhs) ? 1 : 0;
+}
+static inline int32_t vm_cmp_lt_i32_u(int32_t lhs, int32_t rhs) {
+  return ((uint32_t)lhs < (uint32_t)rhs) ? 1 : 0;
+}
+static inline int32_t vm_cmp_nz_i32(int32_t operand) {
+  return (operand != 0) ? 1 : 0;
+}
+static inline int32_t vm_cmp_eq_i64(int64_t lhs, int64_t rhs) {
+  return (lhs == rhs) ? 1 : 0;
+}
+static inline int32_t vm_cmp_ne_i64(int64_t lhs, int64_t rhs) {
+  return (lhs != rhs) ? 1 : 0;
+}
+static inline int32_t vm_cmp_lt_i64_s(int64_t lhs, int64_t rhs) {
+  return (lhs < rhs) ? 1 : 0;
+}
+static inline int32_t vm_cmp_lt_i64_u(int64_t lhs, int64_t rhs) {
+  return ((uint64_t)lhs < (uint64_t)rhs) ? 1 : 0;
+}
+static inline int32_t vm_cmp_nz_i64(int64_t operand) {
+  return (operand != 0) ? 1 : 0;
+}
+// Ordered (O) comparisons are false if either operand is NaN while unordered
+// (U) comparisons are true.
+static inline int32_t vm_cmp_eq_f32_o(float lhs, float rhs) {
+  return (lhs == rhs) ? 1 : 0;
+}
+static inline int32_t vm_cmp_eq_f32_u(float lhs, float rhs) {
+  return (!(lhs < rhs || lhs > rhs)) ? 1 : 0;
+}
+static inline int32_t vm_cmp_ne_f32_o(float lhs, float rhs) {
+  return (lhs < rhs || lhs > rhs) ? 1 : 0;
+}
+static inline int32_t vm_cmp_ne_f32_u(float lhs, float rhs) {
+  return (lhs != rhs) ? 1 : 0;
+}
+static inline int32_t vm_cmp_lt_f32_o(float lhs, float rhs) {
+  return (lhs < rhs) ? 1 : 0;
+}
+static inline int32_t vm_cmp_lt_f32_u(float lhs, float rhs) {
+  return (!(lhs >= rhs)) ? 1 : 0;
+}
+static inline int32_t vm_cmp_lte_f32_o(float lhs, float rhs) {
+  return (lhs <= rhs) ? 1 : 0;
+}
+static inline int32_t vm_cmp_lte_f32_u(float lhs, float rhs) {
+  return (!(lhs > rhs)) ? 1 : 0;
+}
+static inline int32_t vm_cmp_nan_f32(float operand) {
+  return isnan(operand) ? 1 : 0;
+}
+static inline int32_t vm_cmp_nz_f32(float operand) {
+  return (operand != 0) ? 1 : 0;
+}
+static inline int32_t vm_cmp_eq_ref(const iree_vm_ref_t* lhs,
+                                    const iree_vm_ref_t* rhs) {
+  return lhs->ptr == rhs->ptr ? 1 : 0;
+}
+static inline int32_t vm_cmp_ne_ref(const iree_vm_ref_t* lhs,
+                                    const iree_vm_ref_t* rhs) {
+  return lhs->ptr != rhs->ptr ? 1 : 0;
+}
+static inline int32_t vm_cmp_nz_ref(const iree_vm_ref_t* operand) {
+  return operand->ptr != NULL ? 1 : 0;
+}
+
+//===----------------------------------------------------------------------===//
+// Globals
+//===----------------------------------------------------------------------===//
+// Primitive globals are stored in a byte buffer at offsets assigned by the
+// compiler; unaligned access is avoided by going through memcpy.
+
+static inline int32_t vm_global_load_i32(const uint8_t* base,
+                                         int32_t offset) {
+  int32_t value;
+  memcpy(&value, base + offset, sizeof(value));
+  return value;
+}
+static inline void vm_global_store_i32(uint8_t* base, int32_t offset,
+                                       int32_t value) {
+  memcpy(base + offset, &value, sizeof(value));
+}
+static inline int64_t vm_global_load_i64(const uint8_t* base,
+                                         int32_t offset) {
+  int64_t value;
+  memcpy(&value, base + offset, sizeof(value));
+  return value;
+}
+static inline void vm_global_store_i64(uint8_t* base, int32_t offset,
+                                       int64_t value) {
+  memcpy(base + offset, &value, sizeof(value));
+}
+static inline float vm_global_load_f32(const uint8_t* base,
+                                       int32_t offset) {
+  float value;
+  memcpy(&value, base + offset, sizeof(value));
+  return value;
+}
+static inline void vm_global_store_f32(uint8_t* base, int32_t offset,
+                                       float value) {
+  memcpy(base + offset, &value, sizeof(value));
+}
+
+// Indirect accesses take the byte offset produced by vm.global.address and
+// must be bounds checked as the offset is a runtime value.
+static inline iree_status_t vm_global_load_indirect_i32(
+    const uint8_t* base, iree_host_size_t base_size, int32_t offset,
+    int32_t* out_value) {
+  if (IREE_UNLIKELY(offset < 0 || (iree_host_size_t)offset +
+                                        sizeof(*out_value) > base_size)) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "global byte offset %d out of range", offset);
+  }
+  *out_value = vm_global_load_i32(base, offset);
+  return iree_ok_status();
+}
+static inline iree_status_t vm_global_store_indirect_i32(
+    uint8_t* base, iree_host_size_t base_size, int32_t offset, int32_t value) {
+  if (IREE_UNLIKELY(offset < 0 ||
+                    (iree_host_size_t)offset + sizeof(value) > base_size)) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "global byte offset %d out of range", offset);
+  }
+  vm_global_store_i32(base, offset, value);
+  return iree_ok_status();
+}
+static inline iree_status_t vm_global_load_indirect_i64(
+    const uint8_t* base, iree_host_size_t base_size, int32_t offset,
+    int64_t* out_value) {
+  if (IREE_UNLIKELY(offset < 0 || (iree_host_size_t)offset +
+                                        sizeof(*out_value) > base_size)) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "global byte offset %d out of range", offset);
+  }
+  *out_value = vm_global_load_i64(base, offset);
+  return iree_ok_status();
+}
+static inline iree_status_t vm_global_store_indirect_i64(
+    uint8_t* base, iree_host_size_t base_size, int32_t offset, int64_t value) {
+  if (IREE_UNLIKELY(offset < 0 ||
+                    (iree_host_size_t)offset + sizeof(value) > base_size)) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "global byte offset %d out of range", offset);
+  }
+  vm_global_store_i64(base, offset, value);
+  return iree_ok_status();
+}
+static inline iree_status_t vm_global_load_indirect_f32(
+    const uint8_t* base, iree_host_size_t base_size, int32_t offset,
+    float* out_value) {
+  if (IREE_UNLIKELY(offset < 0 || (iree_host_size_t)offset +
+                                        sizeof(*out_value) > base_size)) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "global byte offset %d out of range", offset);
+  }
+  *out_value = vm_global_load_f32(base, offset);
+  return iree_ok_status();
+}
+static inline iree_status_t vm_global_store_indirect_f32(
+    uint8_t* base, iree_host_size_t base_size, int32_t offset, float value) {
+  if (IREE_UNLIKELY(offset < 0 ||
+                    (iree_host_size_t)offset + sizeof(value) > base_size)) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "global byte offset %d out of range", offset);
+  }
+  vm_global_store_f32(base, offset, value);
+  return iree_ok_status();
+}
+static inline iree_status_t vm_global_load_indirect_ref(
+    iree_vm_ref_t* refs, iree_host_size_t ref_count, int32_t ordinal,
+    iree_vm_ref_t* out_value) {
+  if (IREE_UNLIKELY(ordinal < 0 || (iree_host_size_t)ordinal >= ref_count)) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "global ref ordinal %d out of range", ordinal);
+  }
+  iree_vm_ref_retain(&refs[ordinal], out_value);
+  return iree_ok_status();
+}
+static inline iree_status_t vm_global_store_indirect_ref(
+    iree_vm_ref_t* refs, iree_host_size_t ref_count, int32_t ordinal,
+    iree_vm_ref_t* value) {
+  if (IREE_UNLIKELY(ordinal < 0 || (iree_host_size_t)ordinal >= ref_count)) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "global ref ordinal %d out of range", ordinal);
+  }
+  iree_vm_ref_retain(value, &refs[ordinal]);
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// Refs and ABI marshaling
+//===----------------------------------------------------------------------===//
+// Values in the function call ABI buffers are tightly packed (and may be
+// unaligned) and refs stored in them are owned by the buffer.
+
+// Returns a new reference to the value of |ref|.
+static inline iree_vm_ref_t vm_ref_retain_copy(iree_vm_ref_t* ref) {
+  iree_vm_ref_t result;
+  memset(&result, 0, sizeof(result));
+  iree_vm_ref_retain(ref, &result);
+  return result;
+}
+
+// Stores a new reference to |ref| into the ABI buffer at |ptr|.
+static inline void vm_abi_retain_ref(uint8_t* ptr, iree_vm_ref_t* ref) {
+  iree_vm_ref_t value = vm_ref_retain_copy(ref);
+  memcpy(ptr, &value, sizeof(value));
+}
+
+// Moves |ref| into the ABI buffer at |ptr| and resets |ref| to null.
+// Any value previously in the buffer is ignored.
+static inline void vm_abi_move_ref(uint8_t* ptr, iree_vm_ref_t* ref) {
+  memcpy(ptr, ref, sizeof(*ref));
+  memset(ref, 0, sizeof(*ref));
+}
+
+// Moves the ref in the ABI buffer at |ptr| into |out_ref|, releasing any value
+// |out_ref| previously held.
+static inline void vm_abi_take_ref(const uint8_t* ptr, iree_vm_ref_t* out_ref) {
+  iree_vm_ref_t value;
+  memcpy(&value, ptr, sizeof(value));
+  iree_vm_ref_move(&value, out_ref);
+}
+
+// Resolves the registered ref type with the given |name| (without the `!`
+// prefix used in the IR).
+static inline iree_status_t vm_lookup_ref_type(iree_string_view_t name,
+                                               iree_vm_ref_type_t* out_type) {
+  const iree_vm_ref_type_descriptor_t* descriptor =
+      iree_vm_ref_lookup_registered_type(name);
+  if (IREE_UNLIKELY(!descriptor)) {
+    return iree_make_status(IREE_STATUS_NOT_FOUND,
+                            "no type registered with name '%.*s'",
+                            (int)name.size, name.data);
+  }
+  *out_type = descriptor->type;
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// Lists
+//===----------------------------------------------------------------------===//
+
+static inline iree_status_t vm_list_deref(iree_vm_ref_t* list_ref,
+                                          iree_vm_list_t** out_list) {
+  *out_list = iree_vm_list_deref(list_ref);
+  if (IREE_UNLIKELY(!*out_list)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT, "list is null");
+  }
+  return iree_ok_status();
+}
+
+static inline iree_status_t vm_list_alloc(iree_vm_type_def_t element_type,
+                                          int32_t initial_capacity,
+                                          iree_allocator_t allocator,
+                                          iree_vm_ref_t* out_list_ref) {
+  iree_vm_list_t* list = NULL;
+  IREE_RETURN_IF_ERROR(iree_vm_list_create(&element_type, initial_capacity,
+                                           allocator, &list));
+  return iree_vm_ref_wrap_assign(list, iree_vm_list_type_id(), out_list_ref);
+}
+
+static inline iree_status_t vm_list_reserve(iree_vm_ref_t* list_ref,
+                                            int32_t minimum_capacity) {
+  iree_vm_list_t* list = NULL;
+  IREE_RETURN_IF_ERROR(vm_list_deref(list_ref, &list));
+  return iree_vm_list_reserve(list, minimum_capacity);
+}
+
+static inline iree_status_t vm_list_size(iree_vm_ref_t* list_ref,
+                                         int32_t* out_size) {
+  iree_vm_list_t* list = NULL;
+  IREE_RETURN_IF_ERROR(vm_list_deref(list_ref, &list));
+  *out_size = (int32_t)iree_vm_list_size(list);
+  return iree_ok_status();
+}
+
+static inline iree_status_t vm_list_resize(iree_vm_ref_t* list_ref,
+                                           int32_t new_size) {
+  iree_vm_list_t* list = NULL;
+  IREE_RETURN_IF_ERROR(vm_list_deref(list_ref, &list));
+  return iree_vm_list_resize(list, new_size);
+}
+
+static inline iree_status_t vm_list_get_i32(iree_vm_ref_t* list_ref,
+                                            int32_t index, int32_t* out_value) {
+  iree_vm_list_t* list = NULL;
+  IREE_RETURN_IF_ERROR(vm_list_deref(list_ref, &list));
+  iree_vm_value_t value;
+  IREE_RETURN_IF_ERROR(
+      iree_vm_list_get_value_as(list, index, IREE_VM_VALUE_TYPE_I32, &value));
+  *out_value = value.i32;
+  return iree_ok_status();
+}
+
+static inline iree_status_t vm_list_set_i32(iree_vm_ref_t* list_ref,
+                                            int32_t index, int32_t raw_value) {
+  iree_vm_list_t* list = NULL;
+  IREE_RETURN_IF_ERROR(vm_list_deref(list_ref, &list));
+  iree_vm_value_t value = iree_vm_value_make_i32(raw_value);
+  return iree_vm_list_set_value(list, index, &value);
+}
+
+static inline iree_status_t vm_list_get_i64(iree_vm_ref_t* list_ref,
+                                            int32_t index, int64_t* out_value) {
+  iree_vm_list_t* list = NULL;
+  IREE_RETURN_IF_ERROR(vm_list_deref(list_ref, &list));
+  iree_vm_value_t value;
+  IREE_RETURN_IF_ERROR(
+      iree_vm_list_get_value_as(list, index, IREE_VM_VALUE_TYPE_I64, &value));
+  *out_value = value.i64;
+  return iree_ok_status();
+}
+
+static inline iree_status_t vm_list_set_i64(iree_vm_ref_t* list_ref,
+                                            int32_t index, int64_t raw_value) {
+  iree_vm_list_t* list = NULL;
+  IREE_RETURN_IF_ERROR(vm_list_deref(list_ref, &list));
+  iree_vm_value_t value = iree_vm_value_make_i64(raw_value);
+  return iree_vm_list_set_value(list, index, &value);
+}
+
+static inline iree_status_t vm_list_get_f32(iree_vm_ref_t* list_ref,
+                                            int32_t index, float* out_value) {
+  iree_vm_list_t* list = NULL;
+  IREE_RETURN_IF_ERROR(vm_list_deref(list_ref, &list));
+  iree_vm_value_t value;
+  IREE_RETURN_IF_ERROR(
+      iree_vm_list_get_value_as(list, index, IREE_VM_VALUE_TYPE_F32, &value));
+  *out_value = value.f32;
+  return iree_ok_status();
+}
 
-// arithmetic
-inline int32_t vm_add_i32(int32_t a, int32_t b) { return a + b; }
+static inline iree_status_t vm_list_set_f32(iree_vm_ref_t* list_ref,
+                                            int32_t index, float raw_value) {
+  iree_vm_list_t* list = NULL;
+  IREE_RETURN_IF_ERROR(vm_list_deref(list_ref, &list));
+  iree_vm_value_t value = iree_vm_value_make_f32(raw_value);
+  return iree_vm_list_set_value(list, index, &value);
+}
 
-// compare
-inline int32_t vm_cmp_ne_i32(int32_t a, int32_t b) { return a != b ? 1 : 0; }
+static inline iree_status_t vm_list_get_ref(iree_vm_ref_t* list_ref,
+                                            int32_t index,
+                                            iree_vm_ref_t* out_value) {
+  iree_vm_list_t* list = NULL;
+  IREE_RETURN_IF_ERROR(vm_list_deref(list_ref, &list));
+  iree_vm_ref_release(out_value);
+  return iree_vm_list_get_ref_retain(list, index, out_value);
+}
 
-// const
-inline int32_t vm_const_i32(int32_t a) { return a; }
+static inline iree_status_t vm_list_set_ref(iree_vm_ref_t* list_ref,
+                                            int32_t index,
+                                            iree_vm_ref_t* value) {
+  iree_vm_list_t* list = NULL;
+  IREE_RETURN_IF_ERROR(vm_list_deref(list_ref, &list));
+  return iree_vm_list_set_ref_retain(list, index, value);
+}
 
 #endif  // IREE_VM_C_FUNCS_H_
@@ -61,7 +61,17 @@ static iree_status_t iree_vm_context_run_function(
   iree_vm_execution_result_t result;
   status = module->begin_call(module->self, stack, &call, &result);
 
-  // TODO(benvanik): ensure completed synchronously.
+  // These functions must complete synchronously so resume any yields and block
+  // on pending operations.
+  while (iree_status_is_ok(status) &&
+         result.state != IREE_VM_EXECUTION_STATE_COMPLETE) {
+    if (result.state == IREE_VM_EXECUTION_STATE_WAIT && result.wait_fn) {
+      status = result.wait_fn(result.wait_state, IREE_TIME_INFINITE_FUTURE);
+    }
+    if (iree_status_is_ok(status)) {
+      status = module->resume_call(module->self, stack, &call, &result);
+    }
+  }
 
   IREE_TRACE_ZONE_END(z0);
   return status;
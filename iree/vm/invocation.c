@@ -19,7 +19,7 @@
 
 // Marshals caller arguments from the variant list to the ABI convention.
 static iree_status_t iree_vm_invoke_marshal_inputs(
-    iree_string_view_t cconv_arguments, iree_vm_list_t* inputs,
+    iree_string_view_t cconv_arguments, const iree_vm_list_t* inputs,
     iree_byte_span_t arguments) {
   // We are 1:1 right now with no variadic args, so do a quick verification on
   // the input list.
@@ -55,6 +55,13 @@ static iree_status_t iree_vm_invoke_marshal_inputs(
         memcpy(p, &value.i64, sizeof(int64_t));
         p += sizeof(int64_t);
       } break;
+      case IREE_VM_CCONV_TYPE_FLOAT32: {
+        iree_vm_value_t value;
+        IREE_RETURN_IF_ERROR(iree_vm_list_get_value_as(
+            inputs, arg_i, IREE_VM_VALUE_TYPE_F32, &value));
+        memcpy(p, &value.f32, sizeof(float));
+        p += sizeof(float);
+      } break;
       case IREE_VM_CCONV_TYPE_REF: {
         // TODO(benvanik): see if we can't remove this retain by instead relying
         // on the caller still owning the list.
@@ -99,6 +106,11 @@ static iree_status_t iree_vm_invoke_marshal_outputs(
         IREE_RETURN_IF_ERROR(iree_vm_list_set_value(outputs, arg_i, &value));
         p += sizeof(int64_t);
       } break;
+      case IREE_VM_CCONV_TYPE_FLOAT32: {
+        iree_vm_value_t value = iree_vm_value_make_f32(*(float*)p);
+        IREE_RETURN_IF_ERROR(iree_vm_list_set_value(outputs, arg_i, &value));
+        p += sizeof(float);
+      } break;
       case IREE_VM_CCONV_TYPE_REF: {
         IREE_RETURN_IF_ERROR(
             iree_vm_list_set_ref_move(outputs, arg_i, (iree_vm_ref_t*)p));
@@ -109,11 +121,32 @@ static iree_status_t iree_vm_invoke_marshal_outputs(
   return iree_ok_status();
 }
 
-// TODO(benvanik): implement this as an iree_vm_invocation_t sequence.
+// Resumes the suspended execution of |call| on |stack|.
+// If the execution is waiting on a pending operation this first blocks until
+// it can make progress or |deadline| elapses.
+static iree_status_t iree_vm_invoke_resume(iree_vm_stack_t* stack,
+                                           const iree_vm_function_call_t* call,
+                                           iree_time_t deadline,
+                                           iree_vm_execution_result_t* result) {
+  if (result->state == IREE_VM_EXECUTION_STATE_WAIT && result->wait_fn) {
+    IREE_RETURN_IF_ERROR(result->wait_fn(result->wait_state, deadline));
+  }
+  iree_vm_module_t* module = call->function.module;
+  if (IREE_UNLIKELY(!module->resume_call)) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "module does not support resuming calls");
+  }
+  return module->resume_call(module->self, stack, call, result);
+}
+
+// Synchronously invokes |function| once for each of the |batch_size| input
+// lists in order on the same |stack|. The calling convention is processed and
+// the ABI buffers are sized once for the whole batch.
 static iree_status_t iree_vm_invoke_within(
     iree_vm_context_t* context, iree_vm_stack_t* stack,
     iree_vm_function_t function, const iree_vm_invocation_policy_t* policy,
-    iree_vm_list_t* inputs, iree_vm_list_t* outputs) {
+    iree_host_size_t batch_size, iree_vm_list_t* const* inputs,
+    iree_vm_list_t* const* outputs) {
   IREE_ASSERT_ARGUMENT(context);
   IREE_ASSERT_ARGUMENT(stack);
 
@@ -124,42 +157,51 @@ static iree_status_t iree_vm_invoke_within(
   IREE_RETURN_IF_ERROR(iree_vm_function_call_get_cconv_fragments(
       &signature, &cconv_arguments, &cconv_results));
 
-  // Marshal the input arguments into the VM ABI and preallocate the result
-  // buffer.
+  // Preallocate the argument and result buffers. They are reused by each
+  // invocation in the batch.
   // NOTE: today we don't support variadic arguments through this interface.
   iree_byte_span_t arguments = iree_make_byte_span(NULL, 0);
   IREE_RETURN_IF_ERROR(iree_vm_function_call_compute_cconv_fragment_size(
       cconv_arguments, /*segment_size_list=*/NULL, &arguments.data_length));
   arguments.data = iree_alloca(arguments.data_length);
-  memset(arguments.data, 0, arguments.data_length);
-  IREE_RETURN_IF_ERROR(
-      iree_vm_invoke_marshal_inputs(cconv_arguments, inputs, arguments));
-
-  // Allocate the result output that will be populated by the callee.
   iree_byte_span_t results = iree_make_byte_span(NULL, 0);
   IREE_RETURN_IF_ERROR(iree_vm_function_call_compute_cconv_fragment_size(
       cconv_results, /*segment_size_list=*/NULL, &results.data_length));
   results.data = iree_alloca(results.data_length);
-  memset(results.data, 0, results.data_length);
 
-  // Perform execution. Note that for synchronous execution we expect this to
-  // complete without yielding.
-  iree_vm_function_call_t call;
-  memset(&call, 0, sizeof(call));
-  call.function = function;
-  call.arguments = arguments;
-  call.results = results;
-  iree_vm_execution_result_t result;
-  iree_status_t status =
-      function.module->begin_call(function.module->self, stack, &call, &result);
-  if (!iree_status_is_ok(status)) {
-    iree_vm_function_call_release(&call, &signature);
-    return status;
-  }
+  for (iree_host_size_t i = 0; i < batch_size; ++i) {
+    // Marshal the input arguments into the VM ABI and clear the result buffer
+    // that will be populated by the callee.
+    memset(arguments.data, 0, arguments.data_length);
+    memset(results.data, 0, results.data_length);
+    IREE_RETURN_IF_ERROR(
+        iree_vm_invoke_marshal_inputs(cconv_arguments, inputs[i], arguments));
 
-  // Read back the outputs from the result buffer.
-  IREE_RETURN_IF_ERROR(
-      iree_vm_invoke_marshal_outputs(cconv_results, results, outputs));
+    // Perform execution. As this is a synchronous invocation we resume any
+    // yields immediately and block on any pending operations until the call
+    // completes.
+    iree_vm_function_call_t call;
+    memset(&call, 0, sizeof(call));
+    call.function = function;
+    call.arguments = arguments;
+    call.results = results;
+    iree_vm_execution_result_t result;
+    iree_status_t status = function.module->begin_call(function.module->self,
+                                                       stack, &call, &result);
+    while (iree_status_is_ok(status) &&
+           result.state != IREE_VM_EXECUTION_STATE_COMPLETE) {
+      status = iree_vm_invoke_resume(stack, &call, IREE_TIME_INFINITE_FUTURE,
+                                     &result);
+    }
+    if (!iree_status_is_ok(status)) {
+      iree_vm_function_call_release(&call, &signature);
+      return status;
+    }
+
+    // Read back the outputs from the result buffer.
+    IREE_RETURN_IF_ERROR(
+        iree_vm_invoke_marshal_outputs(cconv_results, results, outputs[i]));
+  }
 
   return iree_ok_status();
 }
@@ -173,10 +215,255 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invoke(
   // Allocate a VM stack on the host stack and initialize it.
   IREE_VM_INLINE_STACK_INITIALIZE(
       stack, iree_vm_context_state_resolver(context), allocator);
-  iree_status_t status =
-      iree_vm_invoke_within(context, stack, function, policy, inputs, outputs);
+  iree_status_t status = iree_vm_invoke_within(context, stack, function, policy,
+                                               1, &inputs, &outputs);
   iree_vm_stack_deinitialize(stack);
 
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invoke_batch(
+    iree_vm_context_t* context, iree_vm_function_t function,
+    const iree_vm_invocation_policy_t* policy, iree_host_size_t batch_size,
+    iree_vm_list_t* const* inputs, iree_vm_list_t* const* outputs,
+    iree_allocator_t allocator) {
+  IREE_ASSERT_ARGUMENT(!batch_size || inputs);
+  IREE_ASSERT_ARGUMENT(!batch_size || outputs);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, batch_size);
+
+  // A single VM stack is shared by all invocations in the batch.
+  IREE_VM_INLINE_STACK_INITIALIZE(
+      stack, iree_vm_context_state_resolver(context), allocator);
+  iree_status_t status = iree_vm_invoke_within(
+      context, stack, function, policy, batch_size, inputs, outputs);
+  iree_vm_stack_deinitialize(stack);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+//===----------------------------------------------------------------------===//
+// iree_vm_invocation_t
+//===----------------------------------------------------------------------===//
+
+struct iree_vm_invocation {
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t allocator;
+  iree_vm_context_t* context;
+
+  // Calling convention of the function results used to marshal the outputs.
+  iree_string_view_t cconv_results;
+
+  // Heap-allocated stack holding the suspended execution. NULL once the
+  // invocation has completed (successfully or otherwise) or been aborted.
+  iree_vm_stack_t* stack;
+
+  // Call used to begin and resume execution. The results buffer is allocated
+  // inline after the invocation struct.
+  iree_vm_function_call_t call;
+
+  // Execution result of the last begin or resume.
+  iree_vm_execution_result_t result;
+
+  // Final status once the stack has been released.
+  iree_status_t status;
+
+  // Outputs marshaled from the results buffer upon successful completion.
+  iree_vm_list_t* outputs;
+};
+
+// Updates the invocation after beginning or resuming execution with |status|.
+// Once the execution completes (or fails) the stack is released and - on
+// success - the outputs are marshaled out of the results buffer.
+static void iree_vm_invocation_update(iree_vm_invocation_t* invocation,
+                                      iree_status_t status) {
+  if (iree_status_is_ok(status) &&
+      invocation->result.state != IREE_VM_EXECUTION_STATE_COMPLETE) {
+    return;  // Still in-flight.
+  }
+
+  iree_vm_stack_free(invocation->stack);
+  invocation->stack = NULL;
+
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_list_create(/*element_type=*/NULL,
+                                 invocation->cconv_results.size,
+                                 invocation->allocator, &invocation->outputs);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_invoke_marshal_outputs(invocation->cconv_results,
+                                            invocation->call.results,
+                                            invocation->outputs);
+  }
+  invocation->status = status;
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invocation_create(
+    iree_vm_context_t* context, iree_vm_function_t function,
+    const iree_vm_invocation_policy_t* policy, const iree_vm_list_t* inputs,
+    iree_allocator_t allocator, iree_vm_invocation_t** out_invocation) {
+  IREE_ASSERT_ARGUMENT(context);
+  IREE_ASSERT_ARGUMENT(out_invocation);
+  *out_invocation = NULL;
+  if (IREE_UNLIKELY(policy)) {
+    // No scheduling policies (priority, deadlines, etc) are defined yet.
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "invocation policies are not yet supported");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_vm_function_signature_t signature =
+      iree_vm_function_signature(&function);
+  iree_string_view_t cconv_arguments = iree_string_view_empty();
+  iree_string_view_t cconv_results = iree_string_view_empty();
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_vm_function_call_get_cconv_fragments(
+              &signature, &cconv_arguments, &cconv_results));
+
+  // Arguments are consumed when the call begins and can live on the host
+  // stack while results must persist across resumes.
+  iree_byte_span_t arguments = iree_make_byte_span(NULL, 0);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_vm_function_call_compute_cconv_fragment_size(
+              cconv_arguments, /*segment_size_list=*/NULL,
+              &arguments.data_length));
+  iree_host_size_t results_size = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_vm_function_call_compute_cconv_fragment_size(
+              cconv_results, /*segment_size_list=*/NULL, &results_size));
+
+  iree_vm_invocation_t* invocation = NULL;
+  iree_host_size_t header_size =
+      iree_math_align(sizeof(iree_vm_invocation_t), 16);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(allocator, header_size + results_size,
+                                (void**)&invocation));
+  memset(invocation, 0, header_size + results_size);
+  iree_atomic_ref_count_init(&invocation->ref_count);
+  invocation->allocator = allocator;
+  invocation->context = context;
+  iree_vm_context_retain(context);
+  invocation->cconv_results = cconv_results;
+  invocation->call.function = function;
+  invocation->call.results =
+      iree_make_byte_span((uint8_t*)invocation + header_size, results_size);
+
+  iree_status_t status =
+      iree_vm_stack_allocate(iree_vm_context_state_resolver(context),
+                             allocator, &invocation->stack);
+  if (iree_status_is_ok(status)) {
+    arguments.data = iree_alloca(arguments.data_length);
+    memset(arguments.data, 0, arguments.data_length);
+    invocation->call.arguments = arguments;
+    status = iree_vm_invoke_marshal_inputs(cconv_arguments, inputs, arguments);
+  }
+  if (iree_status_is_ok(status)) {
+    status = function.module->begin_call(function.module->self,
+                                         invocation->stack, &invocation->call,
+                                         &invocation->result);
+    if (!iree_status_is_ok(status)) {
+      iree_vm_function_call_release(&invocation->call, &signature);
+    }
+    invocation->call.arguments = iree_make_byte_span(NULL, 0);
+    iree_vm_invocation_update(invocation, status);
+    status = iree_ok_status();
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_invocation = invocation;
+  } else {
+    iree_vm_invocation_release(invocation);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_vm_invocation_destroy(iree_vm_invocation_t* invocation) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  if (invocation->stack) {
+    iree_vm_stack_free(invocation->stack);
+  }
+  iree_status_ignore(invocation->status);
+  iree_vm_list_release(invocation->outputs);
+  iree_vm_context_release(invocation->context);
+  iree_allocator_free(invocation->allocator, invocation);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_invocation_retain(iree_vm_invocation_t* invocation) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  iree_atomic_ref_count_inc(&invocation->ref_count);
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_invocation_release(iree_vm_invocation_t* invocation) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  if (iree_atomic_ref_count_dec(&invocation->ref_count) == 1) {
+    iree_vm_invocation_destroy(invocation);
+  }
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_invocation_query_status(iree_vm_invocation_t* invocation) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  if (invocation->stack) {
+    return iree_status_from_code(IREE_STATUS_UNAVAILABLE);
+  }
+  return iree_status_clone(invocation->status);
+}
+
+IREE_API_EXPORT const iree_vm_list_t* IREE_API_CALL
+iree_vm_invocation_output(iree_vm_invocation_t* invocation) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  if (invocation->stack || !iree_status_is_ok(invocation->status)) {
+    return NULL;
+  }
+  return invocation->outputs;
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invocation_await(
+    iree_vm_invocation_t* invocation, iree_time_t deadline) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Each resume runs until the next suspension point, so an already-elapsed
+  // deadline still makes progress when possible. This lets hosts multiplex
+  // many invocations on one thread by awaiting with IREE_TIME_INFINITE_PAST.
+  while (invocation->stack) {
+    iree_status_t status =
+        iree_vm_invoke_resume(invocation->stack, &invocation->call, deadline,
+                              &invocation->result);
+    if (iree_status_is_deadline_exceeded(status) &&
+        invocation->result.state == IREE_VM_EXECUTION_STATE_WAIT) {
+      // Timed out in the wait; the invocation itself is still in-flight.
+      IREE_TRACE_ZONE_END(z0);
+      return status;
+    }
+    iree_vm_invocation_update(invocation, status);
+    if (invocation->stack && iree_time_now() >= deadline) {
+      IREE_TRACE_ZONE_END(z0);
+      return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_vm_invocation_query_status(invocation);
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_invocation_abort(iree_vm_invocation_t* invocation) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  if (!invocation->stack) return iree_ok_status();
+
+  // Unwinding the stack releases all refs held by the suspended frames.
+  iree_vm_stack_free(invocation->stack);
+  invocation->stack = NULL;
+  invocation->status = iree_make_status(IREE_STATUS_ABORTED,
+                                        "invocation aborted while in-flight");
+  return iree_ok_status();
+}
@@ -42,12 +42,49 @@ typedef struct iree_vm_invocation_policy iree_vm_invocation_policy_t;
 // |outputs| is populated after the function completes execution with the
 // output values and objects of the function. List ownership remains with the
 // caller.
+//
+// Any yields are resumed immediately and the calling thread blocks on pending
+// operations until the function completes.
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invoke(
     iree_vm_context_t* context, iree_vm_function_t function,
     const iree_vm_invocation_policy_t* policy, iree_vm_list_t* inputs,
     iree_vm_list_t* outputs, iree_allocator_t allocator);
 
-// TODO(benvanik): document and implement.
+// Synchronously invokes a function in the VM once for each of |batch_size|
+// input lists.
+//
+// This behaves as if iree_vm_invoke were called with |inputs|[i] and
+// |outputs|[i] for each i in order but amortizes the per-call setup: a single
+// VM stack is used for the whole batch and the function signature is only
+// processed once. Modules may additionally reuse per-context resources (such
+// as HAL submission semaphores) across the calls.
+//
+// Execution stops at the first failing invocation and its status is returned;
+// outputs of the invocations preceding it remain populated. List ownership
+// remains with the caller and |outputs| entries may be NULL for functions
+// without results.
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invoke_batch(
+    iree_vm_context_t* context, iree_vm_function_t function,
+    const iree_vm_invocation_policy_t* policy, iree_host_size_t batch_size,
+    iree_vm_list_t* const* inputs, iree_vm_list_t* const* outputs,
+    iree_allocator_t allocator);
+
+// Begins an asynchronous invocation of a function in the VM.
+//
+// Execution starts immediately on the calling thread and runs until the
+// function completes or suspends (by yielding or waiting on a pending
+// operation such as an import that would block). Suspended invocations own
+// their VM stack and can be continued with iree_vm_invocation_await from any
+// thread, though only one thread may operate on an invocation at a time.
+//
+// |inputs| is used to pass values and objects into the target function and must
+// match the signature defined by the compiled function. List ownership remains
+// with the caller.
+//
+// |policy| is reserved for scheduling policies and must be NULL.
+//
+// Returns an error only if the invocation could not be started; failures during
+// execution are reported by iree_vm_invocation_query_status.
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invocation_create(
     iree_vm_context_t* context, iree_vm_function_t function,
     const iree_vm_invocation_policy_t* policy, const iree_vm_list_t* inputs,
@@ -84,6 +121,8 @@ iree_vm_invocation_output(iree_vm_invocation_t* invocation);
 //
 // Returns IREE_STATUS_DEADLINE_EXCEEDED if |deadline| elapses before the
 // invocation completes and otherwise returns iree_vm_invocation_query_status.
+// The invocation is resumed at least once if it can make progress, so awaiting
+// with IREE_TIME_INFINITE_PAST performs a non-blocking step of execution.
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invocation_await(
     iree_vm_invocation_t* invocation, iree_time_t deadline);
 
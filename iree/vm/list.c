@@ -15,14 +15,17 @@
 #include "iree/vm/list.h"
 
 #include "iree/base/alignment.h"
+#include "iree/base/math.h"
+#include "iree/base/synchronization.h"
 
 // Size of each iree_vm_value_type_t in bytes.
-static const iree_host_size_t kValueTypeSizes[5] = {
+static const iree_host_size_t kValueTypeSizes[6] = {
     0,  // IREE_VM_VALUE_TYPE_NONE
     1,  // IREE_VM_VALUE_TYPE_I8
     2,  // IREE_VM_VALUE_TYPE_I16
     4,  // IREE_VM_VALUE_TYPE_I32
     8,  // IREE_VM_VALUE_TYPE_I64
+    4,  // IREE_VM_VALUE_TYPE_F32
 };
 static_assert(IREE_VM_VALUE_TYPE_COUNT ==
                   (sizeof(kValueTypeSizes) / sizeof(kValueTypeSizes[0])),
@@ -60,8 +63,26 @@ struct iree_vm_list {
   // For certain storage modes, such as IREE_VM_STORAGE_MODE_REF, special
   // lifetime management and cleanup logic is required.
   void* storage;
+
+  // Pool the list returns to when released, if acquired from one.
+  iree_vm_list_pool_t* pool;
+  // Next list in the pool free list while the list is released.
+  iree_vm_list_t* next_free;
+};
+
+struct iree_vm_list_pool {
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t allocator;
+
+  // Guards |free_head|.
+  iree_slim_mutex_t mutex;
+  // Singly-linked list of released lists available for reuse.
+  iree_vm_list_t* free_head;
 };
 
+static void iree_vm_list_pool_recycle(iree_vm_list_pool_t* pool,
+                                      iree_vm_list_t* list);
+
 static iree_vm_ref_type_descriptor_t iree_vm_list_descriptor = {0};
 
 IREE_VM_DEFINE_TYPE_ADAPTERS(iree_vm_list, iree_vm_list_t);
@@ -75,14 +96,14 @@ static void iree_vm_list_reset_range(iree_vm_list_t* list,
       break;
     case IREE_VM_LIST_STORAGE_MODE_REF: {
       iree_vm_ref_t* ref_storage = (iree_vm_ref_t*)list->storage;
-      for (iree_host_size_t i = offset; i < length; ++i) {
+      for (iree_host_size_t i = offset; i < offset + length; ++i) {
         iree_vm_ref_release(&ref_storage[i]);
       }
       break;
     }
     case IREE_VM_LIST_STORAGE_MODE_VARIANT: {
       iree_vm_variant_t* variant_storage = (iree_vm_variant_t*)list->storage;
-      for (iree_host_size_t i = offset; i < length; ++i) {
+      for (iree_host_size_t i = offset; i < offset + length; ++i) {
         if (iree_vm_type_def_is_ref(&variant_storage[i].type)) {
           iree_vm_ref_release(&variant_storage[i].ref);
         }
@@ -194,6 +215,10 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_list_create(
 static void iree_vm_list_destroy(void* ptr) {
   iree_vm_list_t* list = (iree_vm_list_t*)ptr;
   iree_vm_list_reset_range(list, 0, list->count);
+  if (list->pool) {
+    iree_vm_list_pool_recycle(list->pool, list);
+    return;
+  }
   iree_allocator_free(list->allocator, list->storage);
   iree_allocator_free(list->allocator, list);
 }
@@ -222,6 +247,13 @@ iree_vm_list_reserve(iree_vm_list_t* list, iree_host_size_t minimum_capacity) {
   if (list->capacity >= minimum_capacity) {
     return iree_ok_status();
   }
+  if (!list->allocator.alloc) {
+    // Statically initialized lists have no allocator to grow with.
+    return iree_make_status(
+        IREE_STATUS_RESOURCE_EXHAUSTED,
+        "fixed-capacity list cannot grow: capacity=%zu < required=%zu",
+        list->capacity, minimum_capacity);
+  }
   iree_host_size_t old_capacity = list->capacity;
   iree_host_size_t new_capacity = iree_align(minimum_capacity, 64);
   IREE_RETURN_IF_ERROR(iree_allocator_realloc(
@@ -242,9 +274,10 @@ iree_vm_list_resize(iree_vm_list_t* list, iree_host_size_t new_size) {
   if (new_size == list->count) {
     return iree_ok_status();
   } else if (new_size < list->count) {
-    // Truncating.
-    iree_vm_list_reset_range(list, new_size + 1, list->count - new_size);
-    list->count = new_size;
+    // Truncating. Slots are zeroed so that they can be reused as if new.
+    iree_vm_list_reset_range(list, new_size, list->count - new_size);
+    memset((void*)((uintptr_t)list->storage + new_size * list->element_size),
+           0, (list->count - new_size) * list->element_size);
   } else if (new_size > list->capacity) {
     // Extending beyond capacity.
     IREE_RETURN_IF_ERROR(iree_vm_list_reserve(list, new_size));
@@ -276,6 +309,9 @@ static void iree_vm_list_convert_value_type(
         case IREE_VM_VALUE_TYPE_I64:
           out_value->i64 = (int64_t)source_value->i8;
           return;
+        case IREE_VM_VALUE_TYPE_F32:
+          out_value->f32 = (float)source_value->i8;
+          return;
         default:
           return;
       }
@@ -290,6 +326,9 @@ static void iree_vm_list_convert_value_type(
         case IREE_VM_VALUE_TYPE_I64:
           out_value->i64 = (int64_t)source_value->i16;
           return;
+        case IREE_VM_VALUE_TYPE_F32:
+          out_value->f32 = (float)source_value->i16;
+          return;
         default:
           return;
       }
@@ -304,6 +343,9 @@ static void iree_vm_list_convert_value_type(
         case IREE_VM_VALUE_TYPE_I64:
           out_value->i64 = (int64_t)source_value->i32;
           return;
+        case IREE_VM_VALUE_TYPE_F32:
+          out_value->f32 = (float)source_value->i32;
+          return;
         default:
           return;
       }
@@ -318,6 +360,26 @@ static void iree_vm_list_convert_value_type(
         case IREE_VM_VALUE_TYPE_I32:
           out_value->i32 = (int32_t)source_value->i64;
           return;
+        case IREE_VM_VALUE_TYPE_F32:
+          out_value->f32 = (float)source_value->i64;
+          return;
+        default:
+          return;
+      }
+    case IREE_VM_VALUE_TYPE_F32:
+      switch (target_value_type) {
+        case IREE_VM_VALUE_TYPE_I8:
+          out_value->i8 = iree_math_f32_to_si8_sat(source_value->f32);
+          return;
+        case IREE_VM_VALUE_TYPE_I16:
+          out_value->i16 = iree_math_f32_to_si16_sat(source_value->f32);
+          return;
+        case IREE_VM_VALUE_TYPE_I32:
+          out_value->i32 = iree_math_f32_to_si32_sat(source_value->f32);
+          return;
+        case IREE_VM_VALUE_TYPE_I64:
+          out_value->i64 = iree_math_f32_to_si64_sat(source_value->f32);
+          return;
         default:
           return;
       }
@@ -645,6 +707,119 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_list_push_variant(
   return iree_vm_list_set_variant(list, i, value);
 }
 
+//===----------------------------------------------------------------------===//
+// iree_vm_list_pool_t
+//===----------------------------------------------------------------------===//
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_list_pool_create(
+    iree_allocator_t allocator, iree_vm_list_pool_t** out_pool) {
+  IREE_ASSERT_ARGUMENT(out_pool);
+  *out_pool = NULL;
+  iree_vm_list_pool_t* pool = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_allocator_malloc(allocator, sizeof(*pool), (void**)&pool));
+  memset(pool, 0, sizeof(*pool));
+  iree_atomic_ref_count_init(&pool->ref_count);
+  pool->allocator = allocator;
+  iree_slim_mutex_initialize(&pool->mutex);
+  *out_pool = pool;
+  return iree_ok_status();
+}
+
+static void iree_vm_list_pool_destroy(iree_vm_list_pool_t* pool) {
+  iree_vm_list_pool_trim(pool);
+  iree_slim_mutex_deinitialize(&pool->mutex);
+  iree_allocator_free(pool->allocator, pool);
+}
+
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_list_pool_retain(iree_vm_list_pool_t* pool) {
+  if (pool) {
+    iree_atomic_ref_count_inc(&pool->ref_count);
+  }
+}
+
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_list_pool_release(iree_vm_list_pool_t* pool) {
+  if (pool && iree_atomic_ref_count_dec(&pool->ref_count) == 1) {
+    iree_vm_list_pool_destroy(pool);
+  }
+}
+
+static bool iree_vm_list_pool_matches(const iree_vm_list_t* list,
+                                      const iree_vm_type_def_t* element_type,
+                                      iree_host_size_t capacity) {
+  if (list->capacity < capacity) return false;
+  if (!element_type) {
+    return list->storage_mode == IREE_VM_LIST_STORAGE_MODE_VARIANT;
+  }
+  return list->element_type.value_type == element_type->value_type &&
+         list->element_type.ref_type == element_type->ref_type;
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_list_pool_acquire(
+    iree_vm_list_pool_t* pool, const iree_vm_type_def_t* element_type,
+    iree_host_size_t capacity, iree_vm_list_t** out_list) {
+  IREE_ASSERT_ARGUMENT(pool);
+  IREE_ASSERT_ARGUMENT(out_list);
+  *out_list = NULL;
+
+  // Pools are expected to hold only a handful of lists (a few per in-flight
+  // invocation) so a linear scan is cheaper than anything fancier.
+  iree_vm_list_t* list = NULL;
+  iree_slim_mutex_lock(&pool->mutex);
+  iree_vm_list_t** prev_next = &pool->free_head;
+  for (iree_vm_list_t* it = pool->free_head; it; it = it->next_free) {
+    if (iree_vm_list_pool_matches(it, element_type, capacity)) {
+      *prev_next = it->next_free;
+      it->next_free = NULL;
+      list = it;
+      break;
+    }
+    prev_next = &it->next_free;
+  }
+  iree_slim_mutex_unlock(&pool->mutex);
+
+  if (list) {
+    iree_atomic_ref_count_init(&list->ref_object.counter);
+  } else {
+    IREE_RETURN_IF_ERROR(
+        iree_vm_list_create(element_type, capacity, pool->allocator, &list));
+    list->pool = pool;
+  }
+  iree_vm_list_pool_retain(pool);
+  *out_list = list;
+  return iree_ok_status();
+}
+
+// Returns a released |list| to the |pool| free list. The list contents must
+// have already been reset.
+static void iree_vm_list_pool_recycle(iree_vm_list_pool_t* pool,
+                                      iree_vm_list_t* list) {
+  memset(list->storage, 0, list->count * list->element_size);
+  list->count = 0;
+  iree_slim_mutex_lock(&pool->mutex);
+  list->next_free = pool->free_head;
+  pool->free_head = list;
+  iree_slim_mutex_unlock(&pool->mutex);
+  iree_vm_list_pool_release(pool);
+}
+
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_list_pool_trim(iree_vm_list_pool_t* pool) {
+  IREE_ASSERT_ARGUMENT(pool);
+  iree_slim_mutex_lock(&pool->mutex);
+  iree_vm_list_t* list = pool->free_head;
+  pool->free_head = NULL;
+  iree_slim_mutex_unlock(&pool->mutex);
+  while (list) {
+    iree_vm_list_t* next = list->next_free;
+    iree_allocator_free(list->allocator, list->storage);
+    iree_allocator_free(list->allocator, list);
+    list = next;
+  }
+}
+
 iree_status_t iree_vm_list_register_types() {
   iree_vm_list_descriptor.destroy = iree_vm_list_destroy;
   iree_vm_list_descriptor.offsetof_counter =
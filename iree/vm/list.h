@@ -53,7 +53,9 @@ IREE_API_EXPORT iree_host_size_t iree_vm_list_storage_size(
 //
 // Statically-allocated lists have their lifetime controlled by the caller and
 // must be deinitialized with iree_vm_list_deinitialize only when there are no
-// more users of the list.
+// more users of the list. The storage may come from the host stack, an arena,
+// or be embedded in another structure. These lists cannot grow beyond
+// |capacity| and attempts to do so fail with IREE_STATUS_RESOURCE_EXHAUSTED.
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_list_initialize(
     iree_byte_span_t storage, const iree_vm_type_def_t* element_type,
     iree_host_size_t capacity, iree_vm_list_t** out_list);
@@ -189,6 +191,48 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_list_set_variant(
 IREE_API_EXPORT iree_status_t IREE_API_CALL
 iree_vm_list_push_variant(iree_vm_list_t* list, const iree_vm_variant_t* value);
 
+//===----------------------------------------------------------------------===//
+// iree_vm_list_pool_t
+//===----------------------------------------------------------------------===//
+
+// A pool of lists that can be reused to avoid allocating argument and result
+// lists on each invocation. Lists acquired from the pool are normal ref-counted
+// lists that return to the pool (with their contents cleared) when their last
+// reference is released instead of being freed.
+//
+// Released lists are kept keyed by element type and capacity; acquiring a list
+// reuses any released list with the same element type and at least the
+// requested capacity. Lists retain the pool so it may be released while lists
+// acquired from it are still in use.
+//
+// Thread-safe.
+typedef struct iree_vm_list_pool iree_vm_list_pool_t;
+
+// Creates a list pool that allocates lists (and their storage) from
+// |allocator|.
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_list_pool_create(
+    iree_allocator_t allocator, iree_vm_list_pool_t** out_pool);
+
+// Retains the given |pool| for the caller.
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_list_pool_retain(iree_vm_list_pool_t* pool);
+
+// Releases the given |pool| from the caller.
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_list_pool_release(iree_vm_list_pool_t* pool);
+
+// Acquires an empty list with the given |element_type| (see
+// iree_vm_list_create) and at least |capacity| from the pool, allocating a new
+// one only if no released list matches. The list must be released with
+// iree_vm_list_release.
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_list_pool_acquire(
+    iree_vm_list_pool_t* pool, const iree_vm_type_def_t* element_type,
+    iree_host_size_t capacity, iree_vm_list_t** out_list);
+
+// Frees all released lists retained by the pool.
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_list_pool_trim(iree_vm_list_pool_t* pool);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
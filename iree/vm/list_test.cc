@@ -14,6 +14,8 @@
 
 #include "iree/vm/list.h"
 
+#include <cmath>
+
 #include "iree/base/api.h"
 #include "iree/base/ref_ptr.h"
 #include "iree/testing/gtest.h"
@@ -72,6 +74,12 @@ static iree_vm_ref_t MakeRef(V value) {
   return ref;
 }
 
+static int32_t ReadCounter(iree_vm_ref_t* ref) {
+  return iree_atomic_load_int32(
+      (iree_atomic_ref_count_t*)(((uintptr_t)ref->ptr) + ref->offsetof_counter),
+      iree_memory_order_seq_cst);
+}
+
 class VMListTest : public ::testing::Test {
  protected:
   static void SetUpTestSuite() {
@@ -117,6 +125,47 @@ TEST_F(VMListTest, UsageI32) {
   iree_vm_list_release(list);
 }
 
+// Tests that converting f32 elements to integers saturates out-of-range values
+// and maps NaN to 0 instead of invoking undefined behavior.
+TEST_F(VMListTest, ConvertF32Saturates) {
+  iree_vm_type_def_t element_type =
+      iree_vm_type_def_make_value_type(IREE_VM_VALUE_TYPE_F32);
+  iree_vm_list_t* list = nullptr;
+  IREE_ASSERT_OK(
+      iree_vm_list_create(&element_type, 6, iree_allocator_system(), &list));
+  const float kValues[] = {NAN, INFINITY, -INFINITY, 1e30f, -1e30f, -3.75f};
+  IREE_ASSERT_OK(iree_vm_list_resize(list, IREE_ARRAYSIZE(kValues)));
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(kValues); ++i) {
+    iree_vm_value_t value = iree_vm_value_make_f32(kValues[i]);
+    IREE_ASSERT_OK(iree_vm_list_set_value(list, i, &value));
+  }
+
+  const int8_t kExpectedI8[] = {0, INT8_MAX, INT8_MIN, INT8_MAX, INT8_MIN, -3};
+  const int16_t kExpectedI16[] = {0,         INT16_MAX, INT16_MIN,
+                                  INT16_MAX, INT16_MIN, -3};
+  const int32_t kExpectedI32[] = {0,         INT32_MAX, INT32_MIN,
+                                  INT32_MAX, INT32_MIN, -3};
+  const int64_t kExpectedI64[] = {0,         INT64_MAX, INT64_MIN,
+                                  INT64_MAX, INT64_MIN, -3};
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(kValues); ++i) {
+    iree_vm_value_t value;
+    IREE_ASSERT_OK(
+        iree_vm_list_get_value_as(list, i, IREE_VM_VALUE_TYPE_I8, &value));
+    EXPECT_EQ(kExpectedI8[i], value.i8) << "element " << i;
+    IREE_ASSERT_OK(
+        iree_vm_list_get_value_as(list, i, IREE_VM_VALUE_TYPE_I16, &value));
+    EXPECT_EQ(kExpectedI16[i], value.i16) << "element " << i;
+    IREE_ASSERT_OK(
+        iree_vm_list_get_value_as(list, i, IREE_VM_VALUE_TYPE_I32, &value));
+    EXPECT_EQ(kExpectedI32[i], value.i32) << "element " << i;
+    IREE_ASSERT_OK(
+        iree_vm_list_get_value_as(list, i, IREE_VM_VALUE_TYPE_I64, &value));
+    EXPECT_EQ(kExpectedI64[i], value.i64) << "element " << i;
+  }
+
+  iree_vm_list_release(list);
+}
+
 // Tests simple ref object list usage, mainly just for demonstration.
 // Stores ref object type A elements only, equivalent to `!vm.list<!vm.ref<A>>`.
 TEST_F(VMListTest, UsageRef) {
@@ -229,9 +278,69 @@ TEST_F(VMListTest, Reserve) {
   iree_vm_list_release(list);
 }
 
+// Tests lists initialized in caller-provided storage.
+TEST_F(VMListTest, InitializeFixedStorage) {
+  iree_vm_type_def_t element_type =
+      iree_vm_type_def_make_value_type(IREE_VM_VALUE_TYPE_I32);
+  iree_host_size_t capacity = 4;
+  alignas(8) uint8_t storage[256];
+  ASSERT_LE(iree_vm_list_storage_size(&element_type, capacity),
+            sizeof(storage));
+  iree_vm_list_t* list = nullptr;
+  IREE_ASSERT_OK(iree_vm_list_initialize(
+      iree_make_byte_span(storage, sizeof(storage)), &element_type, capacity,
+      &list));
+  EXPECT_EQ(capacity, iree_vm_list_capacity(list));
+
+  for (iree_host_size_t i = 0; i < capacity; ++i) {
+    iree_vm_value_t value = iree_vm_value_make_i32((int32_t)i);
+    IREE_ASSERT_OK(iree_vm_list_push_value(list, &value));
+  }
+
+  // Growing beyond the provided storage fails as there is no allocator.
+  iree_vm_value_t value = iree_vm_value_make_i32(4);
+  iree_status_t status = iree_vm_list_push_value(list, &value);
+  EXPECT_EQ(IREE_STATUS_RESOURCE_EXHAUSTED, iree_status_code(status));
+  iree_status_ignore(status);
+  EXPECT_EQ(capacity, iree_vm_list_size(list));
+
+  iree_vm_list_deinitialize(list);
+}
+
 // TODO(benvanik): test resize value.
 
-// TODO(benvanik): test resize ref.
+// Tests that truncating a ref list releases the dropped elements.
+TEST_F(VMListTest, ResizeRef) {
+  iree_vm_type_def_t element_type =
+      iree_vm_type_def_make_ref_type(test_a_type_id());
+  iree_vm_list_t* list = nullptr;
+  IREE_ASSERT_OK(
+      iree_vm_list_create(&element_type, 2, iree_allocator_system(), &list));
+
+  iree_vm_ref_t ref_a0 = MakeRef<A>(0.0f);
+  iree_vm_ref_t ref_a1 = MakeRef<A>(1.0f);
+  IREE_ASSERT_OK(iree_vm_list_push_ref_retain(list, &ref_a0));
+  IREE_ASSERT_OK(iree_vm_list_push_ref_retain(list, &ref_a1));
+  EXPECT_EQ(2, ReadCounter(&ref_a0));
+  EXPECT_EQ(2, ReadCounter(&ref_a1));
+
+  IREE_ASSERT_OK(iree_vm_list_resize(list, 1));
+  EXPECT_EQ(2, ReadCounter(&ref_a0));
+  EXPECT_EQ(1, ReadCounter(&ref_a1));
+
+  IREE_ASSERT_OK(iree_vm_list_resize(list, 0));
+  EXPECT_EQ(1, ReadCounter(&ref_a0));
+
+  // Regrowing yields null elements.
+  IREE_ASSERT_OK(iree_vm_list_resize(list, 2));
+  iree_vm_ref_t ref{0};
+  IREE_ASSERT_OK(iree_vm_list_get_ref_assign(list, 1, &ref));
+  EXPECT_TRUE(iree_vm_ref_is_null(&ref));
+
+  iree_vm_ref_release(&ref_a0);
+  iree_vm_ref_release(&ref_a1);
+  iree_vm_list_release(list);
+}
 
 // TODO(benvanik): test resize variant.
 
@@ -245,4 +354,89 @@ TEST_F(VMListTest, Reserve) {
 
 // TODO(benvanik): test ref variant get/set.
 
+// Tests that released lists are reused by the pool.
+TEST_F(VMListTest, PoolReuse) {
+  iree_vm_list_pool_t* pool = nullptr;
+  IREE_ASSERT_OK(iree_vm_list_pool_create(iree_allocator_system(), &pool));
+
+  iree_vm_type_def_t element_type = iree_vm_type_def_make_variant_type();
+  iree_vm_list_t* list0 = nullptr;
+  IREE_ASSERT_OK(iree_vm_list_pool_acquire(pool, &element_type, 4, &list0));
+  EXPECT_LE(4, iree_vm_list_capacity(list0));
+  iree_vm_value_t value = iree_vm_value_make_i32(1);
+  IREE_ASSERT_OK(iree_vm_list_push_value(list0, &value));
+  iree_vm_list_release(list0);
+
+  // The released list is returned empty.
+  iree_vm_list_t* list1 = nullptr;
+  IREE_ASSERT_OK(iree_vm_list_pool_acquire(pool, &element_type, 2, &list1));
+  EXPECT_EQ(list0, list1);
+  EXPECT_EQ(0, iree_vm_list_size(list1));
+
+  // A second outstanding list must be distinct.
+  iree_vm_list_t* list2 = nullptr;
+  IREE_ASSERT_OK(iree_vm_list_pool_acquire(pool, &element_type, 2, &list2));
+  EXPECT_NE(list1, list2);
+
+  // Lists keep the pool alive after the caller releases it.
+  iree_vm_list_pool_release(pool);
+  iree_vm_list_release(list1);
+  iree_vm_list_release(list2);
+}
+
+// Tests that pooled lists are keyed by element type and capacity.
+TEST_F(VMListTest, PoolKeying) {
+  iree_vm_list_pool_t* pool = nullptr;
+  IREE_ASSERT_OK(iree_vm_list_pool_create(iree_allocator_system(), &pool));
+
+  iree_vm_type_def_t i32_type =
+      iree_vm_type_def_make_value_type(IREE_VM_VALUE_TYPE_I32);
+  iree_vm_type_def_t ref_type =
+      iree_vm_type_def_make_ref_type(test_a_type_id());
+  iree_vm_list_t* list0 = nullptr;
+  IREE_ASSERT_OK(iree_vm_list_pool_acquire(pool, &i32_type, 4, &list0));
+  iree_host_size_t capacity = iree_vm_list_capacity(list0);
+  iree_vm_list_release(list0);
+
+  iree_vm_list_t* list1 = nullptr;
+  IREE_ASSERT_OK(iree_vm_list_pool_acquire(pool, &ref_type, 4, &list1));
+  EXPECT_NE(list0, list1);
+  iree_vm_type_def_t queried_element_type;
+  IREE_ASSERT_OK(iree_vm_list_element_type(list1, &queried_element_type));
+  EXPECT_TRUE(iree_vm_type_def_is_ref(&queried_element_type));
+
+  iree_vm_list_t* list2 = nullptr;
+  IREE_ASSERT_OK(
+      iree_vm_list_pool_acquire(pool, &i32_type, capacity + 1, &list2));
+  EXPECT_NE(list0, list2);
+
+  iree_vm_list_t* list3 = nullptr;
+  IREE_ASSERT_OK(iree_vm_list_pool_acquire(pool, &i32_type, capacity, &list3));
+  EXPECT_EQ(list0, list3);
+
+  iree_vm_list_release(list1);
+  iree_vm_list_release(list2);
+  iree_vm_list_release(list3);
+  iree_vm_list_pool_trim(pool);
+  iree_vm_list_pool_release(pool);
+}
+
+// Tests that returning a list to the pool releases its elements.
+TEST_F(VMListTest, PoolReleasesRefs) {
+  iree_vm_list_pool_t* pool = nullptr;
+  IREE_ASSERT_OK(iree_vm_list_pool_create(iree_allocator_system(), &pool));
+
+  iree_vm_type_def_t element_type = iree_vm_type_def_make_variant_type();
+  iree_vm_list_t* list = nullptr;
+  IREE_ASSERT_OK(iree_vm_list_pool_acquire(pool, &element_type, 1, &list));
+  iree_vm_ref_t ref_a = MakeRef<A>(1.0f);
+  IREE_ASSERT_OK(iree_vm_list_push_ref_retain(list, &ref_a));
+  EXPECT_EQ(2, ReadCounter(&ref_a));
+  iree_vm_list_release(list);
+  EXPECT_EQ(1, ReadCounter(&ref_a));
+
+  iree_vm_ref_release(&ref_a);
+  iree_vm_list_pool_release(pool);
+}
+
 }  // namespace
@@ -60,6 +60,9 @@ iree_vm_function_call_compute_cconv_fragment_size(
       case IREE_VM_CCONV_TYPE_INT32:
         required_size += sizeof(int32_t);
         break;
+      case IREE_VM_CCONV_TYPE_FLOAT32:
+        required_size += sizeof(float);
+        break;
       case IREE_VM_CCONV_TYPE_INT64:
         required_size += sizeof(int64_t);
         break;
@@ -83,6 +86,9 @@ iree_vm_function_call_compute_cconv_fragment_size(
             case IREE_VM_CCONV_TYPE_INT32:
               span_size += sizeof(int32_t);
               break;
+            case IREE_VM_CCONV_TYPE_FLOAT32:
+              span_size += sizeof(float);
+              break;
             case IREE_VM_CCONV_TYPE_INT64:
               span_size += sizeof(int64_t);
               break;
@@ -126,6 +132,9 @@ iree_vm_function_call_release(iree_vm_function_call_t* call,
       case IREE_VM_CCONV_TYPE_INT32:
         p += sizeof(int32_t);
         break;
+      case IREE_VM_CCONV_TYPE_FLOAT32:
+        p += sizeof(float);
+        break;
       case IREE_VM_CCONV_TYPE_INT64:
         p += sizeof(int64_t);
         break;
@@ -204,6 +204,7 @@ typedef struct {
 
 #define IREE_VM_CCONV_TYPE_INT32 'i'
 #define IREE_VM_CCONV_TYPE_INT64 'I'
+#define IREE_VM_CCONV_TYPE_FLOAT32 'f'
 #define IREE_VM_CCONV_TYPE_REF 'r'
 #define IREE_VM_CCONV_TYPE_SPAN_START '['
 #define IREE_VM_CCONV_TYPE_SPAN_END ']'
@@ -245,14 +246,38 @@ IREE_API_EXPORT void IREE_API_CALL
 iree_vm_function_call_release(iree_vm_function_call_t* call,
                               const iree_vm_function_signature_t* signature);
 
+// Describes the state of an execution after a begin_call or resume_call.
+enum iree_vm_execution_state_e {
+  // Execution completed and the call results have been populated.
+  IREE_VM_EXECUTION_STATE_COMPLETE = 0,
+  // Execution yielded (such as with vm.yield) and can be resumed immediately.
+  IREE_VM_EXECUTION_STATE_YIELD = 1,
+  // Execution is blocked on a pending operation (such as an import that would
+  // block) and should be resumed once the operation is likely to make progress.
+  IREE_VM_EXECUTION_STATE_WAIT = 2,
+};
+typedef uint32_t iree_vm_execution_state_t;
+
+// Blocks the caller until a pending operation is likely to make progress or
+// the |deadline| elapses. Returns IREE_STATUS_DEADLINE_EXCEEDED on timeout.
+typedef iree_status_t(IREE_API_PTR* iree_vm_execution_wait_fn_t)(
+    void* wait_state, iree_time_t deadline);
+
 // Results of an iree_vm_module_execute request.
 typedef struct {
-  // TODO(benvanik): yield information.
-  // Yield modes:
-  // - yield (yield instruction)
-  // - await (with 1+ wait handles)
-  // - break
-  int reserved;
+  // Whether the execution completed or must be resumed with resume_call.
+  // Suspended executions keep their stack frames on the iree_vm_stack_t and
+  // the same stack must be passed back when resuming.
+  iree_vm_execution_state_t state;
+
+  // Optional wait function populated when |state| is
+  // IREE_VM_EXECUTION_STATE_WAIT. Callers that have no other work to do can use
+  // it to block instead of polling with resume_call. |wait_state| is only valid
+  // until the execution is resumed.
+  iree_vm_execution_wait_fn_t wait_fn;
+  void* wait_state;
+
+  // Breaking into a debugger is not yet represented here.
 } iree_vm_execution_result_t;
 
 // Defines an interface that can be used to reflect and execute functions on a
@@ -316,8 +341,11 @@ typedef struct iree_vm_module {
       iree_vm_execution_result_t* out_result);
 
   // Resumes execution of a previously-yielded call.
+  // |call| must reference the same function passed to begin_call. Its arguments
+  // are ignored (they were consumed when the call began) and its results buffer
+  // will be populated once execution completes.
   iree_status_t(IREE_API_PTR* resume_call)(
-      void* self, iree_vm_stack_t* stack,
+      void* self, iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
       iree_vm_execution_result_t* out_result);
 
   // TODO(benvanik): move this/refactor.
@@ -15,7 +15,10 @@
 #ifndef IREE_VM_MODULE_ABI_PACKING_H_
 #define IREE_VM_MODULE_ABI_PACKING_H_
 
+#include <functional>
+#include <initializer_list>
 #include <memory>
+#include <new>
 #include <tuple>
 #include <utility>
 
@@ -32,6 +35,44 @@
 
 namespace iree {
 namespace vm {
+
+// Result of a native function that may need to wait on a pending operation
+// (such as a semaphore) before it can produce a value.
+//
+// Returning Waitable<T>::Wait instead of a value suspends the calling VM
+// execution with IREE_VM_EXECUTION_STATE_WAIT rather than blocking the thread.
+// When the execution is resumed the function is called again with the same
+// arguments, which are kept alive in the VM stack frame while suspended.
+//
+// The optional |wait_fn| is exposed to hosts as the execution wait function so
+// that those with nothing else to do can block until the function is likely to
+// make progress (or the deadline elapses) instead of polling. It is only called
+// while the execution is suspended and must return DEADLINE_EXCEEDED on
+// timeout.
+template <typename T>
+class Waitable {
+ public:
+  using WaitFn = std::function<Status(iree_time_t deadline)>;
+
+  Waitable(T value) : value_(std::move(value)) {}  // NOLINT
+
+  static Waitable Wait(WaitFn wait_fn) {
+    Waitable waitable;
+    waitable.wait_fn_ = std::move(wait_fn);
+    return waitable;
+  }
+
+  bool is_pending() const { return !value_.has_value(); }
+  T& value() { return *value_; }
+  WaitFn& wait_fn() { return wait_fn_; }
+
+ private:
+  Waitable() = default;
+
+  absl::optional<T> value_;
+  WaitFn wait_fn_;
+};
+
 namespace packing {
 
 namespace impl {
@@ -59,6 +100,20 @@ struct remove_cvref {
   typedef std::remove_cv_t<std::remove_reference_t<T>> type;
 };
 
+template <typename T>
+struct is_primitive_span : std::false_type {};
+template <typename U>
+struct is_primitive_span<absl::Span<U>>
+    : std::integral_constant<bool, std::is_arithmetic<U>::value ||
+                                       std::is_enum<U>::value> {};
+
+constexpr bool any_of(std::initializer_list<bool> values) {
+  for (bool value : values) {
+    if (value) return true;
+  }
+  return false;
+}
+
 }  // namespace impl
 
 template <typename T>
@@ -190,6 +245,10 @@ template <>
 struct cconv_map<uint64_t> {
   static constexpr const auto conv_chars = literal("I");
 };
+template <>
+struct cconv_map<float> {
+  static constexpr const auto conv_chars = literal("f");
+};
 
 template <>
 struct cconv_map<opaque_ref> {
@@ -597,6 +656,99 @@ struct DispatchFunctorVoid {
   }
 };
 
+// A DispatchFunctor specialization for methods returning Waitable results.
+// The unpacked arguments and the pending wait live in the storage of the native
+// VM stack frame entered for the call. Native frames are always at the top of
+// the stack while suspended and are never relocated.
+template <typename Owner, typename Results, typename... Params>
+struct DispatchFunctorWaitable {
+  using FnPtr = StatusOr<Waitable<Results>> (Owner::*)(Params...);
+  using ParamsTuple = std::tuple<typename impl::ParamUnpack<
+      typename std::remove_reference<Params>::type>::storage_type...>;
+
+  struct Frame {
+    ParamsTuple params;
+    typename Waitable<Results>::WaitFn wait_fn;
+  };
+
+  // Frame storage is not aligned so we pad and align within it.
+  static constexpr iree_host_size_t kFrameSize =
+      sizeof(Frame) + alignof(Frame) - 1;
+
+  static Status Call(void (Owner::*ptr)(), Owner* self, iree_vm_stack_t* stack,
+                     const iree_vm_function_call_t* call,
+                     iree_vm_execution_result_t* out_result) {
+    // Primitive spans alias the argument buffer which does not outlive
+    // begin_call and would dangle when the function is retried.
+    static_assert(!impl::any_of({impl::is_primitive_span<
+                      typename impl::remove_cvref<Params>::type>::value...}),
+                  "waitable functions cannot take primitive variadic "
+                  "arguments");
+    Frame* frame = new (GetFrameStorage(stack)) Frame();
+    IREE_ASSIGN_OR_RETURN(
+        frame->params,
+        impl::Unpacker::LoadSequence<Params...>(call->arguments));
+    return Poll(reinterpret_cast<FnPtr>(ptr), self, frame, call, out_result);
+  }
+
+  static Status Resume(void (Owner::*ptr)(), Owner* self,
+                       iree_vm_stack_t* stack,
+                       const iree_vm_function_call_t* call,
+                       iree_vm_execution_result_t* out_result) {
+    Frame* frame = reinterpret_cast<Frame*>(GetFrameStorage(stack));
+    return Poll(reinterpret_cast<FnPtr>(ptr), self, frame, call, out_result);
+  }
+
+  static void FrameCleanup(iree_vm_stack_frame_t* stack_frame) {
+    reinterpret_cast<Frame*>(GetFrameStorage(stack_frame))->~Frame();
+  }
+
+ private:
+  static void* GetFrameStorage(iree_vm_stack_frame_t* stack_frame) {
+    uintptr_t storage =
+        reinterpret_cast<uintptr_t>(iree_vm_stack_frame_storage(stack_frame));
+    return reinterpret_cast<void*>((storage + alignof(Frame) - 1) &
+                                   ~(uintptr_t)(alignof(Frame) - 1));
+  }
+  static void* GetFrameStorage(iree_vm_stack_t* stack) {
+    return GetFrameStorage(iree_vm_stack_current_frame(stack));
+  }
+
+  // Calls the target function and either marshals its results or suspends the
+  // execution if it has to wait.
+  static Status Poll(FnPtr ptr, Owner* self, Frame* frame,
+                     const iree_vm_function_call_t* call,
+                     iree_vm_execution_result_t* out_result) {
+    IREE_ASSIGN_OR_RETURN(
+        auto results, ApplyFn(ptr, self, frame->params,
+                              std::make_index_sequence<sizeof...(Params)>()));
+    if (results.is_pending()) {
+      frame->wait_fn = std::move(results.wait_fn());
+      out_result->state = IREE_VM_EXECUTION_STATE_WAIT;
+      out_result->wait_fn = frame->wait_fn ? Wait : nullptr;
+      out_result->wait_state = frame;
+      return OkStatus();
+    }
+    impl::result_ptr_t result_ptr = call->results.data;
+    impl::ResultPack<Results>::Store(result_ptr, std::move(results.value()));
+    out_result->state = IREE_VM_EXECUTION_STATE_COMPLETE;
+    return OkStatus();
+  }
+
+  static iree_status_t Wait(void* wait_state, iree_time_t deadline) {
+    return reinterpret_cast<Frame*>(wait_state)->wait_fn(deadline);
+  }
+
+  // Arguments are passed by lvalue so that they remain in the frame for
+  // retries; ref arguments taken by value receive a retained copy.
+  template <size_t... I>
+  static StatusOr<Waitable<Results>> ApplyFn(FnPtr ptr, Owner* self,
+                                             ParamsTuple& params,
+                                             std::index_sequence<I...>) {
+    return (self->*ptr)(std::get<I>(params)...);
+  }
+};
+
 }  // namespace packing
 
 template <typename Owner>
@@ -608,6 +760,16 @@ struct NativeFunction {
                        iree_vm_stack_t* stack,
                        const iree_vm_function_call_t* call,
                        iree_vm_execution_result_t* out_result);
+
+  // Optional resume support for functions that may suspend. The native stack
+  // frame entered for the call has |frame_size| bytes of storage, cleaned up
+  // with |frame_cleanup|, that is preserved until the call completes.
+  Status (*const resume)(void (Owner::*ptr)(), Owner* self,
+                         iree_vm_stack_t* stack,
+                         const iree_vm_function_call_t* call,
+                         iree_vm_execution_result_t* out_result);
+  iree_host_size_t frame_size;
+  iree_vm_stack_frame_cleanup_fn_t frame_cleanup;
 };
 
 template <typename Owner, typename Result, typename... Params>
@@ -620,6 +782,21 @@ constexpr NativeFunction<Owner> MakeNativeFunction(
           &dispatch_functor_t::Call};
 }
 
+template <typename Owner, typename Result, typename... Params>
+constexpr NativeFunction<Owner> MakeNativeFunction(
+    absl::string_view name,
+    StatusOr<Waitable<Result>> (Owner::*fn)(Params...)) {
+  using dispatch_functor_t =
+      packing::DispatchFunctorWaitable<Owner, Result, Params...>;
+  return {{name.data(), name.size()},
+          packing::cconv_storage<Result, Params...>::value(),
+          (void (Owner::*)())fn,
+          &dispatch_functor_t::Call,
+          &dispatch_functor_t::Resume,
+          dispatch_functor_t::kFrameSize,
+          &dispatch_functor_t::FrameCleanup};
+}
+
 template <typename Owner, typename... Params>
 constexpr NativeFunction<Owner> MakeNativeFunction(
     absl::string_view name, Status (Owner::*fn)(Params...)) {
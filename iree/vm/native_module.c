@@ -281,6 +281,7 @@ static iree_status_t IREE_API_PTR iree_vm_native_module_begin_call(
                             call->function.ordinal,
                             module->descriptor->export_count);
   }
+  memset(out_result, 0, sizeof(*out_result));
   if (module->user_interface.begin_call) {
     return module->user_interface.begin_call(module->user_interface.self, stack,
                                              call, out_result);
@@ -312,19 +313,32 @@ static iree_status_t IREE_API_PTR iree_vm_native_module_begin_call(
                                   (int)function_name.size, function_name.data);
   }
 
+  // Functions that cannot complete yet keep their frame on the stack until they
+  // are resumed via the user resume_call.
+  if (out_result->state != IREE_VM_EXECUTION_STATE_COMPLETE) {
+    return iree_ok_status();
+  }
   return iree_vm_stack_function_leave(stack);
 }
 
-static iree_status_t IREE_API_PTR
-iree_vm_native_module_resume_call(void* self, iree_vm_stack_t* stack,
-                                  iree_vm_execution_result_t* out_result) {
+static iree_status_t IREE_API_PTR iree_vm_native_module_resume_call(
+    void* self, iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
+    iree_vm_execution_result_t* out_result) {
   iree_vm_native_module_t* module = (iree_vm_native_module_t*)self;
-  if (module->user_interface.resume_call) {
-    return module->user_interface.resume_call(module->user_interface.self,
-                                              stack, out_result);
+  if (!module->user_interface.resume_call) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "native module does not support resume");
   }
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                          "native module does not support resume");
+  IREE_RETURN_IF_ERROR(module->user_interface.resume_call(
+      module->user_interface.self, stack, call, out_result));
+
+  // Leave the frame entered by begin_call once the function has completed.
+  // Modules with a custom begin_call manage their own frames.
+  if (out_result->state != IREE_VM_EXECUTION_STATE_COMPLETE ||
+      module->user_interface.begin_call) {
+    return iree_ok_status();
+  }
+  return iree_vm_stack_function_leave(stack);
 }
 
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_native_module_create(
@@ -15,6 +15,10 @@
 #include "benchmark/benchmark.h"
 #include "iree/base/api.h"
 #include "iree/base/logging.h"
+#include "iree/vm/context.h"
+#include "iree/vm/instance.h"
+#include "iree/vm/invocation.h"
+#include "iree/vm/list.h"
 #include "iree/vm/module.h"
 #include "iree/vm/native_module.h"
 #include "iree/vm/native_module_test.h"
@@ -22,6 +26,149 @@
 
 namespace {
 
-// TODO(benvanik): native module benchmarks.
+// Allocator that forwards to the system allocator and counts allocations.
+// Used to verify that the steady-state invocation path does not allocate.
+struct CountingAllocator {
+  int64_t allocation_count = 0;
+
+  static iree_status_t IREE_API_PTR Allocate(void* self,
+                                             iree_allocation_mode_t mode,
+                                             iree_host_size_t byte_length,
+                                             void** out_ptr) {
+    ++reinterpret_cast<CountingAllocator*>(self)->allocation_count;
+    return iree_allocator_system_allocate(NULL, mode, byte_length, out_ptr);
+  }
+
+  static void IREE_API_PTR Free(void* self, void* ptr) {
+    iree_allocator_system_free(NULL, ptr);
+  }
+
+  iree_allocator_t allocator() {
+    iree_allocator_t v = {this, Allocate, Free};
+    return v;
+  }
+};
+
+// Creates a context with module_a and module_b from native_module_test.h and
+// resolves the module_b.entry function.
+static void CreateContext(iree_allocator_t allocator,
+                          iree_vm_instance_t** out_instance,
+                          iree_vm_context_t** out_context,
+                          iree_vm_function_t* out_function) {
+  IREE_CHECK_OK(iree_vm_instance_create(allocator, out_instance));
+  iree_vm_module_t* module_a = nullptr;
+  IREE_CHECK_OK(module_a_create(allocator, &module_a));
+  iree_vm_module_t* module_b = nullptr;
+  IREE_CHECK_OK(module_b_create(allocator, &module_b));
+  iree_vm_module_t* modules[2] = {module_a, module_b};
+  IREE_CHECK_OK(iree_vm_context_create_with_modules(
+      *out_instance, modules, IREE_ARRAYSIZE(modules), allocator,
+      out_context));
+  iree_vm_module_release(module_a);
+  iree_vm_module_release(module_b);
+  IREE_CHECK_OK(iree_vm_context_resolve_function(
+      *out_context, iree_make_cstring_view("module_b.entry"), out_function));
+}
+
+// Reports allocations made per iteration and fails the benchmark if the
+// steady-state invocation allocated at all.
+static void ReportAllocations(benchmark::State& state,
+                              const CountingAllocator& counting_allocator,
+                              int64_t allocations_before) {
+  int64_t allocations =
+      counting_allocator.allocation_count - allocations_before;
+  state.counters["allocs_per_iter"] = benchmark::Counter(
+      static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+  if (allocations > 0) {
+    state.SkipWithError("steady-state invocation allocated");
+  }
+}
+
+// Invokes module_b.entry with argument and result lists acquired from a list
+// pool on each iteration, as hosting layers that don't own the lists do.
+static void BM_InvokePooledLists(benchmark::State& state) {
+  CountingAllocator counting_allocator;
+  iree_allocator_t allocator = counting_allocator.allocator();
+  iree_vm_instance_t* instance = nullptr;
+  iree_vm_context_t* context = nullptr;
+  iree_vm_function_t function;
+  CreateContext(allocator, &instance, &context, &function);
+  iree_vm_list_pool_t* list_pool = nullptr;
+  IREE_CHECK_OK(iree_vm_list_pool_create(allocator, &list_pool));
+
+  auto invoke = [&]() {
+    iree_vm_list_t* inputs = nullptr;
+    IREE_CHECK_OK(iree_vm_list_pool_acquire(list_pool, /*element_type=*/NULL,
+                                            1, &inputs));
+    iree_vm_value_t arg0 = iree_vm_value_make_i32(1);
+    IREE_CHECK_OK(iree_vm_list_push_value(inputs, &arg0));
+    iree_vm_list_t* outputs = nullptr;
+    IREE_CHECK_OK(iree_vm_list_pool_acquire(list_pool, /*element_type=*/NULL,
+                                            1, &outputs));
+    IREE_CHECK_OK(iree_vm_invoke(context, function, /*policy=*/nullptr,
+                                 inputs, outputs, allocator));
+    iree_vm_value_t ret0;
+    IREE_CHECK_OK(iree_vm_list_get_value(outputs, 0, &ret0));
+    benchmark::DoNotOptimize(ret0);
+    iree_vm_list_release(inputs);
+    iree_vm_list_release(outputs);
+  };
+
+  // Warm up the pool so that only steady-state behavior is measured.
+  invoke();
+  int64_t allocations_before = counting_allocator.allocation_count;
+  for (auto _ : state) {
+    invoke();
+  }
+  ReportAllocations(state, counting_allocator, allocations_before);
+
+  iree_vm_list_pool_release(list_pool);
+  iree_vm_context_release(context);
+  iree_vm_instance_release(instance);
+}
+BENCHMARK(BM_InvokePooledLists);
+
+// Invokes module_b.entry with argument and result lists initialized in stack
+// storage. This is the lowest-overhead path for callers that know their
+// signature ahead of time.
+static void BM_InvokeInlineLists(benchmark::State& state) {
+  CountingAllocator counting_allocator;
+  iree_allocator_t allocator = counting_allocator.allocator();
+  iree_vm_instance_t* instance = nullptr;
+  iree_vm_context_t* context = nullptr;
+  iree_vm_function_t function;
+  CreateContext(allocator, &instance, &context, &function);
+
+  alignas(16) uint8_t input_storage[128];
+  alignas(16) uint8_t output_storage[128];
+  IREE_CHECK_LE(iree_vm_list_storage_size(/*element_type=*/NULL, 1),
+                sizeof(input_storage));
+
+  int64_t allocations_before = counting_allocator.allocation_count;
+  for (auto _ : state) {
+    iree_vm_list_t* inputs = nullptr;
+    IREE_CHECK_OK(iree_vm_list_initialize(
+        iree_make_byte_span(input_storage, sizeof(input_storage)),
+        /*element_type=*/NULL, 1, &inputs));
+    iree_vm_value_t arg0 = iree_vm_value_make_i32(1);
+    IREE_CHECK_OK(iree_vm_list_push_value(inputs, &arg0));
+    iree_vm_list_t* outputs = nullptr;
+    IREE_CHECK_OK(iree_vm_list_initialize(
+        iree_make_byte_span(output_storage, sizeof(output_storage)),
+        /*element_type=*/NULL, 1, &outputs));
+    IREE_CHECK_OK(iree_vm_invoke(context, function, /*policy=*/nullptr,
+                                 inputs, outputs, allocator));
+    iree_vm_value_t ret0;
+    IREE_CHECK_OK(iree_vm_list_get_value(outputs, 0, &ret0));
+    benchmark::DoNotOptimize(ret0);
+    iree_vm_list_deinitialize(inputs);
+    iree_vm_list_deinitialize(outputs);
+  }
+  ReportAllocations(state, counting_allocator, allocations_before);
+
+  iree_vm_context_release(context);
+  iree_vm_instance_release(instance);
+}
+BENCHMARK(BM_InvokeInlineLists);
 
 }  // namespace
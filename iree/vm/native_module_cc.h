@@ -88,6 +88,7 @@ class NativeModule {
     interface_.free_state = NativeModule::ModuleFreeState;
     interface_.resolve_import = NativeModule::ModuleResolveImport;
     interface_.begin_call = NativeModule::ModuleBeginCall;
+    interface_.resume_call = NativeModule::ModuleResumeCall;
   }
 
   virtual ~NativeModule() = default;
@@ -225,22 +226,65 @@ class NativeModule {
     }
     const auto& info = module->dispatch_table_[call->function.ordinal];
 
-    // NOTE: VM stack is currently unused. We could stash things here for the
-    // debugger or use it for coroutine state.
-    iree_host_size_t frame_size = 0;
-
+    // Functions that may suspend keep their arguments in the frame storage so
+    // that they can be retried when resumed.
     iree_vm_stack_frame_t* callee_frame = NULL;
     IREE_RETURN_IF_ERROR(iree_vm_stack_function_enter(
-        stack, &call->function, IREE_VM_STACK_FRAME_NATIVE, frame_size,
-        /*frame_cleanup_fn=*/nullptr, &callee_frame));
+        stack, &call->function, IREE_VM_STACK_FRAME_NATIVE, info.frame_size,
+        info.frame_cleanup, &callee_frame));
 
     auto* state = FromStatePointer(callee_frame->module_state);
-    IREE_RETURN_IF_ERROR(info.call(info.ptr, state, stack, call, out_result),
-                         "while invoking C++ function %s.%.*s", module->name_,
-                         (int)info.name.size, info.name.data);
+    return ModuleEndCall(module, info, stack,
+                         info.call(info.ptr, state, stack, call, out_result),
+                         out_result);
+  }
 
-    return iree_vm_stack_function_leave(stack);
-    ;
+  static iree_status_t ModuleResumeCall(
+      void* self, iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
+      iree_vm_execution_result_t* out_result) {
+    IREE_ASSERT_ARGUMENT(out_result);
+    std::memset(out_result, 0, sizeof(*out_result));
+    auto* module = FromModulePointer(self);
+    iree_vm_stack_frame_t* callee_frame = iree_vm_stack_current_frame(stack);
+    if (IREE_UNLIKELY(!callee_frame ||
+                      callee_frame->function.module != module->interface() ||
+                      callee_frame->function.ordinal >=
+                          module->dispatch_table_.size())) {
+      return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                              "no suspended call of module %s to resume",
+                              module->name_);
+    }
+    const auto& info = module->dispatch_table_[callee_frame->function.ordinal];
+    if (IREE_UNLIKELY(!info.resume)) {
+      return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                              "C++ function %s.%.*s cannot be resumed",
+                              module->name_, (int)info.name.size,
+                              info.name.data);
+    }
+
+    auto* state = FromStatePointer(callee_frame->module_state);
+    return ModuleEndCall(module, info, stack,
+                         info.resume(info.ptr, state, stack, call, out_result),
+                         out_result);
+  }
+
+  // Leaves the frame of a call to |info| unless it is suspended.
+  static iree_status_t ModuleEndCall(NativeModule* module,
+                                     const NativeFunction<State>& info,
+                                     iree_vm_stack_t* stack, Status status,
+                                     iree_vm_execution_result_t* out_result) {
+    if (status.ok() &&
+        out_result->state != IREE_VM_EXECUTION_STATE_COMPLETE) {
+      return iree_ok_status();
+    }
+    iree_status_t leave_status = iree_vm_stack_function_leave(stack);
+    if (!status.ok()) {
+      iree_status_ignore(leave_status);
+      IREE_RETURN_IF_ERROR(std::move(status),
+                           "while invoking C++ function %s.%.*s",
+                           module->name_, (int)info.name.size, info.name.data);
+    }
+    return leave_status;
   }
 
   const char* name_;
@@ -21,11 +21,14 @@
 #include "iree/vm/instance.h"
 #include "iree/vm/invocation.h"
 #include "iree/vm/list.h"
+#include "iree/vm/native_module_cc.h"
 #include "iree/vm/ref_cc.h"
 
 namespace iree {
 namespace {
 
+using ::iree::testing::status::StatusIs;
+
 // Test suite that uses module_a and module_b defined in native_module_test.h.
 // Both modules are put in a context and the module_b.entry function can be
 // executed with RunFunction.
@@ -94,7 +97,7 @@ class VMNativeModuleTest : public ::testing::Test {
     return ret0_value.i32;
   }
 
- private:
+ protected:
   iree_vm_instance_t* instance_ = nullptr;
   iree_vm_context_t* context_ = nullptr;
 };
@@ -111,5 +114,323 @@ TEST_F(VMNativeModuleTest, Example) {
   ASSERT_EQ(v2, 8);
 }
 
+TEST_F(VMNativeModuleTest, InvokeBatch) {
+  iree_vm_function_t function;
+  IREE_ASSERT_OK(iree_vm_context_resolve_function(
+      context_, iree_make_cstring_view("module_b.entry"), &function));
+
+  constexpr int kBatchSize = 3;
+  vm::ref<iree_vm_list_t> input_lists[kBatchSize];
+  vm::ref<iree_vm_list_t> output_lists[kBatchSize];
+  iree_vm_list_t* inputs[kBatchSize];
+  iree_vm_list_t* outputs[kBatchSize];
+  for (int i = 0; i < kBatchSize; ++i) {
+    IREE_ASSERT_OK(iree_vm_list_create(/*element_type=*/nullptr, 1,
+                                       iree_allocator_system(),
+                                       &input_lists[i]));
+    auto arg0_value = iree_vm_value_make_i32(i + 1);
+    IREE_ASSERT_OK(iree_vm_list_push_value(input_lists[i].get(), &arg0_value));
+    IREE_ASSERT_OK(iree_vm_list_create(/*element_type=*/nullptr, 1,
+                                       iree_allocator_system(),
+                                       &output_lists[i]));
+    inputs[i] = input_lists[i].get();
+    outputs[i] = output_lists[i].get();
+  }
+
+  // Results must match those of individual invocations (see Example).
+  IREE_ASSERT_OK(iree_vm_invoke_batch(context_, function, /*policy=*/nullptr,
+                                      kBatchSize, inputs, outputs,
+                                      iree_allocator_system()));
+  const int32_t expected[kBatchSize] = {1, 4, 8};
+  for (int i = 0; i < kBatchSize; ++i) {
+    iree_vm_value_t ret0_value;
+    IREE_ASSERT_OK(iree_vm_list_get_value(outputs[i], 0, &ret0_value));
+    EXPECT_EQ(expected[i], ret0_value.i32);
+  }
+}
+
+// Test suite that uses module_c defined in native_module_test.h to exercise
+// suspending and resuming invocations.
+class VMNativeModuleAsyncTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    IREE_CHECK_OK(iree_vm_instance_create(iree_allocator_system(), &instance_));
+    iree_vm_module_t* module_c = nullptr;
+    IREE_CHECK_OK(module_c_create(iree_allocator_system(), &module_c));
+    IREE_CHECK_OK(iree_vm_context_create_with_modules(
+        instance_, &module_c, 1, iree_allocator_system(), &context_));
+    iree_vm_module_release(module_c);
+    IREE_CHECK_OK(iree_vm_context_resolve_function(
+        context_, iree_make_cstring_view("module_c.wait_n"), &function_));
+  }
+
+  virtual void TearDown() {
+    iree_vm_context_release(context_);
+    iree_vm_instance_release(instance_);
+  }
+
+  vm::ref<iree_vm_list_t> MakeInputs(int32_t arg0) {
+    vm::ref<iree_vm_list_t> input_list;
+    IREE_CHECK_OK(iree_vm_list_create(
+        /*element_type=*/nullptr, 1, iree_allocator_system(), &input_list));
+    auto arg0_value = iree_vm_value_make_i32(arg0);
+    IREE_CHECK_OK(iree_vm_list_push_value(input_list.get(), &arg0_value));
+    return input_list;
+  }
+
+  iree_vm_instance_t* instance_ = nullptr;
+  iree_vm_context_t* context_ = nullptr;
+  iree_vm_function_t function_;
+};
+
+TEST_F(VMNativeModuleAsyncTest, InvokeBlocksUntilComplete) {
+  auto input_list = MakeInputs(3);
+  vm::ref<iree_vm_list_t> output_list;
+  IREE_ASSERT_OK(iree_vm_list_create(/*element_type=*/nullptr, 1,
+                                     iree_allocator_system(), &output_list));
+  IREE_ASSERT_OK(iree_vm_invoke(context_, function_, /*policy=*/nullptr,
+                                input_list.get(), output_list.get(),
+                                iree_allocator_system()));
+  iree_vm_value_t ret0_value;
+  IREE_ASSERT_OK(iree_vm_list_get_value(output_list.get(), 0, &ret0_value));
+  EXPECT_EQ(3, ret0_value.i32);
+}
+
+TEST_F(VMNativeModuleAsyncTest, InvocationSteps) {
+  auto input_list = MakeInputs(2);
+  iree_vm_invocation_t* invocation = nullptr;
+  IREE_ASSERT_OK(iree_vm_invocation_create(context_, function_,
+                                           /*policy=*/nullptr, input_list.get(),
+                                           iree_allocator_system(),
+                                           &invocation));
+  EXPECT_THAT(Status(iree_vm_invocation_query_status(invocation)),
+              StatusIs(StatusCode::kUnavailable));
+  EXPECT_EQ(nullptr, iree_vm_invocation_output(invocation));
+
+  // Each non-blocking await performs a single resume.
+  EXPECT_THAT(Status(iree_vm_invocation_await(invocation,
+                                              IREE_TIME_INFINITE_PAST)),
+              StatusIs(StatusCode::kDeadlineExceeded));
+  EXPECT_THAT(Status(iree_vm_invocation_query_status(invocation)),
+              StatusIs(StatusCode::kUnavailable));
+  IREE_ASSERT_OK(iree_vm_invocation_await(invocation, IREE_TIME_INFINITE_PAST));
+  IREE_EXPECT_OK(iree_vm_invocation_query_status(invocation));
+
+  const iree_vm_list_t* output_list = iree_vm_invocation_output(invocation);
+  ASSERT_NE(nullptr, output_list);
+  iree_vm_value_t ret0_value;
+  IREE_ASSERT_OK(iree_vm_list_get_value(output_list, 0, &ret0_value));
+  EXPECT_EQ(2, ret0_value.i32);
+  IREE_ASSERT_OK(iree_vm_invocation_release(invocation));
+}
+
+TEST_F(VMNativeModuleAsyncTest, InvocationCompletesImmediately) {
+  auto input_list = MakeInputs(0);
+  iree_vm_invocation_t* invocation = nullptr;
+  IREE_ASSERT_OK(iree_vm_invocation_create(context_, function_,
+                                           /*policy=*/nullptr, input_list.get(),
+                                           iree_allocator_system(),
+                                           &invocation));
+  IREE_EXPECT_OK(iree_vm_invocation_query_status(invocation));
+  IREE_EXPECT_OK(iree_vm_invocation_await(invocation, IREE_TIME_INFINITE_PAST));
+  ASSERT_NE(nullptr, iree_vm_invocation_output(invocation));
+  IREE_ASSERT_OK(iree_vm_invocation_release(invocation));
+}
+
+TEST_F(VMNativeModuleAsyncTest, InvocationAbort) {
+  auto input_list = MakeInputs(5);
+  iree_vm_invocation_t* invocation = nullptr;
+  IREE_ASSERT_OK(iree_vm_invocation_create(context_, function_,
+                                           /*policy=*/nullptr, input_list.get(),
+                                           iree_allocator_system(),
+                                           &invocation));
+  IREE_ASSERT_OK(iree_vm_invocation_abort(invocation));
+  EXPECT_THAT(Status(iree_vm_invocation_query_status(invocation)),
+              StatusIs(StatusCode::kAborted));
+  EXPECT_THAT(Status(iree_vm_invocation_await(invocation,
+                                              IREE_TIME_INFINITE_FUTURE)),
+              StatusIs(StatusCode::kAborted));
+  EXPECT_EQ(nullptr, iree_vm_invocation_output(invocation));
+  IREE_ASSERT_OK(iree_vm_invocation_release(invocation));
+}
+
+TEST_F(VMNativeModuleAsyncTest, InvocationRejectsPolicy) {
+  auto input_list = MakeInputs(0);
+  int policy_storage = 0;
+  const auto* policy =
+      reinterpret_cast<const iree_vm_invocation_policy_t*>(&policy_storage);
+  iree_vm_invocation_t* invocation = nullptr;
+  EXPECT_THAT(Status(iree_vm_invocation_create(context_, function_, policy,
+                                               input_list.get(),
+                                               iree_allocator_system(),
+                                               &invocation)),
+              StatusIs(StatusCode::kUnimplemented));
+  EXPECT_EQ(nullptr, invocation);
+}
+
+// Counter shared between a test and a TimelineModule standing in for a device
+// semaphore that waitable calls wait on.
+struct TestTimeline {
+  int32_t value = 0;
+  int wait_count = 0;
+};
+
+// Per-context state of a C++ module with a waitable function.
+class TimelineModuleState final {
+ public:
+  explicit TimelineModuleState(TestTimeline* timeline) : timeline_(timeline) {}
+
+  // Returns the size of |list| once the timeline reaches |min_value|. Blocking
+  // waits advance the timeline as a device completing work would.
+  StatusOr<vm::Waitable<int32_t>> AwaitListSize(
+      const vm::ref<iree_vm_list_t>& list, int32_t min_value) {
+    if (timeline_->value >= min_value) {
+      return vm::Waitable<int32_t>(
+          static_cast<int32_t>(iree_vm_list_size(list.get())));
+    }
+    TestTimeline* timeline = timeline_;
+    return vm::Waitable<int32_t>::Wait(
+        [timeline, min_value](iree_time_t deadline) -> Status {
+          ++timeline->wait_count;
+          if (deadline == IREE_TIME_INFINITE_FUTURE) {
+            timeline->value = min_value;
+          }
+          if (timeline->value < min_value) {
+            return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+          }
+          return OkStatus();
+        });
+  }
+
+ private:
+  TestTimeline* timeline_;
+};
+
+static const vm::NativeFunction<TimelineModuleState>
+    kTimelineModuleFunctions[] = {
+        vm::MakeNativeFunction("await_list_size",
+                               &TimelineModuleState::AwaitListSize),
+};
+
+class TimelineModule final : public vm::NativeModule<TimelineModuleState> {
+ public:
+  TimelineModule(TestTimeline* timeline, iree_allocator_t allocator)
+      : vm::NativeModule<TimelineModuleState>(
+            "timeline", allocator,
+            absl::MakeConstSpan(kTimelineModuleFunctions)),
+        timeline_(timeline) {}
+
+ protected:
+  StatusOr<std::unique_ptr<TimelineModuleState>> CreateState(
+      iree_allocator_t allocator) override {
+    return std::make_unique<TimelineModuleState>(timeline_);
+  }
+
+ private:
+  TestTimeline* timeline_;
+};
+
+// Test suite that exercises C++ native functions returning vm::Waitable.
+class VMNativeModuleWaitableTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    IREE_CHECK_OK(iree_vm_instance_create(iree_allocator_system(), &instance_));
+    iree_vm_module_t* module =
+        std::make_unique<TimelineModule>(&timeline_, iree_allocator_system())
+            .release()
+            ->interface();
+    IREE_CHECK_OK(iree_vm_context_create_with_modules(
+        instance_, &module, 1, iree_allocator_system(), &context_));
+    iree_vm_module_release(module);
+    IREE_CHECK_OK(iree_vm_context_resolve_function(
+        context_, iree_make_cstring_view("timeline.await_list_size"),
+        &function_));
+  }
+
+  virtual void TearDown() {
+    iree_vm_context_release(context_);
+    iree_vm_instance_release(instance_);
+  }
+
+  // Returns inputs passing a list of |list_size| elements and |min_value|.
+  vm::ref<iree_vm_list_t> MakeInputs(iree_host_size_t list_size,
+                                     int32_t min_value) {
+    vm::ref<iree_vm_list_t> list;
+    IREE_CHECK_OK(iree_vm_list_create(/*element_type=*/nullptr, list_size,
+                                      iree_allocator_system(), &list));
+    IREE_CHECK_OK(iree_vm_list_resize(list.get(), list_size));
+    vm::ref<iree_vm_list_t> input_list;
+    IREE_CHECK_OK(iree_vm_list_create(
+        /*element_type=*/nullptr, 2, iree_allocator_system(), &input_list));
+    iree_vm_ref_t list_ref = iree_vm_list_retain_ref(list.get());
+    IREE_CHECK_OK(iree_vm_list_push_ref_move(input_list.get(), &list_ref));
+    auto min_value_value = iree_vm_value_make_i32(min_value);
+    IREE_CHECK_OK(iree_vm_list_push_value(input_list.get(), &min_value_value));
+    return input_list;
+  }
+
+  TestTimeline timeline_;
+  iree_vm_instance_t* instance_ = nullptr;
+  iree_vm_context_t* context_ = nullptr;
+  iree_vm_function_t function_;
+};
+
+TEST_F(VMNativeModuleWaitableTest, InvokeBlocksInWait) {
+  auto input_list = MakeInputs(3, 1);
+  vm::ref<iree_vm_list_t> output_list;
+  IREE_ASSERT_OK(iree_vm_list_create(/*element_type=*/nullptr, 1,
+                                     iree_allocator_system(), &output_list));
+  IREE_ASSERT_OK(iree_vm_invoke(context_, function_, /*policy=*/nullptr,
+                                input_list.get(), output_list.get(),
+                                iree_allocator_system()));
+  iree_vm_value_t ret0_value;
+  IREE_ASSERT_OK(iree_vm_list_get_value(output_list.get(), 0, &ret0_value));
+  EXPECT_EQ(3, ret0_value.i32);
+  EXPECT_EQ(1, timeline_.wait_count);
+}
+
+TEST_F(VMNativeModuleWaitableTest, InvocationSuspendsUntilReady) {
+  auto input_list = MakeInputs(4, 2);
+  iree_vm_invocation_t* invocation = nullptr;
+  IREE_ASSERT_OK(iree_vm_invocation_create(context_, function_,
+                                           /*policy=*/nullptr, input_list.get(),
+                                           iree_allocator_system(),
+                                           &invocation));
+  // Drop our reference to the arguments; the suspended call must keep its own.
+  input_list.reset();
+  EXPECT_THAT(Status(iree_vm_invocation_query_status(invocation)),
+              StatusIs(StatusCode::kUnavailable));
+
+  // Polling does not block and leaves the invocation waiting.
+  EXPECT_THAT(Status(iree_vm_invocation_await(invocation,
+                                              IREE_TIME_INFINITE_PAST)),
+              StatusIs(StatusCode::kDeadlineExceeded));
+  EXPECT_THAT(Status(iree_vm_invocation_query_status(invocation)),
+              StatusIs(StatusCode::kUnavailable));
+
+  // Once the timeline is reached the function is retried with its arguments.
+  timeline_.value = 2;
+  IREE_ASSERT_OK(iree_vm_invocation_await(invocation, IREE_TIME_INFINITE_PAST));
+  const iree_vm_list_t* output_list = iree_vm_invocation_output(invocation);
+  ASSERT_NE(nullptr, output_list);
+  iree_vm_value_t ret0_value;
+  IREE_ASSERT_OK(iree_vm_list_get_value(output_list, 0, &ret0_value));
+  EXPECT_EQ(4, ret0_value.i32);
+  IREE_ASSERT_OK(iree_vm_invocation_release(invocation));
+}
+
+TEST_F(VMNativeModuleWaitableTest, InvocationAbortWhileWaiting) {
+  auto input_list = MakeInputs(1, 1);
+  iree_vm_invocation_t* invocation = nullptr;
+  IREE_ASSERT_OK(iree_vm_invocation_create(context_, function_,
+                                           /*policy=*/nullptr, input_list.get(),
+                                           iree_allocator_system(),
+                                           &invocation));
+  IREE_ASSERT_OK(iree_vm_invocation_abort(invocation));
+  EXPECT_THAT(Status(iree_vm_invocation_query_status(invocation)),
+              StatusIs(StatusCode::kAborted));
+  IREE_ASSERT_OK(iree_vm_invocation_release(invocation));
+}
+
 }  // namespace
 }  // namespace iree
@@ -310,3 +310,122 @@ static iree_status_t module_b_create(iree_allocator_t allocator,
   return iree_vm_native_module_create(&interface, &module_b_descriptor_,
                                       allocator, out_module);
 }
+
+//===----------------------------------------------------------------------===//
+// module_c
+//===----------------------------------------------------------------------===//
+// A module with a function that cannot complete immediately. Calls suspend
+// with IREE_VM_EXECUTION_STATE_WAIT and keep their native frame on the stack
+// until resumed enough times to complete, as an asynchronous import waiting on
+// some external event would.
+
+struct module_c_state_s;
+typedef struct module_c_state_s module_c_state_t;
+
+// Per-context state tracking the in-flight call.
+// NOTE: only one call may be in-flight per context in this simple example. A
+// real module would track pending operations per call.
+typedef struct module_c_state_s {
+  iree_allocator_t allocator;
+  // Number of resumes remaining before the in-flight call completes.
+  int32_t remaining;
+  // Total number of times the wait function has been called.
+  int32_t wait_count;
+} module_c_state_t;
+
+static iree_status_t IREE_API_PTR
+module_c_alloc_state(void* self, iree_allocator_t allocator,
+                     iree_vm_module_state_t** out_module_state) {
+  module_c_state_t* state = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_allocator_malloc(allocator, sizeof(*state), (void**)&state));
+  memset(state, 0, sizeof(*state));
+  state->allocator = allocator;
+  *out_module_state = (iree_vm_module_state_t*)state;
+  return iree_ok_status();
+}
+
+static void IREE_API_PTR
+module_c_free_state(void* self, iree_vm_module_state_t* module_state) {
+  module_c_state_t* state = (module_c_state_t*)module_state;
+  iree_allocator_free(state->allocator, state);
+}
+
+// Called by hosts with nothing else to do instead of polling.
+static iree_status_t IREE_API_PTR module_c_wait(void* wait_state,
+                                                iree_time_t deadline) {
+  module_c_state_t* state = (module_c_state_t*)wait_state;
+  ++state->wait_count;
+  return iree_ok_status();
+}
+
+// Completes the in-flight call if no more resumes are required.
+static void module_c_update(module_c_state_t* state,
+                            const iree_vm_function_call_t* call,
+                            iree_vm_execution_result_t* out_result) {
+  if (state->remaining > 0) {
+    out_result->state = IREE_VM_EXECUTION_STATE_WAIT;
+    out_result->wait_fn = module_c_wait;
+    out_result->wait_state = state;
+    return;
+  }
+  out_result->state = IREE_VM_EXECUTION_STATE_COMPLETE;
+  *(int32_t*)call->results.data = state->wait_count;
+}
+
+// vm.import @module_c.wait_n(%arg0 : i32) -> i32
+// Returns the number of times the wait function was called before completing.
+static iree_status_t module_c_wait_n_shim(
+    iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
+    iree_vm_native_function_target_t target_fn, void* module,
+    void* module_state, iree_vm_execution_result_t* out_result) {
+  module_c_state_t* state = (module_c_state_t*)module_state;
+  state->remaining = *(const int32_t*)call->arguments.data;
+  state->wait_count = 0;
+  module_c_update(state, call, out_result);
+  return iree_ok_status();
+}
+
+// Resumes the in-flight call to module_c.wait_n.
+static iree_status_t IREE_API_PTR module_c_resume_call(
+    void* self, iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
+    iree_vm_execution_result_t* out_result) {
+  module_c_state_t* state =
+      (module_c_state_t*)iree_vm_stack_current_frame(stack)->module_state;
+  --state->remaining;
+  module_c_update(state, call, out_result);
+  return iree_ok_status();
+}
+
+static const iree_vm_native_export_descriptor_t module_c_exports_[] = {
+    {iree_make_cstring_view("wait_n"), iree_make_cstring_view("0i.i"), 0,
+     NULL},
+};
+static const iree_vm_native_function_ptr_t module_c_funcs_[] = {
+    {(iree_vm_native_function_shim_t)module_c_wait_n_shim, NULL},
+};
+static_assert(IREE_ARRAYSIZE(module_c_funcs_) ==
+                  IREE_ARRAYSIZE(module_c_exports_),
+              "function pointer table must be 1:1 with exports");
+static const iree_vm_native_module_descriptor_t module_c_descriptor_ = {
+    iree_make_cstring_view("module_c"),
+    0,
+    NULL,
+    IREE_ARRAYSIZE(module_c_exports_),
+    module_c_exports_,
+    IREE_ARRAYSIZE(module_c_funcs_),
+    module_c_funcs_,
+    0,
+    NULL,
+};
+
+static iree_status_t module_c_create(iree_allocator_t allocator,
+                                     iree_vm_module_t** out_module) {
+  iree_vm_module_t interface;
+  IREE_RETURN_IF_ERROR(iree_vm_module_initialize(&interface, NULL));
+  interface.alloc_state = module_c_alloc_state;
+  interface.free_state = module_c_free_state;
+  interface.resume_call = module_c_resume_call;
+  return iree_vm_native_module_create(&interface, &module_c_descriptor_,
+                                      allocator, out_module);
+}
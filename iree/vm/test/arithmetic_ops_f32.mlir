@@ -0,0 +1,180 @@
+vm.module @arithmetic_ops_f32 {
+
+  //===--------------------------------------------------------------------===//
+  // Native floating-point arithmetic
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_add_f32
+  vm.func @test_add_f32() {
+    %c1 = vm.const.f32 1.5 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v = vm.add.f32 %c1dno, %c1dno : f32
+    %c2 = vm.const.f32 3.0 : f32
+    vm.check.eq %v, %c2, "1.5+1.5=3" : f32
+    vm.return
+  }
+
+  vm.export @test_sub_f32
+  vm.func @test_sub_f32() {
+    %c1 = vm.const.f32 3.0 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %c2 = vm.const.f32 2.5 : f32
+    %c2dno = iree.do_not_optimize(%c2) : f32
+    %v = vm.sub.f32 %c1dno, %c2dno : f32
+    %c3 = vm.const.f32 0.5 : f32
+    vm.check.eq %v, %c3, "3.0-2.5=0.5" : f32
+    vm.return
+  }
+
+  vm.export @test_mul_f32
+  vm.func @test_mul_f32() {
+    %c1 = vm.const.f32 2.5 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v = vm.mul.f32 %c1dno, %c1dno : f32
+    %c2 = vm.const.f32 6.25 : f32
+    vm.check.eq %v, %c2, "2.5*2.5=6.25" : f32
+    vm.return
+  }
+
+  vm.export @test_div_f32
+  vm.func @test_div_f32() {
+    %c1 = vm.const.f32 4.0 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %c2 = vm.const.f32 -2.0 : f32
+    %c2dno = iree.do_not_optimize(%c2) : f32
+    %v = vm.div.f32 %c1dno, %c2dno : f32
+    %c3 = vm.const.f32 -2.0 : f32
+    vm.check.eq %v, %c3, "4.0/-2.0=-2.0" : f32
+    vm.return
+  }
+
+  vm.export @test_rem_f32
+  vm.func @test_rem_f32() {
+    %c1 = vm.const.f32 -3.0 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %c2 = vm.const.f32 -2.0 : f32
+    %c2dno = iree.do_not_optimize(%c2) : f32
+    %v = vm.rem.f32 %c1dno, %c2dno : f32
+    %c3 = vm.const.f32 -1.0 : f32
+    vm.check.eq %v, %c3, "-3.0%-2.0=-1.0" : f32
+    vm.return
+  }
+
+  vm.export @test_abs_f32
+  vm.func @test_abs_f32() {
+    %c1 = vm.const.f32 -1.0 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v = vm.abs.f32 %c1dno : f32
+    %c2 = vm.const.f32 1.0 : f32
+    vm.check.eq %v, %c2, "abs(-1.0)=1.0" : f32
+    vm.return
+  }
+
+  vm.export @test_neg_f32
+  vm.func @test_neg_f32() {
+    %c1 = vm.const.f32 -1.0 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v = vm.neg.f32 %c1dno : f32
+    %c2 = vm.const.f32 1.0 : f32
+    vm.check.eq %v, %c2, "neg(-1.0)=1.0" : f32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Casting and type conversion
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cast_si32_f32
+  vm.func @test_cast_si32_f32() {
+    %c1 = vm.const.i32 -3 : i32
+    %c1dno = iree.do_not_optimize(%c1) : i32
+    %v = vm.cast.si32.f32 %c1dno : i32 -> f32
+    %c2 = vm.const.f32 -3.0 : f32
+    vm.check.eq %v, %c2, "cast(-3)=-3.0" : f32
+    vm.return
+  }
+
+  vm.export @test_cast_f32_si32
+  vm.func @test_cast_f32_si32() {
+    %c1 = vm.const.f32 -3.75 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v = vm.cast.f32.si32 %c1dno : f32 -> i32
+    %c2 = vm.const.i32 -3 : i32
+    vm.check.eq %v, %c2, "cast(-3.75)=-3" : i32
+    vm.return
+  }
+
+  vm.export @test_cast_f32_si32_saturate
+  vm.func @test_cast_f32_si32_saturate() {
+    %c0 = vm.const.f32 0.0 : f32
+    %c0dno = iree.do_not_optimize(%c0) : f32
+    %nan = vm.div.f32 %c0dno, %c0dno : f32
+    %v0 = vm.cast.f32.si32 %nan : f32 -> i32
+    %zero = vm.const.i32 0 : i32
+    vm.check.eq %v0, %zero, "cast(nan)=0" : i32
+    %c1 = vm.const.f32 1.0e+20 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v1 = vm.cast.f32.si32 %c1dno : f32 -> i32
+    %max = vm.const.i32 2147483647 : i32
+    vm.check.eq %v1, %max, "cast(1e20)=INT32_MAX" : i32
+    %c2 = vm.const.f32 -1.0e+20 : f32
+    %c2dno = iree.do_not_optimize(%c2) : f32
+    %v2 = vm.cast.f32.si32 %c2dno : f32 -> i32
+    %min = vm.const.i32 -2147483648 : i32
+    vm.check.eq %v2, %min, "cast(-1e20)=INT32_MIN" : i32
+    vm.return
+  }
+
+  vm.export @test_cast_f32_ui32_saturate
+  vm.func @test_cast_f32_ui32_saturate() {
+    %c0 = vm.const.f32 0.0 : f32
+    %c0dno = iree.do_not_optimize(%c0) : f32
+    %nan = vm.div.f32 %c0dno, %c0dno : f32
+    %v0 = vm.cast.f32.ui32 %nan : f32 -> i32
+    %zero = vm.const.i32 0 : i32
+    vm.check.eq %v0, %zero, "cast(nan)=0" : i32
+    %c1 = vm.const.f32 -3.75 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v1 = vm.cast.f32.ui32 %c1dno : f32 -> i32
+    vm.check.eq %v1, %zero, "cast(-3.75)=0" : i32
+    %c2 = vm.const.f32 1.0e+20 : f32
+    %c2dno = iree.do_not_optimize(%c2) : f32
+    %v2 = vm.cast.f32.ui32 %c2dno : f32 -> i32
+    %max = vm.const.i32 -1 : i32
+    vm.check.eq %v2, %max, "cast(1e20)=UINT32_MAX" : i32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Comparison ops
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cmp_lt_f32
+  vm.func @test_cmp_lt_f32() {
+    %c1 = vm.const.f32 -1.0 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %c2 = vm.const.f32 2.0 : f32
+    %c2dno = iree.do_not_optimize(%c2) : f32
+    %v = vm.cmp.lt.f32.o %c1dno, %c2dno : f32
+    %true = vm.const.i32 1 : i32
+    vm.check.eq %v, %true, "-1.0<2.0" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_nan_f32
+  vm.func @test_cmp_nan_f32() {
+    %c0 = vm.const.f32.zero : f32
+    %c0dno = iree.do_not_optimize(%c0) : f32
+    %nan = vm.div.f32 %c0dno, %c0dno : f32
+    %v0 = vm.cmp.eq.f32.o %nan, %nan : f32
+    %false = vm.const.i32 0 : i32
+    vm.check.eq %v0, %false, "NaN==NaN (ordered)" : i32
+    %v1 = vm.cmp.ne.f32.u %nan, %nan : f32
+    %true = vm.const.i32 1 : i32
+    vm.check.eq %v1, %true, "NaN!=NaN (unordered)" : i32
+    %v2 = vm.cmp.nan.f32 %nan : f32
+    vm.check.eq %v2, %true, "isnan(NaN)" : i32
+    vm.return
+  }
+
+}
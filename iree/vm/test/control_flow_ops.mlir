@@ -41,4 +41,77 @@ vm.module @control_flow_ops {
     vm.return
   }
 
+  //===--------------------------------------------------------------------===//
+  // vm.cond_br
+  //===--------------------------------------------------------------------===//
+
+  // Compare + branch pairs are fused into superinstructions at load time.
+  // Loops exercise both the taken and not-taken paths.
+  vm.export @test_cond_br_loop
+  vm.func @test_cond_br_loop() {
+    %c0 = vm.const.i32.zero : i32
+    %c10 = vm.const.i32 10 : i32
+    %c10dno = iree.do_not_optimize(%c10) : i32
+    vm.br ^loop(%c0 : i32)
+  ^loop(%i : i32):
+    %c1 = vm.const.i32 1 : i32
+    %in = vm.add.i32 %i, %c1 : i32
+    %cmp = vm.cmp.lt.i32.s %in, %c10dno : i32
+    vm.cond_br %cmp, ^loop(%in : i32), ^loop_exit(%in : i32)
+  ^loop_exit(%ie : i32):
+    vm.check.eq %ie, %c10, "loop must run 10 iterations" : i32
+    vm.return
+  }
+
+  vm.export @test_cond_br_loop_nz
+  vm.func @test_cond_br_loop_nz() {
+    %c3 = vm.const.i32 3 : i32
+    %c3dno = iree.do_not_optimize(%c3) : i32
+    %c0 = vm.const.i32.zero : i32
+    vm.br ^loop(%c3dno, %c0 : i32, i32)
+  ^loop(%i : i32, %sum : i32):
+    %c2 = vm.const.i32 2 : i32
+    %sumn = vm.add.i32 %sum, %c2 : i32
+    %cm1 = vm.const.i32 -1 : i32
+    %in = vm.add.i32 %i, %cm1 : i32
+    %nz = vm.cmp.nz.i32 %in : i32
+    vm.cond_br %nz, ^loop(%in, %sumn : i32, i32), ^loop_exit(%sumn : i32)
+  ^loop_exit(%sume : i32):
+    %c6 = vm.const.i32 6 : i32
+    vm.check.eq %sume, %c6, "loop must run 3 iterations" : i32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // vm.yield
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_yield
+  vm.func @test_yield() {
+    %c1 = vm.const.i32 1 : i32
+    %c1dno = iree.do_not_optimize(%c1) : i32
+    vm.yield
+    %v = vm.add.i32 %c1dno, %c1dno : i32
+    vm.yield
+    %c2 = vm.const.i32 2 : i32
+    vm.check.eq %v, %c2, "registers must be preserved across yields" : i32
+    vm.return
+  }
+
+  vm.export @test_yield_in_call
+  vm.func @test_yield_in_call() {
+    %c1 = vm.const.i32 1 : i32
+    %c1dno = iree.do_not_optimize(%c1) : i32
+    %v = vm.call @_yield_add(%c1dno) : (i32) -> i32
+    %c2 = vm.const.i32 2 : i32
+    vm.check.eq %v, %c2, "callee must resume after yielding" : i32
+    vm.return
+  }
+
+  vm.func @_yield_add(%arg0 : i32) -> i32 {
+    vm.yield
+    %v = vm.add.i32 %arg0, %arg0 : i32
+    vm.return %v : i32
+  }
+
 }
@@ -33,8 +33,10 @@ typedef enum {
   IREE_VM_VALUE_TYPE_I32 = 3,
   // int64_t.
   IREE_VM_VALUE_TYPE_I64 = 4,
+  // float.
+  IREE_VM_VALUE_TYPE_F32 = 5,
 
-  IREE_VM_VALUE_TYPE_MAX = IREE_VM_VALUE_TYPE_I64,
+  IREE_VM_VALUE_TYPE_MAX = IREE_VM_VALUE_TYPE_F32,
   IREE_VM_VALUE_TYPE_COUNT = IREE_VM_VALUE_TYPE_MAX + 1,
 } iree_vm_value_type_t;
 
@@ -49,6 +51,7 @@ typedef struct iree_vm_value {
     int16_t i16;
     int32_t i32;
     int64_t i64;
+    float f32;
 
     uint8_t value_storage[IREE_VM_VALUE_STORAGE_SIZE];  // max size of all value
                                                         // types
@@ -69,6 +72,13 @@ static inline iree_vm_value_t iree_vm_value_make_i64(int64_t value) {
   return result;
 }
 
+static inline iree_vm_value_t iree_vm_value_make_f32(float value) {
+  iree_vm_value_t result;
+  result.type = IREE_VM_VALUE_TYPE_F32;
+  result.f32 = value;
+  return result;
+}
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus